@@ -24,6 +24,46 @@ extern "C" {
 
 extern uint32_t ar_log_lvl; /*gobal variable to control the log levels*/
 
+#define AR_LOG_ALL_LVL      (AR_CRITICAL|AR_ERROR|AR_DEBUG|AR_INFO|AR_VERBOSE)
+
+/* Levels at and above min_lvl (AR_VERBOSE < AR_DEBUG < AR_INFO < AR_ERROR < AR_CRITICAL),
+ * a constant expression so that callers can filter at compile time */
+#define AR_LOG_LVL_MASK_FROM(min_lvl)                                     \
+    (((min_lvl) == AR_CRITICAL) ? (AR_CRITICAL) :                         \
+     ((min_lvl) == AR_ERROR)    ? (AR_CRITICAL|AR_ERROR) :                \
+     ((min_lvl) == AR_INFO)     ? (AR_CRITICAL|AR_ERROR|AR_INFO) :        \
+     ((min_lvl) == AR_DEBUG)    ? (AR_CRITICAL|AR_ERROR|AR_INFO|AR_DEBUG) : \
+                                  (AR_LOG_ALL_LVL))
+
+/* Runtime level masks of the components of the client (e.g. framework, containers, modules). The client
+ * assigns the component IDs; a disabled level costs the caller one load and one branch. */
+#define AR_LOG_MAX_MODULES  32
+extern uint32_t ar_log_module_lvl[AR_LOG_MAX_MODULES];
+
+/* Call site of a deferred log message, one static instance per message in the code.
+ * Only pointers to the site and its strings are logged, so they must stay valid till the message is
+ * written: call ar_log_deferred_flush() before unloading a library which logged. */
+typedef struct ar_log_site_t
+{
+    uint32_t level;
+    const char_t *log_tag;
+    const char_t *file;
+    const char_t *fn;
+    int32_t ln;
+    const char_t *format;
+    uint64_t arg_desc; /**< argument types parsed from format on first use, owned by ar_osal */
+} ar_log_site_t;
+
+/* Counters of the deferred logging, see ar_log_deferred_get_stats() */
+typedef struct ar_log_deferred_stats_t
+{
+    uint64_t num_logged;    /**< messages recorded into the rings */
+    uint64_t num_dropped;   /**< messages lost since the thread's ring was full */
+    uint64_t num_sync;      /**< messages formatted by the calling thread, since the
+                                 format is not supported for deferral or the level is AR_CRITICAL */
+    uint64_t num_emitted;   /**< messages formatted and written by the formatter thread */
+} ar_log_deferred_stats_t;
+
 /* Initialize logging */
 void ar_log_init(void);
 
@@ -45,6 +85,27 @@ void ar_log(uint32_t level, const char_t* log_tag, const char_t* file,
  */
 void ar_set_log_level(uint32_t level);
 
+/* Set the log level of one component, see ar_log_module_lvl */
+void ar_set_module_log_level(uint32_t module_id, uint32_t level);
+
+/* Write a formatted message, with the same output as ar_log() */
+void ar_log_write(uint32_t level, const char_t *log_tag, const char_t *msg);
+
+/* Deferred logging.
+ * ar_log_deferred() copies the arguments of the message into a lock free ring of the calling thread; a
+ * low priority thread formats and writes the messages later, in timestamp order, prefixed with the time
+ * at which they were logged. Arguments of %s are copied (truncated to 128 characters). Formats with '*'
+ * width/precision, %n or long double are formatted by the calling thread.
+ * Until ar_log_deferred_init() is called, and after ar_log_deferred_deinit(), messages are formatted
+ * by the calling thread. */
+int32_t ar_log_deferred_init(void);
+int32_t ar_log_deferred_deinit(void);
+void ar_log_deferred(ar_log_site_t *site, ...);
+/* Returns once all messages logged before the call are written. Must not be called by the formatter thread,
+ * i.e. from ar_log_write(). */
+int32_t ar_log_deferred_flush(void);
+int32_t ar_log_deferred_get_stats(ar_log_deferred_stats_t *stats);
+
 #define AR_LOG_VERBOSE(log_tag, ...)                                    \
     if (ar_log_lvl & AR_VERBOSE) {                                    \
         ar_log(AR_VERBOSE, log_tag, __FILE__, __FUNCTION__, __LINE__, __VA_ARGS__); \
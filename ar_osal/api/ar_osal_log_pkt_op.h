@@ -24,6 +24,7 @@ extern "C" {
         AR_LOG_DATA_TRANSPORT_UNKNOWN   = 0x0,
         AR_LOG_DATA_TRANSPORT_DIAG      = 0x1,
         AR_LOG_DATA_TRANSPORT_TCPIP     = 0x2,
+        AR_LOG_DATA_TRANSPORT_FILE      = 0x3,
     }ar_log_data_transport_t;
 
     typedef struct ar_log_pkt_op_init_info_t
@@ -33,8 +34,36 @@ extern "C" {
                                      log packets */
         ar_heap_info heap_info; /**< Heap information used to identify memory
                                      allocated by the data transport */
+        const char *file_path;  /**< AR_LOG_DATA_TRANSPORT_FILE only: file the
+                                     log packets are written to. If NULL, an
+                                     anonymous memfd is used, see
+                                     ar_log_pkt_get_fd() */
+        uint32_t max_file_size; /**< AR_LOG_DATA_TRANSPORT_FILE only: size
+                                     limit of the file in bytes, 0 for the
+                                     default (64 MB). Once reached, a file is
+                                     renamed to <file_path>.1 and a new one
+                                     is started, a memfd is truncated. */
     }ar_log_pkt_op_init_info_t, *par_log_pkt_op_init_info_t;
 
+    /**< Counters of the file data transport, see ar_log_pkt_get_stats() */
+    typedef struct ar_log_pkt_stats_t
+    {
+        uint64_t num_allocated;     /**< Packets reserved by producer threads */
+        uint64_t num_dropped;       /**< Allocations which failed since the
+                                         thread's ring was full */
+        uint64_t num_backpressured; /**< Allocations which found the thread's
+                                         ring above the high watermark and
+                                         woke up the writer early */
+        uint64_t num_written;       /**< Packets written to the file */
+        uint64_t bytes_written;     /**< Bytes written to the file, including
+                                         the file and packet headers */
+        uint64_t num_write_errors;  /**< Failed writes, packets of a failed
+                                         write are lost */
+        uint64_t num_rotations;     /**< Times the file reached
+                                         max_file_size and was rotated or
+                                         truncated */
+    }ar_log_pkt_stats_t;
+
     /**
     * \brief ar_log_pkt_op_init
     *
@@ -137,6 +166,33 @@ extern "C" {
     */
     bool_t ar_log_code_status(uint16_t logcode);
 
+    /**
+    * \brief ar_log_pkt_get_stats
+    *
+    *        Retrieve the counters of the data transport. Only supported
+    *        by AR_LOG_DATA_TRANSPORT_FILE.
+    *
+    * \param[out] stats: counters accumulated since ar_log_pkt_op_init
+    *
+    * \return
+    *  Success -- 0
+    *  Failure -- non-zero
+    */
+    int32_t ar_log_pkt_get_stats(ar_log_pkt_stats_t *stats);
+
+    /**
+    * \brief ar_log_pkt_get_fd
+    *
+    *        Retrieve the file descriptor log packets are written to. Only
+    *        supported by AR_LOG_DATA_TRANSPORT_FILE. The descriptor is closed
+    *        by ar_log_pkt_op_deinit, dup() it to read the memfd afterwards.
+    *
+    * \return
+    *  Success -- file descriptor
+    *  Failure -- -1
+    */
+    int32_t ar_log_pkt_get_fd(void);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
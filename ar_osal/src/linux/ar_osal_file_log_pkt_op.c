@@ -0,0 +1,658 @@
+/**
+* \file ar_osal_file_log_pkt_op.c
+* \brief
+*    Defines ar_log_pkt APIs which write log packets to a file or memfd
+*    (AR_LOG_DATA_TRANSPORT_FILE).
+*
+*    Threads reserve log packets from their own single-producer/
+*    single-consumer ring, so alloc/commit never take a lock or make a
+*    system call. A low priority writer thread drains all rings and writes
+*    the packets to the file in batches.
+*
+*    File format (little endian, no padding):
+*
+*      file header : uint32 magic (AR_LOG_PKT_FILE_MAGIC, "ARLP")
+*                    uint16 version (AR_LOG_PKT_FILE_VERSION)
+*                    uint16 header size in bytes (16)
+*                    uint32 max packet size in bytes, including header
+*                    uint32 reserved
+*      packets     : uint16 len, packet size including this header
+*                    uint16 log code
+*                    uint32 timestamp lsw, us of CLOCK_MONOTONIC
+*                    uint32 timestamp msw
+*                    uint8  payload[len - 12]
+*
+*    The packet header has the same layout as the DIAG/DLS log_hdr_type,
+*    so tools which parse DIAG/DLS log packets can parse the packets as is.
+*    Packets of one thread are in order; packets of different threads are
+*    interleaved in write order.
+*
+*    The file is limited to max_file_size bytes. When the next batch does not
+*    fit anymore, a file is renamed to <file_path>.1 (replacing the previous
+*    one) and a new file is started; a memfd is truncated. Either way the new
+*    file starts with a file header, and the descriptor number is kept.
+*
+* \copyright
+*  Copyright (c) Qualcomm Innovation Center, Inc. All rights reserved.
+*  SPDX-License-Identifier: BSD-3-Clause-Clear
+*/
+
+#define _GNU_SOURCE
+#define AR_OSAL_LOG_PKT_LOG_TAG  "COLP"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include "ar_osal_log_pkt_op.h"
+#include "ar_osal_log.h"
+#include "ar_osal_error.h"
+
+#define AR_LOG_PKT_FILE_MAGIC          0x504C5241 /* "ARLP" */
+#define AR_LOG_PKT_FILE_VERSION        1
+#define AR_LOG_PKT_HDR_SIZE            12
+/* packet len is a uint16 in the header */
+#define AR_LOG_PKT_MAX_SIZE            8192
+/* per thread ring, must be a power of 2 */
+#define AR_LOG_PKT_RING_SIZE           (256 * 1024)
+/* writer is woken up early once a ring is filled above this level */
+#define AR_LOG_PKT_RING_HIGH_WATERMARK ((AR_LOG_PKT_RING_SIZE / 4) * 3)
+#define AR_LOG_PKT_WRITER_PERIOD_MS    10
+#define AR_LOG_PKT_BATCH_SIZE          (64 * 1024)
+#define AR_LOG_PKT_DEFAULT_MAX_FILE_SIZE (64 * 1024 * 1024)
+/* a full batch must fit in a file after the file header */
+#define AR_LOG_PKT_MIN_MAX_FILE_SIZE   (sizeof(ar_log_pkt_file_hdr_t) + AR_LOG_PKT_BATCH_SIZE)
+#define AR_LOG_PKT_ROTATED_SUFFIX      ".1"
+#define AR_LOG_PKT_ALIGN(x)            (((x) + 7) & ~((uint32_t)7))
+
+typedef enum ar_log_pkt_slot_state_t
+{
+    AR_LOG_PKT_SLOT_RESERVED  = 0, /**< being filled by the producer */
+    AR_LOG_PKT_SLOT_COMMITTED = 1, /**< to be written */
+    AR_LOG_PKT_SLOT_FREED     = 2, /**< to be skipped */
+    AR_LOG_PKT_SLOT_PAD       = 3, /**< unused space till the end of the ring */
+} ar_log_pkt_slot_state_t;
+
+/* precedes every packet in the ring */
+typedef struct ar_log_pkt_slot_t
+{
+    uint32_t size;           /**< slot size in bytes, including this header */
+    _Atomic uint32_t state;  /**< ar_log_pkt_slot_state_t */
+} ar_log_pkt_slot_t;
+
+typedef struct ar_log_pkt_hdr_t
+{
+    uint16_t len;
+    uint16_t code;
+    uint32_t ts_lsw;
+    uint32_t ts_msw;
+} __attribute__((packed)) ar_log_pkt_hdr_t;
+
+typedef struct ar_log_pkt_file_hdr_t
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t hdr_size;
+    uint32_t max_pkt_size;
+    uint32_t reserved;
+} ar_log_pkt_file_hdr_t;
+
+typedef struct ar_log_pkt_ring_t
+{
+    struct ar_log_pkt_ring_t *next;
+    _Atomic uint32_t head;              /**< written by the producer */
+    _Atomic uint32_t tail;              /**< written by the writer */
+    _Atomic uint32_t is_orphan;         /**< producer thread exited */
+    /* written by the producer only, read by ar_log_pkt_get_stats */
+    _Atomic uint64_t num_allocated;
+    _Atomic uint64_t num_dropped;
+    _Atomic uint64_t num_backpressured;
+    uint8_t *buf;
+} ar_log_pkt_ring_t;
+
+typedef struct ar_log_pkt_file_ctx_t
+{
+    _Atomic bool_t is_active;
+    uint32_t generation;
+    int32_t fd;
+    char *file_path;                    /**< NULL for memfd */
+    char *rotated_path;                 /**< file_path with AR_LOG_PKT_ROTATED_SUFFIX */
+    uint32_t max_file_size;
+    uint32_t file_size;                 /**< bytes in the current file, writer only */
+    pthread_key_t ring_key;
+    _Atomic(ar_log_pkt_ring_t *) ring_list;
+    pthread_mutex_t ring_free_lock;     /**< writer vs. ar_log_pkt_get_stats, never taken by producers */
+    pthread_t writer_thread;
+    sem_t writer_sem;
+    _Atomic uint32_t wake_pending;
+    _Atomic bool_t stop_writer;
+    uint8_t *batch_buf;
+    uint32_t batch_len;
+    /* counters of freed rings and of the writer */
+    _Atomic uint64_t num_allocated;
+    _Atomic uint64_t num_dropped;
+    _Atomic uint64_t num_backpressured;
+    _Atomic uint64_t num_written;
+    _Atomic uint64_t bytes_written;
+    _Atomic uint64_t num_write_errors;
+    _Atomic uint64_t num_rotations;
+} ar_log_pkt_file_ctx_t;
+
+static ar_log_pkt_file_ctx_t g_log_pkt_ctx = { .fd = -1, .ring_free_lock = PTHREAD_MUTEX_INITIALIZER };
+
+/* caches the ring of the calling thread, valid only for the generation it was created in */
+static __thread ar_log_pkt_ring_t *tls_ring;
+static __thread uint32_t tls_ring_generation;
+
+static inline void ar_log_pkt_counter_inc(_Atomic uint64_t *counter)
+{
+    /* single writer, no need for an atomic read-modify-write */
+    atomic_store_explicit(counter,
+                          atomic_load_explicit(counter, memory_order_relaxed) + 1,
+                          memory_order_relaxed);
+}
+
+static void ar_log_pkt_wake_writer(void)
+{
+    if (0 == atomic_exchange_explicit(&g_log_pkt_ctx.wake_pending, 1, memory_order_acq_rel))
+        sem_post(&g_log_pkt_ctx.writer_sem);
+}
+
+/* pthread key destructor, the writer frees the ring once it is drained */
+static void ar_log_pkt_ring_orphan(void *arg)
+{
+    ar_log_pkt_ring_t *ring = (ar_log_pkt_ring_t *)arg;
+    atomic_store_explicit(&ring->is_orphan, 1, memory_order_release);
+}
+
+static ar_log_pkt_ring_t *ar_log_pkt_get_ring(void)
+{
+    ar_log_pkt_ring_t *ring;
+
+    if (tls_ring && (tls_ring_generation == g_log_pkt_ctx.generation))
+        return tls_ring;
+
+    /* first packet of this thread */
+    ring = (ar_log_pkt_ring_t *)calloc(1, sizeof(ar_log_pkt_ring_t));
+    if (NULL == ring)
+        return NULL;
+
+    ring->buf = (uint8_t *)malloc(AR_LOG_PKT_RING_SIZE);
+    if (NULL == ring->buf) {
+        free(ring);
+        return NULL;
+    }
+
+    ring->next = atomic_load_explicit(&g_log_pkt_ctx.ring_list, memory_order_relaxed);
+    while (!atomic_compare_exchange_weak_explicit(&g_log_pkt_ctx.ring_list, &ring->next, ring,
+                                                  memory_order_release, memory_order_relaxed))
+        ;
+
+    pthread_setspecific(g_log_pkt_ctx.ring_key, ring);
+    tls_ring = ring;
+    tls_ring_generation = g_log_pkt_ctx.generation;
+
+    return ring;
+}
+
+static uint64_t ar_log_pkt_get_time_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000) + ((uint64_t)ts.tv_nsec / 1000);
+}
+
+static void ar_log_pkt_write(const uint8_t *buf, uint32_t len)
+{
+    while (len) {
+        ssize_t n = write(g_log_pkt_ctx.fd, buf, len);
+        if (n < 0) {
+            if (EINTR == errno)
+                continue;
+            AR_LOG_ERR(AR_OSAL_LOG_PKT_LOG_TAG, "%s: write failed, errno = %d\n", __func__, errno);
+            atomic_fetch_add_explicit(&g_log_pkt_ctx.num_write_errors, 1, memory_order_relaxed);
+            return;
+        }
+        atomic_fetch_add_explicit(&g_log_pkt_ctx.bytes_written, (uint64_t)n, memory_order_relaxed);
+        g_log_pkt_ctx.file_size += (uint32_t)n;
+        buf += n;
+        len -= (uint32_t)n;
+    }
+}
+
+static void ar_log_pkt_write_file_hdr(void)
+{
+    ar_log_pkt_file_hdr_t file_hdr;
+
+    file_hdr.magic = AR_LOG_PKT_FILE_MAGIC;
+    file_hdr.version = AR_LOG_PKT_FILE_VERSION;
+    file_hdr.hdr_size = sizeof(ar_log_pkt_file_hdr_t);
+    file_hdr.max_pkt_size = AR_LOG_PKT_MAX_SIZE;
+    file_hdr.reserved = 0;
+    ar_log_pkt_write((const uint8_t *)&file_hdr, sizeof(file_hdr));
+}
+
+/* starts a new file if len bytes don't fit in the current one */
+static void ar_log_pkt_check_rotate(uint32_t len)
+{
+    int32_t fd;
+
+    if ((g_log_pkt_ctx.file_size + len) <= g_log_pkt_ctx.max_file_size)
+        return;
+
+    fd = -1;
+    if (g_log_pkt_ctx.file_path) {
+        if (rename(g_log_pkt_ctx.file_path, g_log_pkt_ctx.rotated_path)) {
+            AR_LOG_ERR(AR_OSAL_LOG_PKT_LOG_TAG, "%s: rename failed, errno = %d\n", __func__, errno);
+        } else {
+            fd = open(g_log_pkt_ctx.file_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        }
+    }
+
+    if (fd >= 0) {
+        /* keep the descriptor number handed out by ar_log_pkt_get_fd */
+        if (dup3(fd, g_log_pkt_ctx.fd, O_CLOEXEC) < 0)
+            AR_LOG_ERR(AR_OSAL_LOG_PKT_LOG_TAG, "%s: dup3 failed, errno = %d\n", __func__, errno);
+        close(fd);
+    } else if (ftruncate(g_log_pkt_ctx.fd, 0) || (lseek(g_log_pkt_ctx.fd, 0, SEEK_SET) < 0)) {
+        /* memfd, or the file could not be rotated: drop what was written */
+        AR_LOG_ERR(AR_OSAL_LOG_PKT_LOG_TAG, "%s: truncate failed, errno = %d\n", __func__, errno);
+    }
+
+    g_log_pkt_ctx.file_size = 0;
+    atomic_fetch_add_explicit(&g_log_pkt_ctx.num_rotations, 1, memory_order_relaxed);
+    ar_log_pkt_write_file_hdr();
+}
+
+static void ar_log_pkt_flush_batch(void)
+{
+    if (g_log_pkt_ctx.batch_len) {
+        ar_log_pkt_check_rotate(g_log_pkt_ctx.batch_len);
+        ar_log_pkt_write(g_log_pkt_ctx.batch_buf, g_log_pkt_ctx.batch_len);
+        g_log_pkt_ctx.batch_len = 0;
+    }
+}
+
+/* copies the committed packets of the ring to the batch. returns TRUE if the ring is empty. */
+static bool_t ar_log_pkt_drain_ring(ar_log_pkt_ring_t *ring)
+{
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+    while (tail != head) {
+        ar_log_pkt_slot_t *slot =
+            (ar_log_pkt_slot_t *)(ring->buf + (tail & (AR_LOG_PKT_RING_SIZE - 1)));
+        uint32_t state = atomic_load_explicit(&slot->state, memory_order_acquire);
+
+        /* packets are written in order, wait for the producer */
+        if (AR_LOG_PKT_SLOT_RESERVED == state)
+            break;
+
+        if (AR_LOG_PKT_SLOT_COMMITTED == state) {
+            ar_log_pkt_hdr_t *hdr = (ar_log_pkt_hdr_t *)(slot + 1);
+            if (hdr->len > (AR_LOG_PKT_BATCH_SIZE - g_log_pkt_ctx.batch_len))
+                ar_log_pkt_flush_batch();
+            memcpy(g_log_pkt_ctx.batch_buf + g_log_pkt_ctx.batch_len, hdr, hdr->len);
+            g_log_pkt_ctx.batch_len += hdr->len;
+            atomic_fetch_add_explicit(&g_log_pkt_ctx.num_written, 1, memory_order_relaxed);
+        }
+
+        tail += slot->size;
+        atomic_store_explicit(&ring->tail, tail, memory_order_release);
+    }
+
+    return (tail == head);
+}
+
+static void ar_log_pkt_free_ring(ar_log_pkt_ring_t *ring)
+{
+    atomic_fetch_add_explicit(&g_log_pkt_ctx.num_allocated,
+                              atomic_load_explicit(&ring->num_allocated, memory_order_relaxed),
+                              memory_order_relaxed);
+    atomic_fetch_add_explicit(&g_log_pkt_ctx.num_dropped,
+                              atomic_load_explicit(&ring->num_dropped, memory_order_relaxed),
+                              memory_order_relaxed);
+    atomic_fetch_add_explicit(&g_log_pkt_ctx.num_backpressured,
+                              atomic_load_explicit(&ring->num_backpressured, memory_order_relaxed),
+                              memory_order_relaxed);
+    free(ring->buf);
+    free(ring);
+}
+
+/* drains all rings once, frees rings of exited threads. Only the writer removes rings from the list. */
+static void ar_log_pkt_drain_all(void)
+{
+    ar_log_pkt_ring_t *prev = NULL;
+    ar_log_pkt_ring_t *ring = atomic_load_explicit(&g_log_pkt_ctx.ring_list, memory_order_acquire);
+
+    while (ring) {
+        ar_log_pkt_ring_t *next = ring->next;
+        bool_t is_orphan = atomic_load_explicit(&ring->is_orphan, memory_order_acquire);
+
+        if (ar_log_pkt_drain_ring(ring) && is_orphan) {
+            pthread_mutex_lock(&g_log_pkt_ctx.ring_free_lock);
+            if (prev) {
+                prev->next = next;
+            } else {
+                ar_log_pkt_ring_t *expected = ring;
+                /* new rings are pushed at the head, unlink from the new predecessor in that case */
+                if (!atomic_compare_exchange_strong_explicit(&g_log_pkt_ctx.ring_list, &expected, next,
+                                                             memory_order_acq_rel, memory_order_acquire)) {
+                    prev = expected;
+                    while (prev->next != ring)
+                        prev = prev->next;
+                    prev->next = next;
+                }
+            }
+            ar_log_pkt_free_ring(ring);
+            pthread_mutex_unlock(&g_log_pkt_ctx.ring_free_lock);
+        } else {
+            prev = ring;
+        }
+        ring = next;
+    }
+
+    ar_log_pkt_flush_batch();
+}
+
+static void *ar_log_pkt_writer(void *arg)
+{
+    struct timespec ts;
+
+    (void)arg;
+    pthread_setname_np(pthread_self(), "ar_log_pkt_wr");
+
+    while (!atomic_load_explicit(&g_log_pkt_ctx.stop_writer, memory_order_acquire)) {
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_nsec += AR_LOG_PKT_WRITER_PERIOD_MS * 1000000;
+        if (ts.tv_nsec >= 1000000000) {
+            ts.tv_sec++;
+            ts.tv_nsec -= 1000000000;
+        }
+        sem_timedwait(&g_log_pkt_ctx.writer_sem, &ts);
+        atomic_store_explicit(&g_log_pkt_ctx.wake_pending, 0, memory_order_release);
+
+        ar_log_pkt_drain_all();
+    }
+
+    /* final drain of whatever was committed before deinit */
+    ar_log_pkt_drain_all();
+    return NULL;
+}
+
+static void ar_log_pkt_free_paths(void)
+{
+    free(g_log_pkt_ctx.file_path);
+    free(g_log_pkt_ctx.rotated_path);
+    g_log_pkt_ctx.file_path = NULL;
+    g_log_pkt_ctx.rotated_path = NULL;
+}
+
+int32_t ar_log_pkt_op_init(ar_log_pkt_op_init_info_t *info)
+{
+    int32_t rc = AR_EOK;
+
+    if (NULL == info) {
+        AR_LOG_ERR(AR_OSAL_LOG_PKT_LOG_TAG, "%s: info is NULL\n", __func__);
+        return AR_EBADPARAM;
+    }
+
+    /* without a file transport log packets are not captured */
+    if (AR_LOG_DATA_TRANSPORT_FILE != info->data_transport)
+        return AR_EOK;
+
+    if (atomic_load(&g_log_pkt_ctx.is_active))
+        return AR_EALREADY;
+
+    g_log_pkt_ctx.max_file_size = info->max_file_size ? info->max_file_size : AR_LOG_PKT_DEFAULT_MAX_FILE_SIZE;
+    if (g_log_pkt_ctx.max_file_size < AR_LOG_PKT_MIN_MAX_FILE_SIZE)
+        g_log_pkt_ctx.max_file_size = AR_LOG_PKT_MIN_MAX_FILE_SIZE;
+    g_log_pkt_ctx.file_size = 0;
+
+    if (info->file_path) {
+        size_t path_len = strlen(info->file_path);
+
+        g_log_pkt_ctx.file_path = strdup(info->file_path);
+        g_log_pkt_ctx.rotated_path = (char *)malloc(path_len + sizeof(AR_LOG_PKT_ROTATED_SUFFIX));
+        if ((NULL == g_log_pkt_ctx.file_path) || (NULL == g_log_pkt_ctx.rotated_path)) {
+            ar_log_pkt_free_paths();
+            return AR_ENOMEMORY;
+        }
+        memcpy(g_log_pkt_ctx.rotated_path, info->file_path, path_len);
+        memcpy(g_log_pkt_ctx.rotated_path + path_len, AR_LOG_PKT_ROTATED_SUFFIX, sizeof(AR_LOG_PKT_ROTATED_SUFFIX));
+
+        g_log_pkt_ctx.fd = open(info->file_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    } else {
+        g_log_pkt_ctx.fd = memfd_create("ar_log_pkt", MFD_CLOEXEC);
+    }
+
+    if (g_log_pkt_ctx.fd < 0) {
+        AR_LOG_ERR(AR_OSAL_LOG_PKT_LOG_TAG, "%s: failed to open log file, errno = %d\n", __func__, errno);
+        ar_log_pkt_free_paths();
+        return AR_EFAILED;
+    }
+
+    g_log_pkt_ctx.batch_buf = (uint8_t *)malloc(AR_LOG_PKT_BATCH_SIZE);
+    if (NULL == g_log_pkt_ctx.batch_buf) {
+        AR_LOG_ERR(AR_OSAL_LOG_PKT_LOG_TAG, "%s: failed to allocate batch buffer\n", __func__);
+        rc = AR_ENOMEMORY;
+        goto err_fd;
+    }
+    g_log_pkt_ctx.batch_len = 0;
+
+    if (pthread_key_create(&g_log_pkt_ctx.ring_key, ar_log_pkt_ring_orphan)) {
+        rc = AR_EFAILED;
+        goto err_batch;
+    }
+
+    if (sem_init(&g_log_pkt_ctx.writer_sem, 0, 0)) {
+        rc = AR_EFAILED;
+        goto err_key;
+    }
+
+    atomic_store(&g_log_pkt_ctx.ring_list, NULL);
+    atomic_store(&g_log_pkt_ctx.wake_pending, 0);
+    atomic_store(&g_log_pkt_ctx.stop_writer, false);
+    atomic_store(&g_log_pkt_ctx.num_allocated, 0);
+    atomic_store(&g_log_pkt_ctx.num_dropped, 0);
+    atomic_store(&g_log_pkt_ctx.num_backpressured, 0);
+    atomic_store(&g_log_pkt_ctx.num_written, 0);
+    atomic_store(&g_log_pkt_ctx.bytes_written, 0);
+    atomic_store(&g_log_pkt_ctx.num_write_errors, 0);
+    atomic_store(&g_log_pkt_ctx.num_rotations, 0);
+    /* invalidates rings cached by threads in an earlier init */
+    g_log_pkt_ctx.generation++;
+
+    ar_log_pkt_write_file_hdr();
+
+    /* default attributes: SCHED_OTHER, below the real time audio threads */
+    if (pthread_create(&g_log_pkt_ctx.writer_thread, NULL, ar_log_pkt_writer, NULL)) {
+        AR_LOG_ERR(AR_OSAL_LOG_PKT_LOG_TAG, "%s: failed to create writer thread\n", __func__);
+        rc = AR_EFAILED;
+        goto err_sem;
+    }
+
+    atomic_store_explicit(&g_log_pkt_ctx.is_active, true, memory_order_release);
+    return AR_EOK;
+
+err_sem:
+    sem_destroy(&g_log_pkt_ctx.writer_sem);
+err_key:
+    pthread_key_delete(g_log_pkt_ctx.ring_key);
+err_batch:
+    free(g_log_pkt_ctx.batch_buf);
+    g_log_pkt_ctx.batch_buf = NULL;
+err_fd:
+    close(g_log_pkt_ctx.fd);
+    g_log_pkt_ctx.fd = -1;
+    ar_log_pkt_free_paths();
+    return rc;
+}
+
+/* log packets must not be allocated or committed during or after deinit */
+int32_t ar_log_pkt_op_deinit()
+{
+    ar_log_pkt_ring_t *ring;
+
+    if (!atomic_load(&g_log_pkt_ctx.is_active))
+        return AR_EOK;
+
+    atomic_store_explicit(&g_log_pkt_ctx.is_active, false, memory_order_release);
+    atomic_store_explicit(&g_log_pkt_ctx.stop_writer, true, memory_order_release);
+    sem_post(&g_log_pkt_ctx.writer_sem);
+    pthread_join(g_log_pkt_ctx.writer_thread, NULL);
+
+    ring = atomic_exchange(&g_log_pkt_ctx.ring_list, NULL);
+    while (ring) {
+        ar_log_pkt_ring_t *next = ring->next;
+        ar_log_pkt_free_ring(ring);
+        ring = next;
+    }
+
+    /* destructors are not called for a deleted key */
+    pthread_key_delete(g_log_pkt_ctx.ring_key);
+    sem_destroy(&g_log_pkt_ctx.writer_sem);
+    free(g_log_pkt_ctx.batch_buf);
+    g_log_pkt_ctx.batch_buf = NULL;
+    close(g_log_pkt_ctx.fd);
+    g_log_pkt_ctx.fd = -1;
+    ar_log_pkt_free_paths();
+
+    return AR_EOK;
+}
+
+uint32_t ar_log_pkt_get_max_size()
+{
+    return AR_LOG_PKT_MAX_SIZE - AR_LOG_PKT_HDR_SIZE;
+}
+
+void *ar_log_pkt_alloc(uint16_t logcode, uint32_t length)
+{
+    ar_log_pkt_ring_t *ring;
+    ar_log_pkt_slot_t *slot;
+    ar_log_pkt_hdr_t *hdr;
+    uint32_t head, tail, offset, slot_size, pad_size, used;
+    uint64_t ts;
+
+    if (!atomic_load_explicit(&g_log_pkt_ctx.is_active, memory_order_acquire) ||
+        (length > (AR_LOG_PKT_MAX_SIZE - AR_LOG_PKT_HDR_SIZE)))
+        return NULL;
+
+    ring = ar_log_pkt_get_ring();
+    if (NULL == ring) {
+        atomic_fetch_add_explicit(&g_log_pkt_ctx.num_dropped, 1, memory_order_relaxed);
+        return NULL;
+    }
+
+    slot_size = AR_LOG_PKT_ALIGN(sizeof(ar_log_pkt_slot_t) + AR_LOG_PKT_HDR_SIZE + length);
+    head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    offset = head & (AR_LOG_PKT_RING_SIZE - 1);
+    used = head - tail;
+
+    /* packets are contiguous, skip the space till the end of the ring if needed */
+    pad_size = ((offset + slot_size) > AR_LOG_PKT_RING_SIZE) ? (AR_LOG_PKT_RING_SIZE - offset) : 0;
+
+    if ((used + pad_size + slot_size) > AR_LOG_PKT_RING_SIZE) {
+        ar_log_pkt_counter_inc(&ring->num_dropped);
+        ar_log_pkt_wake_writer();
+        return NULL;
+    }
+
+    if ((used + pad_size + slot_size) > AR_LOG_PKT_RING_HIGH_WATERMARK) {
+        ar_log_pkt_counter_inc(&ring->num_backpressured);
+        ar_log_pkt_wake_writer();
+    }
+
+    if (pad_size) {
+        slot = (ar_log_pkt_slot_t *)(ring->buf + offset);
+        slot->size = pad_size;
+        atomic_store_explicit(&slot->state, AR_LOG_PKT_SLOT_PAD, memory_order_relaxed);
+        offset = 0;
+    }
+
+    slot = (ar_log_pkt_slot_t *)(ring->buf + offset);
+    slot->size = slot_size;
+    atomic_store_explicit(&slot->state, AR_LOG_PKT_SLOT_RESERVED, memory_order_relaxed);
+
+    ts = ar_log_pkt_get_time_us();
+    hdr = (ar_log_pkt_hdr_t *)(slot + 1);
+    hdr->len = (uint16_t)(AR_LOG_PKT_HDR_SIZE + length);
+    hdr->code = logcode;
+    hdr->ts_lsw = (uint32_t)ts;
+    hdr->ts_msw = (uint32_t)(ts >> 32);
+
+    /* publish the slot headers */
+    atomic_store_explicit(&ring->head, head + pad_size + slot_size, memory_order_release);
+    ar_log_pkt_counter_inc(&ring->num_allocated);
+
+    return (uint8_t *)hdr + AR_LOG_PKT_HDR_SIZE;
+}
+
+static inline ar_log_pkt_slot_t *ar_log_pkt_get_slot(void *ptr)
+{
+    return (ar_log_pkt_slot_t *)((uint8_t *)ptr - AR_LOG_PKT_HDR_SIZE - sizeof(ar_log_pkt_slot_t));
+}
+
+int32_t ar_log_pkt_commit(void *ptr)
+{
+    if (NULL == ptr)
+        return AR_EBADPARAM;
+
+    /* the writer picks it up in its next period */
+    atomic_store_explicit(&ar_log_pkt_get_slot(ptr)->state, AR_LOG_PKT_SLOT_COMMITTED, memory_order_release);
+    return AR_EOK;
+}
+
+void ar_log_pkt_free(void *ptr)
+{
+    if (!ptr) return;
+
+    atomic_store_explicit(&ar_log_pkt_get_slot(ptr)->state, AR_LOG_PKT_SLOT_FREED, memory_order_release);
+}
+
+bool_t ar_log_code_status(uint16_t logcode)
+{
+    (void)logcode;
+    return atomic_load_explicit(&g_log_pkt_ctx.is_active, memory_order_acquire);
+}
+
+int32_t ar_log_pkt_get_stats(ar_log_pkt_stats_t *stats)
+{
+    ar_log_pkt_ring_t *ring;
+
+    if (NULL == stats)
+        return AR_EBADPARAM;
+
+    if (!atomic_load(&g_log_pkt_ctx.is_active))
+        return AR_ENOTREADY;
+
+    pthread_mutex_lock(&g_log_pkt_ctx.ring_free_lock);
+    stats->num_allocated = atomic_load_explicit(&g_log_pkt_ctx.num_allocated, memory_order_relaxed);
+    stats->num_dropped = atomic_load_explicit(&g_log_pkt_ctx.num_dropped, memory_order_relaxed);
+    stats->num_backpressured = atomic_load_explicit(&g_log_pkt_ctx.num_backpressured, memory_order_relaxed);
+    stats->num_written = atomic_load_explicit(&g_log_pkt_ctx.num_written, memory_order_relaxed);
+    stats->bytes_written = atomic_load_explicit(&g_log_pkt_ctx.bytes_written, memory_order_relaxed);
+    stats->num_write_errors = atomic_load_explicit(&g_log_pkt_ctx.num_write_errors, memory_order_relaxed);
+    stats->num_rotations = atomic_load_explicit(&g_log_pkt_ctx.num_rotations, memory_order_relaxed);
+
+    for (ring = atomic_load_explicit(&g_log_pkt_ctx.ring_list, memory_order_acquire); ring; ring = ring->next) {
+        stats->num_allocated += atomic_load_explicit(&ring->num_allocated, memory_order_relaxed);
+        stats->num_dropped += atomic_load_explicit(&ring->num_dropped, memory_order_relaxed);
+        stats->num_backpressured += atomic_load_explicit(&ring->num_backpressured, memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&g_log_pkt_ctx.ring_free_lock);
+
+    return AR_EOK;
+}
+
+int32_t ar_log_pkt_get_fd(void)
+{
+    return atomic_load(&g_log_pkt_ctx.is_active) ? g_log_pkt_ctx.fd : -1;
+}
@@ -75,6 +75,11 @@ static inline void __android_log_write(int prio, const char *tag, const char *ms
 
 uint32_t ar_log_lvl = (AR_CRITICAL|AR_ERROR|AR_INFO);
 
+/* all levels by default, as ar_log() doesn't filter */
+uint32_t ar_log_module_lvl[AR_LOG_MAX_MODULES] = {
+    [0 ... (AR_LOG_MAX_MODULES - 1)] = AR_LOG_ALL_LVL
+};
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void ar_log_init(void)
 {
@@ -95,6 +100,23 @@ void ar_log_init(void)
 #endif /* __ZEPHYR__ */
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void ar_set_log_level(uint32_t level)
+{
+    uint32_t i;
+
+    ar_log_lvl = level;
+    for (i = 0; i < AR_LOG_MAX_MODULES; i++)
+        ar_log_module_lvl[i] = level;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void ar_set_module_log_level(uint32_t module_id, uint32_t level)
+{
+    if (module_id < AR_LOG_MAX_MODULES)
+        ar_log_module_lvl[module_id] = level;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void ar_log(uint32_t level, const char_t* log_tag, const char_t* file,
         const char_t* fn, int32_t ln, const char_t* format, ...)
@@ -108,6 +130,12 @@ void ar_log(uint32_t level, const char_t* log_tag, const char_t* file,
     vsnprintf(buf, LOG_BUF_SIZE, buf_temp, ap);
     va_end(ap);
 
+    ar_log_write(level, log_tag, buf);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void ar_log_write(uint32_t level, const char_t *log_tag, const char_t *buf)
+{
     if (level == AR_DEBUG) {
         LOG_DEBUG(log_tag, buf);
     } else if (level == AR_INFO) {
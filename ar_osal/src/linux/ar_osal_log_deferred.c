@@ -0,0 +1,862 @@
+/**
+* \file ar_osal_log_deferred.c
+* \brief
+*    Defines the deferred logging APIs of ar_osal_log.h.
+*
+*    ar_log_deferred() runs on the logging thread, often a real time audio
+*    thread in the middle of a frame, so it only copies the call site
+*    pointer, a timestamp and the raw arguments into a single-producer/
+*    single-consumer ring owned by the thread. No lock, no system call and
+*    no formatting is done there.
+*
+*    A low priority formatter thread drains all rings every
+*    AR_LOG_DEFERRED_PERIOD_MS (earlier if a ring is filling up), merges
+*    the messages of the threads in timestamp order, formats them and
+*    writes them with ar_log_write().
+*
+*    The argument types of a call site are parsed from its format string
+*    once and cached in the site, see ar_log_site_t.
+*
+*    A record points to its call site, whose strings are owned by the
+*    logging library. ar_log_deferred_flush() writes all pending records,
+*    it must be called before such a library is unloaded. Producers
+*    announce themselves in a per-thread slot counter while they touch
+*    their ring, ar_log_deferred_deinit() waits for them before the rings
+*    are freed.
+*
+* \copyright
+*  Copyright (c) Qualcomm Innovation Center, Inc. All rights reserved.
+*  SPDX-License-Identifier: BSD-3-Clause-Clear
+*/
+
+#define _GNU_SOURCE
+#define AR_OSAL_LOG_DEFERRED_TAG  "COLD"
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdatomic.h>
+#include "ar_osal_log.h"
+#include "ar_osal_error.h"
+
+/* per thread ring, must be a power of 2 */
+#define AR_LOG_DEFERRED_RING_SIZE           (64 * 1024)
+/* formatter is woken up early once a ring is filled above this level */
+#define AR_LOG_DEFERRED_RING_HIGH_WATERMARK ((AR_LOG_DEFERRED_RING_SIZE / 4) * 3)
+#define AR_LOG_DEFERRED_PERIOD_MS           10
+#define AR_LOG_DEFERRED_MAX_STR_LEN         128
+#define AR_LOG_DEFERRED_MSG_SIZE            1024
+#define AR_LOG_DEFERRED_MAX_SPEC_LEN        32
+#define AR_LOG_DEFERRED_ALIGN(x)            (((x) + 7) & ~((uint32_t)7))
+/* producer counters, threads are spread over the slots to avoid sharing a cache line */
+#define AR_LOG_DEFERRED_NUM_SLOTS           16
+#define AR_LOG_DEFERRED_CACHE_LINE          64
+
+/* ar_log_site_t::arg_desc
+ *   bits 0..3   number of arguments
+ *   bits 4..59  4 bit type of each argument, first argument in the lowest bits
+ *   bit  62     format can't be deferred, always formatted by the calling thread
+ *   bit  63     descriptor is valid */
+#define AR_LOG_DESC_MAX_ARGS    14
+#define AR_LOG_DESC_SYNC_ONLY   (1ULL << 62)
+#define AR_LOG_DESC_VALID       (1ULL << 63)
+#define AR_LOG_DESC_NUM_ARGS(d) ((uint32_t)((d) & 0xF))
+#define AR_LOG_DESC_TYPE(d, i)  ((uint32_t)(((d) >> (4 + (4 * (i)))) & 0xF))
+
+typedef enum ar_log_arg_type_t
+{
+    AR_LOG_ARG_NONE = 0, /**< %% */
+    AR_LOG_ARG_INT,      /**< int and shorter */
+    AR_LOG_ARG_INT64,    /**< long long, and long/size_t/ptrdiff_t/intmax_t where 64 bit */
+    AR_LOG_ARG_DOUBLE,
+    AR_LOG_ARG_PTR,
+    AR_LOG_ARG_STR,
+    AR_LOG_ARG_UNSUPPORTED,
+} ar_log_arg_type_t;
+
+typedef struct ar_log_spec_t
+{
+    const char_t *start;    /**< '%' of the conversion */
+    uint32_t len;           /**< including '%' and the conversion character */
+    ar_log_arg_type_t type;
+} ar_log_spec_t;
+
+/* precedes every message in the ring, followed by the 64 bit arguments and the copied strings */
+typedef struct ar_log_rec_t
+{
+    uint32_t size;          /**< record size in bytes, including this header */
+    uint32_t is_pad;        /**< unused space till the end of the ring */
+    ar_log_site_t *site;
+    uint64_t ts_us;
+} ar_log_rec_t;
+
+typedef struct ar_log_ring_t
+{
+    struct ar_log_ring_t *next;
+    _Atomic uint32_t head;  /**< written by the producer */
+    _Atomic uint32_t tail;  /**< written by the formatter */
+    _Atomic uint32_t is_orphan;
+    /* written by the producer only */
+    _Atomic uint64_t num_logged;
+    _Atomic uint64_t num_dropped;
+    _Atomic uint64_t num_sync;
+    uint8_t *buf;
+} ar_log_ring_t;
+
+typedef struct ar_log_producer_slot_t
+{
+    _Atomic uint32_t num_producers; /**< threads of this slot between ar_log_producer_enter() and exit */
+} __attribute__((aligned(AR_LOG_DEFERRED_CACHE_LINE))) ar_log_producer_slot_t;
+
+typedef struct ar_log_deferred_ctx_t
+{
+    ar_log_producer_slot_t slots[AR_LOG_DEFERRED_NUM_SLOTS];
+    _Atomic uint32_t next_slot;
+    _Atomic bool_t is_active;
+    uint32_t generation;
+    pthread_key_t ring_key;
+    _Atomic(ar_log_ring_t *) ring_list;
+    pthread_mutex_t ring_free_lock;     /**< formatter vs. ar_log_deferred_get_stats, never taken by producers */
+    pthread_t formatter_thread;
+    sem_t formatter_sem;
+    _Atomic uint32_t wake_pending;
+    _Atomic bool_t stop_formatter;
+    uint64_t num_dropped_reported;      /**< formatter only */
+    /* counters of freed rings, of threads without a ring and of the formatter */
+    _Atomic uint64_t num_logged;
+    _Atomic uint64_t num_dropped;
+    _Atomic uint64_t num_sync;
+    _Atomic uint64_t num_emitted;
+    /* ar_log_deferred_flush() requests, a request is done once the formatter drained after reading it */
+    pthread_mutex_t flush_lock;
+    pthread_cond_t flush_cond;
+    uint64_t flush_req;
+    uint64_t flush_done;
+} ar_log_deferred_ctx_t;
+
+static ar_log_deferred_ctx_t g_log_deferred_ctx = {
+    .ring_free_lock = PTHREAD_MUTEX_INITIALIZER,
+    .flush_lock = PTHREAD_MUTEX_INITIALIZER,
+    .flush_cond = PTHREAD_COND_INITIALIZER,
+};
+
+/* caches the ring of the calling thread, valid only for the generation it was created in */
+static __thread ar_log_ring_t *tls_log_ring;
+static __thread uint32_t tls_log_ring_generation;
+/* producer slot of the calling thread plus 1, 0 until the first message */
+static __thread uint32_t tls_log_slot;
+
+static inline void ar_log_deferred_counter_inc(_Atomic uint64_t *counter)
+{
+    /* single writer, no need for an atomic read-modify-write */
+    atomic_store_explicit(counter,
+                          atomic_load_explicit(counter, memory_order_relaxed) + 1,
+                          memory_order_relaxed);
+}
+
+/* finds the next conversion of the format, returns the position after it or NULL at the end */
+static const char_t *ar_log_fmt_next(const char_t *fmt, ar_log_spec_t *spec)
+{
+    const char_t *p = strchr(fmt, '%');
+    uint32_t num_l = 0, num_h = 0;
+    bool_t is_size = false;
+
+    if (NULL == p)
+        return NULL;
+
+    spec->start = p++;
+    spec->type = AR_LOG_ARG_UNSUPPORTED;
+
+    /* flags, width and precision */
+    while (*p && strchr("-+ #0123456789.'*", *p)) {
+        if ('*' == *p) {
+            spec->len = (uint32_t)(p + 1 - spec->start);
+            return p + 1;
+        }
+        p++;
+    }
+
+    /* length */
+    for (;; p++) {
+        if ('l' == *p) {
+            num_l++;
+        } else if ('h' == *p) {
+            num_h++;
+        } else if (('j' == *p) || ('q' == *p)) {
+            num_l = 2;
+        } else if (('z' == *p) || ('t' == *p)) {
+            is_size = true;
+        } else if ('L' == *p) {
+            /* long double */
+            spec->len = (uint32_t)(p + 1 - spec->start);
+            return p + 1;
+        } else {
+            break;
+        }
+    }
+
+    switch (*p) {
+    case '%':
+        spec->type = AR_LOG_ARG_NONE;
+        break;
+    case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c':
+        if ((num_l >= 2) || ((1 == num_l) && (sizeof(long) == 8)) || (is_size && (sizeof(size_t) == 8)))
+            spec->type = AR_LOG_ARG_INT64;
+        else
+            spec->type = AR_LOG_ARG_INT;
+        (void)num_h;
+        break;
+    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+        spec->type = AR_LOG_ARG_DOUBLE;
+        break;
+    case 'p':
+        spec->type = AR_LOG_ARG_PTR;
+        break;
+    case 's':
+        spec->type = (0 == num_l) ? AR_LOG_ARG_STR : AR_LOG_ARG_UNSUPPORTED;
+        break;
+    case '\0':
+        /* trailing '%', printed as is */
+        spec->type = AR_LOG_ARG_NONE;
+        spec->len = (uint32_t)(p - spec->start);
+        return p;
+    default:
+        /* %n and anything unknown */
+        break;
+    }
+
+    spec->len = (uint32_t)(p + 1 - spec->start);
+    return p + 1;
+}
+
+static uint64_t ar_log_parse_format(const char_t *fmt)
+{
+    ar_log_spec_t spec;
+    uint64_t desc = 0;
+    uint32_t num_args = 0;
+
+    while (NULL != (fmt = ar_log_fmt_next(fmt, &spec))) {
+        if (AR_LOG_ARG_NONE == spec.type)
+            continue;
+        if ((AR_LOG_ARG_UNSUPPORTED == spec.type) || (num_args >= AR_LOG_DESC_MAX_ARGS))
+            return AR_LOG_DESC_VALID | AR_LOG_DESC_SYNC_ONLY;
+        desc |= ((uint64_t)spec.type) << (4 + (4 * num_args));
+        num_args++;
+    }
+
+    return AR_LOG_DESC_VALID | desc | num_args;
+}
+
+static uint64_t ar_log_get_desc(ar_log_site_t *site)
+{
+    uint64_t desc = __atomic_load_n(&site->arg_desc, __ATOMIC_RELAXED);
+
+    if (!(desc & AR_LOG_DESC_VALID)) {
+        /* threads racing here store the same value */
+        desc = ar_log_parse_format(site->format);
+        __atomic_store_n(&site->arg_desc, desc, __ATOMIC_RELAXED);
+    }
+    return desc;
+}
+
+/* formats the message from arguments already read from the va_list.
+ * strs[i] is the string of argument i if it is a %s. */
+static void ar_log_format(char_t *buf, uint32_t size, const ar_log_site_t *site,
+                          const uint64_t *args, const char_t *const *strs)
+{
+    const char_t *fmt = site->format;
+    const char_t *next;
+    char_t spec_buf[AR_LOG_DEFERRED_MAX_SPEC_LEN];
+    ar_log_spec_t spec;
+    uint32_t arg = 0;
+    int32_t n;
+    uint32_t len;
+    double dbl;
+
+    n = snprintf(buf, size, "%s:%s:%d ", site->file, site->fn, site->ln);
+    len = (n < 0) ? 0 : (((uint32_t)n >= size) ? (size - 1) : (uint32_t)n);
+
+    while ((len < (size - 1)) && (NULL != (next = ar_log_fmt_next(fmt, &spec)))) {
+        uint32_t lit_len = (uint32_t)(spec.start - fmt);
+        uint32_t spec_len = (spec.len < sizeof(spec_buf)) ? spec.len : (sizeof(spec_buf) - 1);
+
+        if (lit_len > (size - 1 - len))
+            lit_len = size - 1 - len;
+        memcpy(buf + len, fmt, lit_len);
+        len += lit_len;
+        fmt = next;
+
+        memcpy(spec_buf, spec.start, spec_len);
+        spec_buf[spec_len] = '\0';
+
+        switch (spec.type) {
+        case AR_LOG_ARG_INT:
+            n = snprintf(buf + len, size - len, spec_buf, (int)args[arg++]);
+            break;
+        case AR_LOG_ARG_INT64:
+            n = snprintf(buf + len, size - len, spec_buf, (long long)args[arg++]);
+            break;
+        case AR_LOG_ARG_DOUBLE:
+            memcpy(&dbl, &args[arg++], sizeof(dbl));
+            n = snprintf(buf + len, size - len, spec_buf, dbl);
+            break;
+        case AR_LOG_ARG_PTR:
+            n = snprintf(buf + len, size - len, spec_buf, (void *)(uintptr_t)args[arg++]);
+            break;
+        case AR_LOG_ARG_STR:
+            n = snprintf(buf + len, size - len, spec_buf, strs[arg] ? strs[arg] : "(null)");
+            arg++;
+            break;
+        default:
+            /* %% */
+            n = (spec.len > 1) ? snprintf(buf + len, size - len, "%%") : snprintf(buf + len, size - len, "%s", spec_buf);
+            break;
+        }
+        if (n > 0)
+            len = ((len + (uint32_t)n) >= size) ? (size - 1) : (len + (uint32_t)n);
+    }
+
+    /* rest of the format after the last conversion */
+    if (len < (size - 1)) {
+        uint32_t lit_len = (uint32_t)strlen(fmt);
+        if (lit_len > (size - 1 - len))
+            lit_len = size - 1 - len;
+        memcpy(buf + len, fmt, lit_len);
+        len += lit_len;
+    }
+    buf[len] = '\0';
+}
+
+static void ar_log_read_args(uint64_t desc, va_list ap, uint64_t *args, const char_t **strs)
+{
+    uint32_t i;
+    double dbl;
+
+    for (i = 0; i < AR_LOG_DESC_NUM_ARGS(desc); i++) {
+        strs[i] = NULL;
+        switch (AR_LOG_DESC_TYPE(desc, i)) {
+        case AR_LOG_ARG_INT:
+            args[i] = (uint64_t)(int64_t)va_arg(ap, int);
+            break;
+        case AR_LOG_ARG_INT64:
+            args[i] = (uint64_t)va_arg(ap, long long);
+            break;
+        case AR_LOG_ARG_DOUBLE:
+            dbl = va_arg(ap, double);
+            memcpy(&args[i], &dbl, sizeof(dbl));
+            break;
+        case AR_LOG_ARG_PTR:
+            args[i] = (uint64_t)(uintptr_t)va_arg(ap, void *);
+            break;
+        case AR_LOG_ARG_STR:
+            strs[i] = va_arg(ap, const char_t *);
+            args[i] = (uint64_t)(uintptr_t)strs[i];
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+static void ar_log_wake_formatter(void)
+{
+    if (0 == atomic_exchange_explicit(&g_log_deferred_ctx.wake_pending, 1, memory_order_acq_rel))
+        sem_post(&g_log_deferred_ctx.formatter_sem);
+}
+
+/* pthread key destructor, the formatter frees the ring once it is drained */
+static void ar_log_ring_orphan(void *arg)
+{
+    ar_log_ring_t *ring = (ar_log_ring_t *)arg;
+    atomic_store_explicit(&ring->is_orphan, 1, memory_order_release);
+}
+
+/* returns the producer counter of the calling thread if deferred logging is active, NULL otherwise.
+ * Until ar_log_producer_exit(), ar_log_deferred_deinit() doesn't free the rings. */
+static _Atomic uint32_t *ar_log_producer_enter(void)
+{
+    _Atomic uint32_t *num_producers;
+
+    if (!atomic_load_explicit(&g_log_deferred_ctx.is_active, memory_order_acquire))
+        return NULL;
+
+    if (0 == tls_log_slot)
+        tls_log_slot = 1 + (atomic_fetch_add_explicit(&g_log_deferred_ctx.next_slot, 1, memory_order_relaxed) %
+                            AR_LOG_DEFERRED_NUM_SLOTS);
+    num_producers = &g_log_deferred_ctx.slots[tls_log_slot - 1].num_producers;
+
+    /* pairs with deinit, which clears is_active before reading the counters: either deinit waits for this
+     * thread or this thread sees the logging inactive */
+    atomic_fetch_add_explicit(num_producers, 1, memory_order_seq_cst);
+    if (!atomic_load_explicit(&g_log_deferred_ctx.is_active, memory_order_seq_cst)) {
+        atomic_fetch_sub_explicit(num_producers, 1, memory_order_release);
+        return NULL;
+    }
+    return num_producers;
+}
+
+static void ar_log_producer_exit(_Atomic uint32_t *num_producers)
+{
+    if (num_producers)
+        atomic_fetch_sub_explicit(num_producers, 1, memory_order_release);
+}
+
+static ar_log_ring_t *ar_log_get_ring(void)
+{
+    ar_log_ring_t *ring;
+
+    if (tls_log_ring && (tls_log_ring_generation == g_log_deferred_ctx.generation))
+        return tls_log_ring;
+
+    /* first message of this thread */
+    ring = (ar_log_ring_t *)calloc(1, sizeof(ar_log_ring_t));
+    if (NULL == ring)
+        return NULL;
+
+    ring->buf = (uint8_t *)malloc(AR_LOG_DEFERRED_RING_SIZE);
+    if (NULL == ring->buf) {
+        free(ring);
+        return NULL;
+    }
+
+    ring->next = atomic_load_explicit(&g_log_deferred_ctx.ring_list, memory_order_relaxed);
+    while (!atomic_compare_exchange_weak_explicit(&g_log_deferred_ctx.ring_list, &ring->next, ring,
+                                                  memory_order_release, memory_order_relaxed))
+        ;
+
+    pthread_setspecific(g_log_deferred_ctx.ring_key, ring);
+    tls_log_ring = ring;
+    tls_log_ring_generation = g_log_deferred_ctx.generation;
+
+    return ring;
+}
+
+static uint64_t ar_log_get_time_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000) + ((uint64_t)ts.tv_nsec / 1000);
+}
+
+/* formats and writes the message from the calling thread */
+static void ar_log_sync(ar_log_site_t *site, uint64_t desc, va_list ap)
+{
+    char_t buf[AR_LOG_DEFERRED_MSG_SIZE];
+    uint64_t args[AR_LOG_DESC_MAX_ARGS];
+    const char_t *strs[AR_LOG_DESC_MAX_ARGS];
+
+    if (desc & AR_LOG_DESC_SYNC_ONLY) {
+        char_t buf_temp[AR_LOG_DEFERRED_MSG_SIZE];
+        snprintf(buf_temp, sizeof(buf_temp), "%s:%s:%d %s", site->file, site->fn, site->ln, site->format);
+        vsnprintf(buf, sizeof(buf), buf_temp, ap);
+    } else {
+        ar_log_read_args(desc, ap, args, strs);
+        ar_log_format(buf, sizeof(buf), site, args, strs);
+    }
+
+    ar_log_write(site->level, site->log_tag, buf);
+}
+
+/* copies the message into the ring, returns FALSE if the ring is full */
+static bool_t ar_log_record(ar_log_ring_t *ring, ar_log_site_t *site, uint64_t desc, va_list ap)
+{
+    uint64_t args[AR_LOG_DESC_MAX_ARGS];
+    const char_t *strs[AR_LOG_DESC_MAX_ARGS];
+    uint32_t str_lens[AR_LOG_DESC_MAX_ARGS];
+    uint32_t num_args = AR_LOG_DESC_NUM_ARGS(desc);
+    uint32_t strs_size = 0;
+    uint32_t head, tail, offset, rec_size, pad_size, used, i;
+    ar_log_rec_t *rec;
+    uint8_t *dst;
+
+    ar_log_read_args(desc, ap, args, strs);
+
+    for (i = 0; i < num_args; i++) {
+        if (strs[i]) {
+            str_lens[i] = (uint32_t)strnlen(strs[i], AR_LOG_DEFERRED_MAX_STR_LEN);
+            strs_size += str_lens[i] + 1;
+        }
+    }
+
+    rec_size = AR_LOG_DEFERRED_ALIGN(sizeof(ar_log_rec_t) + (num_args * sizeof(uint64_t)) + strs_size);
+    head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    offset = head & (AR_LOG_DEFERRED_RING_SIZE - 1);
+    used = head - tail;
+
+    /* records are contiguous, skip the space till the end of the ring if needed */
+    pad_size = ((offset + rec_size) > AR_LOG_DEFERRED_RING_SIZE) ? (AR_LOG_DEFERRED_RING_SIZE - offset) : 0;
+
+    if ((used + pad_size + rec_size) > AR_LOG_DEFERRED_RING_SIZE) {
+        ar_log_wake_formatter();
+        return false;
+    }
+
+    if ((used + pad_size + rec_size) > AR_LOG_DEFERRED_RING_HIGH_WATERMARK)
+        ar_log_wake_formatter();
+
+    if (pad_size) {
+        rec = (ar_log_rec_t *)(ring->buf + offset);
+        rec->size = pad_size;
+        rec->is_pad = 1;
+        offset = 0;
+    }
+
+    rec = (ar_log_rec_t *)(ring->buf + offset);
+    rec->size = rec_size;
+    rec->is_pad = 0;
+    rec->site = site;
+    rec->ts_us = ar_log_get_time_us();
+
+    dst = (uint8_t *)(rec + 1);
+    memcpy(dst, args, num_args * sizeof(uint64_t));
+    dst += num_args * sizeof(uint64_t);
+    for (i = 0; i < num_args; i++) {
+        if (strs[i]) {
+            memcpy(dst, strs[i], str_lens[i]);
+            dst[str_lens[i]] = '\0';
+            dst += str_lens[i] + 1;
+        }
+    }
+
+    /* publish the record */
+    atomic_store_explicit(&ring->head, head + pad_size + rec_size, memory_order_release);
+    return true;
+}
+
+void ar_log_deferred(ar_log_site_t *site, ...)
+{
+    ar_log_ring_t *ring = NULL;
+    uint64_t desc = ar_log_get_desc(site);
+    _Atomic uint32_t *num_producers = ar_log_producer_enter();
+    va_list ap;
+
+    va_start(ap, site);
+
+    if (num_producers && !(desc & AR_LOG_DESC_SYNC_ONLY) && (AR_CRITICAL != site->level))
+        ring = ar_log_get_ring();
+
+    if (NULL == ring) {
+        /* critical messages usually precede an abort, don't leave them in the ring */
+        ar_log_sync(site, desc, ap);
+        if (num_producers) {
+            if (tls_log_ring && (tls_log_ring_generation == g_log_deferred_ctx.generation))
+                ar_log_deferred_counter_inc(&tls_log_ring->num_sync);
+            else
+                atomic_fetch_add_explicit(&g_log_deferred_ctx.num_sync, 1, memory_order_relaxed);
+        }
+    } else if (ar_log_record(ring, site, desc, ap)) {
+        ar_log_deferred_counter_inc(&ring->num_logged);
+    } else {
+        ar_log_deferred_counter_inc(&ring->num_dropped);
+    }
+
+    va_end(ap);
+    ar_log_producer_exit(num_producers);
+}
+
+/* skips padding, returns the next committed record of the ring or NULL */
+static ar_log_rec_t *ar_log_ring_peek(ar_log_ring_t *ring)
+{
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+    while (tail != head) {
+        ar_log_rec_t *rec = (ar_log_rec_t *)(ring->buf + (tail & (AR_LOG_DEFERRED_RING_SIZE - 1)));
+        if (!rec->is_pad)
+            return rec;
+        tail += rec->size;
+        atomic_store_explicit(&ring->tail, tail, memory_order_release);
+    }
+    return NULL;
+}
+
+static void ar_log_emit_rec(const ar_log_rec_t *rec)
+{
+    char_t msg[AR_LOG_DEFERRED_MSG_SIZE];
+    char_t buf[AR_LOG_DEFERRED_MSG_SIZE + 32];
+    const char_t *strs[AR_LOG_DESC_MAX_ARGS];
+    const ar_log_site_t *site = rec->site;
+    uint64_t desc = __atomic_load_n(&site->arg_desc, __ATOMIC_RELAXED);
+    uint32_t num_args = AR_LOG_DESC_NUM_ARGS(desc);
+    const uint64_t *args = (const uint64_t *)(rec + 1);
+    const char_t *str = (const char_t *)(args + num_args);
+    uint32_t i;
+
+    for (i = 0; i < num_args; i++) {
+        strs[i] = NULL;
+        if (AR_LOG_ARG_STR == AR_LOG_DESC_TYPE(desc, i)) {
+            strs[i] = str;
+            str += strlen(str) + 1;
+        }
+    }
+
+    ar_log_format(msg, sizeof(msg), site, args, strs);
+    /* the message is written late, keep the time at which it was logged */
+    snprintf(buf, sizeof(buf), "@%llu.%06llu %s",
+             (unsigned long long)(rec->ts_us / 1000000), (unsigned long long)(rec->ts_us % 1000000), msg);
+    ar_log_write(site->level, site->log_tag, buf);
+    atomic_fetch_add_explicit(&g_log_deferred_ctx.num_emitted, 1, memory_order_relaxed);
+}
+
+static void ar_log_free_ring(ar_log_ring_t *ring)
+{
+    atomic_fetch_add_explicit(&g_log_deferred_ctx.num_logged,
+                              atomic_load_explicit(&ring->num_logged, memory_order_relaxed),
+                              memory_order_relaxed);
+    atomic_fetch_add_explicit(&g_log_deferred_ctx.num_dropped,
+                              atomic_load_explicit(&ring->num_dropped, memory_order_relaxed),
+                              memory_order_relaxed);
+    atomic_fetch_add_explicit(&g_log_deferred_ctx.num_sync,
+                              atomic_load_explicit(&ring->num_sync, memory_order_relaxed),
+                              memory_order_relaxed);
+    free(ring->buf);
+    free(ring);
+}
+
+static uint64_t ar_log_get_num_dropped(void)
+{
+    uint64_t num_dropped = atomic_load_explicit(&g_log_deferred_ctx.num_dropped, memory_order_relaxed);
+    ar_log_ring_t *ring;
+
+    for (ring = atomic_load_explicit(&g_log_deferred_ctx.ring_list, memory_order_acquire); ring; ring = ring->next)
+        num_dropped += atomic_load_explicit(&ring->num_dropped, memory_order_relaxed);
+    return num_dropped;
+}
+
+/* writes the messages of all rings in timestamp order, frees rings of exited threads.
+ * Only the formatter removes rings from the list. */
+static void ar_log_drain_all(void)
+{
+    ar_log_ring_t *prev = NULL;
+    ar_log_ring_t *ring;
+    uint64_t num_dropped;
+
+    for (;;) {
+        ar_log_ring_t *min_ring = NULL;
+        ar_log_rec_t *min_rec = NULL;
+
+        for (ring = atomic_load_explicit(&g_log_deferred_ctx.ring_list, memory_order_acquire); ring; ring = ring->next) {
+            ar_log_rec_t *rec = ar_log_ring_peek(ring);
+            if (rec && (!min_rec || (rec->ts_us < min_rec->ts_us))) {
+                min_rec = rec;
+                min_ring = ring;
+            }
+        }
+        if (NULL == min_rec)
+            break;
+
+        ar_log_emit_rec(min_rec);
+        atomic_store_explicit(&min_ring->tail,
+                              atomic_load_explicit(&min_ring->tail, memory_order_relaxed) + min_rec->size,
+                              memory_order_release);
+    }
+
+    num_dropped = ar_log_get_num_dropped();
+    if (num_dropped != g_log_deferred_ctx.num_dropped_reported) {
+        char_t buf[96];
+        snprintf(buf, sizeof(buf), "%s: %llu log messages dropped, ring full", __func__,
+                 (unsigned long long)(num_dropped - g_log_deferred_ctx.num_dropped_reported));
+        ar_log_write(AR_ERROR, AR_OSAL_LOG_DEFERRED_TAG, buf);
+        g_log_deferred_ctx.num_dropped_reported = num_dropped;
+    }
+
+    ring = atomic_load_explicit(&g_log_deferred_ctx.ring_list, memory_order_acquire);
+    while (ring) {
+        ar_log_ring_t *next = ring->next;
+        bool_t is_orphan = atomic_load_explicit(&ring->is_orphan, memory_order_acquire);
+
+        if (is_orphan && (NULL == ar_log_ring_peek(ring))) {
+            pthread_mutex_lock(&g_log_deferred_ctx.ring_free_lock);
+            if (prev) {
+                prev->next = next;
+            } else {
+                ar_log_ring_t *expected = ring;
+                /* new rings are pushed at the head, unlink from the new predecessor in that case */
+                if (!atomic_compare_exchange_strong_explicit(&g_log_deferred_ctx.ring_list, &expected, next,
+                                                             memory_order_acq_rel, memory_order_acquire)) {
+                    prev = expected;
+                    while (prev->next != ring)
+                        prev = prev->next;
+                    prev->next = next;
+                }
+            }
+            ar_log_free_ring(ring);
+            pthread_mutex_unlock(&g_log_deferred_ctx.ring_free_lock);
+        } else {
+            prev = ring;
+        }
+        ring = next;
+    }
+}
+
+/* drains all rings, then completes the flush requests made before */
+static void ar_log_drain_and_flush(void)
+{
+    uint64_t flush_req;
+
+    pthread_mutex_lock(&g_log_deferred_ctx.flush_lock);
+    flush_req = g_log_deferred_ctx.flush_req;
+    pthread_mutex_unlock(&g_log_deferred_ctx.flush_lock);
+
+    ar_log_drain_all();
+
+    if (flush_req != g_log_deferred_ctx.flush_done) {
+        pthread_mutex_lock(&g_log_deferred_ctx.flush_lock);
+        g_log_deferred_ctx.flush_done = flush_req;
+        pthread_cond_broadcast(&g_log_deferred_ctx.flush_cond);
+        pthread_mutex_unlock(&g_log_deferred_ctx.flush_lock);
+    }
+}
+
+static void *ar_log_formatter(void *arg)
+{
+    struct timespec ts;
+
+    (void)arg;
+    pthread_setname_np(pthread_self(), "ar_log_fmt");
+
+    while (!atomic_load_explicit(&g_log_deferred_ctx.stop_formatter, memory_order_acquire)) {
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_nsec += AR_LOG_DEFERRED_PERIOD_MS * 1000000;
+        if (ts.tv_nsec >= 1000000000) {
+            ts.tv_sec++;
+            ts.tv_nsec -= 1000000000;
+        }
+        sem_timedwait(&g_log_deferred_ctx.formatter_sem, &ts);
+        atomic_store_explicit(&g_log_deferred_ctx.wake_pending, 0, memory_order_release);
+
+        ar_log_drain_and_flush();
+    }
+
+    /* final drain of whatever was logged before deinit */
+    ar_log_drain_and_flush();
+    return NULL;
+}
+
+int32_t ar_log_deferred_init(void)
+{
+    if (atomic_load(&g_log_deferred_ctx.is_active))
+        return AR_EALREADY;
+
+    if (pthread_key_create(&g_log_deferred_ctx.ring_key, ar_log_ring_orphan))
+        return AR_EFAILED;
+
+    if (sem_init(&g_log_deferred_ctx.formatter_sem, 0, 0)) {
+        pthread_key_delete(g_log_deferred_ctx.ring_key);
+        return AR_EFAILED;
+    }
+
+    atomic_store(&g_log_deferred_ctx.ring_list, NULL);
+    atomic_store(&g_log_deferred_ctx.wake_pending, 0);
+    atomic_store(&g_log_deferred_ctx.stop_formatter, false);
+    atomic_store(&g_log_deferred_ctx.num_logged, 0);
+    atomic_store(&g_log_deferred_ctx.num_dropped, 0);
+    atomic_store(&g_log_deferred_ctx.num_sync, 0);
+    atomic_store(&g_log_deferred_ctx.num_emitted, 0);
+    g_log_deferred_ctx.num_dropped_reported = 0;
+    /* invalidates rings cached by threads in an earlier init */
+    g_log_deferred_ctx.generation++;
+
+    /* default attributes: SCHED_OTHER, below the real time audio threads */
+    if (pthread_create(&g_log_deferred_ctx.formatter_thread, NULL, ar_log_formatter, NULL)) {
+        AR_LOG_ERR(AR_OSAL_LOG_DEFERRED_TAG, "%s: failed to create formatter thread\n", __func__);
+        sem_destroy(&g_log_deferred_ctx.formatter_sem);
+        pthread_key_delete(g_log_deferred_ctx.ring_key);
+        return AR_EFAILED;
+    }
+
+    atomic_store_explicit(&g_log_deferred_ctx.is_active, true, memory_order_release);
+    return AR_EOK;
+}
+
+/* messages logged concurrently with deinit are either formatted by the calling thread or written by the
+ * final drain of the formatter */
+int32_t ar_log_deferred_deinit(void)
+{
+    ar_log_ring_t *ring;
+    uint32_t i;
+
+    if (!atomic_load(&g_log_deferred_ctx.is_active))
+        return AR_EOK;
+
+    atomic_store_explicit(&g_log_deferred_ctx.is_active, false, memory_order_seq_cst);
+
+    /* producers which saw the logging active may still write to their rings or create one */
+    for (i = 0; i < AR_LOG_DEFERRED_NUM_SLOTS; i++) {
+        while (atomic_load_explicit(&g_log_deferred_ctx.slots[i].num_producers, memory_order_seq_cst))
+            sched_yield();
+    }
+
+    atomic_store_explicit(&g_log_deferred_ctx.stop_formatter, true, memory_order_release);
+    sem_post(&g_log_deferred_ctx.formatter_sem);
+    pthread_join(g_log_deferred_ctx.formatter_thread, NULL);
+
+    ring = atomic_exchange(&g_log_deferred_ctx.ring_list, NULL);
+    while (ring) {
+        ar_log_ring_t *next = ring->next;
+        ar_log_free_ring(ring);
+        ring = next;
+    }
+
+    /* destructors are not called for a deleted key */
+    pthread_key_delete(g_log_deferred_ctx.ring_key);
+    sem_destroy(&g_log_deferred_ctx.formatter_sem);
+
+    return AR_EOK;
+}
+
+int32_t ar_log_deferred_flush(void)
+{
+    _Atomic uint32_t *num_producers = ar_log_producer_enter();
+    uint64_t flush_req;
+
+    /* inactive, nothing is pending */
+    if (NULL == num_producers)
+        return AR_EOK;
+
+    pthread_mutex_lock(&g_log_deferred_ctx.flush_lock);
+    flush_req = ++g_log_deferred_ctx.flush_req;
+    pthread_mutex_unlock(&g_log_deferred_ctx.flush_lock);
+
+    ar_log_wake_formatter();
+
+    /* deinit waits for this thread, so the formatter keeps running till the request is done */
+    pthread_mutex_lock(&g_log_deferred_ctx.flush_lock);
+    while (g_log_deferred_ctx.flush_done < flush_req)
+        pthread_cond_wait(&g_log_deferred_ctx.flush_cond, &g_log_deferred_ctx.flush_lock);
+    pthread_mutex_unlock(&g_log_deferred_ctx.flush_lock);
+
+    ar_log_producer_exit(num_producers);
+    return AR_EOK;
+}
+
+int32_t ar_log_deferred_get_stats(ar_log_deferred_stats_t *stats)
+{
+    ar_log_ring_t *ring;
+
+    if (NULL == stats)
+        return AR_EBADPARAM;
+
+    if (!atomic_load(&g_log_deferred_ctx.is_active))
+        return AR_ENOTREADY;
+
+    pthread_mutex_lock(&g_log_deferred_ctx.ring_free_lock);
+    stats->num_logged = atomic_load_explicit(&g_log_deferred_ctx.num_logged, memory_order_relaxed);
+    stats->num_dropped = atomic_load_explicit(&g_log_deferred_ctx.num_dropped, memory_order_relaxed);
+    stats->num_sync = atomic_load_explicit(&g_log_deferred_ctx.num_sync, memory_order_relaxed);
+    stats->num_emitted = atomic_load_explicit(&g_log_deferred_ctx.num_emitted, memory_order_relaxed);
+
+    for (ring = atomic_load_explicit(&g_log_deferred_ctx.ring_list, memory_order_acquire); ring; ring = ring->next) {
+        stats->num_logged += atomic_load_explicit(&ring->num_logged, memory_order_relaxed);
+        stats->num_dropped += atomic_load_explicit(&ring->num_dropped, memory_order_relaxed);
+        stats->num_sync += atomic_load_explicit(&ring->num_sync, memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&g_log_deferred_ctx.ring_free_lock);
+
+    return AR_EOK;
+}
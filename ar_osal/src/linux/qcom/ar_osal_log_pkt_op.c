@@ -166,4 +166,33 @@ void ar_log_pkt_free(void *ptr)
 bool_t ar_log_code_status(uint16_t logcode)
 {
     return ar_osal_log_status(logcode);
-}
\ No newline at end of file
+}
+
+/**
+* \brief ar_log_pkt_get_stats
+*
+*        Counters are not available through diag
+*
+* \param[out] stats: unused
+*
+* \return
+*  AR_EUNSUPPORTED
+*/
+int32_t ar_log_pkt_get_stats(ar_log_pkt_stats_t *stats)
+{
+    (void)stats;
+    return AR_EUNSUPPORTED;
+}
+
+/**
+* \brief ar_log_pkt_get_fd
+*
+*        Diag does not log to a file descriptor
+*
+* \return
+*  -1
+*/
+int32_t ar_log_pkt_get_fd(void)
+{
+    return -1;
+}
@@ -0,0 +1,316 @@
+/*
+ * ar_osal_file_log_pkt_op_test.c
+ *
+ * Tests of the file log packet data transport. Producer threads log packets
+ * which carry their thread index and a sequence number, the file is parsed
+ * afterwards and every packet in it must be intact and in order per thread.
+ * The file size limit is set low so that the memfd is truncated and the file
+ * is rotated several times.
+ *
+ * Copyright (c) Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "ar_osal_log_pkt_op.h"
+#include "ar_osal_log.h"
+#include "ar_osal_error.h"
+#include "ar_osal_file_log_pkt_op_test.h"
+
+#define TEST_LOG_TAG "LPTS"
+#define TEST_NUM_THREADS 4
+#define TEST_NUM_PKTS 20000
+#define TEST_LOG_CODE 0x1586
+#define TEST_MAX_FILE_SIZE (256 * 1024)
+#define TEST_FILE_HDR_SIZE 16
+#define TEST_PKT_HDR_SIZE 12
+#define TEST_WAIT_MS 5000
+/*every n-th packet is freed instead of committed*/
+#define TEST_FREE_EVERY 7
+
+typedef struct test_payload_t {
+    uint32_t thread_idx;
+    uint32_t seq;
+} test_payload_t;
+
+typedef struct test_file_result_t {
+    uint32_t num_pkts;
+    uint32_t num_bad;
+    /*first and last sequence number per thread, UINT32_MAX if none*/
+    uint32_t first_seq[TEST_NUM_THREADS];
+    uint32_t last_seq[TEST_NUM_THREADS];
+} test_file_result_t;
+
+static uint32_t test_payload_len(uint32_t seq)
+{
+    return sizeof(test_payload_t) + ((seq * 37) % 200);
+}
+
+/*sequence number of the last committed packet*/
+static uint32_t test_last_seq(void)
+{
+    uint32_t seq = TEST_NUM_PKTS - 1;
+
+    while (0 == (seq % TEST_FREE_EVERY))
+        seq--;
+    return seq;
+}
+
+static int32_t test_log_pkts(uint32_t thread_idx, uint32_t num_pkts, uint32_t *num_committed)
+{
+    uint32_t seq, i, len;
+    uint8_t *ptr;
+
+    for (seq = 0; seq < num_pkts; seq++) {
+        len = test_payload_len(seq);
+        /*a full ring is drained by the writer within its period*/
+        while (NULL == (ptr = (uint8_t *)ar_log_pkt_alloc(TEST_LOG_CODE, len)))
+            usleep(1000);
+
+        ((test_payload_t *)ptr)->thread_idx = thread_idx;
+        ((test_payload_t *)ptr)->seq = seq;
+        for (i = sizeof(test_payload_t); i < len; i++)
+            ptr[i] = (uint8_t)(seq + i);
+
+        if (0 == (seq % TEST_FREE_EVERY)) {
+            ar_log_pkt_free(ptr);
+        } else if (AR_EOK == ar_log_pkt_commit(ptr)) {
+            __atomic_add_fetch(num_committed, 1, __ATOMIC_RELAXED);
+        }
+    }
+    return AR_EOK;
+}
+
+typedef struct test_thread_arg_t {
+    uint32_t thread_idx;
+    uint32_t *num_committed;
+} test_thread_arg_t;
+
+static void *test_producer(void *arg)
+{
+    test_thread_arg_t *t = (test_thread_arg_t *)arg;
+
+    test_log_pkts(t->thread_idx, TEST_NUM_PKTS, t->num_committed);
+    return NULL;
+}
+
+/*waits until the writer wrote every committed packet*/
+static int32_t test_wait_written(uint32_t num_committed, ar_log_pkt_stats_t *stats)
+{
+    uint32_t ms;
+
+    for (ms = 0; ms < TEST_WAIT_MS; ms++) {
+        if (ar_log_pkt_get_stats(stats))
+            return AR_EFAILED;
+        if (stats->num_written >= num_committed)
+            return AR_EOK;
+        usleep(1000);
+    }
+    AR_LOG_ERR(TEST_LOG_TAG, "%s: %llu of %u packets written\n", __func__,
+               (unsigned long long)stats->num_written, num_committed);
+    return AR_EFAILED;
+}
+
+/*parses a log packet file, checks every packet and the order per thread*/
+static int32_t test_parse_file(int fd, test_file_result_t *res)
+{
+    struct stat st;
+    uint8_t *buf;
+    uint32_t off, i;
+    uint32_t magic;
+
+    memset(res, 0, sizeof(*res));
+    for (i = 0; i < TEST_NUM_THREADS; i++) {
+        res->first_seq[i] = UINT32_MAX;
+        res->last_seq[i] = UINT32_MAX;
+    }
+
+    if (fstat(fd, &st) || (st.st_size < TEST_FILE_HDR_SIZE) || (st.st_size > TEST_MAX_FILE_SIZE)) {
+        AR_LOG_ERR(TEST_LOG_TAG, "%s: bad file size %lld\n", __func__, (long long)st.st_size);
+        return AR_EFAILED;
+    }
+
+    buf = (uint8_t *)malloc(st.st_size);
+    if ((NULL == buf) || (pread(fd, buf, st.st_size, 0) != st.st_size)) {
+        free(buf);
+        return AR_EFAILED;
+    }
+
+    memcpy(&magic, buf, sizeof(magic));
+    if (0x504C5241 != magic) {
+        AR_LOG_ERR(TEST_LOG_TAG, "%s: bad file header 0x%x\n", __func__, magic);
+        res->num_bad++;
+    }
+
+    for (off = TEST_FILE_HDR_SIZE; off + TEST_PKT_HDR_SIZE <= (uint32_t)st.st_size;) {
+        uint16_t len, code;
+        test_payload_t p;
+        uint8_t *payload = buf + off + TEST_PKT_HDR_SIZE;
+
+        memcpy(&len, buf + off, sizeof(len));
+        memcpy(&code, buf + off + 2, sizeof(code));
+        if ((len < TEST_PKT_HDR_SIZE + sizeof(p)) || (off + len > (uint32_t)st.st_size) ||
+            (TEST_LOG_CODE != code)) {
+            res->num_bad++;
+            break;
+        }
+        memcpy(&p, payload, sizeof(p));
+        if ((p.thread_idx >= TEST_NUM_THREADS) || (len != TEST_PKT_HDR_SIZE + test_payload_len(p.seq)) ||
+            (0 == (p.seq % TEST_FREE_EVERY)) ||
+            ((UINT32_MAX != res->last_seq[p.thread_idx]) && (p.seq <= res->last_seq[p.thread_idx]))) {
+            res->num_bad++;
+        } else {
+            for (i = sizeof(p); i < (uint32_t)(len - TEST_PKT_HDR_SIZE); i++) {
+                if (payload[i] != (uint8_t)(p.seq + i)) {
+                    res->num_bad++;
+                    break;
+                }
+            }
+            if (UINT32_MAX == res->first_seq[p.thread_idx])
+                res->first_seq[p.thread_idx] = p.seq;
+            res->last_seq[p.thread_idx] = p.seq;
+        }
+        res->num_pkts++;
+        off += len;
+    }
+    if (off != (uint32_t)st.st_size)
+        res->num_bad++;
+
+    free(buf);
+    return res->num_bad ? AR_EFAILED : AR_EOK;
+}
+
+/*producer threads log to a memfd which is truncated whenever it is full*/
+static int32_t test_memfd(void)
+{
+    ar_log_pkt_op_init_info_t info;
+    ar_log_pkt_stats_t stats;
+    test_thread_arg_t args[TEST_NUM_THREADS];
+    pthread_t threads[TEST_NUM_THREADS];
+    test_file_result_t res;
+    uint32_t num_committed = 0;
+    int32_t rc;
+    int fd;
+    uint32_t i;
+
+    memset(&info, 0, sizeof(info));
+    info.data_transport = AR_LOG_DATA_TRANSPORT_FILE;
+    info.max_file_size = TEST_MAX_FILE_SIZE;
+    if (ar_log_pkt_op_init(&info))
+        return AR_EFAILED;
+
+    for (i = 0; i < TEST_NUM_THREADS; i++) {
+        args[i].thread_idx = i;
+        args[i].num_committed = &num_committed;
+        pthread_create(&threads[i], NULL, test_producer, &args[i]);
+    }
+    for (i = 0; i < TEST_NUM_THREADS; i++)
+        pthread_join(threads[i], NULL);
+
+    rc = test_wait_written(num_committed, &stats);
+    fd = dup(ar_log_pkt_get_fd());
+    ar_log_pkt_op_deinit();
+
+    if (AR_EOK == rc)
+        rc = test_parse_file(fd, &res);
+    close(fd);
+
+    AR_LOG_INFO(TEST_LOG_TAG, "%s: committed %u written %llu rotations %llu, %u packets in file, %u bad\n",
+                __func__, num_committed, (unsigned long long)stats.num_written,
+                (unsigned long long)stats.num_rotations, res.num_pkts, res.num_bad);
+
+    /*the memfd keeps the packets after the last truncation, this includes the very last one*/
+    for (i = 0; (AR_EOK == rc) && (i < TEST_NUM_THREADS); i++) {
+        if (res.last_seq[i] == test_last_seq())
+            break;
+    }
+    if ((AR_EOK == rc) && (TEST_NUM_THREADS == i)) {
+        AR_LOG_ERR(TEST_LOG_TAG, "%s: no thread's last packet in the file\n", __func__);
+        rc = AR_EFAILED;
+    }
+    if ((AR_EOK == rc) && (0 == stats.num_rotations)) {
+        AR_LOG_ERR(TEST_LOG_TAG, "%s: memfd was never truncated\n", __func__);
+        rc = AR_EFAILED;
+    }
+    return rc;
+}
+
+/*a named file is rotated to <path>.1, both stay below the limit and continue each other*/
+static int32_t test_file_rotation(void)
+{
+    ar_log_pkt_op_init_info_t info;
+    ar_log_pkt_stats_t stats;
+    test_file_result_t res, res_rotated;
+    char dir[] = "/tmp/ar_log_pkt_testXXXXXX";
+    char path[64], rotated_path[64];
+    uint32_t num_committed = 0;
+    int32_t rc;
+    int fd, fd_rotated;
+
+    if (NULL == mkdtemp(dir))
+        return AR_EFAILED;
+    snprintf(path, sizeof(path), "%s/log.bin", dir);
+    snprintf(rotated_path, sizeof(rotated_path), "%s/log.bin.1", dir);
+
+    memset(&info, 0, sizeof(info));
+    info.data_transport = AR_LOG_DATA_TRANSPORT_FILE;
+    info.file_path = path;
+    info.max_file_size = TEST_MAX_FILE_SIZE;
+    if (ar_log_pkt_op_init(&info))
+        return AR_EFAILED;
+
+    test_log_pkts(0, TEST_NUM_PKTS, &num_committed);
+    rc = test_wait_written(num_committed, &stats);
+    ar_log_pkt_op_deinit();
+
+    fd = open(path, O_RDONLY);
+    fd_rotated = open(rotated_path, O_RDONLY);
+    if ((fd < 0) || (fd_rotated < 0)) {
+        AR_LOG_ERR(TEST_LOG_TAG, "%s: log files missing\n", __func__);
+        rc = AR_EFAILED;
+    }
+    if (AR_EOK == rc)
+        rc = test_parse_file(fd, &res);
+    if (AR_EOK == rc)
+        rc = test_parse_file(fd_rotated, &res_rotated);
+
+    /*the current file continues where the rotated one ends, nothing is lost in between*/
+    if ((AR_EOK == rc) &&
+        ((test_last_seq() != res.last_seq[0]) || (UINT32_MAX == res_rotated.last_seq[0]) ||
+         (res.first_seq[0] != res_rotated.last_seq[0] + 1 +
+                                  (0 == ((res_rotated.last_seq[0] + 1) % TEST_FREE_EVERY))))) {
+        AR_LOG_ERR(TEST_LOG_TAG, "%s: rotated file ends at %u, file has %u..%u\n", __func__,
+                   res_rotated.last_seq[0], res.first_seq[0], res.last_seq[0]);
+        rc = AR_EFAILED;
+    }
+    if ((AR_EOK == rc) && (stats.num_rotations < 2)) {
+        AR_LOG_ERR(TEST_LOG_TAG, "%s: %llu rotations\n", __func__, (unsigned long long)stats.num_rotations);
+        rc = AR_EFAILED;
+    }
+
+    if (fd >= 0)
+        close(fd);
+    if (fd_rotated >= 0)
+        close(fd_rotated);
+    unlink(path);
+    unlink(rotated_path);
+    rmdir(dir);
+    return rc;
+}
+
+int32_t ar_osal_file_log_pkt_op_test(void)
+{
+    int32_t rc = AR_EOK;
+
+    rc |= test_memfd();
+    rc |= test_file_rotation();
+
+    AR_LOG_INFO(TEST_LOG_TAG, "%s: %s\n", __func__, rc ? "FAILED" : "passed");
+    return rc;
+}
@@ -0,0 +1,17 @@
+/*
+ * ar_osal_file_log_pkt_op_test.h
+ *
+ * Tests of the file log packet data transport.
+ *
+ * Copyright (c) Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+#ifndef AR_OSAL_FILE_LOG_PKT_OP_TEST_H
+#define AR_OSAL_FILE_LOG_PKT_OP_TEST_H
+
+#include <stdint.h>
+
+/*Runs the tests in the calling process, returns AR_EOK on success*/
+int32_t ar_osal_file_log_pkt_op_test(void);
+
+#endif /* AR_OSAL_FILE_LOG_PKT_OP_TEST_H */
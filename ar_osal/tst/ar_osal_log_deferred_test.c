@@ -0,0 +1,131 @@
+/*
+ * ar_osal_log_deferred_test.c
+ *
+ * Tests of the deferred logging:
+ * - threads keep logging while the deferred logging is inited and deinited
+ *   over and over, no ring may be used after it was freed
+ * - a call site whose strings are freed after ar_log_deferred_flush(), as
+ *   when a library is unloaded, must not be read afterwards
+ * Both are meant to run with AddressSanitizer.
+ *
+ * Copyright (c) Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "ar_osal_log.h"
+#include "ar_osal_error.h"
+#include "ar_osal_log_deferred_test.h"
+
+#define TEST_LOG_TAG "LDTS"
+#define TEST_NUM_THREADS 4
+#define TEST_NUM_CYCLES 200
+#define TEST_NUM_FLUSH_MSGS 500
+
+static _Atomic bool_t test_stop;
+static _Atomic uint64_t test_num_msgs;
+
+static void *test_producer(void *arg)
+{
+    static ar_log_site_t site = { AR_VERBOSE, TEST_LOG_TAG, __FILE__, "test_producer", __LINE__,
+                                  "thread %d message %llu %s", 0 };
+    int thread_idx = (int)(intptr_t)arg;
+    unsigned long long seq = 0;
+
+    while (!atomic_load(&test_stop)) {
+        ar_log_deferred(&site, thread_idx, seq++, "payload");
+        atomic_fetch_add(&test_num_msgs, 1);
+    }
+    return NULL;
+}
+
+/*threads log while the deferred logging is inited and deinited*/
+static int32_t test_deinit_race(void)
+{
+    pthread_t threads[TEST_NUM_THREADS];
+    int32_t rc = AR_EOK;
+    uint32_t i, cycle;
+
+    atomic_store(&test_stop, false);
+    for (i = 0; i < TEST_NUM_THREADS; i++)
+        pthread_create(&threads[i], NULL, test_producer, (void *)(intptr_t)i);
+
+    for (cycle = 0; (cycle < TEST_NUM_CYCLES) && (AR_EOK == rc); cycle++) {
+        rc = ar_log_deferred_init();
+        usleep((cycle % 3) * 500);
+        ar_log_deferred_deinit();
+    }
+
+    atomic_store(&test_stop, true);
+    for (i = 0; i < TEST_NUM_THREADS; i++)
+        pthread_join(threads[i], NULL);
+
+    AR_LOG_INFO(TEST_LOG_TAG, "%s: %u cycles, %llu messages\n", __func__, cycle,
+                (unsigned long long)atomic_load(&test_num_msgs));
+    return rc;
+}
+
+/*a call site in memory which goes away after the flush, like the data of an unloaded library*/
+static int32_t test_flush(void)
+{
+    ar_log_deferred_stats_t stats;
+    ar_log_site_t *site;
+    char_t *format;
+    int32_t rc;
+    uint32_t i;
+
+    if (ar_log_deferred_init())
+        return AR_EFAILED;
+
+    site = (ar_log_site_t *)calloc(1, sizeof(*site));
+    format = strdup("flushed message %u of %s");
+    if ((NULL == site) || (NULL == format)) {
+        free(site);
+        free(format);
+        ar_log_deferred_deinit();
+        return AR_EFAILED;
+    }
+    site->level = AR_VERBOSE;
+    site->log_tag = TEST_LOG_TAG;
+    site->file = __FILE__;
+    site->fn = __func__;
+    site->ln = __LINE__;
+    site->format = format;
+
+    for (i = 0; i < TEST_NUM_FLUSH_MSGS; i++)
+        ar_log_deferred(site, i, "the site");
+
+    rc = ar_log_deferred_flush();
+    if ((AR_EOK == rc) && (AR_EOK == (rc = ar_log_deferred_get_stats(&stats)))) {
+        if ((stats.num_emitted != stats.num_logged) ||
+            ((stats.num_logged + stats.num_dropped) != TEST_NUM_FLUSH_MSGS)) {
+            AR_LOG_ERR(TEST_LOG_TAG, "%s: %llu logged, %llu dropped, %llu emitted after flush\n", __func__,
+                       (unsigned long long)stats.num_logged, (unsigned long long)stats.num_dropped,
+                       (unsigned long long)stats.num_emitted);
+            rc = AR_EFAILED;
+        }
+    }
+
+    /*the library is unloaded, the formatter must not look at the site anymore*/
+    memset(format, 0, strlen(format));
+    free(format);
+    free(site);
+
+    ar_log_deferred_deinit();
+    return rc;
+}
+
+int32_t ar_osal_log_deferred_test(void)
+{
+    int32_t rc = AR_EOK;
+
+    rc |= test_deinit_race();
+    rc |= test_flush();
+
+    AR_LOG_INFO(TEST_LOG_TAG, "%s: %s\n", __func__, rc ? "FAILED" : "passed");
+    return rc;
+}
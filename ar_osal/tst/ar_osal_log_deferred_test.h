@@ -0,0 +1,17 @@
+/*
+ * ar_osal_log_deferred_test.h
+ *
+ * Tests of the deferred logging.
+ *
+ * Copyright (c) Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+#ifndef AR_OSAL_LOG_DEFERRED_TEST_H
+#define AR_OSAL_LOG_DEFERRED_TEST_H
+
+#include <stdint.h>
+
+/*Runs the tests in the calling process, returns AR_EOK on success*/
+int32_t ar_osal_log_deferred_test(void);
+
+#endif /* AR_OSAL_LOG_DEFERRED_TEST_H */
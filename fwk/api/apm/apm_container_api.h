@@ -489,6 +489,43 @@ struct apm_cont_prop_id_thread_core_affinity_t
 ;
 typedef struct apm_cont_prop_id_thread_core_affinity_t apm_cont_prop_id_thread_core_affinity_t;
 
+/*--------------------------------------------------------------------------------------------------------------------*/
+/** @ingroup spf_apm_container_props
+    Container property identifier for processing independent parallel paths concurrently.
+
+    @msgpayload
+    apm_cont_prop_id_parallel_paths_t
+*/
+#define APM_CONTAINER_PROP_ID_PARALLEL_PATHS                        0x08001AA1
+
+/*# @h2xmlp_property    {"Parallel Paths", APM_CONTAINER_PROP_ID_PARALLEL_PATHS}
+    @h2xmlp_description {Container property ID for processing independent parallel paths concurrently.} */
+
+/** Value of number of worker threads that disables concurrent processing of parallel paths.*/
+#define APM_CONT_PARALLEL_PATHS_DISABLED    0
+
+/** @ingroup spf_apm_container_props
+    Payload for #APM_CONTAINER_PROP_ID_PARALLEL_PATHS.
+ */
+#include "spf_begin_pack.h"
+struct apm_cont_prop_id_parallel_paths_t
+{
+   uint32_t num_worker_threads;
+   /**< Number of worker threads used to process the independent parallel paths of the container concurrently.
+    * The container thread processes one of the paths itself. Support available only on certain platforms
+    * (E.g. Linux) and only for containers that are not in island.
+    */
+
+   /*#< @h2xmle_range       {0..31}
+        @h2xmle_default     {APM_CONT_PARALLEL_PATHS_DISABLED}
+        @h2xmle_description {Number of worker threads used to process independent parallel paths of the container
+           concurrently. Value of zero disables concurrent processing and the paths are processed one after another.
+         } */
+}
+#include "spf_end_pack.h"
+;
+typedef struct apm_cont_prop_id_parallel_paths_t apm_cont_prop_id_parallel_paths_t;
+
 /** @ingroup spf_apm_container_props
     Container property identifier for the peer heap ID.
 
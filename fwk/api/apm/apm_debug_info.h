@@ -315,6 +315,65 @@ struct apm_param_id_port_media_format_t
 #include "spf_end_pack.h"
 ;
 typedef struct apm_param_id_port_media_format_t apm_param_id_port_media_format_t;
+
+/** @ingroup spf_apm_debug_info
+    Payload for #APM_PARAM_ID_SPF_BUFMGR_STATS.
+    Immediately following this structure are num_size_classes structures of
+    apm_spf_bufmgr_class_stats_t, one per size class in increasing buf_size.
+    This param can be only be used with APM_CMD_GET_CFG */
+#define APM_PARAM_ID_SPF_BUFMGR_STATS 0x08001B70
+
+#include "spf_begin_pack.h"
+struct apm_spf_bufmgr_class_stats_t
+{
+   uint32_t buf_size;
+   /**< Size of the buffers of this class in bytes. */
+
+   uint32_t num_prealloc;
+   /**< Number of buffers preallocated at init. */
+
+   uint32_t num_bufs;
+   /**< Number of buffers currently owned by the class, preallocated and grown. */
+
+   uint32_t num_in_use;
+   /**< Number of buffers currently in use. */
+
+   uint32_t max_in_use;
+   /**< High-water of the number of buffers in use. */
+
+   uint32_t num_grown;
+   /**< Number of buffers allocated from heap to grow the class. */
+
+   uint32_t num_shrunk;
+   /**< Number of grown buffers freed back to heap. */
+
+   uint32_t num_borrowed;
+   /**< Number of buffers used for requests of a smaller class. */
+}
+#include "spf_end_pack.h"
+;
+typedef struct apm_spf_bufmgr_class_stats_t apm_spf_bufmgr_class_stats_t;
+
+#include "spf_begin_pack.h"
+struct apm_param_id_spf_bufmgr_stats_t
+{
+   uint32_t num_heap_allocs;
+   /**< Number of requests which could not be served by the size classes. */
+
+   uint32_t grown_bytes;
+   /**< Bytes currently allocated by the size classes beyond the preallocated buffers. */
+
+   uint32_t num_size_classes;
+   /**< Number of size classes following this structure. */
+#ifdef __H2XML__
+   apm_spf_bufmgr_class_stats_t class_stats[0];
+   /*#< @h2xmle_description {Statistics of each size class.}
+        @h2xmle_variableArraySize  { "num_size_classes" } */
+#endif
+}
+#include "spf_end_pack.h"
+;
+typedef struct apm_param_id_spf_bufmgr_stats_t apm_param_id_spf_bufmgr_stats_t;
 /*====================================================================================================================*/
 /*====================================================================================================================*/
 /*--------------------------------------------------------------------------------------------------------------------*/
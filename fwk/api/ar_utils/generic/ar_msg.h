@@ -87,17 +87,58 @@
 #define LOCAL_FILE_NAME AR_NON_GUID(__FILE__)
 #endif
 
+/* Component of the calling code, selects its runtime level mask in ar_log_module_lvl
+ * (see ar_set_module_log_level()). The build assigns it per library, see spf_build_static_library(). */
+#define AR_MSG_MODULE_ID_FWK   0
+#define AR_MSG_MODULE_ID_POSAL 1
+#define AR_MSG_MODULE_ID_APM   2
+#define AR_MSG_MODULE_ID_CNTR  3
+#define AR_MSG_MODULE_ID_CAPI  4
+
+#ifndef AR_MSG_MODULE_ID
+#define AR_MSG_MODULE_ID AR_MSG_MODULE_ID_FWK
+#endif
+
+/* Lowest priority compiled in, messages below it are removed at compile time */
+#ifndef AR_MSG_MIN_PRIO
+#define AR_MSG_MIN_PRIO AR_LOW_PRIO
+#endif
+
+#define AR_MSG_IS_ENABLED(xx_ss_mask) \
+   ((AR_LOG_LVL_MASK_FROM(AR_MSG_MIN_PRIO) & (xx_ss_mask)) && (ar_log_module_lvl[AR_MSG_MODULE_ID] & (xx_ss_mask)))
+
 #undef AR_MSG_LOG
 
-#if ARSDK_BUILD_ENABLED
+#if ARSDK_BUILD_ENABLED && defined(AR_MSG_DEFERRED)
+/* Messages are recorded by the calling thread and formatted later by the ar_osal formatter thread,
+ * see ar_log_deferred(). xx_ss_mask and xx_fmt must be constants. */
 #define AR_MSG_LOG( xx_ss_sid, xx_ss_mask, xx_fmt, ...) \
    do { \
       if (ar_log_debugmsg_enable) \
       { \
-         static const char *msg_tag = AR_MSG_TAG; \
-         static const char filename[] = LOCAL_FILE_NAME; \
-         static const uint32_t line_no = __LINE__; \
-         ar_log( xx_ss_mask, msg_tag, filename, __FUNCTION__, line_no, xx_fmt, ##__VA_ARGS__); \
+         if (AR_MSG_IS_ENABLED(xx_ss_mask)) \
+         { \
+            static ar_log_site_t ar_log_site = { xx_ss_mask, AR_MSG_TAG, LOCAL_FILE_NAME, __FUNCTION__, __LINE__, xx_fmt, 0 }; \
+            ar_log_deferred(&ar_log_site, ##__VA_ARGS__); \
+         } \
+         if (DBG_FATAL_PRIO == (xx_ss_mask)) \
+         { \
+            assert(0); \
+         } \
+      } \
+   } while(0)
+#elif ARSDK_BUILD_ENABLED
+#define AR_MSG_LOG( xx_ss_sid, xx_ss_mask, xx_fmt, ...) \
+   do { \
+      if (ar_log_debugmsg_enable) \
+      { \
+         if (AR_MSG_IS_ENABLED(xx_ss_mask)) \
+         { \
+            static const char *msg_tag = AR_MSG_TAG; \
+            static const char filename[] = LOCAL_FILE_NAME; \
+            static const uint32_t line_no = __LINE__; \
+            ar_log( xx_ss_mask, msg_tag, filename, __FUNCTION__, line_no, xx_fmt, ##__VA_ARGS__); \
+         } \
          if (DBG_FATAL_PRIO == (xx_ss_mask)) \
          { \
             assert(0); \
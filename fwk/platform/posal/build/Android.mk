@@ -40,6 +40,7 @@ LOCAL_SRC_FILES := \
     src/generic/posal_thread_profiling.c \
     src/generic/posal_thread_util.c \
     src/linux/posal.c \
+    src/linux/posal_bufpool_thread_cache.c \
     src/linux/posal_cache_island.c \
     src/linux/posal_cache.c \
     src/linux/posal_condvar.c \
@@ -47,6 +48,7 @@ LOCAL_SRC_FILES := \
     src/linux/posal_linux_signal.c \
     src/linux/posal_linux_stubs.c \
     src/linux/posal_linux_thread.c \
+    src/linux/posal_heapmgr.c \
     src/linux/posal_mem_prof.c \
     src/linux/posal_memory.c \
     src/linux/posal_memory_island.c \
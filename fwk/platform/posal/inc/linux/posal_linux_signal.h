@@ -20,11 +20,27 @@
 /* ----------------------------------------------------------------------------
  * Global Declarations/Definitions
  * ------------------------------------------------------------------------- */
+/* On Linux the signal is a bit mask word with futex wait/wake, setting a bit
+   takes a system call only when a thread sleeps on the signal. Other targets
+   of the linux posal, such as Zephyr, use a mutex and condition variable. */
+#if defined(__linux__) && !defined(__ZEPHYR__)
+#define POSAL_LINUX_SIGNAL_USES_FUTEX
+#endif
+
+#if defined(POSAL_LINUX_SIGNAL_USES_FUTEX)
+typedef struct {
+    uint32_t signalled;
+    /**< Bit mask of the set signals, also the futex word waiters sleep on. */
+    uint32_t num_waiters;
+    /**< Number of threads sleeping or about to sleep on the futex word. */
+}posal_linux_signal_internal_t;
+#else
 typedef struct {
     pthread_cond_t created_signal;
     uint32_t signalled;
     pthread_mutex_t mutex_handle;
 }posal_linux_signal_internal_t;
+#endif
 
 typedef void *posal_linux_signal_t;
 
@@ -18,8 +18,19 @@
 
 /**
  * maximum number of heaps (determined by number of bits used for actual heap)
+ * heap ids 1..7 are available to posal_memory_heapmgr_create_v2, 0 is the default heap
  */
-#define POSAL_HEAP_MGR_MAX_NUM_HEAPS 1
+#define POSAL_HEAP_MGR_MAX_NUM_HEAPS 7
+
+/**
+ * Number of nodes each thread may cache per buffer pool (per-thread magazines).
+ * posal_bufpool_get_node/return_node are served from the calling thread's magazine without taking
+ * the pool mutex; refill and drain move half a magazine at a time under the mutex.
+ * Leave undefined to disable the magazines.
+ */
+#ifndef __ZEPHYR__
+#define POSAL_BUFPOOL_MAGAZINE_SIZE 16
+#endif
 
 /**
  * Controls buffer pool reserved for queue elements.
@@ -61,8 +61,19 @@ typedef struct
 
 /** posal timer structure. */
 typedef struct {
-  timer_t*         timer_obj;
-  /**< Pointer to timer object. */
+  uint64_t          expiry_time;
+  /**< Absolute time (in microseconds) of the next expiry while the timer is
+       armed. */
+
+  int32_t           heap_idx;
+  /**< Position of the timer in the timer service queue, -1 when the timer is
+       not armed. */
+
+  uint32_t          notification_type;
+  /**< Client notification type; see #posal_timer_client_notification_type_t. */
+
+  posal_timer_callback_info_t cb_info;
+  /**< Callback to invoke when the timer expires, for callback timers. */
 
   uint64_t          timer_start_time;
 
@@ -97,7 +97,8 @@ ar_result_t posal_memory_heapmgr_create_v2(POSAL_HEAP_ID *          heap_id_ptr,
   @param[in] heap_id  ID of the heap.
 
   @return
-  Status of the heap manager deletion.
+  Status of the heap manager deletion. AR_EBUSY if blocks allocated from the
+  heap are not freed yet; the heap is left intact in that case.
 
   @dependencies
   Before calling this function, the object must be created and initialized.
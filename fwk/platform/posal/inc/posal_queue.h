@@ -63,6 +63,10 @@ typedef struct posal_queue_init_attr_t
    /**< Heap ID from which nodes are to be allocated. */
    bool_t        is_priority_queue;
    /**< FALSE: default FIFO queue, TRUE: Priority queue. */
+   bool_t        is_spsc_queue;
+   /**< FALSE: default mutex protected queue, TRUE: lock-free single-producer/single-consumer queue.
+        Exactly one thread may push (push_back) and exactly one thread may pop (pop_front/peek).
+        All max_nodes elements are preallocated, insert_front and pop_back are not supported. */
 }posal_queue_init_attr_t;
 
 /*
@@ -466,6 +470,7 @@ static inline void posal_queue_attr_init(posal_queue_init_attr_t *attr_ptr)
    attr_ptr->max_nodes         = 0;
    attr_ptr->heap_id           = POSAL_HEAP_DEFAULT;
    attr_ptr->is_priority_queue = FALSE;
+   attr_ptr->is_spsc_queue     = FALSE;
 }
 
 /** Setup the attribute 'name' for the queue */
@@ -498,6 +503,12 @@ static inline void posal_queue_attr_set_priority_queue_mode(posal_queue_init_att
    attr_ptr->is_priority_queue = is_priority_queue ? TRUE : FALSE;
 }
 
+/** Setup the attribute 'is_spsc_queue' for the queue */
+static inline void posal_queue_attr_set_spsc_mode(posal_queue_init_attr_t *attr_ptr, bool_t is_spsc_queue)
+{
+   attr_ptr->is_spsc_queue = is_spsc_queue ? TRUE : FALSE;
+}
+
 /**
   Locks the mutext for the queue.
 
@@ -32,6 +32,24 @@ extern posal_bufpool_pool_t *all_pools[POSAL_BUFPOOL_MAX_POOLS];
 /* =======================================================================
 **                          Function Definitions
 ** ======================================================================= */
+/* Number of nodes of the pool parked in thread magazines, i.e. marked used in the bitmask but not owned by clients */
+static uint32_t posal_bufpool_num_cached_nodes_(uint32_t pool_index)
+{
+#ifdef POSAL_BUFPOOL_MAGAZINE_SIZE
+   return posal_bufpool_get_num_cached_nodes(pool_index);
+#else
+   return 0;
+#endif
+}
+
+/* Makes every thread drop the nodes it has cached for this pool on its next access */
+static void posal_bufpool_invalidate_magazines_(uint32_t pool_index)
+{
+#ifdef POSAL_BUFPOOL_MAGAZINE_SIZE
+   __atomic_add_fetch(&posal_bufpool_pool_gen[pool_index], 1, __ATOMIC_RELEASE);
+#endif
+}
+
 uint32_t posal_bufpool_pool_create(uint16_t              node_size,
                                    POSAL_HEAP_ID         heap_id,
                                    uint32_t              num_arrays,
@@ -75,6 +93,13 @@ uint32_t posal_bufpool_pool_create(uint16_t              node_size,
    pool_ptr->num_of_node_arrays = num_arrays;
    pool_ptr->align_padding_size = (alignment == EIGHT_BYTE_ALIGN) ? 4 : 0;
    pool_ptr->nodes_per_arr      = nodes_per_arr;
+#ifdef POSAL_BUFPOOL_MAGAZINE_SIZE
+   // Nodes parked in a magazine are marked used, keep them a small share of the pool so that other threads do not
+   // run dry. Small pools, e.g. the LPI pools, are not cached.
+   uint32_t mag_depth  = (num_arrays * nodes_per_arr) / POSAL_BUFPOOL_MAGAZINE_POOL_SHARE;
+   mag_depth           = (mag_depth > POSAL_BUFPOOL_MAGAZINE_SIZE) ? POSAL_BUFPOOL_MAGAZINE_SIZE : (mag_depth & ~1u);
+   pool_ptr->mag_depth = (mag_depth >= POSAL_BUFPOOL_MAGAZINE_MIN_DEPTH) ? mag_depth : 0;
+#endif
    result                       = posal_bufpool_allocate_new_nodes_arr(pool_ptr, 0, i);
    if (AR_DID_FAIL(result))
    {
@@ -146,6 +171,9 @@ void posal_bufpool_pool_destroy(uint32_t pool_handle)
    posal_bufpool_pool_t *pool_ptr = all_pools[pool_index];
    posal_mutex_lock(pool_ptr->pool_mutex);
    AR_MSG(DBG_HIGH_PRIO, "Bufpool: Destroying pool %lu", pool_index);
+   // nodes parked in thread magazines are not leaks, they are dropped through the generation bump
+   bool_t report_leaks = (pool_ptr->used_nodes > posal_bufpool_num_cached_nodes_(pool_index));
+   posal_bufpool_invalidate_magazines_(pool_index);
    for (uint32_t i = 0; i < pool_ptr->num_of_node_arrays; i++)
    {
       if (pool_ptr->nodes_ptr[i].mem_start_addr)
@@ -153,14 +181,17 @@ void posal_bufpool_pool_destroy(uint32_t pool_handle)
          if (pool_ptr->nodes_ptr[i].list_bitmask)
          {
             // Force to zero
-            AR_MSG(DBG_ERROR_PRIO,
-                   "Bufpool error: Freeing, but all nodes aren't returned! Pool index %lu, list index %lu, bitmask "
-                   "0x%lx",
-                   pool_index,
-                   i,
-                   pool_ptr->nodes_ptr[i].list_bitmask);
+            if (report_leaks)
+            {
+               AR_MSG(DBG_ERROR_PRIO,
+                      "Bufpool error: Freeing, but all nodes aren't returned! Pool index %lu, list index %lu, "
+                      "bitmask 0x%lx",
+                      pool_index,
+                      i,
+                      pool_ptr->nodes_ptr[i].list_bitmask);
+               BUFPOOL_ASSERT();
+            }
             pool_ptr->nodes_ptr[i].list_bitmask = 0;
-            BUFPOOL_ASSERT();
          }
          posal_bufpool_free_nodes_arr(pool_ptr, i);
       }
@@ -183,6 +214,8 @@ void posal_bufpool_pool_reset_to_base(uint32_t pool_handle)
    }
    posal_bufpool_pool_t *pool_ptr = all_pools[pool_index];
    posal_mutex_lock(pool_ptr->pool_mutex);
+   bool_t report_leaks = (pool_ptr->used_nodes > posal_bufpool_num_cached_nodes_(pool_index));
+   posal_bufpool_invalidate_magazines_(pool_index);
    // List at index 0 should be allocated by default
    if (NULL == pool_ptr->nodes_ptr[0].mem_start_addr)
    {
@@ -190,12 +223,15 @@ void posal_bufpool_pool_reset_to_base(uint32_t pool_handle)
    }
    else if (pool_ptr->nodes_ptr[0].list_bitmask)
    {
-      AR_MSG(DBG_ERROR_PRIO,
-             "Bufpool error: All nodes aren't returned! Pool index %lu, bitmask 0x%lx",
-             pool_index,
-             pool_ptr->nodes_ptr[0].list_bitmask);
+      if (report_leaks)
+      {
+         AR_MSG(DBG_ERROR_PRIO,
+                "Bufpool error: All nodes aren't returned! Pool index %lu, bitmask 0x%lx",
+                pool_index,
+                pool_ptr->nodes_ptr[0].list_bitmask);
+         BUFPOOL_ASSERT();
+      }
       pool_ptr->nodes_ptr[0].list_bitmask = 0;
-      BUFPOOL_ASSERT();
    }
    // free all other lists
    for (uint32_t i = 1; i < pool_ptr->num_of_node_arrays; i++)
@@ -206,14 +242,17 @@ void posal_bufpool_pool_reset_to_base(uint32_t pool_handle)
          {
             // TODO: should we force to zero? this is only used on sim, and if we free even when nodes are not returned
             // there won't be any eventual mem leak seen, though arguably one should be
-            AR_MSG(DBG_ERROR_PRIO,
-                   "Bufpool error: Freeing, but all nodes aren't returned! Pool index %lu, list index %lu, bitmask "
-                   "0x%lx",
-                   pool_index,
-                   i,
-                   pool_ptr->nodes_ptr[i].list_bitmask);
+            if (report_leaks)
+            {
+               AR_MSG(DBG_ERROR_PRIO,
+                      "Bufpool error: Freeing, but all nodes aren't returned! Pool index %lu, list index %lu, "
+                      "bitmask 0x%lx",
+                      pool_index,
+                      i,
+                      pool_ptr->nodes_ptr[i].list_bitmask);
+               BUFPOOL_ASSERT();
+            }
             pool_ptr->nodes_ptr[i].list_bitmask = 0;
-            BUFPOOL_ASSERT();
          }
 
          posal_bufpool_free_nodes_arr(pool_ptr, i);
@@ -283,6 +322,10 @@ ar_result_t posal_bufpool_profile_mem_usage(uint32_t pool_handle, uint32_t* byte
       }
    }
 
+   // nodes cached by thread magazines are free from the client's point of view
+   uint32_t nodes_cached = posal_bufpool_num_cached_nodes_(pool_index);
+   nodes_used            = (nodes_used > nodes_cached) ? (nodes_used - nodes_cached) : 0;
+
    *bytes_used_ptr = nodes_used * pool_ptr->node_size;
    posal_mutex_unlock(pool_ptr->pool_mutex);
 
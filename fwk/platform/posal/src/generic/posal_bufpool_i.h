@@ -42,6 +42,15 @@ INCLUDE FILES FOR MODULE
 // Magic number for pool node, limited to 8 bits
 #define POSAL_BUFPOOL_NODE_MAGIC (0x5a)
 
+// Magic number for a node parked in a per-thread magazine, limited to 8 bits
+#define POSAL_BUFPOOL_NODE_CACHED_MAGIC (0xa5)
+
+// A magazine holds at most 1/POSAL_BUFPOOL_MAGAZINE_POOL_SHARE of the pool capacity
+#define POSAL_BUFPOOL_MAGAZINE_POOL_SHARE (16)
+
+// Pools whose magazines would be shallower than this are not cached at all
+#define POSAL_BUFPOOL_MAGAZINE_MIN_DEPTH (4)
+
 /*--------------------------------------------------------------*/
 /* Type definitions                                             */
 /* -------------------------------------------------------------*/
@@ -65,6 +74,7 @@ typedef struct posal_bufpool_pool_t
    uint16_t				  align_padding_size; /*alignment of the pointer to be returned to the client. (sizeof posal_bufpool_node_header)*/
    POSAL_HEAP_ID 		  heap_id;       /* heap id used for allocating for this pool */
    posal_mutex_t 		  pool_mutex;    /*< Mutex to prevent simultaneous access*/
+   uint16_t               mag_depth;     /* nodes a thread magazine may hold for this pool, 0 if not cached */
 } posal_bufpool_pool_t;
 
 /* Header added to each node. Uses a union to ensure proper alignment if pointer types are
@@ -85,6 +95,29 @@ typedef struct posal_bufpool_node_header_t
    };
 } posal_bufpool_node_header_t;
 
+#ifdef POSAL_BUFPOOL_MAGAZINE_SIZE
+/* Per-thread stash of free nodes of one pool. It is modified by the thread that holds busy: the owning
+ * thread, or a thread that drains it back to an exhausted pool. num_nodes is read by the profiling path
+ * of other threads. */
+typedef struct posal_bufpool_magazine_t
+{
+   uint32_t busy;      /* set while a thread works on the magazine, only ever try-acquired */
+   uint32_t pool_gen;  /* posal_bufpool_pool_gen[] of the pool when the nodes were cached */
+   uint32_t num_nodes; /* number of valid entries in node_ptrs */
+   posal_bufpool_node_header_t *node_ptrs[POSAL_BUFPOOL_MAGAZINE_SIZE];
+} posal_bufpool_magazine_t;
+
+/* Per-thread cache: one magazine per pool, linked into a global list for profiling */
+typedef struct posal_bufpool_thread_cache_t
+{
+   struct posal_bufpool_thread_cache_t *next_ptr;
+   posal_bufpool_magazine_t             magazines[POSAL_BUFPOOL_MAX_POOLS];
+} posal_bufpool_thread_cache_t;
+
+/* Generation of each pool slot, bumped on create, destroy and reset so that stale magazines are dropped */
+extern uint32_t posal_bufpool_pool_gen[POSAL_BUFPOOL_MAX_POOLS];
+#endif // POSAL_BUFPOOL_MAGAZINE_SIZE
+
 /*--------------------------------------------------------------*/
 /* Function Declarations/definitions                            */
 /* -------------------------------------------------------------*/
@@ -95,6 +128,24 @@ void posal_bufpool_free_nodes_arr(posal_bufpool_pool_t *pool_ptr, uint32_t index
 
 ar_result_t validate_handle(uint32_t handle, uint32_t *index);
 
+#ifdef POSAL_BUFPOOL_MAGAZINE_SIZE
+/* Target specific: returns the calling thread's cache, creating it on first use. NULL if unavailable. */
+posal_bufpool_thread_cache_t *posal_bufpool_get_thread_cache(void);
+
+/* Target specific: number of nodes of the given pool currently parked in all thread caches */
+uint32_t posal_bufpool_get_num_cached_nodes(uint32_t pool_index);
+
+/* Returns all nodes held by the cache to their pools. Called when the owning thread exits. */
+void posal_bufpool_thread_cache_flush(posal_bufpool_thread_cache_t *cache_ptr);
+
+/* Target specific: returns the nodes that other threads cache for an exhausted pool to the pool. Called with
+ * pool_mutex held. Magazines in use at that moment are skipped. Returns the number of nodes returned. */
+uint32_t posal_bufpool_drain_thread_caches(posal_bufpool_pool_t *pool_ptr, uint32_t pool_index);
+
+/* Returns all nodes of a magazine to its pool. Called with pool_mutex and the magazine's busy flag held. */
+uint32_t posal_bufpool_magazine_return_all_locked(posal_bufpool_pool_t *pool_ptr, posal_bufpool_magazine_t *mag_ptr);
+#endif // POSAL_BUFPOOL_MAGAZINE_SIZE
+
 //void toggle_bit_in_list_bitmask_at_idx(posal_bufpool_pool_t *pool_ptr, uint32_t index, uint32_t pos);
 
 //uint32_t get_first_zero_idx_in_list_bitmask(posal_bufpool_pool_t *pool_ptr, uint32_t index);
@@ -25,6 +25,9 @@ INCLUDE FILES FOR MODULE
  * will be created statically at bootup from a single thread, and destroy will not
  * be called while any nodes are still pending */
 posal_bufpool_pool_t *all_pools[POSAL_BUFPOOL_MAX_POOLS];
+#ifdef POSAL_BUFPOOL_MAGAZINE_SIZE
+uint32_t posal_bufpool_pool_gen[POSAL_BUFPOOL_MAX_POOLS];
+#endif
 /* Number of free nodes that should be present in overall pool for a node array to be freed
  * 48 includes the 32 nodes about to be freed, plus 16 more in other lists, to ensure that we don't
  * get stuck freeing-reallocating too frequently
@@ -107,30 +110,24 @@ ar_result_t posal_bufpool_allocate_new_nodes_arr(posal_bufpool_pool_t *pool_ptr,
    return posal_bufpool_allocate_new_nodes_arr_util_(pool_ptr,index,  pool_index);
 }
 
-void *posal_bufpool_get_node(uint32_t pool_handle)
+/* Takes one node out of the pool. Must be called with pool_mutex held. Node arrays are only allocated if
+ * allow_grow is set, otherwise just the free nodes of the arrays already allocated are considered. */
+static void *posal_bufpool_get_node_locked_(posal_bufpool_pool_t *pool_ptr, uint32_t pool_index, bool_t allow_grow)
 {
-   uint32_t    pool_index;
+   void *      node_to_return = NULL;
+   uint32_t    next_node_idx;
    ar_result_t result;
 
-   if (AR_DID_FAIL(validate_handle(pool_handle, &pool_index)))
-   {
-      AR_MSG_ISLAND(DBG_ERROR_PRIO, "Bufpool error: Invalid handle %lu", pool_handle);
-      BUFPOOL_ASSERT();
-      return NULL;
-   }
-
-   posal_bufpool_pool_t *pool_ptr       = all_pools[pool_index];
-   void *                node_to_return = NULL;
-   uint32_t              next_node_idx;
-
-   posal_mutex_lock(pool_ptr->pool_mutex);
    for (uint32_t i = 0; i < pool_ptr->num_of_node_arrays; i++)
    {
       if (NULL == pool_ptr->nodes_ptr[i].mem_start_addr)
       {
+         if (!allow_grow)
+         {
+            continue;
+         }
          if (AR_DID_FAIL(result = posal_bufpool_allocate_new_nodes_arr(pool_ptr, i, pool_index)))
          {
-            posal_mutex_unlock(pool_ptr->pool_mutex);
             BUFPOOL_ASSERT();
             return NULL;
          }
@@ -142,11 +139,14 @@ void *posal_bufpool_get_node(uint32_t pool_handle)
          next_node_idx = get_first_zero_idx_in_list_bitmask(pool_ptr, i);
          if (pool_ptr->nodes_per_arr == next_node_idx)
          {
+            if (!allow_grow)
+            {
+               continue;
+            }
             // need to init the next list go to it
             // if already allocated, this function will just return
             if (AR_DID_FAIL(result = posal_bufpool_allocate_new_nodes_arr(pool_ptr, i + 1, pool_index)))
             {
-               posal_mutex_unlock(pool_ptr->pool_mutex);
                BUFPOOL_ASSERT();
                return NULL;
             }
@@ -180,40 +180,16 @@ void *posal_bufpool_get_node(uint32_t pool_handle)
       pool_ptr->used_nodes++;
       break;
    }
-   posal_mutex_unlock(pool_ptr->pool_mutex);
    return node_to_return;
 }
 
-void posal_bufpool_return_node(void *node_to_return)
+/* Gives one node back to the pool. Must be called with pool_mutex held, node magic already validated. */
+static void posal_bufpool_return_node_locked_(posal_bufpool_pool_t *pool_ptr, posal_bufpool_node_header_t *node_ptr)
 {
-   posal_bufpool_node_header_t *node_ptr =
-      (posal_bufpool_node_header_t *)((int8_t *)node_to_return - sizeof(posal_bufpool_node_header_t));
-#ifdef DEBUG_BUFPOOL_LOW
-   AR_MSG_ISLAND(DBG_MED_PRIO, "Node being returned, pointer 0x%lx", node_ptr);
-#endif
    uint32_t pool_index = node_ptr->pool_index;
-   if ((pool_index >= POSAL_BUFPOOL_MAX_POOLS) || (NULL == all_pools[pool_index]))
-   {
-      AR_MSG_ISLAND(DBG_ERROR_PRIO, "Bufpool error: Invalid pool index %lu", pool_index);
-      BUFPOOL_ASSERT();
-      return;
-   }
-
-   posal_bufpool_pool_t *pool_ptr = all_pools[pool_index];
-   posal_mutex_lock(pool_ptr->pool_mutex);
    uint32_t list_index = node_ptr->node_arr_index;
    uint32_t node_index = node_ptr->node_index;
-   if (node_ptr->magic != POSAL_BUFPOOL_NODE_MAGIC)
-   {
-      AR_MSG_ISLAND(DBG_ERROR_PRIO,
-             "Bufpool error: Node address invalid or node corrupted! Pool %lu, list %lu node %lu",
-             pool_index,
-             list_index,
-             node_index);
-      posal_mutex_unlock(pool_ptr->pool_mutex);
-      BUFPOOL_ASSERT();
-      return;
-   }
+
    if (!(pool_ptr->nodes_ptr[list_index].list_bitmask & (1 << node_index)))
    {
       // node was not allocated to begin with
@@ -222,8 +198,6 @@ void posal_bufpool_return_node(void *node_to_return)
              pool_index,
              list_index,
              node_index);
-
-      posal_mutex_unlock(pool_ptr->pool_mutex);
       BUFPOOL_ASSERT();
       return;
    }
@@ -259,6 +233,228 @@ void posal_bufpool_return_node(void *node_to_return)
       }
       posal_bufpool_free_nodes_arr(pool_ptr, list_index);
    }
+}
+
+#ifdef POSAL_BUFPOOL_MAGAZINE_SIZE
+/* Returns the calling thread's magazine for the pool with its busy flag held, or NULL if the pool is not cached
+ * or a thread draining the pool holds the magazine right now. Drops the contents if the pool was destroyed or
+ * reset since they were cached (the nodes no longer belong to the caller). */
+static posal_bufpool_magazine_t *posal_bufpool_get_magazine_(posal_bufpool_pool_t *pool_ptr, uint32_t pool_index)
+{
+   if (0 == pool_ptr->mag_depth)
+   {
+      return NULL;
+   }
+
+   posal_bufpool_thread_cache_t *cache_ptr = posal_bufpool_get_thread_cache();
+   if (NULL == cache_ptr)
+   {
+      return NULL;
+   }
+
+   posal_bufpool_magazine_t *mag_ptr = &cache_ptr->magazines[pool_index];
+   uint32_t                  idle    = 0;
+   if (!__atomic_compare_exchange_n(&mag_ptr->busy, &idle, 1, FALSE, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+   {
+      return NULL;
+   }
+
+   uint32_t pool_gen = __atomic_load_n(&posal_bufpool_pool_gen[pool_index], __ATOMIC_ACQUIRE);
+   if (mag_ptr->pool_gen != pool_gen)
+   {
+      __atomic_store_n(&mag_ptr->num_nodes, 0, __ATOMIC_RELAXED);
+      mag_ptr->pool_gen = pool_gen;
+   }
+   return mag_ptr;
+}
+
+static inline void posal_bufpool_put_magazine_(posal_bufpool_magazine_t *mag_ptr)
+{
+   __atomic_store_n(&mag_ptr->busy, 0, __ATOMIC_RELEASE);
+}
+
+uint32_t posal_bufpool_magazine_return_all_locked(posal_bufpool_pool_t *pool_ptr, posal_bufpool_magazine_t *mag_ptr)
+{
+   uint32_t num_nodes = mag_ptr->num_nodes;
+
+   while (num_nodes)
+   {
+      posal_bufpool_node_header_t *hdr_ptr = mag_ptr->node_ptrs[--num_nodes];
+      hdr_ptr->magic                       = POSAL_BUFPOOL_NODE_MAGIC;
+      posal_bufpool_return_node_locked_(pool_ptr, hdr_ptr);
+   }
+   num_nodes = mag_ptr->num_nodes;
+   __atomic_store_n(&mag_ptr->num_nodes, 0, __ATOMIC_RELAXED);
+   return num_nodes;
+}
+
+/* Takes one node out of the pool for the calling thread. If the pool is exhausted, the nodes other threads
+ * have cached are returned to the pool and the allocation is retried. Must be called with pool_mutex held. */
+static void *posal_bufpool_get_node_or_drain_locked_(posal_bufpool_pool_t *pool_ptr, uint32_t pool_index)
+{
+   void *node_ptr = posal_bufpool_get_node_locked_(pool_ptr, pool_index, TRUE);
+
+   if ((NULL == node_ptr) && (pool_ptr->mag_depth) && posal_bufpool_drain_thread_caches(pool_ptr, pool_index))
+   {
+      node_ptr = posal_bufpool_get_node_locked_(pool_ptr, pool_index, TRUE);
+   }
+   return node_ptr;
+}
+
+/* Moves nodes between a magazine and its pool so that it ends up half full. A refill allocates a node array
+ * for its first node only, the rest must already be free in the pool. */
+static void posal_bufpool_magazine_rebalance_(posal_bufpool_pool_t *    pool_ptr,
+                                              uint32_t                  pool_index,
+                                              posal_bufpool_magazine_t *mag_ptr)
+{
+   uint32_t num_nodes = mag_ptr->num_nodes;
+   uint32_t target    = pool_ptr->mag_depth / 2;
+
+   posal_mutex_lock(pool_ptr->pool_mutex);
+   while (num_nodes < target)
+   {
+      void *node_ptr = (0 == num_nodes) ? posal_bufpool_get_node_or_drain_locked_(pool_ptr, pool_index)
+                                        : posal_bufpool_get_node_locked_(pool_ptr, pool_index, FALSE);
+      if (NULL == node_ptr)
+      {
+         break;
+      }
+      posal_bufpool_node_header_t *hdr_ptr =
+         (posal_bufpool_node_header_t *)((int8_t *)node_ptr - sizeof(posal_bufpool_node_header_t));
+      hdr_ptr->magic                = POSAL_BUFPOOL_NODE_CACHED_MAGIC;
+      mag_ptr->node_ptrs[num_nodes++] = hdr_ptr;
+   }
+   while (num_nodes > target)
+   {
+      posal_bufpool_node_header_t *hdr_ptr = mag_ptr->node_ptrs[--num_nodes];
+      hdr_ptr->magic                       = POSAL_BUFPOOL_NODE_MAGIC;
+      posal_bufpool_return_node_locked_(pool_ptr, hdr_ptr);
+   }
+   posal_mutex_unlock(pool_ptr->pool_mutex);
+
+   __atomic_store_n(&mag_ptr->num_nodes, num_nodes, __ATOMIC_RELAXED);
+}
+
+void posal_bufpool_thread_cache_flush(posal_bufpool_thread_cache_t *cache_ptr)
+{
+   for (uint32_t pool_index = 0; pool_index < POSAL_BUFPOOL_MAX_POOLS; pool_index++)
+   {
+      posal_bufpool_magazine_t *mag_ptr  = &cache_ptr->magazines[pool_index];
+      posal_bufpool_pool_t *    pool_ptr = all_pools[pool_index];
+
+      if ((NULL == pool_ptr) || (0 == __atomic_load_n(&mag_ptr->num_nodes, __ATOMIC_RELAXED)))
+      {
+         continue;
+      }
+
+      // drainers only hold the busy flag together with pool_mutex, so it is free here
+      posal_mutex_lock(pool_ptr->pool_mutex);
+      __atomic_store_n(&mag_ptr->busy, 1, __ATOMIC_RELAXED);
+      if (mag_ptr->pool_gen == __atomic_load_n(&posal_bufpool_pool_gen[pool_index], __ATOMIC_ACQUIRE))
+      {
+         posal_bufpool_magazine_return_all_locked(pool_ptr, mag_ptr);
+      }
+      __atomic_store_n(&mag_ptr->num_nodes, 0, __ATOMIC_RELAXED);
+      posal_bufpool_put_magazine_(mag_ptr);
+      posal_mutex_unlock(pool_ptr->pool_mutex);
+   }
+}
+#endif // POSAL_BUFPOOL_MAGAZINE_SIZE
+
+void *posal_bufpool_get_node(uint32_t pool_handle)
+{
+   uint32_t pool_index;
+
+   if (AR_DID_FAIL(validate_handle(pool_handle, &pool_index)))
+   {
+      AR_MSG_ISLAND(DBG_ERROR_PRIO, "Bufpool error: Invalid handle %lu", pool_handle);
+      BUFPOOL_ASSERT();
+      return NULL;
+   }
+
+   posal_bufpool_pool_t *pool_ptr = all_pools[pool_index];
+   void *                node_to_return;
+
+#ifdef POSAL_BUFPOOL_MAGAZINE_SIZE
+   posal_bufpool_magazine_t *mag_ptr = posal_bufpool_get_magazine_(pool_ptr, pool_index);
+   if (mag_ptr)
+   {
+      node_to_return = NULL;
+      if (0 == mag_ptr->num_nodes)
+      {
+         posal_bufpool_magazine_rebalance_(pool_ptr, pool_index, mag_ptr);
+      }
+      if (mag_ptr->num_nodes)
+      {
+         uint32_t                     num_nodes = mag_ptr->num_nodes - 1;
+         posal_bufpool_node_header_t *hdr_ptr   = mag_ptr->node_ptrs[num_nodes];
+         hdr_ptr->magic                         = POSAL_BUFPOOL_NODE_MAGIC;
+         __atomic_store_n(&mag_ptr->num_nodes, num_nodes, __ATOMIC_RELAXED);
+         node_to_return = (void *)((int8_t *)hdr_ptr + sizeof(posal_bufpool_node_header_t));
+      }
+      posal_bufpool_put_magazine_(mag_ptr);
+      return node_to_return;
+   }
+
+   posal_mutex_lock(pool_ptr->pool_mutex);
+   node_to_return = posal_bufpool_get_node_or_drain_locked_(pool_ptr, pool_index);
+   posal_mutex_unlock(pool_ptr->pool_mutex);
+   return node_to_return;
+#endif // POSAL_BUFPOOL_MAGAZINE_SIZE
+
+   posal_mutex_lock(pool_ptr->pool_mutex);
+   node_to_return = posal_bufpool_get_node_locked_(pool_ptr, pool_index, TRUE);
+   posal_mutex_unlock(pool_ptr->pool_mutex);
+   return node_to_return;
+}
+
+void posal_bufpool_return_node(void *node_to_return)
+{
+   posal_bufpool_node_header_t *node_ptr =
+      (posal_bufpool_node_header_t *)((int8_t *)node_to_return - sizeof(posal_bufpool_node_header_t));
+#ifdef DEBUG_BUFPOOL_LOW
+   AR_MSG_ISLAND(DBG_MED_PRIO, "Node being returned, pointer 0x%lx", node_ptr);
+#endif
+   uint32_t pool_index = node_ptr->pool_index;
+   if ((pool_index >= POSAL_BUFPOOL_MAX_POOLS) || (NULL == all_pools[pool_index]))
+   {
+      AR_MSG_ISLAND(DBG_ERROR_PRIO, "Bufpool error: Invalid pool index %lu", pool_index);
+      BUFPOOL_ASSERT();
+      return;
+   }
+
+   posal_bufpool_pool_t *pool_ptr = all_pools[pool_index];
+   if (node_ptr->magic != POSAL_BUFPOOL_NODE_MAGIC)
+   {
+      // a node that is already parked in a magazine carries POSAL_BUFPOOL_NODE_CACHED_MAGIC
+      AR_MSG_ISLAND(DBG_ERROR_PRIO,
+             "Bufpool error: Node address invalid, corrupted or already freed! Pool %lu, list %lu node %lu",
+             pool_index,
+             node_ptr->node_arr_index,
+             node_ptr->node_index);
+      BUFPOOL_ASSERT();
+      return;
+   }
+
+#ifdef POSAL_BUFPOOL_MAGAZINE_SIZE
+   posal_bufpool_magazine_t *mag_ptr = posal_bufpool_get_magazine_(pool_ptr, pool_index);
+   if (mag_ptr)
+   {
+      if (pool_ptr->mag_depth == mag_ptr->num_nodes)
+      {
+         posal_bufpool_magazine_rebalance_(pool_ptr, pool_index, mag_ptr);
+      }
+      uint32_t num_nodes          = mag_ptr->num_nodes;
+      node_ptr->magic             = POSAL_BUFPOOL_NODE_CACHED_MAGIC;
+      mag_ptr->node_ptrs[num_nodes] = node_ptr;
+      __atomic_store_n(&mag_ptr->num_nodes, num_nodes + 1, __ATOMIC_RELAXED);
+      posal_bufpool_put_magazine_(mag_ptr);
+      return;
+   }
+#endif // POSAL_BUFPOOL_MAGAZINE_SIZE
+
+   posal_mutex_lock(pool_ptr->pool_mutex);
+   posal_bufpool_return_node_locked_(pool_ptr, node_ptr);
    posal_mutex_unlock(pool_ptr->pool_mutex);
    return;
 }
@@ -34,6 +34,7 @@ INCLUDE FILES FOR MODULE
 ** ======================================================================= */
 static void        posal_queue_free_all_nodes(posal_queue_internal_t *);
 static ar_result_t posal_queue_create_prealloc_nodes(posal_queue_t *q_ptr, posal_queue_init_attr_t *attr_ptr);
+static ar_result_t posal_queue_spsc_create_ring(posal_queue_internal_t *queue_ptr);
 
 /****************************************************************************
 ** Queues
@@ -90,6 +91,26 @@ ar_result_t posal_queue_peek_forward(posal_queue_t *q_ptr, posal_queue_element_t
 
    *payload_ptr = NULL;
 
+   if (queue_ptr->is_spsc_queue)
+   {
+      posal_queue_spsc_ring_t *ring_ptr = queue_ptr->spsc_ring_ptr;
+      posal_queue_element_t  **it_pptr  = (posal_queue_element_t **)iterator;
+      uint32_t                 head     = __atomic_load_n(&ring_ptr->head, __ATOMIC_RELAXED);
+      uint32_t                 tail     = __atomic_load_n(&ring_ptr->tail, __ATOMIC_ACQUIRE);
+
+      // if queue is empty or iterator already reached the last element then return.
+      if ((head == tail) || (&ring_ptr->elem[(tail - 1) & ring_ptr->mask] == *it_pptr))
+      {
+         *it_pptr = NULL;
+         return AR_ENEEDMORE;
+      }
+
+      *it_pptr = (NULL == *it_pptr) ? &ring_ptr->elem[head & ring_ptr->mask]
+                                    : &ring_ptr->elem[((*it_pptr - ring_ptr->elem) + 1) & ring_ptr->mask];
+      *payload_ptr = *it_pptr;
+      return AR_EOK;
+   }
+
    posal_queue_element_list_t **it_list_pptr = (posal_queue_element_list_t **)iterator;
 
    // if queue is empty or iterator already reached the end of list then return.
@@ -128,6 +149,20 @@ ar_result_t posal_queue_peek_front(posal_queue_t *q_ptr, posal_queue_element_t *
       return AR_EBADPARAM;
    }
 
+   // only the consumer peeks, so the head element cannot go away underneath
+   if (queue_ptr->is_spsc_queue)
+   {
+      posal_queue_spsc_ring_t *ring_ptr = queue_ptr->spsc_ring_ptr;
+      uint32_t                 head     = __atomic_load_n(&ring_ptr->head, __ATOMIC_RELAXED);
+
+      if (head == __atomic_load_n(&ring_ptr->tail, __ATOMIC_ACQUIRE))
+      {
+         return AR_ENEEDMORE;
+      }
+      *payload_ptr = &ring_ptr->elem[head & ring_ptr->mask];
+      return AR_EOK;
+   }
+
    // acquire the mutex
    posal_queue_mutex_lock(queue_ptr);
 
@@ -155,6 +190,13 @@ ar_result_t posal_queue_pop_back(posal_queue_t *q_ptr, posal_queue_element_t *pa
       return AR_EBADPARAM;
    }
 
+   // the consumer only owns the head of a single-producer/single-consumer queue
+   if (queue_ptr->is_spsc_queue)
+   {
+      AR_MSG(DBG_ERROR_PRIO, "Queue error: pop back is not supported on SPSC queue Q=0x%p", queue_ptr);
+      return AR_EUNSUPPORTED;
+   }
+
    // grab the mutex
    posal_queue_mutex_lock(queue_ptr);
 
@@ -269,6 +311,33 @@ ar_result_t posal_queue_push_back_with_priority(posal_queue_t *q_ptr, posal_queu
    return result;
 }
 
+/* Allocates the element ring of a single-producer/single-consumer queue, sized to the next power of 2 of max nodes.
+ * All elements are allocated up front so that push never allocates.
+ */
+static ar_result_t posal_queue_spsc_create_ring(posal_queue_internal_t *queue_ptr)
+{
+   uint32_t ring_size = 1;
+   while (ring_size < (uint32_t)queue_ptr->max_nodes)
+   {
+      ring_size <<= 1;
+   }
+
+   queue_ptr->spsc_ring_ptr = (posal_queue_spsc_ring_t *)
+      posal_memory_aligned_malloc(sizeof(posal_queue_spsc_ring_t) + (ring_size * sizeof(posal_queue_element_t)),
+                                  POSAL_QUEUE_SPSC_CACHE_LINE_SIZE,
+                                  queue_ptr->heap_id);
+   if (NULL == queue_ptr->spsc_ring_ptr)
+   {
+      AR_MSG(DBG_FATAL_PRIO, "Queue error: unable to allocate SPSC ring of %lu elements", ring_size);
+      return AR_ENOMEMORY;
+   }
+
+   queue_ptr->spsc_ring_ptr->head = 0;
+   queue_ptr->spsc_ring_ptr->tail = 0;
+   queue_ptr->spsc_ring_ptr->mask = ring_size - 1;
+   return AR_EOK;
+}
+
 static ar_result_t posal_queue_create_prealloc_nodes(posal_queue_t *q_ptr, posal_queue_init_attr_t *attr_ptr)
 {
    ar_result_t result = AR_EOK;
@@ -362,8 +431,22 @@ ar_result_t posal_queue_init(posal_queue_t *q_ptr, posal_queue_init_attr_t *attr
    queue_ptr->max_nodes         = attr_ptr->max_nodes;
    queue_ptr->heap_id           = attr_ptr->heap_id;
    queue_ptr->is_priority_queue = attr_ptr->is_priority_queue ? 1 : 0;
+   queue_ptr->is_spsc_queue     = attr_ptr->is_spsc_queue ? 1 : 0;
 
-   result = posal_queue_create_prealloc_nodes(q_ptr, attr_ptr);
+   if (queue_ptr->is_spsc_queue)
+   {
+      // priority insertion moves nodes in the middle of the queue, which needs the mutex
+      if (queue_ptr->is_priority_queue)
+      {
+         AR_MSG(DBG_ERROR_PRIO, "Queue error: SPSC queue cannot be a priority queue");
+         return AR_EBADPARAM;
+      }
+      result = posal_queue_spsc_create_ring(queue_ptr);
+   }
+   else
+   {
+      result = posal_queue_create_prealloc_nodes(q_ptr, attr_ptr);
+   }
    if (AR_DID_FAIL(result))
    {
       return result;
@@ -421,6 +504,20 @@ void posal_queue_deinit(posal_queue_t *q_ptr)
    // deinit channel ptr -- it is possible to double-deinit
    queue_ptr->channel_ptr = NULL;
 
+   if (queue_ptr->is_spsc_queue)
+   {
+      if (0 != posal_queue_spsc_get_active_nodes(queue_ptr))
+      {
+         AR_MSG(DBG_HIGH_PRIO,
+                "Warning: Queue was destroyed while %lu nodes present",
+                posal_queue_spsc_get_active_nodes(queue_ptr));
+      }
+      posal_memory_aligned_free(queue_ptr->spsc_ring_ptr);
+      queue_ptr->spsc_ring_ptr = NULL;
+      posal_inline_mutex_deinit(&queue_ptr->queue_mutex);
+      return;
+   }
+
    // return nodes, if any. print warning.
    if (queue_ptr->active_nodes != 0)
    {
@@ -471,7 +568,7 @@ ar_result_t posal_queue_enable_disable_signaling(posal_queue_t *q_ptr, bool_t is
       // if signaling is disabled then clear the signal from the channel.
       posal_signal_clear_with_bitmask_target_inline(&ch_ptr->anysig, queue_ptr->channel_bit);
    }
-   else if (queue_ptr->active_nodes > 0)
+   else if ((queue_ptr->is_spsc_queue ? posal_queue_spsc_get_active_nodes(queue_ptr) : queue_ptr->active_nodes) > 0)
    {
       // if signaling is enabled and there are some elements in the queue then set the signal
       posal_signal_set_target_inline(&ch_ptr->anysig, queue_ptr->channel_bit);
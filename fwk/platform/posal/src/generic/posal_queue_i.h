@@ -65,6 +65,25 @@ struct posal_priority_queue_element_list_t
    uint32_t priority;
 };
 
+#define POSAL_QUEUE_SPSC_CACHE_LINE_SIZE 64
+
+/* Bounded ring used by single-producer/single-consumer queues. Head and tail live on their own cache lines so that the
+ * producer and consumer threads do not share a line on every push/pop.
+ */
+typedef struct posal_queue_spsc_ring_t
+{
+   uint32_t head __attribute__((aligned(POSAL_QUEUE_SPSC_CACHE_LINE_SIZE)));
+   /**< Index of the next element to pop, only written by the consumer. */
+
+   uint32_t tail __attribute__((aligned(POSAL_QUEUE_SPSC_CACHE_LINE_SIZE)));
+   /**< Index of the next element to push, only written by the producer. */
+
+   uint32_t mask __attribute__((aligned(POSAL_QUEUE_SPSC_CACHE_LINE_SIZE)));
+   /**< Ring size - 1, ring size is a power of 2. */
+
+   posal_queue_element_t elem[];
+} posal_queue_spsc_ring_t;
+
 typedef struct posal_queue_internal_t
 {
    posal_inline_mutex_t queue_mutex;
@@ -97,6 +116,12 @@ typedef struct posal_queue_internal_t
    uint16_t disable_signaling : 1;
    /**< Specifies whether the signaling from the queue is disabled.*/
 
+   uint16_t is_spsc_queue : 1;
+   /**< Flag to mark this queue as lock-free single-producer/single-consumer queue. */
+
+   posal_queue_spsc_ring_t *spsc_ring_ptr;
+   /**< Preallocated element ring, used only by single-producer/single-consumer queues. */
+
 #ifdef QUEUE_DISABLE_NEEDED
    bool_t disable_flag;
    /**< Specifies whether the queue is disabled.
@@ -111,6 +136,12 @@ typedef struct posal_queue_internal_t
 #endif
 } posal_queue_internal_t;
 
+static inline uint32_t posal_queue_spsc_get_active_nodes(posal_queue_internal_t *queue_ptr)
+{
+   posal_queue_spsc_ring_t *ring_ptr = queue_ptr->spsc_ring_ptr;
+   return __atomic_load_n(&ring_ptr->tail, __ATOMIC_ACQUIRE) - __atomic_load_n(&ring_ptr->head, __ATOMIC_ACQUIRE);
+}
+
 static inline posal_queue_element_list_t *posal_queue_create_node(posal_queue_internal_t *queue_ptr)
 {
    if (!queue_ptr->is_priority_queue)
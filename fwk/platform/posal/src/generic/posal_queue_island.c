@@ -23,6 +23,66 @@ INCLUDE FILES FOR MODULE
 ** ----------------------------------------------------------------------- */
 uint32_t g_posal_queue_bufpool_handle[SPF_POSAL_Q_NUM_POOLS];
 
+/* Lock-free push for single-producer/single-consumer queues. Only the producer thread writes the tail. */
+static ar_result_t posal_queue_spsc_push_back(posal_queue_internal_t *queue_ptr, posal_queue_element_t *payload_ptr)
+{
+   posal_queue_spsc_ring_t *ring_ptr = queue_ptr->spsc_ring_ptr;
+   uint32_t                 tail     = __atomic_load_n(&ring_ptr->tail, __ATOMIC_RELAXED);
+   uint32_t                 head     = __atomic_load_n(&ring_ptr->head, __ATOMIC_ACQUIRE);
+
+   // Check for full queue
+   if ((int32_t)(tail - head) >= queue_ptr->max_nodes)
+   {
+      AR_MSG(DBG_ERROR_PRIO, "Queue error: OVERFLOWED QUEUE: Q=0x%p", queue_ptr);
+      return AR_ENEEDMORE;
+   }
+
+   ring_ptr->elem[tail & ring_ptr->mask] = *payload_ptr;
+
+   // publish the element before the signal so that the consumer always finds it once woken up
+   __atomic_store_n(&ring_ptr->tail, tail + 1, __ATOMIC_RELEASE);
+
+   if (!queue_ptr->disable_signaling)
+   {
+      posal_channel_internal_t *ch_ptr = (posal_channel_internal_t *)queue_ptr->channel_ptr;
+      posal_signal_set_target_inline(&ch_ptr->anysig, queue_ptr->channel_bit);
+   }
+
+   return AR_EOK;
+}
+
+/* Lock-free pop for single-producer/single-consumer queues. Only the consumer thread writes the head. */
+static ar_result_t posal_queue_spsc_pop_front(posal_queue_internal_t *queue_ptr, posal_queue_element_t *payload_ptr)
+{
+   posal_queue_spsc_ring_t *ring_ptr = queue_ptr->spsc_ring_ptr;
+   uint32_t                 head     = __atomic_load_n(&ring_ptr->head, __ATOMIC_RELAXED);
+
+   if (head == __atomic_load_n(&ring_ptr->tail, __ATOMIC_ACQUIRE))
+   {
+      return AR_ENEEDMORE;
+   }
+
+   *payload_ptr = ring_ptr->elem[head & ring_ptr->mask];
+   head++;
+   __atomic_store_n(&ring_ptr->head, head, __ATOMIC_RELEASE);
+
+   // if mq is empty, clear signal. The producer may push between the empty check and the clear, so check again after
+   // clearing and restore the signal if an element has arrived in between.
+   if (head == __atomic_load_n(&ring_ptr->tail, __ATOMIC_ACQUIRE))
+   {
+      posal_channel_internal_t *ch_ptr = (posal_channel_internal_t *)queue_ptr->channel_ptr;
+      posal_signal_clear_with_bitmask_target_inline(&ch_ptr->anysig, queue_ptr->channel_bit);
+
+      __atomic_thread_fence(__ATOMIC_SEQ_CST);
+      if ((head != __atomic_load_n(&ring_ptr->tail, __ATOMIC_ACQUIRE)) && (!queue_ptr->disable_signaling))
+      {
+         posal_signal_set_target_inline(&ch_ptr->anysig, queue_ptr->channel_bit);
+      }
+   }
+
+   return AR_EOK;
+}
+
 ar_result_t posal_queue_push_back(posal_queue_t *q_ptr, posal_queue_element_t *payload_ptr)
 {
    posal_queue_internal_t *queue_ptr = (posal_queue_internal_t *)q_ptr;
@@ -31,6 +91,11 @@ ar_result_t posal_queue_push_back(posal_queue_t *q_ptr, posal_queue_element_t *p
       AR_MSG(DBG_ERROR_PRIO, "Q SEND: channel not initialized on Q");
       return AR_EBADPARAM;
    }
+
+   if (queue_ptr->is_spsc_queue)
+   {
+      return posal_queue_spsc_push_back(queue_ptr, payload_ptr);
+   }
    // grab the mutex
    posal_queue_mutex_lock(queue_ptr);
 
@@ -148,6 +213,12 @@ ar_result_t posal_queue_pop_front(posal_queue_t *q_ptr, posal_queue_element_t *p
       AR_MSG(DBG_ERROR_PRIO, "Q SEND: channel not initialized on Q");
       return AR_EBADPARAM;
    }
+
+   if (queue_ptr->is_spsc_queue)
+   {
+      return posal_queue_spsc_pop_front(queue_ptr, payload_ptr);
+   }
+
    // grab the mutex
    posal_queue_mutex_lock(queue_ptr);
    // make sure not empty (this is non-blocking mq).
@@ -243,7 +314,7 @@ uint32_t posal_queue_get_queue_fullness(posal_queue_t *q_ptr)
    posal_queue_internal_t *queue_ptr = (posal_queue_internal_t *)q_ptr;
    if (NULL != queue_ptr)
    {
-      return queue_ptr->active_nodes;
+      return queue_ptr->is_spsc_queue ? posal_queue_spsc_get_active_nodes(queue_ptr) : queue_ptr->active_nodes;
    }
 
    return 0;
@@ -257,6 +328,14 @@ ar_result_t posal_queue_insert_front(posal_queue_t *q_ptr, posal_queue_element_t
       AR_MSG(DBG_ERROR_PRIO, "Q SEND: channel not initialized on Q");
       return AR_EBADPARAM;
    }
+
+   // the producer only owns the tail of a single-producer/single-consumer queue
+   if (queue_ptr->is_spsc_queue)
+   {
+      AR_MSG(DBG_ERROR_PRIO, "Queue error: insert front is not supported on SPSC queue Q=0x%p", queue_ptr);
+      return AR_EUNSUPPORTED;
+   }
+
    // grab the mutex
    posal_queue_mutex_lock(queue_ptr);
 
@@ -18,6 +18,9 @@ INCLUDE FILES FOR MODULE
 #include "posal_globalstate.h"
 #include "posal_mem_prof.h"
 #include "posal_power_mgr.h"
+#ifdef POSAL_LOG_PKT_DATA_LOGGING
+#include "ar_osal_log_pkt_op.h"
+#endif
 
 /*--------------------------------------------------------------*/
 /* Macro definitions                                            */
@@ -38,6 +41,31 @@ INCLUDE FILES FOR MODULE
 
 posal_globalstate_t posal_globalstate;
 
+#ifdef POSAL_LOG_PKT_DATA_LOGGING
+/* TRUE if posal started the log packet transport, a transport started by the hosting process is left to it */
+static bool_t posal_log_pkt_started;
+
+static void posal_log_pkt_init(void)
+{
+   ar_log_pkt_op_init_info_t info;
+
+   memset(&info, 0, sizeof(info));
+   info.data_transport = AR_LOG_DATA_TRANSPORT_FILE;
+   info.file_path      = ('\0' != POSAL_LOG_PKT_FILE_PATH[0]) ? POSAL_LOG_PKT_FILE_PATH : NULL;
+   info.max_file_size  = POSAL_LOG_PKT_FILE_MAX_SIZE_KB * 1024;
+
+   int32_t rc = ar_log_pkt_op_init(&info);
+   if (AR_EOK == rc)
+   {
+      posal_log_pkt_started = TRUE;
+   }
+   else if (AR_EALREADY != rc)
+   {
+      AR_MSG(DBG_ERROR_PRIO, "FAILED to init log packet file transport, result 0x%lx", rc);
+   }
+}
+#endif
+
 
 void posal_init(void)
 {
@@ -74,6 +102,10 @@ void posal_init(void)
    /* Initialise posal power manager */
    posal_power_mgr_init();
 
+#ifdef POSAL_LOG_PKT_DATA_LOGGING
+   posal_log_pkt_init();
+#endif
+
    // if Q6_TCM is not available then malloc ensures we fallback to other island heaps.
    posal_queue_pool_setup(MODIFY_HEAP_ID_FOR_FWK_ALLOC_FOR_MEM_TRACKING(spf_mem_island_heap_id),
                           LPI_QUEUE_BUF_POOL_NUM_ARRAYS,
@@ -86,5 +118,11 @@ void posal_init(void)
 
 void posal_deinit(void)
 {
-
+#ifdef POSAL_LOG_PKT_DATA_LOGGING
+   if (posal_log_pkt_started)
+   {
+      ar_log_pkt_op_deinit();
+      posal_log_pkt_started = FALSE;
+   }
+#endif
 }
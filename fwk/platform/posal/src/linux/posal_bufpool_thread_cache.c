@@ -0,0 +1,158 @@
+/**
+ * \file posal_bufpool_thread_cache.c
+ * \brief
+ *    This file contains the per-thread cache storage backing the buffer pool magazines
+ *
+ *    Each thread that touches a buffer pool gets a posal_bufpool_thread_cache_t on first use. A pthread key
+ *    destructor returns the cached nodes to their pools when the thread exits. All caches are kept on a list
+ *    so that profiling can account for the nodes parked in them, and so that an exhausted pool can take back
+ *    the nodes other threads have parked.
+ *
+ * \copyright
+ *    Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ *    SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+/* =======================================================================
+INCLUDE FILES FOR MODULE
+========================================================================== */
+#include "posal.h"
+#include "posal_bufpool_i.h"
+
+#ifdef POSAL_BUFPOOL_MAGAZINE_SIZE
+#include <pthread.h>
+#include <stdlib.h>
+
+/* -----------------------------------------------------------------------
+** Constant / Define Declarations
+** ----------------------------------------------------------------------- */
+static pthread_once_t  bufpool_cache_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t   bufpool_cache_key;
+static bool_t          bufpool_cache_key_valid = FALSE;
+static pthread_mutex_t bufpool_cache_list_lock = PTHREAD_MUTEX_INITIALIZER;
+static posal_bufpool_thread_cache_t *bufpool_cache_list_ptr = NULL;
+
+static __thread posal_bufpool_thread_cache_t *bufpool_cache_tls_ptr = NULL;
+
+/* -----------------------------------------------------------------------
+** Function Definitions
+** ----------------------------------------------------------------------- */
+static void posal_bufpool_thread_cache_destroy(void *arg_ptr)
+{
+   posal_bufpool_thread_cache_t *cache_ptr = (posal_bufpool_thread_cache_t *)arg_ptr;
+
+   posal_bufpool_thread_cache_flush(cache_ptr);
+
+   pthread_mutex_lock(&bufpool_cache_list_lock);
+   posal_bufpool_thread_cache_t **link_pptr = &bufpool_cache_list_ptr;
+   while (*link_pptr && (*link_pptr != cache_ptr))
+   {
+      link_pptr = &(*link_pptr)->next_ptr;
+   }
+   if (*link_pptr)
+   {
+      *link_pptr = cache_ptr->next_ptr;
+   }
+   pthread_mutex_unlock(&bufpool_cache_list_lock);
+
+   bufpool_cache_tls_ptr = NULL;
+   free(cache_ptr);
+}
+
+static void posal_bufpool_thread_cache_key_create(void)
+{
+   if (0 == pthread_key_create(&bufpool_cache_key, posal_bufpool_thread_cache_destroy))
+   {
+      bufpool_cache_key_valid = TRUE;
+   }
+   else
+   {
+      AR_MSG(DBG_ERROR_PRIO, "Bufpool: thread cache key creation failed, magazines disabled");
+   }
+}
+
+posal_bufpool_thread_cache_t *posal_bufpool_get_thread_cache(void)
+{
+   posal_bufpool_thread_cache_t *cache_ptr = bufpool_cache_tls_ptr;
+   if (cache_ptr)
+   {
+      return cache_ptr;
+   }
+
+   pthread_once(&bufpool_cache_key_once, posal_bufpool_thread_cache_key_create);
+   if (!bufpool_cache_key_valid)
+   {
+      return NULL;
+   }
+
+   // not from a posal heap: the cache outlives any heap the pools may be created in
+   cache_ptr = (posal_bufpool_thread_cache_t *)calloc(1, sizeof(posal_bufpool_thread_cache_t));
+   if (NULL == cache_ptr)
+   {
+      return NULL;
+   }
+
+   if (0 != pthread_setspecific(bufpool_cache_key, cache_ptr))
+   {
+      free(cache_ptr);
+      return NULL;
+   }
+
+   pthread_mutex_lock(&bufpool_cache_list_lock);
+   cache_ptr->next_ptr    = bufpool_cache_list_ptr;
+   bufpool_cache_list_ptr = cache_ptr;
+   pthread_mutex_unlock(&bufpool_cache_list_lock);
+
+   bufpool_cache_tls_ptr = cache_ptr;
+   return cache_ptr;
+}
+
+uint32_t posal_bufpool_get_num_cached_nodes(uint32_t pool_index)
+{
+   uint32_t num_nodes = 0;
+   uint32_t pool_gen  = __atomic_load_n(&posal_bufpool_pool_gen[pool_index], __ATOMIC_ACQUIRE);
+
+   pthread_mutex_lock(&bufpool_cache_list_lock);
+   for (posal_bufpool_thread_cache_t *cache_ptr = bufpool_cache_list_ptr; cache_ptr; cache_ptr = cache_ptr->next_ptr)
+   {
+      posal_bufpool_magazine_t *mag_ptr = &cache_ptr->magazines[pool_index];
+      // stale magazines hold nodes of a previous incarnation of the pool
+      if (pool_gen == mag_ptr->pool_gen)
+      {
+         num_nodes += __atomic_load_n(&mag_ptr->num_nodes, __ATOMIC_RELAXED);
+      }
+   }
+   pthread_mutex_unlock(&bufpool_cache_list_lock);
+
+   return num_nodes;
+}
+
+uint32_t posal_bufpool_drain_thread_caches(posal_bufpool_pool_t *pool_ptr, uint32_t pool_index)
+{
+   uint32_t num_nodes = 0;
+   uint32_t pool_gen  = __atomic_load_n(&posal_bufpool_pool_gen[pool_index], __ATOMIC_ACQUIRE);
+
+   pthread_mutex_lock(&bufpool_cache_list_lock);
+   for (posal_bufpool_thread_cache_t *cache_ptr = bufpool_cache_list_ptr; cache_ptr; cache_ptr = cache_ptr->next_ptr)
+   {
+      posal_bufpool_magazine_t *mag_ptr = &cache_ptr->magazines[pool_index];
+      uint32_t                  idle    = 0;
+
+      // never wait for the owner, it may itself be blocked on pool_mutex
+      if ((0 == __atomic_load_n(&mag_ptr->num_nodes, __ATOMIC_RELAXED)) ||
+          !__atomic_compare_exchange_n(&mag_ptr->busy, &idle, 1, FALSE, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+      {
+         continue;
+      }
+      if (pool_gen == mag_ptr->pool_gen)
+      {
+         num_nodes += posal_bufpool_magazine_return_all_locked(pool_ptr, mag_ptr);
+      }
+      __atomic_store_n(&mag_ptr->busy, 0, __ATOMIC_RELEASE);
+   }
+   pthread_mutex_unlock(&bufpool_cache_list_lock);
+
+   return num_nodes;
+}
+
+#endif // POSAL_BUFPOOL_MAGAZINE_SIZE
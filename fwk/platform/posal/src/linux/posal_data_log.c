@@ -18,6 +18,8 @@ INCLUDE FILES FOR MODULE
 #include "dls_log_pkt_hdr_api.h"
 #if defined(DLS_DATA_LOGGING)
 #include "dls.h"
+#elif defined(POSAL_LOG_PKT_DATA_LOGGING)
+#include "ar_osal_log_pkt_op.h"
 #else
 #include "log.h"
 #endif //defined DLS_DATA_LOGGING
@@ -36,6 +38,35 @@ typedef union log_pkt_header_internal_t
 #define log_commit dls_commit_buffer
 #define log_free dls_log_buf_free
 #define log_status dls_log_code_status
+#elif defined(POSAL_LOG_PKT_DATA_LOGGING)
+/* ar_log_pkt_* hand out the payload after the log header (which they fill), while
+ * log_alloc() users expect the packet including the header. */
+static inline void *posal_log_pkt_alloc(uint16_t log_code, uint32_t log_pkt_size)
+{
+   uint8_t *payload_ptr;
+
+   if (log_pkt_size <= sizeof(dls_log_hdr_type))
+   {
+      return NULL;
+   }
+   payload_ptr = (uint8_t *)ar_log_pkt_alloc(log_code, log_pkt_size - sizeof(dls_log_hdr_type));
+   return (NULL == payload_ptr) ? NULL : (payload_ptr - sizeof(dls_log_hdr_type));
+}
+
+static inline void posal_log_pkt_commit(void *log_pkt_ptr)
+{
+   (void)ar_log_pkt_commit((uint8_t *)log_pkt_ptr + sizeof(dls_log_hdr_type));
+}
+
+static inline void posal_log_pkt_free(void *log_pkt_ptr)
+{
+   ar_log_pkt_free((uint8_t *)log_pkt_ptr + sizeof(dls_log_hdr_type));
+}
+
+#define log_alloc posal_log_pkt_alloc
+#define log_commit posal_log_pkt_commit
+#define log_free posal_log_pkt_free
+#define log_status ar_log_code_status
 #endif //defined DLS_DATA_LOGGING
 
 static void *      posal_data_alloc_log_buffer_internal(uint32_t                buf_size,
@@ -0,0 +1,536 @@
+/**
+ * \file posal_heapmgr.c
+ * \brief
+ *  	This file contains the heap manager for Linux. Each heap ID created through
+ *  	posal_memory_heapmgr_create_v2 gets its own arena carved from a caller
+ *  	supplied or heap manager allocated region, with size class free lists.
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+/* ----------------------------------------------------------------------------
+ * Include Files
+ * ------------------------------------------------------------------------- */
+#include "posal.h"
+#include "posal_internal.h"
+#include "posal_globalstate.h"
+#include "posal_memory_i.h"
+#ifndef __ZEPHYR__
+#include <sys/mman.h>
+#endif
+
+/* ----------------------------------------------------------------------------
+ * Global Declarations/Definitions
+ * ------------------------------------------------------------------------- */
+//#define DEBUG_POSAL_HEAPMGR
+
+#define POSAL_HEAPMGR_BLOCK_MAGIC 0x48454150 // "HEAP"
+#define POSAL_HEAPMGR_ALIGN 16
+#define POSAL_HEAPMGR_ALIGN_UP(x) (((x) + (POSAL_HEAPMGR_ALIGN - 1)) & ~((uint64_t)(POSAL_HEAPMGR_ALIGN - 1)))
+
+/* Largest block (header included) the heap manager serves, keeps class sizes within 32 bits */
+#define POSAL_HEAPMGR_MAX_BLOCK_SIZE ((uint64_t)1 << 31)
+
+extern posal_heap_table_t posal_heap_table[POSAL_HEAP_MGR_MAX_NUM_HEAPS];
+
+/* Serializes heap creation and destruction. Alloc/free only take the arena lock. */
+static pthread_mutex_t posal_heapmgr_table_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Arena of each heap table entry, live while its seq is odd */
+static posal_heapmgr_arena_t posal_heapmgr_arenas[POSAL_HEAP_MGR_MAX_NUM_HEAPS];
+
+/* Number of live arenas, lets free of default heap memory skip the arena walk. Accessed with atomics only. */
+static uint32_t posal_heapmgr_num_arenas = 0;
+
+/* Arena locks are initialized once and never destroyed, a retired arena keeps a usable lock */
+static pthread_once_t posal_heapmgr_locks_once = PTHREAD_ONCE_INIT;
+
+/* -------------------------------------------------------------------------
+ * Function Definitions
+ * ------------------------------------------------------------------------- */
+static inline uint32_t posal_heapmgr_size_to_class(uint32_t block_size)
+{
+   if (block_size <= POSAL_HEAPMGR_LINEAR_CLASS_MAX_SIZE)
+   {
+      return (block_size >> 4) - 1;
+   }
+
+   uint32_t m     = block_size - 1;
+   uint32_t msb   = 31 - __builtin_clz(m);
+   uint32_t shift = msb - 2;
+   uint32_t sub   = (m >> shift) & 3;
+
+   return POSAL_HEAPMGR_NUM_LINEAR_CLASSES + ((msb - POSAL_HEAPMGR_LINEAR_CLASS_MAX_SIZE_LOG2) << 2) + sub;
+}
+
+static inline uint32_t posal_heapmgr_class_size(uint32_t class_idx)
+{
+   if (class_idx < POSAL_HEAPMGR_NUM_LINEAR_CLASSES)
+   {
+      return (class_idx + 1) << 4;
+   }
+
+   uint32_t rel = class_idx - POSAL_HEAPMGR_NUM_LINEAR_CLASSES;
+   uint32_t msb = POSAL_HEAPMGR_LINEAR_CLASS_MAX_SIZE_LOG2 + (rel >> 2);
+
+   return (5 + (rel & 3)) << (msb - 2);
+}
+
+static inline void posal_heapmgr_push(posal_heapmgr_arena_t *arena_ptr, uint32_t class_idx, posal_heapmgr_block_hdr_t *hdr_ptr)
+{
+   *((void **)(hdr_ptr + 1))            = arena_ptr->free_list_ptr[class_idx];
+   arena_ptr->free_list_ptr[class_idx] = hdr_ptr;
+   arena_ptr->non_empty_bitmap[class_idx >> 6] |= ((uint64_t)1 << (class_idx & 63));
+}
+
+static inline posal_heapmgr_block_hdr_t *posal_heapmgr_pop(posal_heapmgr_arena_t *arena_ptr, uint32_t class_idx)
+{
+   posal_heapmgr_block_hdr_t *hdr_ptr = (posal_heapmgr_block_hdr_t *)arena_ptr->free_list_ptr[class_idx];
+   if (NULL == hdr_ptr)
+   {
+      return NULL;
+   }
+
+   arena_ptr->free_list_ptr[class_idx] = *((void **)(hdr_ptr + 1));
+   if (NULL == arena_ptr->free_list_ptr[class_idx])
+   {
+      arena_ptr->non_empty_bitmap[class_idx >> 6] &= ~((uint64_t)1 << (class_idx & 63));
+   }
+   return hdr_ptr;
+}
+
+/* Returns the smallest non-empty size class above class_idx, POSAL_HEAPMGR_NUM_SIZE_CLASSES if none */
+static inline uint32_t posal_heapmgr_find_larger_class(posal_heapmgr_arena_t *arena_ptr, uint32_t class_idx)
+{
+   uint32_t start = class_idx + 1;
+
+   for (uint32_t word = start >> 6; word < POSAL_HEAPMGR_CLASS_BITMAP_WORDS; word++)
+   {
+      uint64_t bits = arena_ptr->non_empty_bitmap[word];
+      if (word == (start >> 6))
+      {
+         bits &= ~(((uint64_t)1 << (start & 63)) - 1);
+      }
+      if (bits)
+      {
+         return (word << 6) + __builtin_ctzll(bits);
+      }
+   }
+   return POSAL_HEAPMGR_NUM_SIZE_CLASSES;
+}
+
+static void posal_heapmgr_init_locks(void)
+{
+   for (uint32_t idx = 0; idx < POSAL_HEAP_MGR_MAX_NUM_HEAPS; idx++)
+   {
+      pthread_mutex_init(&posal_heapmgr_arenas[idx].lock, NULL);
+   }
+}
+
+static inline bool_t posal_heapmgr_is_live(posal_heapmgr_arena_t *arena_ptr)
+{
+   return (__atomic_load_n(&arena_ptr->seq, __ATOMIC_ACQUIRE) & 1);
+}
+
+/* Lock-free range check. The range is only rewritten while the arena is retired, and a change of seq across the
+   reads means the arena was retired or republished meanwhile, in which case ptr cannot be a live block of it. */
+static inline bool_t posal_heapmgr_arena_owns(posal_heapmgr_arena_t *arena_ptr, void *ptr)
+{
+   uint32_t seq = __atomic_load_n(&arena_ptr->seq, __ATOMIC_ACQUIRE);
+   if (0 == (seq & 1))
+   {
+      return FALSE;
+   }
+
+   uint64_t start_addr = __atomic_load_n(&arena_ptr->start_addr, __ATOMIC_RELAXED);
+   uint64_t end_addr   = __atomic_load_n(&arena_ptr->end_addr, __ATOMIC_RELAXED);
+
+   __atomic_thread_fence(__ATOMIC_ACQUIRE);
+   if (seq != __atomic_load_n(&arena_ptr->seq, __ATOMIC_RELAXED))
+   {
+      return FALSE;
+   }
+   return ((uint64_t)ptr >= start_addr) && ((uint64_t)ptr < end_addr);
+}
+
+bool_t posal_heapmgr_is_arena_heap(POSAL_HEAP_ID heap_id)
+{
+   if ((POSAL_DEFAULT_HEAP_INDEX == heap_id) || (heap_id > POSAL_HEAP_MGR_HEAP_INDEX_END))
+   {
+      return FALSE;
+   }
+
+   return posal_heapmgr_is_live(&posal_heapmgr_arenas[HEAP_TABLE_INDEX_FROM_HEAP_ID(heap_id)]);
+}
+
+void *posal_heapmgr_alloc(POSAL_HEAP_ID heap_id, uint32_t bytes)
+{
+   uint32_t                   heap_idx   = HEAP_TABLE_INDEX_FROM_HEAP_ID(heap_id);
+   posal_heapmgr_arena_t *    arena_ptr  = &posal_heapmgr_arenas[heap_idx];
+   posal_mem_stats_t *        stats_ptr  = &posal_globalstate.avs_stats[heap_id];
+   posal_heapmgr_block_hdr_t *hdr_ptr    = NULL;
+   uint64_t                   block_size = POSAL_HEAPMGR_ALIGN_UP((uint64_t)bytes) + sizeof(posal_heapmgr_block_hdr_t);
+
+   if (block_size > POSAL_HEAPMGR_MAX_BLOCK_SIZE)
+   {
+      AR_MSG(DBG_ERROR_PRIO, "POSAL HEAPMGR: heap id %lu, request of %lu bytes is too large", heap_id, bytes);
+      return NULL;
+   }
+
+   uint32_t class_idx = posal_heapmgr_size_to_class((uint32_t)block_size);
+
+   pthread_mutex_lock(&arena_ptr->lock);
+
+   // The heap may have been destroyed since the caller checked it
+   if (!posal_heapmgr_is_live(arena_ptr))
+   {
+      pthread_mutex_unlock(&arena_ptr->lock);
+      AR_MSG(DBG_ERROR_PRIO, "POSAL HEAPMGR: heap id %lu is destroyed", heap_id);
+      return NULL;
+   }
+
+   hdr_ptr = posal_heapmgr_pop(arena_ptr, class_idx);
+   if (NULL == hdr_ptr)
+   {
+      uint32_t class_size = posal_heapmgr_class_size(class_idx);
+      if ((uint64_t)(arena_ptr->end_ptr - arena_ptr->bump_ptr) >= class_size)
+      {
+         hdr_ptr = (posal_heapmgr_block_hdr_t *)arena_ptr->bump_ptr;
+         arena_ptr->bump_ptr += class_size;
+      }
+      else
+      {
+         // Region is exhausted, borrow the smallest free block of a larger class. Blocks are never split, so the
+         // block keeps its class and goes back to that class on free.
+         class_idx = posal_heapmgr_find_larger_class(arena_ptr, class_idx);
+         if (class_idx < POSAL_HEAPMGR_NUM_SIZE_CLASSES)
+         {
+            hdr_ptr = posal_heapmgr_pop(arena_ptr, class_idx);
+         }
+      }
+   }
+
+   if (NULL == hdr_ptr)
+   {
+      arena_ptr->num_alloc_failures++;
+      pthread_mutex_unlock(&arena_ptr->lock);
+      AR_MSG(DBG_ERROR_PRIO,
+             "POSAL HEAPMGR: heap id %lu exhausted, requested %lu bytes, in use %lu bytes, failures %lu",
+             heap_id,
+             bytes,
+             stats_ptr->curr_heap,
+             arena_ptr->num_alloc_failures);
+      return NULL;
+   }
+
+   hdr_ptr->magic     = POSAL_HEAPMGR_BLOCK_MAGIC;
+   hdr_ptr->class_idx = (uint16_t)class_idx;
+   hdr_ptr->heap_idx  = (uint16_t)heap_idx;
+   hdr_ptr->req_bytes = bytes;
+
+   stats_ptr->num_mallocs++;
+   stats_ptr->curr_heap += posal_heapmgr_class_size(class_idx);
+   if (stats_ptr->curr_heap > stats_ptr->peak_heap)
+   {
+      stats_ptr->peak_heap = stats_ptr->curr_heap;
+   }
+
+   pthread_mutex_unlock(&arena_ptr->lock);
+
+#ifdef DEBUG_POSAL_HEAPMGR
+   AR_MSG(DBG_HIGH_PRIO,
+          "POSAL HEAPMGR: heap id %lu alloc %lu bytes, class %lu, ptr 0x%p",
+          heap_id,
+          bytes,
+          class_idx,
+          (void *)(hdr_ptr + 1));
+#endif
+   return (void *)(hdr_ptr + 1);
+}
+
+uint32_t posal_heapmgr_get_heap_idx(void *ptr)
+{
+   if (0 == __atomic_load_n(&posal_heapmgr_num_arenas, __ATOMIC_ACQUIRE))
+   {
+      return POSAL_HEAP_MGR_MAX_NUM_HEAPS;
+   }
+
+   for (uint32_t idx = 0; idx < POSAL_HEAP_MGR_MAX_NUM_HEAPS; idx++)
+   {
+      if (posal_heapmgr_arena_owns(&posal_heapmgr_arenas[idx], ptr))
+      {
+         return idx;
+      }
+   }
+   return POSAL_HEAP_MGR_MAX_NUM_HEAPS;
+}
+
+void posal_heapmgr_free(uint32_t heap_table_idx, void *ptr)
+{
+   posal_heapmgr_arena_t *    arena_ptr = &posal_heapmgr_arenas[heap_table_idx];
+   posal_mem_stats_t *        stats_ptr = &posal_globalstate.avs_stats[HEAP_ID_FROM_HEAP_TABLE_INDEX(heap_table_idx)];
+   posal_heapmgr_block_hdr_t *hdr_ptr   = ((posal_heapmgr_block_hdr_t *)ptr) - 1;
+
+   pthread_mutex_lock(&arena_ptr->lock);
+
+   if ((POSAL_HEAPMGR_BLOCK_MAGIC != hdr_ptr->magic) || (heap_table_idx != hdr_ptr->heap_idx) ||
+       (hdr_ptr->class_idx >= POSAL_HEAPMGR_NUM_SIZE_CLASSES))
+   {
+      pthread_mutex_unlock(&arena_ptr->lock);
+      AR_MSG(DBG_ERROR_PRIO,
+             "POSAL HEAPMGR: invalid or double free of ptr 0x%p in heap id %lu",
+             ptr,
+             HEAP_ID_FROM_HEAP_TABLE_INDEX(heap_table_idx));
+      return;
+   }
+
+   hdr_ptr->magic = 0;
+   stats_ptr->num_frees++;
+   stats_ptr->curr_heap -= posal_heapmgr_class_size(hdr_ptr->class_idx);
+   posal_heapmgr_push(arena_ptr, hdr_ptr->class_idx, hdr_ptr);
+
+   pthread_mutex_unlock(&arena_ptr->lock);
+}
+
+uint32_t posal_heapmgr_get_block_size(void *ptr)
+{
+   uint32_t heap_table_idx = posal_heapmgr_get_heap_idx(ptr);
+   if (heap_table_idx >= POSAL_HEAP_MGR_MAX_NUM_HEAPS)
+   {
+      return 0;
+   }
+
+   posal_heapmgr_block_hdr_t *hdr_ptr = ((posal_heapmgr_block_hdr_t *)ptr) - 1;
+   if (POSAL_HEAPMGR_BLOCK_MAGIC != hdr_ptr->magic)
+   {
+      return 0;
+   }
+   return posal_heapmgr_class_size(hdr_ptr->class_idx) - sizeof(posal_heapmgr_block_hdr_t);
+}
+
+/* Fills the retired arena at heap_idx. It is published by the caller. */
+static ar_result_t posal_heapmgr_arena_create(posal_heapmgr_arena_t *arena_ptr,
+                                              void *                 heap_start_ptr,
+                                              uint32_t               heap_size,
+                                              uint32_t               heap_idx)
+{
+   arena_ptr->map_ptr            = NULL;
+   arena_ptr->map_size           = 0;
+   arena_ptr->num_alloc_failures = 0;
+   memset(arena_ptr->free_list_ptr, 0, sizeof(arena_ptr->free_list_ptr));
+   memset(arena_ptr->non_empty_bitmap, 0, sizeof(arena_ptr->non_empty_bitmap));
+
+   if (NULL == heap_start_ptr)
+   {
+      // No region from the caller, reserve one so that the heap is capped at heap_size. Pages are only committed
+      // when first touched by the bump allocator.
+#ifndef __ZEPHYR__
+      heap_start_ptr = mmap(NULL, heap_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+      if (MAP_FAILED == heap_start_ptr)
+      {
+         heap_start_ptr = NULL;
+      }
+#else
+      heap_start_ptr = malloc(heap_size);
+#endif
+      if (NULL == heap_start_ptr)
+      {
+         AR_MSG(DBG_ERROR_PRIO, "POSAL HEAPMGR: Failed to reserve %lu bytes for heap", heap_size);
+         return AR_ENOMEMORY;
+      }
+      arena_ptr->map_ptr  = heap_start_ptr;
+      arena_ptr->map_size = heap_size;
+   }
+
+   arena_ptr->bump_ptr = (uint8_t *)POSAL_HEAPMGR_ALIGN_UP((uint64_t)heap_start_ptr);
+   arena_ptr->end_ptr  = ((uint8_t *)heap_start_ptr) + heap_size;
+   arena_ptr->heap_idx = heap_idx;
+   if (arena_ptr->bump_ptr > arena_ptr->end_ptr)
+   {
+      arena_ptr->bump_ptr = arena_ptr->end_ptr;
+   }
+
+   // Lookups may still be reading the range of the previous incarnation, order these stores after its retirement
+   __atomic_thread_fence(__ATOMIC_RELEASE);
+   __atomic_store_n(&arena_ptr->start_addr, (uint64_t)heap_start_ptr, __ATOMIC_RELAXED);
+   __atomic_store_n(&arena_ptr->end_addr, (uint64_t)heap_start_ptr + heap_size, __ATOMIC_RELAXED);
+   return AR_EOK;
+}
+
+/* Releases the region of a retired arena */
+static void posal_heapmgr_arena_destroy(posal_heapmgr_arena_t *arena_ptr)
+{
+   if (NULL != arena_ptr->map_ptr)
+   {
+#ifndef __ZEPHYR__
+      munmap(arena_ptr->map_ptr, arena_ptr->map_size);
+#else
+      free(arena_ptr->map_ptr);
+#endif
+      arena_ptr->map_ptr = NULL;
+   }
+}
+
+ar_result_t posal_memory_heapmgr_create(POSAL_HEAP_ID *heap_id_ptr,
+                                        void *         heap_start_ptr,
+                                        uint32_t       heap_size,
+                                        bool_t         is_init_heap_needed)
+{
+   return posal_memory_heapmgr_create_v2(heap_id_ptr,
+                                         heap_start_ptr,
+                                         heap_size,
+                                         is_init_heap_needed,
+                                         POSAL_HEAP_NON_ISLAND,
+                                         NULL,
+                                         NULL,
+                                         0);
+}
+
+ar_result_t posal_memory_heapmgr_create_v2(POSAL_HEAP_ID *          heap_id_ptr,
+                                           void *                   heap_start_ptr,
+                                           uint32_t                 heap_size,
+                                           bool_t                   is_init_heap_needed,
+                                           uint32_t                 heap_type,
+                                           posal_heap_tcm_handle_t *tcm_handle_ptr,
+                                           char *                   tcm_name,
+                                           uint32_t                 tcm_name_len)
+{
+   ar_result_t            result    = AR_EOK;
+   uint32_t               heap_idx  = 0;
+   posal_heapmgr_arena_t *arena_ptr = NULL;
+
+   if ((NULL == heap_id_ptr) || (0 == heap_size) || ((!is_init_heap_needed) && (NULL == heap_start_ptr)))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "POSAL HEAPMGR: Invalid args, heap size %lu", heap_size);
+      return AR_EBADPARAM;
+   }
+
+   // TCM pools do not exist on Linux
+   if (NULL != tcm_handle_ptr)
+   {
+      *tcm_handle_ptr = 0;
+   }
+
+   pthread_once(&posal_heapmgr_locks_once, posal_heapmgr_init_locks);
+   pthread_mutex_lock(&posal_heapmgr_table_lock);
+
+   for (heap_idx = 0; heap_idx < POSAL_HEAP_MGR_MAX_NUM_HEAPS; heap_idx++)
+   {
+      if (!posal_heap_table[heap_idx].used_flag)
+      {
+         break;
+      }
+   }
+
+   if (POSAL_HEAP_MGR_MAX_NUM_HEAPS == heap_idx)
+   {
+      AR_MSG(DBG_ERROR_PRIO, "POSAL HEAPMGR: All %lu heap table entries are in use", POSAL_HEAP_MGR_MAX_NUM_HEAPS);
+      result = AR_ENORESOURCE;
+      goto __bailout;
+   }
+
+   // When the heap is managed outside SPF only the range is tracked, allocations with this heap id use the default
+   // heap.
+   if (is_init_heap_needed)
+   {
+      arena_ptr = &posal_heapmgr_arenas[heap_idx];
+      if (AR_DID_FAIL(result = posal_heapmgr_arena_create(arena_ptr, heap_start_ptr, heap_size, heap_idx)))
+      {
+         goto __bailout;
+      }
+      heap_start_ptr = (NULL != arena_ptr->map_ptr) ? arena_ptr->map_ptr : heap_start_ptr;
+   }
+
+   posal_heap_table[heap_idx].dynamic_heap       = (NULL != arena_ptr) && (NULL != arena_ptr->map_ptr);
+   posal_heap_table[heap_idx].is_phys_addr_range = FALSE;
+   posal_heap_table[heap_idx].start_addr         = (uint64_t)heap_start_ptr;
+   posal_heap_table[heap_idx].end_addr           = (uint64_t)heap_start_ptr + heap_size;
+   memset(&posal_globalstate.avs_stats[HEAP_ID_FROM_HEAP_TABLE_INDEX(heap_idx)], 0, sizeof(posal_mem_stats_t));
+
+   // Publish the entry and the arena last so that lock-free lookups never see a partially filled one
+   __atomic_store_n(&posal_heap_table[heap_idx].used_flag, TRUE, __ATOMIC_RELEASE);
+   if (NULL != arena_ptr)
+   {
+      __atomic_add_fetch(&arena_ptr->seq, 1, __ATOMIC_RELEASE);
+      __atomic_add_fetch(&posal_heapmgr_num_arenas, 1, __ATOMIC_RELEASE);
+   }
+
+   *heap_id_ptr = (POSAL_HEAP_ID)HEAP_ID_FROM_HEAP_TABLE_INDEX(heap_idx);
+
+   AR_MSG(DBG_HIGH_PRIO,
+          "POSAL HEAPMGR: Created heap id %lu, type %lu, start 0x%p, size %lu, managed %lu",
+          *heap_id_ptr,
+          heap_type,
+          heap_start_ptr,
+          heap_size,
+          is_init_heap_needed);
+
+__bailout:
+   pthread_mutex_unlock(&posal_heapmgr_table_lock);
+   return result;
+}
+
+ar_result_t posal_memory_heapmgr_destroy(POSAL_HEAP_ID origheapId)
+{
+   POSAL_HEAP_ID          heap_id   = GET_ACTUAL_HEAP_ID(origheapId);
+   uint32_t               heap_idx  = HEAP_TABLE_INDEX_FROM_HEAP_ID(heap_id);
+   posal_heapmgr_arena_t *arena_ptr = NULL;
+   posal_mem_stats_t *    stats_ptr = NULL;
+
+   if ((POSAL_DEFAULT_HEAP_INDEX == heap_id) || (heap_id > POSAL_HEAP_MGR_HEAP_INDEX_END))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "POSAL HEAPMGR: Cannot destroy heap id %lu", heap_id);
+      return AR_EBADPARAM;
+   }
+
+   pthread_mutex_lock(&posal_heapmgr_table_lock);
+
+   if (!posal_heap_table[heap_idx].used_flag)
+   {
+      pthread_mutex_unlock(&posal_heapmgr_table_lock);
+      AR_MSG(DBG_ERROR_PRIO, "POSAL HEAPMGR: Heap id %lu is not created", heap_id);
+      return AR_EBADPARAM;
+   }
+
+   if (posal_heapmgr_is_live(&posal_heapmgr_arenas[heap_idx]))
+   {
+      arena_ptr = &posal_heapmgr_arenas[heap_idx];
+      stats_ptr = &posal_globalstate.avs_stats[heap_id];
+
+      // Live blocks would be handed to libc free once the range is gone, so the heap stays until they are freed.
+      // Checked and retired under the arena lock: a free that already found this arena holds a live block, which
+      // keeps curr_heap non zero until it has taken the lock.
+      pthread_mutex_lock(&arena_ptr->lock);
+      if (0 != stats_ptr->curr_heap)
+      {
+         pthread_mutex_unlock(&arena_ptr->lock);
+         pthread_mutex_unlock(&posal_heapmgr_table_lock);
+         AR_MSG(DBG_ERROR_PRIO,
+                "POSAL HEAPMGR: Cannot destroy heap id %lu, %lu bytes still allocated (mallocs %lu, frees %lu)",
+                heap_id,
+                stats_ptr->curr_heap,
+                stats_ptr->num_mallocs,
+                stats_ptr->num_frees);
+         return AR_EBUSY;
+      }
+      __atomic_add_fetch(&arena_ptr->seq, 1, __ATOMIC_RELEASE);
+      pthread_mutex_unlock(&arena_ptr->lock);
+
+      __atomic_sub_fetch(&posal_heapmgr_num_arenas, 1, __ATOMIC_RELEASE);
+   }
+
+   __atomic_store_n(&posal_heap_table[heap_idx].used_flag, FALSE, __ATOMIC_RELEASE);
+   memset(&posal_heap_table[heap_idx], 0, sizeof(posal_heap_table_t));
+
+   if (NULL != arena_ptr)
+   {
+      posal_heapmgr_arena_destroy(arena_ptr);
+   }
+
+   pthread_mutex_unlock(&posal_heapmgr_table_lock);
+
+   AR_MSG(DBG_HIGH_PRIO, "POSAL HEAPMGR: Destroyed heap id %lu", heap_id);
+   return AR_EOK;
+}
@@ -14,6 +14,12 @@
  * ------------------------------------------------------------------------- */
 #include "posal.h"
 #include "posal_linux_signal.h"
+#if defined(POSAL_LINUX_SIGNAL_USES_FUTEX)
+#include <limits.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 /* ----------------------------------------------------------------------------
  * Global Declarations/Definitions
@@ -24,6 +30,122 @@
 /* -------------------------------------------------------------------------
  * Function Definitions
  * ------------------------------------------------------------------------- */
+#if defined(POSAL_LINUX_SIGNAL_USES_FUTEX)
+static inline void posal_linux_futex_wait(uint32_t *word_ptr, uint32_t expected)
+{
+    // Returns right away with EAGAIN if the word no longer holds the expected value
+    syscall(SYS_futex, word_ptr, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+}
+
+static inline void posal_linux_futex_wake_all(uint32_t *word_ptr)
+{
+    syscall(SYS_futex, word_ptr, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
+
+ar_result_t posal_linux_signal_create(posal_linux_signal_t *signal)
+{
+#ifdef SAFE_MODE
+    if (NULL == signal)
+        return AR_EBADPARAM;
+#endif
+
+    posal_linux_signal_internal_t *signal_handles = (posal_linux_signal_internal_t *)malloc(sizeof(posal_linux_signal_internal_t));
+    if (NULL == signal_handles) {
+        AR_MSG(DBG_ERROR_PRIO,"%s: Failed to allocate signal\n", __func__);
+        return AR_ENOMEMORY;
+    }
+
+    signal_handles->signalled   = 0;
+    signal_handles->num_waiters = 0;
+
+    *signal = (posal_linux_signal_t)signal_handles;
+    return AR_EOK;
+}
+
+ar_result_t posal_linux_signal_destroy(posal_linux_signal_t *signal)
+{
+#ifdef SAFE_MODE
+    if (NULL == signal)
+        return AR_EBADPARAM;
+#endif
+
+    free(*signal);
+    return AR_EOK;
+}
+
+ar_result_t posal_linux_signal_clear(posal_linux_signal_t *signal, uint32_t signal_bitmask)
+{
+    posal_linux_signal_internal_t *signal_handles = (posal_linux_signal_internal_t *)(*signal);
+
+#ifdef SAFE_MODE
+    if (NULL == signal)
+        return AR_EBADPARAM;
+#endif
+
+    __atomic_and_fetch(&signal_handles->signalled, ~signal_bitmask, __ATOMIC_RELEASE);
+    return AR_EOK;
+}
+
+uint32_t posal_linux_signal_wait(posal_linux_signal_t *signal, uint32_t signal_mask)
+{
+    posal_linux_signal_internal_t *signal_handles = (posal_linux_signal_internal_t *)(*signal);
+
+    if (signal_mask == 0)
+    {
+        return 0;
+    }
+
+    uint32_t current_signals = __atomic_load_n(&signal_handles->signalled, __ATOMIC_ACQUIRE);
+    if (current_signals & signal_mask)
+    {
+        return current_signals & signal_mask;
+    }
+
+    // Announce the waiter before the final check, set() reads num_waiters after publishing its bits, so either the
+    // bits are seen here or set() sees the waiter and wakes it.
+    __atomic_add_fetch(&signal_handles->num_waiters, 1, __ATOMIC_SEQ_CST);
+    while (0 == ((current_signals = __atomic_load_n(&signal_handles->signalled, __ATOMIC_SEQ_CST)) & signal_mask))
+    {
+        posal_linux_futex_wait(&signal_handles->signalled, current_signals);
+    }
+    __atomic_sub_fetch(&signal_handles->num_waiters, 1, __ATOMIC_RELAXED);
+
+    return current_signals & signal_mask;
+}
+
+ar_result_t posal_linux_signal_set(posal_linux_signal_t *signal, uint32_t signal_mask)
+{
+    posal_linux_signal_internal_t *signal_handles = (posal_linux_signal_internal_t *)*signal;
+
+#ifdef SAFE_MODE
+    if (NULL == signal)
+        return AR_EBADPARAM;
+#endif
+
+    // Bits which are already set have been or are being delivered by the thread which set them. The fence orders
+    // the caller's preceding stores (e.g. an SPSC queue tail) before this load and pairs with the fence a consumer
+    // issues between clearing the bit and re-checking its source, so one of the two always sees the other.
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if ((__atomic_load_n(&signal_handles->signalled, __ATOMIC_RELAXED) & signal_mask) == signal_mask)
+    {
+        return AR_EOK;
+    }
+
+    __atomic_or_fetch(&signal_handles->signalled, signal_mask, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&signal_handles->num_waiters, __ATOMIC_SEQ_CST))
+    {
+        posal_linux_futex_wake_all(&signal_handles->signalled);
+    }
+    return AR_EOK;
+}
+
+uint32_t posal_linux_signal_get(posal_linux_signal_t *signal)
+{
+    posal_linux_signal_internal_t *signal_handles = (posal_linux_signal_internal_t *)*signal;
+
+    return __atomic_load_n(&signal_handles->signalled, __ATOMIC_ACQUIRE);
+}
+#else
 ar_result_t posal_linux_signal_create(posal_linux_signal_t *signal)
 {
 	ar_result_t status = AR_EOK;
@@ -276,4 +398,5 @@ uint32_t posal_linux_signal_get(posal_linux_signal_t *signal)
     }
 
     return current_signals;
-}
\ No newline at end of file
+}
+#endif //POSAL_LINUX_SIGNAL_USES_FUTEX
@@ -222,7 +222,8 @@ static void posal_mem_prof_update_stats(void *ptr, POSAL_HEAP_ID update_heap_id,
 
 uint32_t posal_mem_prof_get_mem_size(void *ptr, POSAL_HEAP_ID orig_heap_id)
 {
-   return 0;
+   /** Only heap manager blocks carry their size, default heap (libc) allocations are not profiled */
+   return posal_heapmgr_get_block_size(ptr);
 }
 
 inline void posal_mem_prof_pre_process_malloc(POSAL_HEAP_ID  orig_heap_id,
@@ -26,10 +26,23 @@
 
 ----------------------------------------------------------------------------------------------------------------------*/
 
+extern posal_heap_table_t posal_heap_table[POSAL_HEAP_MGR_MAX_NUM_HEAPS];
+
+/*----------------------------------------------------------------------------------------------------------------------
+
+----------------------------------------------------------------------------------------------------------------------*/
+
 bool_t posal_check_if_addr_within_heap_idx_range(uint32_t heap_table_idx, void *target_addr)
 {
    bool_t addr_within_range = FALSE;
 
+   if ((heap_table_idx < POSAL_HEAP_MGR_MAX_NUM_HEAPS) &&
+       __atomic_load_n(&posal_heap_table[heap_table_idx].used_flag, __ATOMIC_ACQUIRE))
+   {
+      addr_within_range = ((uint64_t)target_addr >= posal_heap_table[heap_table_idx].start_addr) &&
+                          ((uint64_t)target_addr < posal_heap_table[heap_table_idx].end_addr);
+   }
+
    return addr_within_range;
 }
 
@@ -91,7 +104,15 @@ static inline void *posal_memory_malloc_inline(uint32_t unBytes, POSAL_HEAP_ID o
       goto __posal_memory_malloc_end;
    }
 
-   ptr = malloc(appended_bytes);
+   /* heaps created through posal_memory_heapmgr_create_v2 are served from their own arena, others from libc */
+   if (posal_heapmgr_is_arena_heap(heapId))
+   {
+      ptr = posal_heapmgr_alloc(heapId, appended_bytes);
+   }
+   else
+   {
+      ptr = malloc(appended_bytes);
+   }
 
 __posal_memory_malloc_end:
    posal_mem_prof_post_process_malloc(ptr, origheapId, (appended_bytes != unBytes));
@@ -149,11 +170,23 @@ void posal_memory_free_internal(void *ptr, bool_t track_mem_stats)
 
    posal_mem_prof_process_free(ptr);
 
+   heap_table_idx = posal_heapmgr_get_heap_idx(ptr);
+   heap_id        = (heap_table_idx < POSAL_HEAP_MGR_MAX_NUM_HEAPS) ? HEAP_ID_FROM_HEAP_TABLE_INDEX(heap_table_idx)
+                                                                    : POSAL_DEFAULT_HEAP_INDEX;
+
    if (track_mem_stats)
    {
-      posal_memory_stats_update(ptr, IS_FREE, 0, POSAL_DEFAULT_HEAP_INDEX);
+      posal_memory_stats_update(ptr, IS_FREE, 0, heap_id);
+   }
+
+   if (POSAL_DEFAULT_HEAP_INDEX != heap_id)
+   {
+      posal_heapmgr_free(heap_table_idx, ptr);
+   }
+   else
+   {
+      free(ptr);
    }
-   free(ptr);
 }
 
 /*----------------------------------------------------------------------------------------------------------------------
@@ -229,30 +262,6 @@ void posal_memory_aligned_free_internal(void *ptr, bool_t track_mem_stats)
    posal_memory_free_internal(pTemp, track_mem_stats);
 }
 
-ar_result_t posal_memory_heapmgr_create(POSAL_HEAP_ID *heap_id_ptr,
-                                        void *         heap_start_ptr,
-                                        uint32_t       heap_size,
-                                        bool_t         is_init_heap_needed)
-{
-   return AR_EOK;
-}
-ar_result_t posal_memory_heapmgr_create_v2(POSAL_HEAP_ID *          heap_id_ptr,
-                                           void *                   heap_start_ptr,
-                                           uint32_t                 heap_size,
-                                           bool_t                   is_init_heap_needed,
-                                           uint32_t                 heap_type,
-                                           posal_heap_tcm_handle_t *tcm_handle_ptr,
-                                           char *                   tcm_name,
-                                           uint32_t                 tcm_name_len)
-{
-   return AR_EOK;
-}
-
-ar_result_t posal_memory_heapmgr_destroy(POSAL_HEAP_ID origheapId)
-{
-   return AR_EOK;
-}
-
 void *posal_memory_malloc(uint32_t unBytes, POSAL_HEAP_ID origheapId)
 {
    return posal_memory_malloc_inline(unBytes, origheapId, TRACK_MEM_STATS_TRUE);
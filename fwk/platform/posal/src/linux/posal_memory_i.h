@@ -16,11 +16,48 @@
 #include "ar_error_codes.h"
 #include "posal_types.h"
 #include "posal_memory.h"
+#include <pthread.h>
 
 
 /* ----------------------------------------------------------------------------
  * Global Declarations/Definitions
  * ------------------------------------------------------------------------- */
+/* Size classes: 16 linear classes of 16 bytes up to 256 bytes, then 4 classes per power of two (1.25x steps) */
+#define POSAL_HEAPMGR_NUM_LINEAR_CLASSES 16
+#define POSAL_HEAPMGR_LINEAR_CLASS_MAX_SIZE 256
+#define POSAL_HEAPMGR_LINEAR_CLASS_MAX_SIZE_LOG2 8
+#define POSAL_HEAPMGR_NUM_SIZE_CLASSES (POSAL_HEAPMGR_NUM_LINEAR_CLASSES + (32 - POSAL_HEAPMGR_LINEAR_CLASS_MAX_SIZE_LOG2) * 4)
+#define POSAL_HEAPMGR_CLASS_BITMAP_WORDS ((POSAL_HEAPMGR_NUM_SIZE_CLASSES + 63) / 64)
+
+/* Every block is preceded by this header, keeps the payload 16 byte aligned like libc malloc */
+typedef struct posal_heapmgr_block_hdr_t
+{
+   uint32_t magic;      /* POSAL_HEAPMGR_BLOCK_MAGIC while allocated, cleared on free */
+   uint16_t class_idx;  /* Size class the block was carved for */
+   uint16_t heap_idx;   /* Heap table index of the owning arena */
+   uint32_t req_bytes;  /* Bytes requested by the client, for stats */
+   uint32_t reserved;
+} posal_heapmgr_block_hdr_t;
+
+/* Per heap arena: blocks are carved from [base_ptr, end_ptr) and recycled through per size class free lists.
+   Arenas are statically allocated, one per heap table entry, so a lookup racing with destroy never reads freed
+   memory. */
+typedef struct posal_heapmgr_arena_t
+{
+   uint32_t        seq;                 /* Odd while the arena is live, bumped when it is published and retired */
+   uint64_t        start_addr;          /* Region start, read by lock-free lookups under seq */
+   uint64_t        end_addr;            /* Region end, read by lock-free lookups under seq */
+   pthread_mutex_t lock;                /* Serializes alloc/free within this heap only */
+   uint8_t        *bump_ptr;            /* Start of the never-used part of the region */
+   uint8_t        *end_ptr;             /* End of the region */
+   void           *map_ptr;             /* Region allocated by the heap manager itself, NULL if caller supplied */
+   uint32_t        map_size;            /* Size of map_ptr */
+   uint32_t        heap_idx;            /* Heap table index */
+   uint32_t        num_alloc_failures;  /* Allocations that could not be served from this heap */
+   void           *free_list_ptr[POSAL_HEAPMGR_NUM_SIZE_CLASSES];
+   uint64_t        non_empty_bitmap[POSAL_HEAPMGR_CLASS_BITMAP_WORDS]; /* Bit set if free list is non-empty */
+} posal_heapmgr_arena_t;
+
 /* posal heap manager heap table structure */
 typedef struct posal_heap_table_t
 {
@@ -36,4 +73,19 @@ typedef struct posal_heap_table_t
  * ------------------------------------------------------------------------- */
 bool_t posal_check_if_addr_within_heap_idx_range(uint32_t heap_table_idx, void *target_addr);
 
+/* Returns TRUE if an arena is active for the given actual heap id */
+bool_t posal_heapmgr_is_arena_heap(POSAL_HEAP_ID heap_id);
+
+/* Allocates from the arena of the given actual heap id. Returns NULL if the heap is exhausted */
+void *posal_heapmgr_alloc(POSAL_HEAP_ID heap_id, uint32_t bytes);
+
+/* Returns heap table index of the arena owning ptr, POSAL_HEAP_MGR_MAX_NUM_HEAPS if ptr is not from an arena */
+uint32_t posal_heapmgr_get_heap_idx(void *ptr);
+
+/* Returns the block to the arena at heap_table_idx */
+void posal_heapmgr_free(uint32_t heap_table_idx, void *ptr);
+
+/* Returns usable size of an arena block, 0 if ptr is not from an arena */
+uint32_t posal_heapmgr_get_block_size(void *ptr);
+
 #endif // POSAL_BUFMGR_I_H
\ No newline at end of file
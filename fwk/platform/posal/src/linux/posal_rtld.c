@@ -42,6 +42,10 @@ void* posal_dlopenbuf(const char* name, const char* buf, int len, int flags)
 
 int posal_dlclose(void* handle)
 {
+#ifdef AR_MSG_DEFERRED
+    // pending deferred logs point to the strings of the library, write them before it is unloaded
+    (void)ar_log_deferred_flush();
+#endif
     return dlclose(handle);
 }
 
@@ -11,10 +11,18 @@
 /* =======================================================================
 INCLUDE FILES FOR MODULE
 ========================================================================== */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // pthread_setname_np
+#endif
 #include "posal.h"
-#include <signal.h>           /* Definition of SIGEV_* constants */
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
 #include <time.h>
 #include <unistd.h> // for usleep
+#ifndef __ZEPHYR__
+#include <sys/timerfd.h>
+#endif
 #include "posal_internal.h"
 #include "posal_target_i.h"
 #include <ar_osal_timer.h>
@@ -32,10 +40,364 @@ INCLUDE FILES FOR MODULE
 #define TIMER_SIGNAL_MARGIN 300
 #define TIMER_SLEEP_MARGIN 200
 
+#define POSAL_TIMER_NOT_ARMED (-1)
+#define POSAL_TIMER_SVC_INIT_QUEUE_SIZE 64
+
+/* All timers are served by one dispatch thread. Armed timers are kept in a min heap ordered by expiry time and a
+   single timerfd is programmed with the earliest expiry, so the number of timers is not limited by file descriptors
+   and expiry costs neither a thread handoff nor a signal. The dispatch thread sets the client signal directly, or
+   calls the client callback with the service lock released. */
+typedef struct posal_timer_svc_t
+{
+   pthread_mutex_t      lock;
+   posal_timer_info_t **queue_pptr;   /**< Min heap of armed timers ordered by expiry_time. */
+   uint32_t             queue_size;   /**< Number of entries allocated in queue_pptr. */
+   uint32_t             num_armed;    /**< Number of armed timers in queue_pptr. */
+   uint32_t             num_timers;   /**< Number of created timers, the queue always has room for all of them. */
+   posal_timer_info_t  *cb_timer_ptr; /**< Timer whose callback is being invoked by the dispatch thread. */
+   pthread_cond_t       cb_done_cond;
+   pthread_t            thread;
+   bool_t               is_init_done;
+#ifdef __ZEPHYR__
+   pthread_cond_t       rearm_cond;
+#else
+   int                  timer_fd;
+#endif
+} posal_timer_svc_t;
+
+static posal_timer_svc_t posal_timer_svc = { .lock = PTHREAD_MUTEX_INITIALIZER };
+static pthread_once_t    posal_timer_svc_once = PTHREAD_ONCE_INIT;
+
 /* =======================================================================
  **                          Function Definitions
  ** ======================================================================= */
 
+static uint64_t posal_timer_svc_now(void)
+{
+   struct timespec ts = { 0 };
+   clock_gettime(POSAL_CLOCK_ID, &ts);
+   return ((uint64_t)ts.tv_sec * 1000000) + ((uint64_t)ts.tv_nsec / 1000);
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+ Timer queue, all functions below must be called with the service lock held.
+----------------------------------------------------------------------------------------------------------------------*/
+static void posal_timer_queue_place(posal_timer_info_t *p_timer, uint32_t idx)
+{
+   posal_timer_svc.queue_pptr[idx] = p_timer;
+   p_timer->heap_idx               = (int32_t)idx;
+}
+
+static void posal_timer_queue_sift_up(uint32_t idx)
+{
+   posal_timer_info_t *p_timer = posal_timer_svc.queue_pptr[idx];
+   while (idx > 0)
+   {
+      uint32_t parent = (idx - 1) >> 1;
+      if (posal_timer_svc.queue_pptr[parent]->expiry_time <= p_timer->expiry_time)
+      {
+         break;
+      }
+      posal_timer_queue_place(posal_timer_svc.queue_pptr[parent], idx);
+      idx = parent;
+   }
+   posal_timer_queue_place(p_timer, idx);
+}
+
+static void posal_timer_queue_sift_down(uint32_t idx)
+{
+   posal_timer_info_t *p_timer = posal_timer_svc.queue_pptr[idx];
+   uint32_t            n       = posal_timer_svc.num_armed;
+   for (;;)
+   {
+      uint32_t child = (idx << 1) + 1;
+      if (child >= n)
+      {
+         break;
+      }
+      if ((child + 1 < n) &&
+          (posal_timer_svc.queue_pptr[child + 1]->expiry_time < posal_timer_svc.queue_pptr[child]->expiry_time))
+      {
+         child++;
+      }
+      if (p_timer->expiry_time <= posal_timer_svc.queue_pptr[child]->expiry_time)
+      {
+         break;
+      }
+      posal_timer_queue_place(posal_timer_svc.queue_pptr[child], idx);
+      idx = child;
+   }
+   posal_timer_queue_place(p_timer, idx);
+}
+
+static void posal_timer_queue_remove(posal_timer_info_t *p_timer)
+{
+   uint32_t idx = (uint32_t)p_timer->heap_idx;
+   uint32_t last = --posal_timer_svc.num_armed;
+
+   p_timer->heap_idx = POSAL_TIMER_NOT_ARMED;
+   if (idx == last)
+   {
+      return;
+   }
+
+   posal_timer_queue_place(posal_timer_svc.queue_pptr[last], idx);
+   if ((idx > 0) &&
+       (posal_timer_svc.queue_pptr[idx]->expiry_time < posal_timer_svc.queue_pptr[(idx - 1) >> 1]->expiry_time))
+   {
+      posal_timer_queue_sift_up(idx);
+   }
+   else
+   {
+      posal_timer_queue_sift_down(idx);
+   }
+}
+
+static void posal_timer_queue_insert(posal_timer_info_t *p_timer)
+{
+   posal_timer_queue_place(p_timer, posal_timer_svc.num_armed++);
+   posal_timer_queue_sift_up((uint32_t)p_timer->heap_idx);
+}
+
+/* Programs the wakeup of the dispatch thread for the earliest expiry. */
+static void posal_timer_svc_rearm(void)
+{
+#ifdef __ZEPHYR__
+   pthread_cond_signal(&posal_timer_svc.rearm_cond);
+#else
+   struct itimerspec its = { 0 };
+   if (posal_timer_svc.num_armed)
+   {
+      uint64_t expiry_time = posal_timer_svc.queue_pptr[0]->expiry_time;
+      its.it_value.tv_sec  = expiry_time / 1000000;
+      its.it_value.tv_nsec = (expiry_time % 1000000) * 1000;
+      if ((0 == its.it_value.tv_sec) && (0 == its.it_value.tv_nsec))
+      {
+         // A zero value disarms the timerfd, an expiry in the past fires right away.
+         its.it_value.tv_nsec = 1;
+      }
+   }
+   if (0 != timerfd_settime(posal_timer_svc.timer_fd, TFD_TIMER_ABSTIME, &its, NULL))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "Failed to program timer service, errno %d", errno);
+   }
+#endif
+}
+
+/* Arms or re-arms the timer for the given expiry, the dispatch thread is only reprogrammed if the earliest expiry
+   changes. */
+static void posal_timer_arm(posal_timer_info_t *p_timer, uint64_t expiry_time, uint64_t period)
+{
+   pthread_mutex_lock(&posal_timer_svc.lock);
+
+   posal_timer_info_t *prev_head_ptr = posal_timer_svc.num_armed ? posal_timer_svc.queue_pptr[0] : NULL;
+   uint64_t            prev_expiry   = prev_head_ptr ? prev_head_ptr->expiry_time : 0;
+
+   if (POSAL_TIMER_NOT_ARMED != p_timer->heap_idx)
+   {
+      posal_timer_queue_remove(p_timer);
+   }
+   p_timer->timer_start_time = posal_timer_svc_now();
+   p_timer->expiry_time      = expiry_time;
+   p_timer->duration         = period ? period
+                                      : ((expiry_time > p_timer->timer_start_time)
+                                            ? (expiry_time - p_timer->timer_start_time)
+                                            : 0);
+   posal_timer_queue_insert(p_timer);
+
+   if ((posal_timer_svc.queue_pptr[0] != prev_head_ptr) || (posal_timer_svc.queue_pptr[0]->expiry_time != prev_expiry))
+   {
+      posal_timer_svc_rearm();
+   }
+
+   pthread_mutex_unlock(&posal_timer_svc.lock);
+}
+
+static void posal_timer_disarm(posal_timer_info_t *p_timer)
+{
+   pthread_mutex_lock(&posal_timer_svc.lock);
+   if (POSAL_TIMER_NOT_ARMED != p_timer->heap_idx)
+   {
+      bool_t was_head = (0 == p_timer->heap_idx);
+      posal_timer_queue_remove(p_timer);
+      if (was_head)
+      {
+         posal_timer_svc_rearm();
+      }
+   }
+   pthread_mutex_unlock(&posal_timer_svc.lock);
+}
+
+static void posal_timer_expire(posal_timer_info_t *p_timer)
+{
+   if (POSAL_TIMER_NOTIFY_OBJ_TYPE_SIGNAL == p_timer->notification_type)
+   {
+      posal_channel_internal_t *p_channel = (posal_channel_internal_t *)p_timer->pChannel;
+      posal_signal_set_target_inline(&p_channel->anysig, p_timer->timer_sigmask);
+   }
+   else
+   {
+      // The callback may restart, stop or destroy this timer, so it is invoked without the lock and the timer is not
+      // touched afterwards.
+      posal_timer_callback_info_t cb_info = p_timer->cb_info;
+      posal_timer_svc.cb_timer_ptr        = p_timer;
+      pthread_mutex_unlock(&posal_timer_svc.lock);
+
+      cb_info.cb_func_ptr(cb_info.cb_context_ptr);
+
+      pthread_mutex_lock(&posal_timer_svc.lock);
+      posal_timer_svc.cb_timer_ptr = NULL;
+      pthread_cond_broadcast(&posal_timer_svc.cb_done_cond);
+   }
+#ifdef DEBUG_POSAL_TIMER
+      prev_trigger_count = trigger_counter;
+      trigger_counter++;
+      is_timer_triggered = TRUE;
+#endif // DEBUG_POSAL_TIMER
+}
+
+static void *posal_timer_svc_thread(void *arg)
+{
+   pthread_mutex_lock(&posal_timer_svc.lock);
+   for (;;)
+   {
+#ifdef __ZEPHYR__
+      if (0 == posal_timer_svc.num_armed)
+      {
+         pthread_cond_wait(&posal_timer_svc.rearm_cond, &posal_timer_svc.lock);
+      }
+      else
+      {
+         uint64_t        expiry_time = posal_timer_svc.queue_pptr[0]->expiry_time;
+         struct timespec ts          = { .tv_sec  = expiry_time / 1000000,
+                                         .tv_nsec = (expiry_time % 1000000) * 1000 };
+         pthread_cond_timedwait(&posal_timer_svc.rearm_cond, &posal_timer_svc.lock, &ts);
+      }
+#else
+      uint64_t num_expirations = 0;
+      pthread_mutex_unlock(&posal_timer_svc.lock);
+      if ((sizeof(num_expirations) != read(posal_timer_svc.timer_fd, &num_expirations, sizeof(num_expirations))) &&
+          (EINTR != errno))
+      {
+         AR_MSG(DBG_ERROR_PRIO, "Timer service read failed, errno %d", errno);
+      }
+      pthread_mutex_lock(&posal_timer_svc.lock);
+#endif
+
+      uint64_t now = posal_timer_svc_now();
+      while (posal_timer_svc.num_armed && (posal_timer_svc.queue_pptr[0]->expiry_time <= now))
+      {
+         posal_timer_info_t *p_timer = posal_timer_svc.queue_pptr[0];
+         if ((POSAL_TIMER_PERIODIC == p_timer->uTimerType) && (p_timer->duration > 0))
+         {
+            // Expiries missed while the thread was held off are dropped, like timer overruns of POSIX timers.
+            uint64_t period = p_timer->duration;
+            p_timer->expiry_time += ((now - p_timer->expiry_time) / period + 1) * period;
+            posal_timer_queue_sift_down(0);
+         }
+         else
+         {
+            posal_timer_queue_remove(p_timer);
+         }
+         posal_timer_expire(p_timer);
+      }
+
+#ifndef __ZEPHYR__
+      posal_timer_svc_rearm();
+#endif
+   }
+   return NULL;
+}
+
+static void posal_timer_svc_init(void)
+{
+   posal_timer_svc.queue_pptr = (posal_timer_info_t **)posal_memory_malloc(POSAL_TIMER_SVC_INIT_QUEUE_SIZE *
+                                                                              sizeof(posal_timer_info_t *),
+                                                                           POSAL_HEAP_DEFAULT);
+   if (NULL == posal_timer_svc.queue_pptr)
+   {
+      AR_MSG(DBG_ERROR_PRIO, "Timer service queue allocation failure");
+      return;
+   }
+   posal_timer_svc.queue_size = POSAL_TIMER_SVC_INIT_QUEUE_SIZE;
+   pthread_cond_init(&posal_timer_svc.cb_done_cond, NULL);
+
+#ifdef __ZEPHYR__
+   pthread_condattr_t cond_attr;
+   pthread_condattr_init(&cond_attr);
+   pthread_condattr_setclock(&cond_attr, POSAL_CLOCK_ID);
+   pthread_cond_init(&posal_timer_svc.rearm_cond, &cond_attr);
+   pthread_condattr_destroy(&cond_attr);
+#else
+   posal_timer_svc.timer_fd = timerfd_create(POSAL_CLOCK_ID, TFD_CLOEXEC);
+   if (posal_timer_svc.timer_fd < 0)
+   {
+      AR_MSG(DBG_ERROR_PRIO, "Failed to create timer service timerfd, errno %d", errno);
+      posal_memory_free(posal_timer_svc.queue_pptr);
+      posal_timer_svc.queue_pptr = NULL;
+      return;
+   }
+#endif
+
+   if (0 != pthread_create(&posal_timer_svc.thread, NULL, posal_timer_svc_thread, NULL))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "Failed to create timer service thread");
+      return;
+   }
+#ifndef __ZEPHYR__
+   pthread_setname_np(posal_timer_svc.thread, "posal_timer");
+#endif
+
+   // Expiry latency is the wakeup latency of this thread, run it above the threads it signals when permitted.
+   struct sched_param sch_param = { .sched_priority = sched_get_priority_max(SCHED_FIFO) };
+   int                rc        = pthread_setschedparam(posal_timer_svc.thread, SCHED_FIFO, &sch_param);
+   if (rc)
+   {
+      AR_MSG(DBG_HIGH_PRIO, "Warning: timer service thread runs without SCHED_FIFO, error %d", rc);
+   }
+
+   posal_timer_svc.is_init_done = TRUE;
+}
+
+/* Reserves a queue entry for a new timer so that arming never needs to allocate. */
+static ar_result_t posal_timer_svc_add_timer(void)
+{
+   pthread_once(&posal_timer_svc_once, posal_timer_svc_init);
+   if (!posal_timer_svc.is_init_done)
+   {
+      return AR_EFAILED;
+   }
+
+   ar_result_t result = AR_EOK;
+   pthread_mutex_lock(&posal_timer_svc.lock);
+   if (posal_timer_svc.num_timers == posal_timer_svc.queue_size)
+   {
+      uint32_t             new_size   = posal_timer_svc.queue_size * 2;
+      posal_timer_info_t **queue_pptr =
+         (posal_timer_info_t **)posal_memory_malloc(new_size * sizeof(posal_timer_info_t *), POSAL_HEAP_DEFAULT);
+      if (NULL == queue_pptr)
+      {
+         result = AR_ENOMEMORY;
+      }
+      else
+      {
+         memscpy(queue_pptr,
+                 new_size * sizeof(posal_timer_info_t *),
+                 posal_timer_svc.queue_pptr,
+                 posal_timer_svc.num_armed * sizeof(posal_timer_info_t *));
+         posal_memory_free(posal_timer_svc.queue_pptr);
+         posal_timer_svc.queue_pptr = queue_pptr;
+         posal_timer_svc.queue_size = new_size;
+      }
+   }
+   if (AR_EOK == result)
+   {
+      posal_timer_svc.num_timers++;
+   }
+   pthread_mutex_unlock(&posal_timer_svc.lock);
+   return result;
+}
+
 /**
   Deletes an existing timer.
 
@@ -58,42 +420,33 @@ ar_result_t posal_timer_destroy(posal_timer_t *pp_obj)
 ar_result_t posal_timer_destroy_v2(posal_timer_t *pp_obj)
 {
    posal_timer_info_t *p_timer = NULL;
-   int nStatus = AR_EOK;
 
    if (!pp_obj || !*pp_obj)
       return AR_EBADPARAM;
 
    p_timer = (posal_timer_info_t *)(*pp_obj);
-   if (!p_timer->timer_obj)
+   if (!p_timer->istimerCreated)
       return AR_EBADPARAM;
 
-   timer_t *timerId = (timer_t *)p_timer->timer_obj;
-
-   nStatus = timer_delete(*timerId);
-   if (nStatus != 0) {
-      AR_MSG(DBG_ERROR_PRIO, "Failed to destroy timer");
-      return AR_EFAILED;
+   pthread_mutex_lock(&posal_timer_svc.lock);
+   if (POSAL_TIMER_NOT_ARMED != p_timer->heap_idx)
+   {
+      posal_timer_queue_remove(p_timer);
    }
+   // Wait for a running callback of this timer to return, unless it is the callback destroying its own timer.
+   while ((posal_timer_svc.cb_timer_ptr == p_timer) && !pthread_equal(pthread_self(), posal_timer_svc.thread))
+   {
+      pthread_cond_wait(&posal_timer_svc.cb_done_cond, &posal_timer_svc.lock);
+   }
+   posal_timer_svc.num_timers--;
+   pthread_mutex_unlock(&posal_timer_svc.lock);
 
-   free(timerId);
-   free(p_timer);
+   posal_memory_free(p_timer);
    *pp_obj = NULL;
 
    return AR_EOK;
 }
 
-static void posal_timer_expire_cb(union sigval sv)
-{
-   posal_timer_info_t *p_timer = (posal_timer_info_t *)sv.sival_ptr;
-   posal_channel_internal_t *p_channel = (posal_channel_internal_t *)p_timer->pChannel;
-   posal_signal_set_target_inline(&p_channel->anysig, p_timer->timer_sigmask);
-#ifdef DEBUG_POSAL_TIMER
-      prev_trigger_count = trigger_counter;
-      trigger_counter++;
-      is_timer_triggered = TRUE;
-#endif // DEBUG_POSAL_TIMER
-}
-
 /**
   Creates a timer in the default deferrable timer group.
 
@@ -147,8 +500,7 @@ int32_t posal_timer_create_v2(posal_timer_t *                        pp_timer,
                               void *                                 client_info_ptr,
                               POSAL_HEAP_ID                          heap_id)
 {
-   int nStatus = 0;
-   struct sigevent timer_event = {0};
+   ar_result_t result = AR_EOK;
 
    if ((NULL == pp_timer) || (NULL == client_info_ptr) ||
        (notification_type >= MAX_SUPPORTED_POSAL_TIMER_NOTIFY_OBJ_TYPES))
@@ -172,50 +524,42 @@ int32_t posal_timer_create_v2(posal_timer_t *                        pp_timer,
    }
    memset(p_timer, 0, sizeof(posal_timer_info_t));
 
-   //Allocate timer id
-   timer_t *timerId = NULL;
-   if (NULL == (timerId = (posal_timer_info_t *)posal_memory_malloc(sizeof(timer_t), heap_id)))
-   {
-      AR_MSG(DBG_ERROR_PRIO, "Memory allocation failure");
-      posal_memory_free(p_timer);
-      posal_memory_free(timerId);
-      return AR_ENOMEMORY;
-   }
-   memset(timerId, 0, sizeof(timer_t));
-
    // init timer structure
-   p_timer->istimerCreated = FALSE;
-   p_timer->uTimerType     = (uint32_t)timerType;
-   p_timer->duration       = ATS_TIMER_MAX_DURATION;
-   p_timer->heap_id        = (POSAL_HEAP_ID)heap_id;
-   p_timer->timer_obj      = timerId; //save pointer to timer
-
-   //Set signal for timer
-   posal_signal_t p_signal = NULL;
+   p_timer->istimerCreated    = FALSE;
+   p_timer->uTimerType        = (uint32_t)timerType;
+   p_timer->duration          = ATS_TIMER_MAX_DURATION;
+   p_timer->heap_id           = (POSAL_HEAP_ID)heap_id;
+   p_timer->heap_idx          = POSAL_TIMER_NOT_ARMED;
+   p_timer->notification_type = (uint32_t)notification_type;
+
+   //Set signal or callback for timer
    if (POSAL_TIMER_NOTIFY_OBJ_TYPE_SIGNAL == notification_type)
    {
-      p_signal = client_info_ptr;
+      posal_signal_t p_signal = client_info_ptr;
       if (NULL == (p_timer->pChannel = posal_signal_get_channel(p_signal)))
       {
          AR_MSG(DBG_ERROR_PRIO, "Signal does not belong to any channel");
          posal_memory_free(p_timer);
-         posal_memory_free(timerId);
          return AR_EFAILED;
       }
       p_timer->timer_sigmask = posal_signal_get_channel_bit(p_signal);
    }
-   //Create linux timer
-   timer_event.sigev_notify = SIGEV_THREAD;
-   timer_event.sigev_notify_function = &posal_timer_expire_cb;
-   timer_event.sigev_value.sival_ptr = p_timer; //Save the timer info for callback function
+   else
+   {
+      p_timer->cb_info = *((posal_timer_callback_info_t *)client_info_ptr);
+      if (NULL == p_timer->cb_info.cb_func_ptr)
+      {
+         AR_MSG(DBG_ERROR_PRIO, "Timer callback function is NULL");
+         posal_memory_free(p_timer);
+         return AR_EBADPARAM;
+      }
+   }
 
-   nStatus = timer_create(POSAL_CLOCK_ID, &timer_event, timerId);
-   if (nStatus != 0)
+   if (AR_EOK != (result = posal_timer_svc_add_timer()))
    {
-      AR_MSG(DBG_ERROR_PRIO, "Failed to create timer");
+      AR_MSG(DBG_ERROR_PRIO, "Failed to create timer, result 0x%lx", result);
       posal_memory_free(p_timer);
-      posal_memory_free(timerId);
-      return AR_EFAILED;
+      return result;
    }
 
    p_timer->istimerCreated = TRUE;
@@ -240,7 +584,8 @@ int32_t posal_timer_create_v2(posal_timer_t *                        pp_timer,
  */
 uint64_t posal_timer_get_duration(posal_timer_t p_obj)
 {
-   return 0;
+   posal_timer_info_t *p_timer = (posal_timer_info_t *)p_obj;
+   return p_timer ? p_timer->duration : 0;
 }
 
 /**
@@ -318,6 +663,14 @@ uint64_t posal_timer_get_time_in_msec(void)
  */
 int32_t posal_timer_oneshot_start_duration(posal_timer_t p_obj, int64_t duration)
 {
+   posal_timer_info_t *p_timer = (posal_timer_info_t *)p_obj;
+   if ((NULL == p_timer) || (duration < 0))
+   {
+      return AR_EBADPARAM;
+   }
+
+   posal_timer_arm(p_timer, posal_timer_svc_now() + (uint64_t)duration, 0);
+
    return AR_EOK;
 }
 
@@ -338,26 +691,16 @@ int32_t posal_timer_oneshot_start_duration(posal_timer_t p_obj, int64_t duration
  */
 int32_t posal_timer_oneshot_start_absolute(posal_timer_t p_obj, int64_t time)
 {
-   int nStatus = AR_EOK;
    posal_timer_info_t *p_timer = (posal_timer_info_t *)p_obj;
-   timer_t *timer = (timer_t*) p_timer->timer_obj;
-   struct itimerspec its = {0};
-
-   // Set the timer delay and interval
-   its.it_interval.tv_sec = 0;
-   its.it_interval.tv_nsec = 0;
-
-   //Indicates when the timer will fire next
-   its.it_value.tv_sec = time / 1000000;
-   its.it_value.tv_nsec = (time % 1000000) * 1000;
-
-   nStatus = timer_settime(*timer, TIMER_ABSTIME, &its, NULL);
-   if (nStatus != 0)
+   if ((NULL == p_timer) || (time < 0))
    {
       AR_MSG(DBG_ERROR_PRIO, "Failed to start oneshot absolute timer for time: %lld", time);
-      return AR_EFAILED;
+      return AR_EBADPARAM;
    }
 
+   // A time already in the past expires right away
+   posal_timer_arm(p_timer, (uint64_t)time, 0);
+
    return AR_EOK;
 }
 
@@ -378,26 +721,7 @@ int32_t posal_timer_oneshot_start_absolute(posal_timer_t p_obj, int64_t time)
  */
 int32_t posal_timer_periodic_start(posal_timer_t p_obj, int64_t duration)
 {
-   int nStatus = 0;
-   posal_timer_info_t *p_timer = (posal_timer_info_t *)p_obj;
-   timer_t *timer = (timer_t*) p_timer->timer_obj;
-   struct itimerspec its = {0};
-
-   //Set the timer delay and interval
-   its.it_interval.tv_sec  = duration / 1000000;
-   its.it_interval.tv_nsec = (duration % 1000000) * 1000;
-   its.it_value.tv_sec     = its.it_interval.tv_sec;
-   its.it_value.tv_nsec    = its.it_interval.tv_nsec;
-
-   //Start the timer
-   nStatus = timer_settime(*timer, 0, &its, NULL);
-   if (nStatus != 0)
-   {
-      AR_MSG(DBG_ERROR_PRIO, "Failed to start timer");
-      return AR_EFAILED;
-   }
-
-   return AR_EOK;
+   return posal_timer_periodic_start_with_offset(p_obj, duration, duration);
 }
 
 /**
@@ -417,6 +741,15 @@ int32_t posal_timer_periodic_start(posal_timer_t p_obj, int64_t duration)
  */
 int32_t posal_timer_periodic_start_with_offset(posal_timer_t p_obj, int64_t periodic_duration, int64_t start_offset)
 {
+   posal_timer_info_t *p_timer = (posal_timer_info_t *)p_obj;
+   if ((NULL == p_timer) || (periodic_duration <= 0) || (start_offset < 0))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "Failed to start periodic timer, period %lld", periodic_duration);
+      return AR_EBADPARAM;
+   }
+
+   posal_timer_arm(p_timer, posal_timer_svc_now() + (uint64_t)start_offset, (uint64_t)periodic_duration);
+
    return AR_EOK;
 }
 
@@ -436,6 +769,14 @@ int32_t posal_timer_periodic_start_with_offset(posal_timer_t p_obj, int64_t peri
  */
 int32_t posal_timer_stop(posal_timer_t p_obj)
 {
+   posal_timer_info_t *p_timer = (posal_timer_info_t *)p_obj;
+   if (NULL == p_timer)
+   {
+      return AR_EBADPARAM;
+   }
+
+   posal_timer_disarm(p_timer);
+
    return AR_EOK;
 }
 
@@ -452,7 +793,21 @@ int32_t posal_timer_stop(posal_timer_t p_obj)
  */
 uint64_t posal_timer_get_remaining_duration(posal_timer_t p_obj)
 {
-   uint64_t  duration = 0;
+   posal_timer_info_t *p_timer  = (posal_timer_info_t *)p_obj;
+   uint64_t            duration = 0;
+
+   if (NULL == p_timer)
+   {
+      return duration;
+   }
+
+   pthread_mutex_lock(&posal_timer_svc.lock);
+   if (POSAL_TIMER_NOT_ARMED != p_timer->heap_idx)
+   {
+      uint64_t now = posal_timer_svc_now();
+      duration     = (p_timer->expiry_time > now) ? (p_timer->expiry_time - now) : 0;
+   }
+   pthread_mutex_unlock(&posal_timer_svc.lock);
 
    return duration;
 }
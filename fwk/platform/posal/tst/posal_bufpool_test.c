@@ -0,0 +1,346 @@
+/***
+ * \file posal_bufpool_test.c
+ * \brief
+ *    This file tests the POSAL buffer pool with nodes cached by other threads: every node of a pool must be
+ *    available to one thread after another thread got and returned nodes and is still alive, small pools as well
+ *    as pools whose free nodes sit in the other thread's magazine. posal_bufpool_profile_mem_usage must count
+ *    the nodes held by clients only, and a refill must not allocate node arrays ahead of need. A multi-thread
+ *    get/return stress checks that no node is handed out twice and that no node is lost.
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "posal_bufpool_test.h"
+#include <sched.h>
+
+#define BUFPOOL_TEST_NODE_SIZE (16)
+#define BUFPOOL_TEST_MAX_NODES (256)
+#define BUFPOOL_TEST_NUM_THREADS (4)
+#define BUFPOOL_TEST_NUM_ITERATIONS (200000)
+#define BUFPOOL_TEST_SLOTS (16)
+
+typedef struct bufpool_test_thread_ctx_t
+{
+   uint32_t pool_handle;
+   uint32_t thread_idx;
+   uint32_t num_nodes;    /* nodes the helper gets and returns before it waits */
+   uint32_t num_failures;
+   uint32_t ready;        /* set by the helper once its nodes are returned */
+   uint32_t release;      /* set by the test to let the helper exit */
+} bufpool_test_thread_ctx_t;
+
+/********************************************************************************/
+static inline uint32_t bufpool_test_rand(uint32_t *seed_ptr)
+{
+   // xorshift32
+   *seed_ptr ^= *seed_ptr << 13;
+   *seed_ptr ^= *seed_ptr >> 17;
+   *seed_ptr ^= *seed_ptr << 5;
+   return *seed_ptr;
+}
+
+static ar_result_t bufpool_test_launch(posal_thread_t *tid_ptr, ar_result_t (*fn)(void *), void *arg_ptr)
+{
+   // time sliced rather than real time, so that the threads interleave even on one CPU
+   return posal_thread_launch3(tid_ptr, "BUFPOOL_TEST", 16 * 1024, 0, 0, fn, arg_ptr, POSAL_HEAP_DEFAULT, SCHED_OTHER, 0);
+}
+
+static uint32_t bufpool_test_bytes_used(uint32_t pool_handle, uint32_t *bytes_allocated_ptr)
+{
+   uint32_t bytes_used = 0, bytes_allocated = 0;
+
+   if (AR_FAILED(posal_bufpool_profile_mem_usage(pool_handle, &bytes_used, &bytes_allocated)))
+   {
+      return ~0u;
+   }
+   if (bytes_allocated_ptr)
+   {
+      *bytes_allocated_ptr = bytes_allocated;
+   }
+   return bytes_used;
+}
+
+/********************************************************************************/
+/* Gets and returns nodes, then stays alive, with whatever it cached, until released */
+static ar_result_t bufpool_test_helper(void *arg_ptr)
+{
+   bufpool_test_thread_ctx_t *ctx_ptr = (bufpool_test_thread_ctx_t *)arg_ptr;
+   void *                     nodes[BUFPOOL_TEST_MAX_NODES];
+
+   for (uint32_t i = 0; i < ctx_ptr->num_nodes; i++)
+   {
+      if (NULL == (nodes[i] = posal_bufpool_get_node(ctx_ptr->pool_handle)))
+      {
+         ctx_ptr->num_failures++;
+      }
+   }
+   for (uint32_t i = 0; i < ctx_ptr->num_nodes; i++)
+   {
+      if (nodes[i])
+      {
+         posal_bufpool_return_node(nodes[i]);
+      }
+   }
+
+   __atomic_store_n(&ctx_ptr->ready, 1, __ATOMIC_RELEASE);
+   while (!__atomic_load_n(&ctx_ptr->release, __ATOMIC_ACQUIRE))
+   {
+      sched_yield();
+   }
+   return AR_EOK;
+}
+
+/* A helper thread uses the pool first, then this thread must get every node of it while the helper is alive */
+static ar_result_t bufpool_test_capacity(uint16_t nodes_per_arr, uint32_t num_arrays, uint32_t helper_nodes)
+{
+   ar_result_t               result      = AR_EOK;
+   ar_result_t               thread_result;
+   uint32_t                  capacity    = nodes_per_arr * num_arrays;
+   uint32_t                  num_got     = 0;
+   uint32_t                  bytes_used  = 0;
+   posal_thread_t            tid;
+   bufpool_test_thread_ctx_t ctx;
+   void *                    nodes[BUFPOOL_TEST_MAX_NODES + 1];
+
+   uint32_t pool_handle =
+      posal_bufpool_pool_create(BUFPOOL_TEST_NODE_SIZE, POSAL_HEAP_DEFAULT, num_arrays, FOUR_BYTE_ALIGN, nodes_per_arr);
+   if (POSAL_BUFPOOL_INVALID_HANDLE == pool_handle)
+   {
+      return AR_EFAILED;
+   }
+
+   memset(&ctx, 0, sizeof(ctx));
+   ctx.pool_handle = pool_handle;
+   ctx.num_nodes   = helper_nodes;
+   if (AR_FAILED(bufpool_test_launch(&tid, bufpool_test_helper, &ctx)))
+   {
+      posal_bufpool_pool_destroy(pool_handle);
+      return AR_EFAILED;
+   }
+   while (!__atomic_load_n(&ctx.ready, __ATOMIC_ACQUIRE))
+   {
+      sched_yield();
+   }
+
+   // the helper returned everything, whatever it still caches is not in use
+   if (0 != (bytes_used = bufpool_test_bytes_used(pool_handle, NULL)))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "Bufpool test: %lu bytes used after the helper returned its nodes", bytes_used);
+      result = AR_EFAILED;
+   }
+
+   for (num_got = 0; num_got < capacity; num_got++)
+   {
+      if (NULL == (nodes[num_got] = posal_bufpool_get_node(pool_handle)))
+      {
+         AR_MSG(DBG_ERROR_PRIO, "Bufpool test: pool of %lu nodes exhausted after %lu gets", capacity, num_got);
+         result = AR_EFAILED;
+         break;
+      }
+   }
+
+   if ((capacity == num_got) && (capacity * BUFPOOL_TEST_NODE_SIZE != (bytes_used = bufpool_test_bytes_used(pool_handle, NULL))))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "Bufpool test: %lu bytes used with the whole pool held, expected %lu", bytes_used,
+             capacity * BUFPOOL_TEST_NODE_SIZE);
+      result = AR_EFAILED;
+   }
+   if ((capacity == num_got) && (NULL != (nodes[capacity] = posal_bufpool_get_node(pool_handle))))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "Bufpool test: pool of %lu nodes handed out one more", capacity);
+      posal_bufpool_return_node(nodes[capacity]);
+      result = AR_EFAILED;
+   }
+
+   for (uint32_t i = 0; i < num_got; i++)
+   {
+      posal_bufpool_return_node(nodes[i]);
+   }
+   if (0 != (bytes_used = bufpool_test_bytes_used(pool_handle, NULL)))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "Bufpool test: %lu bytes used after all nodes were returned", bytes_used);
+      result = AR_EFAILED;
+   }
+
+   __atomic_store_n(&ctx.release, 1, __ATOMIC_RELEASE);
+   posal_thread_join(tid, &thread_result);
+   if (ctx.num_failures)
+   {
+      result = AR_EFAILED;
+   }
+   posal_bufpool_pool_destroy(pool_handle);
+
+   AR_MSG(DBG_HIGH_PRIO,
+          "Bufpool test: %lu x %lu nodes, helper used %lu, capacity %s",
+          (uint32_t)nodes_per_arr,
+          num_arrays,
+          helper_nodes,
+          AR_SUCCEEDED(result) ? "ok" : "FAILED");
+   return result;
+}
+
+/* A get from a fresh pool must not allocate node arrays beyond the one it takes the node from */
+static ar_result_t bufpool_test_growth()
+{
+   ar_result_t result          = AR_EOK;
+   uint32_t    bytes_allocated = 0;
+   uint16_t    nodes_per_arr   = 4;
+   uint32_t    pool_handle =
+      posal_bufpool_pool_create(BUFPOOL_TEST_NODE_SIZE, POSAL_HEAP_DEFAULT, 64, FOUR_BYTE_ALIGN, nodes_per_arr);
+   if (POSAL_BUFPOOL_INVALID_HANDLE == pool_handle)
+   {
+      return AR_EFAILED;
+   }
+
+   void *node_ptr = posal_bufpool_get_node(pool_handle);
+   if ((NULL == node_ptr) || (BUFPOOL_TEST_NODE_SIZE != bufpool_test_bytes_used(pool_handle, &bytes_allocated)) ||
+       (nodes_per_arr * BUFPOOL_TEST_NODE_SIZE != bytes_allocated))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "Bufpool test: %lu bytes allocated for one node", bytes_allocated);
+      result = AR_EFAILED;
+   }
+   if (node_ptr)
+   {
+      posal_bufpool_return_node(node_ptr);
+   }
+   posal_bufpool_pool_destroy(pool_handle);
+
+   AR_MSG(DBG_HIGH_PRIO, "Bufpool test: growth %s", AR_SUCCEEDED(result) ? "ok" : "FAILED");
+   return result;
+}
+
+/********************************************************************************/
+/* Gets and returns nodes at random, tagging every node so that a node handed to two owners is detected */
+static ar_result_t bufpool_test_worker(void *arg_ptr)
+{
+   bufpool_test_thread_ctx_t *ctx_ptr = (bufpool_test_thread_ctx_t *)arg_ptr;
+   uint32_t                   seed    = 0x9E3779B9 * (ctx_ptr->thread_idx + 1);
+   uint32_t *                 slots[BUFPOOL_TEST_SLOTS];
+   uint32_t                   tags[BUFPOOL_TEST_SLOTS];
+
+   memset(slots, 0, sizeof(slots));
+
+   for (uint32_t n = 0; n < BUFPOOL_TEST_NUM_ITERATIONS; n++)
+   {
+      uint32_t idx = bufpool_test_rand(&seed) % BUFPOOL_TEST_SLOTS;
+
+      if (NULL != slots[idx])
+      {
+         if ((slots[idx][0] != tags[idx]) || (slots[idx][3] != ~tags[idx]))
+         {
+            ctx_ptr->num_failures++;
+         }
+         posal_bufpool_return_node(slots[idx]);
+         slots[idx] = NULL;
+         continue;
+      }
+
+      if (NULL == (slots[idx] = (uint32_t *)posal_bufpool_get_node(ctx_ptr->pool_handle)))
+      {
+         ctx_ptr->num_failures++;
+         continue;
+      }
+      tags[idx]     = (ctx_ptr->thread_idx << 24) ^ n;
+      slots[idx][0] = tags[idx];
+      slots[idx][3] = ~tags[idx];
+   }
+
+   for (uint32_t i = 0; i < BUFPOOL_TEST_SLOTS; i++)
+   {
+      if (slots[i])
+      {
+         posal_bufpool_return_node(slots[i]);
+      }
+   }
+   return AR_EOK;
+}
+
+/* Threads hold at most a quarter of a pool between them, no get may fail and nothing may be left used */
+static ar_result_t bufpool_test_concurrent()
+{
+   ar_result_t               result        = AR_EOK;
+   ar_result_t               thread_result = AR_EOK;
+   uint32_t                  num_launched  = 0;
+   uint32_t                  bytes_used    = 0;
+   bufpool_test_thread_ctx_t ctx[BUFPOOL_TEST_NUM_THREADS];
+   posal_thread_t            tids[BUFPOOL_TEST_NUM_THREADS];
+
+   uint32_t pool_handle = posal_bufpool_pool_create(BUFPOOL_TEST_NODE_SIZE,
+                                                    POSAL_HEAP_DEFAULT,
+                                                    BUFPOOL_TEST_MAX_NODES / 32,
+                                                    FOUR_BYTE_ALIGN,
+                                                    32);
+   if (POSAL_BUFPOOL_INVALID_HANDLE == pool_handle)
+   {
+      return AR_EFAILED;
+   }
+
+   for (uint32_t t = 0; t < BUFPOOL_TEST_NUM_THREADS; t++)
+   {
+      memset(&ctx[t], 0, sizeof(ctx[t]));
+      ctx[t].pool_handle = pool_handle;
+      ctx[t].thread_idx  = t;
+      if (AR_FAILED(bufpool_test_launch(&tids[t], bufpool_test_worker, &ctx[t])))
+      {
+         result = AR_EFAILED;
+         break;
+      }
+      num_launched++;
+   }
+
+   // profile while the workers run, the result must stay within what they can hold
+   for (uint32_t i = 0; (i < 1000) && AR_SUCCEEDED(result); i++)
+   {
+      bytes_used = bufpool_test_bytes_used(pool_handle, NULL);
+      if (bytes_used > BUFPOOL_TEST_NUM_THREADS * BUFPOOL_TEST_SLOTS * BUFPOOL_TEST_NODE_SIZE)
+      {
+         AR_MSG(DBG_ERROR_PRIO, "Bufpool test: %lu bytes used while the workers run", bytes_used);
+         result = AR_EFAILED;
+      }
+      sched_yield();
+   }
+
+   for (uint32_t t = 0; t < num_launched; t++)
+   {
+      posal_thread_join(tids[t], &thread_result);
+      if (0 != ctx[t].num_failures)
+      {
+         AR_MSG(DBG_ERROR_PRIO, "Bufpool test: thread %lu saw %lu failures", t, ctx[t].num_failures);
+         result = AR_EFAILED;
+      }
+   }
+
+   // the workers flushed their magazines on exit
+   if (0 != (bytes_used = bufpool_test_bytes_used(pool_handle, NULL)))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "Bufpool test: %lu bytes used after the workers exited", bytes_used);
+      result = AR_EFAILED;
+   }
+   posal_bufpool_pool_destroy(pool_handle);
+
+   AR_MSG(DBG_HIGH_PRIO,
+          "Bufpool test: %lu threads, concurrency %s",
+          num_launched,
+          AR_SUCCEEDED(result) ? "ok" : "FAILED");
+   return result;
+}
+
+/********************************************************************************/
+ar_result_t posal_bufpool_test()
+{
+   ar_result_t result = AR_EOK;
+
+   // LPI_SNS and LPI_GENERAL sized pools, the helper exhausts them
+   result |= bufpool_test_capacity(4, 1, 4);
+   result |= bufpool_test_capacity(8, 4, 32);
+   // nodes cached by the helper must be taken back once the pool runs dry
+   result |= bufpool_test_capacity(32, 8, 40);
+   result |= bufpool_test_growth();
+   result |= bufpool_test_concurrent();
+
+   AR_MSG(DBG_HIGH_PRIO, "POSAL bufpool tests %s", AR_SUCCEEDED(result) ? "passed" : "FAILED");
+
+   return result;
+}
@@ -0,0 +1,18 @@
+#ifndef __POSAL_BUFPOOL_TEST_H__
+#define __POSAL_BUFPOOL_TEST_H__
+/***
+ * \file posal_bufpool_test.h
+ * \brief
+ *    Header file for the POSAL buffer pool tests.
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "posal.h"
+
+/* Runs the buffer pool capacity, accounting and multi-thread get/return tests, returns AR_EOK if all pass */
+ar_result_t posal_bufpool_test();
+
+#endif //__POSAL_BUFPOOL_TEST_H__
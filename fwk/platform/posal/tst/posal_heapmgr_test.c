@@ -0,0 +1,500 @@
+/***
+ * \file posal_heapmgr_test.c
+ * \brief
+ *    This file tests the Linux POSAL heap manager: block sizes of every size class and at the class boundaries,
+ *    borrowing from a larger class once a heap region is exhausted, destroy while blocks are outstanding, and
+ *    frees racing with the creation and destruction of other heaps.
+ *
+ *    Expected block sizes are derived from the class layout documented in posal_memory_i.h (16 byte classes up to
+ *    256 bytes, then four classes per power of two), and checked through the per heap curr_heap statistic.
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "posal_heapmgr_test.h"
+#include "posal_globalstate.h"
+#include <sched.h>
+
+#define HEAPMGR_TEST_HDR_SIZE (16)
+#define HEAPMGR_TEST_HEAP_SIZE (32 * 1024 * 1024)
+#define HEAPMGR_TEST_MAX_BLOCK (1024 * 1024)
+#define HEAPMGR_TEST_SMALL_HEAP_SIZE (8192)
+#define HEAPMGR_TEST_NUM_THREADS (4)
+#define HEAPMGR_TEST_NUM_ITERATIONS (200000)
+#define HEAPMGR_TEST_SLOTS (16)
+
+typedef struct heapmgr_test_thread_ctx_t
+{
+   POSAL_HEAP_ID heap_id;
+   uint32_t      thread_idx;
+   uint32_t      num_failures;
+} heapmgr_test_thread_ctx_t;
+
+static uint8_t heapmgr_test_region[HEAPMGR_TEST_SMALL_HEAP_SIZE] __attribute__((aligned(16)));
+
+/********************************************************************************/
+/* Block size, header included, that the heap manager uses for a request of bytes */
+static uint32_t heapmgr_test_class_size(uint32_t bytes)
+{
+   uint32_t block_size = ((bytes + 15) & ~15u) + HEAPMGR_TEST_HDR_SIZE;
+
+   if (block_size <= 256)
+   {
+      return block_size;
+   }
+   for (uint32_t exp = 8; exp < 31; exp++)
+   {
+      for (uint32_t k = 5; k <= 8; k++)
+      {
+         if ((k << (exp - 2)) >= block_size)
+         {
+            return k << (exp - 2);
+         }
+      }
+   }
+   return 0;
+}
+
+static inline uint32_t heapmgr_test_curr_heap(POSAL_HEAP_ID heap_id)
+{
+   return posal_globalstate.avs_stats[heap_id].curr_heap;
+}
+
+static inline uint32_t heapmgr_test_rand(uint32_t *seed_ptr)
+{
+   // xorshift32
+   *seed_ptr ^= *seed_ptr << 13;
+   *seed_ptr ^= *seed_ptr >> 17;
+   *seed_ptr ^= *seed_ptr << 5;
+   return *seed_ptr;
+}
+
+/********************************************************************************/
+/* Allocates one request size, checks alignment and accounting, and that a free and realloc reuses the block */
+static ar_result_t heapmgr_test_one_size(POSAL_HEAP_ID heap_id, uint32_t bytes)
+{
+   uint32_t expected = heapmgr_test_class_size(bytes);
+   uint32_t before   = heapmgr_test_curr_heap(heap_id);
+   uint8_t *ptr      = (uint8_t *)posal_memory_malloc(bytes, heap_id);
+
+   if (NULL == ptr)
+   {
+      AR_MSG(DBG_ERROR_PRIO, "Heapmgr test: alloc of %lu bytes failed", bytes);
+      return AR_EFAILED;
+   }
+
+   if ((0 != ((uintptr_t)ptr & 15)) || (expected != heapmgr_test_curr_heap(heap_id) - before))
+   {
+      AR_MSG(DBG_ERROR_PRIO,
+             "Heapmgr test: %lu bytes at 0x%p, block %lu bytes, expected %lu",
+             bytes,
+             ptr,
+             heapmgr_test_curr_heap(heap_id) - before,
+             expected);
+      posal_memory_free(ptr);
+      return AR_EFAILED;
+   }
+
+   // the whole usable size must be writable
+   memset(ptr, 0xA5, expected - HEAPMGR_TEST_HDR_SIZE);
+   posal_memory_free(ptr);
+
+   uint8_t *again_ptr = (uint8_t *)posal_memory_malloc(bytes, heap_id);
+   posal_memory_free(again_ptr);
+
+   if ((again_ptr != ptr) || (before != heapmgr_test_curr_heap(heap_id)))
+   {
+      AR_MSG(DBG_ERROR_PRIO,
+             "Heapmgr test: %lu bytes, freed block 0x%p not reused (got 0x%p) or usage %lu not restored to %lu",
+             bytes,
+             ptr,
+             again_ptr,
+             heapmgr_test_curr_heap(heap_id),
+             before);
+      return AR_EFAILED;
+   }
+   return AR_EOK;
+}
+
+/********************************************************************************/
+static ar_result_t heapmgr_test_size_classes()
+{
+   ar_result_t   result    = AR_EOK;
+   POSAL_HEAP_ID heap_id   = POSAL_HEAP_DEFAULT;
+   uint32_t      num_sizes = 0;
+   void *        ptrs[600] = { NULL };
+   uint32_t      sizes[600];
+
+   if (AR_FAILED(posal_memory_heapmgr_create(&heap_id, NULL, HEAPMGR_TEST_HEAP_SIZE, TRUE)))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "Heapmgr test: heap create failed");
+      return AR_EFAILED;
+   }
+
+   // every size of the linear classes and a little beyond
+   for (uint32_t bytes = 1; bytes <= 300; bytes++)
+   {
+      sizes[num_sizes++] = bytes;
+   }
+
+   // both sides of every class boundary of the geometric classes
+   for (uint32_t class_size = 320; class_size <= HEAPMGR_TEST_MAX_BLOCK;
+        class_size      = heapmgr_test_class_size(class_size))
+   {
+      sizes[num_sizes++] = class_size - HEAPMGR_TEST_HDR_SIZE;
+      sizes[num_sizes++] = class_size - HEAPMGR_TEST_HDR_SIZE + 1;
+   }
+
+   for (uint32_t i = 0; (i < num_sizes) && AR_SUCCEEDED(result); i++)
+   {
+      result = heapmgr_test_one_size(heap_id, sizes[i]);
+   }
+
+   // all sizes live at once must not overlap
+   uint32_t expected_usage = 0;
+   for (uint32_t i = 0; (i < num_sizes) && AR_SUCCEEDED(result); i++)
+   {
+      ptrs[i] = posal_memory_malloc(sizes[i], heap_id);
+      if (NULL == ptrs[i])
+      {
+         result = AR_EFAILED;
+         break;
+      }
+      memset(ptrs[i], (int)(i & 0xFF), sizes[i]);
+      expected_usage += heapmgr_test_class_size(sizes[i]);
+   }
+   if (AR_SUCCEEDED(result) && (expected_usage != heapmgr_test_curr_heap(heap_id)))
+   {
+      AR_MSG(DBG_ERROR_PRIO,
+             "Heapmgr test: usage %lu with all sizes live, expected %lu",
+             heapmgr_test_curr_heap(heap_id),
+             expected_usage);
+      result = AR_EFAILED;
+   }
+   for (uint32_t i = 0; (i < num_sizes) && AR_SUCCEEDED(result); i++)
+   {
+      for (uint32_t b = 0; b < sizes[i]; b++)
+      {
+         if (((uint8_t *)ptrs[i])[b] != (uint8_t)(i & 0xFF))
+         {
+            AR_MSG(DBG_ERROR_PRIO, "Heapmgr test: block of %lu bytes overwritten at byte %lu", sizes[i], b);
+            result = AR_EFAILED;
+            break;
+         }
+      }
+   }
+   for (uint32_t i = 0; i < num_sizes; i++)
+   {
+      posal_memory_free(ptrs[i]);
+      ptrs[i] = NULL;
+   }
+
+   if (AR_SUCCEEDED(result) && (0 != heapmgr_test_curr_heap(heap_id)))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "Heapmgr test: usage %lu after all frees", heapmgr_test_curr_heap(heap_id));
+      result = AR_EFAILED;
+   }
+
+   // memory of the default heap still goes to libc while an arena is live
+   void *libc_ptr = posal_memory_malloc(100, POSAL_HEAP_DEFAULT);
+   if (AR_SUCCEEDED(result) && ((NULL == libc_ptr) || (0 != heapmgr_test_curr_heap(heap_id))))
+   {
+      result = AR_EFAILED;
+   }
+   posal_memory_free(libc_ptr);
+
+   if (AR_FAILED(posal_memory_heapmgr_destroy(heap_id)))
+   {
+      result = AR_EFAILED;
+   }
+
+   AR_MSG(DBG_HIGH_PRIO, "Heapmgr test: %lu sizes, size classes %s", num_sizes, AR_SUCCEEDED(result) ? "ok" : "FAILED");
+   return result;
+}
+
+/********************************************************************************/
+/* Fills a caller supplied region, then checks that the freed block of a larger class is borrowed and keeps its
+   class */
+static ar_result_t heapmgr_test_exhaustion()
+{
+   ar_result_t   result     = AR_EOK;
+   POSAL_HEAP_ID heap_id    = POSAL_HEAP_DEFAULT;
+   uint32_t      big_bytes  = 2048 - HEAPMGR_TEST_HDR_SIZE;
+   uint32_t      num_small  = 0;
+   uint32_t      max_small  = (HEAPMGR_TEST_SMALL_HEAP_SIZE - 2048) / 64;
+   void *        small_ptrs[(HEAPMGR_TEST_SMALL_HEAP_SIZE - 2048) / 64];
+   void *        big_ptr;
+   void *        ptr;
+
+   if (AR_FAILED(posal_memory_heapmgr_create(&heap_id, heapmgr_test_region, sizeof(heapmgr_test_region), TRUE)))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "Heapmgr test: small heap create failed");
+      return AR_EFAILED;
+   }
+
+   big_ptr = posal_memory_malloc(big_bytes, heap_id);
+   posal_memory_free(big_ptr);
+
+   // 48 byte requests use 64 byte blocks and fill the rest of the region exactly
+   while (num_small < max_small)
+   {
+      if (NULL == (small_ptrs[num_small] = posal_memory_malloc(48, heap_id)))
+      {
+         break;
+      }
+      num_small++;
+   }
+
+   // the region is exhausted, the next small request borrows the free 2048 byte block
+   ptr = posal_memory_malloc(48, heap_id);
+   if ((NULL == big_ptr) || (max_small != num_small) || (ptr != big_ptr) ||
+       (HEAPMGR_TEST_SMALL_HEAP_SIZE != heapmgr_test_curr_heap(heap_id)))
+   {
+      AR_MSG(DBG_ERROR_PRIO,
+             "Heapmgr test: %lu of %lu small blocks, borrowed 0x%p instead of 0x%p, usage %lu",
+             num_small,
+             max_small,
+             ptr,
+             big_ptr,
+             heapmgr_test_curr_heap(heap_id));
+      result = AR_EFAILED;
+   }
+
+   // nothing left at all
+   void *none_ptr = posal_memory_malloc(16, heap_id);
+   if (NULL != none_ptr)
+   {
+      AR_MSG(DBG_ERROR_PRIO, "Heapmgr test: alloc from a full heap returned 0x%p", none_ptr);
+      posal_memory_free(none_ptr);
+      result = AR_EFAILED;
+   }
+
+   // the borrowed block goes back to its own class
+   posal_memory_free(ptr);
+   ptr = posal_memory_malloc(big_bytes, heap_id);
+   if (ptr != big_ptr)
+   {
+      AR_MSG(DBG_ERROR_PRIO, "Heapmgr test: borrowed block not returned to its class");
+      result = AR_EFAILED;
+   }
+   posal_memory_free(ptr);
+
+   for (uint32_t i = 0; i < num_small; i++)
+   {
+      posal_memory_free(small_ptrs[i]);
+   }
+
+   if (0 != heapmgr_test_curr_heap(heap_id))
+   {
+      result = AR_EFAILED;
+   }
+   if (AR_FAILED(posal_memory_heapmgr_destroy(heap_id)))
+   {
+      result = AR_EFAILED;
+   }
+
+   AR_MSG(DBG_HIGH_PRIO, "Heapmgr test: exhaustion and borrow %s", AR_SUCCEEDED(result) ? "ok" : "FAILED");
+   return result;
+}
+
+/********************************************************************************/
+static ar_result_t heapmgr_test_destroy()
+{
+   ar_result_t   result  = AR_EOK;
+   POSAL_HEAP_ID heap_id = POSAL_HEAP_DEFAULT;
+   uint8_t *     ptr;
+
+   if (AR_FAILED(posal_memory_heapmgr_create(&heap_id, NULL, 65536, TRUE)))
+   {
+      return AR_EFAILED;
+   }
+
+   ptr = (uint8_t *)posal_memory_malloc(1000, heap_id);
+   if ((NULL == ptr) || (AR_EBUSY != posal_memory_heapmgr_destroy(heap_id)))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "Heapmgr test: destroy with a live block did not fail with AR_EBUSY");
+      result = AR_EFAILED;
+   }
+
+   // the heap is intact, the block is still usable and goes back to the arena
+   memset(ptr, 0x5A, 1000);
+   posal_memory_free(ptr);
+   if (0 != heapmgr_test_curr_heap(heap_id))
+   {
+      result = AR_EFAILED;
+   }
+
+   if (AR_EOK != posal_memory_heapmgr_destroy(heap_id))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "Heapmgr test: destroy of an empty heap failed");
+      result = AR_EFAILED;
+   }
+   if (AR_EBADPARAM != posal_memory_heapmgr_destroy(heap_id))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "Heapmgr test: second destroy did not fail");
+      result = AR_EFAILED;
+   }
+
+   // the entry can be reused
+   if (AR_FAILED(posal_memory_heapmgr_create(&heap_id, NULL, 65536, TRUE)))
+   {
+      return AR_EFAILED;
+   }
+   if (AR_FAILED(heapmgr_test_one_size(heap_id, 1000)) || AR_FAILED(posal_memory_heapmgr_destroy(heap_id)))
+   {
+      result = AR_EFAILED;
+   }
+
+   AR_MSG(DBG_HIGH_PRIO, "Heapmgr test: destroy %s", AR_SUCCEEDED(result) ? "ok" : "FAILED");
+   return result;
+}
+
+/********************************************************************************/
+/* Allocates and frees random sizes from one heap and the default heap, tagging every block so that a block handed
+   to the wrong heap or to two owners is detected */
+static ar_result_t heapmgr_test_worker(void *arg_ptr)
+{
+   heapmgr_test_thread_ctx_t *ctx_ptr = (heapmgr_test_thread_ctx_t *)arg_ptr;
+   uint32_t                   seed    = 0x9E3779B9 * (ctx_ptr->thread_idx + 1);
+   uint32_t *                 slots[HEAPMGR_TEST_SLOTS];
+   uint32_t                   tags[HEAPMGR_TEST_SLOTS];
+
+   memset(slots, 0, sizeof(slots));
+
+   for (uint32_t n = 0; n < HEAPMGR_TEST_NUM_ITERATIONS; n++)
+   {
+      uint32_t r   = heapmgr_test_rand(&seed);
+      uint32_t idx = r % HEAPMGR_TEST_SLOTS;
+
+      if (NULL != slots[idx])
+      {
+         if (slots[idx][0] != tags[idx])
+         {
+            ctx_ptr->num_failures++;
+         }
+         posal_memory_free(slots[idx]);
+         slots[idx] = NULL;
+         continue;
+      }
+
+      uint32_t bytes = 4 + ((r >> 8) % 3000);
+      slots[idx]     = (uint32_t *)posal_memory_malloc(bytes, (r & 0x80000000) ? POSAL_HEAP_DEFAULT : ctx_ptr->heap_id);
+      if (NULL == slots[idx])
+      {
+         ctx_ptr->num_failures++;
+         continue;
+      }
+      tags[idx]     = (ctx_ptr->thread_idx << 24) ^ n;
+      slots[idx][0] = tags[idx];
+   }
+
+   for (uint32_t i = 0; i < HEAPMGR_TEST_SLOTS; i++)
+   {
+      posal_memory_free(slots[i]);
+   }
+   return AR_EOK;
+}
+
+/* Frees on worker threads look up the owning arena while this thread creates and destroys another heap */
+static ar_result_t heapmgr_test_concurrent()
+{
+   ar_result_t               result          = AR_EOK;
+   ar_result_t               thread_result   = AR_EOK;
+   POSAL_HEAP_ID             heap_id         = POSAL_HEAP_DEFAULT;
+   uint32_t                  num_cycles      = 0;
+   uint32_t                  num_launched    = 0;
+   uint32_t                  num_done        = 0;
+   heapmgr_test_thread_ctx_t ctx[HEAPMGR_TEST_NUM_THREADS];
+   posal_thread_t            tids[HEAPMGR_TEST_NUM_THREADS];
+
+   if (AR_FAILED(posal_memory_heapmgr_create(&heap_id, NULL, HEAPMGR_TEST_HEAP_SIZE, TRUE)))
+   {
+      return AR_EFAILED;
+   }
+
+   for (uint32_t t = 0; t < HEAPMGR_TEST_NUM_THREADS; t++)
+   {
+      ctx[t].heap_id      = heap_id;
+      ctx[t].thread_idx   = t;
+      ctx[t].num_failures = 0;
+      // time sliced rather than real time, so that workers and the churn below interleave even on one CPU
+      if (AR_FAILED(posal_thread_launch3(&tids[t],
+                                         "HEAP_TEST",
+                                         16 * 1024,
+                                         0,
+                                         0,
+                                         heapmgr_test_worker,
+                                         &ctx[t],
+                                         POSAL_HEAP_DEFAULT,
+                                         SCHED_OTHER,
+                                         0)))
+      {
+         result = AR_EFAILED;
+         break;
+      }
+      num_launched++;
+   }
+
+   // churn another heap until the workers are about done
+   for (uint32_t i = 0; (i < 20000) && AR_SUCCEEDED(result); i++)
+   {
+      POSAL_HEAP_ID churn_heap_id = POSAL_HEAP_DEFAULT;
+      if (AR_FAILED(posal_memory_heapmgr_create(&churn_heap_id, NULL, 65536, TRUE)))
+      {
+         result = AR_EFAILED;
+         break;
+      }
+      void *ptr = posal_memory_malloc(64 + (i % 4000), churn_heap_id);
+      posal_memory_free(ptr);
+      if ((NULL == ptr) || (AR_EOK != posal_memory_heapmgr_destroy(churn_heap_id)))
+      {
+         result = AR_EFAILED;
+      }
+      num_cycles++;
+   }
+
+   for (uint32_t t = 0; t < num_launched; t++)
+   {
+      posal_thread_join(tids[t], &thread_result);
+      if (0 != ctx[t].num_failures)
+      {
+         AR_MSG(DBG_ERROR_PRIO, "Heapmgr test: thread %lu saw %lu failures", t, ctx[t].num_failures);
+         result = AR_EFAILED;
+      }
+      num_done++;
+   }
+
+   if (0 != heapmgr_test_curr_heap(heap_id))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "Heapmgr test: usage %lu after concurrent run", heapmgr_test_curr_heap(heap_id));
+      result = AR_EFAILED;
+   }
+   if (AR_FAILED(posal_memory_heapmgr_destroy(heap_id)))
+   {
+      result = AR_EFAILED;
+   }
+
+   AR_MSG(DBG_HIGH_PRIO,
+          "Heapmgr test: %lu threads, %lu create/destroy cycles, concurrency %s",
+          num_done,
+          num_cycles,
+          AR_SUCCEEDED(result) ? "ok" : "FAILED");
+   return result;
+}
+
+/********************************************************************************/
+ar_result_t posal_heapmgr_test()
+{
+   ar_result_t result = AR_EOK;
+
+   result |= heapmgr_test_size_classes();
+   result |= heapmgr_test_exhaustion();
+   result |= heapmgr_test_destroy();
+   result |= heapmgr_test_concurrent();
+
+   AR_MSG(DBG_HIGH_PRIO, "POSAL heap manager tests %s", AR_SUCCEEDED(result) ? "passed" : "FAILED");
+
+   return result;
+}
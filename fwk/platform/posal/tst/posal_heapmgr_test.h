@@ -0,0 +1,18 @@
+#ifndef __POSAL_HEAPMGR_TEST_H__
+#define __POSAL_HEAPMGR_TEST_H__
+/***
+ * \file posal_heapmgr_test.h
+ * \brief
+ *    Header file for the Linux POSAL heap manager tests.
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "posal.h"
+
+/* Runs the heap manager size class, exhaustion, destroy and concurrency tests, returns AR_EOK if all pass */
+ar_result_t posal_heapmgr_test();
+
+#endif //__POSAL_HEAPMGR_TEST_H__
@@ -0,0 +1,247 @@
+/***
+ * \file posal_signal_test.c
+ * \brief
+ *    This file stress tests signal delivery between a producer pushing to an SPSC queue and a consumer waiting on
+ *    the queue's channel.
+ *
+ *    The consumer pops until the queue is empty, which clears the channel bit, while the producer pushes and sets
+ *    it. A wakeup lost in that window leaves an element in the queue with the bit cleared and the consumer asleep.
+ *    The producer detects this with a watchdog on the number of consumed elements, and wakes the consumer through a
+ *    separate signal so that the test can report the failure instead of hanging.
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "posal_signal_test.h"
+
+#define SIGNAL_TEST_NUM_ELEMENTS (200000)
+#define SIGNAL_TEST_MAX_NODES (16)
+/* producer pushes bursts of 1 to this many elements */
+#define SIGNAL_TEST_MAX_BURST (4)
+/* a consumer which has not made progress for this long has lost a wakeup */
+#define SIGNAL_TEST_WATCHDOG_US (1000000)
+
+#define SIGNAL_TEST_QUEUE_MASK (0x1)
+#define SIGNAL_TEST_KICK_MASK (0x2)
+
+/* queue nodes carry two pointer sized words, the test only uses the second for a sequence number */
+typedef struct signal_test_elem_t
+{
+   void     *payload_ptr;
+   uintptr_t seq;
+} signal_test_elem_t;
+
+typedef struct signal_test_ctx_t
+{
+   posal_channel_t channel_ptr;
+   posal_queue_t  *queue_ptr;
+   posal_signal_t  kick_signal_ptr;
+   uint32_t        num_consumed;
+   uint32_t        num_lost_wakeups;
+   uint32_t        num_out_of_order;
+   bool_t          stop;
+} signal_test_ctx_t;
+
+/********************************************************************************/
+/* Consumer: drains the queue on each wakeup, like a container's command loop. */
+static ar_result_t signal_test_consumer(void *arg_ptr)
+{
+   signal_test_ctx_t     *ctx_ptr  = (signal_test_ctx_t *)arg_ptr;
+   uint32_t               expected = 0;
+   signal_test_elem_t     elem;
+   posal_queue_element_t *peek_ptr = NULL;
+
+   while (expected < SIGNAL_TEST_NUM_ELEMENTS)
+   {
+      uint32_t mask = posal_channel_wait(ctx_ptr->channel_ptr, SIGNAL_TEST_QUEUE_MASK | SIGNAL_TEST_KICK_MASK);
+
+      if (mask & SIGNAL_TEST_KICK_MASK)
+      {
+         posal_signal_clear(ctx_ptr->kick_signal_ptr);
+
+         // woken by the watchdog while the queue holds data: the push did not wake us up
+         if (0 == (mask & SIGNAL_TEST_QUEUE_MASK) && AR_SUCCEEDED(posal_queue_peek_front(ctx_ptr->queue_ptr, &peek_ptr)))
+         {
+            __atomic_add_fetch(&ctx_ptr->num_lost_wakeups, 1, __ATOMIC_RELAXED);
+         }
+         if (__atomic_load_n(&ctx_ptr->stop, __ATOMIC_ACQUIRE))
+         {
+            break;
+         }
+      }
+
+      while (AR_SUCCEEDED(posal_queue_pop_front(ctx_ptr->queue_ptr, (posal_queue_element_t *)&elem)))
+      {
+         if (elem.seq != expected)
+         {
+            ctx_ptr->num_out_of_order++;
+         }
+         expected++;
+         __atomic_store_n(&ctx_ptr->num_consumed, expected, __ATOMIC_RELEASE);
+      }
+   }
+
+   return AR_EOK;
+}
+
+/********************************************************************************/
+/* Producer: pushes short bursts and mostly waits until they are consumed, so that the queue runs empty and the
+   channel bit is cleared and set again on nearly every element. */
+static ar_result_t signal_test_producer(signal_test_ctx_t *ctx_ptr)
+{
+   ar_result_t result    = AR_EOK;
+   uint32_t    num_sent  = 0;
+   uint32_t    rand_seed = 1;
+
+   while (AR_SUCCEEDED(result) && (num_sent < SIGNAL_TEST_NUM_ELEMENTS))
+   {
+      rand_seed      = rand_seed * 1103515245 + 12345;
+      uint32_t burst = 1 + ((rand_seed >> 16) % SIGNAL_TEST_MAX_BURST);
+
+      for (uint32_t i = 0; (i < burst) && (num_sent < SIGNAL_TEST_NUM_ELEMENTS); i++)
+      {
+         signal_test_elem_t elem = { .payload_ptr = NULL, .seq = num_sent };
+
+         if (AR_FAILED(posal_queue_push_back(ctx_ptr->queue_ptr, (posal_queue_element_t *)&elem)))
+         {
+            // full, let the consumer catch up
+            break;
+         }
+         num_sent++;
+      }
+
+      // every other burst is pushed without waiting so that pushes also race with the consumer's pops
+      if (rand_seed & 0x80000000)
+      {
+         continue;
+      }
+
+      uint64_t last_progress_us = posal_timer_get_time();
+      uint32_t last_consumed    = __atomic_load_n(&ctx_ptr->num_consumed, __ATOMIC_ACQUIRE);
+      while (last_consumed != num_sent)
+      {
+         uint32_t consumed = __atomic_load_n(&ctx_ptr->num_consumed, __ATOMIC_ACQUIRE);
+         uint64_t now_us   = posal_timer_get_time();
+
+         if (consumed != last_consumed)
+         {
+            last_consumed    = consumed;
+            last_progress_us = now_us;
+         }
+         else if (now_us - last_progress_us > SIGNAL_TEST_WATCHDOG_US)
+         {
+            AR_MSG(DBG_ERROR_PRIO,
+                   "Signal test: consumer stuck at %lu of %lu elements, lost wakeup",
+                   consumed,
+                   num_sent);
+            result = AR_EFAILED;
+            break;
+         }
+      }
+   }
+
+   __atomic_store_n(&ctx_ptr->stop, TRUE, __ATOMIC_RELEASE);
+   posal_signal_send(ctx_ptr->kick_signal_ptr);
+
+   return result;
+}
+
+/********************************************************************************/
+static ar_result_t signal_test_spsc_wakeup()
+{
+   ar_result_t             result = AR_EOK;
+   ar_result_t             thread_result;
+   signal_test_ctx_t       ctx;
+   posal_thread_t          consumer_tid;
+   posal_queue_init_attr_t q_attr;
+
+   memset(&ctx, 0, sizeof(ctx));
+
+   posal_queue_attr_init(&q_attr);
+   posal_queue_attr_set_name(&q_attr, "SIG_TEST");
+   posal_queue_attr_set_max_nodes(&q_attr, SIGNAL_TEST_MAX_NODES);
+   posal_queue_attr_set_prealloc_nodes(&q_attr, SIGNAL_TEST_MAX_NODES);
+   posal_queue_attr_set_spsc_mode(&q_attr, TRUE);
+
+   if (AR_SUCCEEDED(result))
+   {
+      result = posal_channel_create(&ctx.channel_ptr, POSAL_HEAP_DEFAULT);
+   }
+   if (AR_SUCCEEDED(result))
+   {
+      result = posal_queue_create_v1(&ctx.queue_ptr, &q_attr);
+   }
+   if (AR_SUCCEEDED(result))
+   {
+      result = posal_channel_addq(ctx.channel_ptr, ctx.queue_ptr, SIGNAL_TEST_QUEUE_MASK);
+   }
+   if (AR_SUCCEEDED(result))
+   {
+      result = posal_signal_create(&ctx.kick_signal_ptr, POSAL_HEAP_DEFAULT);
+   }
+   if (AR_SUCCEEDED(result))
+   {
+      result = posal_channel_add_signal(ctx.channel_ptr, ctx.kick_signal_ptr, SIGNAL_TEST_KICK_MASK);
+   }
+   if (AR_SUCCEEDED(result))
+   {
+      result = posal_thread_launch(&consumer_tid,
+                                   "SIG_TEST_CONS",
+                                   16 * 1024,
+                                   50,
+                                   signal_test_consumer,
+                                   &ctx,
+                                   POSAL_HEAP_DEFAULT);
+   }
+   if (AR_FAILED(result))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "Signal test: setup failed 0x%lx", result);
+   }
+   else
+   {
+      result = signal_test_producer(&ctx);
+
+      posal_thread_join(consumer_tid, &thread_result);
+
+      AR_MSG(DBG_HIGH_PRIO,
+             "Signal test: %lu of %lu elements consumed, lost wakeups %lu, out of order %lu",
+             ctx.num_consumed,
+             SIGNAL_TEST_NUM_ELEMENTS,
+             ctx.num_lost_wakeups,
+             ctx.num_out_of_order);
+
+      if ((SIGNAL_TEST_NUM_ELEMENTS != ctx.num_consumed) || (0 != ctx.num_lost_wakeups) ||
+          (0 != ctx.num_out_of_order))
+      {
+         result = AR_EFAILED;
+      }
+   }
+
+   if (ctx.kick_signal_ptr)
+   {
+      posal_signal_destroy(&ctx.kick_signal_ptr);
+   }
+   if (ctx.queue_ptr)
+   {
+      posal_queue_destroy(ctx.queue_ptr);
+   }
+   if (ctx.channel_ptr)
+   {
+      posal_channel_destroy(&ctx.channel_ptr);
+   }
+   return result;
+}
+
+/********************************************************************************/
+ar_result_t posal_signal_test()
+{
+   ar_result_t result = AR_EOK;
+
+   result |= signal_test_spsc_wakeup();
+
+   AR_MSG(DBG_HIGH_PRIO, "POSAL signal tests %s", AR_SUCCEEDED(result) ? "passed" : "FAILED");
+
+   return result;
+}
@@ -0,0 +1,18 @@
+#ifndef __POSAL_SIGNAL_TEST_H__
+#define __POSAL_SIGNAL_TEST_H__
+/***
+ * \file posal_signal_test.h
+ * \brief
+ *    Header file for the POSAL signal and SPSC queue wakeup tests.
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "posal.h"
+
+/* Runs the producer/consumer wakeup stress tests, returns AR_EOK if no wakeup is lost */
+ar_result_t posal_signal_test();
+
+#endif //__POSAL_SIGNAL_TEST_H__
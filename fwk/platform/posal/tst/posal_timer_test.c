@@ -0,0 +1,244 @@
+/***
+ * \file posal_timer_test.c
+ * \brief
+ *    This file tests POSAL timers: expiry time and jitter of periodic timers, one shot timers and stop.
+ *
+ *    Limits are loose enough for a loaded host without real time priority. The measured jitter is printed so that
+ *    it can be compared across changes.
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "posal_timer_test.h"
+
+#define TIMER_TEST_PERIOD_US (1000)
+#define TIMER_TEST_NUM_PERIODS (2000)
+#define TIMER_TEST_NUM_TIMERS (4)
+#define TIMER_TEST_ONESHOT_US (5000)
+
+/* an expiry may not be earlier than due, nor later than this */
+#define TIMER_TEST_MAX_LATE_US (5000)
+/* average period must be within this of the configured period */
+#define TIMER_TEST_MAX_PERIOD_ERR_US (20)
+
+#define TIMER_TEST_SIGNAL_MASK(i) (1 << (i))
+
+typedef struct timer_test_ctx_t
+{
+   posal_channel_t channel_ptr;
+   posal_signal_t  signal_ptr[TIMER_TEST_NUM_TIMERS];
+   posal_timer_t   timer_ptr[TIMER_TEST_NUM_TIMERS];
+} timer_test_ctx_t;
+
+static void timer_test_destroy(timer_test_ctx_t *ctx_ptr)
+{
+   for (uint32_t i = 0; i < TIMER_TEST_NUM_TIMERS; i++)
+   {
+      if (ctx_ptr->timer_ptr[i])
+      {
+         posal_timer_destroy(&ctx_ptr->timer_ptr[i]);
+      }
+      if (ctx_ptr->signal_ptr[i])
+      {
+         posal_signal_destroy(&ctx_ptr->signal_ptr[i]);
+      }
+   }
+   if (ctx_ptr->channel_ptr)
+   {
+      posal_channel_destroy(&ctx_ptr->channel_ptr);
+   }
+}
+
+static ar_result_t timer_test_create(timer_test_ctx_t *ctx_ptr, posal_timer_duration_t type)
+{
+   ar_result_t result = AR_EOK;
+
+   memset(ctx_ptr, 0, sizeof(*ctx_ptr));
+   result = posal_channel_create(&ctx_ptr->channel_ptr, POSAL_HEAP_DEFAULT);
+
+   for (uint32_t i = 0; (i < TIMER_TEST_NUM_TIMERS) && AR_SUCCEEDED(result); i++)
+   {
+      result = posal_signal_create(&ctx_ptr->signal_ptr[i], POSAL_HEAP_DEFAULT);
+      if (AR_SUCCEEDED(result))
+      {
+         result = posal_channel_add_signal(ctx_ptr->channel_ptr, ctx_ptr->signal_ptr[i], TIMER_TEST_SIGNAL_MASK(i));
+      }
+      if (AR_SUCCEEDED(result) &&
+          (0 != posal_timer_create(&ctx_ptr->timer_ptr[i],
+                                   type,
+                                   POSAL_TIMER_USER,
+                                   ctx_ptr->signal_ptr[i],
+                                   POSAL_HEAP_DEFAULT)))
+      {
+         result = AR_EFAILED;
+      }
+   }
+
+   if (AR_FAILED(result))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "Timer test: creating timers failed");
+      timer_test_destroy(ctx_ptr);
+   }
+   return result;
+}
+
+/********************************************************************************/
+/* Periodic timers with different phases run together. Every expiry is on or after its due time, and the periods
+   average to the configured one, i.e. no period is dropped or added. */
+static ar_result_t timer_test_periodic_jitter()
+{
+   ar_result_t      result = AR_EOK;
+   timer_test_ctx_t ctx;
+   uint64_t         start_time[TIMER_TEST_NUM_TIMERS];
+   uint32_t         num_expiries[TIMER_TEST_NUM_TIMERS] = { 0 };
+   uint64_t         max_late_us                         = 0;
+   uint64_t         sum_late_us                         = 0;
+   uint64_t         last_time_us                        = 0;
+   uint32_t         all_mask                            = 0;
+
+   if (AR_FAILED(result = timer_test_create(&ctx, POSAL_TIMER_PERIODIC)))
+   {
+      return result;
+   }
+
+   for (uint32_t i = 0; i < TIMER_TEST_NUM_TIMERS; i++)
+   {
+      uint64_t offset_us = (i * TIMER_TEST_PERIOD_US) / TIMER_TEST_NUM_TIMERS;
+
+      start_time[i] = posal_timer_get_time() + offset_us;
+      posal_timer_periodic_start_with_offset(ctx.timer_ptr[i], TIMER_TEST_PERIOD_US, offset_us);
+      all_mask |= TIMER_TEST_SIGNAL_MASK(i);
+   }
+
+   while (AR_SUCCEEDED(result) && (num_expiries[TIMER_TEST_NUM_TIMERS - 1] < TIMER_TEST_NUM_PERIODS))
+   {
+      uint32_t mask = posal_channel_wait(ctx.channel_ptr, all_mask);
+      uint64_t now  = posal_timer_get_time();
+
+      for (uint32_t i = 0; i < TIMER_TEST_NUM_TIMERS; i++)
+      {
+         if (!(mask & TIMER_TEST_SIGNAL_MASK(i)))
+         {
+            continue;
+         }
+         posal_signal_clear(ctx.signal_ptr[i]);
+         num_expiries[i]++;
+
+         // due time of the latest expiry, first one is due at the start time. Missed periods are dropped by the timer.
+         uint64_t due_us = start_time[i] + (uint64_t)(num_expiries[i] - 1) * TIMER_TEST_PERIOD_US;
+         while (due_us + TIMER_TEST_PERIOD_US <= now)
+         {
+            due_us += TIMER_TEST_PERIOD_US;
+            num_expiries[i]++;
+         }
+         if (now + 1 < due_us)
+         {
+            AR_MSG(DBG_ERROR_PRIO, "Timer test: timer %lu expired %lu us early", i, (uint32_t)(due_us - now));
+            result = AR_EFAILED;
+            break;
+         }
+         max_late_us = MAX(max_late_us, now - due_us);
+         sum_late_us += now - due_us;
+      }
+      last_time_us = now;
+   }
+
+   uint32_t total_expiries = 0;
+   for (uint32_t i = 0; i < TIMER_TEST_NUM_TIMERS; i++)
+   {
+      posal_timer_stop(ctx.timer_ptr[i]);
+      total_expiries += num_expiries[i];
+   }
+
+   // periods of the last timer over the elapsed time, phase offset excluded
+   uint64_t elapsed_us = last_time_us - start_time[TIMER_TEST_NUM_TIMERS - 1];
+   uint64_t period_us  = elapsed_us / MAX(num_expiries[TIMER_TEST_NUM_TIMERS - 1] - 1, 1);
+
+   AR_MSG(DBG_HIGH_PRIO,
+          "Timer test: %lu expiries, average period %lu us, lateness average %lu us max %lu us",
+          total_expiries,
+          (uint32_t)period_us,
+          (uint32_t)(sum_late_us / MAX(total_expiries, 1)),
+          (uint32_t)max_late_us);
+
+   if (AR_SUCCEEDED(result) &&
+       ((max_late_us > TIMER_TEST_MAX_LATE_US) ||
+        (period_us + TIMER_TEST_MAX_PERIOD_ERR_US < TIMER_TEST_PERIOD_US) ||
+        (period_us > TIMER_TEST_PERIOD_US + TIMER_TEST_MAX_PERIOD_ERR_US)))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "Timer test: periodic jitter out of limits");
+      result = AR_EFAILED;
+   }
+
+   timer_test_destroy(&ctx);
+   return result;
+}
+
+/********************************************************************************/
+/* One shot timers expire once, not early, and a stopped timer does not expire. */
+static ar_result_t timer_test_oneshot()
+{
+   ar_result_t      result = AR_EOK;
+   timer_test_ctx_t ctx;
+
+   if (AR_FAILED(result = timer_test_create(&ctx, POSAL_TIMER_ONESHOT_DURATION)))
+   {
+      return result;
+   }
+
+   uint64_t start_us = posal_timer_get_time();
+   posal_timer_oneshot_start_duration(ctx.timer_ptr[0], TIMER_TEST_ONESHOT_US);
+   posal_timer_oneshot_start_duration(ctx.timer_ptr[1], TIMER_TEST_ONESHOT_US / 2);
+   posal_timer_oneshot_start_duration(ctx.timer_ptr[2], TIMER_TEST_ONESHOT_US / 2);
+   posal_timer_stop(ctx.timer_ptr[2]);
+
+   uint32_t expected_mask = TIMER_TEST_SIGNAL_MASK(0) | TIMER_TEST_SIGNAL_MASK(1);
+   uint32_t fired_mask    = 0;
+   while (fired_mask != expected_mask)
+   {
+      uint32_t mask = posal_channel_wait(ctx.channel_ptr, expected_mask & ~fired_mask);
+      uint64_t now  = posal_timer_get_time();
+      uint64_t due  = start_us + ((mask & TIMER_TEST_SIGNAL_MASK(0)) ? TIMER_TEST_ONESHOT_US : TIMER_TEST_ONESHOT_US / 2);
+
+      if ((now + 1 < due) || (now > due + TIMER_TEST_MAX_LATE_US))
+      {
+         AR_MSG(DBG_ERROR_PRIO, "Timer test: one shot mask 0x%lx expired at %lu us", mask, (uint32_t)(now - start_us));
+         result = AR_EFAILED;
+      }
+      fired_mask |= mask;
+      for (uint32_t i = 0; i < TIMER_TEST_NUM_TIMERS; i++)
+      {
+         if (mask & TIMER_TEST_SIGNAL_MASK(i))
+         {
+            posal_signal_clear(ctx.signal_ptr[i]);
+         }
+      }
+   }
+
+   // one shot timers must not fire again, stopped timer must not fire at all
+   posal_timer_sleep(2 * TIMER_TEST_ONESHOT_US);
+   uint32_t late_mask = posal_channel_poll(ctx.channel_ptr, 0xFFFFFFFF);
+   if (late_mask)
+   {
+      AR_MSG(DBG_ERROR_PRIO, "Timer test: unexpected expiry, mask 0x%lx", late_mask);
+      result = AR_EFAILED;
+   }
+
+   timer_test_destroy(&ctx);
+   return result;
+}
+
+/********************************************************************************/
+ar_result_t posal_timer_test()
+{
+   ar_result_t result = AR_EOK;
+
+   result |= timer_test_oneshot();
+   result |= timer_test_periodic_jitter();
+
+   AR_MSG(DBG_HIGH_PRIO, "POSAL timer tests %s", AR_SUCCEEDED(result) ? "passed" : "FAILED");
+
+   return result;
+}
@@ -0,0 +1,18 @@
+#ifndef __POSAL_TIMER_TEST_H__
+#define __POSAL_TIMER_TEST_H__
+/***
+ * \file posal_timer_test.h
+ * \brief
+ *    Header file for the POSAL timer tests.
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "posal.h"
+
+/* Runs the timer expiry and jitter tests, returns AR_EOK if all of them pass */
+ar_result_t posal_timer_test();
+
+#endif //__POSAL_TIMER_TEST_H__
@@ -122,6 +122,55 @@ ar_result_t apm_compute_cntr_msg_payload_size(uint32_t param_id , uint32_t *cntr
       return result;
 }
 
+static ar_result_t apm_get_spf_bufmgr_stats(apm_module_param_data_t *mod_data_ptr)
+{
+   ar_result_t                      result = AR_EOK;
+   spf_bufmgr_stats_t               bufmgr_stats;
+   apm_param_id_spf_bufmgr_stats_t *pid_payload_ptr;
+   apm_spf_bufmgr_class_stats_t *   class_stats_ptr;
+   uint32_t                         req_param_size;
+
+   req_param_size = sizeof(apm_param_id_spf_bufmgr_stats_t) +
+                    (SPF_BUFMGR_NUM_SIZE_CLASSES * sizeof(apm_spf_bufmgr_class_stats_t));
+
+   if (mod_data_ptr->param_size < req_param_size)
+   {
+      AR_MSG(DBG_ERROR_PRIO,
+             "APM_PARAM_ID_SPF_BUFMGR_STATS: Insufficient payload size[%lu], expected size[%lu]",
+             mod_data_ptr->param_size,
+             req_param_size);
+
+      return AR_ENEEDMORE;
+   }
+
+   if (AR_EOK != (result = spf_bufmgr_get_stats(&bufmgr_stats)))
+   {
+      return result;
+   }
+
+   pid_payload_ptr                   = (apm_param_id_spf_bufmgr_stats_t *)(mod_data_ptr + 1);
+   pid_payload_ptr->num_heap_allocs  = bufmgr_stats.num_heap_allocs;
+   pid_payload_ptr->grown_bytes      = bufmgr_stats.grown_bytes;
+   pid_payload_ptr->num_size_classes = SPF_BUFMGR_NUM_SIZE_CLASSES;
+
+   class_stats_ptr = (apm_spf_bufmgr_class_stats_t *)(pid_payload_ptr + 1);
+   for (uint32_t idx = 0; idx < SPF_BUFMGR_NUM_SIZE_CLASSES; idx++)
+   {
+      class_stats_ptr[idx].buf_size     = bufmgr_stats.class_stats[idx].buf_size;
+      class_stats_ptr[idx].num_prealloc = bufmgr_stats.class_stats[idx].num_prealloc;
+      class_stats_ptr[idx].num_bufs     = bufmgr_stats.class_stats[idx].num_bufs;
+      class_stats_ptr[idx].num_in_use   = bufmgr_stats.class_stats[idx].num_in_use;
+      class_stats_ptr[idx].max_in_use   = bufmgr_stats.class_stats[idx].max_in_use;
+      class_stats_ptr[idx].num_grown    = bufmgr_stats.class_stats[idx].num_grown;
+      class_stats_ptr[idx].num_shrunk   = bufmgr_stats.class_stats[idx].num_shrunk;
+      class_stats_ptr[idx].num_borrowed = bufmgr_stats.class_stats[idx].num_borrowed;
+   }
+
+   mod_data_ptr->param_size = req_param_size;
+
+   return result;
+}
+
 ar_result_t apm_parse_fwk_get_cfg_params(apm_t *apm_info_ptr, apm_module_param_data_t *mod_data_ptr)
 {
    ar_result_t      result = AR_EOK;
@@ -154,6 +203,12 @@ ar_result_t apm_parse_fwk_get_cfg_params(apm_t *apm_info_ptr, apm_module_param_d
 
          break;
       }
+      case APM_PARAM_ID_SPF_BUFMGR_STATS:
+      {
+         result = apm_get_spf_bufmgr_stats(mod_data_ptr);
+
+         break;
+      }
       default:
       {
          AR_MSG(DBG_ERROR_PRIO,
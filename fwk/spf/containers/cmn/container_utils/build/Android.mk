@@ -73,6 +73,9 @@ LOCAL_SRC_FILES := \
 
 LOCAL_CFLAGS += -flto -O3 -Wall -ffixed-x18 -std=c17
 
+# spf_thread_pool is built with libspf_utils, parallel paths property is supported
+LOCAL_CFLAGS += -DUSES_SPF_THREAD_POOL
+
 LOCAL_CFLAGS_32 += -mfpu=neon -fasm -ftree-vectorize -O3
 LOCAL_CFLAGS_64 += -fasm -ftree-vectorize -O3 -march=armv8-a+crypto
 
@@ -256,6 +256,7 @@ typedef struct cu_base_t
    int32_t                configured_thread_prio;  /**< Thread priority configured by the client */
    uint32_t               configured_sched_policy; /**< scheduling policy. Mainly for Linux */
    uint32_t               configured_core_affinity;/**< CPU Core affinity policy. Mainly for Linux */
+   uint32_t               configured_num_path_workers; /**< Worker threads for processing parallel paths concurrently */
    posal_channel_t        channel_ptr;
    posal_channel_t        gp_channel_ptr;           /**< General purpose channel */
    posal_signal_t         gp_signal_ptr;            /**< General purpose signal */
@@ -832,6 +832,33 @@ ar_result_t cu_parse_container_cfg(cu_base_t *me_ptr, apm_container_cfg_t *conta
 
             break;
          }
+         case APM_CONTAINER_PROP_ID_PARALLEL_PATHS:
+         {
+            VERIFY(result, cntr_prop_ptr->prop_size >= sizeof(apm_cont_prop_id_parallel_paths_t));
+
+            apm_cont_prop_id_parallel_paths_t *pp_cfg_ptr = (apm_cont_prop_id_parallel_paths_t *)(cntr_prop_ptr + 1);
+
+#ifndef USES_SPF_THREAD_POOL
+            // paths can't be processed concurrently without the thread pool, don't ignore the config silently.
+            if (APM_CONT_PARALLEL_PATHS_DISABLED != pp_cfg_ptr->num_worker_threads)
+            {
+               CU_MSG(me_ptr->gu_ptr->log_id,
+                      DBG_ERROR_PRIO,
+                      "Parallel path worker threads %lu configured, but thread pool is not supported",
+                      pp_cfg_ptr->num_worker_threads);
+               THROW(result, AR_EUNSUPPORTED);
+            }
+#endif
+
+            me_ptr->configured_num_path_workers = pp_cfg_ptr->num_worker_threads;
+
+            CU_MSG(me_ptr->gu_ptr->log_id,
+                   DBG_MED_PRIO,
+                   "Configured number of parallel path worker threads %lu",
+                   me_ptr->configured_num_path_workers);
+
+            break;
+         }
          default:
          {
             CU_MSG(me_ptr->gu_ptr->log_id,
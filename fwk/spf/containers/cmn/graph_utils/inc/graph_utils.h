@@ -15,6 +15,7 @@
  */
 
 #include "spf_utils.h"
+#include "spf_hashtable.h"
 #include "apm_sub_graph_api.h"
 #include "ar_ids.h"
 #include "gpr_api_inline.h"
@@ -352,6 +353,8 @@ typedef struct gu_module_t
    gu_sg_t *   sg_ptr; /**< every module belongs to a subgraph. not port */
 
    gu_output_port_t *host_output_port_ptr; /** NULL if no attached(elementary) module - points to host module's output port. */
+
+   spf_hash_node_t module_ht_node; /**< node in gu_t::module_ht, keyed by module_instance_id. */
 } gu_module_t;
 
 
@@ -423,6 +426,9 @@ typedef struct gu_t
    posal_mutex_t            prof_mutex;             /**< Mutex used to access profiling shared resources */
    uint32_t container_instance_id;                   /**< instance id of container */
 
+   spf_hashtable_t   module_ht;     /**< index of all the modules in sg_list_ptr by module instance id. table_ptr is NULL
+                                             until the first module is added. */
+
    gu_async_graph_t *async_gu_ptr; /**< graph info which is kept hidden from the main gu while data path is running in parallel. This is used in open and close context. Don't use this directly from container and topo layer. */
 
    int32_t          data_path_thread_id; /**< main thread id in which data-path processing is active */
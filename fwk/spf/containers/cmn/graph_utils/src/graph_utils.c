@@ -31,6 +31,13 @@
 
 #define GU_MSG(ID, xx_ss_mask, xx_fmt, ...) AR_MSG(xx_ss_mask, GU_MSG_PREFIX xx_fmt, ID, ##__VA_ARGS__)
 
+/** initial number of buckets in the module index, hashtable grows by the resize factor as modules get added. */
+#define GU_MODULE_HT_INIT_SIZE 16
+#define GU_MODULE_HT_RESIZE_FACTOR 2
+
+#define GU_MODULE_FROM_HT_NODE(node_ptr)                                                                               \
+   ((gu_module_t *)(((int8_t *)(node_ptr)) - offsetof(gu_module_t, module_ht_node)))
+
 //#define DEBUG_GRAPH_SORT
 //#define DEBUG_MODE_LOG
 
@@ -68,6 +75,60 @@ static void gu_set_status(gu_status_t *status_to_update, gu_status_t status_valu
    *status_to_update = status_value;
 }
 
+static void gu_module_ht_insert_node(gu_t *gu_ptr, gu_module_t *module_ptr)
+{
+   module_ptr->module_ht_node.key_ptr  = &module_ptr->module_instance_id;
+   module_ptr->module_ht_node.key_size = sizeof(module_ptr->module_instance_id);
+
+   (void)spf_hashtable_insert(&gu_ptr->module_ht, &module_ptr->module_ht_node);
+}
+
+// adds the module to the module index of the given gu. index is created when the first module is added, any module
+// already present in the sg list is indexed at that point. if the index can't be created, gu_find_module falls back
+// to the list search.
+static void gu_module_ht_add(gu_t *gu_ptr, gu_module_t *module_ptr, POSAL_HEAP_ID heap_id)
+{
+   if (!gu_ptr->module_ht.table_ptr)
+   {
+      if (AR_EOK != spf_hashtable_init(&gu_ptr->module_ht,
+                                       heap_id,
+                                       GU_MODULE_HT_INIT_SIZE,
+                                       GU_MODULE_HT_RESIZE_FACTOR,
+                                       NULL /* free_fptr, nodes are part of the module */,
+                                       NULL))
+      {
+         GU_MSG(gu_ptr->log_id, DBG_ERROR_PRIO, "Failed to create module index, using list search");
+         spf_hashtable_deinit(&gu_ptr->module_ht);
+         return;
+      }
+
+      for (gu_sg_list_t *sg_list_ptr = gu_ptr->sg_list_ptr; sg_list_ptr; LIST_ADVANCE(sg_list_ptr))
+      {
+         for (gu_module_list_t *module_list_ptr = sg_list_ptr->sg_ptr->module_list_ptr; module_list_ptr;
+              LIST_ADVANCE(module_list_ptr))
+         {
+            if (module_list_ptr->module_ptr != module_ptr)
+            {
+               gu_module_ht_insert_node(gu_ptr, module_list_ptr->module_ptr);
+            }
+         }
+      }
+   }
+
+   gu_module_ht_insert_node(gu_ptr, module_ptr);
+}
+
+static void gu_module_ht_remove(gu_t *gu_ptr, gu_module_t *module_ptr)
+{
+   if (gu_ptr->module_ht.table_ptr)
+   {
+      (void)spf_hashtable_remove(&gu_ptr->module_ht,
+                                 &module_ptr->module_instance_id,
+                                 sizeof(module_ptr->module_instance_id),
+                                 &module_ptr->module_ht_node);
+   }
+}
+
 static gu_cmn_port_t *gu_find_port_by_id(spf_list_node_t *list_ptr, uint32_t id)
 {
    while (list_ptr)
@@ -2685,6 +2746,13 @@ gu_ext_ctrl_port_t *gu_get_ext_ctrl_port_for_inter_proc_imcl(gu_t *   gu_ptr,
 
 gu_module_t *gu_find_module(gu_t *gu_ptr, uint32_t module_instance_id)
 {
+   if (gu_ptr->module_ht.table_ptr)
+   {
+      spf_hash_node_t *node_ptr =
+         spf_hashtable_find(&gu_ptr->module_ht, &module_instance_id, sizeof(module_instance_id));
+      return node_ptr ? GU_MODULE_FROM_HT_NODE(node_ptr) : NULL;
+   }
+
    gu_sg_list_t *sg_list_ptr = gu_ptr->sg_list_ptr;
    while (sg_list_ptr)
    {
@@ -3213,6 +3281,7 @@ ar_result_t gu_destroy_graph(gu_t *gu_ptr, bool_t b_destroy_everything)
 
             // remove the module from the SG list
             sg_ptr->num_modules--;
+            gu_module_ht_remove(gu_ptr, module_ptr);
             spf_list_delete_node(((spf_list_node_t **)&module_list_ptr), TRUE /* pool_used */);
 
             // remove the closing modules from the sorted module list
@@ -3314,6 +3383,11 @@ ar_result_t gu_destroy_graph(gu_t *gu_ptr, bool_t b_destroy_everything)
 
    gu_cleanup_danling_control_ports(gu_ptr);
 
+   if (0 == gu_ptr->num_subgraphs)
+   {
+      spf_hashtable_deinit(&gu_ptr->module_ht);
+   }
+
    // don't need to sort modules, modules which are closed are removed from the list already.
    // gu_print_graph(gu_ptr);
 
@@ -3569,6 +3643,8 @@ ar_result_t gu_create_graph(gu_t *                    gu_ptr,
          module_ptr->module_id          = cmd_module_ptr->module_id;
          module_ptr->module_heap_id     = heap_id;
 
+         gu_module_ht_add(open_gu_ptr, module_ptr, heap_id);
+
          module_ptr->min_input_ports  = (uint8_t)CAPI_INVALID_VAL;
          module_ptr->min_output_ports = (uint8_t)CAPI_INVALID_VAL;
 
@@ -4211,6 +4287,9 @@ ar_result_t gu_prepare_async_destroy(gu_t *gu_ptr, POSAL_HEAP_ID heap_id)
             for (gu_module_list_t *module_list_ptr = sg_list_ptr->sg_ptr->module_list_ptr; NULL != module_list_ptr;
                  LIST_ADVANCE(module_list_ptr))
             {
+               // closing modules are searched through the list of the async gu.
+               gu_module_ht_remove(gu_ptr, module_list_ptr->module_ptr);
+
                // remove the closing modules from the sorted module list
                if (gu_ptr->sorted_module_list_ptr)
                {
@@ -4317,6 +4396,17 @@ ar_result_t gu_finish_async_create(gu_t *gu_ptr, POSAL_HEAP_ID heap_id)
    // if new internal links or SG are opened then need to sort the module list
    b_sorting_needed = (gu_ptr->async_gu_ptr->port_list_ptr || (src_gu_ptr->num_subgraphs)) ? TRUE : FALSE;
 
+   // move the new modules to the module index of the primary gu
+   for (gu_sg_list_t *sg_list_ptr = src_gu_ptr->sg_list_ptr; sg_list_ptr; LIST_ADVANCE(sg_list_ptr))
+   {
+      for (gu_module_list_t *module_list_ptr = sg_list_ptr->sg_ptr->module_list_ptr; module_list_ptr;
+           LIST_ADVANCE(module_list_ptr))
+      {
+         gu_module_ht_add(gu_ptr, module_list_ptr->module_ptr, heap_id);
+      }
+   }
+   spf_hashtable_deinit(&src_gu_ptr->module_ht);
+
    gu_ptr->num_subgraphs += src_gu_ptr->num_subgraphs;
    spf_list_merge_lists(((spf_list_node_t **)&(gu_ptr->sg_list_ptr)), ((spf_list_node_t **)&(src_gu_ptr->sg_list_ptr)));
 
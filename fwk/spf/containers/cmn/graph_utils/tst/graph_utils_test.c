@@ -0,0 +1,82 @@
+/***
+ * \file graph_utils_test.c
+ * \brief
+ *    This file tests the module index of the graph utils (gu_t::module_ht).
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "graph_utils_test.h"
+
+#define GU_TEST_NUM_MODULES (5)
+#define GU_TEST_MIID_BASE (0x4000)
+
+/********************************************************************************/
+static ar_result_t gu_test_index_modules(gu_t *gu_ptr, gu_module_t *modules_ptr)
+{
+   ar_result_t result = spf_hashtable_init(&gu_ptr->module_ht, POSAL_HEAP_DEFAULT, 8, 2, NULL, NULL);
+
+   for (uint32_t i = 0; (i < GU_TEST_NUM_MODULES) && AR_SUCCEEDED(result); i++)
+   {
+      modules_ptr[i].module_instance_id      = GU_TEST_MIID_BASE + i;
+      modules_ptr[i].module_ht_node.key_ptr  = &modules_ptr[i].module_instance_id;
+      modules_ptr[i].module_ht_node.key_size = sizeof(modules_ptr[i].module_instance_id);
+      result = spf_hashtable_insert(&gu_ptr->module_ht, &modules_ptr[i].module_ht_node);
+   }
+
+   for (uint32_t i = 0; (i < GU_TEST_NUM_MODULES) && AR_SUCCEEDED(result); i++)
+   {
+      if (gu_find_module(gu_ptr, GU_TEST_MIID_BASE + i) != &modules_ptr[i])
+      {
+         AR_MSG(DBG_ERROR_PRIO, "gu test: module 0x%lx not found in the index", GU_TEST_MIID_BASE + i);
+         result = AR_EFAILED;
+      }
+   }
+   return result;
+}
+
+/* A graph may be destroyed twice (e.g. by OLC, once from the response handler and once on close). The second
+   destroy must not touch the freed module index, and the index can be created again afterwards. */
+static ar_result_t gu_test_destroy_twice()
+{
+   gu_t        gu;
+   gu_module_t modules[GU_TEST_NUM_MODULES];
+   ar_result_t result = AR_EOK;
+
+   memset(&gu, 0, sizeof(gu));
+   memset(modules, 0, sizeof(modules));
+
+   result |= gu_test_index_modules(&gu, modules);
+
+   for (uint32_t i = 0; i < 2; i++)
+   {
+      result |= gu_destroy_graph(&gu, TRUE);
+      if (gu.module_ht.table_ptr || gu.module_ht.table_size || gu.module_ht.num_items ||
+          gu_find_module(&gu, GU_TEST_MIID_BASE))
+      {
+         AR_MSG(DBG_ERROR_PRIO, "gu test: module index still present after destroy %lu", i);
+         result = AR_EFAILED;
+      }
+   }
+
+   memset(modules, 0, sizeof(modules));
+   result |= gu_test_index_modules(&gu, modules);
+   spf_hashtable_deinit(&gu.module_ht);
+   spf_hashtable_deinit(&gu.module_ht);
+
+   return result;
+}
+
+/********************************************************************************/
+ar_result_t graph_utils_test()
+{
+   ar_result_t result = AR_EOK;
+
+   result |= gu_test_destroy_twice();
+
+   AR_MSG(DBG_HIGH_PRIO, "gu tests %s", AR_SUCCEEDED(result) ? "passed" : "FAILED");
+
+   return result;
+}
@@ -0,0 +1,18 @@
+#ifndef __GRAPH_UTILS_TEST_H__
+#define __GRAPH_UTILS_TEST_H__
+/***
+ * \file graph_utils_test.h
+ * \brief
+ *    Header file for the graph utils (gu) tests.
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "graph_utils.h"
+
+/* Runs all the gu tests, returns AR_EOK if all of them pass */
+ar_result_t graph_utils_test();
+
+#endif //__GRAPH_UTILS_TEST_H__
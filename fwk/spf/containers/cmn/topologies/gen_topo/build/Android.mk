@@ -76,6 +76,7 @@ LOCAL_SRC_FILES := \
     core/src/gen_topo_fwk_extn_utils.c \
     core/src/gen_topo_intf_extn_utils.c \
     core/src/gen_topo_island.c \
+    core/src/gen_topo_parallel_paths.c \
     core/src/gen_topo_pm.c \
     core/src/gen_topo_propagation.c \
     core/src/gen_topo_public_functions.c \
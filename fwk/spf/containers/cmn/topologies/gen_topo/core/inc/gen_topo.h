@@ -439,6 +439,20 @@ typedef struct gen_topo_process_context_t
    capi_err_t                         proc_result;
 } gen_topo_process_context_t;
 
+/**
+ * State for processing the parallel paths of the topology (gu_t::num_parallel_paths) concurrently.
+ * Allocated only for containers that enable it (see gen_topo_parallel_paths_create).
+ */
+typedef struct gen_topo_parallel_paths_t
+{
+   bool_t                            is_active;          /**< TRUE while the paths are being processed concurrently. Process context
+                                                              is then per path and the lock below must guard shared topo state. */
+   uint8_t                           num_paths;          /**< number of process contexts in proc_context_pptr */
+   posal_mutex_t                     lock;               /**< serializes the buffer manager and module event callbacks when active */
+   gen_topo_process_context_t        **proc_context_pptr; /**< process context per path, index with path_index.
+                                                              index 0 points to gen_topo_t::proc_context. */
+} gen_topo_parallel_paths_t;
+
 
 typedef struct gen_topo_init_data_t
 {
@@ -641,6 +655,7 @@ typedef struct gen_topo_t
    gu_t                          gu;                        /**< Graph utils. */
    gu_module_list_t             *started_sorted_module_list_ptr; /**< sub list from sorted_modue_list, but only includes modules from started-SG */
    gen_topo_process_context_t    proc_context;              /**< history data required for data processing */
+   gen_topo_parallel_paths_t     *parallel_paths_ptr;       /**< non-NULL only if parallel paths can be processed concurrently */
 
    /*Following Capi Event Flags are hidden to prevent the direct access. These can be accessed using utility functions and Macros. */
    GEN_TOPO_CAPI_EVENT_FLAG_TYPE    capi_event_flag_;       /**< Main Capi Events: these are set synchronous to the data-path processing thread. Any event handling is also done based on this. */
@@ -784,6 +799,7 @@ typedef union gen_topo_module_flags_t
       uint64_t supports_period : 1; /** < INTF_EXTN_PERIOD */
       uint64_t supports_calibration_ops_done : 1; /** < INTF_EXTN_CALIBRATION_OPS_DONE */
       uint64_t supports_stm_ts : 1; /**< INTF_EXTN_STM_TS: Module requires the latest signal-triggered timestamp value*/
+      uint64_t supports_shared_out_buf : 1; /**< INTF_EXTN_SHARED_OUTPUT_BUFFER: input buffer can be shared with the outputs */
    };
    uint64_t word;
 } gen_topo_module_flags_t;
@@ -910,6 +926,9 @@ typedef union gen_topo_port_flags_t
                                                 GEN_TOPO_MF_PCM_UNPACKED_V2=0x2 indicates unpacked V2 */
 
       uint32_t       supports_buffer_resuse_extn: 2; /**< GEN_TOPO_MODULE_* bit mask */
+      uint32_t       is_shared_buf : 1;      /**< buf-mgr buffer on this port may be shared (read-only) with sibling ports of a
+                                                  module supporting INTF_EXTN_SHARED_OUTPUT_BUFFER. Must be made private using
+                                                  gen_topo_check_unshare_buf_mgr_buf() before modifying the data. */
 #ifdef USES_THIN_TOPO
       uint32_t       thin_topo_can_assign_ext_in_buffer:1;
       uint32_t       thin_topo_can_assign_ext_out_buffer:1;
@@ -1385,6 +1404,35 @@ void            gen_topo_set_sg_state(gu_sg_t *sg_ptr, topo_sg_state_t state);
 
 ar_result_t gen_topo_check_update_started_sorted_module_list(void *vtopo_ptr, bool_t b_force_update);
 
+/* Process context of the module. While parallel paths are processed concurrently each path has its own context;
+   otherwise this is topo_ptr->proc_context. */
+static inline gen_topo_process_context_t *gen_topo_get_proc_context(gen_topo_t *topo_ptr, gen_topo_module_t *module_ptr)
+{
+   gen_topo_parallel_paths_t *pp_ptr = topo_ptr->parallel_paths_ptr;
+   return (pp_ptr && pp_ptr->is_active) ? pp_ptr->proc_context_pptr[module_ptr->gu.path_index] : &topo_ptr->proc_context;
+}
+
+/* Guards topo state shared by all paths (buffer manager, event flags) while parallel paths are processed concurrently.
+   No-op otherwise. */
+static inline bool_t gen_topo_parallel_paths_lock(gen_topo_t *topo_ptr)
+{
+   gen_topo_parallel_paths_t *pp_ptr = topo_ptr->parallel_paths_ptr;
+   if (pp_ptr && pp_ptr->is_active)
+   {
+      posal_mutex_lock(pp_ptr->lock);
+      return TRUE;
+   }
+   return FALSE;
+}
+
+static inline void gen_topo_parallel_paths_unlock(gen_topo_t *topo_ptr, bool_t is_locked)
+{
+   if (is_locked)
+   {
+      posal_mutex_unlock(topo_ptr->parallel_paths_ptr->lock);
+   }
+}
+
 /* Process context sdata is common for all the module's capi process calls in the topo. Make sure to call reset
    in the begining of each module's process context. */
 static inline void gen_topo_reset_process_context_sdata(gen_topo_process_context_t *pc, gen_topo_module_t *module_ptr)
@@ -1415,6 +1463,13 @@ void gen_topo_exit_island_temporarily(gen_topo_t *topo_ptr);
  * */
 ar_result_t gen_topo_topo_process(gen_topo_t *topo_ptr, gu_module_list_t **start_module_list_pptr, uint8_t *path_index_ptr);
 
+//////////////////////////////////////  gen_topo_parallel_paths
+ar_result_t gen_topo_parallel_paths_create(gen_topo_t *topo_ptr, uint32_t num_paths);
+void        gen_topo_parallel_paths_destroy(gen_topo_t *topo_ptr);
+ar_result_t gen_topo_parallel_paths_realloc_scratch_memory(gen_topo_t *topo_ptr);
+void        gen_topo_parallel_paths_begin(gen_topo_t *topo_ptr);
+void        gen_topo_parallel_paths_end(gen_topo_t *topo_ptr);
+
 //////////////////////////////////////  NBLC
 bool_t      gen_topo_is_port_at_nblc_end(gu_module_t *gu_module_ptr, gen_topo_common_port_t *cmn_port_ptr);
 ar_result_t gen_topo_assign_non_buf_lin_chains(gen_topo_t *topo_ptr);
@@ -2140,11 +2195,14 @@ static inline bool_t gen_topo_input_has_data_or_md(gen_topo_input_port_t *in_por
 
 /* Following macro should be used to set one capi event flag.
  * This macros ensure that event is set in the correct event_flag based on the command or data path processing context.
+ * Flags are shared by all the paths, parallel paths lock is taken while they are processed concurrently.
  */
 #define GEN_TOPO_SET_ONE_CAPI_EVENT_FLAG(topo_ptr, flag)                                                               \
    {                                                                                                                   \
-      gen_topo_capi_event_flag_t *capi_set_event_flag_ptr = gen_topo_get_capi_event_flag_(topo_ptr);                   \
-      capi_set_event_flag_ptr->flag = TRUE;                                                                            \
+      bool_t                      capi_set_event_is_locked = gen_topo_parallel_paths_lock(topo_ptr);                   \
+      gen_topo_capi_event_flag_t *capi_set_event_flag_ptr  = gen_topo_get_capi_event_flag_(topo_ptr);                  \
+      capi_set_event_flag_ptr->flag                        = TRUE;                                                     \
+      gen_topo_parallel_paths_unlock(topo_ptr, capi_set_event_is_locked);                                              \
    }
 
 /* Following macro should be used to set more than one capi event flags.
@@ -2152,8 +2210,10 @@ static inline bool_t gen_topo_input_has_data_or_md(gen_topo_input_port_t *in_por
  */
 #define GEN_TOPO_SET_CAPI_EVENT_FLAGS(topo_ptr, capi_event_flags)                                                      \
    {                                                                                                                   \
-      gen_topo_capi_event_flag_t *capi_set_event_flag_ptr = gen_topo_get_capi_event_flag_(topo_ptr);                   \
+      bool_t                      capi_set_event_is_locked = gen_topo_parallel_paths_lock(topo_ptr);                   \
+      gen_topo_capi_event_flag_t *capi_set_event_flag_ptr  = gen_topo_get_capi_event_flag_(topo_ptr);                  \
       capi_set_event_flag_ptr->word |= capi_event_flags.word;                                                          \
+      gen_topo_parallel_paths_unlock(topo_ptr, capi_set_event_is_locked);                                              \
    }
 /*
  * Following two macros should be used carefully in an event handling function.
@@ -2221,8 +2281,14 @@ static inline bool_t gen_topo_any_process_call_events(gen_topo_t *topo_ptr)
    // kpps, bw, rt change can be handled at the end of topo processing. but media fmt, threshold events need
    // to be handled in b/w module processing also.
    // process state - we must break at this module and call the module again to avoid buffering in nblc.
-   return (((gen_topo_capi_event_flag_t *)&topo_ptr->capi_event_flag_)->word & (GT_CAPI_EVENT_PORT_THRESH_BIT_MASK | GT_CAPI_EVENT_PROCESS_STATE_BIT_MASK |
-                                             GT_CAPI_EVENT_MEDIA_FMT_BIT_MASK));
+   // while parallel paths are processed concurrently, other paths may be setting the flags.
+   bool_t is_locked = gen_topo_parallel_paths_lock(topo_ptr);
+   bool_t any_event = (0 != (((gen_topo_capi_event_flag_t *)&topo_ptr->capi_event_flag_)->word &
+                             (GT_CAPI_EVENT_PORT_THRESH_BIT_MASK | GT_CAPI_EVENT_PROCESS_STATE_BIT_MASK |
+                              GT_CAPI_EVENT_MEDIA_FMT_BIT_MASK)));
+   gen_topo_parallel_paths_unlock(topo_ptr, is_locked);
+
+   return any_event;
 }
 
 ///////////////////////////////// CAPI EVENT HANDLING RELATED - END ////////////////////////////////
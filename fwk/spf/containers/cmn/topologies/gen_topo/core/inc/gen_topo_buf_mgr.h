@@ -33,6 +33,12 @@ ar_result_t gen_topo_check_get_in_buf_from_buf_mgr_util_(gen_topo_t *
                                                          gen_topo_input_port_t * curr_in_port_ptr,
                                                          gen_topo_output_port_t *prev_out_port_ptr);
 
+/* Dont call this function directly, use gen_topo_check_unshare_buf_mgr_buf() instead */
+ar_result_t gen_topo_unshare_buf_mgr_buf_util_(gen_topo_t *            topo_ptr,
+                                               gen_topo_common_port_t *cmn_port_ptr,
+                                               uint32_t                module_inst_id,
+                                               uint32_t                port_id);
+
 ar_result_t gen_topo_initialize_bufs_sdata(gen_topo_t *            topo_ptr,
                                            gen_topo_common_port_t *cmn_port_ptr,
                                            uint32_t                miid,
@@ -144,6 +150,7 @@ static inline ar_result_t gen_topo_buf_mgr_wrapper_get_buf(gen_topo_t *topo_ptr,
    {
       cmn_port_ptr->bufs_ptr[0].data_ptr       = ptr;
       cmn_port_ptr->flags.buf_origin           = GEN_TOPO_BUF_ORIGIN_BUF_MGR;
+      cmn_port_ptr->flags.is_shared_buf        = FALSE;
 
       // for pcm unpacked v1/v2 we populate len only for first ch here. If port is operating with unpacked v1
       // fwk updates rest of the ch lens before calling module process.
@@ -303,8 +310,10 @@ static inline ar_result_t gen_topo_return_one_buf_mgr_buf(gen_topo_t *
             //     adjusted when borrowed and must be updated everytime dtmf borrows.
             //  2. IF data flow state is not at GAP, in other words if data is flowing.
             //  3. We can hold buffers only in Real time paths. In FTRT paths, the pile up can vary
+            //  4. buffer is not shared with sibling ports (refer gen_topo_check_unshare_buf_mgr_buf()).
             if ((cmn_port_ptr->data_flow_state != TOPO_DATA_FLOW_STATE_AT_GAP) &&
                 (FALSE == cmn_port_ptr->flags.downstream_req_data_buffering) &&
+                (FALSE == cmn_port_ptr->flags.is_shared_buf) &&
                  gen_topo_is_port_in_realtime_path(cmn_port_ptr))
             {
                return AR_EOK;
@@ -334,6 +343,7 @@ static inline ar_result_t gen_topo_return_one_buf_mgr_buf(gen_topo_t *
 
 #if 1
       cmn_port_ptr->bufs_ptr[0].data_ptr = NULL;
+      cmn_port_ptr->flags.is_shared_buf  = FALSE;
 #else
       for (uint32_t b = 0; b < cmn_port_ptr->sdata.bufs_num; b++)
       {
@@ -359,6 +369,45 @@ static inline ar_result_t gen_topo_check_return_one_buf_mgr_buf(gen_topo_t *
    return gen_topo_return_one_buf_mgr_buf(topo_ptr, cmn_port_ptr, module_inst_id, port_id);
 }
 
+/**
+ * Copy-on-write for buffers shared by a module supporting INTF_EXTN_SHARED_OUTPUT_BUFFER.
+ *
+ * Must be called before modifying data (in-place, append, move to beginning, zero push etc) in a port buffer which
+ * may be shared. If other ports still refer to the buffer, data is copied to a new buf-mgr buffer which is then owned
+ * only by this port.
+ */
+static inline ar_result_t gen_topo_check_unshare_buf_mgr_buf(gen_topo_t *            topo_ptr,
+                                                             gen_topo_common_port_t *cmn_port_ptr,
+                                                             uint32_t                module_inst_id,
+                                                             uint32_t                port_id)
+{
+   if (!cmn_port_ptr->flags.is_shared_buf)
+   {
+      return AR_EOK;
+   }
+   return gen_topo_unshare_buf_mgr_buf_util_(topo_ptr, cmn_port_ptr, module_inst_id, port_id);
+}
+
+/**
+ * Copy-on-write before a module process call. CAPI doesn't forbid writing to the input (e.g. filters cross-fading in
+ * place on their input), so a shared buffer is given only to modules which declare a read-only input by supporting
+ * INTF_EXTN_SHARED_OUTPUT_BUFFER. Bypassed modules and framework modules only read the input.
+ */
+static inline ar_result_t gen_topo_check_unshare_in_buf_before_process(gen_topo_t *           topo_ptr,
+                                                                       gen_topo_module_t *    module_ptr,
+                                                                       gen_topo_input_port_t *in_port_ptr)
+{
+   if (!in_port_ptr->common.flags.is_shared_buf || !module_ptr->capi_ptr || module_ptr->bypass_ptr ||
+       module_ptr->flags.supports_shared_out_buf)
+   {
+      return AR_EOK;
+   }
+   return gen_topo_unshare_buf_mgr_buf_util_(topo_ptr,
+                                             &in_port_ptr->common,
+                                             module_ptr->gu.module_instance_id,
+                                             in_port_ptr->gu.cmn.id);
+}
+
 /**
  *
  *                      -----------------                             ---------------
@@ -853,6 +853,9 @@ ar_result_t gen_topo_check_n_realloc_scratch_memory(gen_topo_t *topo_ptr, bool_t
 
    SPF_CRITICAL_SECTION_END(&topo_ptr->gu);
 
+   // on failure parallel paths are processed serially, no need to fail here.
+   (void)gen_topo_parallel_paths_realloc_scratch_memory(topo_ptr);
+
    CATCH(result, TOPO_MSG_PREFIX, topo_ptr->gu.log_id)
    {
       TOPO_MSG(topo_ptr->gu.log_id,
@@ -978,6 +981,8 @@ ar_result_t gen_topo_destroy_topo(gen_topo_t *topo_ptr)
    MFREE_NULLIFY(topo_ptr->proc_context.ext_in_port_scratch_ptr);
    MFREE_NULLIFY(topo_ptr->proc_context.ext_out_port_scratch_ptr);
 
+   gen_topo_parallel_paths_destroy(topo_ptr);
+
    // free the started sorted module list if not done yet
    spf_list_delete_list((spf_list_node_t **)&topo_ptr->started_sorted_module_list_ptr, TRUE);
 
@@ -169,6 +169,52 @@ capi_err_t gen_topo_mark_buf_mgr_buffers_to_force_return(gen_topo_t *topo_ptr)
    return CAPI_EOK;
 }
 
+/**
+ * Modules supporting INTF_EXTN_SHARED_OUTPUT_BUFFER (e.g. splitter) publish the input as is on all outputs.
+ * Instead of a copy per output, the input buf-mgr buffer is assigned to the output and ref counted. Both ports are
+ * marked is_shared_buf so that whoever modifies the data later makes a private copy first
+ * (gen_topo_check_unshare_buf_mgr_buf). That includes every downstream module which doesn't declare a read-only input
+ * by supporting the same extension, as CAPI allows modules to write to their input.
+ *
+ * Not done in low latency mode as buffers are held across process calls there.
+ */
+static bool_t gen_topo_check_share_in_buf_with_out(gen_topo_t *            topo_ptr,
+                                                   gen_topo_module_t *     module_ptr,
+                                                   gen_topo_output_port_t *curr_out_port_ptr)
+{
+   if (!module_ptr->flags.supports_shared_out_buf || (TOPO_BUF_LOW_LATENCY == topo_ptr->buf_mgr.mode) ||
+       (1 != module_ptr->gu.num_input_ports) || (NULL == curr_out_port_ptr->gu.conn_in_port_ptr))
+   {
+      return FALSE;
+   }
+
+   gen_topo_input_port_t *in_port_ptr = (gen_topo_input_port_t *)module_ptr->gu.input_port_list_ptr->ip_port_ptr;
+
+   // only buf mgr buffers are ref counted. output must see the same buffer layout as input.
+   if ((NULL == in_port_ptr->common.bufs_ptr[0].data_ptr) ||
+       (GEN_TOPO_BUF_ORIGIN_BUF_MGR != in_port_ptr->common.flags.buf_origin) ||
+       (in_port_ptr->common.sdata.bufs_num != curr_out_port_ptr->common.sdata.bufs_num) ||
+       (in_port_ptr->common.flags.is_pcm_unpacked != curr_out_port_ptr->common.flags.is_pcm_unpacked) ||
+       (in_port_ptr->common.bufs_ptr[0].max_data_len != curr_out_port_ptr->common.max_buf_len_per_buf))
+   {
+      return FALSE;
+   }
+
+   gen_topo_assign_bufs_ptr(topo_ptr->gu.log_id,
+                            &curr_out_port_ptr->common,
+                            &in_port_ptr->common,
+                            module_ptr,
+                            curr_out_port_ptr->gu.cmn.id);
+
+   curr_out_port_ptr->common.flags.buf_origin = GEN_TOPO_BUF_ORIGIN_BUF_MGR;
+   gen_topo_buf_mgr_wrapper_inc_ref_count(&curr_out_port_ptr->common);
+
+   in_port_ptr->common.flags.is_shared_buf       = TRUE;
+   curr_out_port_ptr->common.flags.is_shared_buf = TRUE;
+
+   return TRUE;
+}
+
 /**
  * Dont call this function directly, use gen_topo_check_get_out_buf_from_buf_mgr() instead
  *
@@ -196,7 +242,11 @@ ar_result_t gen_topo_check_get_out_buf_from_buf_mgr_util_(gen_topo_t *
    if (gen_topo_is_inplace_or_disabled_siso(module_ptr))
    {
       gen_topo_input_port_t *in_port_ptr = (gen_topo_input_port_t *)module_ptr->gu.input_port_list_ptr->ip_port_ptr;
-      if (in_port_ptr->common.bufs_ptr[0].data_ptr)
+
+      // copy-on-write: an enabled inplace module would overwrite a shared input, give it a separate output instead.
+      if (in_port_ptr->common.bufs_ptr[0].data_ptr &&
+          (!in_port_ptr->common.flags.is_shared_buf || module_ptr->bypass_ptr ||
+           module_ptr->flags.supports_shared_out_buf))
       {
          gen_topo_assign_bufs_ptr(topo_ptr->gu.log_id,
                                   &curr_out_port_ptr->common,
@@ -204,10 +254,15 @@ ar_result_t gen_topo_check_get_out_buf_from_buf_mgr_util_(gen_topo_t *
                                   module_ptr,
                                   curr_out_port_ptr->gu.cmn.id);
          // in place modules are SISO (already checked)
-         curr_out_port_ptr->common.flags.buf_origin = in_port_ptr->common.flags.buf_origin;
+         curr_out_port_ptr->common.flags.buf_origin    = in_port_ptr->common.flags.buf_origin;
+         curr_out_port_ptr->common.flags.is_shared_buf = in_port_ptr->common.flags.is_shared_buf;
          gen_topo_buf_mgr_wrapper_inc_ref_count(&curr_out_port_ptr->common);
       }
    }
+   else if (gen_topo_check_share_in_buf_with_out(topo_ptr, module_ptr, curr_out_port_ptr))
+   {
+      // input buffer is shared with the output.
+   }
    else
    {
       // check if the buffer can be reused from the nblc end.
@@ -340,7 +395,8 @@ ar_result_t gen_topo_check_get_in_buf_from_buf_mgr_util_(gen_topo_t *
                                module_ptr,
                                curr_in_port_ptr->gu.cmn.id);
 
-      curr_in_port_ptr->common.flags.buf_origin = prev_out_port_ptr->common.flags.buf_origin;
+      curr_in_port_ptr->common.flags.buf_origin    = prev_out_port_ptr->common.flags.buf_origin;
+      curr_in_port_ptr->common.flags.is_shared_buf = prev_out_port_ptr->common.flags.is_shared_buf;
       gen_topo_buf_mgr_wrapper_inc_ref_count(&curr_in_port_ptr->common);
       // don't release prev_out_port_ptr->common.bufs_ptr[0].data_ptr here, as return_buf is called.
    }
@@ -404,6 +460,68 @@ ar_result_t gen_topo_check_get_in_buf_from_buf_mgr_util_(gen_topo_t *
    return result;
 }
 
+/* Dont call this function directly, use gen_topo_check_unshare_buf_mgr_buf() instead. */
+ar_result_t gen_topo_unshare_buf_mgr_buf_util_(gen_topo_t *            topo_ptr,
+                                               gen_topo_common_port_t *cmn_port_ptr,
+                                               uint32_t                module_inst_id,
+                                               uint32_t                port_id)
+{
+   ar_result_t result = AR_EOK;
+
+   if ((NULL == cmn_port_ptr->bufs_ptr[0].data_ptr) || (GEN_TOPO_BUF_ORIGIN_BUF_MGR != cmn_port_ptr->flags.buf_origin))
+   {
+      cmn_port_ptr->flags.is_shared_buf = FALSE;
+      return result;
+   }
+
+   int8_t *                    old_ptr     = cmn_port_ptr->bufs_ptr[0].data_ptr;
+   topo_buf_manager_element_t *wrapper_ptr = (topo_buf_manager_element_t *)(old_ptr - TBF_BUF_PTR_OFFSET);
+
+   // if nobody else refers to the buffer anymore, it's already private.
+   if (wrapper_ptr->ref_count <= 1)
+   {
+      cmn_port_ptr->flags.is_shared_buf = FALSE;
+      return result;
+   }
+
+   int8_t *new_ptr = NULL;
+   result          = topo_buf_manager_get_buf(topo_ptr, &new_ptr, wrapper_ptr->size);
+   if (NULL == new_ptr)
+   {
+      TOPO_MSG(topo_ptr->gu.log_id,
+               DBG_ERROR_PRIO,
+               " Module 0x%lX: port id 0x%lx, failed to get buffer to unshare 0x%p",
+               module_inst_id,
+               port_id,
+               old_ptr);
+      return AR_DID_FAIL(result) ? result : AR_ENOMEMORY;
+   }
+
+   // copy whole buffer so that data of all bufs stays at the same offsets.
+   memscpy(new_ptr, wrapper_ptr->size, old_ptr, wrapper_ptr->size);
+
+   for (uint32_t b = 0; b < cmn_port_ptr->sdata.bufs_num; b++)
+   {
+      cmn_port_ptr->bufs_ptr[b].data_ptr = new_ptr + (cmn_port_ptr->bufs_ptr[b].data_ptr - old_ptr);
+   }
+
+   // other ports still hold the old buffer, ref count cannot reach zero here.
+   wrapper_ptr->ref_count--;
+   cmn_port_ptr->flags.is_shared_buf = FALSE;
+
+#ifdef BUF_MGMT_DEBUG
+   TOPO_MSG(topo_ptr->gu.log_id,
+            DBG_LOW_PRIO,
+            " Module 0x%lX: port id 0x%lx, unshared buf 0x%p -> 0x%p",
+            module_inst_id,
+            port_id,
+            old_ptr,
+            new_ptr);
+#endif
+
+   return result;
+}
+
 /*********************************
  *
  *
@@ -576,7 +694,7 @@ static void topo_buf_manager_check_destroy_unused_buf(gen_topo_t *topo_ptr)
    }
 }
 
-ar_result_t topo_buf_manager_get_buf(gen_topo_t *topo_ptr, int8_t **buf_pptr, uint32_t buf_size)
+static ar_result_t topo_buf_manager_get_buf_(gen_topo_t *topo_ptr, int8_t **buf_pptr, uint32_t buf_size)
 {
    spf_list_node_t *           buf_mgr_list_ptr;
    topo_buf_manager_element_t *buf_element_ptr;
@@ -684,7 +802,7 @@ destory_unused_buf_n_ret:
    return AR_EOK;
 }
 
-void topo_buf_manager_return_buf(gen_topo_t *topo_ptr, int8_t *buf_ptr)
+static void topo_buf_manager_return_buf_(gen_topo_t *topo_ptr, int8_t *buf_ptr)
 {
    spf_list_node_t *returned_buf_node_ptr;
 
@@ -791,3 +909,19 @@ void topo_buf_manager_return_buf(gen_topo_t *topo_ptr, int8_t *buf_ptr)
 
    return;
 }
+
+ar_result_t topo_buf_manager_get_buf(gen_topo_t *topo_ptr, int8_t **buf_pptr, uint32_t buf_size)
+{
+   // buffer list is shared by all parallel paths
+   bool_t      is_locked = gen_topo_parallel_paths_lock(topo_ptr);
+   ar_result_t result    = topo_buf_manager_get_buf_(topo_ptr, buf_pptr, buf_size);
+   gen_topo_parallel_paths_unlock(topo_ptr, is_locked);
+   return result;
+}
+
+void topo_buf_manager_return_buf(gen_topo_t *topo_ptr, int8_t *buf_ptr)
+{
+   bool_t is_locked = gen_topo_parallel_paths_lock(topo_ptr);
+   topo_buf_manager_return_buf_(topo_ptr, buf_ptr);
+   gen_topo_parallel_paths_unlock(topo_ptr, is_locked);
+}
@@ -507,6 +507,7 @@ static ar_result_t gen_topo_capi_query_intf_extn_support(void *             amdb
                               { INTF_EXTN_PERIOD,                    FALSE, { NULL, 0, 0 } },      \
                               { INTF_EXTN_CALIBRATION_OPS_DONE,      FALSE, { NULL, 0, 0 } },      \
                               { INTF_EXTN_STM_TS,                    FALSE, { NULL, 0, 0 } },      \
+                              { INTF_EXTN_SHARED_OUTPUT_BUFFER,      FALSE, { NULL, 0, 0 } },      \
                             }
 
    #define LEN_OF_INTF_EXTNS_ARRAY SIZE_OF_ARRAY((capi_interface_extn_desc_t[]) INTF_EXTNS_ARRAY)
@@ -609,6 +610,11 @@ static ar_result_t gen_topo_capi_query_intf_extn_support(void *             amdb
                   module_ptr->flags.supports_stm_ts = TRUE;
                   break;
                }
+               case INTF_EXTN_SHARED_OUTPUT_BUFFER:
+               {
+                  module_ptr->flags.supports_shared_out_buf = TRUE;
+                  break;
+               }
                default:
                {
                   // Something can't be supported and not be handled. Shouldn't get here.
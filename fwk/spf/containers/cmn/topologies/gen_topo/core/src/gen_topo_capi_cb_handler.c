@@ -381,8 +381,9 @@ capi_err_t gen_topo_handle_output_media_format_event(void *             ctxt_ptr
     * zero then also it's an error. However, if there's no data, then it's ok to raise subsquent media fmts even if we
     * had not handled yet.
     */
-   uint32_t old_bytes = topo_ptr->proc_context.process_info.is_in_mod_proc_context
-                           ? topo_ptr->proc_context.out_port_scratch_ptr[port_ind].prev_actual_data_len[0]
+   gen_topo_process_context_t *pc_ptr = gen_topo_get_proc_context(topo_ptr, module_ptr);
+   uint32_t old_bytes = pc_ptr->process_info.is_in_mod_proc_context
+                           ? pc_ptr->out_port_scratch_ptr[port_ind].prev_actual_data_len[0]
                            : out_port_ptr->common.bufs_ptr && out_port_ptr->common.bufs_ptr[0].actual_data_len;
    if (!is_pending_data_valid && (0 != old_bytes))
    {
@@ -393,7 +394,7 @@ capi_err_t gen_topo_handle_output_media_format_event(void *             ctxt_ptr
                module_ptr->gu.module_instance_id,
                old_bytes,
                out_port_ptr->common.flags.media_fmt_event,
-               topo_ptr->proc_context.process_info.is_in_mod_proc_context);
+               pc_ptr->process_info.is_in_mod_proc_context);
       return CAPI_EFAILED;
    }
 
@@ -1085,10 +1086,10 @@ capi_err_t gen_topo_capi_callback_base(gen_topo_module_t *module_ptr,
             {
                if (out_port_ptr->common.threshold_raised != new_threshold)
                {
-                  uint32_t old_bytes =
-                     topo_ptr->proc_context.process_info.is_in_mod_proc_context
-                        ? topo_ptr->proc_context.out_port_scratch_ptr[event_info_ptr->port_info.port_index]
-                             .prev_actual_data_len[0]
+                  gen_topo_process_context_t *pc_ptr = gen_topo_get_proc_context(topo_ptr, module_ptr);
+                  uint32_t                    old_bytes =
+                     pc_ptr->process_info.is_in_mod_proc_context
+                        ? pc_ptr->out_port_scratch_ptr[event_info_ptr->port_info.port_index].prev_actual_data_len[0]
                         : (out_port_ptr->common.bufs_ptr && out_port_ptr->common.bufs_ptr[0].actual_data_len);
                   if (old_bytes != 0)
                   {
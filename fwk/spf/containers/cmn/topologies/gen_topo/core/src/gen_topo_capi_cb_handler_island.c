@@ -31,6 +31,9 @@ capi_err_t gen_topo_capi_callback(void *context_ptr, capi_event_id_t id, capi_ev
    gen_topo_module_t *module_ptr = (gen_topo_module_t *)(context_ptr);
    gen_topo_t *       topo_ptr   = module_ptr->topo_ptr;
 
+   // event flags are shared by all parallel paths, modules of different paths may raise events at the same time.
+   bool_t is_locked = gen_topo_parallel_paths_lock(topo_ptr);
+
    SPF_CRITICAL_SECTION_START(&topo_ptr->gu);
 
    // try to handle the event in island, if not handle in non-island
@@ -67,6 +70,8 @@ capi_err_t gen_topo_capi_callback(void *context_ptr, capi_event_id_t id, capi_ev
 
    SPF_CRITICAL_SECTION_END(&topo_ptr->gu);
 
+   gen_topo_parallel_paths_unlock(topo_ptr, is_locked);
+
    return result;
 }
 
@@ -309,6 +309,40 @@ static bool_t gen_topo_need_to_copy_md(gen_topo_module_t *    module_ptr,
            prev_sdata_ptr->flags.end_of_frame || next_sdata_ptr->flags.marker_eos);
 }
 
+/**
+ * copy-on-write for shared buffers (INTF_EXTN_SHARED_OUTPUT_BUFFER): data is appended to next input and if next input
+ * cannot take everything, remaining data is moved to the beginning of prev output.
+ */
+static void gen_topo_check_unshare_bufs_before_copy(gen_topo_t *            topo_ptr,
+                                                    gen_topo_input_port_t * next_in_port_ptr,
+                                                    gen_topo_output_port_t *prev_out_port_ptr)
+{
+   topo_buf_t *next_bufs_ptr = next_in_port_ptr->common.bufs_ptr;
+   topo_buf_t *prev_bufs_ptr = prev_out_port_ptr->common.bufs_ptr;
+
+   gen_topo_check_unshare_buf_mgr_buf(topo_ptr,
+                                      &next_in_port_ptr->common,
+                                      next_in_port_ptr->gu.cmn.module_ptr->module_instance_id,
+                                      next_in_port_ptr->gu.cmn.id);
+
+   if (!prev_out_port_ptr->common.flags.is_shared_buf)
+   {
+      return;
+   }
+
+   for (uint32_t b = 0; b < gen_topo_get_num_sdata_bufs_to_update(&next_in_port_ptr->common); b++)
+   {
+      if (prev_bufs_ptr[b].actual_data_len > (next_bufs_ptr[b].max_data_len - next_bufs_ptr[b].actual_data_len))
+      {
+         gen_topo_check_unshare_buf_mgr_buf(topo_ptr,
+                                            &prev_out_port_ptr->common,
+                                            prev_out_port_ptr->gu.cmn.module_ptr->module_instance_id,
+                                            prev_out_port_ptr->gu.cmn.id);
+         break;
+      }
+   }
+}
+
 ar_result_t gen_topo_copy_data_from_prev_to_next(gen_topo_t *            topo_ptr,
                                                  gen_topo_module_t *     next_module_ptr,
                                                  gen_topo_input_port_t * next_in_port_ptr,
@@ -388,6 +422,8 @@ ar_result_t gen_topo_copy_data_from_prev_to_next(gen_topo_t *            topo_pt
    }
    else
    {
+      gen_topo_check_unshare_bufs_before_copy(topo_ptr, next_in_port_ptr, prev_out_port_ptr);
+
       if (SPF_IS_PCM_DATA_FORMAT(next_med_fmt_ptr->data_format) &&
           (TOPO_DEINTERLEAVED_PACKED == next_med_fmt_ptr->pcm.interleaving))
       {
@@ -951,16 +987,16 @@ GEN_TOPO_STATIC ar_result_t gen_topo_check_copy_between_modules(gen_topo_t *
       // Important: If media format event is set, should NOT set data_pending_in_prev though there is pending data in
       // prev output. Else it can result in erroneous copy of new mf data from prev output to next input with old mf,
       // and media format will never be propagated since next input has the erroneous data. tests: rve_rx_tx_low_power
+      gen_topo_process_context_t *pc = gen_topo_get_proc_context(topo_ptr, next_module_ptr);
       if (prev_out_port_ptr->common.bufs_ptr[0].actual_data_len > 0)
       {
-         gen_topo_process_context_t *pc                                                     = &topo_ptr->proc_context;
          pc->in_port_scratch_ptr[next_in_port_ptr->gu.cmn.index].flags.data_pending_in_prev = TRUE;
       }
 
       // If data is copied from output to input then mark this true.
       // there can be a case where input is copied but module's trigger policy is not satisfied
       // test: pb_sync_gen_cntr_sal_8
-      topo_ptr->proc_context.process_info.anything_changed = TRUE;
+      pc->process_info.anything_changed = TRUE;
    }
    // trying to release here helps case where get_buf is FALSE and prev_out has no data.
    // at EOS we cannot return buf as we need buf to call module process
@@ -985,7 +1021,7 @@ ar_result_t gen_topo_populate_sdata_bufs(gen_topo_t *            topo_ptr,
 {
    ar_result_t                 result = AR_EOK;
    capi_buf_t *                bufs;
-   gen_topo_process_context_t *pc_ptr      = &topo_ptr->proc_context;
+   gen_topo_process_context_t *pc_ptr      = gen_topo_get_proc_context(topo_ptr, module_ptr);
    topo_media_fmt_t *          med_fmt_ptr = out_port_ptr->common.media_fmt_ptr;
 
 // when stale out is present we don't call module_process
@@ -1074,8 +1110,8 @@ ar_result_t gen_topo_update_out_buf_len_after_process(gen_topo_t *            to
                                                       bool_t                  err_check,
                                                       uint32_t *              prev_actual_data_len)
 {
-   gen_topo_process_context_t *pc_ptr              = &topo_ptr->proc_context;
    gen_topo_module_t *         module_ptr          = (gen_topo_module_t *)out_port_ptr->gu.cmn.module_ptr;
+   gen_topo_process_context_t *pc_ptr              = gen_topo_get_proc_context(topo_ptr, module_ptr);
    topo_media_fmt_t *          med_fmt_ptr         = out_port_ptr->common.media_fmt_ptr;
    capi_stream_data_v2_t *     sdata_ptr           = pc_ptr->out_port_sdata_pptr[out_port_ptr->gu.cmn.index];
    uint32_t                    supposed_len_per_ch = 0;
@@ -1262,6 +1298,15 @@ ar_result_t gen_topo_move_data_to_beginning_after_process(gen_topo_t *
 
    // This function needs to update actual data len
 
+   // copy-on-write: remaining data is moved within the buffer below.
+   if (remaining_size_after_per_buf)
+   {
+      gen_topo_check_unshare_buf_mgr_buf(topo_ptr,
+                                         &in_port_ptr->common,
+                                         in_port_ptr->gu.cmn.module_ptr->module_instance_id,
+                                         in_port_ptr->gu.cmn.id);
+   }
+
    // remaining_size_after_per_buf is based on first ch or buf only, which is sufficient to check if any data remains.
    // Exact amount varies per buf.
    // whether remaining length is zero or not, the 'else' logic works.
@@ -1495,13 +1540,14 @@ void gen_topo_process_attached_module_to_output(gen_topo_t             *topo_ptr
       return;
          }
 
-         uint32_t out_port_idx = out_port_ptr->gu.cmn.index;
+         uint32_t                    out_port_idx = out_port_ptr->gu.cmn.index;
+         gen_topo_process_context_t *pc_ptr       = gen_topo_get_proc_context(topo_ptr, module_ptr);
 
          // If attached doesnt support unpacked V2, update lens for all the channels,
          // because host may be operating with unpacked V2
          if (GEN_TOPO_MF_PCM_UNPACKED_V1 == attached_mod_ip_port_ptr->common.flags.is_pcm_unpacked)
          {
-            capi_stream_data_v2_t *output_sdata_ptr        = topo_ptr->proc_context.out_port_sdata_pptr[out_port_idx];
+            capi_stream_data_v2_t *output_sdata_ptr        = pc_ptr->out_port_sdata_pptr[out_port_idx];
             uint32_t               actual_data_len_per_buf = output_sdata_ptr->buf_ptr[0].actual_data_len;
             uint32_t               max_data_len_per_buf    = output_sdata_ptr->buf_ptr[0].max_data_len;
             for (uint32_t i = 1; i < output_sdata_ptr->bufs_num; i++)
@@ -1525,8 +1571,8 @@ void gen_topo_process_attached_module_to_output(gen_topo_t             *topo_ptr
          attached_proc_result =
             out_attached_module_ptr->capi_ptr->vtbl_ptr
                ->process(out_attached_module_ptr->capi_ptr,
-                         (capi_stream_data_t **)&(topo_ptr->proc_context.out_port_sdata_pptr[out_port_idx]),
-                         (capi_stream_data_t **)&(topo_ptr->proc_context.out_port_sdata_pptr[out_port_idx]));
+                         (capi_stream_data_t **)&(pc_ptr->out_port_sdata_pptr[out_port_idx]),
+                         (capi_stream_data_t **)&(pc_ptr->out_port_sdata_pptr[out_port_idx]));
 
          );
          // clang-format on
@@ -1535,9 +1581,9 @@ void gen_topo_process_attached_module_to_output(gen_topo_t             *topo_ptr
 
          TOPO_MSG(topo_ptr->gu.log_id,DBG_LOW_PRIO,"M_iid 0x%lX output ts_valid - %d , TS[MSW, LSW] - [%d, %d]",
                  out_attached_module_ptr->gu.module_instance_id,
-                 topo_ptr->proc_context.out_port_sdata_pptr[out_port_idx]->flags.is_timestamp_valid,
-                 (uint32_t )(topo_ptr->proc_context.out_port_sdata_pptr[out_port_idx]->timestamp >>32),
-                 (uint32_t )topo_ptr->proc_context.out_port_sdata_pptr[out_port_idx]->timestamp );
+                 pc_ptr->out_port_sdata_pptr[out_port_idx]->flags.is_timestamp_valid,
+                 (uint32_t )(pc_ptr->out_port_sdata_pptr[out_port_idx]->timestamp >>32),
+                 (uint32_t )pc_ptr->out_port_sdata_pptr[out_port_idx]->timestamp );
 
          PRINT_PORT_INFO_AT_PROCESS(out_attached_module_ptr->gu.module_instance_id,
                                     out_port_ptr->gu.cmn.id,
@@ -1614,7 +1660,7 @@ GEN_TOPO_STATIC ar_result_t gen_topo_module_process(gen_topo_t *       topo_ptr,
    uint32_t op_idx = 0, ip_idx = 0;
    uint32_t m_iid = module_ptr->gu.module_instance_id;
 
-   gen_topo_process_context_t *pc               = &topo_ptr->proc_context;
+   gen_topo_process_context_t *pc               = gen_topo_get_proc_context(topo_ptr, module_ptr);
    gen_topo_process_info_t *   process_info_ptr = &pc->process_info;
    gen_topo_input_port_t *     in_port_ptr      = NULL;
    gen_topo_output_port_t *    out_port_ptr     = NULL;
@@ -1644,6 +1690,12 @@ GEN_TOPO_STATIC ar_result_t gen_topo_module_process(gen_topo_t *       topo_ptr,
          }
       }
 
+      // copy-on-write for a shared input (INTF_EXTN_SHARED_OUTPUT_BUFFER)
+      if (AR_EOK != (local_result = gen_topo_check_unshare_in_buf_before_process(topo_ptr, module_ptr, in_port_ptr)))
+      {
+         return local_result;
+      }
+
       // pushes zeros only when fwk owns metadata (checks are inside)
       if (topo_is_sdata_flag_EOS_or_EOF_set(sdata_ptr))
       {
@@ -2422,8 +2474,7 @@ ar_result_t gen_topo_topo_process(gen_topo_t        *topo_ptr,
                                   gu_module_list_t **start_module_list_pptr,
                                   uint8_t           *path_index_ptr)
 {
-   ar_result_t              result           = AR_EOK;
-   gen_topo_process_info_t *process_info_ptr = &topo_ptr->proc_context.process_info;
+   ar_result_t result = AR_EOK;
 
 #ifdef VERBOSE_DEBUGGING
    TOPO_MSG_ISLAND(topo_ptr->gu.log_id,
@@ -2442,7 +2493,9 @@ ar_result_t gen_topo_topo_process(gen_topo_t        *topo_ptr,
          continue;
       }
 
-      gen_topo_process_context_t *pc                            = &topo_ptr->proc_context;
+      // while parallel paths are processed concurrently, each path has its own process context
+      gen_topo_process_context_t *pc                            = gen_topo_get_proc_context(topo_ptr, module_ptr);
+      gen_topo_process_info_t    *process_info_ptr              = &pc->process_info;
       bool_t                      prev_output_produced_any_data = FALSE;
       bool_t out_has_no_trigger = FALSE; // by default assume output has trigger (works for sink modules)
       bool_t inp_has_no_trigger = FALSE;
@@ -0,0 +1,240 @@
+/**
+ * \file gen_topo_parallel_paths.c
+ * \brief
+ *     This file contains the topo support for processing parallel paths concurrently.
+ *
+ *     Each parallel path gets its own process context (port scratch data, sdata pointers and process info) so that
+ *     gen_topo_topo_process can run for different paths on different threads. Topo state shared across the paths
+ *     (buffer manager, capi event flags) is serialized with gen_topo_parallel_paths_t::lock while the paths are active.
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "gen_topo.h"
+
+static uint32_t gen_topo_parallel_paths_port_scratch_size(uint32_t num_ports, uint32_t max_num_channels)
+{
+   uint32_t per_port_scratch_size = sizeof(gen_topo_port_scratch_data_t) + sizeof(capi_stream_data_v2_t *) +
+                                    (max_num_channels * (sizeof(uint32_t) + sizeof(capi_buf_t)));
+   return ALIGN_8_BYTES(num_ports * per_port_scratch_size);
+}
+
+/* Carves the scratch data, sdata pointers and per channel arrays out of blob_ptr, same layout as the topo's own
+ * process context (gen_topo_check_n_realloc_scratch_memory). */
+static void gen_topo_parallel_paths_assign_port_scratch(int8_t                        *blob_ptr,
+                                                        uint32_t                       num_ports,
+                                                        uint32_t                       max_num_channels,
+                                                        gen_topo_port_scratch_data_t **scratch_pptr,
+                                                        capi_stream_data_v2_t       ***sdata_ppptr)
+{
+   *scratch_pptr = (gen_topo_port_scratch_data_t *)blob_ptr;
+   blob_ptr += (num_ports * sizeof(gen_topo_port_scratch_data_t));
+
+   *sdata_ppptr = (capi_stream_data_v2_t **)blob_ptr;
+   blob_ptr += (num_ports * sizeof(capi_stream_data_v2_t *));
+
+   for (uint32_t idx = 0; idx < num_ports; idx++)
+   {
+      (*scratch_pptr)[idx].prev_actual_data_len = (uint32_t *)blob_ptr;
+      blob_ptr += (sizeof(uint32_t) * max_num_channels);
+
+      (*scratch_pptr)[idx].bufs = (capi_buf_t *)blob_ptr;
+      blob_ptr += (sizeof(capi_buf_t) * max_num_channels);
+   }
+}
+
+static void gen_topo_parallel_paths_free_contexts(gen_topo_parallel_paths_t *pp_ptr)
+{
+   // index 0 is the topo's own process context
+   for (uint32_t i = 1; i < pp_ptr->num_paths; i++)
+   {
+      MFREE_NULLIFY(pp_ptr->proc_context_pptr[i]);
+   }
+   MFREE_NULLIFY(pp_ptr->proc_context_pptr);
+   pp_ptr->num_paths = 0;
+}
+
+/**
+ * Creates (or resizes) the per path process contexts. Must be called synchronously with the data path thread,
+ * whenever the number of parallel paths changes.
+ */
+ar_result_t gen_topo_parallel_paths_create(gen_topo_t *topo_ptr, uint32_t num_paths)
+{
+   ar_result_t result = AR_EOK;
+   INIT_EXCEPTION_HANDLING
+
+   gen_topo_parallel_paths_t *pp_ptr = topo_ptr->parallel_paths_ptr;
+
+   if (NULL == pp_ptr)
+   {
+      MALLOC_MEMSET(pp_ptr, gen_topo_parallel_paths_t, sizeof(gen_topo_parallel_paths_t), topo_ptr->heap_id, result);
+      topo_ptr->parallel_paths_ptr = pp_ptr;
+      TRY(result, posal_mutex_create(&pp_ptr->lock, topo_ptr->heap_id));
+   }
+
+   if (num_paths == pp_ptr->num_paths)
+   {
+      return result;
+   }
+
+   gen_topo_parallel_paths_free_contexts(pp_ptr);
+
+   MALLOC_MEMSET(pp_ptr->proc_context_pptr,
+                 gen_topo_process_context_t *,
+                 num_paths * sizeof(gen_topo_process_context_t *),
+                 topo_ptr->heap_id,
+                 result);
+   pp_ptr->num_paths            = num_paths;
+   pp_ptr->proc_context_pptr[0] = &topo_ptr->proc_context;
+
+   TRY(result, gen_topo_parallel_paths_realloc_scratch_memory(topo_ptr));
+
+   TOPO_MSG(topo_ptr->gu.log_id, DBG_HIGH_PRIO, "Created process contexts for %lu parallel paths", num_paths);
+
+   CATCH(result, TOPO_MSG_PREFIX, topo_ptr->gu.log_id)
+   {
+      gen_topo_parallel_paths_destroy(topo_ptr);
+   }
+
+   return result;
+}
+
+void gen_topo_parallel_paths_destroy(gen_topo_t *topo_ptr)
+{
+   gen_topo_parallel_paths_t *pp_ptr = topo_ptr->parallel_paths_ptr;
+
+   if (NULL == pp_ptr)
+   {
+      return;
+   }
+
+   gen_topo_parallel_paths_free_contexts(pp_ptr);
+
+   if (pp_ptr->lock)
+   {
+      posal_mutex_destroy(&pp_ptr->lock);
+   }
+
+   MFREE_NULLIFY(topo_ptr->parallel_paths_ptr);
+}
+
+/**
+ * Reallocates the scratch memory of the per path process contexts to match the topo's process context.
+ * Called after the topo's scratch memory is reallocated (gen_topo_check_n_realloc_scratch_memory).
+ */
+ar_result_t gen_topo_parallel_paths_realloc_scratch_memory(gen_topo_t *topo_ptr)
+{
+   ar_result_t result = AR_EOK;
+   INIT_EXCEPTION_HANDLING
+
+   gen_topo_parallel_paths_t  *pp_ptr      = topo_ptr->parallel_paths_ptr;
+   gen_topo_process_context_t *main_pc_ptr = &topo_ptr->proc_context;
+
+   if (NULL == pp_ptr)
+   {
+      return result;
+   }
+
+   uint32_t in_scratch_size  = gen_topo_parallel_paths_port_scratch_size(main_pc_ptr->num_in_ports,
+                                                                        main_pc_ptr->max_num_channels);
+   uint32_t out_scratch_size = gen_topo_parallel_paths_port_scratch_size(main_pc_ptr->num_out_ports,
+                                                                         main_pc_ptr->max_num_channels);
+
+   for (uint32_t i = 1; i < pp_ptr->num_paths; i++)
+   {
+      gen_topo_process_context_t *pc_ptr = pp_ptr->proc_context_pptr[i];
+
+      if (pc_ptr && (pc_ptr->num_in_ports == main_pc_ptr->num_in_ports) &&
+          (pc_ptr->num_out_ports == main_pc_ptr->num_out_ports) &&
+          (pc_ptr->max_num_channels == main_pc_ptr->max_num_channels))
+      {
+         continue;
+      }
+
+      MFREE_NULLIFY(pp_ptr->proc_context_pptr[i]);
+
+      // context and its scratch memory are one allocation
+      MALLOC_MEMSET(pc_ptr,
+                    gen_topo_process_context_t,
+                    sizeof(gen_topo_process_context_t) + in_scratch_size + out_scratch_size,
+                    topo_ptr->heap_id,
+                    result);
+      pp_ptr->proc_context_pptr[i] = pc_ptr;
+
+      int8_t *blob_ptr = (int8_t *)(pc_ptr + 1);
+      gen_topo_parallel_paths_assign_port_scratch(blob_ptr,
+                                                  main_pc_ptr->num_in_ports,
+                                                  main_pc_ptr->max_num_channels,
+                                                  &pc_ptr->in_port_scratch_ptr,
+                                                  &pc_ptr->in_port_sdata_pptr);
+      gen_topo_parallel_paths_assign_port_scratch(blob_ptr + in_scratch_size,
+                                                  main_pc_ptr->num_out_ports,
+                                                  main_pc_ptr->max_num_channels,
+                                                  &pc_ptr->out_port_scratch_ptr,
+                                                  &pc_ptr->out_port_sdata_pptr);
+
+      pc_ptr->num_in_ports     = main_pc_ptr->num_in_ports;
+      pc_ptr->num_out_ports    = main_pc_ptr->num_out_ports;
+      pc_ptr->max_num_channels = main_pc_ptr->max_num_channels;
+   }
+
+   CATCH(result, TOPO_MSG_PREFIX, topo_ptr->gu.log_id)
+   {
+      // container falls back to processing the paths serially
+      gen_topo_parallel_paths_destroy(topo_ptr);
+   }
+
+   return result;
+}
+
+/**
+ * Switches the topo to per path process contexts. Container calls this on its own thread right before handing the
+ * paths to other threads; the topo process context must not be modified until gen_topo_parallel_paths_end.
+ */
+void gen_topo_parallel_paths_begin(gen_topo_t *topo_ptr)
+{
+   gen_topo_parallel_paths_t  *pp_ptr      = topo_ptr->parallel_paths_ptr;
+   gen_topo_process_context_t *main_pc_ptr = &topo_ptr->proc_context;
+
+   for (uint32_t i = 1; i < pp_ptr->num_paths; i++)
+   {
+      gen_topo_process_context_t *pc_ptr = pp_ptr->proc_context_pptr[i];
+
+      // ext port history is owned by the container thread, share it
+      pc_ptr->num_ext_in_ports                  = main_pc_ptr->num_ext_in_ports;
+      pc_ptr->num_ext_out_ports                 = main_pc_ptr->num_ext_out_ports;
+      pc_ptr->ext_in_port_scratch_ptr           = main_pc_ptr->ext_in_port_scratch_ptr;
+      pc_ptr->ext_out_port_scratch_ptr          = main_pc_ptr->ext_out_port_scratch_ptr;
+      pc_ptr->curr_trigger                      = main_pc_ptr->curr_trigger;
+      pc_ptr->err_print_time_in_this_process_ms = main_pc_ptr->err_print_time_in_this_process_ms;
+      pc_ptr->process_info                      = main_pc_ptr->process_info;
+   }
+
+   pp_ptr->is_active = TRUE;
+}
+
+/**
+ * Switches back to the topo process context after all paths are joined. Changes noted by the paths are merged
+ * into the topo's process info.
+ */
+void gen_topo_parallel_paths_end(gen_topo_t *topo_ptr)
+{
+   gen_topo_parallel_paths_t *pp_ptr           = topo_ptr->parallel_paths_ptr;
+   gen_topo_process_info_t   *process_info_ptr = &topo_ptr->proc_context.process_info;
+
+   pp_ptr->is_active = FALSE;
+
+   for (uint32_t i = 1; i < pp_ptr->num_paths; i++)
+   {
+      gen_topo_process_context_t *pc_ptr = pp_ptr->proc_context_pptr[i];
+
+      process_info_ptr->anything_changed |= pc_ptr->process_info.anything_changed;
+#ifdef USES_THIN_TOPO
+      process_info_ptr->atleast_one_inp_holds_ext_buffer |= pc_ptr->process_info.atleast_one_inp_holds_ext_buffer;
+#endif
+      topo_ptr->proc_context.err_print_time_in_this_process_ms =
+         MAX(topo_ptr->proc_context.err_print_time_in_this_process_ms, pc_ptr->err_print_time_in_this_process_ms);
+   }
+}
@@ -1204,7 +1204,7 @@ bool_t gen_topo_is_module_trigger_condition_satisfied(gen_topo_module_t *module_
 
    return gen_topo_is_module_data_trigger_condition_satisfied(module_ptr,
                                                               is_ext_trigger_not_satisfied_ptr,
-                                                              &topo_ptr->proc_context);
+                                                              gen_topo_get_proc_context(topo_ptr, module_ptr));
 }
 
 /**
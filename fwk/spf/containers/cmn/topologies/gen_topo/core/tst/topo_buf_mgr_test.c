@@ -17,6 +17,8 @@
 #include "ar_msg.h"
 #include "ar_ids.h"
 #include "topo_buf_mgr.h"
+#include "gen_topo.h"
+#include "gen_topo_buf_mgr.h"
 
 #ifdef ENABLE_BUF_MANAGER_TEST
 
@@ -27,16 +29,18 @@ extern "C" {
 static ar_result_t test_1()
 {
    ar_result_t result = AR_EOK;
-   void *      buf_mgr_ptr;
+   gen_topo_t  topo;
    int8_t *    buf1_ptr, *buf2_ptr;
    uint32_t    buf_size = 0;
 
-   result = topo_buf_manager_create(&buf_mgr_ptr, POSAL_HEAP_DEFAULT, 0);
+   memset(&topo, 0, sizeof(topo));
+   topo.buf_mgr.mode = TOPO_BUF_LOW_POWER;
+   result            = topo_buf_manager_init(&topo);
 
-   AR_MSG(DBG_HIGH_PRIO, "buf_mgr_test 1: topo_buf_manager_create buf_mgr_ptr: 0x%lx, result: %u", buf_mgr_ptr, result);
+   AR_MSG(DBG_HIGH_PRIO, "buf_mgr_test 1: topo_buf_manager_init result: %u", result);
 
    buf_size = 20;
-   result   = topo_buf_manager_get_buf(buf_mgr_ptr, &buf1_ptr, buf_size, 0);
+   result   = topo_buf_manager_get_buf(&topo, &buf1_ptr, buf_size);
 
    AR_MSG(DBG_HIGH_PRIO,
           "buf_mgr_test 1: topo_buf_manager_get_buf buf_size: %u buf_ptr: 0x%lx, result: %u",
@@ -45,7 +49,7 @@ static ar_result_t test_1()
           result);
 
    buf_size = 30;
-   result   = topo_buf_manager_get_buf(buf_mgr_ptr, &buf2_ptr, buf_size, 0);
+   result   = topo_buf_manager_get_buf(&topo, &buf2_ptr, buf_size);
 
    AR_MSG(DBG_HIGH_PRIO,
           "buf_mgr_test 1: topo_buf_manager_get_buf buf_size: %u buf_ptr: 0x%lx, result: %u",
@@ -53,17 +57,18 @@ static ar_result_t test_1()
           buf2_ptr,
           result);
 
-   topo_buf_manager_return_buf(buf_mgr_ptr, buf1_ptr, 0);
+   topo_buf_manager_return_buf(&topo, buf1_ptr);
 
    AR_MSG(DBG_HIGH_PRIO, "buf_mgr_test 1: topo_buf_manager_return_buf returned buf1_ptr: 0x%lx", buf1_ptr);
 
-   topo_buf_manager_return_buf(buf_mgr_ptr, buf2_ptr, 0);
+   topo_buf_manager_return_buf(&topo, buf2_ptr);
 
    AR_MSG(DBG_HIGH_PRIO, "buf_mgr_test 1: topo_buf_manager_return_buf returned buf2_ptr: 0x%lx", buf2_ptr);
 
-   topo_buf_manager_destroy(buf_mgr_ptr, 0);
+   topo_buf_manager_destroy_all_unused_buffers(&topo, TRUE);
+   topo_buf_manager_deinit(&topo);
 
-   AR_MSG(DBG_HIGH_PRIO, "buf_mgr_test 1: topo_buf_manager_destroy destroyed buf_mgr_ptr: 0x%lx", buf_mgr_ptr);
+   AR_MSG(DBG_HIGH_PRIO, "buf_mgr_test 1: topo_buf_manager_deinit done");
 
    return result;
 }
@@ -71,16 +76,18 @@ static ar_result_t test_1()
 static ar_result_t test_2()
 {
    ar_result_t result = AR_EOK;
-   void *      buf_mgr_ptr;
+   gen_topo_t  topo;
    int8_t *    buf1_ptr, *buf2_ptr;
    uint32_t    buf_size = 0;
 
-   result = topo_buf_manager_create(&buf_mgr_ptr, POSAL_HEAP_DEFAULT, 0);
+   memset(&topo, 0, sizeof(topo));
+   topo.buf_mgr.mode = TOPO_BUF_LOW_POWER;
+   result            = topo_buf_manager_init(&topo);
 
-   AR_MSG(DBG_HIGH_PRIO, "buf_mgr_test 1: topo_buf_manager_create buf_mgr_ptr: 0x%lx, result: %u", buf_mgr_ptr, result);
+   AR_MSG(DBG_HIGH_PRIO, "buf_mgr_test 1: topo_buf_manager_init result: %u", result);
 
    buf_size = 20;
-   result   = topo_buf_manager_get_buf(buf_mgr_ptr, &buf1_ptr, buf_size, 0);
+   result   = topo_buf_manager_get_buf(&topo, &buf1_ptr, buf_size);
 
    AR_MSG(DBG_HIGH_PRIO,
           "buf_mgr_test 2: topo_buf_manager_get_buf buf_size: %u buf_ptr: 0x%lx, result: %u",
@@ -89,7 +96,7 @@ static ar_result_t test_2()
           result);
 
    buf_size = 30;
-   result   = topo_buf_manager_get_buf(buf_mgr_ptr, &buf2_ptr, buf_size, 0);
+   result   = topo_buf_manager_get_buf(&topo, &buf2_ptr, buf_size);
 
    AR_MSG(DBG_HIGH_PRIO,
           "buf_mgr_test 2: topo_buf_manager_get_buf buf_size: %u buf_ptr: 0x%lx, result: %u",
@@ -97,16 +104,16 @@ static ar_result_t test_2()
           buf2_ptr,
           result);
 
-   topo_buf_manager_return_buf(buf_mgr_ptr, buf1_ptr, 0);
+   topo_buf_manager_return_buf(&topo, buf1_ptr);
 
    AR_MSG(DBG_HIGH_PRIO, "buf_mgr_test 2: topo_buf_manager_return_buf returned buf_ptr: 0x%lx", buf1_ptr);
 
-   topo_buf_manager_return_buf(buf_mgr_ptr, buf2_ptr, 0);
+   topo_buf_manager_return_buf(&topo, buf2_ptr);
 
    AR_MSG(DBG_HIGH_PRIO, "buf_mgr_test 2: topo_buf_manager_return_buf  returned buf_ptr: 0x%lx", buf2_ptr);
 
    buf_size = 40;
-   result   = topo_buf_manager_get_buf(buf_mgr_ptr, &buf1_ptr, buf_size, 0);
+   result   = topo_buf_manager_get_buf(&topo, &buf1_ptr, buf_size);
 
    AR_MSG(DBG_HIGH_PRIO,
           "buf_mgr_test 2: topo_buf_manager_get_buf buf_size: %u buf_ptr: 0x%lx, result: %u",
@@ -115,7 +122,7 @@ static ar_result_t test_2()
           result);
 
    buf_size = 30;
-   result   = topo_buf_manager_get_buf(buf_mgr_ptr, &buf2_ptr, buf_size, 0);
+   result   = topo_buf_manager_get_buf(&topo, &buf2_ptr, buf_size);
 
    AR_MSG(DBG_HIGH_PRIO,
           "buf_mgr_test 2: topo_buf_manager_get_buf buf_size: %u buf_ptr: 0x%lx, result: %u",
@@ -123,17 +130,18 @@ static ar_result_t test_2()
           buf2_ptr,
           result);
 
-   topo_buf_manager_return_buf(buf_mgr_ptr, buf1_ptr, 0);
+   topo_buf_manager_return_buf(&topo, buf1_ptr);
 
    AR_MSG(DBG_HIGH_PRIO, "buf_mgr_test 2: topo_buf_manager_return_buf returned buf_ptr: 0x%lx", buf1_ptr);
 
-   topo_buf_manager_return_buf(buf_mgr_ptr, buf2_ptr, 0);
+   topo_buf_manager_return_buf(&topo, buf2_ptr);
 
    AR_MSG(DBG_HIGH_PRIO, "buf_mgr_test 2: topo_buf_manager_return_buf  returned buf_ptr: 0x%lx", buf2_ptr);
 
-   topo_buf_manager_destroy(buf_mgr_ptr, 0);
+   topo_buf_manager_destroy_all_unused_buffers(&topo, TRUE);
+   topo_buf_manager_deinit(&topo);
 
-   AR_MSG(DBG_HIGH_PRIO, "buf_mgr_test 2: topo_buf_manager_destroy destroyed buf_mgr_ptr: 0x%lx", buf_mgr_ptr);
+   AR_MSG(DBG_HIGH_PRIO, "buf_mgr_test 2: topo_buf_manager_deinit done");
 
    return result;
 }
@@ -141,16 +149,18 @@ static ar_result_t test_2()
 static ar_result_t test_3()
 {
    ar_result_t result = AR_EOK;
-   void *      buf_mgr_ptr;
+   gen_topo_t  topo;
    int8_t *    buf1_ptr, *buf2_ptr;
    uint32_t    buf_size = 0;
 
-   result = topo_buf_manager_create(&buf_mgr_ptr, POSAL_HEAP_DEFAULT, 0);
+   memset(&topo, 0, sizeof(topo));
+   topo.buf_mgr.mode = TOPO_BUF_LOW_POWER;
+   result            = topo_buf_manager_init(&topo);
 
-   AR_MSG(DBG_HIGH_PRIO, "buf_mgr_test 3: topo_buf_manager_create buf_mgr_ptr: 0x%lx, result: %u", buf_mgr_ptr, result);
+   AR_MSG(DBG_HIGH_PRIO, "buf_mgr_test 3: topo_buf_manager_init result: %u", result);
 
    buf_size = 20;
-   result   = topo_buf_manager_get_buf(buf_mgr_ptr, &buf1_ptr, buf_size, 0);
+   result   = topo_buf_manager_get_buf(&topo, &buf1_ptr, buf_size);
 
    AR_MSG(DBG_HIGH_PRIO,
           "buf_mgr_test 3: topo_buf_manager_get_buf buf_size: %u buf_ptr: 0x%lx, result: %u",
@@ -158,14 +168,14 @@ static ar_result_t test_3()
           buf1_ptr,
           result);
 
-   topo_buf_manager_return_buf(buf_mgr_ptr, buf1_ptr, 0);
+   topo_buf_manager_return_buf(&topo, buf1_ptr);
 
    AR_MSG(DBG_HIGH_PRIO, "buf_mgr_test 3: topo_buf_manager_return_buf returned buf1_ptr: 0x%lx", buf1_ptr);
 
    for (uint32_t i = 0; i < 25; i++)
    {
       buf_size = 30;
-      result   = topo_buf_manager_get_buf(buf_mgr_ptr, &buf2_ptr, buf_size, 0);
+      result   = topo_buf_manager_get_buf(&topo, &buf2_ptr, buf_size);
 
       AR_MSG(DBG_HIGH_PRIO,
              "buf_mgr_test 3: topo_buf_manager_get_buf buf_size: %u buf_ptr: 0x%lx, result: %u",
@@ -173,14 +183,177 @@ static ar_result_t test_3()
              buf2_ptr,
              result);
 
-      topo_buf_manager_return_buf(buf_mgr_ptr, buf2_ptr, 0);
+      topo_buf_manager_return_buf(&topo, buf2_ptr);
 
       AR_MSG(DBG_HIGH_PRIO, "buf_mgr_test 3: topo_buf_manager_return_buf returned buf2_ptr: 0x%lx", buf2_ptr);
    }
 
-   topo_buf_manager_destroy(buf_mgr_ptr, 0);
+   topo_buf_manager_destroy_all_unused_buffers(&topo, TRUE);
+   topo_buf_manager_deinit(&topo);
 
-   AR_MSG(DBG_HIGH_PRIO, "buf_mgr_test 3: topo_buf_manager_destroy destroyed buf_mgr_ptr: 0x%lx", buf_mgr_ptr);
+   AR_MSG(DBG_HIGH_PRIO, "buf_mgr_test 3: topo_buf_manager_deinit done");
+
+   return result;
+}
+
+#define TEST_4_BUF_SIZE (64)
+#define TEST_4_NUM_OUTPUTS (3)
+
+static void test_4_fill(int8_t *ptr, int8_t val)
+{
+   for (uint32_t i = 0; i < TEST_4_BUF_SIZE; i++)
+   {
+      ptr[i] = (int8_t)(val + i);
+   }
+}
+
+static bool_t test_4_check(int8_t *ptr, int8_t val)
+{
+   for (uint32_t i = 0; i < TEST_4_BUF_SIZE; i++)
+   {
+      if (ptr[i] != (int8_t)(val + i))
+      {
+         return FALSE;
+      }
+   }
+   return TRUE;
+}
+
+static void test_4_init_port(gen_topo_common_port_t *cmn_port_ptr, topo_buf_t *buf_ptr)
+{
+   cmn_port_ptr->bufs_ptr            = buf_ptr;
+   cmn_port_ptr->sdata.buf_ptr       = (capi_buf_t *)buf_ptr;
+   cmn_port_ptr->sdata.bufs_num      = 1;
+   cmn_port_ptr->max_buf_len         = TEST_4_BUF_SIZE;
+   cmn_port_ptr->max_buf_len_per_buf = TEST_4_BUF_SIZE;
+}
+
+/* input port of a downstream module takes over the buffer of the connected output, as in
+   gen_topo_check_get_in_buf_from_buf_mgr followed by returning the output buffer. */
+static void test_4_move_to_input(gen_topo_t *topo_ptr, gen_topo_common_port_t *out_ptr, gen_topo_input_port_t *in_ptr)
+{
+   in_ptr->common.bufs_ptr[0]         = out_ptr->bufs_ptr[0];
+   in_ptr->common.flags.buf_origin    = out_ptr->flags.buf_origin;
+   in_ptr->common.flags.is_shared_buf = out_ptr->flags.is_shared_buf;
+   gen_topo_buf_mgr_wrapper_inc_ref_count(&in_ptr->common);
+   gen_topo_return_one_buf_mgr_buf(topo_ptr, out_ptr, 0, 0);
+}
+
+/* Splitter shares its input with 3 outputs (INTF_EXTN_SHARED_OUTPUT_BUFFER). Downstream:
+   - module A writes to its input in place, it must get a private copy and the other outputs must not see its writes.
+   - module B declares a read-only input, it must process the shared buffer without a copy.
+   - module C is the last user, it gets the buffer without a copy and may modify it. */
+static ar_result_t test_4()
+{
+   ar_result_t            result = AR_EOK;
+   gen_topo_t             topo;
+   gen_topo_module_t      a_module, b_module, c_module;
+   gen_topo_input_port_t  split_in, a_in, b_in, c_in;
+   gen_topo_output_port_t split_out[TEST_4_NUM_OUTPUTS];
+   topo_buf_t             split_in_buf, split_out_buf[TEST_4_NUM_OUTPUTS], a_buf, b_buf, c_buf;
+   uint32_t               dummy_capi;
+   int8_t *               shared_ptr;
+
+   memset(&topo, 0, sizeof(topo));
+   memset(&a_module, 0, sizeof(a_module));
+   memset(&b_module, 0, sizeof(b_module));
+   memset(&c_module, 0, sizeof(c_module));
+   memset(&split_in, 0, sizeof(split_in));
+   memset(&a_in, 0, sizeof(a_in));
+   memset(&b_in, 0, sizeof(b_in));
+   memset(&c_in, 0, sizeof(c_in));
+   memset(split_out, 0, sizeof(split_out));
+   memset(&split_in_buf, 0, sizeof(split_in_buf));
+   memset(split_out_buf, 0, sizeof(split_out_buf));
+   memset(&a_buf, 0, sizeof(a_buf));
+   memset(&b_buf, 0, sizeof(b_buf));
+   memset(&c_buf, 0, sizeof(c_buf));
+
+   topo.buf_mgr.mode = TOPO_BUF_LOW_POWER;
+   topo_buf_manager_init(&topo);
+
+   a_module.capi_ptr                      = (capi_t *)&dummy_capi;
+   b_module.capi_ptr                      = (capi_t *)&dummy_capi;
+   b_module.flags.supports_shared_out_buf = TRUE;
+   c_module.capi_ptr                      = (capi_t *)&dummy_capi;
+
+   test_4_init_port(&split_in.common, &split_in_buf);
+   test_4_init_port(&a_in.common, &a_buf);
+   test_4_init_port(&b_in.common, &b_buf);
+   test_4_init_port(&c_in.common, &c_buf);
+
+   if (AR_EOK != gen_topo_buf_mgr_wrapper_get_buf(&topo, &split_in.common))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "buf_mgr_test 4: get buf failed");
+      return AR_EFAILED;
+   }
+   shared_ptr = split_in.common.bufs_ptr[0].data_ptr;
+   test_4_fill(shared_ptr, 1);
+
+   // splitter process: all outputs refer to the input buffer, then the consumed input is returned
+   for (uint32_t i = 0; i < TEST_4_NUM_OUTPUTS; i++)
+   {
+      test_4_init_port(&split_out[i].common, &split_out_buf[i]);
+      split_out[i].common.bufs_ptr[0]         = split_in.common.bufs_ptr[0];
+      split_out[i].common.flags.buf_origin    = GEN_TOPO_BUF_ORIGIN_BUF_MGR;
+      split_out[i].common.flags.is_shared_buf = TRUE;
+      gen_topo_buf_mgr_wrapper_inc_ref_count(&split_out[i].common);
+   }
+   split_in.common.flags.is_shared_buf = TRUE;
+   gen_topo_return_one_buf_mgr_buf(&topo, &split_in.common, 0, 0);
+
+   // A modifies its input in place
+   test_4_move_to_input(&topo, &split_out[0].common, &a_in);
+   result |= gen_topo_check_unshare_in_buf_before_process(&topo, &a_module, &a_in);
+   if ((shared_ptr == a_in.common.bufs_ptr[0].data_ptr) || a_in.common.flags.is_shared_buf ||
+       !test_4_check(a_in.common.bufs_ptr[0].data_ptr, 1))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "buf_mgr_test 4: in place consumer did not get a private copy");
+      result = AR_EFAILED;
+   }
+   test_4_fill(a_in.common.bufs_ptr[0].data_ptr, 100);
+
+   // B only reads its input
+   test_4_move_to_input(&topo, &split_out[1].common, &b_in);
+   result |= gen_topo_check_unshare_in_buf_before_process(&topo, &b_module, &b_in);
+   if ((shared_ptr != b_in.common.bufs_ptr[0].data_ptr) || !test_4_check(shared_ptr, 1))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "buf_mgr_test 4: read-only consumer got a copy or corrupted data");
+      result = AR_EFAILED;
+   }
+   gen_topo_return_one_buf_mgr_buf(&topo, &b_in.common, 0, 0);
+
+   // C is the last user of the shared buffer
+   test_4_move_to_input(&topo, &split_out[2].common, &c_in);
+   result |= gen_topo_check_unshare_in_buf_before_process(&topo, &c_module, &c_in);
+   if ((shared_ptr != c_in.common.bufs_ptr[0].data_ptr) || c_in.common.flags.is_shared_buf ||
+       (1 != gen_topo_buf_mgr_wrapper_get_ref_count(&c_in.common)) || !test_4_check(shared_ptr, 1))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "buf_mgr_test 4: last consumer did not get the buffer as is");
+      result = AR_EFAILED;
+   }
+
+   if (!test_4_check(a_in.common.bufs_ptr[0].data_ptr, 100))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "buf_mgr_test 4: private copy corrupted");
+      result = AR_EFAILED;
+   }
+
+   gen_topo_return_one_buf_mgr_buf(&topo, &a_in.common, 0, 0);
+   gen_topo_return_one_buf_mgr_buf(&topo, &c_in.common, 0, 0);
+
+   // shared buffer and one private copy, all returned
+   if ((2 != topo.buf_mgr.total_num_bufs_allocated) || (0 != topo.buf_mgr.num_used_buffers))
+   {
+      AR_MSG(DBG_ERROR_PRIO,
+             "buf_mgr_test 4: %lu buffers allocated, %lu still in use",
+             topo.buf_mgr.total_num_bufs_allocated,
+             topo.buf_mgr.num_used_buffers);
+      result = AR_EFAILED;
+   }
+
+   topo_buf_manager_destroy_all_unused_buffers(&topo, TRUE);
+   topo_buf_manager_deinit(&topo);
 
    return result;
 }
@@ -201,6 +374,10 @@ ar_result_t buf_mgr_test()
    AR_MSG(DBG_HIGH_PRIO, "buf_mgr_test: test 3 result: %d", local_result);
    result |= local_result;
 
+   local_result = test_4();
+   AR_MSG(DBG_HIGH_PRIO, "buf_mgr_test: test 4 result: %d", local_result);
+   result |= local_result;
+
    return result;
 }
 
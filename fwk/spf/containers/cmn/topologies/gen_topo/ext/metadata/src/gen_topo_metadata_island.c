@@ -13,6 +13,7 @@
 
 #include "gen_topo.h"
 #include "gen_topo_capi.h"
+#include "gen_topo_buf_mgr.h"
 #include "spf_ref_counter.h"
 #include "thin_topo_inline.h"
 
@@ -237,6 +238,9 @@ static ar_result_t gen_topo_check_eos_md_update_defer_voting_flag( gu_cmn_port_t
    ar_result_t result = AR_EOK;
 
    gen_topo_t *topo_ptr = (gen_topo_t *)((gen_topo_module_t *)cmn_port_ptr->module_ptr)->topo_ptr;
+
+   // topo flags are shared by all parallel paths
+   bool_t is_locked = gen_topo_parallel_paths_lock(topo_ptr);
    if (gen_topo_does_eos_skip_voting(md_ptr))
    {
       topo_ptr->flags.defer_voting_on_dfs_change = TRUE;
@@ -245,6 +249,7 @@ static ar_result_t gen_topo_check_eos_md_update_defer_voting_flag( gu_cmn_port_t
    {
       topo_ptr->flags.defer_voting_on_dfs_change = FALSE;
    }
+   gen_topo_parallel_paths_unlock(topo_ptr, is_locked);
 
    TOPO_MSG_ISLAND(topo_ptr->gu.log_id,
                    DBG_HIGH_PRIO,
@@ -1522,8 +1527,8 @@ ar_result_t gen_topo_metadata_prop_for_sink(gen_topo_module_t *module_ptr, capi_
                                           &output_stream_ptr->metadata_list_ptr,
                                           FALSE /* is_dropped */);
 
-   gen_topo_t *topo_ptr                                 = module_ptr->topo_ptr;
-   topo_ptr->proc_context.process_info.anything_changed = TRUE;
+   gen_topo_process_context_t *pc_ptr  = gen_topo_get_proc_context(module_ptr->topo_ptr, module_ptr);
+   pc_ptr->process_info.anything_changed = TRUE;
 
    return result;
 }
@@ -2200,6 +2205,15 @@ ar_result_t gen_topo_push_zeros_at_eos_util_(gen_topo_t *           topo_ptr,
 
    // Note: Even for packetized formats this pushes zeros instead of null bursts.
 
+   // copy-on-write: zeros are written into the input buffer.
+   if (AR_DID_FAIL(result = gen_topo_check_unshare_buf_mgr_buf(topo_ptr,
+                                                               &in_port_ptr->common,
+                                                               module_ptr->gu.module_instance_id,
+                                                               in_port_ptr->gu.cmn.id)))
+   {
+      return result;
+   }
+
    uint32_t    amount_of_zero_pushed_per_ch = 0; // bytes
    topo_buf_t *bufs_ptr                     = in_port_ptr->common.bufs_ptr;
    uint32_t    ch                           = in_port_ptr->common.media_fmt_ptr->pcm.num_channels;
@@ -74,6 +74,7 @@ LOCAL_SRC_FILES := \
     core/src/gen_cntr_fwk_extn_utils.c \
     core/src/gen_cntr_fwk_extn_utils_island.c \
     core/src/gen_cntr_island.c \
+    core/src/gen_cntr_parallel_paths.c \
     core/src/gen_cntr_pm.c \
     core/src/gen_cntr_st_handler.c \
     core/src/gen_cntr_st_handler_island.c \
@@ -113,6 +114,9 @@ endif
 
 LOCAL_CFLAGS += -flto -O3 -Wall -ffixed-x18 -std=c17
 
+# spf_thread_pool is built with libspf_utils, enables processing parallel paths concurrently
+LOCAL_CFLAGS += -DUSES_SPF_THREAD_POOL
+
 ifeq ($(CONFIG_APM_THIN_TOPO),y)
     LOCAL_CFLAGS += -DUSES_THIN_TOPO
 endif
@@ -201,6 +201,7 @@ ar_result_t gen_cntr_create(cntr_cmn_init_params_t *init_params_ptr, spf_handle_
    me_ptr->cu.configured_thread_prio                = APM_CONT_PRIO_IGNORE; // Assume configured priority, to be updated by tools
    me_ptr->cu.configured_sched_policy               = APM_CONT_SCHED_POLICY_IGNORE;
    me_ptr->cu.configured_core_affinity              = APM_CONT_CORE_AFFINITY_IGNORE;
+   me_ptr->cu.configured_num_path_workers           = APM_CONT_PARALLEL_PATHS_DISABLED;
 
 #ifdef CONTAINER_ASYNC_CMD_HANDLING
    posal_mutex_create(&me_ptr->cu.gu_ptr->critical_section_lock_, my_heap_id);
@@ -349,6 +350,8 @@ ar_result_t gen_cntr_destroy(cu_base_t *base_ptr, void *temp)
    // deinit.
    cu_deinit_external_ports(&me_ptr->cu, FALSE /*b_ignore_ports_from_sg_close*/, TRUE /*force_deinit_all_ports*/);
 
+   gen_cntr_parallel_paths_destroy(me_ptr);
+
    gen_topo_destroy_topo(&me_ptr->topo);
 
    gu_destroy_graph(me_ptr->cu.gu_ptr, TRUE /*b_destroy_everything*/);
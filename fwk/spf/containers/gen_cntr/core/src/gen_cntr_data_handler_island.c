@@ -776,40 +776,48 @@ static ar_result_t gen_cntr_data_process_one_frame(gen_cntr_t *me_ptr)
       }
    }
 
-   for (uint8_t i = 0; i < me_ptr->cu.gu_ptr->num_parallel_paths; i++)
+   if (gen_cntr_parallel_paths_can_process(me_ptr))
    {
-      gu_module_list_t *start_module_list_ptr = me_ptr->topo.started_sorted_module_list_ptr;
+      result = gen_cntr_parallel_paths_process(me_ptr, &mf_th_ps_event);
+   }
+   else
+   {
+      for (uint8_t i = 0; i < me_ptr->cu.gu_ptr->num_parallel_paths; i++)
+      {
+         gu_module_list_t *start_module_list_ptr = me_ptr->topo.started_sorted_module_list_ptr;
 
-      // if there was switch from thin topo to gen topo get the module from
-      // which process needs to continue.
-      thin_topo_check_get_gen_topo_next_proc_module(&me_ptr->topo,
-                                                    &start_module_list_ptr);
+         // if there was switch from thin topo to gen topo get the module from
+         // which process needs to continue.
+         thin_topo_check_get_gen_topo_next_proc_module(&me_ptr->topo,
+                                                       &start_module_list_ptr);
 
-      if (0 == me_ptr->wait_mask_arr[i])
-      {
-         while (TRUE)
+         if (0 == me_ptr->wait_mask_arr[i])
          {
-            // Flag to indicate Media format, threshold or process state change event
-            mf_th_ps_event = FALSE;
-            result      = gen_topo_topo_process(&me_ptr->topo, &start_module_list_ptr, &i);
-
-            // here MF must propagate from next module, starting from current module overwrites any data that module
-            // might have outputed in this call.
-            gen_cntr_handle_process_events_and_flags(me_ptr,
-                                                     process_info_ptr,
-                                                     &mf_th_ps_event,
-                                                     (start_module_list_ptr ? start_module_list_ptr->next_ptr : NULL));
-
-            if (mf_th_ps_event && (NULL != start_module_list_ptr))
-            {
-               GEN_CNTR_MSG(me_ptr->topo.gu.log_id,
-                            DBG_LOW_PRIO,
-                            "Looping back to topo process from module 0x%08lX ",
-                            start_module_list_ptr->module_ptr->module_instance_id);
-            }
-            else
+            while (TRUE)
             {
-               break;
+               // Flag to indicate Media format, threshold or process state change event
+               mf_th_ps_event = FALSE;
+               result      = gen_topo_topo_process(&me_ptr->topo, &start_module_list_ptr, &i);
+
+               // here MF must propagate from next module, starting from current module overwrites any data that module
+               // might have outputed in this call.
+               gen_cntr_handle_process_events_and_flags(me_ptr,
+                                                        process_info_ptr,
+                                                        &mf_th_ps_event,
+                                                        (start_module_list_ptr ? start_module_list_ptr->next_ptr
+                                                                               : NULL));
+
+               if (mf_th_ps_event && (NULL != start_module_list_ptr))
+               {
+                  GEN_CNTR_MSG(me_ptr->topo.gu.log_id,
+                               DBG_LOW_PRIO,
+                               "Looping back to topo process from module 0x%08lX ",
+                               start_module_list_ptr->module_ptr->module_instance_id);
+               }
+               else
+               {
+                  break;
+               }
             }
          }
       }
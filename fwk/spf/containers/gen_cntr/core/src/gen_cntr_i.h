@@ -39,6 +39,7 @@ INCLUDE FILES FOR MODULE
 
 #include "spf_ref_counter.h"
 #include "spf_svc_utils.h"
+#include "spf_thread_pool.h"
 
 #include "posal_power_mgr.h"
 #include "posal_intrinsics.h"
@@ -399,6 +400,27 @@ typedef struct gen_cntr_async_signal_t
 
 } gen_cntr_async_signal_t;
 
+/** Job for processing one parallel path on the thread pool. */
+typedef struct gen_cntr_path_job_t
+{
+   spf_thread_pool_job_t job;                   /**< Job pushed to the thread pool, context is this struct */
+   gen_cntr_t           *me_ptr;
+   gu_module_list_t     *start_module_list_ptr; /**< Module from which the path is processed, updated by topo process */
+   uint8_t               path_index;
+   bool_t                is_ready;              /**< Path is processed in the current frame */
+} gen_cntr_path_job_t;
+
+/** Created only if the container is configured with APM_CONTAINER_PROP_ID_PARALLEL_PATHS and has more than one
+ *  parallel path. */
+typedef struct gen_cntr_parallel_paths_t
+{
+   spf_thread_pool_inst_t *tp_ptr;      /**< Dedicated thread pool which processes the paths */
+   posal_channel_t         channel_ptr; /**< Channel on which container waits for the jobs, bit i is job i */
+   uint32_t                num_workers;
+   uint32_t                num_jobs;    /**< One job per parallel path */
+   gen_cntr_path_job_t    *jobs_ptr;
+} gen_cntr_parallel_paths_t;
+
 typedef struct gen_cntr_flags_t
 {
    uint32_t is_any_ext_in_mf_pending : 1; /**< TRUE only if any external input port MF is pending.
@@ -419,6 +441,7 @@ typedef struct gen_cntr_t
    uint32_t         *wait_mask_arr;             /**< wait mask for each parallel path. (me_ptr->cu.gu_ptr->num_parallel_paths)
                                                      this is bitmask where each bit corresponds to an external port.*/
    spf_list_node_t  *async_signal_list_ptr;     /**< list of async signals created for the container, node type is gen_cntr_async_signal_t */
+   gen_cntr_parallel_paths_t *parallel_paths_ptr; /**< For processing parallel paths concurrently. NULL if not enabled */
 } gen_cntr_t;
 
 typedef struct gen_cntr_render_eos_cb_context_t
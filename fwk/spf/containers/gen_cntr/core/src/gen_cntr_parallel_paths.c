@@ -0,0 +1,348 @@
+/**
+ * \file gen_cntr_parallel_paths.c
+ * \brief
+ *     This file contains functions for processing the parallel paths of the container concurrently.
+ *
+ *     Parallel paths don't share any module, so gen_topo_topo_process of different paths can run on different threads
+ *     once the topo switches to per path process contexts (gen_topo_parallel_paths_begin). The container thread
+ *     processes one path and the dedicated thread pool processes the others. Events raised during process are handled
+ *     after all the paths are joined, one path after the other, same as when the paths are processed serially.
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "gen_cntr_i.h"
+
+#ifdef USES_SPF_THREAD_POOL
+
+// jobs are joined on the bits of one channel
+#define GEN_CNTR_MAX_PARALLEL_PATH_JOBS 32
+
+static ar_result_t gen_cntr_parallel_path_job_func(void *job_context_ptr)
+{
+   gen_cntr_path_job_t *path_job_ptr = (gen_cntr_path_job_t *)job_context_ptr;
+
+   return gen_topo_topo_process(&path_job_ptr->me_ptr->topo,
+                                &path_job_ptr->start_module_list_ptr,
+                                &path_job_ptr->path_index);
+}
+
+static void gen_cntr_parallel_paths_free_jobs(gen_cntr_parallel_paths_t *pp_ptr)
+{
+   if (pp_ptr->jobs_ptr)
+   {
+      for (uint32_t i = 0; i < pp_ptr->num_jobs; i++)
+      {
+         if (pp_ptr->jobs_ptr[i].job.job_signal_ptr)
+         {
+            posal_signal_destroy(&pp_ptr->jobs_ptr[i].job.job_signal_ptr);
+         }
+      }
+      MFREE_NULLIFY(pp_ptr->jobs_ptr);
+   }
+
+   if (pp_ptr->channel_ptr)
+   {
+      posal_channel_destroy(&pp_ptr->channel_ptr);
+   }
+
+   pp_ptr->num_jobs = 0;
+}
+
+static ar_result_t gen_cntr_parallel_paths_create_jobs(gen_cntr_t *me_ptr, uint32_t num_jobs)
+{
+   ar_result_t result = AR_EOK;
+   INIT_EXCEPTION_HANDLING
+   gen_cntr_parallel_paths_t *pp_ptr = me_ptr->parallel_paths_ptr;
+
+   gen_cntr_parallel_paths_free_jobs(pp_ptr);
+
+   TRY(result, posal_channel_create(&pp_ptr->channel_ptr, me_ptr->cu.heap_id));
+
+   MALLOC_MEMSET(pp_ptr->jobs_ptr,
+                 gen_cntr_path_job_t,
+                 num_jobs * sizeof(gen_cntr_path_job_t),
+                 me_ptr->cu.heap_id,
+                 result);
+   pp_ptr->num_jobs = num_jobs;
+
+   for (uint32_t i = 0; i < num_jobs; i++)
+   {
+      gen_cntr_path_job_t *path_job_ptr = &pp_ptr->jobs_ptr[i];
+
+      path_job_ptr->me_ptr              = me_ptr;
+      path_job_ptr->path_index          = (uint8_t)i;
+      path_job_ptr->job.job_func_ptr    = gen_cntr_parallel_path_job_func;
+      path_job_ptr->job.job_context_ptr = path_job_ptr;
+
+      TRY(result, posal_signal_create(&path_job_ptr->job.job_signal_ptr, me_ptr->cu.heap_id));
+      TRY(result, posal_channel_add_signal(pp_ptr->channel_ptr, path_job_ptr->job.job_signal_ptr, (1 << i)));
+   }
+
+   CATCH(result, GEN_CNTR_MSG_PREFIX, me_ptr->topo.gu.log_id)
+   {
+   }
+
+   return result;
+}
+
+void gen_cntr_parallel_paths_destroy(gen_cntr_t *me_ptr)
+{
+   gen_cntr_parallel_paths_t *pp_ptr = me_ptr->parallel_paths_ptr;
+
+   gen_topo_parallel_paths_destroy(&me_ptr->topo);
+
+   if (NULL == pp_ptr)
+   {
+      return;
+   }
+
+   if (pp_ptr->tp_ptr)
+   {
+      spf_thread_pool_release_instance(&pp_ptr->tp_ptr, me_ptr->topo.gu.log_id);
+   }
+
+   gen_cntr_parallel_paths_free_jobs(pp_ptr);
+
+   MFREE_NULLIFY(me_ptr->parallel_paths_ptr);
+}
+
+/**
+ * Creates, resizes or destroys the thread pool and jobs as per the current number of parallel paths.
+ * Caller's responsibility to call this function synchronously with the main data processing thread.
+ * On failure the paths are processed serially.
+ */
+void gen_cntr_parallel_paths_update(gen_cntr_t *me_ptr)
+{
+   ar_result_t result = AR_EOK;
+   INIT_EXCEPTION_HANDLING
+   uint32_t num_paths = me_ptr->topo.gu.num_parallel_paths;
+
+   if ((APM_CONT_PARALLEL_PATHS_DISABLED == me_ptr->cu.configured_num_path_workers) ||
+       POSAL_IS_ISLAND_HEAP_ID(me_ptr->cu.heap_id) || (num_paths < 2) || (num_paths > GEN_CNTR_MAX_PARALLEL_PATH_JOBS))
+   {
+      gen_cntr_parallel_paths_destroy(me_ptr);
+      return;
+   }
+
+   // container thread processes one of the paths
+   uint32_t num_workers = MIN(me_ptr->cu.configured_num_path_workers, num_paths - 1);
+   uint32_t stack_size  = MAX(me_ptr->cu.actual_stack_size, SPF_DEFAULT_THREAD_POOL_STACK_SIZE);
+
+   if (NULL == me_ptr->parallel_paths_ptr)
+   {
+      int32_t thread_prio = 0;
+
+      MALLOC_MEMSET(me_ptr->parallel_paths_ptr,
+                    gen_cntr_parallel_paths_t,
+                    sizeof(gen_cntr_parallel_paths_t),
+                    me_ptr->cu.heap_id,
+                    result);
+
+      // workers run at the container priority (without any bump up), they do the same work as the container thread.
+      gen_cntr_get_set_thread_priority(me_ptr, &thread_prio, FALSE /*should_set*/, 1 /*bump_up_factor*/, 0);
+
+      TRY(result,
+          spf_thread_pool_get_instance(&me_ptr->parallel_paths_ptr->tp_ptr,
+                                       me_ptr->cu.heap_id,
+                                       (posal_thread_prio_t)thread_prio,
+                                       TRUE /*is_dedicated_pool*/,
+                                       stack_size,
+                                       num_workers,
+                                       me_ptr->topo.gu.log_id));
+      me_ptr->parallel_paths_ptr->num_workers = num_workers;
+   }
+   else if (num_workers != me_ptr->parallel_paths_ptr->num_workers)
+   {
+      TRY(result,
+          spf_thread_pool_update_instance(&me_ptr->parallel_paths_ptr->tp_ptr,
+                                          stack_size,
+                                          num_workers,
+                                          me_ptr->topo.gu.log_id));
+      me_ptr->parallel_paths_ptr->num_workers = num_workers;
+   }
+
+   if (num_paths != me_ptr->parallel_paths_ptr->num_jobs)
+   {
+      TRY(result, gen_cntr_parallel_paths_create_jobs(me_ptr, num_paths));
+   }
+
+   TRY(result, gen_topo_parallel_paths_create(&me_ptr->topo, num_paths));
+
+   GEN_CNTR_MSG(me_ptr->topo.gu.log_id,
+                DBG_HIGH_PRIO,
+                "Processing %lu parallel paths concurrently with %lu worker threads",
+                num_paths,
+                num_workers);
+
+   CATCH(result, GEN_CNTR_MSG_PREFIX, me_ptr->topo.gu.log_id)
+   {
+      GEN_CNTR_MSG(me_ptr->topo.gu.log_id, DBG_ERROR_PRIO, "Parallel paths will be processed serially");
+      gen_cntr_parallel_paths_destroy(me_ptr);
+   }
+}
+
+/**
+ * Paths are processed concurrently only if at least two of them are ready. When probing for trigger policy module
+ * activity, topo process must stop as soon as all such modules are done, which needs serial processing.
+ */
+bool_t gen_cntr_parallel_paths_can_process(gen_cntr_t *me_ptr)
+{
+   gen_cntr_parallel_paths_t *pp_ptr          = me_ptr->parallel_paths_ptr;
+   uint32_t                   num_paths       = me_ptr->topo.gu.num_parallel_paths;
+   uint32_t                   num_ready_paths = 0;
+
+   if ((NULL == pp_ptr) || (NULL == me_ptr->topo.parallel_paths_ptr) || (num_paths != pp_ptr->num_jobs) ||
+       (num_paths != me_ptr->topo.parallel_paths_ptr->num_paths) ||
+       me_ptr->topo.proc_context.process_info.probing_for_tpm_activity)
+   {
+      return FALSE;
+   }
+
+   for (uint32_t i = 0; (i < num_paths) && (num_ready_paths < 2); i++)
+   {
+      if (0 == me_ptr->wait_mask_arr[i])
+      {
+         num_ready_paths++;
+      }
+   }
+
+   return (num_ready_paths >= 2);
+}
+
+/**
+ * Processes all the ready parallel paths and handles the events raised during process.
+ * Equivalent of calling gen_topo_topo_process for each path serially.
+ */
+ar_result_t gen_cntr_parallel_paths_process(gen_cntr_t *me_ptr, bool_t *mf_th_ps_event_ptr)
+{
+   ar_result_t                result           = AR_EOK;
+   gen_cntr_parallel_paths_t *pp_ptr           = me_ptr->parallel_paths_ptr;
+   gen_topo_process_info_t   *process_info_ptr = &me_ptr->topo.proc_context.process_info;
+   gen_cntr_path_job_t       *local_job_ptr    = NULL;
+   uint32_t                   pending_mask     = 0;
+
+   gen_topo_parallel_paths_begin(&me_ptr->topo);
+
+   for (uint32_t i = 0; i < pp_ptr->num_jobs; i++)
+   {
+      gen_cntr_path_job_t *path_job_ptr = &pp_ptr->jobs_ptr[i];
+
+      path_job_ptr->is_ready = (0 == me_ptr->wait_mask_arr[i]);
+      if (!path_job_ptr->is_ready)
+      {
+         continue;
+      }
+
+      path_job_ptr->start_module_list_ptr = me_ptr->topo.started_sorted_module_list_ptr;
+
+      // if there was switch from thin topo to gen topo get the module from
+      // which process needs to continue.
+      thin_topo_check_get_gen_topo_next_proc_module(&me_ptr->topo, &path_job_ptr->start_module_list_ptr);
+
+      // first ready path is processed by the container thread once the others are pushed
+      if (NULL == local_job_ptr)
+      {
+         local_job_ptr = path_job_ptr;
+         continue;
+      }
+
+      if (AR_EOK == spf_thread_pool_push_job(pp_ptr->tp_ptr, &path_job_ptr->job, 0 /*priority*/))
+      {
+         pending_mask |= (1 << i);
+      }
+      else
+      {
+         path_job_ptr->job.job_result = gen_cntr_parallel_path_job_func(path_job_ptr);
+      }
+   }
+
+   local_job_ptr->job.job_result = gen_cntr_parallel_path_job_func(local_job_ptr);
+
+   while (pending_mask)
+   {
+      uint32_t done_mask = posal_channel_wait(pp_ptr->channel_ptr, pending_mask);
+      for (uint32_t i = 0; i < pp_ptr->num_jobs; i++)
+      {
+         if (done_mask & (1 << i))
+         {
+            posal_signal_clear(pp_ptr->jobs_ptr[i].job.job_signal_ptr);
+         }
+      }
+      pending_mask &= ~done_mask;
+   }
+
+   gen_topo_parallel_paths_end(&me_ptr->topo);
+
+   for (uint32_t i = 0; i < pp_ptr->num_jobs; i++)
+   {
+      gen_cntr_path_job_t *path_job_ptr = &pp_ptr->jobs_ptr[i];
+
+      if (!path_job_ptr->is_ready)
+      {
+         continue;
+      }
+
+      result |= path_job_ptr->job.job_result;
+
+      bool_t is_stopped_in_parallel = TRUE;
+      while (TRUE)
+      {
+         // Flag to indicate Media format, threshold or process state change event
+         *mf_th_ps_event_ptr = FALSE;
+
+         // here MF must propagate from next module, starting from current module overwrites any data that module
+         // might have outputed in this call.
+         gen_cntr_handle_process_events_and_flags(me_ptr,
+                                                  process_info_ptr,
+                                                  mf_th_ps_event_ptr,
+                                                  (path_job_ptr->start_module_list_ptr
+                                                      ? path_job_ptr->start_module_list_ptr->next_ptr
+                                                      : NULL));
+
+         // while processing concurrently, a path stops at a module if an event is pending in the topo, even if the
+         // event was raised by another path. Such a path needs to continue irrespective of its own events.
+         if ((NULL == path_job_ptr->start_module_list_ptr) || !(*mf_th_ps_event_ptr || is_stopped_in_parallel))
+         {
+            break;
+         }
+         is_stopped_in_parallel = FALSE;
+
+         GEN_CNTR_MSG(me_ptr->topo.gu.log_id,
+                      DBG_LOW_PRIO,
+                      "Looping back to topo process from module 0x%08lX ",
+                      path_job_ptr->start_module_list_ptr->module_ptr->module_instance_id);
+
+         result |= gen_topo_topo_process(&me_ptr->topo,
+                                         &path_job_ptr->start_module_list_ptr,
+                                         &path_job_ptr->path_index);
+      }
+   }
+
+   return result;
+}
+
+#else // USES_SPF_THREAD_POOL
+
+/* Without the thread pool, the parallel paths are always processed serially. */
+void gen_cntr_parallel_paths_update(gen_cntr_t *me_ptr)
+{
+}
+
+void gen_cntr_parallel_paths_destroy(gen_cntr_t *me_ptr)
+{
+}
+
+bool_t gen_cntr_parallel_paths_can_process(gen_cntr_t *me_ptr)
+{
+   return FALSE;
+}
+
+ar_result_t gen_cntr_parallel_paths_process(gen_cntr_t *me_ptr, bool_t *mf_th_ps_event_ptr)
+{
+   return AR_EUNSUPPORTED;
+}
+
+#endif // USES_SPF_THREAD_POOL
@@ -2196,6 +2196,8 @@ ar_result_t gen_cntr_allocate_wait_mask_arr(gen_cntr_t *me_ptr)
                            result);
    }
 
+   gen_cntr_parallel_paths_update(me_ptr);
+
    CATCH(result, GEN_CNTR_MSG_PREFIX, me_ptr->topo.gu.log_id)
    {
       me_ptr->topo.gu.num_parallel_paths = 0;
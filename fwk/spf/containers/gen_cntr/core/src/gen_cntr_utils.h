@@ -249,6 +249,12 @@ ar_result_t gen_cntr_init_ext_out_port(void *base_ptr, gu_ext_out_port_t *gu_ext
 ar_result_t gen_cntr_deinit_ext_out_port(void *base_ptr, gu_ext_out_port_t *gu_ext_port_ptr);
 
 ar_result_t gen_cntr_update_icb_info(gen_topo_t *topo_ptr);
+/** ------------------------------------------- parallel paths -----------------------------------------------------*/
+void        gen_cntr_parallel_paths_update(gen_cntr_t *me_ptr);
+void        gen_cntr_parallel_paths_destroy(gen_cntr_t *me_ptr);
+bool_t      gen_cntr_parallel_paths_can_process(gen_cntr_t *me_ptr);
+ar_result_t gen_cntr_parallel_paths_process(gen_cntr_t *me_ptr, bool_t *mf_th_ps_event_ptr);
+
 /** ------------------------------------------- timestamp    ---------------------------------------------------------*/
 ar_result_t gen_cntr_copy_timestamp_from_input(gen_cntr_t *me_ptr, gen_cntr_ext_in_port_t *ext_in_port_ptr);
 
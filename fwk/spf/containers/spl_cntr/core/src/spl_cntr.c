@@ -499,6 +499,7 @@ ar_result_t spl_cntr_create(cntr_cmn_init_params_t *init_params_ptr, spf_handle_
    me_ptr->cu.configured_thread_prio                = APM_CONT_PRIO_IGNORE; // Assume configured priority, to be updated by tools
    me_ptr->cu.configured_sched_policy               = APM_CONT_SCHED_POLICY_IGNORE;
    me_ptr->cu.configured_core_affinity              = APM_CONT_CORE_AFFINITY_IGNORE;
+   me_ptr->cu.configured_num_path_workers           = APM_CONT_PARALLEL_PATHS_DISABLED;
 
    TRY(result, spl_cntr_parse_container_cfg(me_ptr, init_params_ptr->container_cfg_ptr));
 
@@ -0,0 +1,52 @@
+#ifndef CAPI_INTF_EXTN_SHARED_OUTPUT_BUFFER_H
+#define CAPI_INTF_EXTN_SHARED_OUTPUT_BUFFER_H
+
+/**
+ *   \file capi_intf_extn_shared_output_buffer.h
+ *   \brief
+ *        intf_extns related to sharing the input buffer of a module with its outputs.
+ *
+ *    This file defines the interface extension that allows a module which only replicates its input on its outputs
+ *    (e.g. splitter) to let the framework hand out the input buffer itself on the outputs.
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+ *  SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/*------------------------------------------------------------------------------
+ * Include Files
+ *----------------------------------------------------------------------------*/
+#include "capi_types.h"
+
+/** @addtogroup capi_if_ext_shared_output_buffer
+The Shared Output Buffer interface extension (#INTF_EXTN_SHARED_OUTPUT_BUFFER) is supported by single input modules
+which copy the input data as is to one or more outputs.
+
+When a module supports this extension, the framework may assign the same (read-only, reference counted) buffer to the
+input and to any of the outputs. In that case input and output data pointers are equal and the module must not copy,
+it only needs to update the output actual data length. The module must handle both cases as the framework can still
+assign separate output buffers, for example for external outputs.
+
+Supporting this extension is also a declaration that the module never modifies its input data. Downstream modules
+which don't support it may write to their input, so the framework gives them a private copy of a shared buffer before
+calling their process (copy-on-write). A shared buffer reaches only the last of them without a copy.
+*/
+
+/** @addtogroup capi_if_ext_shared_output_buffer
+@{ */
+
+/** Unique identifier of the Shared Output Buffer interface extension. */
+#define INTF_EXTN_SHARED_OUTPUT_BUFFER 0x0A001BB4
+
+/** @} */ /* end_addtogroup capi_if_ext_shared_output_buffer */
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /* CAPI_INTF_EXTN_SHARED_OUTPUT_BUFFER_H*/
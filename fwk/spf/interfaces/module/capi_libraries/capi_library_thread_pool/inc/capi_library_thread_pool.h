@@ -1,8 +1,8 @@
 /**
  * \file capi_library_thread_pool.h
  * \brief
- *  
- * 
+ *  Thread pool for CAPI libraries, see capi_library_thread_pool.c.
+ *
  * \copyright
  *  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
  *  SPDX-License-Identifier: BSD-3-Clause-Clear
@@ -21,6 +21,7 @@
  -----------------------------------------------------------------------*/
 #define TH_POOL_TH_NAME_SIZE (4) // algo name. THPL$ is appended to input
 #define TH_POOL_EXIT_TASK_ID (0) // task id for thread exit
+#define TH_POOL_THREAD_NAME_MAX_LEN (16) // algo name, THPL and the thread index, including the NULL char
 
 /** thread pool handle */
 typedef struct th_pool_t th_pool_t;
@@ -40,6 +41,18 @@ typedef void (*th_pool_cb_fn)(void *cb_contex, th_pool_task_t *task_info);
 /** default callback info */
 typedef struct th_pool_default_cb_t th_pool_default_cb_t;
 
+/** fork-join job function, called once for every job index in [0, num_jobs) */
+typedef void (*th_pool_job_fn)(void *context_ptr, uint32_t job_idx);
+
+/** fork-join load statistics, accumulated since th_pool_create */
+typedef struct th_pool_stats_t
+{
+   uint32_t num_fork_joins; // number of th_pool_fork_join calls which used the worker threads
+   uint64_t job_time_us;    // time spent in the job functions, summed over all threads
+   uint64_t busy_time_us;   // time spent in fork-joins (dispatch, job claiming and jobs, without the join wait),
+                            // summed over all threads
+} th_pool_stats_t;
+
 /** final task definition */
 typedef struct th_pool_task_t
 {
@@ -62,6 +75,12 @@ th_pool_t *th_pool_create(uint32_t   th_prio,
                           uint32_t   th_stack,
                           const char th_name[TH_POOL_TH_NAME_SIZE]);
 void th_pool_destroy(th_pool_t *th_pool_handle);
+/** Name of the pool thread with index thread_idx, e.g. "ALGOTHPL12". Only TH_POOL_TH_NAME_SIZE chars of th_name are
+    used, which leaves room for the index in TH_POOL_THREAD_NAME_MAX_LEN. */
+void th_pool_get_thread_name(const char th_name[TH_POOL_TH_NAME_SIZE],
+                             uint32_t   thread_idx,
+                             char      *name_ptr,
+                             uint32_t   name_size);
 ar_result_t th_pool_push_task(th_pool_t *th_pool_handle, th_pool_task_t *task_ptr);
 
 /*-----------------------------------------------------------------------
@@ -74,6 +93,23 @@ void th_pool_wait_for_task_complete(th_pool_default_cb_t *cb_info_ptr);
 void th_pool_default_cb_destroy(th_pool_default_cb_t *cb_info_ptr);
 ar_result_t th_pool_work_loop(void *context);
 
+/*-----------------------------------------------------------------------
+ fork-join
+ -----------------------------------------------------------------------*/
+/** Runs job_fn for job indices 0 .. num_jobs-1 on the worker threads and the calling thread, and returns once all
+    jobs are complete. Meant for splitting independent work of one process call, e.g. per channel processing.
+    Jobs run concurrently, so they must not share state without locking. Only one fork-join may be active per pool.
+    th_pool_handle can be NULL, in which case all jobs run on the calling thread. */
+ar_result_t th_pool_fork_join(th_pool_t *th_pool_handle, th_pool_job_fn job_fn, void *context_ptr, uint32_t num_jobs);
+
+/** Returns the fork-join load statistics of the pool. */
+void th_pool_get_stats(th_pool_t *th_pool_handle, th_pool_stats_t *stats_ptr);
+
+/** Scales a module's single thread KPPS estimate by the measured fork-join overhead (busy time / job time). Work done
+    on the worker threads is not seen by the container thread's processing time, so modules using th_pool_fork_join
+    must vote for it through their KPPS event; the result is what the module should raise. */
+uint32_t th_pool_get_kpps(th_pool_t *th_pool_handle, uint32_t single_thread_kpps);
+
 #ifdef __cplusplus
 }
 #endif /*__cplusplus*/
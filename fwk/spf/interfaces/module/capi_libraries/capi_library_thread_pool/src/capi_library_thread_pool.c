@@ -1,7 +1,11 @@
 /**
  * \file capi_library_thread_pool.c
  * \brief
+ *     Thread pool for CAPI libraries, built on posal threads, queues and signals.
  *
+ *     Tasks are copied into a fixed set of task slots: free slots wait in the free queue, pushed tasks in the task
+ *     queue which is shared by all the worker threads. th_pool_fork_join builds on this to split the work of a single
+ *     process call (e.g. per channel filtering) across the worker threads and the calling thread.
  *
  * \copyright
  *  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
@@ -9,29 +13,102 @@
  */
 
 #include "capi_library_thread_pool.h"
-#include "amdb_queue.h"
-//#include "elite_thrd_prio.h"
 #include "posal.h"
-#include <stringl/stringl.h>
 
 #define TH_POOL_TASK_Q_LENGTH (8)
 #define TH_POOL_MAX_THREADS (4)
+#define TH_POOL_Q_BIT_MASK (0x1)
+#define TH_POOL_SIGNAL_BIT_MASK (0x1)
+
+/** queue element, points to a task slot */
+typedef struct th_pool_msg_t
+{
+   th_pool_task_t *task_ptr;
+   void *          reserved_ptr;
+} th_pool_msg_t;
+
 /** thread pool handle */
 typedef struct th_pool_t
 {
-   uint32_t       num_threads;
-   posal_thread_t threads[TH_POOL_MAX_THREADS];
-   amdb_queue_t * task_queue_ptr;
+   uint32_t        num_threads;
+   posal_thread_t  threads[TH_POOL_MAX_THREADS];
+   th_pool_task_t  task_slots[TH_POOL_TASK_Q_LENGTH];
+   posal_channel_t task_channel;
+   posal_queue_t * task_q_ptr;   // pushed tasks, popped by the worker threads
+   posal_channel_t free_channel;
+   posal_queue_t * free_q_ptr;   // unused task slots
+   posal_mutex_t   wt_sync_lock; // serializes worker threads waiting on the shared task queue
+   posal_mutex_t   push_lock;    // serializes clients waiting for a free slot
+
+   // fork-join
+   posal_mutex_t   join_lock;    // protects fork-join job claiming, pending helpers and stats
+   posal_channel_t join_channel;
+   posal_signal_t  join_signal;  // set by the last helper task of a fork-join
+   th_pool_stats_t stats;
 } th_pool_t;
 
 /** default callback info */
 typedef struct th_pool_default_cb_t
 {
    uint32_t        num_tasks; // num of tasks to wait
-   posal_condvar_t condition_var;
-   posal_nmutex_t  mutex;
+   posal_mutex_t   lock;
+   posal_channel_t channel;
+   posal_signal_t  signal; // set whenever a task completes
 } th_pool_default_cb_t;
 
+/** state of one fork-join call, lives on the caller's stack */
+typedef struct th_pool_fork_join_t
+{
+   th_pool_t *    pool_ptr;
+   th_pool_job_fn job_fn;
+   void *         context_ptr;
+   uint32_t       num_jobs;
+   uint32_t       next_job_idx;
+   uint32_t       num_pending_helpers;
+} th_pool_fork_join_t;
+
+static ar_result_t th_pool_create_queue(posal_queue_t **q_pptr, posal_channel_t *channel_ptr, char *q_name)
+{
+   ar_result_t             result = AR_EOK;
+   posal_queue_init_attr_t q_attr;
+
+   if (AR_DID_FAIL(result = posal_channel_create(channel_ptr, POSAL_HEAP_DEFAULT)))
+   {
+      return result;
+   }
+
+   posal_queue_attr_init(&q_attr);
+   posal_queue_attr_set_heap_id(&q_attr, POSAL_HEAP_DEFAULT);
+   posal_queue_attr_set_max_nodes(&q_attr, TH_POOL_TASK_Q_LENGTH);
+   posal_queue_attr_set_prealloc_nodes(&q_attr, TH_POOL_TASK_Q_LENGTH);
+   posal_queue_attr_set_name(&q_attr, q_name);
+   if (AR_DID_FAIL(result = posal_queue_create_v1(q_pptr, &q_attr)))
+   {
+      return result;
+   }
+
+   return posal_channel_addq(*channel_ptr, *q_pptr, TH_POOL_Q_BIT_MASK);
+}
+
+static void th_pool_destroy_queue(posal_queue_t **q_pptr, posal_channel_t *channel_ptr)
+{
+   if (*q_pptr)
+   {
+      posal_queue_destroy(*q_pptr);
+      *q_pptr = NULL;
+   }
+   if (*channel_ptr)
+   {
+      posal_channel_destroy(channel_ptr);
+   }
+}
+
+static void th_pool_signal_wait(posal_channel_t channel, posal_signal_t signal)
+{
+   posal_channel_wait(channel, TH_POOL_SIGNAL_BIT_MASK);
+   posal_signal_clear(signal);
+}
+
 /** function definition */
 th_pool_t *th_pool_create(uint32_t   th_prio,
                           uint32_t   num_threads,
@@ -42,47 +119,53 @@ th_pool_t *th_pool_create(uint32_t   th_prio,
 
    if (TH_POOL_MAX_THREADS < num_threads)
    {
-      MSG_1(MSG_SSID_QDSP6, DBG_ERROR_PRIO, "th_pool: invalid number of threads %ld", num_threads);
+      AR_MSG(DBG_ERROR_PRIO, "th_pool: invalid number of threads %lu", num_threads);
       return NULL;
    }
 
    th_pool_t *obj_ptr = (th_pool_t *)posal_memory_malloc(sizeof(th_pool_t), POSAL_HEAP_DEFAULT);
    if (NULL == obj_ptr)
    {
-      MSG(MSG_SSID_QDSP6, DBG_ERROR_PRIO, "th_pool: Failed to allocate the th pool memory.");
+      AR_MSG(DBG_ERROR_PRIO, "th_pool: Failed to allocate the th pool memory.");
       return NULL;
    }
 
    memset(obj_ptr, 0, sizeof(th_pool_t));
 
    char task_q_name[] = "THPLQ";
-   obj_ptr->task_queue_ptr =
-      amdb_queue_create(TH_POOL_TASK_Q_LENGTH, sizeof(th_pool_task_t), task_q_name, POSAL_HEAP_DEFAULT);
-   if (NULL == obj_ptr->task_queue_ptr)
+   char free_q_name[] = "THPLF";
+   if (AR_DID_FAIL(th_pool_create_queue(&obj_ptr->task_q_ptr, &obj_ptr->task_channel, task_q_name)) ||
+       AR_DID_FAIL(th_pool_create_queue(&obj_ptr->free_q_ptr, &obj_ptr->free_channel, free_q_name)) ||
+       AR_DID_FAIL(posal_mutex_create(&obj_ptr->wt_sync_lock, POSAL_HEAP_DEFAULT)) ||
+       AR_DID_FAIL(posal_mutex_create(&obj_ptr->push_lock, POSAL_HEAP_DEFAULT)) ||
+       AR_DID_FAIL(posal_mutex_create(&obj_ptr->join_lock, POSAL_HEAP_DEFAULT)) ||
+       AR_DID_FAIL(posal_channel_create(&obj_ptr->join_channel, POSAL_HEAP_DEFAULT)) ||
+       AR_DID_FAIL(posal_signal_create(&obj_ptr->join_signal, POSAL_HEAP_DEFAULT)) ||
+       AR_DID_FAIL(posal_channel_add_signal(obj_ptr->join_channel, obj_ptr->join_signal, TH_POOL_SIGNAL_BIT_MASK)))
    {
-      MSG(MSG_SSID_QDSP6,
-          DBG_ERROR_PRIO,
-          "th_pool: Failed to allocate the task queue for the th pool parallel loader.");
+      AR_MSG(DBG_ERROR_PRIO, "th_pool: Failed to create the queues and signals for the th pool.");
       th_pool_destroy(obj_ptr);
       return NULL;
    }
 
+   for (uint32_t i = 0; i < TH_POOL_TASK_Q_LENGTH; i++)
+   {
+      th_pool_msg_t msg = { &obj_ptr->task_slots[i], NULL };
+      posal_queue_push_back(obj_ptr->free_q_ptr, (posal_queue_element_t *)&msg);
+   }
+
    if (0 == thread_prio)
    {
       thread_prio = posal_thread_prio_get();
-      // th_prio = posal_thread_prio_get();
-      // We cannot use posal_thread_prio_get function as the thread pool function
-      // can be called from ADM context as capiv2_init function is called from ADM context
    }
 
    // Threads should be launched only after everything else is initialized, since they may access the object.
-   char thread_name[16];
-   strlcpy(thread_name, th_name, sizeof(thread_name));
-   strlcat(thread_name, "THPL0", sizeof(thread_name));
+   char thread_name[TH_POOL_THREAD_NAME_MAX_LEN];
 
    for (uint32_t i = 0; i < num_threads; i++)
    {
       ar_result_t res;
+      th_pool_get_thread_name(th_name, i, thread_name, sizeof(thread_name));
       res = posal_thread_launch(&obj_ptr->threads[i],
                                 thread_name,
                                 th_stack,
@@ -92,46 +175,74 @@ th_pool_t *th_pool_create(uint32_t   th_prio,
                                 POSAL_HEAP_DEFAULT);
       if (AR_DID_FAIL(res))
       {
-         MSG_1(MSG_SSID_QDSP6, DBG_ERROR_PRIO, "th_pool: Failed to launch thread %lu.", i);
+         AR_MSG(DBG_ERROR_PRIO, "th_pool: Failed to launch thread %lu.", i);
          th_pool_destroy(obj_ptr);
          return NULL;
       }
 
       obj_ptr->num_threads++;
-      thread_name[strlen(thread_name) - 1]++;
    }
 
    // return object
    return obj_ptr;
 }
 
+/* th_name need not be NULL terminated, only up to TH_POOL_TH_NAME_SIZE chars are used. The index is formatted in full,
+   so that the name stays unique for any number of threads. */
+void th_pool_get_thread_name(const char th_name[TH_POOL_TH_NAME_SIZE],
+                             uint32_t   thread_idx,
+                             char      *name_ptr,
+                             uint32_t   name_size)
+{
+   snprintf(name_ptr, name_size, "%.*sTHPL%lu", TH_POOL_TH_NAME_SIZE, th_name, (unsigned long)thread_idx);
+}
+
 void th_pool_destroy(th_pool_t *obj_ptr)
 {
-   if (NULL != obj_ptr)
+   if (NULL == obj_ptr)
    {
-      if (obj_ptr->task_queue_ptr)
-      {
-         for (uint32_t i = 0; i < obj_ptr->num_threads; i++)
-         {
-            th_pool_task_t task;
-            task.task_id = TH_POOL_EXIT_TASK_ID;
-            amdb_queue_push(obj_ptr->task_queue_ptr, &task);
-         }
+      return;
+   }
 
-         for (uint32_t i = 0; i < obj_ptr->num_threads; i++)
-         {
-            ar_result_t status = 0;
-            posal_thread_join(obj_ptr->threads[i], &status);
-         }
+   for (uint32_t i = 0; i < obj_ptr->num_threads; i++)
+   {
+      th_pool_task_t task;
+      memset(&task, 0, sizeof(task));
+      task.task_id = TH_POOL_EXIT_TASK_ID;
+      th_pool_push_task(obj_ptr, &task);
+   }
 
-         if (NULL != obj_ptr->task_queue_ptr)
-         {
-            amdb_queue_destroy(obj_ptr->task_queue_ptr);
-            obj_ptr->task_queue_ptr = NULL;
-         }
-      }
-      posal_memory_free(obj_ptr);
+   for (uint32_t i = 0; i < obj_ptr->num_threads; i++)
+   {
+      ar_result_t status = 0;
+      posal_thread_join(obj_ptr->threads[i], &status);
+   }
+
+   th_pool_destroy_queue(&obj_ptr->task_q_ptr, &obj_ptr->task_channel);
+   th_pool_destroy_queue(&obj_ptr->free_q_ptr, &obj_ptr->free_channel);
+
+   if (obj_ptr->join_signal)
+   {
+      posal_signal_destroy(&obj_ptr->join_signal);
+   }
+   if (obj_ptr->join_channel)
+   {
+      posal_channel_destroy(&obj_ptr->join_channel);
+   }
+   if (obj_ptr->wt_sync_lock)
+   {
+      posal_mutex_destroy(&obj_ptr->wt_sync_lock);
+   }
+   if (obj_ptr->push_lock)
+   {
+      posal_mutex_destroy(&obj_ptr->push_lock);
    }
+   if (obj_ptr->join_lock)
+   {
+      posal_mutex_destroy(&obj_ptr->join_lock);
+   }
+
+   posal_memory_free(obj_ptr);
 }
 
 ar_result_t th_pool_work_loop(void *context)
@@ -140,37 +251,73 @@ ar_result_t th_pool_work_loop(void *context)
 
    while (1)
    {
+      th_pool_msg_t  msg = { NULL, NULL };
       th_pool_task_t task;
-      amdb_queue_pop(obj_ptr->task_queue_ptr, &task);
+
+      // one worker at a time waits on the shared task queue
+      posal_mutex_lock(obj_ptr->wt_sync_lock);
+      posal_channel_wait(obj_ptr->task_channel, TH_POOL_Q_BIT_MASK);
+      posal_queue_pop_front(obj_ptr->task_q_ptr, (posal_queue_element_t *)&msg);
+      posal_mutex_unlock(obj_ptr->wt_sync_lock);
+
+      if (NULL == msg.task_ptr)
+      {
+         continue;
+      }
+
+      // release the slot before running the task, so the task can push more tasks
+      task = *msg.task_ptr;
+      posal_queue_push_back(obj_ptr->free_q_ptr, (posal_queue_element_t *)&msg);
 
       switch (task.task_id)
       {
          case TH_POOL_EXIT_TASK_ID:
-            return 0;
+            return AR_EOK;
          default:
          {
-            // MSG_1(MSG_SSID_QDSP6, DBG_ERROR_PRIO,"th_pool: executing function %p",task.fn);
             task.fn(task.io_args);
-            task.cb_fn(task.cb_context, &task);
+            if (task.cb_fn)
+            {
+               task.cb_fn(task.cb_context, &task);
+            }
             break;
          }
       }
    }
-   return 0;
+   return AR_EOK;
 }
 
 ar_result_t th_pool_push_task(th_pool_t *th_pool_handle, th_pool_task_t *task_ptr)
 {
-   if (th_pool_handle && task_ptr)
+   ar_result_t   result = AR_EOK;
+   th_pool_msg_t msg    = { NULL, NULL };
+
+   if ((NULL == th_pool_handle) || (NULL == task_ptr))
    {
-      amdb_queue_push(th_pool_handle->task_queue_ptr, task_ptr);
-      return AR_EOK;
+      AR_MSG(DBG_ERROR_PRIO, "th_pool: NULL pointer error");
+      return AR_EFAILED;
    }
-   else
+
+   // wait for a free slot, blocks only when TH_POOL_TASK_Q_LENGTH tasks are pending
+   posal_mutex_lock(th_pool_handle->push_lock);
+   posal_channel_wait(th_pool_handle->free_channel, TH_POOL_Q_BIT_MASK);
+   posal_queue_pop_front(th_pool_handle->free_q_ptr, (posal_queue_element_t *)&msg);
+   posal_mutex_unlock(th_pool_handle->push_lock);
+
+   if (NULL == msg.task_ptr)
    {
-      MSG(MSG_SSID_QDSP6, DBG_ERROR_PRIO, "th_pool: NULL pointer error");
+      AR_MSG(DBG_ERROR_PRIO, "th_pool: failed to get a free task slot");
       return AR_EFAILED;
    }
+
+   *msg.task_ptr = *task_ptr;
+   if (AR_DID_FAIL(result = posal_queue_push_back(th_pool_handle->task_q_ptr, (posal_queue_element_t *)&msg)))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "th_pool: failed to push the task, result %lu", result);
+      posal_queue_push_back(th_pool_handle->free_q_ptr, (posal_queue_element_t *)&msg);
+   }
+
+   return result;
 }
 
 /** default callback functions */
@@ -180,38 +327,65 @@ th_pool_default_cb_t *th_pool_default_cb_create(void)
       (th_pool_default_cb_t *)posal_memory_malloc(sizeof(th_pool_default_cb_t), POSAL_HEAP_DEFAULT);
    if (NULL == cb_ptr)
    {
-      MSG(MSG_SSID_QDSP6, DBG_ERROR_PRIO, "th_pool: failed to allocate memory for default cb");
+      AR_MSG(DBG_ERROR_PRIO, "th_pool: failed to allocate memory for default cb");
+      return NULL;
+   }
+   memset(cb_ptr, 0, sizeof(th_pool_default_cb_t));
+
+   if (AR_DID_FAIL(posal_mutex_create(&cb_ptr->lock, POSAL_HEAP_DEFAULT)) ||
+       AR_DID_FAIL(posal_channel_create(&cb_ptr->channel, POSAL_HEAP_DEFAULT)) ||
+       AR_DID_FAIL(posal_signal_create(&cb_ptr->signal, POSAL_HEAP_DEFAULT)) ||
+       AR_DID_FAIL(posal_channel_add_signal(cb_ptr->channel, cb_ptr->signal, TH_POOL_SIGNAL_BIT_MASK)))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "th_pool: failed to create the default cb signal");
+      th_pool_default_cb_destroy(cb_ptr);
       return NULL;
    }
-   posal_nmutex_create(&cb_ptr->mutex, POSAL_HEAP_DEFAULT);
-   posal_condvar_create(&cb_ptr->condition_var, POSAL_HEAP_DEFAULT);
-   cb_ptr->num_tasks = 0;
 
    return cb_ptr;
 }
+
 void th_pool_set_num_tasks_to_wait(th_pool_default_cb_t *cb_info_ptr, uint32_t num_tasks)
 {
-   posal_nmutex_lock(cb_info_ptr->mutex);
+   posal_mutex_lock(cb_info_ptr->lock);
    cb_info_ptr->num_tasks = num_tasks;
-   posal_nmutex_unlock(cb_info_ptr->mutex);
+   posal_mutex_unlock(cb_info_ptr->lock);
 }
 
 void th_pool_wait_for_task_complete(th_pool_default_cb_t *cb_info_ptr)
 {
-   posal_nmutex_lock(cb_info_ptr->mutex);
-   while (cb_info_ptr->num_tasks)
+   while (1)
    {
-      posal_condvar_wait(cb_info_ptr->condition_var, cb_info_ptr->mutex);
+      posal_mutex_lock(cb_info_ptr->lock);
+      uint32_t num_tasks = cb_info_ptr->num_tasks;
+      posal_mutex_unlock(cb_info_ptr->lock);
+
+      if (0 == num_tasks)
+      {
+         break;
+      }
+
+      // the signal is sent after every decrement, so a completion between the check and the wait is not lost
+      th_pool_signal_wait(cb_info_ptr->channel, cb_info_ptr->signal);
    }
-   posal_nmutex_unlock(cb_info_ptr->mutex);
 }
 
 void th_pool_default_cb_destroy(th_pool_default_cb_t *cb_info_ptr)
 {
    if (cb_info_ptr)
    {
-      posal_nmutex_destroy(&cb_info_ptr->mutex);
-      posal_condvar_destroy(&cb_info_ptr->condition_var);
+      if (cb_info_ptr->signal)
+      {
+         posal_signal_destroy(&cb_info_ptr->signal);
+      }
+      if (cb_info_ptr->channel)
+      {
+         posal_channel_destroy(&cb_info_ptr->channel);
+      }
+      if (cb_info_ptr->lock)
+      {
+         posal_mutex_destroy(&cb_info_ptr->lock);
+      }
       posal_memory_free(cb_info_ptr);
    }
 }
@@ -219,15 +393,186 @@ void th_pool_default_cb_destroy(th_pool_default_cb_t *cb_info_ptr)
 void th_pool_default_cb_fn(void *cb_contex, th_pool_task_t *task_info)
 {
    th_pool_default_cb_t *obj_ptr = (th_pool_default_cb_t *)(cb_contex);
-   posal_nmutex_lock(obj_ptr->mutex);
+   posal_mutex_lock(obj_ptr->lock);
    if (0 == obj_ptr->num_tasks)
    {
-      MSG(MSG_SSID_QDSP6, DBG_ERROR_PRIO, "th_pool: invalid num_tasks");
+      AR_MSG(DBG_ERROR_PRIO, "th_pool: invalid num_tasks");
    }
    else
    {
       obj_ptr->num_tasks--;
    }
-   posal_condvar_signal(obj_ptr->condition_var);
-   posal_nmutex_unlock(obj_ptr->mutex);
-}
\ No newline at end of file
+   posal_signal_send(obj_ptr->signal);
+   posal_mutex_unlock(obj_ptr->lock);
+}
+
+/*-----------------------------------------------------------------------
+ fork-join
+ -----------------------------------------------------------------------*/
+/* Runs jobs until all are claimed; returns the time spent in the job functions. */
+static uint64_t th_pool_fork_join_run_jobs(th_pool_fork_join_t *fj_ptr)
+{
+   th_pool_t *pool_ptr    = fj_ptr->pool_ptr;
+   uint64_t   job_time_us = 0;
+
+   while (1)
+   {
+      uint32_t job_idx;
+
+      posal_mutex_lock(pool_ptr->join_lock);
+      job_idx = fj_ptr->next_job_idx;
+      if (job_idx < fj_ptr->num_jobs)
+      {
+         fj_ptr->next_job_idx++;
+      }
+      posal_mutex_unlock(pool_ptr->join_lock);
+
+      if (job_idx >= fj_ptr->num_jobs)
+      {
+         break;
+      }
+
+      uint64_t start_us = posal_timer_get_time();
+      fj_ptr->job_fn(fj_ptr->context_ptr, job_idx);
+      job_time_us += (posal_timer_get_time() - start_us);
+   }
+
+   return job_time_us;
+}
+
+/* helper task, runs on a worker thread */
+static void th_pool_fork_join_helper(th_pool_in_args_t *io_args)
+{
+   th_pool_fork_join_t *fj_ptr   = (th_pool_fork_join_t *)io_args;
+   th_pool_t *          pool_ptr = fj_ptr->pool_ptr;
+   uint64_t             start_us = posal_timer_get_time();
+   uint64_t             job_time_us;
+
+   job_time_us = th_pool_fork_join_run_jobs(fj_ptr);
+
+   posal_mutex_lock(pool_ptr->join_lock);
+   pool_ptr->stats.job_time_us += job_time_us;
+   pool_ptr->stats.busy_time_us += (posal_timer_get_time() - start_us);
+   posal_mutex_unlock(pool_ptr->join_lock);
+}
+
+static void th_pool_fork_join_helper_done(void *cb_context, th_pool_task_t *task_info)
+{
+   th_pool_fork_join_t *fj_ptr   = (th_pool_fork_join_t *)cb_context;
+   th_pool_t *          pool_ptr = fj_ptr->pool_ptr;
+
+   // fj_ptr is on the caller's stack, it must not be touched after the last helper signals
+   posal_mutex_lock(pool_ptr->join_lock);
+   if (0 == --fj_ptr->num_pending_helpers)
+   {
+      posal_signal_send(pool_ptr->join_signal);
+   }
+   posal_mutex_unlock(pool_ptr->join_lock);
+}
+
+ar_result_t th_pool_fork_join(th_pool_t *th_pool_handle, th_pool_job_fn job_fn, void *context_ptr, uint32_t num_jobs)
+{
+   th_pool_fork_join_t fj;
+   uint32_t            num_helpers = 0;
+   uint64_t            start_us, job_time_us;
+
+   if (NULL == job_fn)
+   {
+      AR_MSG(DBG_ERROR_PRIO, "th_pool: NULL job function");
+      return AR_EBADPARAM;
+   }
+
+   // without a pool (or a single job) everything runs on the calling thread
+   if ((NULL == th_pool_handle) || (num_jobs <= 1))
+   {
+      for (uint32_t job_idx = 0; job_idx < num_jobs; job_idx++)
+      {
+         job_fn(context_ptr, job_idx);
+      }
+      return AR_EOK;
+   }
+
+   memset(&fj, 0, sizeof(fj));
+   fj.pool_ptr    = th_pool_handle;
+   fj.job_fn      = job_fn;
+   fj.context_ptr = context_ptr;
+   fj.num_jobs    = num_jobs;
+
+   start_us = posal_timer_get_time();
+
+   // the caller takes one share of the jobs itself
+   num_helpers = MIN(th_pool_handle->num_threads, num_jobs - 1);
+   for (uint32_t i = 0; i < num_helpers; i++)
+   {
+      th_pool_task_t task;
+      task.task_id    = TH_POOL_EXIT_TASK_ID + 1;
+      task.fn         = th_pool_fork_join_helper;
+      task.io_args    = (th_pool_in_args_t *)&fj;
+      task.cb_fn      = th_pool_fork_join_helper_done;
+      task.cb_context = &fj;
+
+      posal_mutex_lock(th_pool_handle->join_lock);
+      fj.num_pending_helpers++;
+      posal_mutex_unlock(th_pool_handle->join_lock);
+
+      if (AR_DID_FAIL(th_pool_push_task(th_pool_handle, &task)))
+      {
+         // remaining jobs are picked up by the caller and the helpers already pushed
+         posal_mutex_lock(th_pool_handle->join_lock);
+         fj.num_pending_helpers--;
+         posal_mutex_unlock(th_pool_handle->join_lock);
+         break;
+      }
+   }
+
+   job_time_us = th_pool_fork_join_run_jobs(&fj);
+
+   posal_mutex_lock(th_pool_handle->join_lock);
+   th_pool_handle->stats.num_fork_joins++;
+   th_pool_handle->stats.job_time_us += job_time_us;
+   th_pool_handle->stats.busy_time_us += (posal_timer_get_time() - start_us);
+   posal_mutex_unlock(th_pool_handle->join_lock);
+
+   // join
+   while (1)
+   {
+      posal_mutex_lock(th_pool_handle->join_lock);
+      uint32_t num_pending_helpers = fj.num_pending_helpers;
+      posal_mutex_unlock(th_pool_handle->join_lock);
+
+      if (0 == num_pending_helpers)
+      {
+         break;
+      }
+      th_pool_signal_wait(th_pool_handle->join_channel, th_pool_handle->join_signal);
+   }
+
+   return AR_EOK;
+}
+
+void th_pool_get_stats(th_pool_t *th_pool_handle, th_pool_stats_t *stats_ptr)
+{
+   if ((NULL == th_pool_handle) || (NULL == stats_ptr))
+   {
+      return;
+   }
+   posal_mutex_lock(th_pool_handle->join_lock);
+   *stats_ptr = th_pool_handle->stats;
+   posal_mutex_unlock(th_pool_handle->join_lock);
+}
+
+uint32_t th_pool_get_kpps(th_pool_t *th_pool_handle, uint32_t single_thread_kpps)
+{
+   th_pool_stats_t stats;
+
+   memset(&stats, 0, sizeof(stats));
+   th_pool_get_stats(th_pool_handle, &stats);
+
+   if ((0 == stats.job_time_us) || (stats.busy_time_us <= stats.job_time_us))
+   {
+      return single_thread_kpps;
+   }
+
+   // the jobs cost single_thread_kpps wherever they run, dispatch and job claiming come on top
+   return (uint32_t)(((uint64_t)single_thread_kpps * stats.busy_time_us) / stats.job_time_us);
+}
@@ -74,6 +74,7 @@
 #include "capi_intf_extn_period.h"
 #include "capi_intf_extn_calibration_ops.h"
 #include "capi_intf_extn_stm_ts.h"
+#include "capi_intf_extn_shared_output_buffer.h"
 #include "capi_lib_capi_process_thread.h"
 #include "capi_lib_get_capi_module.h"
 #include "capi_lib_get_imc.h"
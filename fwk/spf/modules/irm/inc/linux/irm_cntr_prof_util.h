@@ -12,27 +12,90 @@ SPDX-License-Identifier: BSD-3-Clause-Clear
 #define _IRM_CNTR_PROF_UTIL_H_
 
 #include "ar_error_codes.h"
+#include <stdint.h>
+#include <time.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif /*__cplusplus*/
 #define IRM_MAX_NUM_HW_THREADS 6
 
+/* Module process sections accumulate the CPU time of the calling thread in ns, which IRM reports in us. With
+   IRM_USES_PERF_EVENTS they accumulate per thread perf counters instead: CPU cycles for the processor cycles metric and
+   retired instructions for the packet count metric. Since the calling thread is sampled, modules processed on SPF
+   thread pool workers are accounted correctly, while the container metric only covers the container thread. */
+#if defined(IRM_USES_PERF_EVENTS)
+#define IRM_LX_MOD_CYCLES_SCALE 1
+
+void irm_lx_get_curr_thread_counters(uint64_t *cycles_ptr, uint64_t *pktcnt_ptr);
+#else
+#define IRM_LX_MOD_CYCLES_SCALE 1000
+
+static inline void irm_lx_get_curr_thread_counters(uint64_t *cycles_ptr, uint64_t *pktcnt_ptr)
+{
+   struct timespec ts = { 0 };
+   clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+   *cycles_ptr = ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+   *pktcnt_ptr = 0;
+}
+#endif
+
 #define PROF_BEFORE_PROCESS(prof_info_ptr)
 #define PROF_AFTER_PROCESS(prof_info_ptr, prof_mutex)
 
-#define IRM_PROFILE_MOD_PROCESS_SECTION(prof_info_ptr, prof_mutex, XX_CODE_SECTION_XX)        \
-   do                                                                                         \
-   {                                                                                          \
-      XX_CODE_SECTION_XX                                                                      \
-   } while (0)
+#define IRM_PROFILE_MODULE_PROCESS_BEGIN(prof_info_ptr)                                                                \
+   uint64_t pcycles_before = 0;                                                                                        \
+   uint64_t pcycles_after  = 0;                                                                                        \
+   uint64_t pktcnt_before  = 0;                                                                                        \
+   uint64_t pktcnt_after   = 0;                                                                                        \
+   if (prof_info_ptr)                                                                                                  \
+   {                                                                                                                   \
+      irm_lx_get_curr_thread_counters(&pcycles_before, &pktcnt_before);                                                \
+   }
+
+#define IRM_PROFILE_MODULE_PROCESS_END(prof_info_ptr, prof_mutex)                                                      \
+   if (prof_info_ptr)                                                                                                  \
+   {                                                                                                                   \
+      irm_lx_get_curr_thread_counters(&pcycles_after, &pktcnt_after);                                                  \
+      if (prof_mutex)                                                                                                  \
+      {                                                                                                                \
+         posal_mutex_lock(prof_mutex);                                                                                 \
+         prof_info_ptr->accum_pcylces += (pcycles_after - pcycles_before);                                             \
+         prof_info_ptr->accum_pktcnt += (pktcnt_after - pktcnt_before);                                                \
+         posal_mutex_unlock(prof_mutex);                                                                               \
+      }                                                                                                                \
+   }
 
-#define IRM_PROFILE_MODULE_PROCESS_BEGIN(prof_info_ptr)
-#define IRM_PROFILE_MODULE_PROCESS_END(prof_info_ptr, prof_mutex)
+#define IRM_PROFILE_MOD_PROCESS_SECTION(prof_info_ptr, prof_mutex, XX_CODE_SECTION_XX)                                 \
+   do                                                                                                                  \
+   {                                                                                                                   \
+      if (prof_info_ptr)                                                                                               \
+      {                                                                                                                \
+         uint64_t pcycles_before = 0;                                                                                  \
+         uint64_t pcycles_after  = 0;                                                                                  \
+         uint64_t pktcnt_before  = 0;                                                                                  \
+         uint64_t pktcnt_after   = 0;                                                                                  \
+         irm_lx_get_curr_thread_counters(&pcycles_before, &pktcnt_before);                                             \
+                                                                                                                       \
+         XX_CODE_SECTION_XX                                                                                            \
+                                                                                                                       \
+         irm_lx_get_curr_thread_counters(&pcycles_after, &pktcnt_after);                                               \
+         if (prof_mutex)                                                                                               \
+         {                                                                                                             \
+            posal_mutex_lock(prof_mutex);                                                                              \
+            prof_info_ptr->accum_pcylces += (pcycles_after - pcycles_before);                                          \
+            prof_info_ptr->accum_pktcnt += (pktcnt_after - pktcnt_before);                                             \
+            posal_mutex_unlock(prof_mutex);                                                                            \
+         }                                                                                                             \
+      }                                                                                                                \
+      else                                                                                                             \
+      {                                                                                                                \
+         XX_CODE_SECTION_XX                                                                                            \
+      }                                                                                                                \
+   } while (0)
 
 #ifdef __cplusplus
 }
 #endif /*__cplusplus*/
 
 #endif /* _IRM_CNTR_PROF_UTIL_H_ */
-
@@ -19,15 +19,26 @@ SPDX-License-Identifier: BSD-3-Clause-Clear
 #include "posal_thread_profiling.h"
 #include "posal_island.h"
 
+#include "irm_cntr_prof_util.h"
+
 #include <sys/time.h>
 #include <sys/times.h>
 #include <sys/resource.h>
 #include <unistd.h>
+#include <time.h>
 
 #include <pthread.h>
 
-#define IRM_DEBUG 1
+#if defined(IRM_USES_PERF_EVENTS)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+
+//#define IRM_DEBUG 1
 
+/* Processor cycle metrics of the processor, containers and static modules are reported as CPU time in us, since ARM
+   cores do not expose a per thread cycle counter to user space. Module metrics are sampled around process(), see
+   irm_cntr_prof_util.h for their units. */
 
 irm_system_capabilities_t g_irm_cmn_capabilities = { .processor_type               = IRM_PROCESSOR_TYPE_ARM,
                                                      .min_profiling_period_us      = 200000,
@@ -35,16 +46,21 @@ irm_system_capabilities_t g_irm_cmn_capabilities = { .processor_type
                                                      .max_num_containers_supported = IRM_MAX_NUM_CONTAINERS_SUPPORTED,
                                                      .max_module_supported         = IRM_MAX_NUM_MODULES_SUPPORTED };
 
-uint32_t g_irm_processor_metric_capabilities[] = { IRM_METRIC_ID_PROCESSOR_CYCLES
-				};
+uint32_t g_irm_processor_metric_capabilities[] = { IRM_METRIC_ID_PROCESSOR_CYCLES };
 
-uint32_t g_irm_container_metric_capabilities[]  = {  };
-uint32_t g_irm_module_metric_capabilities[] = {  };
+uint32_t g_irm_container_metric_capabilities[] = { IRM_METRIC_ID_PROCESSOR_CYCLES, IRM_METRIC_ID_HEAP_INFO };
 
-uint32_t g_irm_pool_metric_capabilities[] = {  };
+#if defined(IRM_USES_PERF_EVENTS)
+uint32_t g_irm_module_metric_capabilities[] = { IRM_METRIC_ID_PROCESSOR_CYCLES,
+                                                IRM_METRIC_ID_PACKET_COUNT,
+                                                IRM_METRIC_ID_HEAP_INFO };
+#else
+uint32_t g_irm_module_metric_capabilities[] = { IRM_METRIC_ID_PROCESSOR_CYCLES, IRM_METRIC_ID_HEAP_INFO };
+#endif
 
-uint32_t g_irm_static_mod_metric_capabilities[] = {  };
+uint32_t g_irm_pool_metric_capabilities[] = { IRM_METRIC_ID_HEAP_INFO };
 
+uint32_t g_irm_static_mod_metric_capabilities[] = { IRM_METRIC_ID_PROCESSOR_CYCLES, IRM_METRIC_ID_HEAP_INFO };
 
 irm_capability_node_t g_capability_list[] = {
    { .block_id       = IRM_BLOCK_ID_PROCESSOR,
@@ -67,6 +83,105 @@ irm_capability_node_t g_capability_list[] = {
 irm_capability_node_t *g_capability_list_ptr   = &g_capability_list[0];
 uint32_t               g_num_capability_blocks = sizeof(g_capability_list) / sizeof(irm_capability_node_t);
 
+#if defined(IRM_USES_PERF_EVENTS)
+/*----------------------------------------------------------------------------------------------------------------------
+ Per thread perf counter group, cycles as the leader and instructions as the member, opened on first use by each
+ thread which runs a profiled module and closed when the thread exits.
+----------------------------------------------------------------------------------------------------------------------*/
+#define IRM_LX_PERF_NOT_OPENED (-2)
+#define IRM_LX_PERF_UNAVAILABLE (-1)
+
+static pthread_key_t  irm_lx_perf_key;
+static pthread_once_t irm_lx_perf_once = PTHREAD_ONCE_INIT;
+static __thread int   irm_lx_perf_fd[2] = { IRM_LX_PERF_NOT_OPENED, IRM_LX_PERF_NOT_OPENED };
+
+static void irm_lx_perf_thread_exit(void *arg)
+{
+   for (uint32_t i = 0; i < 2; i++)
+   {
+      if (irm_lx_perf_fd[i] >= 0)
+      {
+         close(irm_lx_perf_fd[i]);
+      }
+      irm_lx_perf_fd[i] = IRM_LX_PERF_UNAVAILABLE;
+   }
+}
+
+static void irm_lx_perf_key_create(void)
+{
+   pthread_key_create(&irm_lx_perf_key, irm_lx_perf_thread_exit);
+}
+
+static int irm_lx_perf_open(uint64_t config, int group_fd)
+{
+   struct perf_event_attr attr;
+   memset(&attr, 0, sizeof(attr));
+   attr.type           = PERF_TYPE_HARDWARE;
+   attr.size           = sizeof(attr);
+   attr.config         = config;
+   attr.exclude_kernel = 1;
+   attr.exclude_hv     = 1;
+   attr.read_format    = PERF_FORMAT_GROUP;
+   return (int)syscall(__NR_perf_event_open, &attr, 0 /* calling thread */, -1 /* any cpu */, group_fd, 0);
+}
+
+static void irm_lx_perf_thread_init(void)
+{
+   pthread_once(&irm_lx_perf_once, irm_lx_perf_key_create);
+
+   irm_lx_perf_fd[0] = irm_lx_perf_open(PERF_COUNT_HW_CPU_CYCLES, -1);
+   irm_lx_perf_fd[1] = (irm_lx_perf_fd[0] >= 0) ? irm_lx_perf_open(PERF_COUNT_HW_INSTRUCTIONS, irm_lx_perf_fd[0])
+                                                : IRM_LX_PERF_UNAVAILABLE;
+   if (irm_lx_perf_fd[1] < 0)
+   {
+      AR_MSG(DBG_ERROR_PRIO, "IRM: perf counters unavailable for this thread, module cycles will read 0");
+      irm_lx_perf_thread_exit(NULL);
+      return;
+   }
+   // Only needed to get the destructor called, the fds live in thread local storage
+   pthread_setspecific(irm_lx_perf_key, (void *)irm_lx_perf_fd);
+}
+
+void irm_lx_get_curr_thread_counters(uint64_t *cycles_ptr, uint64_t *pktcnt_ptr)
+{
+   struct
+   {
+      uint64_t nr;
+      uint64_t values[2];
+   } group = { 0 };
+
+   *cycles_ptr = 0;
+   *pktcnt_ptr = 0;
+
+   if (IRM_LX_PERF_NOT_OPENED == irm_lx_perf_fd[0])
+   {
+      irm_lx_perf_thread_init();
+   }
+   if ((irm_lx_perf_fd[0] < 0) || (sizeof(group) != read(irm_lx_perf_fd[0], &group, sizeof(group))))
+   {
+      return;
+   }
+   *cycles_ptr = group.values[0];
+   *pktcnt_ptr = group.values[1];
+}
+#endif
+
+/*----------------------------------------------------------------------------------------------------------------------
+ Returns the CPU time consumed so far by the given thread of this process in us, 0 if it cannot be read.
+----------------------------------------------------------------------------------------------------------------------*/
+static uint64_t irm_lx_get_thread_cpu_time_us(int64_t thread_id)
+{
+   clockid_t       clock_id;
+   struct timespec ts = { 0 };
+
+   if ((0 == thread_id) || (0 != pthread_getcpuclockid((pthread_t)thread_id, &clock_id)) ||
+       (0 != clock_gettime(clock_id, &ts)))
+   {
+      return 0;
+   }
+   return ((uint64_t)ts.tv_sec * 1000000) + ((uint64_t)ts.tv_nsec / 1000);
+}
+
 /*----------------------------------------------------------------------------------------------------------------------
 
 ----------------------------------------------------------------------------------------------------------------------*/
@@ -152,18 +267,15 @@ void irm_get_supported_metric_arr(uint32_t block_id, uint32_t **metric_id_list,
    }
 }
 
-static ar_result_t irm_fill_processor_metric(irm_t                *irm_ptr,
-                                             irm_node_obj_t       *metric_obj_ptr,
-                                             uint32_t              frame_size_ms)
+/*----------------------------------------------------------------------------------------------------------------------
+ Returns the payload of the current profiling tick in the report of the given metric and marks it valid.
+----------------------------------------------------------------------------------------------------------------------*/
+static irm_report_metric_payload_t *irm_get_curr_report_payload(irm_t          *irm_ptr,
+                                                                irm_node_obj_t *metric_obj_ptr,
+                                                                uint32_t        frame_size_ms)
 {
-   ar_result_t result = AR_EOK;
-   if (NULL == metric_obj_ptr)
-   {
-      result = AR_EFAILED;
-      return result;
-   }
-   irm_report_metric_t    *report_metric_ptr = (irm_report_metric_t *)metric_obj_ptr->metric_info.metric_payload_ptr;
-   report_metric_ptr->num_metric_payloads    = irm_ptr->core.timer_tick_counter + 1;
+   irm_report_metric_t *report_metric_ptr = (irm_report_metric_t *)metric_obj_ptr->metric_info.metric_payload_ptr;
+   report_metric_ptr->num_metric_payloads = irm_ptr->core.timer_tick_counter + 1;
    report_metric_ptr++;
 
    uint32_t metric_size = irm_get_metric_payload_size(metric_obj_ptr->id);
@@ -176,6 +288,132 @@ static ar_result_t irm_fill_processor_metric(irm_t                *irm_ptr,
    report_metric_payload_ptr->is_valid      = 1;
    report_metric_payload_ptr->frame_size_ms = frame_size_ms;
    report_metric_payload_ptr->payload_size  = metric_size;
+   return report_metric_payload_ptr;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+ Fills the delta of a free running counter, the first sample only primes the previous value and is marked invalid.
+----------------------------------------------------------------------------------------------------------------------*/
+static uint32_t irm_fill_counter_delta(irm_report_metric_payload_t *report_metric_payload_ptr,
+                                       irm_node_obj_t              *metric_obj_ptr,
+                                       uint64_t                    *prev_value_ptr,
+                                       uint64_t                     curr_value,
+                                       uint32_t                     scale)
+{
+   uint32_t delta = 0;
+   if (!metric_obj_ptr->is_first_time)
+   {
+      delta = (uint32_t)((curr_value - *prev_value_ptr) / scale);
+   }
+   else
+   {
+      report_metric_payload_ptr->is_valid      = 0;
+      report_metric_payload_ptr->frame_size_ms = 0;
+      metric_obj_ptr->is_first_time            = FALSE;
+   }
+   *prev_value_ptr = curr_value;
+   return delta;
+}
+
+static void irm_fill_thread_cycles_metric(irm_report_metric_payload_t *report_metric_payload_ptr,
+                                          irm_node_obj_t              *metric_obj_ptr,
+                                          int64_t                      thread_id,
+                                          uint32_t                     instance_id)
+{
+   irm_metric_id_processor_cycles_t *payload_ptr = (irm_metric_id_processor_cycles_t *)(report_metric_payload_ptr + 1);
+   irm_prev_metric_processor_cycles_t *prev_ptr =
+      (irm_prev_metric_processor_cycles_t *)metric_obj_ptr->metric_info.prev_statistic_ptr;
+
+   payload_ptr->processor_cycles = irm_fill_counter_delta(report_metric_payload_ptr,
+                                                          metric_obj_ptr,
+                                                          &prev_ptr->processor_cycles,
+                                                          irm_lx_get_thread_cpu_time_us(thread_id),
+                                                          1);
+#if IRM_DEBUG
+   AR_MSG(DBG_HIGH_PRIO, "IRM: IID = 0x%X, cpu time us = %lu", instance_id, payload_ptr->processor_cycles);
+#endif
+}
+
+static void irm_fill_cntr_or_module_heap_metric(irm_node_obj_t              *instance_obj_ptr,
+                                                irm_report_metric_payload_t *report_metric_payload_ptr)
+{
+   irm_metric_id_heap_info_t *payload_ptr = (irm_metric_id_heap_info_t *)(report_metric_payload_ptr + 1);
+   payload_ptr->num_heap_id               = IRM_MAX_NUM_HEAP_ID;
+   irm_per_heap_id_info_payload_t *per_heap_id_payload_ptr = (irm_per_heap_id_info_payload_t *)(payload_ptr + 1);
+
+   uint32_t regular_heap_usage = 0;
+   uint32_t island_heap_usage  = 0;
+
+   for (uint32_t heap_idx = 0; heap_idx < POSAL_HEAP_MGR_HEAP_INDEX_END; heap_idx++)
+   {
+      uint32_t      heap_usage = 0;
+      POSAL_HEAP_ID heap_id    = instance_obj_ptr->heap_id | heap_idx;
+      posal_mem_prof_query(heap_id, &heap_usage);
+      // Internally there may be more heaps but they are classified into island and non-island.
+      if (POSAL_IS_ISLAND_HEAP_ID(heap_id))
+      {
+         island_heap_usage += heap_usage;
+      }
+      else
+      {
+         regular_heap_usage += heap_usage;
+      }
+   }
+
+   per_heap_id_payload_ptr[0].heap_id               = 0;
+   per_heap_id_payload_ptr[0].current_heap_usage    = regular_heap_usage;
+   per_heap_id_payload_ptr[0].max_allowed_heap_size = 0;
+   per_heap_id_payload_ptr[1].heap_id               = 1;
+   per_heap_id_payload_ptr[1].current_heap_usage    = island_heap_usage;
+   per_heap_id_payload_ptr[1].max_allowed_heap_size = 0;
+#if IRM_DEBUG
+   AR_MSG(DBG_HIGH_PRIO,
+          "IRM: IID = 0x%X, heap id = 0x%X, current_heap_usage0 = %lu, current_heap_usage1 = %lu",
+          instance_obj_ptr->id,
+          instance_obj_ptr->heap_id,
+          per_heap_id_payload_ptr[0].current_heap_usage,
+          per_heap_id_payload_ptr[1].current_heap_usage);
+#endif
+}
+
+static void irm_fill_pool_heap_metric(irm_node_obj_t              *instance_obj_ptr,
+                                      irm_report_metric_payload_t *report_metric_payload_ptr)
+{
+   irm_metric_id_heap_info_t *payload_ptr = (irm_metric_id_heap_info_t *)(report_metric_payload_ptr + 1);
+   payload_ptr->num_heap_id               = IRM_MAX_NUM_HEAP_ID;
+   irm_per_heap_id_info_payload_t *per_heap_id_payload_ptr = (irm_per_heap_id_info_payload_t *)(payload_ptr + 1);
+
+   uint32_t pool_used = 0;
+
+   switch (instance_obj_ptr->id)
+   {
+      case IRM_POOL_ID_LIST:
+         pool_used = posal_bufpool_profile_all_mem_usage();
+   }
+
+   per_heap_id_payload_ptr[0].heap_id               = 0;
+   per_heap_id_payload_ptr[0].current_heap_usage    = pool_used;
+   per_heap_id_payload_ptr[0].max_allowed_heap_size = 0;
+   per_heap_id_payload_ptr[1].heap_id               = 1;
+   per_heap_id_payload_ptr[1].current_heap_usage    = 0;
+   per_heap_id_payload_ptr[1].max_allowed_heap_size = 0;
+#if IRM_DEBUG
+   AR_MSG(DBG_HIGH_PRIO, "IRM: pool id = 0x%X, pool usage = %lu", instance_obj_ptr->id, pool_used);
+#endif
+}
+
+static ar_result_t irm_fill_processor_metric(irm_t          *irm_ptr,
+                                             irm_node_obj_t *metric_obj_ptr,
+                                             uint32_t        frame_size_ms)
+{
+   ar_result_t result = AR_EOK;
+   if (NULL == metric_obj_ptr)
+   {
+      result = AR_EFAILED;
+      return result;
+   }
+   irm_report_metric_payload_t *report_metric_payload_ptr =
+      irm_get_curr_report_payload(irm_ptr, metric_obj_ptr, frame_size_ms);
 
    switch (metric_obj_ptr->id)
    {
@@ -185,59 +423,186 @@ static ar_result_t irm_fill_processor_metric(irm_t                *irm_ptr,
             (irm_metric_id_processor_cycles_t *)(report_metric_payload_ptr + 1);
          irm_prev_metric_processor_cycles_t *prev_ptr =
             (irm_prev_metric_processor_cycles_t *)metric_obj_ptr->metric_info.prev_statistic_ptr;
-		uint32_t total_time_active = 0;
-		
-		{
-			//https://pubs.opengroup.org/onlinepubs/009604499/basedefs/sys/time.h.html
-			struct rusage usage = {0};
-			int rc = getrusage(RUSAGE_SELF, &usage);
-			if (rc)
-			{
-				AR_MSG(DBG_HIGH_PRIO, "getrusage returned error %d\n", rc);
-			}
-			else
-			{
-				total_time_active = (uint32_t) ((usage.ru_utime.tv_sec*1000000.0+usage.ru_utime.tv_usec)/1000000.0 + 
-				(usage.ru_stime.tv_sec*1000000.0+usage.ru_stime.tv_usec)/1000000.0);
-				
-				AR_MSG(DBG_HIGH_PRIO," User time %f sec\n System time %f sec. total_time_active %lu\n", \
-						(usage.ru_utime.tv_sec*1000000.0+usage.ru_utime.tv_usec)/1000000.0, \
-						(usage.ru_stime.tv_sec*1000000.0+usage.ru_stime.tv_usec)/1000000.0,
-						total_time_active
-						);
-			}
-		}
-		//for now, report amount of time we are active
-        payload_ptr->processor_cycles = (uint32_t)(total_time_active - prev_ptr->processor_cycles);
+         uint64_t total_time_active_us = 0;
+
+         // https://pubs.opengroup.org/onlinepubs/009604499/basedefs/sys/time.h.html
+         struct rusage usage = { 0 };
+         int           rc    = getrusage(RUSAGE_SELF, &usage);
+         if (rc)
+         {
+            AR_MSG(DBG_HIGH_PRIO, "getrusage returned error %d", rc);
+         }
+         else
+         {
+            total_time_active_us = ((uint64_t)usage.ru_utime.tv_sec * 1000000) + (uint64_t)usage.ru_utime.tv_usec +
+                                   ((uint64_t)usage.ru_stime.tv_sec * 1000000) + (uint64_t)usage.ru_stime.tv_usec;
+         }
+
+         // Report the CPU time of the whole process, user and system, in us
+         payload_ptr->processor_cycles = (uint32_t)(total_time_active_us - prev_ptr->processor_cycles);
 
 #if IRM_DEBUG
-         AR_MSG(DBG_HIGH_PRIO, "IRM: pcyles = %lu", payload_ptr->processor_cycles);
+         AR_MSG(DBG_HIGH_PRIO, "IRM: cpu time us = %lu", payload_ptr->processor_cycles);
 #endif
-         prev_ptr->processor_cycles = total_time_active;
+         prev_ptr->processor_cycles = total_time_active_us;
          break;
       }
-      case IRM_BASIC_METRIC_ID_CURRENT_CLOCK:
+      default:
       {
          break;
       }
+   }
+   return result;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+ Container cycles are the CPU time of the container's command thread only. Parallel paths that the container hands to
+ the SPF thread pool run on pool threads, which may be shared by several containers, so their time is not part of this
+ metric. It is still counted in the module metrics, which sample the thread that runs process().
+----------------------------------------------------------------------------------------------------------------------*/
+static ar_result_t irm_fill_container_metrics(irm_t          *irm_ptr,
+                                              irm_node_obj_t *instance_obj_ptr,
+                                              irm_node_obj_t *metric_obj_ptr,
+                                              uint32_t        frame_size_ms)
+{
+   irm_report_metric_payload_t *report_metric_payload_ptr =
+      irm_get_curr_report_payload(irm_ptr, metric_obj_ptr, frame_size_ms);
+
+   if (NULL == instance_obj_ptr->handle_ptr)
+   {
+      // Packet cannot be filled with valid data if there is no handle
+      report_metric_payload_ptr->is_valid = 0;
+      return AR_EOK;
+   }
+
+   switch (metric_obj_ptr->id)
+   {
+      case IRM_METRIC_ID_PROCESSOR_CYCLES:
+      {
+         int64_t thread_id = posal_thread_get_tid_v2(instance_obj_ptr->handle_ptr->cmd_handle_ptr->thread_id);
+         irm_fill_thread_cycles_metric(report_metric_payload_ptr, metric_obj_ptr, thread_id, instance_obj_ptr->id);
+         break;
+      }
       case IRM_METRIC_ID_HEAP_INFO:
       {
-        break;
+         irm_fill_cntr_or_module_heap_metric(instance_obj_ptr, report_metric_payload_ptr);
+         break;
       }
-      case IRM_METRIC_ID_PACKET_COUNT:
+      default:
       {
          break;
       }
-      case IRM_METRIC_ID_MEM_TRANSACTIONS:
+   }
+   return AR_EOK;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+
+----------------------------------------------------------------------------------------------------------------------*/
+static ar_result_t irm_fill_static_module_metrics(irm_t          *irm_ptr,
+                                                  irm_node_obj_t *instance_obj_ptr,
+                                                  irm_node_obj_t *metric_obj_ptr,
+                                                  uint32_t        frame_size_ms)
+{
+   irm_report_metric_payload_t *report_metric_payload_ptr =
+      irm_get_curr_report_payload(irm_ptr, metric_obj_ptr, frame_size_ms);
+
+   if (NULL == instance_obj_ptr->static_module_info_ptr)
+   {
+      // Packet cannot be filled with valid data if there is no static module info
+      report_metric_payload_ptr->is_valid = 0;
+      return AR_EOK;
+   }
+
+   switch (metric_obj_ptr->id)
+   {
+      case IRM_METRIC_ID_PROCESSOR_CYCLES:
+      {
+         irm_fill_thread_cycles_metric(report_metric_payload_ptr,
+                                       metric_obj_ptr,
+                                       instance_obj_ptr->static_module_info_ptr->tid,
+                                       instance_obj_ptr->id);
+         break;
+      }
+      case IRM_METRIC_ID_HEAP_INFO:
+      {
+         irm_fill_cntr_or_module_heap_metric(instance_obj_ptr, report_metric_payload_ptr);
+         break;
+      }
+      default:
+      {
+         break;
+      }
+   }
+   return AR_EOK;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+ Module cycles and packet counts are accumulated by the container around process(), see irm_cntr_prof_util.h
+----------------------------------------------------------------------------------------------------------------------*/
+static ar_result_t irm_fill_module_metrics(irm_t          *irm_ptr,
+                                           irm_node_obj_t *instance_obj_ptr,
+                                           irm_node_obj_t *metric_obj_ptr,
+                                           uint32_t        frame_size_ms)
+{
+   irm_report_metric_payload_t *report_metric_payload_ptr =
+      irm_get_curr_report_payload(irm_ptr, metric_obj_ptr, frame_size_ms);
+
+   if (NULL == instance_obj_ptr->handle_ptr)
+   {
+      // Packet cannot be filled with valid data if there is no handle
+      report_metric_payload_ptr->is_valid = 0;
+      return AR_EOK;
+   }
+
+   uint64_t accum_value = 0;
+   if (NULL != metric_obj_ptr->metric_info.current_mod_statistics_ptr)
+   {
+      accum_value = *((uint64_t *)metric_obj_ptr->metric_info.current_mod_statistics_ptr);
+   }
+   else
+   {
+      metric_obj_ptr->is_first_time = TRUE;
+   }
+
+   switch (metric_obj_ptr->id)
+   {
+      case IRM_METRIC_ID_PROCESSOR_CYCLES:
       {
+         irm_metric_id_processor_cycles_t *payload_ptr =
+            (irm_metric_id_processor_cycles_t *)(report_metric_payload_ptr + 1);
+         irm_prev_metric_processor_cycles_t *prev_ptr =
+            (irm_prev_metric_processor_cycles_t *)metric_obj_ptr->metric_info.prev_statistic_ptr;
+
+         payload_ptr->processor_cycles = irm_fill_counter_delta(report_metric_payload_ptr,
+                                                                metric_obj_ptr,
+                                                                &prev_ptr->processor_cycles,
+                                                                accum_value,
+                                                                IRM_LX_MOD_CYCLES_SCALE);
+#if IRM_DEBUG
+         AR_MSG(DBG_HIGH_PRIO, "IRM: IID = 0x%X, pcyles = %lu", instance_obj_ptr->id, payload_ptr->processor_cycles);
+#endif
          break;
       }
-      case IRM_METRIC_ID_Q6_HW_INFO:
+      case IRM_METRIC_ID_PACKET_COUNT:
       {
+         irm_metric_id_packet_count_t   *payload_ptr = (irm_metric_id_packet_count_t *)(report_metric_payload_ptr + 1);
+         irm_prev_metric_packet_count_t *prev_ptr =
+            (irm_prev_metric_packet_count_t *)metric_obj_ptr->metric_info.prev_statistic_ptr;
+
+         payload_ptr->packet_count = irm_fill_counter_delta(report_metric_payload_ptr,
+                                                            metric_obj_ptr,
+                                                            &prev_ptr->packet_count,
+                                                            accum_value,
+                                                            1);
+#if IRM_DEBUG
+         AR_MSG(DBG_HIGH_PRIO, "IRM: IID = 0x%X, packet_count = %lu", instance_obj_ptr->id, payload_ptr->packet_count);
+#endif
          break;
       }
-      case IRM_METRIC_ID_TIMESTAMP:
+      case IRM_METRIC_ID_HEAP_INFO:
       {
+         irm_fill_cntr_or_module_heap_metric(instance_obj_ptr, report_metric_payload_ptr);
          break;
       }
       default:
@@ -245,7 +610,7 @@ static ar_result_t irm_fill_processor_metric(irm_t                *irm_ptr,
          break;
       }
    }
-   return result;
+   return AR_EOK;
 }
 
 /*----------------------------------------------------------------------------------------------------------------------
@@ -275,6 +640,135 @@ static ar_result_t irm_handle_processor_metrics(irm_t *irm_ptr, irm_node_obj_t *
    return AR_EOK;
 }
 
+/*----------------------------------------------------------------------------------------------------------------------
+ Containers and static modules are both profiled through their thread
+----------------------------------------------------------------------------------------------------------------------*/
+static ar_result_t irm_handle_thread_block_metrics(irm_t          *irm_ptr,
+                                                   irm_node_obj_t *block_obj_ptr,
+                                                   uint32_t        frame_size_ms)
+{
+   ar_result_t result = AR_EOK;
+
+   spf_list_node_t *instance_node_ptr = block_obj_ptr->head_node_ptr;
+
+   // For each container or static module,
+   for (; NULL != instance_node_ptr; LIST_ADVANCE(instance_node_ptr))
+   {
+      irm_node_obj_t *instance_obj_ptr = (irm_node_obj_t *)instance_node_ptr->obj_ptr;
+      if (NULL == instance_obj_ptr)
+      {
+         continue;
+      }
+
+      // For each metric,
+      for (spf_list_node_t *metric_node_ptr = instance_obj_ptr->head_node_ptr; NULL != metric_node_ptr;
+           LIST_ADVANCE(metric_node_ptr))
+      {
+         irm_node_obj_t *metric_obj_ptr = (irm_node_obj_t *)metric_node_ptr->obj_ptr;
+         if (NULL == metric_obj_ptr)
+         {
+            continue;
+         }
+         if (IRM_BLOCK_ID_CONTAINER == block_obj_ptr->id)
+         {
+            result |= irm_fill_container_metrics(irm_ptr, instance_obj_ptr, metric_obj_ptr, frame_size_ms);
+         }
+         else
+         {
+            result |= irm_fill_static_module_metrics(irm_ptr, instance_obj_ptr, metric_obj_ptr, frame_size_ms);
+         }
+      }
+   }
+   return result;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+
+----------------------------------------------------------------------------------------------------------------------*/
+static ar_result_t irm_handle_pool_metrics(irm_t *irm_ptr, irm_node_obj_t *block_obj_ptr, uint32_t frame_size_ms)
+{
+   spf_list_node_t *instance_node_ptr = block_obj_ptr->head_node_ptr;
+
+   for (; NULL != instance_node_ptr; LIST_ADVANCE(instance_node_ptr))
+   {
+      irm_node_obj_t *instance_obj_ptr = (irm_node_obj_t *)instance_node_ptr->obj_ptr;
+      if (NULL == instance_obj_ptr)
+      {
+         continue;
+      }
+
+      for (spf_list_node_t *metric_node_ptr = instance_obj_ptr->head_node_ptr; NULL != metric_node_ptr;
+           LIST_ADVANCE(metric_node_ptr))
+      {
+         irm_node_obj_t *metric_obj_ptr = (irm_node_obj_t *)metric_node_ptr->obj_ptr;
+         if ((NULL == metric_obj_ptr) || (IRM_METRIC_ID_HEAP_INFO != metric_obj_ptr->id))
+         {
+            continue;
+         }
+         irm_report_metric_payload_t *report_metric_payload_ptr =
+            irm_get_curr_report_payload(irm_ptr, metric_obj_ptr, frame_size_ms);
+         irm_fill_pool_heap_metric(instance_obj_ptr, report_metric_payload_ptr);
+      }
+   }
+   return AR_EOK;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+
+----------------------------------------------------------------------------------------------------------------------*/
+static ar_result_t irm_handle_module_metrics(irm_t *irm_ptr, irm_node_obj_t *block_obj_ptr, uint32_t frame_size_ms)
+{
+   ar_result_t result = AR_EOK;
+
+   spf_list_node_t *module_node_ptr = block_obj_ptr->head_node_ptr;
+
+   // For each module,
+   for (; NULL != module_node_ptr; LIST_ADVANCE(module_node_ptr))
+   {
+      irm_node_obj_t *instance_obj_ptr = (irm_node_obj_t *)module_node_ptr->obj_ptr;
+      if (NULL == instance_obj_ptr)
+      {
+         continue;
+      }
+
+      // The container updates cycles and packet counts together under its prof mutex, hold it so both are read from
+      // the same set of process calls.
+      bool_t is_mutex_valid = (NULL != instance_obj_ptr->mod_mutex_ptr) && (NULL != *instance_obj_ptr->mod_mutex_ptr);
+      if (is_mutex_valid)
+      {
+         posal_mutex_lock(*instance_obj_ptr->mod_mutex_ptr);
+      }
+
+      for (spf_list_node_t *metric_node_ptr = instance_obj_ptr->head_node_ptr; NULL != metric_node_ptr;
+           LIST_ADVANCE(metric_node_ptr))
+      {
+         irm_node_obj_t *metric_obj_ptr = (irm_node_obj_t *)metric_node_ptr->obj_ptr;
+         if (NULL == metric_obj_ptr)
+         {
+            continue;
+         }
+
+         if (is_mutex_valid || (IRM_METRIC_ID_HEAP_INFO == metric_obj_ptr->id))
+         {
+            result |= irm_fill_module_metrics(irm_ptr, instance_obj_ptr, metric_obj_ptr, frame_size_ms);
+         }
+         else
+         {
+            // The container has not enabled profiling for this module yet
+            irm_report_metric_payload_t *report_metric_payload_ptr =
+               irm_get_curr_report_payload(irm_ptr, metric_obj_ptr, frame_size_ms);
+            report_metric_payload_ptr->is_valid = 0;
+         }
+      }
+
+      if (is_mutex_valid)
+      {
+         posal_mutex_unlock(*instance_obj_ptr->mod_mutex_ptr);
+      }
+   }
+   return result;
+}
+
 
 ar_result_t irm_profiler_init(irm_t *irm_ptr)
 {
@@ -317,24 +811,19 @@ ar_result_t irm_collect_and_fill_info(irm_t *irm_ptr, uint32_t frame_size_ms)
                break;
             }
             case IRM_BLOCK_ID_CONTAINER:
-            {
-               //result |= irm_handle_container_metrics(irm_ptr, block_obj_ptr, frame_size_ms);
-               break;
-            }
             case IRM_BLOCK_ID_STATIC_MODULE:
             {
-               //result |= irm_handle_static_module_metrics(irm_ptr, block_obj_ptr, frame_size_ms);
+               result |= irm_handle_thread_block_metrics(irm_ptr, block_obj_ptr, frame_size_ms);
                break;
             }
-
             case IRM_BLOCK_ID_MODULE:
             {
-               //result |= irm_handle_module_metrics(irm_ptr, block_obj_ptr, frame_size_ms);
+               result |= irm_handle_module_metrics(irm_ptr, block_obj_ptr, frame_size_ms);
                break;
             }
             case IRM_BLOCK_ID_POOL:
             {
-               //result |= irm_handle_pool_metrics(irm_ptr, block_obj_ptr, frame_size_ms);
+               result |= irm_handle_pool_metrics(irm_ptr, block_obj_ptr, frame_size_ms);
                break;
             }
             default:
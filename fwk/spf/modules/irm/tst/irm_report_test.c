@@ -0,0 +1,324 @@
+/***
+ * \file irm_report_test.c
+ * \brief
+ *    This file tests the report generated by the Linux IRM driver. A fake container thread burns CPU itself and then
+ *    runs a module on a worker thread, the way parallel paths run on the SPF thread pool. The report is collected
+ *    twice and parsed: the layout must match the enabled blocks and metrics, the processor metric must cover both
+ *    threads, the module metric must count the worker time and the container metric only the container thread.
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "irm_report_test.h"
+#include "irm_i.h"
+#include "irm_cntr_prof_util.h"
+#include <sched.h>
+
+#define IRM_TEST_CNTR_IID (0x1000)
+#define IRM_TEST_MODULE_IID (0x2000)
+#define IRM_TEST_NUM_BLOCKS (3)
+#define IRM_TEST_FRAME_SIZE_MS (100)
+#define IRM_TEST_CNTR_BURN_US (30000)
+#define IRM_TEST_WORKER_BURN_US (60000)
+#define IRM_TEST_TOLERANCE_US (3000)
+
+/* Module statistics in the layout gen_topo_module_prof_info_t reports them to IRM */
+typedef struct irm_test_prof_info_t
+{
+   uint64_t accum_pcylces;
+   uint64_t accum_pktcnt;
+} irm_test_prof_info_t;
+
+typedef struct irm_test_ctx_t
+{
+   posal_mutex_t               prof_mutex;
+   irm_test_prof_info_t        prof_info;        /* accumulated by the worker like gen_topo does around process() */
+   uint64_t                    cntr_cpu_us;      /* CPU time of the container thread between go and done */
+   uint64_t                    worker_cpu_us;    /* CPU time of the worker thread */
+   volatile uint32_t           started;          /* set by the container thread once it runs */
+   volatile uint32_t           go;               /* set by the test after the first collection */
+   volatile uint32_t           done;             /* set by the container thread once the frame is processed */
+   volatile uint32_t           release;          /* set by the test after the second collection */
+   ar_result_t                 result;
+} irm_test_ctx_t;
+
+/********************************************************************************/
+static uint64_t irm_test_thread_cpu_us(void)
+{
+   struct timespec ts = { 0 };
+   clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+   return ((uint64_t)ts.tv_sec * 1000000) + ((uint64_t)ts.tv_nsec / 1000);
+}
+
+static void irm_test_burn(uint64_t cpu_us)
+{
+   uint64_t start_us = irm_test_thread_cpu_us();
+   while ((irm_test_thread_cpu_us() - start_us) < cpu_us)
+   {
+   }
+}
+
+static void irm_test_wait(volatile uint32_t *flag_ptr)
+{
+   // sleep rather than spin, so that waiting does not add to the CPU time under test
+   while (!*flag_ptr)
+   {
+      posal_timer_sleep(1000);
+   }
+}
+
+static ar_result_t irm_test_launch(posal_thread_t *tid_ptr, ar_result_t (*fn)(void *), void *arg_ptr)
+{
+   return posal_thread_launch3(tid_ptr, "IRM_TEST", 16 * 1024, 0, 0, fn, arg_ptr, POSAL_HEAP_DEFAULT, SCHED_OTHER, 0);
+}
+
+static ar_result_t irm_test_worker(void *arg_ptr)
+{
+   irm_test_ctx_t       *ctx_ptr       = (irm_test_ctx_t *)arg_ptr;
+   irm_test_prof_info_t *prof_info_ptr = &ctx_ptr->prof_info;
+   uint64_t              start_us      = irm_test_thread_cpu_us();
+
+   IRM_PROFILE_MOD_PROCESS_SECTION(prof_info_ptr, ctx_ptr->prof_mutex, irm_test_burn(IRM_TEST_WORKER_BURN_US););
+
+   ctx_ptr->worker_cpu_us = irm_test_thread_cpu_us() - start_us;
+   return AR_EOK;
+}
+
+static ar_result_t irm_test_container(void *arg_ptr)
+{
+   irm_test_ctx_t *ctx_ptr = (irm_test_ctx_t *)arg_ptr;
+   posal_thread_t  worker_tid;
+   ar_result_t     worker_result = AR_EOK;
+
+   ctx_ptr->started = 1;
+   irm_test_wait(&ctx_ptr->go);
+
+   uint64_t start_us = irm_test_thread_cpu_us();
+   irm_test_burn(IRM_TEST_CNTR_BURN_US);
+
+   // hand the module to another thread and wait for it, like a parallel path job on the thread pool
+   ctx_ptr->result = irm_test_launch(&worker_tid, irm_test_worker, ctx_ptr);
+   if (AR_SUCCEEDED(ctx_ptr->result))
+   {
+      posal_thread_join(worker_tid, &worker_result);
+      ctx_ptr->result = worker_result;
+   }
+
+   ctx_ptr->cntr_cpu_us = irm_test_thread_cpu_us() - start_us;
+   ctx_ptr->done        = 1;
+   irm_test_wait(&ctx_ptr->release);
+   return AR_EOK;
+}
+
+/* Enables the processor cycles metric of one instance, returns the instance object */
+static irm_node_obj_t *irm_test_insert(irm_t *irm_ptr, uint32_t block_id, uint32_t instance_id)
+{
+   irm_node_obj_t *block_obj_ptr    = irm_check_insert_node(irm_ptr, &irm_ptr->core.block_head_node_ptr, block_id);
+   irm_node_obj_t *instance_obj_ptr = NULL;
+
+   if ((NULL == block_obj_ptr) ||
+       (NULL == (instance_obj_ptr = irm_check_insert_node(irm_ptr, &block_obj_ptr->head_node_ptr, instance_id))) ||
+       (NULL == irm_check_insert_node(irm_ptr, &instance_obj_ptr->head_node_ptr, IRM_METRIC_ID_PROCESSOR_CYCLES)))
+   {
+      return NULL;
+   }
+   ((irm_node_obj_t *)instance_obj_ptr->head_node_ptr->obj_ptr)->is_first_time = TRUE;
+   return instance_obj_ptr;
+}
+
+static bool_t irm_test_check_near(const char *name_ptr, uint64_t value, uint64_t expected)
+{
+   uint64_t diff = (value > expected) ? (value - expected) : (expected - value);
+   if (diff > IRM_TEST_TOLERANCE_US)
+   {
+      AR_MSG(DBG_ERROR_PRIO,
+             "IRM test: %s reports %lu us, expected %lu us",
+             name_ptr,
+             (uint32_t)value,
+             (uint32_t)expected);
+      return FALSE;
+   }
+   return TRUE;
+}
+
+/* Walks the report and checks its layout, returns the processor cycles of each block in block order */
+static ar_result_t irm_test_parse_report(irm_t *irm_ptr, uint32_t cycles[IRM_TEST_NUM_BLOCKS])
+{
+   static const uint32_t block_ids[IRM_TEST_NUM_BLOCKS]    = { IRM_BLOCK_ID_PROCESSOR,
+                                                               IRM_BLOCK_ID_CONTAINER,
+                                                               IRM_BLOCK_ID_MODULE };
+   static const uint32_t instance_ids[IRM_TEST_NUM_BLOCKS] = { 0, IRM_TEST_CNTR_IID, IRM_TEST_MODULE_IID };
+
+   uint8_t          *payload_ptr    = irm_ptr->core.report_payload_ptr;
+   uint8_t          *end_ptr        = payload_ptr + irm_ptr->core.report_payload_size;
+   irm_rtm_header_t *rtm_header_ptr = (irm_rtm_header_t *)payload_ptr;
+
+   if ((NULL == payload_ptr) || (PARAM_ID_IRM_REPORT_METRICS != rtm_header_ptr->rtm_header.param_id) ||
+       (IRM_MODULE_INSTANCE_ID != rtm_header_ptr->rtm_header.module_instance_id) ||
+       (irm_ptr->core.report_payload_size != rtm_header_ptr->rtm_header.param_size + sizeof(irm_rtm_header_t)))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "IRM test: bad report header");
+      return AR_EFAILED;
+   }
+
+   param_id_report_metrics_t *report_ptr = (param_id_report_metrics_t *)(rtm_header_ptr + 1);
+   if (IRM_TEST_NUM_BLOCKS != report_ptr->num_blocks)
+   {
+      AR_MSG(DBG_ERROR_PRIO, "IRM test: report has %lu blocks", report_ptr->num_blocks);
+      return AR_EFAILED;
+   }
+
+   uint8_t *curr_ptr = (uint8_t *)(report_ptr + 1);
+   for (uint32_t i = 0; i < IRM_TEST_NUM_BLOCKS; i++)
+   {
+      irm_report_metrics_block_t  *block_ptr   = (irm_report_metrics_block_t *)curr_ptr;
+      irm_report_metric_t         *metric_ptr  = (irm_report_metric_t *)(block_ptr + 1);
+      irm_report_metric_payload_t *payload_hdr = (irm_report_metric_payload_t *)(metric_ptr + 1);
+      irm_metric_id_processor_cycles_t *cycles_ptr = (irm_metric_id_processor_cycles_t *)(payload_hdr + 1);
+
+      curr_ptr = (uint8_t *)(cycles_ptr + 1);
+      if ((curr_ptr > end_ptr) || (block_ids[i] != block_ptr->block_id) ||
+          (instance_ids[i] != block_ptr->instance_id) || (1 != block_ptr->num_metric_ids) ||
+          (IRM_METRIC_ID_PROCESSOR_CYCLES != metric_ptr->metric_id) || (1 != metric_ptr->num_metric_payloads) ||
+          (sizeof(irm_metric_id_processor_cycles_t) != payload_hdr->payload_size))
+      {
+         AR_MSG(DBG_ERROR_PRIO, "IRM test: bad metric layout in block %lu", i);
+         return AR_EFAILED;
+      }
+      if ((1 != payload_hdr->is_valid) || (IRM_TEST_FRAME_SIZE_MS != payload_hdr->frame_size_ms))
+      {
+         AR_MSG(DBG_ERROR_PRIO, "IRM test: metric of block id %lu is not valid", block_ptr->block_id);
+         return AR_EFAILED;
+      }
+      cycles[i] = cycles_ptr->processor_cycles;
+   }
+
+   if (curr_ptr != end_ptr)
+   {
+      AR_MSG(DBG_ERROR_PRIO, "IRM test: report has %lu trailing bytes", (uint32_t)(end_ptr - curr_ptr));
+      return AR_EFAILED;
+   }
+   return AR_EOK;
+}
+
+/********************************************************************************/
+ar_result_t irm_report_test()
+{
+   ar_result_t       result          = AR_EOK;
+   irm_t             irm;
+   irm_test_ctx_t    ctx;
+   spf_cmd_handle_t  cntr_cmd_handle;
+   spf_handle_t      cntr_handle;
+   posal_thread_t    cntr_tid;
+   ar_result_t       cntr_result     = AR_EOK;
+   uint32_t          cycles[IRM_TEST_NUM_BLOCKS];
+   irm_node_obj_t   *cntr_obj_ptr    = NULL;
+   irm_node_obj_t   *module_obj_ptr  = NULL;
+
+   AR_MSG(DBG_HIGH_PRIO, "IRM report test entry.");
+
+   memset(&irm, 0, sizeof(irm));
+   memset(&ctx, 0, sizeof(ctx));
+   memset(&cntr_cmd_handle, 0, sizeof(cntr_cmd_handle));
+   memset(&cntr_handle, 0, sizeof(cntr_handle));
+
+   // IRM lists take their nodes from the SPF list pool, normally created by spf_framework_pre_init
+   spf_list_buf_pool_init(POSAL_HEAP_DEFAULT, 4, 16);
+
+   irm.heap_id                      = POSAL_HEAP_DEFAULT;
+   irm.core.num_profiles_per_report = IRM_MIN_PROFILES_PER_REPORT_1;
+   irm.core.irm_bufpool_handle =
+      posal_bufpool_pool_create(sizeof(irm_node_obj_t), irm.heap_id, IRM_NUM_BUF_POOL_ARRAYS, FOUR_BYTE_ALIGN, 16);
+   if ((POSAL_BUFPOOL_INVALID_HANDLE == irm.core.irm_bufpool_handle) ||
+       AR_FAILED(posal_mutex_create(&ctx.prof_mutex, irm.heap_id)))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "IRM test: setup failed");
+      spf_list_buf_pool_deinit(POSAL_HEAP_DEFAULT);
+      return AR_EFAILED;
+   }
+
+   if (AR_FAILED(irm_test_launch(&cntr_tid, irm_test_container, &ctx)))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "IRM test: container thread launch failed");
+      posal_mutex_destroy(&ctx.prof_mutex);
+      posal_bufpool_pool_destroy(irm.core.irm_bufpool_handle);
+      spf_list_buf_pool_deinit(POSAL_HEAP_DEFAULT);
+      return AR_EFAILED;
+   }
+   irm_test_wait(&ctx.started);
+   cntr_cmd_handle.thread_id  = cntr_tid;
+   cntr_handle.cmd_handle_ptr = &cntr_cmd_handle;
+
+   // Enable processor cycles for the processor, the container and its module, as the enable handler would
+   if ((NULL == irm_test_insert(&irm, IRM_BLOCK_ID_PROCESSOR, 0)) ||
+       (NULL == (cntr_obj_ptr = irm_test_insert(&irm, IRM_BLOCK_ID_CONTAINER, IRM_TEST_CNTR_IID))) ||
+       (NULL == (module_obj_ptr = irm_test_insert(&irm, IRM_BLOCK_ID_MODULE, IRM_TEST_MODULE_IID))) ||
+       AR_FAILED(irm_recreate_report_payload(&irm)) || AR_FAILED(irm_populate_report_payload_info(&irm)))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "IRM test: failed to create the report");
+      result = AR_EFAILED;
+   }
+   else
+   {
+      // Handles and statistics pointers, as returned by APM and by the container
+      cntr_obj_ptr->handle_ptr       = &cntr_handle;
+      module_obj_ptr->handle_ptr     = &cntr_handle;
+      module_obj_ptr->cntr_iid       = IRM_TEST_CNTR_IID;
+      module_obj_ptr->mod_mutex_ptr  = &ctx.prof_mutex;
+      ((irm_node_obj_t *)module_obj_ptr->head_node_ptr->obj_ptr)->metric_info.current_mod_statistics_ptr =
+         &ctx.prof_info.accum_pcylces;
+
+      // The first collection only primes the previous values
+      result |= irm_collect_and_fill_info(&irm, 0);
+      ctx.go = 1;
+      irm_test_wait(&ctx.done);
+      result |= irm_collect_and_fill_info(&irm, IRM_TEST_FRAME_SIZE_MS);
+      result |= ctx.result;
+
+      if (AR_SUCCEEDED(result) && AR_SUCCEEDED(result = irm_test_parse_report(&irm, cycles)))
+      {
+         AR_MSG(DBG_HIGH_PRIO,
+                "IRM test: processor %lu us, container %lu us (own %lu us), module %lu us (worker %lu us)",
+                cycles[0],
+                cycles[1],
+                (uint32_t)ctx.cntr_cpu_us,
+                cycles[2],
+                (uint32_t)ctx.worker_cpu_us);
+
+         // The module is profiled on the thread that processed it
+         if (!irm_test_check_near("module", cycles[2], ctx.worker_cpu_us))
+         {
+            result = AR_EFAILED;
+         }
+         // The container metric covers the container thread only, the worker time is not part of it
+         if (!irm_test_check_near("container", cycles[1], ctx.cntr_cpu_us))
+         {
+            result = AR_EFAILED;
+         }
+         // The processor metric covers every thread of the process
+         if (cycles[0] + IRM_TEST_TOLERANCE_US < ctx.cntr_cpu_us + ctx.worker_cpu_us)
+         {
+            AR_MSG(DBG_ERROR_PRIO, "IRM test: processor reports %lu us, less than its threads", cycles[0]);
+            result = AR_EFAILED;
+         }
+      }
+   }
+
+   ctx.go      = 1;
+   ctx.release = 1;
+   posal_thread_join(cntr_tid, &cntr_result);
+
+   irm_clean_up_all_nodes(&irm);
+   if (NULL != irm.core.report_payload_ptr)
+   {
+      posal_memory_free(irm.core.report_payload_ptr);
+   }
+   posal_mutex_destroy(&ctx.prof_mutex);
+   posal_bufpool_pool_destroy(irm.core.irm_bufpool_handle);
+   spf_list_buf_pool_deinit(POSAL_HEAP_DEFAULT);
+
+   AR_MSG(DBG_HIGH_PRIO, "IRM report test %s.", AR_SUCCEEDED(result) ? "passed" : "failed");
+   return result;
+}
@@ -0,0 +1,19 @@
+#ifndef __IRM_REPORT_TEST_H__
+#define __IRM_REPORT_TEST_H__
+/***
+ * \file irm_report_test.h
+ * \brief
+ *    Header file for the Linux IRM report tests.
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "posal.h"
+
+/* Generates an IRM report for a container that offloads a module to a worker thread and parses it, returns AR_EOK
+ * if the report layout and the reported CPU times are as expected */
+ar_result_t irm_report_test();
+
+#endif //__IRM_REPORT_TEST_H__
@@ -102,6 +102,7 @@ capi_err_t capi_splitter_process(capi_t *_pif, capi_stream_data_t *input[], capi
          // if input MF is unpacked v2 read/update lengths only for the first ch's buffer
          uint32_t actual_data_len;
          uint32_t max_data_len_per_buf = output[j]->buf_ptr[0].max_data_len;
+         // same buffer when inplace or when fwk shares the input buffer (INTF_EXTN_SHARED_OUTPUT_BUFFER).
          if (input[0]->buf_ptr[i].data_ptr == output[j]->buf_ptr[i].data_ptr)
          {
             actual_data_len = MIN(max_data_len_per_buf, data_len);
@@ -51,6 +51,7 @@ LOCAL_SRC_FILES := \
     cmn/src/spf_svc_utils.c \
     cmn/src/spf_sys_util.c \
     interleaver/src/spf_interleaver_island.c \
+    interleaver/src/spf_interleaver_simd.c \
     list/src/spf_list_utils.c \
     list/src/spf_list_utils_island.c \
     lpi_pool/src/spf_lpi_pool_utils.c \
@@ -0,0 +1,153 @@
+#ifndef CAPI_BENCH_H
+#define CAPI_BENCH_H
+/**
+ * \file capi_bench.h
+ * \brief
+ *    Host side benchmark and conformance harness for CAPI modules.
+ *
+ *    Any module registered in the AMDB static module table is created through its
+ *    get_static_properties/init entry points, configured with a PCM media format and driven frame by frame
+ *    with generated or WAV input. Per module it reports process time, cycles per sample, memory footprint and
+ *    whether the output is bit-exact with a stored reference.
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <stdio.h>
+#include "posal.h"
+#include "capi.h"
+#include "capi_cmn.h"
+#include "amdb_api.h"
+#include "amdb_autogen_def.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif //__cplusplus
+
+#define CAPI_BENCH_MAX_PARAMS 16
+#define CAPI_BENCH_MAX_CHANNELS 32
+
+/** port IDs used for the data port operations, same as the ones used by the placeholder ports in the graphs */
+#define CAPI_BENCH_INPUT_PORT_ID 0x2
+#define CAPI_BENCH_OUTPUT_PORT_ID 0x1
+
+typedef enum capi_bench_signal_t
+{
+   CAPI_BENCH_SIGNAL_SINE = 0, /**< a different tone per channel at -6 dBFS */
+   CAPI_BENCH_SIGNAL_NOISE,    /**< white noise from a fixed seed, so the input is the same on every run */
+   CAPI_BENCH_SIGNAL_IMPULSE,  /**< one full scale sample at the start of each channel */
+   CAPI_BENCH_SIGNAL_WAV,      /**< samples read from a WAV file */
+} capi_bench_signal_t;
+
+typedef enum capi_bench_ref_status_t
+{
+   CAPI_BENCH_REF_NONE = 0, /**< no reference to compare against */
+   CAPI_BENCH_REF_MATCH,
+   CAPI_BENCH_REF_MISMATCH,
+   CAPI_BENCH_REF_UPDATED, /**< reference was (re)written from this run */
+} capi_bench_ref_status_t;
+
+/** calibration applied through set_param before the media format is set */
+typedef struct capi_bench_param_t
+{
+   uint32_t param_id;
+   int8_t * payload_ptr;
+   uint32_t payload_size;
+} capi_bench_param_t;
+
+typedef struct capi_bench_cfg_t
+{
+   uint32_t            sample_rate;
+   uint32_t            num_channels;
+   uint32_t            bits_per_sample; /**< 16 (Q15), 24 (Q27 in 32 bit words) or 32 (Q31) */
+   uint32_t            frame_size;      /**< samples per channel given to each process call */
+   uint32_t            num_frames;      /**< number of timed frames, 0 to run until the end of the WAV input */
+   uint32_t            warmup_frames;   /**< frames processed before timing starts */
+   uint32_t            cpu_mhz;         /**< used to convert time to cycles where no cycle counter is read */
+   uint64_t            budget_ns;       /**< fail the module if its average ns/frame is above this, 0 to disable */
+   capi_bench_signal_t signal;
+   const char *        in_wav_path;
+   const char *        out_wav_path; /**< output of the module, only for single module runs */
+   const char *        ref_path;     /**< reference of a single module run */
+   const char *        ref_dir;      /**< references of all module runs, one <module id>.raw per module */
+   bool_t              update_ref;   /**< write the references instead of comparing against them */
+   bool_t              verbose;
+   uint32_t            num_params;
+   capi_bench_param_t  params[CAPI_BENCH_MAX_PARAMS];
+} capi_bench_cfg_t;
+
+typedef struct capi_bench_result_t
+{
+   bool_t                  is_setup_done; /**< FALSE if the module could not be created or configured */
+   bool_t                  is_disabled;   /**< module raised process state disabled, so it was not processed */
+   const char *            fail_reason_ptr;
+   uint32_t                init_mem_size; /**< CAPI_INIT_MEMORY_REQUIREMENT */
+   uint32_t                stack_size;    /**< CAPI_STACK_SIZE */
+   uint64_t                heap_bytes;    /**< heap in use by the module after setup, including the init memory */
+   uint64_t                peak_heap_bytes;
+   uint32_t                kpps;     /**< last KPPS the module raised */
+   uint32_t                delay_us; /**< last algorithmic delay the module raised */
+   uint32_t                num_frames;
+   uint64_t                num_samples; /**< input samples consumed, per channel */
+   uint32_t                num_channels;
+   uint64_t                total_ns;
+   uint64_t                min_ns;
+   uint64_t                max_ns;
+   uint64_t                total_cycles;
+   capi_bench_ref_status_t ref_status;
+   uint64_t                ref_mismatch_offset; /**< byte offset of the first difference with the reference */
+} capi_bench_result_t;
+
+/** source of the input samples, deinterleaved into the input buffers of the module */
+typedef struct capi_bench_src_t
+{
+   capi_bench_signal_t signal;
+   FILE *              wav_fp;
+   uint32_t            wav_bits_per_sample;
+   uint64_t            wav_bytes_left;
+   uint8_t *           wav_frame_ptr; /**< one frame of interleaved samples read from the file */
+   uint32_t            sample_rate;
+   uint32_t            num_channels;
+   uint32_t            bits_per_sample;
+   uint64_t            sample_index; /**< per channel */
+   uint32_t            noise_state;
+} capi_bench_src_t;
+
+typedef struct capi_bench_wav_writer_t
+{
+   FILE *   fp;
+   uint32_t num_channels;
+   uint32_t bytes_per_sample;
+   uint32_t data_bytes;
+} capi_bench_wav_writer_t;
+
+/* capi_bench_io.c */
+ar_result_t capi_bench_src_open(capi_bench_src_t *src_ptr, capi_bench_cfg_t *cfg_ptr);
+uint32_t capi_bench_src_read(capi_bench_src_t *src_ptr, int8_t *ch_ptrs[], uint32_t offset, uint32_t num_samples);
+void capi_bench_src_close(capi_bench_src_t *src_ptr);
+
+ar_result_t capi_bench_wav_writer_open(capi_bench_wav_writer_t *wr_ptr,
+                                       const char *             path_ptr,
+                                       uint32_t                 sample_rate,
+                                       uint32_t                 num_channels,
+                                       uint32_t                 bits_per_sample);
+void capi_bench_wav_writer_write(capi_bench_wav_writer_t *wr_ptr,
+                                 capi_buf_t *             bufs_ptr,
+                                 uint32_t                 num_samples,
+                                 uint32_t                 q_factor);
+void capi_bench_wav_writer_close(capi_bench_wav_writer_t *wr_ptr);
+
+ar_result_t capi_bench_read_file(const char *path_ptr, int8_t **data_pptr, uint32_t *size_ptr);
+
+/* capi_bench_module.c */
+ar_result_t capi_bench_run_module(const amdb_static_capi_module_t *entry_ptr,
+                                  capi_bench_cfg_t *               cfg_ptr,
+                                  capi_bench_result_t *            result_ptr);
+
+#ifdef __cplusplus
+}
+#endif //__cplusplus
+
+#endif // CAPI_BENCH_H
@@ -0,0 +1,472 @@
+/**
+ * \file capi_bench.c
+ * \brief
+ *    Command line front end of the CAPI module benchmark. Runs one module, or every module of the AMDB static
+ *    table, and prints one line of results per module.
+ *
+ *    Exit code is non-zero if any output differs from its reference, any module is over the time budget, or
+ *    the single requested module could not be set up, so that the tool can gate a CI job.
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "capi_bench.h"
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <signal.h>
+
+extern const amdb_static_capi_module_t amdb_spf_static_capi_modules[];
+extern const uint32_t                  amdb_spf_num_static_capi_modules;
+
+#define CAPI_BENCH_MAX_PATH 512
+
+/** time a module gets in a full run before it's reported as hung, e.g. modules which wait for a timer in process */
+#define CAPI_BENCH_MODULE_TIMEOUT_SEC 60
+
+static void capi_bench_usage(const char *prog_ptr)
+{
+   fprintf(stderr,
+           "usage: %s (-m <module id> | -a | -l) [options]\n"
+           "  -m, --module <id>        benchmark one module\n"
+           "  -a, --all                benchmark every module of the static module table\n"
+           "  -l, --list               list the modules of the static module table\n"
+           "  -r, --rate <hz>          input sample rate (48000)\n"
+           "  -c, --channels <n>       input channels (2)\n"
+           "  -b, --bits <16|24|32>    input bits per sample (16)\n"
+           "  -f, --frame <samples>    samples per channel per process call (480)\n"
+           "  -n, --frames <n>         timed frames, 0 to run until the end of the WAV input (1000)\n"
+           "  -w, --warmup <n>         frames processed before timing starts (10)\n"
+           "  -g, --signal <s>         sine, noise or impulse (sine)\n"
+           "  -i, --in <file.wav>      read the input from a WAV file\n"
+           "  -o, --out <file.wav>     write the output of the module (single module only)\n"
+           "  -R, --ref <file>         reference output of the module (single module only)\n"
+           "  -D, --ref-dir <dir>      directory with one <module id>.raw reference per module\n"
+           "  -U, --update-ref         write the references instead of comparing against them\n"
+           "  -p, --param <id>:<file>  set_param payload applied before the media format, can repeat\n"
+           "  -M, --cpu-mhz <mhz>      clock used to estimate cycles where there is no cycle counter\n"
+           "  -B, --budget-ns <ns>     fail modules whose average time per frame is above this\n"
+           "  -v, --verbose            print why modules fail to set up\n",
+           prog_ptr);
+}
+
+static const char *capi_bench_mtype_str(uint32_t mtype)
+{
+   switch (mtype)
+   {
+      case AMDB_MODULE_TYPE_GENERIC:
+         return "GENERIC";
+      case AMDB_MODULE_TYPE_DECODER:
+         return "DECODER";
+      case AMDB_MODULE_TYPE_ENCODER:
+         return "ENCODER";
+      case AMDB_MODULE_TYPE_CONVERTER:
+         return "CONVERT";
+      case AMDB_MODULE_TYPE_PACKETIZER:
+         return "PACKET";
+      case AMDB_MODULE_TYPE_DEPACKETIZER:
+         return "DEPACKET";
+      case AMDB_MODULE_TYPE_DETECTOR:
+         return "DETECTOR";
+      case AMDB_MODULE_TYPE_GENERATOR:
+         return "GENERATOR";
+      case AMDB_MODULE_TYPE_PP:
+         return "PP";
+      case AMDB_MODULE_TYPE_END_POINT:
+         return "ENDPOINT";
+      default:
+         return "OTHER";
+   }
+}
+
+static ar_result_t capi_bench_parse_param(capi_bench_cfg_t *cfg_ptr, char *arg_ptr)
+{
+   char *sep_ptr = strchr(arg_ptr, ':');
+
+   if (!sep_ptr || (cfg_ptr->num_params >= CAPI_BENCH_MAX_PARAMS))
+   {
+      return AR_EBADPARAM;
+   }
+
+   capi_bench_param_t *param_ptr = &cfg_ptr->params[cfg_ptr->num_params];
+
+   *sep_ptr            = '\0';
+   param_ptr->param_id = (uint32_t)strtoul(arg_ptr, NULL, 0);
+
+   if (AR_EOK != capi_bench_read_file(sep_ptr + 1, &param_ptr->payload_ptr, &param_ptr->payload_size))
+   {
+      fprintf(stderr, "capi_bench: cannot read %s\n", sep_ptr + 1);
+      return AR_EFAILED;
+   }
+
+   cfg_ptr->num_params++;
+   return AR_EOK;
+}
+
+static void capi_bench_print_header(void)
+{
+   printf("%-10s %-9s %-8s %8s %8s %6s %6s %7s %7s %10s %10s %10s %8s %s\n",
+          "MID",
+          "TYPE",
+          "STATUS",
+          "INIT_B",
+          "HEAP_B",
+          "STACK",
+          "KPPS",
+          "DELAY",
+          "FRAMES",
+          "AVG_NS",
+          "MIN_NS",
+          "MAX_NS",
+          "CYC/SMP",
+          "REF");
+}
+
+static const char *capi_bench_ref_str(capi_bench_ref_status_t status)
+{
+   switch (status)
+   {
+      case CAPI_BENCH_REF_MATCH:
+         return "match";
+      case CAPI_BENCH_REF_MISMATCH:
+         return "MISMATCH";
+      case CAPI_BENCH_REF_UPDATED:
+         return "updated";
+      default:
+         return "-";
+   }
+}
+
+static void capi_bench_print_result(const amdb_static_capi_module_t *entry_ptr,
+                                    capi_bench_result_t *            res_ptr,
+                                    const char *                     status_ptr)
+{
+   uint64_t avg_ns = res_ptr->num_frames ? (res_ptr->total_ns / res_ptr->num_frames) : 0;
+   uint64_t samples = res_ptr->num_samples * res_ptr->num_channels;
+   double   cyc_per_smp = samples ? ((double)res_ptr->total_cycles / (double)samples) : 0.0;
+
+   printf("0x%08lX %-9s %-8s %8lu %8llu %6lu %6lu %7lu %7lu %10llu %10llu %10llu %8.2f %s",
+          (unsigned long)entry_ptr->mid,
+          capi_bench_mtype_str(entry_ptr->mtype),
+          status_ptr,
+          (unsigned long)res_ptr->init_mem_size,
+          (unsigned long long)res_ptr->heap_bytes,
+          (unsigned long)res_ptr->stack_size,
+          (unsigned long)res_ptr->kpps,
+          (unsigned long)res_ptr->delay_us,
+          (unsigned long)res_ptr->num_frames,
+          (unsigned long long)avg_ns,
+          (unsigned long long)res_ptr->min_ns,
+          (unsigned long long)res_ptr->max_ns,
+          cyc_per_smp,
+          capi_bench_ref_str(res_ptr->ref_status));
+
+   if (CAPI_BENCH_REF_MISMATCH == res_ptr->ref_status)
+   {
+      printf(" @%llu", (unsigned long long)res_ptr->ref_mismatch_offset);
+   }
+   printf("\n");
+}
+
+/* runs the module in a child process, so that a module which crashes or hangs outside of a real graph doesn't stop
+ * a full run. Returns NULL if the child came back with a result, else the status to print. */
+static const char *capi_bench_run_isolated(const amdb_static_capi_module_t *entry_ptr,
+                                      capi_bench_cfg_t *               cfg_ptr,
+                                      capi_bench_result_t *            res_ptr)
+{
+   int   fds[2];
+   pid_t pid;
+   int   status = 0;
+
+   memset(res_ptr, 0, sizeof(*res_ptr));
+
+   fflush(stdout);
+   if (0 != pipe(fds))
+   {
+      (void)capi_bench_run_module(entry_ptr, cfg_ptr, res_ptr);
+      return NULL;
+   }
+
+   if (0 > (pid = fork()))
+   {
+      close(fds[0]);
+      close(fds[1]);
+      (void)capi_bench_run_module(entry_ptr, cfg_ptr, res_ptr);
+      return NULL;
+   }
+
+   if (0 == pid)
+   {
+      close(fds[0]);
+      alarm(CAPI_BENCH_MODULE_TIMEOUT_SEC);
+      (void)capi_bench_run_module(entry_ptr, cfg_ptr, res_ptr);
+      // fail_reason_ptr points to a string literal, which is at the same address in the parent
+      ssize_t written = write(fds[1], res_ptr, sizeof(*res_ptr));
+      _exit((written == (ssize_t)sizeof(*res_ptr)) ? 0 : 1);
+   }
+
+   close(fds[1]);
+   ssize_t rd_size = read(fds[0], res_ptr, sizeof(*res_ptr));
+   close(fds[0]);
+   (void)waitpid(pid, &status, 0);
+
+   if ((rd_size != (ssize_t)sizeof(*res_ptr)) || !WIFEXITED(status) || (0 != WEXITSTATUS(status)))
+   {
+      memset(res_ptr, 0, sizeof(*res_ptr));
+      return (WIFSIGNALED(status) && (SIGALRM == WTERMSIG(status))) ? "timeout" : "crash";
+   }
+   return NULL;
+}
+
+/* runs one module, prints its line and returns TRUE if it passed */
+static bool_t capi_bench_run_one(const amdb_static_capi_module_t *entry_ptr, capi_bench_cfg_t *cfg_ptr, bool_t is_all)
+{
+   capi_bench_result_t res;
+   char                ref_path[CAPI_BENCH_MAX_PATH];
+   const char *        status_ptr = "ok";
+   bool_t              is_pass    = TRUE;
+   capi_bench_cfg_t    cfg        = *cfg_ptr;
+
+   if (is_all)
+   {
+      cfg.out_wav_path = NULL;
+      cfg.ref_path     = NULL;
+   }
+   if (cfg.ref_dir)
+   {
+      snprintf(ref_path, sizeof(ref_path), "%s/0x%08lX.raw", cfg.ref_dir, (unsigned long)entry_ptr->mid);
+      cfg.ref_path = ref_path;
+   }
+
+   if (!is_all)
+   {
+      (void)capi_bench_run_module(entry_ptr, &cfg, &res);
+   }
+   else if (NULL != (status_ptr = capi_bench_run_isolated(entry_ptr, &cfg, &res)))
+   {
+      capi_bench_print_result(entry_ptr, &res, status_ptr);
+      return FALSE;
+   }
+   status_ptr = "ok";
+
+   if (!res.is_setup_done)
+   {
+      status_ptr = "skip";
+      // modules which don't take PCM on one input and one output are expected to be skipped in a full run
+      is_pass = is_all;
+   }
+   else if (res.fail_reason_ptr)
+   {
+      status_ptr = "fail";
+      is_pass    = FALSE;
+   }
+   else if (res.is_disabled)
+   {
+      status_ptr = "disabled";
+   }
+   else if (cfg.budget_ns && res.num_frames && ((res.total_ns / res.num_frames) > cfg.budget_ns))
+   {
+      status_ptr = "budget";
+      is_pass    = FALSE;
+   }
+
+   if (CAPI_BENCH_REF_MISMATCH == res.ref_status)
+   {
+      is_pass = FALSE;
+   }
+
+   capi_bench_print_result(entry_ptr, &res, status_ptr);
+
+   if (res.fail_reason_ptr && (cfg.verbose || !is_all))
+   {
+      fprintf(stderr, "capi_bench: module 0x%08lX: %s\n", (unsigned long)entry_ptr->mid, res.fail_reason_ptr);
+   }
+
+   return is_pass;
+}
+
+int main(int argc, char *argv[])
+{
+   static const struct option long_opts[] = {
+      { "module", required_argument, NULL, 'm' },    { "all", no_argument, NULL, 'a' },
+      { "list", no_argument, NULL, 'l' },            { "rate", required_argument, NULL, 'r' },
+      { "channels", required_argument, NULL, 'c' },  { "bits", required_argument, NULL, 'b' },
+      { "frame", required_argument, NULL, 'f' },     { "frames", required_argument, NULL, 'n' },
+      { "warmup", required_argument, NULL, 'w' },    { "signal", required_argument, NULL, 'g' },
+      { "in", required_argument, NULL, 'i' },        { "out", required_argument, NULL, 'o' },
+      { "ref", required_argument, NULL, 'R' },       { "ref-dir", required_argument, NULL, 'D' },
+      { "update-ref", no_argument, NULL, 'U' },      { "param", required_argument, NULL, 'p' },
+      { "cpu-mhz", required_argument, NULL, 'M' },   { "budget-ns", required_argument, NULL, 'B' },
+      { "verbose", no_argument, NULL, 'v' },         { "help", no_argument, NULL, 'h' },
+      { NULL, 0, NULL, 0 },
+   };
+
+   capi_bench_cfg_t cfg;
+   uint32_t         mid      = 0;
+   bool_t           is_mid   = FALSE;
+   bool_t           is_all   = FALSE;
+   bool_t           is_list  = FALSE;
+   int              exit_code = 0;
+   int              opt;
+
+   memset(&cfg, 0, sizeof(cfg));
+   cfg.sample_rate     = 48000;
+   cfg.num_channels    = 2;
+   cfg.bits_per_sample = 16;
+   cfg.frame_size      = 480;
+   cfg.num_frames      = 1000;
+   cfg.warmup_frames   = 10;
+   cfg.signal          = CAPI_BENCH_SIGNAL_SINE;
+
+   while (-1 != (opt = getopt_long(argc, argv, "m:alr:c:b:f:n:w:g:i:o:R:D:Up:M:B:vh", long_opts, NULL)))
+   {
+      switch (opt)
+      {
+         case 'm':
+            mid    = (uint32_t)strtoul(optarg, NULL, 0);
+            is_mid = TRUE;
+            break;
+         case 'a':
+            is_all = TRUE;
+            break;
+         case 'l':
+            is_list = TRUE;
+            break;
+         case 'r':
+            cfg.sample_rate = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+         case 'c':
+            cfg.num_channels = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+         case 'b':
+            cfg.bits_per_sample = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+         case 'f':
+            cfg.frame_size = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+         case 'n':
+            cfg.num_frames = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+         case 'w':
+            cfg.warmup_frames = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+         case 'g':
+            if (0 == strcmp(optarg, "sine"))
+            {
+               cfg.signal = CAPI_BENCH_SIGNAL_SINE;
+            }
+            else if (0 == strcmp(optarg, "noise"))
+            {
+               cfg.signal = CAPI_BENCH_SIGNAL_NOISE;
+            }
+            else if (0 == strcmp(optarg, "impulse"))
+            {
+               cfg.signal = CAPI_BENCH_SIGNAL_IMPULSE;
+            }
+            else
+            {
+               capi_bench_usage(argv[0]);
+               return 2;
+            }
+            break;
+         case 'i':
+            cfg.in_wav_path = optarg;
+            cfg.signal      = CAPI_BENCH_SIGNAL_WAV;
+            break;
+         case 'o':
+            cfg.out_wav_path = optarg;
+            break;
+         case 'R':
+            cfg.ref_path = optarg;
+            break;
+         case 'D':
+            cfg.ref_dir = optarg;
+            break;
+         case 'U':
+            cfg.update_ref = TRUE;
+            break;
+         case 'p':
+            if (AR_EOK != capi_bench_parse_param(&cfg, optarg))
+            {
+               capi_bench_usage(argv[0]);
+               return 2;
+            }
+            break;
+         case 'M':
+            cfg.cpu_mhz = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+         case 'B':
+            cfg.budget_ns = strtoull(optarg, NULL, 0);
+            break;
+         case 'v':
+            cfg.verbose = TRUE;
+            break;
+         default:
+            capi_bench_usage(argv[0]);
+            return 2;
+      }
+   }
+
+   if ((is_mid + is_all + is_list) != 1)
+   {
+      capi_bench_usage(argv[0]);
+      return 2;
+   }
+
+   if ((0 == cfg.num_channels) || (cfg.num_channels > CAPI_BENCH_MAX_CHANNELS) || (0 == cfg.sample_rate) ||
+       (0 == cfg.frame_size) || ((16 != cfg.bits_per_sample) && (24 != cfg.bits_per_sample) && (32 != cfg.bits_per_sample)))
+   {
+      fprintf(stderr, "capi_bench: unsupported media format\n");
+      return 2;
+   }
+
+   if (is_list)
+   {
+      for (uint32_t i = 0; i < amdb_spf_num_static_capi_modules; i++)
+      {
+         const amdb_static_capi_module_t *entry_ptr = &amdb_spf_static_capi_modules[i];
+         printf("0x%08lX %s\n", (unsigned long)entry_ptr->mid, capi_bench_mtype_str(entry_ptr->mtype));
+      }
+      return 0;
+   }
+
+   posal_init();
+
+   capi_bench_print_header();
+
+   bool_t is_found = FALSE;
+   for (uint32_t i = 0; i < amdb_spf_num_static_capi_modules; i++)
+   {
+      const amdb_static_capi_module_t *entry_ptr = &amdb_spf_static_capi_modules[i];
+
+      if (is_mid && (entry_ptr->mid != mid))
+      {
+         continue;
+      }
+      is_found = TRUE;
+
+      if (!capi_bench_run_one(entry_ptr, &cfg, is_all))
+      {
+         exit_code = 1;
+      }
+   }
+
+   if (!is_found)
+   {
+      fprintf(stderr, "capi_bench: module 0x%08lX is not in the static module table\n", (unsigned long)mid);
+      exit_code = 1;
+   }
+
+   for (uint32_t i = 0; i < cfg.num_params; i++)
+   {
+      free(cfg.params[i].payload_ptr);
+   }
+
+   posal_deinit();
+
+   return exit_code;
+}
@@ -0,0 +1,412 @@
+/**
+ * \file capi_bench_io.c
+ * \brief
+ *    Input generation, WAV reading/writing and file helpers of the CAPI benchmark harness.
+ *
+ *    Generated signals only use integer arithmetic so that the input, and hence the stored references, are the
+ *    same on every host.
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "capi_bench.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define CAPI_BENCH_WAV_FMT_PCM 1
+#define CAPI_BENCH_WAV_FMT_EXTENSIBLE 0xFFFE
+#define CAPI_BENCH_WAV_HEADER_SIZE 44
+
+#define CAPI_BENCH_SINE_BASE_FREQ_HZ 997
+#define CAPI_BENCH_NOISE_SEED 0x2545F491
+
+static uint32_t capi_bench_rd_le(const uint8_t *ptr, uint32_t num_bytes)
+{
+   uint32_t val = 0;
+   for (uint32_t i = 0; i < num_bytes; i++)
+   {
+      val |= ((uint32_t)ptr[i]) << (8 * i);
+   }
+   return val;
+}
+
+static void capi_bench_wr_le(uint8_t *ptr, uint32_t val, uint32_t num_bytes)
+{
+   for (uint32_t i = 0; i < num_bytes; i++)
+   {
+      ptr[i] = (uint8_t)(val >> (8 * i));
+   }
+}
+
+/* half amplitude sine in Q31 for a phase over the full 32 bit range. Uses Bhaskara's approximation,
+ * sin(pi * t) ~= 16 t (1 - t) / (5 - 4 t (1 - t)), which is within 0.2% and needs no floating point. */
+static int32_t capi_bench_sine_q31(uint32_t phase)
+{
+   uint64_t t = phase & 0x7FFFFFFF;                      // Q31 position in the half period
+   uint64_t u = (t * ((1ULL << 31) - t)) >> 32;          // Q30 t (1 - t)
+   uint64_t s = ((u << 4) << 31) / ((5ULL << 30) - 4 * u); // Q31 sin
+   int32_t  half = (int32_t)(MIN(s, 0x7FFFFFFFULL) >> 1);
+
+   return (phase & 0x80000000) ? -half : half;
+}
+
+static uint32_t capi_bench_noise_next(uint32_t *state_ptr)
+{
+   uint32_t x = *state_ptr;
+   x ^= x << 13;
+   x ^= x >> 17;
+   x ^= x << 5;
+   *state_ptr = x;
+   return x;
+}
+
+static void capi_bench_store_q31(int8_t *dst_ptr, uint32_t bits_per_sample, int32_t val_q31)
+{
+   switch (bits_per_sample)
+   {
+      case 16:
+         *(int16_t *)dst_ptr = (int16_t)(val_q31 >> 16);
+         break;
+      case 24:
+         *(int32_t *)dst_ptr = val_q31 >> 4; // Q27
+         break;
+      default:
+         *(int32_t *)dst_ptr = val_q31;
+         break;
+   }
+}
+
+static ar_result_t capi_bench_wav_parse_header(capi_bench_src_t *src_ptr, capi_bench_cfg_t *cfg_ptr)
+{
+   uint8_t  hdr[12];
+   uint8_t  chunk[8];
+   uint8_t  fmt[40];
+   bool_t   is_fmt_found = FALSE;
+   uint32_t num_channels = 0, sample_rate = 0, bits = 0;
+
+   if ((1 != fread(hdr, sizeof(hdr), 1, src_ptr->wav_fp)) || memcmp(hdr, "RIFF", 4) || memcmp(hdr + 8, "WAVE", 4))
+   {
+      fprintf(stderr, "capi_bench: %s is not a RIFF/WAVE file\n", cfg_ptr->in_wav_path);
+      return AR_EBADPARAM;
+   }
+
+   while (1 == fread(chunk, sizeof(chunk), 1, src_ptr->wav_fp))
+   {
+      uint32_t chunk_size = capi_bench_rd_le(chunk + 4, 4);
+
+      if (!memcmp(chunk, "fmt ", 4))
+      {
+         uint32_t rd_size = MIN(chunk_size, (uint32_t)sizeof(fmt));
+         if ((chunk_size < 16) || (1 != fread(fmt, rd_size, 1, src_ptr->wav_fp)))
+         {
+            break;
+         }
+         uint32_t fmt_tag = capi_bench_rd_le(fmt, 2);
+         // for the extensible format the first two bytes of the sub format GUID carry the format tag
+         if ((CAPI_BENCH_WAV_FMT_EXTENSIBLE == fmt_tag) && (rd_size >= 26))
+         {
+            fmt_tag = capi_bench_rd_le(fmt + 24, 2);
+         }
+         if (CAPI_BENCH_WAV_FMT_PCM != fmt_tag)
+         {
+            fprintf(stderr, "capi_bench: %s: only integer PCM is supported\n", cfg_ptr->in_wav_path);
+            return AR_EUNSUPPORTED;
+         }
+         num_channels = capi_bench_rd_le(fmt + 2, 2);
+         sample_rate  = capi_bench_rd_le(fmt + 4, 4);
+         bits         = capi_bench_rd_le(fmt + 14, 2);
+         is_fmt_found = TRUE;
+         fseek(src_ptr->wav_fp, (long)(chunk_size - rd_size + (chunk_size & 1)), SEEK_CUR);
+      }
+      else if (!memcmp(chunk, "data", 4))
+      {
+         if (!is_fmt_found)
+         {
+            break;
+         }
+         if (((16 != bits) && (24 != bits) && (32 != bits)) || (0 == num_channels) ||
+             (num_channels > CAPI_BENCH_MAX_CHANNELS) || (0 == sample_rate))
+         {
+            fprintf(stderr,
+                    "capi_bench: %s: unsupported format, %lu ch, %lu Hz, %lu bits\n",
+                    cfg_ptr->in_wav_path,
+                    (unsigned long)num_channels,
+                    (unsigned long)sample_rate,
+                    (unsigned long)bits);
+            return AR_EUNSUPPORTED;
+         }
+         src_ptr->wav_bits_per_sample = bits;
+         src_ptr->wav_bytes_left      = chunk_size;
+
+         // the file decides the media format of the run
+         cfg_ptr->sample_rate     = sample_rate;
+         cfg_ptr->num_channels    = num_channels;
+         cfg_ptr->bits_per_sample = bits;
+         return AR_EOK;
+      }
+      else
+      {
+         fseek(src_ptr->wav_fp, (long)(chunk_size + (chunk_size & 1)), SEEK_CUR);
+      }
+   }
+
+   fprintf(stderr, "capi_bench: %s: fmt/data chunk not found\n", cfg_ptr->in_wav_path);
+   return AR_EBADPARAM;
+}
+
+ar_result_t capi_bench_src_open(capi_bench_src_t *src_ptr, capi_bench_cfg_t *cfg_ptr)
+{
+   ar_result_t result = AR_EOK;
+
+   memset(src_ptr, 0, sizeof(*src_ptr));
+   src_ptr->signal      = cfg_ptr->signal;
+   src_ptr->noise_state = CAPI_BENCH_NOISE_SEED;
+
+   if (CAPI_BENCH_SIGNAL_WAV == src_ptr->signal)
+   {
+      src_ptr->wav_fp = fopen(cfg_ptr->in_wav_path, "rb");
+      if (!src_ptr->wav_fp)
+      {
+         fprintf(stderr, "capi_bench: cannot open %s\n", cfg_ptr->in_wav_path);
+         return AR_EFAILED;
+      }
+
+      if (AR_EOK != (result = capi_bench_wav_parse_header(src_ptr, cfg_ptr)))
+      {
+         capi_bench_src_close(src_ptr);
+         return result;
+      }
+
+      src_ptr->wav_frame_ptr = (uint8_t *)malloc((size_t)cfg_ptr->num_channels * (cfg_ptr->bits_per_sample >> 3));
+      if (!src_ptr->wav_frame_ptr)
+      {
+         capi_bench_src_close(src_ptr);
+         return AR_ENOMEMORY;
+      }
+   }
+
+   src_ptr->sample_rate     = cfg_ptr->sample_rate;
+   src_ptr->num_channels    = cfg_ptr->num_channels;
+   src_ptr->bits_per_sample = cfg_ptr->bits_per_sample;
+
+   return result;
+}
+
+uint32_t capi_bench_src_read(capi_bench_src_t *src_ptr, int8_t *ch_ptrs[], uint32_t offset, uint32_t num_samples)
+{
+   uint32_t bytes_per_sample = (16 == src_ptr->bits_per_sample) ? 2 : 4;
+   uint32_t n;
+
+   for (n = 0; n < num_samples; n++)
+   {
+      uint32_t dst_offset = (offset + n) * bytes_per_sample;
+
+      if (CAPI_BENCH_SIGNAL_WAV == src_ptr->signal)
+      {
+         uint32_t wav_bytes_per_sample = src_ptr->wav_bits_per_sample >> 3;
+         uint32_t frame_bytes          = wav_bytes_per_sample * src_ptr->num_channels;
+
+         if ((src_ptr->wav_bytes_left < frame_bytes) || (1 != fread(src_ptr->wav_frame_ptr, frame_bytes, 1, src_ptr->wav_fp)))
+         {
+            break;
+         }
+         src_ptr->wav_bytes_left -= frame_bytes;
+
+         for (uint32_t ch = 0; ch < src_ptr->num_channels; ch++)
+         {
+            uint32_t raw = capi_bench_rd_le(src_ptr->wav_frame_ptr + ch * wav_bytes_per_sample, wav_bytes_per_sample);
+            int32_t  val_q31 = (int32_t)(raw << (32 - src_ptr->wav_bits_per_sample));
+            capi_bench_store_q31(ch_ptrs[ch] + dst_offset, src_ptr->bits_per_sample, val_q31);
+         }
+      }
+      else
+      {
+         // channels are generated sample by sample so that the signal doesn't depend on the frame size
+         for (uint32_t ch = 0; ch < src_ptr->num_channels; ch++)
+         {
+            int32_t val_q31 = 0;
+
+            switch (src_ptr->signal)
+            {
+               case CAPI_BENCH_SIGNAL_SINE:
+               {
+                  uint64_t freq = (uint64_t)CAPI_BENCH_SINE_BASE_FREQ_HZ * (ch + 1);
+                  while (freq * 2 >= src_ptr->sample_rate)
+                  {
+                     freq >>= 1;
+                  }
+                  uint64_t phase_inc = (freq << 32) / src_ptr->sample_rate;
+                  val_q31            = capi_bench_sine_q31((uint32_t)(phase_inc * src_ptr->sample_index));
+                  break;
+               }
+               case CAPI_BENCH_SIGNAL_NOISE:
+               {
+                  val_q31 = ((int32_t)capi_bench_noise_next(&src_ptr->noise_state)) >> 1;
+                  break;
+               }
+               case CAPI_BENCH_SIGNAL_IMPULSE:
+               {
+                  val_q31 = (0 == src_ptr->sample_index) ? 0x40000000 : 0;
+                  break;
+               }
+               default:
+                  break;
+            }
+
+            capi_bench_store_q31(ch_ptrs[ch] + dst_offset, src_ptr->bits_per_sample, val_q31);
+         }
+      }
+
+      src_ptr->sample_index++;
+   }
+
+   return n;
+}
+
+void capi_bench_src_close(capi_bench_src_t *src_ptr)
+{
+   if (src_ptr->wav_fp)
+   {
+      fclose(src_ptr->wav_fp);
+      src_ptr->wav_fp = NULL;
+   }
+   free(src_ptr->wav_frame_ptr);
+   src_ptr->wav_frame_ptr = NULL;
+}
+
+static void capi_bench_wav_write_header(capi_bench_wav_writer_t *wr_ptr, uint32_t sample_rate)
+{
+   uint8_t  hdr[CAPI_BENCH_WAV_HEADER_SIZE];
+   uint32_t block_align = wr_ptr->num_channels * wr_ptr->bytes_per_sample;
+
+   memcpy(hdr, "RIFF", 4);
+   capi_bench_wr_le(hdr + 4, 36 + wr_ptr->data_bytes, 4);
+   memcpy(hdr + 8, "WAVEfmt ", 8);
+   capi_bench_wr_le(hdr + 16, 16, 4);
+   capi_bench_wr_le(hdr + 20, CAPI_BENCH_WAV_FMT_PCM, 2);
+   capi_bench_wr_le(hdr + 22, wr_ptr->num_channels, 2);
+   capi_bench_wr_le(hdr + 24, sample_rate, 4);
+   capi_bench_wr_le(hdr + 28, sample_rate * block_align, 4);
+   capi_bench_wr_le(hdr + 32, block_align, 2);
+   capi_bench_wr_le(hdr + 34, wr_ptr->bytes_per_sample * 8, 2);
+   memcpy(hdr + 36, "data", 4);
+   capi_bench_wr_le(hdr + 40, wr_ptr->data_bytes, 4);
+
+   fwrite(hdr, sizeof(hdr), 1, wr_ptr->fp);
+}
+
+ar_result_t capi_bench_wav_writer_open(capi_bench_wav_writer_t *wr_ptr,
+                                       const char *             path_ptr,
+                                       uint32_t                 sample_rate,
+                                       uint32_t                 num_channels,
+                                       uint32_t                 bits_per_sample)
+{
+   memset(wr_ptr, 0, sizeof(*wr_ptr));
+
+   wr_ptr->fp = fopen(path_ptr, "wb");
+   if (!wr_ptr->fp)
+   {
+      fprintf(stderr, "capi_bench: cannot create %s\n", path_ptr);
+      return AR_EFAILED;
+   }
+
+   // 32 bit words are written as Q31 regardless of their Q factor so that the file plays at the right level
+   wr_ptr->num_channels     = num_channels;
+   wr_ptr->bytes_per_sample = (16 == bits_per_sample) ? 2 : 4;
+
+   // data size is patched on close
+   capi_bench_wav_write_header(wr_ptr, sample_rate);
+
+   return AR_EOK;
+}
+
+void capi_bench_wav_writer_write(capi_bench_wav_writer_t *wr_ptr,
+                                 capi_buf_t *             bufs_ptr,
+                                 uint32_t                 num_samples,
+                                 uint32_t                 q_factor)
+{
+   uint8_t sample[4];
+
+   if (!wr_ptr->fp)
+   {
+      return;
+   }
+
+   for (uint32_t n = 0; n < num_samples; n++)
+   {
+      for (uint32_t ch = 0; ch < wr_ptr->num_channels; ch++)
+      {
+         if (2 == wr_ptr->bytes_per_sample)
+         {
+            capi_bench_wr_le(sample, (uint16_t)((int16_t *)bufs_ptr[ch].data_ptr)[n], 2);
+         }
+         else
+         {
+            int64_t val = (int64_t)((int32_t *)bufs_ptr[ch].data_ptr)[n] << (31 - MIN(q_factor, 31));
+            val         = MAX(MIN(val, (int64_t)INT32_MAX), (int64_t)INT32_MIN);
+            capi_bench_wr_le(sample, (uint32_t)(int32_t)val, 4);
+         }
+         fwrite(sample, wr_ptr->bytes_per_sample, 1, wr_ptr->fp);
+      }
+   }
+
+   wr_ptr->data_bytes += num_samples * wr_ptr->num_channels * wr_ptr->bytes_per_sample;
+}
+
+void capi_bench_wav_writer_close(capi_bench_wav_writer_t *wr_ptr)
+{
+   uint8_t size[4];
+
+   if (!wr_ptr->fp)
+   {
+      return;
+   }
+
+   capi_bench_wr_le(size, 36 + wr_ptr->data_bytes, 4);
+   fseek(wr_ptr->fp, 4, SEEK_SET);
+   fwrite(size, sizeof(size), 1, wr_ptr->fp);
+
+   capi_bench_wr_le(size, wr_ptr->data_bytes, 4);
+   fseek(wr_ptr->fp, 40, SEEK_SET);
+   fwrite(size, sizeof(size), 1, wr_ptr->fp);
+
+   fclose(wr_ptr->fp);
+   wr_ptr->fp = NULL;
+}
+
+ar_result_t capi_bench_read_file(const char *path_ptr, int8_t **data_pptr, uint32_t *size_ptr)
+{
+   FILE *fp = fopen(path_ptr, "rb");
+   long  size;
+
+   *data_pptr = NULL;
+   *size_ptr  = 0;
+
+   if (!fp)
+   {
+      fprintf(stderr, "capi_bench: cannot open %s\n", path_ptr);
+      return AR_EFAILED;
+   }
+
+   fseek(fp, 0, SEEK_END);
+   size = ftell(fp);
+   fseek(fp, 0, SEEK_SET);
+
+   if (size > 0)
+   {
+      *data_pptr = (int8_t *)malloc((size_t)size);
+      if (!*data_pptr || (1 != fread(*data_pptr, (size_t)size, 1, fp)))
+      {
+         free(*data_pptr);
+         *data_pptr = NULL;
+         fclose(fp);
+         return AR_EFAILED;
+      }
+   }
+
+   *size_ptr = (uint32_t)size;
+   fclose(fp);
+   return AR_EOK;
+}
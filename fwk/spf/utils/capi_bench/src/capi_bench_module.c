@@ -0,0 +1,731 @@
+/**
+ * \file capi_bench_module.c
+ * \brief
+ *    Creates one CAPI module the way the framework does (static properties, init, calibration, port open/start,
+ *    input media format) and times its process calls on a single deinterleaved input/output port pair.
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "capi_bench.h"
+#include "capi_intf_extn_data_port_operation.h"
+#include "media_fmt_api.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <malloc.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CAPI_BENCH_HAS_CYCLE_COUNTER
+#endif
+
+/** process calls in a row without consuming or producing data before the module is reported as stuck */
+#define CAPI_BENCH_MAX_STALLS 4
+
+#define CAPI_BENCH_REF_CHUNK_SIZE 4096
+
+typedef struct capi_bench_module_t
+{
+   capi_t *            capi_ptr;
+   capi_media_fmt_v2_t in_mf;
+   capi_media_fmt_v2_t out_mf;
+   bool_t              is_enabled;
+   bool_t              supports_deintlvd_unpacked_v2; /**< module raised CAPI_EVENT_DEINTERLEAVED_UNPACKED_V2_SUPPORTED */
+   uint32_t            kpps;
+   uint32_t            delay_us;
+   uint32_t            in_threshold_bytes; /**< across all the channels, 0 if the module didn't raise one */
+   uint32_t            out_threshold_bytes;
+} capi_bench_module_t;
+
+typedef struct capi_bench_bufs_t
+{
+   int8_t *              in_ch_ptrs[CAPI_BENCH_MAX_CHANNELS];
+   int8_t *              out_ch_ptrs[CAPI_BENCH_MAX_CHANNELS];
+   capi_buf_t            in_bufs[CAPI_BENCH_MAX_CHANNELS];
+   capi_buf_t            out_bufs[CAPI_BENCH_MAX_CHANNELS];
+   capi_stream_data_v2_t in_sdata;
+   capi_stream_data_v2_t out_sdata;
+   uint32_t              in_max_samples;  /**< per channel */
+   uint32_t              out_max_samples; /**< per channel */
+} capi_bench_bufs_t;
+
+typedef struct capi_bench_ref_t
+{
+   FILE *   fp;
+   bool_t   is_update;
+   bool_t   is_mismatch;
+   uint64_t offset;
+   uint8_t  chunk[CAPI_BENCH_REF_CHUNK_SIZE];
+} capi_bench_ref_t;
+
+static uint64_t capi_bench_get_time_ns(void)
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+   return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t capi_bench_get_cycles(void)
+{
+#ifdef CAPI_BENCH_HAS_CYCLE_COUNTER
+   return __rdtsc();
+#else
+   return 0;
+#endif
+}
+
+/* bytes the process heap currently hands out, used to measure the allocations done by the module */
+static uint64_t capi_bench_get_heap_in_use(void)
+{
+#if defined(__GLIBC__) && ((__GLIBC__ > 2) || ((__GLIBC__ == 2) && (__GLIBC_MINOR__ >= 33)))
+   struct mallinfo2 mi = mallinfo2();
+   return (uint64_t)mi.uordblks + (uint64_t)mi.hblkhd;
+#elif defined(__GLIBC__)
+   struct mallinfo mi = mallinfo();
+   return (uint64_t)(uint32_t)mi.uordblks + (uint64_t)(uint32_t)mi.hblkhd;
+#else
+   return 0;
+#endif
+}
+
+static capi_err_t capi_bench_event_cb(void *context_ptr, capi_event_id_t id, capi_event_info_t *event_info_ptr)
+{
+   capi_bench_module_t *mod_ptr     = (capi_bench_module_t *)context_ptr;
+   capi_buf_t *         payload_ptr = &event_info_ptr->payload;
+
+   switch (id)
+   {
+      case CAPI_EVENT_KPPS:
+      {
+         if (payload_ptr->actual_data_len >= sizeof(capi_event_KPPS_t))
+         {
+            mod_ptr->kpps = ((capi_event_KPPS_t *)payload_ptr->data_ptr)->KPPS;
+         }
+         break;
+      }
+      case CAPI_EVENT_ALGORITHMIC_DELAY:
+      {
+         if (payload_ptr->actual_data_len >= sizeof(capi_event_algorithmic_delay_t))
+         {
+            mod_ptr->delay_us = ((capi_event_algorithmic_delay_t *)payload_ptr->data_ptr)->delay_in_us;
+         }
+         break;
+      }
+      case CAPI_EVENT_PROCESS_STATE:
+      {
+         if (payload_ptr->actual_data_len >= sizeof(capi_event_process_state_t))
+         {
+            mod_ptr->is_enabled = ((capi_event_process_state_t *)payload_ptr->data_ptr)->is_enabled;
+         }
+         break;
+      }
+      case CAPI_EVENT_PORT_DATA_THRESHOLD_CHANGE:
+      {
+         if ((payload_ptr->actual_data_len >= sizeof(capi_port_data_threshold_change_t)) &&
+             event_info_ptr->port_info.is_valid && (0 == event_info_ptr->port_info.port_index))
+         {
+            uint32_t thresh = ((capi_port_data_threshold_change_t *)payload_ptr->data_ptr)->new_threshold_in_bytes;
+            if (event_info_ptr->port_info.is_input_port)
+            {
+               mod_ptr->in_threshold_bytes = thresh;
+            }
+            else
+            {
+               mod_ptr->out_threshold_bytes = thresh;
+            }
+         }
+         break;
+      }
+      case CAPI_EVENT_OUTPUT_MEDIA_FORMAT_UPDATED_V2:
+      {
+         if ((payload_ptr->actual_data_len >= CAPI_MF_V2_MIN_SIZE) &&
+             (!event_info_ptr->port_info.is_valid || (0 == event_info_ptr->port_info.port_index)))
+         {
+            memcpy(&mod_ptr->out_mf, payload_ptr->data_ptr, MIN(payload_ptr->actual_data_len, sizeof(mod_ptr->out_mf)));
+         }
+         break;
+      }
+      case CAPI_EVENT_DEINTERLEAVED_UNPACKED_V2_SUPPORTED:
+      {
+         mod_ptr->supports_deintlvd_unpacked_v2 = TRUE;
+         break;
+      }
+      // the harness has no framework services behind it
+      case CAPI_EVENT_GET_LIBRARY_INSTANCE:
+      case CAPI_EVENT_GET_DLINFO:
+      case CAPI_EVENT_GET_DATA_FROM_DSP_SERVICE:
+      {
+         return CAPI_EUNSUPPORTED;
+      }
+      default:
+      {
+         break;
+      }
+   }
+
+   return CAPI_EOK;
+}
+
+static void capi_bench_init_media_fmt(capi_media_fmt_v2_t *mf_ptr, capi_bench_cfg_t *cfg_ptr, bool_t is_unpacked_v2)
+{
+   memset(mf_ptr, 0, sizeof(*mf_ptr));
+
+   mf_ptr->header.format_header.data_format = CAPI_FIXED_POINT;
+   mf_ptr->format.minor_version             = CAPI_MEDIA_FORMAT_MINOR_VERSION;
+   mf_ptr->format.bitstream_format          = MEDIA_FMT_ID_PCM;
+   mf_ptr->format.num_channels              = cfg_ptr->num_channels;
+   mf_ptr->format.bits_per_sample           = (16 == cfg_ptr->bits_per_sample) ? 16 : 32;
+   mf_ptr->format.q_factor                  = (16 == cfg_ptr->bits_per_sample)   ? PCM_Q_FACTOR_15
+                                              : (24 == cfg_ptr->bits_per_sample) ? PCM_Q_FACTOR_27
+                                                                                 : PCM_Q_FACTOR_31;
+   mf_ptr->format.sampling_rate             = cfg_ptr->sample_rate;
+   mf_ptr->format.data_is_signed            = TRUE;
+   mf_ptr->format.data_interleaving         = is_unpacked_v2 ? CAPI_DEINTERLEAVED_UNPACKED_V2 : CAPI_DEINTERLEAVED_UNPACKED;
+
+   for (uint32_t ch = 0; ch < cfg_ptr->num_channels; ch++)
+   {
+      mf_ptr->channel_type[ch] = (1 == cfg_ptr->num_channels) ? PCM_CHANNEL_C : (uint16_t)(PCM_CHANNEL_L + ch);
+   }
+}
+
+static capi_err_t capi_bench_get_static_prop(capi_get_static_properties_f get_static_prop_fn,
+                                             uint32_t                     prop_id,
+                                             uint32_t *                   size_ptr)
+{
+   capi_prop_t     prop;
+   capi_proplist_t proplist = { .props_num = 1, .prop_ptr = &prop };
+
+   memset(&prop, 0, sizeof(prop));
+   prop.id                      = (capi_property_id_t)prop_id;
+   prop.payload.data_ptr        = (int8_t *)size_ptr;
+   prop.payload.max_data_len    = sizeof(uint32_t);
+   prop.payload.actual_data_len = sizeof(uint32_t);
+
+   return get_static_prop_fn(NULL, &proplist);
+}
+
+static void capi_bench_port_operation(capi_bench_module_t *mod_ptr, bool_t is_input, intf_extn_data_port_opcode_t opcode)
+{
+   // the operation is packed and followed by the map, so it's built in a word aligned buffer
+   uint32_t payload[(sizeof(intf_extn_data_port_operation_t) + sizeof(intf_extn_data_port_id_idx_map_t) + 3) >> 2];
+   intf_extn_data_port_operation_t *op_ptr = (intf_extn_data_port_operation_t *)payload;
+
+   memset(payload, 0, sizeof(payload));
+   op_ptr->is_input_port        = is_input;
+   op_ptr->opcode               = opcode;
+   op_ptr->num_ports            = 1;
+   op_ptr->id_idx[0].port_id    = is_input ? CAPI_BENCH_INPUT_PORT_ID : CAPI_BENCH_OUTPUT_PORT_ID;
+   op_ptr->id_idx[0].port_index = 0;
+
+   capi_buf_t       buf       = { .data_ptr        = (int8_t *)payload,
+                                  .actual_data_len = sizeof(intf_extn_data_port_operation_t) +
+                                                     sizeof(intf_extn_data_port_id_idx_map_t),
+                                  .max_data_len    = sizeof(payload) };
+   capi_port_info_t port_info = { 0 };
+
+   // modules which don't implement the extension reject it, which is fine.
+   (void)mod_ptr->capi_ptr->vtbl_ptr->set_param(mod_ptr->capi_ptr,
+                                                INTF_EXTN_PARAM_ID_DATA_PORT_OPERATION,
+                                                &port_info,
+                                                &buf);
+}
+
+static const char *capi_bench_create_module(const amdb_static_capi_module_t *entry_ptr,
+                                            capi_bench_cfg_t *               cfg_ptr,
+                                            capi_bench_module_t *            mod_ptr,
+                                            capi_bench_result_t *            result_ptr)
+{
+   capi_err_t err = CAPI_EOK;
+
+   if (!entry_ptr->get_static_prop_fn || !entry_ptr->init_fn)
+   {
+      return "no CAPI entry points";
+   }
+
+   if (CAPI_FAILED(capi_bench_get_static_prop(entry_ptr->get_static_prop_fn,
+                                              CAPI_INIT_MEMORY_REQUIREMENT,
+                                              &result_ptr->init_mem_size)) ||
+       (0 == result_ptr->init_mem_size))
+   {
+      return "get_static_properties failed";
+   }
+   (void)capi_bench_get_static_prop(entry_ptr->get_static_prop_fn, CAPI_STACK_SIZE, &result_ptr->stack_size);
+
+   mod_ptr->capi_ptr = (capi_t *)posal_memory_malloc(result_ptr->init_mem_size, POSAL_HEAP_DEFAULT);
+   if (!mod_ptr->capi_ptr)
+   {
+      return "no memory for the module";
+   }
+   memset(mod_ptr->capi_ptr, 0, result_ptr->init_mem_size);
+
+   // modules are enabled until they say otherwise
+   mod_ptr->is_enabled = TRUE;
+
+   capi_heap_id_t             heap_id   = { .heap_id = (uint32_t)POSAL_HEAP_DEFAULT };
+   capi_event_callback_info_t cb_info   = { .event_cb = capi_bench_event_cb, .event_context = mod_ptr };
+   capi_port_num_info_t       num_ports = { .num_input_ports = 1, .num_output_ports = 1 };
+   capi_prop_t                init_props[3];
+   capi_proplist_t            init_proplist = { .props_num = 3, .prop_ptr = init_props };
+
+   memset(init_props, 0, sizeof(init_props));
+   init_props[0].id                      = CAPI_HEAP_ID;
+   init_props[0].payload.data_ptr        = (int8_t *)&heap_id;
+   init_props[0].payload.actual_data_len = init_props[0].payload.max_data_len = sizeof(heap_id);
+   init_props[1].id                      = CAPI_EVENT_CALLBACK_INFO;
+   init_props[1].payload.data_ptr        = (int8_t *)&cb_info;
+   init_props[1].payload.actual_data_len = init_props[1].payload.max_data_len = sizeof(cb_info);
+   init_props[2].id                      = CAPI_PORT_NUM_INFO;
+   init_props[2].payload.data_ptr        = (int8_t *)&num_ports;
+   init_props[2].payload.actual_data_len = init_props[2].payload.max_data_len = sizeof(num_ports);
+
+   if (CAPI_FAILED(err = entry_ptr->init_fn(mod_ptr->capi_ptr, &init_proplist)))
+   {
+      // vtbl is not valid if init failed, so there is nothing to end
+      posal_memory_free(mod_ptr->capi_ptr);
+      mod_ptr->capi_ptr = NULL;
+      return "init failed";
+   }
+
+   for (uint32_t i = 0; i < cfg_ptr->num_params; i++)
+   {
+      capi_bench_param_t *param_ptr = &cfg_ptr->params[i];
+      capi_buf_t          buf       = { .data_ptr        = param_ptr->payload_ptr,
+                                        .actual_data_len = param_ptr->payload_size,
+                                        .max_data_len    = param_ptr->payload_size };
+      capi_port_info_t    port_info = { 0 };
+
+      if (CAPI_FAILED(err = mod_ptr->capi_ptr->vtbl_ptr->set_param(mod_ptr->capi_ptr,
+                                                                   param_ptr->param_id,
+                                                                   &port_info,
+                                                                   &buf)))
+      {
+         fprintf(stderr,
+                 "capi_bench: module 0x%08lX rejected param 0x%08lX, result 0x%lX\n",
+                 (unsigned long)entry_ptr->mid,
+                 (unsigned long)param_ptr->param_id,
+                 (unsigned long)err);
+      }
+   }
+
+   capi_bench_port_operation(mod_ptr, TRUE, INTF_EXTN_DATA_PORT_OPEN);
+   capi_bench_port_operation(mod_ptr, FALSE, INTF_EXTN_DATA_PORT_OPEN);
+
+   // same choice of interleaving as the topology, lengths are set on all the buffers so both work
+   capi_bench_init_media_fmt(&mod_ptr->in_mf, cfg_ptr, mod_ptr->supports_deintlvd_unpacked_v2);
+   mod_ptr->out_mf = mod_ptr->in_mf;
+
+   capi_prop_t     mf_prop;
+   capi_proplist_t mf_proplist = { .props_num = 1, .prop_ptr = &mf_prop };
+
+   memset(&mf_prop, 0, sizeof(mf_prop));
+   mf_prop.id                      = CAPI_INPUT_MEDIA_FORMAT_V2;
+   mf_prop.payload.data_ptr        = (int8_t *)&mod_ptr->in_mf;
+   // full size like the topology sends it, some modules check for it
+   mf_prop.payload.actual_data_len = sizeof(mod_ptr->in_mf);
+   mf_prop.payload.max_data_len    = sizeof(mod_ptr->in_mf);
+   mf_prop.port_info.is_valid      = TRUE;
+   mf_prop.port_info.is_input_port = TRUE;
+   mf_prop.port_info.port_index    = 0;
+
+   if (CAPI_FAILED(err = mod_ptr->capi_ptr->vtbl_ptr->set_properties(mod_ptr->capi_ptr, &mf_proplist)))
+   {
+      return "input media format rejected";
+   }
+
+   capi_bench_port_operation(mod_ptr, TRUE, INTF_EXTN_DATA_PORT_START);
+   capi_bench_port_operation(mod_ptr, FALSE, INTF_EXTN_DATA_PORT_START);
+
+   if ((CAPI_FIXED_POINT != mod_ptr->out_mf.header.format_header.data_format) ||
+       ((16 != mod_ptr->out_mf.format.bits_per_sample) && (32 != mod_ptr->out_mf.format.bits_per_sample)) ||
+       (0 == mod_ptr->out_mf.format.num_channels) || (mod_ptr->out_mf.format.num_channels > CAPI_BENCH_MAX_CHANNELS) ||
+       (0 == mod_ptr->out_mf.format.sampling_rate))
+   {
+      return "unsupported output media format";
+   }
+
+   return NULL;
+}
+
+static void capi_bench_destroy_module(capi_bench_module_t *mod_ptr)
+{
+   if (mod_ptr->capi_ptr)
+   {
+      mod_ptr->capi_ptr->vtbl_ptr->end(mod_ptr->capi_ptr);
+      posal_memory_free(mod_ptr->capi_ptr);
+      mod_ptr->capi_ptr = NULL;
+   }
+}
+
+static bool_t capi_bench_alloc_bufs(capi_bench_bufs_t *bufs_ptr, capi_bench_module_t *mod_ptr, uint32_t frame_size)
+{
+   uint32_t in_rate  = mod_ptr->in_mf.format.sampling_rate;
+   uint32_t out_rate = mod_ptr->out_mf.format.sampling_rate;
+   uint32_t in_ch    = mod_ptr->in_mf.format.num_channels;
+   uint32_t out_ch   = mod_ptr->out_mf.format.num_channels;
+
+   memset(bufs_ptr, 0, sizeof(*bufs_ptr));
+
+   bufs_ptr->in_max_samples = frame_size;
+
+   // room for rate conversion, a frame of buffering in the module and the output threshold if it raised one
+   bufs_ptr->out_max_samples = (uint32_t)(((uint64_t)frame_size * out_rate + in_rate - 1) / in_rate) + frame_size;
+   bufs_ptr->out_max_samples =
+      MAX(bufs_ptr->out_max_samples, mod_ptr->out_threshold_bytes / (out_ch * (mod_ptr->out_mf.format.bits_per_sample >> 3)));
+
+   for (uint32_t ch = 0; ch < in_ch; ch++)
+   {
+      if (!(bufs_ptr->in_ch_ptrs[ch] = (int8_t *)calloc(bufs_ptr->in_max_samples, sizeof(int32_t))))
+      {
+         return FALSE;
+      }
+      bufs_ptr->in_bufs[ch].data_ptr = bufs_ptr->in_ch_ptrs[ch];
+   }
+
+   // output words are sized for 32 bits, so a module that changes its output format while processing still fits
+   for (uint32_t ch = 0; ch < CAPI_BENCH_MAX_CHANNELS; ch++)
+   {
+      if ((ch < out_ch) && !(bufs_ptr->out_ch_ptrs[ch] = (int8_t *)calloc(bufs_ptr->out_max_samples, sizeof(int32_t))))
+      {
+         return FALSE;
+      }
+      bufs_ptr->out_bufs[ch].data_ptr = bufs_ptr->out_ch_ptrs[ch];
+   }
+
+   bufs_ptr->in_sdata.flags.stream_data_version  = CAPI_STREAM_V2;
+   bufs_ptr->in_sdata.buf_ptr                    = bufs_ptr->in_bufs;
+   bufs_ptr->in_sdata.bufs_num                   = in_ch;
+   bufs_ptr->out_sdata.flags.stream_data_version = CAPI_STREAM_V2;
+   bufs_ptr->out_sdata.buf_ptr                   = bufs_ptr->out_bufs;
+   bufs_ptr->out_sdata.bufs_num                  = out_ch;
+
+   return TRUE;
+}
+
+static void capi_bench_free_bufs(capi_bench_bufs_t *bufs_ptr)
+{
+   for (uint32_t ch = 0; ch < CAPI_BENCH_MAX_CHANNELS; ch++)
+   {
+      free(bufs_ptr->in_ch_ptrs[ch]);
+      free(bufs_ptr->out_ch_ptrs[ch]);
+   }
+   memset(bufs_ptr, 0, sizeof(*bufs_ptr));
+}
+
+/* compares (or records) the output of one process call, channel after channel */
+static void capi_bench_ref_process(capi_bench_ref_t *ref_ptr, const int8_t *data_ptr, uint32_t size)
+{
+   if (!ref_ptr->fp || ref_ptr->is_mismatch)
+   {
+      return;
+   }
+
+   if (ref_ptr->is_update)
+   {
+      fwrite(data_ptr, size, 1, ref_ptr->fp);
+      ref_ptr->offset += size;
+      return;
+   }
+
+   while (size)
+   {
+      uint32_t chunk_size = MIN(size, (uint32_t)sizeof(ref_ptr->chunk));
+      uint32_t rd_size    = (uint32_t)fread(ref_ptr->chunk, 1, chunk_size, ref_ptr->fp);
+
+      for (uint32_t i = 0; i < chunk_size; i++)
+      {
+         if ((i >= rd_size) || (ref_ptr->chunk[i] != (uint8_t)data_ptr[i]))
+         {
+            ref_ptr->is_mismatch = TRUE;
+            ref_ptr->offset += i;
+            return;
+         }
+      }
+
+      ref_ptr->offset += chunk_size;
+      data_ptr += chunk_size;
+      size -= chunk_size;
+   }
+}
+
+static capi_bench_ref_status_t capi_bench_ref_close(capi_bench_ref_t *ref_ptr, uint64_t *mismatch_offset_ptr)
+{
+   capi_bench_ref_status_t status = CAPI_BENCH_REF_NONE;
+
+   if (!ref_ptr->fp)
+   {
+      return status;
+   }
+
+   if (ref_ptr->is_update)
+   {
+      status = CAPI_BENCH_REF_UPDATED;
+   }
+   else
+   {
+      // a longer reference means the module produced less data than before
+      if (!ref_ptr->is_mismatch && (EOF != fgetc(ref_ptr->fp)))
+      {
+         ref_ptr->is_mismatch = TRUE;
+      }
+      status               = ref_ptr->is_mismatch ? CAPI_BENCH_REF_MISMATCH : CAPI_BENCH_REF_MATCH;
+      *mismatch_offset_ptr = ref_ptr->offset;
+   }
+
+   fclose(ref_ptr->fp);
+   ref_ptr->fp = NULL;
+   return status;
+}
+
+static const char *capi_bench_process_loop(capi_bench_cfg_t *       cfg_ptr,
+                                           capi_bench_module_t *    mod_ptr,
+                                           capi_bench_bufs_t *      bufs_ptr,
+                                           capi_bench_src_t *       src_ptr,
+                                           capi_bench_ref_t *       ref_ptr,
+                                           capi_bench_wav_writer_t *wr_ptr,
+                                           capi_bench_result_t *    result_ptr,
+                                           uint64_t                 heap_base)
+{
+   uint32_t in_ch          = mod_ptr->in_mf.format.num_channels;
+   uint32_t in_bytes       = mod_ptr->in_mf.format.bits_per_sample >> 3;
+   uint32_t in_fill        = 0;
+   uint32_t num_stalls     = 0;
+   bool_t   is_eos         = FALSE;
+   uint64_t total_frames   = cfg_ptr->num_frames ? ((uint64_t)cfg_ptr->warmup_frames + cfg_ptr->num_frames) : UINT64_MAX;
+   capi_stream_data_t *in_sdata_ptrs[1]  = { (capi_stream_data_t *)&bufs_ptr->in_sdata };
+   capi_stream_data_t *out_sdata_ptrs[1] = { (capi_stream_data_t *)&bufs_ptr->out_sdata };
+
+   result_ptr->min_ns = UINT64_MAX;
+
+   for (uint64_t frame = 0; frame < total_frames; frame++)
+   {
+      if (!is_eos)
+      {
+         uint32_t to_read = bufs_ptr->in_max_samples - in_fill;
+         uint32_t n       = capi_bench_src_read(src_ptr, bufs_ptr->in_ch_ptrs, in_fill, to_read);
+         in_fill += n;
+         is_eos = (n < to_read);
+      }
+
+      if (0 == in_fill)
+      {
+         break;
+      }
+
+      for (uint32_t ch = 0; ch < in_ch; ch++)
+      {
+         bufs_ptr->in_bufs[ch].actual_data_len = in_fill * in_bytes;
+         bufs_ptr->in_bufs[ch].max_data_len    = bufs_ptr->in_max_samples * in_bytes;
+      }
+      for (uint32_t ch = 0; ch < bufs_ptr->out_sdata.bufs_num; ch++)
+      {
+         bufs_ptr->out_bufs[ch].data_ptr        = bufs_ptr->out_ch_ptrs[ch];
+         bufs_ptr->out_bufs[ch].actual_data_len = 0;
+         bufs_ptr->out_bufs[ch].max_data_len    = bufs_ptr->out_max_samples * (mod_ptr->out_mf.format.bits_per_sample >> 3);
+      }
+      bufs_ptr->in_sdata.flags.end_of_frame = is_eos;
+
+      uint64_t   start_cycles = capi_bench_get_cycles();
+      uint64_t   start_ns     = capi_bench_get_time_ns();
+      capi_err_t err = mod_ptr->capi_ptr->vtbl_ptr->process(mod_ptr->capi_ptr, in_sdata_ptrs, out_sdata_ptrs);
+      uint64_t   elapsed_ns     = capi_bench_get_time_ns() - start_ns;
+      uint64_t   elapsed_cycles = capi_bench_get_cycles() - start_cycles;
+
+      if (CAPI_FAILED(err))
+      {
+         return "process failed";
+      }
+
+      // the media format can change from within process, e.g. on the first frame
+      uint32_t out_ch    = MIN(mod_ptr->out_mf.format.num_channels, (uint32_t)CAPI_BENCH_MAX_CHANNELS);
+      uint32_t out_bytes = mod_ptr->out_mf.format.bits_per_sample >> 3;
+      if ((out_ch != bufs_ptr->out_sdata.bufs_num) || ((2 != out_bytes) && (4 != out_bytes)))
+      {
+         return "output media format changed while processing";
+      }
+
+      uint32_t consumed = bufs_ptr->in_bufs[0].actual_data_len / in_bytes;
+      uint32_t produced = bufs_ptr->out_bufs[0].actual_data_len / out_bytes;
+
+      if ((0 == consumed) && (0 == produced))
+      {
+         if ((++num_stalls >= CAPI_BENCH_MAX_STALLS) || is_eos)
+         {
+            break;
+         }
+      }
+      else
+      {
+         num_stalls = 0;
+      }
+
+      // keep what was not consumed for the next call
+      consumed = MIN(consumed, in_fill);
+      if (consumed < in_fill)
+      {
+         for (uint32_t ch = 0; ch < in_ch; ch++)
+         {
+            memmove(bufs_ptr->in_ch_ptrs[ch],
+                    bufs_ptr->in_ch_ptrs[ch] + consumed * in_bytes,
+                    (in_fill - consumed) * in_bytes);
+         }
+      }
+      in_fill -= consumed;
+
+      if (frame >= cfg_ptr->warmup_frames)
+      {
+         result_ptr->num_frames++;
+         result_ptr->num_samples += consumed;
+         result_ptr->total_ns += elapsed_ns;
+         result_ptr->total_cycles += elapsed_cycles;
+         result_ptr->min_ns = MIN(result_ptr->min_ns, elapsed_ns);
+         result_ptr->max_ns = MAX(result_ptr->max_ns, elapsed_ns);
+      }
+
+      for (uint32_t ch = 0; ch < out_ch; ch++)
+      {
+         // a module sharing its input with the output points the output buffers somewhere else
+         capi_bench_ref_process(ref_ptr, bufs_ptr->out_bufs[ch].data_ptr, produced * out_bytes);
+      }
+      capi_bench_wav_writer_write(wr_ptr, bufs_ptr->out_bufs, produced, mod_ptr->out_mf.format.q_factor);
+
+      uint64_t heap_now = capi_bench_get_heap_in_use();
+      if (heap_now > heap_base)
+      {
+         result_ptr->peak_heap_bytes = MAX(result_ptr->peak_heap_bytes, result_ptr->heap_bytes + (heap_now - heap_base));
+      }
+
+      if (is_eos && (0 == in_fill))
+      {
+         break;
+      }
+   }
+
+#ifndef CAPI_BENCH_HAS_CYCLE_COUNTER
+   result_ptr->total_cycles = (result_ptr->total_ns * cfg_ptr->cpu_mhz) / 1000;
+#endif
+
+   return NULL;
+}
+
+ar_result_t capi_bench_run_module(const amdb_static_capi_module_t *entry_ptr,
+                                  capi_bench_cfg_t *               cfg_ptr,
+                                  capi_bench_result_t *            result_ptr)
+{
+   capi_bench_module_t     mod;
+   capi_bench_bufs_t       bufs;
+   capi_bench_src_t        src;
+   capi_bench_ref_t *      ref_ptr = NULL;
+   capi_bench_wav_writer_t wr;
+   capi_bench_cfg_t        cfg = *cfg_ptr;
+   const char *            fail_reason_ptr;
+
+   memset(&mod, 0, sizeof(mod));
+   memset(&bufs, 0, sizeof(bufs));
+   memset(&wr, 0, sizeof(wr));
+   memset(result_ptr, 0, sizeof(*result_ptr));
+
+   // the source is reopened for every module so that all of them see the same input
+   if (AR_EOK != capi_bench_src_open(&src, &cfg))
+   {
+      result_ptr->fail_reason_ptr = "cannot open the input";
+      return AR_EFAILED;
+   }
+
+   uint64_t heap_start = capi_bench_get_heap_in_use();
+
+   fail_reason_ptr = capi_bench_create_module(entry_ptr, &cfg, &mod, result_ptr);
+
+   result_ptr->heap_bytes      = capi_bench_get_heap_in_use() - heap_start;
+   result_ptr->peak_heap_bytes = result_ptr->heap_bytes;
+   result_ptr->kpps            = mod.kpps;
+   result_ptr->delay_us        = mod.delay_us;
+   result_ptr->num_channels    = cfg.num_channels;
+
+   if (fail_reason_ptr)
+   {
+      goto __bail_out;
+   }
+
+   result_ptr->is_setup_done = TRUE;
+
+   if (!mod.is_enabled)
+   {
+      result_ptr->is_disabled = TRUE;
+      goto __bail_out;
+   }
+
+   // modules with a fixed frame raise their threshold, which decides the frame size
+   uint32_t frame_size = cfg.frame_size;
+   if (mod.in_threshold_bytes > 1)
+   {
+      frame_size = MAX(1, mod.in_threshold_bytes / (cfg.num_channels * (mod.in_mf.format.bits_per_sample >> 3)));
+   }
+
+   if (!capi_bench_alloc_bufs(&bufs, &mod, frame_size))
+   {
+      fail_reason_ptr = "no memory for the buffers";
+      goto __bail_out;
+   }
+
+   if (cfg.ref_path)
+   {
+      ref_ptr = (capi_bench_ref_t *)calloc(1, sizeof(capi_bench_ref_t));
+      if (ref_ptr)
+      {
+         ref_ptr->is_update = cfg.update_ref;
+         ref_ptr->fp        = fopen(cfg.ref_path, cfg.update_ref ? "wb" : "rb");
+         if (!ref_ptr->fp && cfg.update_ref)
+         {
+            fprintf(stderr, "capi_bench: cannot create %s\n", cfg.ref_path);
+         }
+      }
+   }
+
+   if (cfg.out_wav_path)
+   {
+      (void)capi_bench_wav_writer_open(&wr,
+                                       cfg.out_wav_path,
+                                       mod.out_mf.format.sampling_rate,
+                                       mod.out_mf.format.num_channels,
+                                       mod.out_mf.format.bits_per_sample);
+   }
+
+   fail_reason_ptr = capi_bench_process_loop(&cfg,
+                                             &mod,
+                                             &bufs,
+                                             &src,
+                                             ref_ptr ? ref_ptr : &(capi_bench_ref_t){ 0 },
+                                             &wr,
+                                             result_ptr,
+                                             capi_bench_get_heap_in_use());
+
+   result_ptr->kpps     = mod.kpps;
+   result_ptr->delay_us = mod.delay_us;
+
+__bail_out:
+   if (ref_ptr)
+   {
+      result_ptr->ref_status = capi_bench_ref_close(ref_ptr, &result_ptr->ref_mismatch_offset);
+      free(ref_ptr);
+   }
+   capi_bench_wav_writer_close(&wr);
+   capi_bench_free_bufs(&bufs);
+   capi_bench_destroy_module(&mod);
+   capi_bench_src_close(&src);
+
+   if (0 == result_ptr->num_frames)
+   {
+      result_ptr->min_ns = 0;
+   }
+
+   result_ptr->fail_reason_ptr = fail_reason_ptr;
+   if (fail_reason_ptr)
+   {
+      return AR_EFAILED;
+   }
+
+   return AR_EOK;
+}
@@ -35,22 +35,74 @@ Type Declarations
 /** Structure holding all spf_bufmgr static variables.
  */
 
-/* This struct is the bin for each power-of-2 buffer size. */
-typedef struct posal_bufbin_t
+/* Number of size classes. Classes are 16, 24 and 32 bytes followed by four classes per power of two, i.e. 40, 48,
+   56, 64, 80, 96, ... 3584, 4096 bytes. Each class is at most 1.25x (1.5x for 24) the size of the previous one. */
+#define SPF_BUFMGR_NUM_SIZE_CLASSES 31
+
+/* Largest size served from the size classes. Bigger requests are allocated from heap. */
+#define SPF_BUFMGR_MAX_CLASS_SIZE 4096
+
+/* Maximum number of buffers (preallocated + grown) a size class may own. */
+#define SPF_BUFMGR_MAX_BUFS_PER_CLASS 64
+
+/* Maximum number of bytes all size classes together may grow beyond the preallocated buffers. */
+#define SPF_BUFMGR_MAX_GROWN_BYTES (64 * 1024)
+
+/* Number of buffer gets after which a size class starts a new high-water window. At the start of a window, grown
+   buffers are freed from the class queue while the class owns more buffers than the high-water of the two windows
+   before. */
+#define SPF_BUFMGR_SHRINK_WINDOW 64
+
+/* Tag stored in word 3 of the metadata: identifies the size class of the buffer and whether it was grown from heap
+   (as opposed to preallocated in the buffer manager blob). */
+#define SPF_BUFMGR_CLASS_TAG 0x5BC00000
+#define SPF_BUFMGR_CLASS_TAG_MASK 0xFFFF0000
+#define SPF_BUFMGR_CLASS_TAG_GROWN 0x00000100
+#define SPF_BUFMGR_CLASS_TAG_IDX_MASK 0x000000FF
+
+/* Statistics of a size class. */
+typedef struct spf_bufmgr_class_stats_t
 {
-   int            nBufs;
-   posal_queue_t *pQ;
-} posal_bufbin_t;
+   uint32_t buf_size;        /* Size of the buffers of this class in bytes. */
+   uint32_t num_prealloc;    /* Buffers preallocated at create time. */
+   uint32_t num_bufs;        /* Buffers currently owned (preallocated + grown). */
+   uint32_t num_in_use;      /* Buffers currently handed out, i.e. owned but not in the class queue. */
+   uint32_t max_in_use;      /* High-water of num_in_use since create. */
+   uint32_t num_grown;       /* Buffers allocated from heap to grow the class. */
+   uint32_t num_shrunk;      /* Grown buffers freed back to heap. */
+   uint32_t num_borrowed;    /* Buffers handed out for requests of a smaller class. */
+} spf_bufmgr_class_stats_t;
+
+/* Statistics of the buffer manager. */
+typedef struct spf_bufmgr_stats_t
+{
+   uint32_t                 num_heap_allocs; /* Requests which could not be served from a size class. */
+   uint32_t                 grown_bytes;     /* Bytes currently grown beyond the preallocated buffers. */
+   spf_bufmgr_class_stats_t class_stats[SPF_BUFMGR_NUM_SIZE_CLASSES];
+} spf_bufmgr_stats_t;
+
+/* This struct is the state of each size class. */
+typedef struct posal_bufclass_t
+{
+   posal_queue_t *          pQ;
+   uint32_t                 win_max_in_use;      /* High-water of num_in_use in the current window. */
+   uint32_t                 prev_win_max_in_use; /* High-water of num_in_use in the previous window. */
+   uint32_t                 win_num_gets;        /* Number of buffers handed out in the current window. */
+   spf_bufmgr_class_stats_t stats;
+} posal_bufclass_t;
 
 /* This is the state instance of the buffer manager. */
 typedef struct posal_bufmgr_t
 {
-   char *          pStartAddr;
-   uint32_t        size;
-   posal_mutex_t   mutex;
-   posal_channel_t channel_ptr;
-   uint32_t        unAnyBufsMask;
-   posal_bufbin_t  aBufferBin[32];
+   char *           pStartAddr;
+   uint32_t         size;
+   POSAL_HEAP_ID    heap_id;
+   posal_mutex_t    mutex;
+   posal_channel_t  channel_ptr;
+   uint32_t         unAnyBufsMask;
+   uint32_t         num_heap_allocs;
+   uint32_t         grown_bytes;
+   posal_bufclass_t aSizeClass[SPF_BUFMGR_NUM_SIZE_CLASSES];
 } posal_bufmgr_t;
 
 /** Node that represents a buffer. When clients request a buffer from the
@@ -101,26 +153,26 @@ void spf_bufmgr_global_deinit(void);
    Creates the buffer manager. This function also performs a sanity check on
    the sizes of the requested set of buffers.
 
-   @param[in]  bufsize_bins  Pointer to an array of 32 integers. \n
-                             bufsize_bins[n] is the number of buffers of size
-                             2^n bytes to be managed by the buffer manager. The
-                             first three elements must be 0 because 8 is the
-                             minimum supported buffer size.
+   @param[in]  bufs_per_class  Pointer to an array of SPF_BUFMGR_NUM_SIZE_CLASSES
+                             integers. \n
+                             bufs_per_class[n] is the number of buffers of
+                             size class n to be preallocated. Classes can grow
+                             beyond this on demand.
    @param[in]  heap_id       Heap ID required for mallocs
    @param[out] buf_mgr_pptr  Double pointer to the buffer manager created if
                              this function returns AR_EOK.
 
    @return
-   AR_EBADPARAM -- Invalid bufsize_bins (e.g., a request for buffers smaller
-                   than 8 bytes).
+   AR_EBADPARAM -- Invalid bufs_per_class (e.g., more buffers than
+                   SPF_BUFMGR_MAX_BUFS_PER_CLASS in a class).
    @par
-   AR_EOK -- bufsize_bins is valid. The buffer manager is created and its
+   AR_EOK -- bufs_per_class is valid. The buffer manager is created and its
                pointer is put in the buf_mgr_pptr parameter.
 
    @dependencies
    None. @newpage
  */
-ar_result_t spf_bufmgr_create(const uint32_t *bufsize_bins, posal_bufmgr_t **buf_mgr_pptr, POSAL_HEAP_ID heap_id);
+ar_result_t spf_bufmgr_create(const uint32_t *bufs_per_class, posal_bufmgr_t **buf_mgr_pptr, POSAL_HEAP_ID heap_id);
 /**
    Takes the address of a managed buffer, looks up the metadata, and pushes the
    address to the home queue.
@@ -156,9 +208,12 @@ ar_result_t spf_bufmgr_return_buf(void *buf_ptr);
 void spf_bufmgr_destroy(posal_bufmgr_t *buf_mgr_ptr);
 
 /**
-   Requests a buffer from the manager. If a buffer of adequate size is
-   available, a node is returned with pointers to the buffer and the return
-   queue of the buffer.
+   Requests a buffer from the manager. The buffer is taken from the smallest
+   size class which fits desired_size. If that class is empty it is grown from
+   heap, and if it cannot grow or growing fails a buffer is borrowed from a
+   bigger class. If none is available the buffer is allocated from heap. A
+   node is returned with pointers to the buffer and the return queue of the
+   buffer.
 
    @datatypes
    posal_bufmgr_node_t
@@ -200,6 +255,24 @@ ar_result_t spf_bufmgr_poll_for_buffer(uint32_t             desired_size,
   */
 bool_t spf_is_bufmgr_node(void *buf_ptr);
 
+/**
+   Gets the statistics of the spf buffer manager.
+
+   @datatypes
+   spf_bufmgr_stats_t
+
+   @param[out] stats_ptr    Pointer to the statistics to fill.
+
+   @return
+   AR_EOK -- Success.
+   @par
+   AR_EFAILED -- The buffer manager is not created.
+
+   @dependencies
+   spf_bufmgr_global_init() must be called before calling this function.
+  */
+ar_result_t spf_bufmgr_get_stats(spf_bufmgr_stats_t *stats_ptr);
+
 #ifdef __cplusplus
 }
 #endif //__cplusplus
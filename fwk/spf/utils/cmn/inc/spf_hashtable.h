@@ -157,7 +157,8 @@ ar_result_t spf_hashtable_remove(spf_hashtable_t *ht_ptr,
                                  spf_hash_node_t *node_ptr);
 
 /**
-  De-inits hashtable
+  De-inits hashtable. Calling it again is harmless and the hashtable can be
+  inited again afterwards.
 
   @param[in] ht_ptr    Pointer to the hashtable.
 
@@ -18,8 +18,6 @@ INCLUDE FILES FOR MODULE
 
 extern uint32_t g_heap_alloc_indicator;
 
-/* Macro for maximum bins */
-#define POSAL_BUFMGR_MAX_BUFFER_BINS 32
 static const uint32_t MSB_32                  = 0x80000000L;
 static const uint32_t CORRUPTION_DETECT_MAGIC = 0x836ADF71;
 /*--------------------------------------------------------------*/
@@ -49,18 +47,21 @@ ar_result_t spf_bufmgr_global_init(POSAL_HEAP_ID heap_id)
 
    /*
     * This is a configuraton parameter for spf global memory pool.
-    * This is the distribution of different size buffers.
-    * It can be optimized based on the spf system load.
+    * This is the number of buffers preallocated for each size class.
+    * It can be optimized based on the spf system load, classes grow and
+    * shrink on demand beyond this.
     * Current configurations:
-    * 16 uint8_t:  32 buffers
-    * 32 uint8_t:  16 buffers
-    * 64 uint8_t:  8 buffers
-    * 128 uint8_t: 8 buffers
-    * 256 uint8_t: 2 buffers
-    * 512 uint8_t: 4 buffers
+    * 16 uint8_t:  16 buffers
+    * 24, 32 uint8_t: 8 buffers each
+    * 40 - 128 uint8_t: 2 buffers each
+    * 160 - 512 uint8_t: 1 buffer each
+    * 640 - 4096 uint8_t: none
     */
-   const uint32_t buf_bins[] = { 0, 0, 0, 0, 32, 16, 8, 8, 2, 4, 0, 0, 0, 0, 0, 0,
-                                 0, 0, 0, 0, 0,  0,  0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+   const uint32_t bufs_per_class[SPF_BUFMGR_NUM_SIZE_CLASSES] = { 16, 8, 8,                   /* 16 - 32    */
+                                                                  2,  2, 2, 2, 2, 2, 2, 2,     /* 40 - 128   */
+                                                                  1,  1, 1, 1, 1, 1, 1, 1,     /* 160 - 512  */
+                                                                  0,  0, 0, 0, 0, 0, 0, 0,     /* 640 - 2048 */
+                                                                  0,  0, 0, 0 };               /* 2560 - 4096 */
 
    // Initialize global variables to zero.
    spf_bufmgr_ptr = NULL;
@@ -71,7 +72,7 @@ ar_result_t spf_bufmgr_global_init(POSAL_HEAP_ID heap_id)
    }
 
    // Allocate memory.
-   result = spf_bufmgr_create(buf_bins, &spf_bufmgr_ptr, heap_id);
+   result = spf_bufmgr_create(bufs_per_class, &spf_bufmgr_ptr, heap_id);
    if (AR_DID_FAIL(result))
    {
       AR_MSG(DBG_HIGH_PRIO, "Failed to create buffer manager!!");
@@ -100,23 +101,48 @@ void spf_bufmgr_global_deinit(void)
 #endif //#ifndef DISABLE_DEINIT
 }
 
-ar_result_t spf_bufmgr_create(const uint32_t *nBufsInBin, posal_bufmgr_t **ppBufMgr, POSAL_HEAP_ID heap_id)
+/* Size in bytes of the buffers of size class class_idx, see SPF_BUFMGR_NUM_SIZE_CLASSES */
+static uint32_t spf_bufmgr_get_class_size(uint32_t class_idx)
 {
-   ar_result_t result;
-   uint32_t    binIdx                = 0;
-   char *      pStartAddr            = NULL;
-   uint32_t    bufmgr_meta_data_size = POSAL_BUFMGR_METADATA_SIZE;
-   uint32_t    mem_blob_size_bytes   = 0;
-   spf_bufmgr_metadata_t  *metadata_ptr = NULL;
-
-   if (NULL == ppBufMgr)
+   static const uint32_t SMALL_CLASS_SIZES[] = { 16, 24, 32 };
+
+   if (class_idx < 3)
+   {
+      return SMALL_CLASS_SIZES[class_idx];
+   }
+
+   uint32_t pow2 = 5 + ((class_idx - 3) >> 2);
+   uint32_t step = ((class_idx - 3) & 3) + 1;
+
+   return (1 << pow2) + (step << (pow2 - 2));
+}
+
+ar_result_t spf_bufmgr_create(const uint32_t *nBufsInClass, posal_bufmgr_t **ppBufMgr, POSAL_HEAP_ID heap_id)
+{
+   ar_result_t            result;
+   uint32_t               classIdx              = 0;
+   char *                 pStartAddr            = NULL;
+   uint32_t               bufmgr_meta_data_size = POSAL_BUFMGR_METADATA_SIZE;
+   uint32_t               mem_blob_size_bytes   = 0;
+   spf_bufmgr_metadata_t *metadata_ptr          = NULL;
+
+   if ((NULL == ppBufMgr) || (NULL == nBufsInClass))
    {
       return AR_EBADPARAM;
    }
 
-   for (binIdx = 0; binIdx < 32; binIdx++)
+   for (classIdx = 0; classIdx < SPF_BUFMGR_NUM_SIZE_CLASSES; classIdx++)
    {
-      mem_blob_size_bytes += (nBufsInBin[binIdx]) * (bufmgr_meta_data_size + (1 << binIdx));
+      if (nBufsInClass[classIdx] > SPF_BUFMGR_MAX_BUFS_PER_CLASS)
+      {
+         AR_MSG(DBG_ERROR_PRIO,
+                "posal_bufmgr_create: %lu buffers requested for class %lu, max is %lu",
+                nBufsInClass[classIdx],
+                classIdx,
+                SPF_BUFMGR_MAX_BUFS_PER_CLASS);
+         return AR_EBADPARAM;
+      }
+      mem_blob_size_bytes += (nBufsInClass[classIdx]) * (bufmgr_meta_data_size + spf_bufmgr_get_class_size(classIdx));
    }
 
    /* Initialized posal global buffer manager*/
@@ -131,6 +157,7 @@ ar_result_t spf_bufmgr_create(const uint32_t *nBufsInBin, posal_bufmgr_t **ppBuf
    if (!(*ppBufMgr = (posal_bufmgr_t *)posal_memory_malloc(sizeof(posal_bufmgr_t), heap_id)))
    {
       AR_MSG(DBG_FATAL_PRIO, "Out of memory trying to posal_bufmgr_create!");
+      posal_memory_aligned_free(pStartAddr);
       return AR_ENOMEMORY;
    }
 
@@ -141,6 +168,7 @@ ar_result_t spf_bufmgr_create(const uint32_t *nBufsInBin, posal_bufmgr_t **ppBuf
    posal_bufmgr_t *pBufMgr = *ppBufMgr;
    pBufMgr->pStartAddr     = pStartAddr;
    pBufMgr->size           = mem_blob_size_bytes;
+   pBufMgr->heap_id        = heap_id;
 
    /* Inititialize the channel & mutex */
    if (AR_DID_FAIL(result = posal_channel_create(&pBufMgr->channel_ptr, heap_id)))
@@ -153,40 +181,30 @@ ar_result_t spf_bufmgr_create(const uint32_t *nBufsInBin, posal_bufmgr_t **ppBuf
 
    posal_mutex_create(&pBufMgr->mutex, heap_id);
 
-   /* Build up the array of buffer bins */
+   /* Build up the array of size classes. Every class gets a queue, even without preallocated buffers, since it
+    * can grow on demand. */
    uint8_t *pBuffer = (uint8_t *)pStartAddr;
-   for (binIdx = 3; binIdx < POSAL_BUFMGR_MAX_BUFFER_BINS; binIdx++)
+   for (classIdx = 0; classIdx < SPF_BUFMGR_NUM_SIZE_CLASSES; classIdx++)
    {
-      /* Continue if no buffers are requested for each bin */
-      if (0 == nBufsInBin[binIdx])
-      {
-         continue;
-      }
-
-      /* Add this bin to the mask */
-      pBufMgr->unAnyBufsMask |= (MSB_32 >> binIdx);
-
-      /* save number of buffers */
-      posal_bufbin_t *pBin = &pBufMgr->aBufferBin[binIdx];
-      pBin->nBufs          = nBufsInBin[binIdx];
+      posal_bufclass_t *pClass   = &pBufMgr->aSizeClass[classIdx];
+      pClass->stats.buf_size     = spf_bufmgr_get_class_size(classIdx);
+      pClass->stats.num_prealloc = nBufsInClass[classIdx];
+      pClass->stats.num_bufs     = nBufsInClass[classIdx];
 
       /* Create the queue name */
       char name[POSAL_DEFAULT_NAME_LEN];
       int  count = posal_atomic_increment(nInstanceCount) & 0x000000FFL;
-      snprintf(name, POSAL_DEFAULT_NAME_LEN, "BFRMGR%xBIN%lu", count, binIdx);
+      snprintf(name, POSAL_DEFAULT_NAME_LEN, "BFRMGR%xCL%lu", count, classIdx);
 
-      /* Round up queue nodes to nearest power of 2 */
-      int nQueueNodes = 1 << (32 - s32_cl0_s32(nBufsInBin[binIdx] - 1));
-
-      /* Create Q and add it to channel. */
+      /* Create Q and add it to channel. SPF_BUFMGR_MAX_BUFS_PER_CLASS is a power of 2. */
       posal_queue_init_attr_t q_attr;
       posal_queue_attr_init(&q_attr);
       posal_queue_attr_set_heap_id(&q_attr, heap_id);
-      posal_queue_attr_set_max_nodes(&q_attr, nQueueNodes);
+      posal_queue_attr_set_max_nodes(&q_attr, SPF_BUFMGR_MAX_BUFS_PER_CLASS);
       posal_queue_attr_set_prealloc_nodes(&q_attr, 0);
       posal_queue_attr_set_name(&q_attr, name);
-      if (AR_DID_FAIL(result = posal_queue_create_v1(&pBin->pQ, &q_attr)) ||
-          AR_DID_FAIL(result = posal_channel_addq(pBufMgr->channel_ptr, pBin->pQ, (MSB_32 >> binIdx))))
+      if (AR_DID_FAIL(result = posal_queue_create_v1(&pClass->pQ, &q_attr)) ||
+          AR_DID_FAIL(result = posal_channel_addq(pBufMgr->channel_ptr, pClass->pQ, (MSB_32 >> classIdx))))
       {
          AR_MSG(DBG_FATAL_PRIO, "posal_bufmgr_create failed to create queues for buffer nodes!");
          spf_bufmgr_destroy(pBufMgr);
@@ -194,12 +212,14 @@ ar_result_t spf_bufmgr_create(const uint32_t *nBufsInBin, posal_bufmgr_t **ppBuf
          return result;
       }
 
+      /* Add this class to the mask */
+      pBufMgr->unAnyBufsMask |= (MSB_32 >> classIdx);
+
       /* fill the queue with pointers */
       posal_bufmgr_node_t bufNode;
-      bufNode.return_q_ptr = pBin->pQ;
+      bufNode.return_q_ptr = pClass->pQ;
 
-      uint32_t buf_size_in_words = (1 << binIdx); //pBuffer is changed to uint8_t. Hence the divide with uin32_t is removed.
-      for (int buf_id = 0; buf_id < pBin->nBufs; buf_id++)
+      for (uint32_t buf_id = 0; buf_id < pClass->stats.num_prealloc; buf_id++)
       {
          /*
           *    fill 4 metadata words for finding buffer's home queue and for debug info.
@@ -207,19 +227,19 @@ ar_result_t spf_bufmgr_create(const uint32_t *nBufsInBin, posal_bufmgr_t **ppBuf
           *              &g_heap_alloc_indicator implies that the buf is allocated from heap
           *    Word 1 - (for corruption detection) the return queue handle XOR a magic number.
           *    Word 2 - thread ID of the allocating function. 0 implies unallocated buffer.
-          *    Word 3 - for 8-byte alignment.
+          *    Word 3 - size class tag, see SPF_BUFMGR_CLASS_TAG.
           */
          metadata_ptr = (spf_bufmgr_metadata_t *) pBuffer;
-         metadata_ptr->word0 = (void *)(pBin->pQ);
-         metadata_ptr->word1 = (void *)((uint64_t)(pBin->pQ) ^ CORRUPTION_DETECT_MAGIC);
+         metadata_ptr->word0 = (void *)(pClass->pQ);
+         metadata_ptr->word1 = (void *)((uint64_t)(pClass->pQ) ^ CORRUPTION_DETECT_MAGIC);
          metadata_ptr->word2 = 0;
-         metadata_ptr->word3 = 0;
+         metadata_ptr->word3 = (void *)((uint64_t)(SPF_BUFMGR_CLASS_TAG | classIdx));
 
          pBuffer += sizeof(spf_bufmgr_metadata_t);
          bufNode.buf_ptr = (char *)pBuffer;
 
-         posal_queue_push_back(pBin->pQ, (posal_queue_element_t *)&bufNode);
-         pBuffer += buf_size_in_words;
+         posal_queue_push_back(pClass->pQ, (posal_queue_element_t *)&bufNode);
+         pBuffer += pClass->stats.buf_size;
       }
    }
    return AR_EOK;
@@ -234,20 +254,29 @@ void spf_bufmgr_destroy(posal_bufmgr_t *pBufMgr)
    if (!pBufMgr)
       return;
 
-   /* lock out all clients and drain all the buffers */
-   posal_mutex_lock(pBufMgr->mutex);
-
-   for (int binIdx = 0; binIdx < POSAL_BUFMGR_MAX_BUFFER_BINS; binIdx++)
+   for (int classIdx = 0; classIdx < SPF_BUFMGR_NUM_SIZE_CLASSES; classIdx++)
    {
-      if (pBufMgr->unAnyBufsMask & (MSB_32 >> binIdx))
+      posal_bufclass_t *pClass = &pBufMgr->aSizeClass[classIdx];
+      if (pBufMgr->unAnyBufsMask & (MSB_32 >> classIdx))
       {
-         for (int buf_id = 0; buf_id < pBufMgr->aBufferBin[binIdx].nBufs; buf_id++)
+         for (uint32_t buf_id = 0; buf_id < pClass->stats.num_bufs; buf_id++)
          {
-            (void)posal_channel_wait(pBufMgr->channel_ptr, MSB_32 >> binIdx);
-            result = posal_queue_pop_front(pBufMgr->aBufferBin[binIdx].pQ, (posal_queue_element_t *)&bufNode);
+            (void)posal_channel_wait(pBufMgr->channel_ptr, MSB_32 >> classIdx);
+            result = posal_queue_pop_front(pClass->pQ, (posal_queue_element_t *)&bufNode);
             POSAL_ASSERT(AR_SUCCEEDED(result));
+
+            /* Grown buffers were allocated from heap individually */
+            spf_bufmgr_metadata_t *metadata_ptr =
+               (spf_bufmgr_metadata_t *)((uint8_t *)(bufNode.buf_ptr) - POSAL_BUFMGR_METADATA_SIZE);
+            if ((uint64_t)metadata_ptr->word3 & SPF_BUFMGR_CLASS_TAG_GROWN)
+            {
+               posal_memory_free(metadata_ptr);
+            }
          }
-         posal_queue_destroy(pBufMgr->aBufferBin[binIdx].pQ);
+      }
+      if (pClass->pQ)
+      {
+         posal_queue_destroy(pClass->pQ);
       }
    }
 
@@ -258,9 +287,38 @@ void spf_bufmgr_destroy(posal_bufmgr_t *pBufMgr)
    posal_memory_aligned_free(pBufMgr->pStartAddr);
 
    /* destroy mutex */
-   posal_mutex_unlock(pBufMgr->mutex);
-   posal_mutex_destroy(&pBufMgr->mutex);
+   if (pBufMgr->mutex)
+   {
+      posal_mutex_destroy(&pBufMgr->mutex);
+   }
 
    /* free buffer manager handle. */
    posal_memory_free(pBufMgr);
 }
+
+ar_result_t spf_bufmgr_get_stats(spf_bufmgr_stats_t *stats_ptr)
+{
+   posal_bufmgr_t *pBufMgr = spf_bufmgr_ptr;
+
+   if ((NULL == pBufMgr) || (NULL == stats_ptr))
+   {
+      return AR_EFAILED;
+   }
+
+   posal_mutex_lock(pBufMgr->mutex);
+
+   stats_ptr->num_heap_allocs = pBufMgr->num_heap_allocs;
+   stats_ptr->grown_bytes     = pBufMgr->grown_bytes;
+   for (uint32_t classIdx = 0; classIdx < SPF_BUFMGR_NUM_SIZE_CLASSES; classIdx++)
+   {
+      posal_bufclass_t *pClass = &pBufMgr->aSizeClass[classIdx];
+
+      /* buffers are returned without the mutex, see spf_bufmgr_return_buf */
+      pClass->stats.num_in_use = pClass->stats.num_bufs - posal_queue_get_queue_fullness(pClass->pQ);
+      stats_ptr->class_stats[classIdx] = pClass->stats;
+   }
+
+   posal_mutex_unlock(pBufMgr->mutex);
+
+   return AR_EOK;
+}
@@ -22,6 +22,7 @@ metadata for the following:
 - To detect double-free scenarios
  */
 static const uint32_t CORRUPTION_DETECT_MAGIC = 0x836ADF71;
+static const uint32_t MSB_32                  = 0x80000000L;
 
 // Global variables.
 posal_bufmgr_t *spf_bufmgr_ptr;
@@ -33,6 +34,81 @@ uint32_t g_heap_alloc_indicator;
 /* =======================================================================
  **                          Function Definitions
  ** ======================================================================= */
+/* Index of the smallest size class which fits size, see SPF_BUFMGR_NUM_SIZE_CLASSES.
+   size must not exceed SPF_BUFMGR_MAX_CLASS_SIZE. */
+static inline uint32_t spf_bufmgr_get_class_idx(uint32_t size)
+{
+   if (size <= 32)
+   {
+      return (size <= 16) ? 0 : ((size <= 24) ? 1 : 2);
+   }
+
+   /* 2^pow2 < size <= 2^(pow2 + 1), the group of four classes above 2^pow2 is spaced by 2^(pow2 - 2). */
+   uint32_t pow2 = 31 - s32_cl0_s32(size - 1);
+   uint32_t step = ((size - (1 << pow2)) + (1 << (pow2 - 2)) - 1) >> (pow2 - 2);
+
+   return 2 + ((pow2 - 5) << 2) + step;
+}
+
+/* Frees the grown buffers of pClass which were not needed in the last two windows, called with the bufmgr mutex
+   held. Only buffers sitting in the class queue can be freed, preallocated ones are pushed back. */
+static void spf_bufmgr_class_shrink(posal_bufmgr_t *pBufMgr, posal_bufclass_t *pClass)
+{
+   uint32_t            num_needed = MAX(pClass->win_max_in_use, pClass->prev_win_max_in_use);
+   uint32_t            num_queued = posal_queue_get_queue_fullness(pClass->pQ);
+   posal_bufmgr_node_t bufNode;
+
+   for (uint32_t i = 0; (i < num_queued) && (pClass->stats.num_bufs > num_needed) &&
+                        (pClass->stats.num_grown > pClass->stats.num_shrunk);
+        i++)
+   {
+      if (AR_DID_FAIL(posal_queue_pop_front(pClass->pQ, (posal_queue_element_t *)&bufNode)))
+      {
+         break;
+      }
+
+      spf_bufmgr_metadata_t *metadata_ptr =
+         (spf_bufmgr_metadata_t *)((uint8_t *)(bufNode.buf_ptr) - POSAL_BUFMGR_METADATA_SIZE);
+      if ((uint64_t)metadata_ptr->word3 & SPF_BUFMGR_CLASS_TAG_GROWN)
+      {
+#ifdef DEBUG_POSAL_BUFMGR
+         AR_MSG(DBG_HIGH_PRIO, "BufMgr ShrinkBuffer: Buff=0x%x", bufNode.buf_ptr);
+#endif
+         pClass->stats.num_bufs--;
+         pClass->stats.num_shrunk++;
+         pBufMgr->grown_bytes -= pClass->stats.buf_size;
+         posal_memory_free(metadata_ptr);
+      }
+      else
+      {
+         posal_queue_push_back(pClass->pQ, (posal_queue_element_t *)&bufNode);
+      }
+   }
+}
+
+/* Accounts a buffer of pClass handed out, called with the bufmgr mutex held. Buffers are returned without the mutex
+   (and in island mode without spf_bufmgr_return_buf), so the buffers in use are the owned ones not in the queue. */
+static inline void spf_bufmgr_class_account_get(posal_bufmgr_t *pBufMgr, posal_bufclass_t *pClass)
+{
+   pClass->stats.num_in_use = pClass->stats.num_bufs - posal_queue_get_queue_fullness(pClass->pQ);
+   if (pClass->stats.num_in_use > pClass->stats.max_in_use)
+   {
+      pClass->stats.max_in_use = pClass->stats.num_in_use;
+   }
+   if (pClass->stats.num_in_use > pClass->win_max_in_use)
+   {
+      pClass->win_max_in_use = pClass->stats.num_in_use;
+   }
+
+   if (++pClass->win_num_gets >= SPF_BUFMGR_SHRINK_WINDOW)
+   {
+      pClass->prev_win_max_in_use = pClass->win_max_in_use;
+      pClass->win_max_in_use      = pClass->stats.num_in_use;
+      pClass->win_num_gets        = 0;
+      spf_bufmgr_class_shrink(pBufMgr, pClass);
+   }
+}
+
 bool_t spf_is_bufmgr_node(void *buf_ptr)
 {
    // this function is called in steady state while returning a buffer
@@ -61,6 +137,16 @@ bool_t spf_is_bufmgr_node(void *buf_ptr)
       {
          return TRUE;
       }
+
+      /* Buffers grown from heap are tagged with their size class and return to its queue */
+      uint32_t class_tag = (uint32_t)((uint64_t)pMetadata->word3);
+      uint32_t class_idx = class_tag & SPF_BUFMGR_CLASS_TAG_IDX_MASK;
+      if ((SPF_BUFMGR_CLASS_TAG == (class_tag & SPF_BUFMGR_CLASS_TAG_MASK)) &&
+          (class_tag & SPF_BUFMGR_CLASS_TAG_GROWN) && (class_idx < SPF_BUFMGR_NUM_SIZE_CLASSES) &&
+          (return_q_ptr == bufmgr_ptr->aSizeClass[class_idx].pQ))
+      {
+         return TRUE;
+      }
       return FALSE;
    }
 }
@@ -101,14 +187,23 @@ ar_result_t spf_bufmgr_return_buf(void *pBuf)
       /* set thread ID to zero */
       pMetadata->word2 = 0;
 
-      /* form bufmgr node and push it back to its home queue. */
+      /* form bufmgr node and push it back to its home queue. Grown buffers go to the front, so that gets (which pop
+       * from the back) prefer the preallocated buffers and spf_bufmgr_class_shrink finds the grown ones first. */
       posal_bufmgr_node_t bufNode;
+      ar_result_t         result;
       bufNode.return_q_ptr = (posal_queue_t *)(pMetadata->word0);
       bufNode.buf_ptr      = pBuf;
 #ifdef DEBUG_POSAL_BUFMGR
       AR_MSG(DBG_HIGH_PRIO, "BufMgr ReturnBuffer: Buff=0x%x", pBuf);
 #endif
-      ar_result_t result = posal_queue_push_back(bufNode.return_q_ptr, (posal_queue_element_t *)&bufNode);
+      if ((uint64_t)pMetadata->word3 & SPF_BUFMGR_CLASS_TAG_GROWN)
+      {
+         result = posal_queue_insert_front(bufNode.return_q_ptr, (posal_queue_element_t *)&bufNode);
+      }
+      else
+      {
+         result = posal_queue_push_back(bufNode.return_q_ptr, (posal_queue_element_t *)&bufNode);
+      }
       if (AR_DID_FAIL(result))
       {
          AR_MSG(DBG_ERROR_PRIO,
@@ -125,65 +220,121 @@ ar_result_t spf_bufmgr_poll_for_buffer(uint32_t             nDesiredSize,
                                        uint32_t *           pnActualSize,
                                        POSAL_HEAP_ID        heap_id)
 {
-   posal_bufmgr_t *pBufMgr = spf_bufmgr_ptr;
-   uint32_t        unChannelMask;
-   uint32_t        unChannelStatus;
-   ar_result_t     result;
-    spf_bufmgr_metadata_t  *metadata_ptr = NULL;
-
-   /* mask off all the bufs that are too small */
-   unChannelMask = pBufMgr->unAnyBufsMask & ((1 << s32_cl0_s32(nDesiredSize - 1)) - 1);
+   posal_bufmgr_t *       pBufMgr = spf_bufmgr_ptr;
+   uint32_t               unChannelStatus;
+   ar_result_t            result;
+   spf_bufmgr_metadata_t *metadata_ptr = NULL;
 
    /* enter critical section */
    posal_mutex_lock(pBufMgr->mutex);
 
-   /* Take node off back of stack. Use back instead of front in attempt to
-    * keep using the same buffers. Better for cache performance. */
-   if (!(unChannelStatus = posal_channel_poll(pBufMgr->channel_ptr, unChannelMask)) ||
-       AR_DID_FAIL(result = posal_queue_pop_back(pBufMgr->aBufferBin[s32_cl0_s32(unChannelStatus)].pQ,
-                                                 (posal_queue_element_t *)pNode)))
+   if (nDesiredSize <= SPF_BUFMGR_MAX_CLASS_SIZE)
    {
-      AR_MSG(DBG_HIGH_PRIO, "Buffer Manager failed to find a free buffer. Trying to allocate from heap");
-      posal_mutex_unlock(pBufMgr->mutex);
+      uint32_t          class_idx = spf_bufmgr_get_class_idx(nDesiredSize);
+      posal_bufclass_t *pClass    = &pBufMgr->aSizeClass[class_idx];
 
-      uint8_t *buf = (uint8_t *)posal_memory_malloc(nDesiredSize + POSAL_BUFMGR_METADATA_SIZE, heap_id);
-      if (NULL == buf)
+      /* Prefer the class which fits best, then grow it and only if it can't grow (or growing fails) borrow from a
+       * bigger class.
+       * Take node off back of stack. Use back instead of front in attempt to keep using the same buffers. Better
+       * for cache performance. */
+      if (!(unChannelStatus = posal_channel_poll(pBufMgr->channel_ptr, MSB_32 >> class_idx)))
       {
-         AR_MSG(DBG_ERROR_PRIO, "Buffer Manager failed to allocate even from heap!");
-         return AR_ENEEDMORE;
+         if ((pClass->stats.num_bufs < SPF_BUFMGR_MAX_BUFS_PER_CLASS) &&
+             (pBufMgr->grown_bytes + pClass->stats.buf_size <= SPF_BUFMGR_MAX_GROWN_BYTES))
+         {
+            /* Reserve the buffer in the class and allocate outside the critical section */
+            pClass->stats.num_bufs++;
+            pClass->stats.num_grown++;
+            pBufMgr->grown_bytes += pClass->stats.buf_size;
+            spf_bufmgr_class_account_get(pBufMgr, pClass);
+            posal_mutex_unlock(pBufMgr->mutex);
+
+            uint8_t *buf =
+               (uint8_t *)posal_memory_malloc(pClass->stats.buf_size + POSAL_BUFMGR_METADATA_SIZE, pBufMgr->heap_id);
+            if (NULL != buf)
+            {
+               metadata_ptr        = (spf_bufmgr_metadata_t *)buf;
+               metadata_ptr->word0 = (void *)(pClass->pQ);
+               metadata_ptr->word1 = (void *)((uint64_t)(pClass->pQ) ^ CORRUPTION_DETECT_MAGIC);
+               metadata_ptr->word2 = (void *)((uint64_t)posal_thread_get_curr_tid());
+               metadata_ptr->word3 = (void *)((uint64_t)(SPF_BUFMGR_CLASS_TAG | SPF_BUFMGR_CLASS_TAG_GROWN | class_idx));
+
+               pNode->return_q_ptr = pClass->pQ;
+               pNode->buf_ptr      = &buf[0] + sizeof(spf_bufmgr_metadata_t);
+
+#ifdef DEBUG_POSAL_BUFMGR
+               AR_MSG(DBG_HIGH_PRIO, "BufMgr GrowBuffer: Buff=0x%x", pNode->buf_ptr);
+#endif
+               *pnActualSize = pClass->stats.buf_size;
+               return AR_EOK;
+            }
+
+            posal_mutex_lock(pBufMgr->mutex);
+            pClass->stats.num_bufs--;
+            pClass->stats.num_grown--;
+            pClass->stats.num_in_use--;
+            pBufMgr->grown_bytes -= pClass->stats.buf_size;
+         }
+
+         /* borrow from a bigger class, mask off all the classes that are too small */
+         unChannelStatus =
+            posal_channel_poll(pBufMgr->channel_ptr, pBufMgr->unAnyBufsMask & ((MSB_32 >> class_idx) - 1));
       }
 
-      /* ReturnQ is set to addr of g_heap_alloc_indicator to indicate that this buffer came from heap */
-      metadata_ptr = (spf_bufmgr_metadata_t *)buf;
-      metadata_ptr->word0 = (void *)&g_heap_alloc_indicator;
-      metadata_ptr->word1 = (void *) ((uint64_t)(metadata_ptr->word0) ^ CORRUPTION_DETECT_MAGIC);
+      if (unChannelStatus && AR_SUCCEEDED(result = posal_queue_pop_back(pBufMgr->aSizeClass[s32_cl0_s32(unChannelStatus)].pQ,
+                                                                         (posal_queue_element_t *)pNode)))
+      {
+         posal_bufclass_t *pSrcClass = &pBufMgr->aSizeClass[s32_cl0_s32(unChannelStatus)];
+         spf_bufmgr_class_account_get(pBufMgr, pSrcClass);
+         if (pSrcClass != pClass)
+         {
+            pSrcClass->stats.num_borrowed++;
+         }
 
-      /* thread ID is not useful for heap allocations but retaining for consistency sake; */
-      metadata_ptr->word2 = (void *)((uint64_t)posal_thread_get_curr_tid());
-      metadata_ptr->word3 = 0;
+         *pnActualSize = pSrcClass->stats.buf_size;
 
-      pNode->return_q_ptr = (posal_queue_t *)(metadata_ptr->word0);
-      pNode->buf_ptr      = &buf[0]+sizeof(spf_bufmgr_metadata_t);
+         /* set the thread ID of the calling function */
+         metadata_ptr = (spf_bufmgr_metadata_t *)((uint8_t *)(pNode->buf_ptr) - sizeof(spf_bufmgr_metadata_t));
+         metadata_ptr->word2 = (void *)((uint64_t)posal_thread_get_curr_tid());
 
 #ifdef DEBUG_POSAL_BUFMGR
-      AR_MSG(DBG_HIGH_PRIO, "BufMgr HEAP GetBuffer: Buff=0x%x", pNode->buf_ptr);
+         AR_MSG(DBG_HIGH_PRIO, "BufMgr GetBuffer: Buff=0x%x", pNode->buf_ptr);
 #endif
 
-      *pnActualSize = nDesiredSize;
-      return AR_EOK;
+         /* leave critical section */
+         posal_mutex_unlock(pBufMgr->mutex);
+         return AR_EOK;
+      }
+   }
+
+   pBufMgr->num_heap_allocs++;
+   posal_mutex_unlock(pBufMgr->mutex);
+
+   AR_MSG(DBG_HIGH_PRIO, "Buffer Manager failed to find a free buffer. Trying to allocate from heap");
+
+   uint8_t *buf = (uint8_t *)posal_memory_malloc(nDesiredSize + POSAL_BUFMGR_METADATA_SIZE, heap_id);
+   if (NULL == buf)
+   {
+      AR_MSG(DBG_ERROR_PRIO, "Buffer Manager failed to allocate even from heap!");
+      return AR_ENEEDMORE;
    }
 
-   *pnActualSize = 1 << s32_cl0_s32(unChannelStatus);
+   /* ReturnQ is set to addr of g_heap_alloc_indicator to indicate that this buffer came from heap */
+   metadata_ptr = (spf_bufmgr_metadata_t *)buf;
+   metadata_ptr->word0 = (void *)&g_heap_alloc_indicator;
+   metadata_ptr->word1 = (void *) ((uint64_t)(metadata_ptr->word0) ^ CORRUPTION_DETECT_MAGIC);
 
-   /* set the thread ID of the calling function */
-   metadata_ptr = (spf_bufmgr_metadata_t *)((uint8_t *)(pNode->buf_ptr) - sizeof(spf_bufmgr_metadata_t));
+   /* thread ID is not useful for heap allocations but retaining for consistency sake; */
    metadata_ptr->word2 = (void *)((uint64_t)posal_thread_get_curr_tid());
+   metadata_ptr->word3 = 0;
+
+   pNode->return_q_ptr = (posal_queue_t *)(metadata_ptr->word0);
+   pNode->buf_ptr      = &buf[0]+sizeof(spf_bufmgr_metadata_t);
 
 #ifdef DEBUG_POSAL_BUFMGR
-   AR_MSG(DBG_HIGH_PRIO, "BufMgr GetBuffer: Buff=0x%x", pNode->buf_ptr);
+   AR_MSG(DBG_HIGH_PRIO, "BufMgr HEAP GetBuffer: Buff=0x%x", pNode->buf_ptr);
 #endif
 
-   /* leave critical section */
-   posal_mutex_unlock(pBufMgr->mutex);
+   *pnActualSize = nDesiredSize;
    return AR_EOK;
 }
@@ -171,6 +171,14 @@ static ar_result_t hashtable_grow(spf_hashtable_t *ht_ptr)
 ----------------------------------------------------------------------------------------------------------------------*/
 ar_result_t spf_hashtable_remove_all(spf_hashtable_t *ht_ptr)
 {
+   // table is not allocated (before init or after deinit)
+   if (NULL == ht_ptr->table_ptr)
+   {
+      ht_ptr->num_items = 0;
+      ht_ptr->num_nodes = 0;
+      return AR_EOK;
+   }
+
    for (uint32_t i = 0; i < ht_ptr->table_size; i++)
    {
       spf_hash_node_t *node = ht_ptr->table_ptr[i];
@@ -348,4 +356,8 @@ void spf_hashtable_deinit(spf_hashtable_t *ht_ptr)
       posal_memory_free(ht_ptr->table_ptr);
       ht_ptr->table_ptr = NULL;
    }
+
+   // deinit may be called again (e.g. a graph destroyed twice), the table must not look allocated
+   ht_ptr->table_size = 0;
+   ht_ptr->mask_size  = 0;
 }
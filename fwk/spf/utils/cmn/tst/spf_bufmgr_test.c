@@ -0,0 +1,405 @@
+/***
+ * \file spf_bufmgr_test.c
+ * \brief
+ *    This file tests the size classes of the spf buffer manager: growth, borrowing from a bigger class, shrinking and
+ *    the accounting of buffers returned with and without spf_bufmgr_return_buf.
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "spf_bufmgr_test.h"
+#include "posal_globalstate.h"
+
+#define BUFMGR_TEST_SIZE (100)
+#define BUFMGR_TEST_CLASS_SIZE (112)
+#define BUFMGR_TEST_BIG_CLASS_SIZE (256)
+#define BUFMGR_TEST_NUM_BUFS (16)
+#define BUFMGR_TEST_NUM_THREADS (4)
+#define BUFMGR_TEST_NUM_ITERS (20000)
+
+extern posal_bufmgr_t *spf_bufmgr_ptr;
+
+typedef struct bufmgr_test_thread_ctx_t
+{
+   posal_thread_t      thread;
+   posal_atomic_word_t start_ptr;
+   uint32_t            seed;
+   ar_result_t         result;
+} bufmgr_test_thread_ctx_t;
+
+/********************************************************************************/
+static uint32_t bufmgr_test_get_class_idx(uint32_t buf_size)
+{
+   spf_bufmgr_stats_t stats;
+
+   spf_bufmgr_get_stats(&stats);
+   for (uint32_t i = 0; i < SPF_BUFMGR_NUM_SIZE_CLASSES; i++)
+   {
+      if (stats.class_stats[i].buf_size == buf_size)
+      {
+         return i;
+      }
+   }
+   return 0;
+}
+
+/* Creates a buffer manager with nBufs preallocated in the class of buf_size and makes it the global one. */
+static ar_result_t bufmgr_test_create(uint32_t buf_size, uint32_t nBufs, posal_bufmgr_t **saved_pptr)
+{
+   uint32_t        bufs_per_class[SPF_BUFMGR_NUM_SIZE_CLASSES] = { 0 };
+   posal_bufmgr_t *bufmgr_ptr                                   = NULL;
+   ar_result_t     result;
+
+   *saved_pptr = spf_bufmgr_ptr;
+   if (AR_DID_FAIL(result = spf_bufmgr_create(bufs_per_class, &bufmgr_ptr, POSAL_HEAP_DEFAULT)))
+   {
+      return result;
+   }
+   spf_bufmgr_ptr = bufmgr_ptr;
+
+   if (nBufs)
+   {
+      bufs_per_class[bufmgr_test_get_class_idx(buf_size)] = nBufs;
+      spf_bufmgr_destroy(bufmgr_ptr);
+      if (AR_DID_FAIL(result = spf_bufmgr_create(bufs_per_class, &bufmgr_ptr, POSAL_HEAP_DEFAULT)))
+      {
+         spf_bufmgr_ptr = *saved_pptr;
+         return result;
+      }
+      spf_bufmgr_ptr = bufmgr_ptr;
+   }
+   return AR_EOK;
+}
+
+static void bufmgr_test_destroy(posal_bufmgr_t *saved_ptr)
+{
+   spf_bufmgr_destroy(spf_bufmgr_ptr);
+   spf_bufmgr_ptr = saved_ptr;
+}
+
+/********************************************************************************/
+/* An empty class grows instead of falling back to heap, returned buffers are reused. A buffer pushed straight to its
+   return queue (as spf_msg_return_msg does in island mode) is accounted like one returned with
+   spf_bufmgr_return_buf. */
+static ar_result_t bufmgr_test_grow()
+{
+   posal_bufmgr_t *    saved_ptr;
+   posal_bufmgr_node_t nodes[BUFMGR_TEST_NUM_BUFS];
+   spf_bufmgr_stats_t  stats;
+   uint32_t            actual_size = 0;
+   ar_result_t         result      = AR_EOK;
+
+   if (AR_DID_FAIL(bufmgr_test_create(0, 0, &saved_ptr)))
+   {
+      return AR_EFAILED;
+   }
+   uint32_t class_idx = bufmgr_test_get_class_idx(BUFMGR_TEST_CLASS_SIZE);
+
+   for (uint32_t round = 0; round < 2; round++)
+   {
+      for (uint32_t i = 0; i < BUFMGR_TEST_NUM_BUFS; i++)
+      {
+         spf_bufmgr_poll_for_buffer(BUFMGR_TEST_SIZE, &nodes[i], &actual_size, POSAL_HEAP_DEFAULT);
+         if ((BUFMGR_TEST_CLASS_SIZE != actual_size) || !spf_is_bufmgr_node(nodes[i].buf_ptr))
+         {
+            AR_MSG(DBG_ERROR_PRIO, "bufmgr test: got a buffer of %lu bytes, not from the class", actual_size);
+            result = AR_EFAILED;
+         }
+      }
+
+      spf_bufmgr_get_stats(&stats);
+      spf_bufmgr_class_stats_t *cls_ptr = &stats.class_stats[class_idx];
+      if ((BUFMGR_TEST_NUM_BUFS != cls_ptr->num_grown) || (BUFMGR_TEST_NUM_BUFS != cls_ptr->num_bufs) ||
+          (BUFMGR_TEST_NUM_BUFS != cls_ptr->num_in_use) || (0 != stats.num_heap_allocs) ||
+          (BUFMGR_TEST_NUM_BUFS * BUFMGR_TEST_CLASS_SIZE != stats.grown_bytes))
+      {
+         AR_MSG(DBG_ERROR_PRIO,
+                "bufmgr test: round %lu grown %lu bufs %lu in use %lu heap allocs %lu",
+                round,
+                cls_ptr->num_grown,
+                cls_ptr->num_bufs,
+                cls_ptr->num_in_use,
+                stats.num_heap_allocs);
+         result = AR_EFAILED;
+      }
+
+      /* return half of the buffers like in island mode */
+      for (uint32_t i = 0; i < BUFMGR_TEST_NUM_BUFS; i++)
+      {
+         if (i & 1)
+         {
+            posal_queue_push_back(nodes[i].return_q_ptr, (posal_queue_element_t *)&nodes[i]);
+         }
+         else
+         {
+            spf_bufmgr_return_buf(nodes[i].buf_ptr);
+         }
+      }
+
+      spf_bufmgr_get_stats(&stats);
+      if (0 != stats.class_stats[class_idx].num_in_use)
+      {
+         AR_MSG(DBG_ERROR_PRIO, "bufmgr test: %lu buffers in use after return", stats.class_stats[class_idx].num_in_use);
+         result = AR_EFAILED;
+      }
+   }
+
+   bufmgr_test_destroy(saved_ptr);
+   return result;
+}
+
+/********************************************************************************/
+/* A class which can't grow, because growing fails or because the class is full, borrows from a bigger class before
+   falling back to heap. */
+static ar_result_t bufmgr_test_borrow()
+{
+   posal_bufmgr_t *    saved_ptr;
+   posal_bufmgr_node_t nodes[SPF_BUFMGR_MAX_BUFS_PER_CLASS + 1];
+   posal_bufmgr_node_t node;
+   spf_bufmgr_stats_t  stats;
+   uint32_t            actual_size = 0;
+   ar_result_t         result      = AR_EOK;
+
+   if (AR_DID_FAIL(bufmgr_test_create(BUFMGR_TEST_BIG_CLASS_SIZE, 1, &saved_ptr)))
+   {
+      return AR_EFAILED;
+   }
+   uint32_t class_idx     = bufmgr_test_get_class_idx(BUFMGR_TEST_CLASS_SIZE);
+   uint32_t big_class_idx = bufmgr_test_get_class_idx(BUFMGR_TEST_BIG_CLASS_SIZE);
+
+   /* growth fails */
+   posal_globalstate.nSimulatedMallocFailCount = 1;
+   spf_bufmgr_poll_for_buffer(BUFMGR_TEST_SIZE, &node, &actual_size, POSAL_HEAP_DEFAULT);
+   posal_globalstate.nSimulatedMallocFailCount = -1;
+
+   spf_bufmgr_get_stats(&stats);
+   if ((BUFMGR_TEST_BIG_CLASS_SIZE != actual_size) || (1 != stats.class_stats[big_class_idx].num_borrowed) ||
+       (0 != stats.class_stats[class_idx].num_bufs) || (0 != stats.grown_bytes) || (0 != stats.num_heap_allocs))
+   {
+      AR_MSG(DBG_ERROR_PRIO,
+             "bufmgr test: failed growth gave %lu bytes, borrowed %lu heap allocs %lu",
+             actual_size,
+             stats.class_stats[big_class_idx].num_borrowed,
+             stats.num_heap_allocs);
+      result = AR_EFAILED;
+   }
+   spf_bufmgr_return_buf(node.buf_ptr);
+
+   /* the class is full */
+   for (uint32_t i = 0; i < SPF_BUFMGR_MAX_BUFS_PER_CLASS + 1; i++)
+   {
+      spf_bufmgr_poll_for_buffer(BUFMGR_TEST_SIZE, &nodes[i], &actual_size, POSAL_HEAP_DEFAULT);
+   }
+   spf_bufmgr_get_stats(&stats);
+   if ((BUFMGR_TEST_BIG_CLASS_SIZE != actual_size) || (2 != stats.class_stats[big_class_idx].num_borrowed) ||
+       (SPF_BUFMGR_MAX_BUFS_PER_CLASS != stats.class_stats[class_idx].num_bufs) || (0 != stats.num_heap_allocs))
+   {
+      AR_MSG(DBG_ERROR_PRIO,
+             "bufmgr test: full class gave %lu bytes, borrowed %lu heap allocs %lu",
+             actual_size,
+             stats.class_stats[big_class_idx].num_borrowed,
+             stats.num_heap_allocs);
+      result = AR_EFAILED;
+   }
+
+   /* nothing left to borrow */
+   spf_bufmgr_poll_for_buffer(BUFMGR_TEST_SIZE, &node, &actual_size, POSAL_HEAP_DEFAULT);
+   spf_bufmgr_get_stats(&stats);
+   if (1 != stats.num_heap_allocs)
+   {
+      AR_MSG(DBG_ERROR_PRIO, "bufmgr test: %lu heap allocs, expected 1", stats.num_heap_allocs);
+      result = AR_EFAILED;
+   }
+   spf_bufmgr_return_buf(node.buf_ptr);
+
+   for (uint32_t i = 0; i < SPF_BUFMGR_MAX_BUFS_PER_CLASS + 1; i++)
+   {
+      spf_bufmgr_return_buf(nodes[i].buf_ptr);
+   }
+
+   bufmgr_test_destroy(saved_ptr);
+   return result;
+}
+
+/********************************************************************************/
+/* After a burst the grown buffers are freed again once a lower use lasted for two windows, preallocated buffers are
+   kept. */
+static ar_result_t bufmgr_test_shrink()
+{
+   posal_bufmgr_t *    saved_ptr;
+   posal_bufmgr_node_t nodes[BUFMGR_TEST_NUM_BUFS];
+   spf_bufmgr_stats_t  stats;
+   uint32_t            actual_size = 0;
+   ar_result_t         result      = AR_EOK;
+
+   if (AR_DID_FAIL(bufmgr_test_create(BUFMGR_TEST_CLASS_SIZE, 2, &saved_ptr)))
+   {
+      return AR_EFAILED;
+   }
+   uint32_t class_idx = bufmgr_test_get_class_idx(BUFMGR_TEST_CLASS_SIZE);
+
+   for (uint32_t i = 0; i < BUFMGR_TEST_NUM_BUFS; i++)
+   {
+      spf_bufmgr_poll_for_buffer(BUFMGR_TEST_SIZE, &nodes[i], &actual_size, POSAL_HEAP_DEFAULT);
+   }
+   for (uint32_t i = 0; i < BUFMGR_TEST_NUM_BUFS; i++)
+   {
+      spf_bufmgr_return_buf(nodes[i].buf_ptr);
+   }
+
+   /* steady state with a single buffer in use */
+   for (uint32_t i = 0; i < 3 * SPF_BUFMGR_SHRINK_WINDOW; i++)
+   {
+      spf_bufmgr_poll_for_buffer(BUFMGR_TEST_SIZE, &nodes[0], &actual_size, POSAL_HEAP_DEFAULT);
+      spf_bufmgr_return_buf(nodes[0].buf_ptr);
+   }
+
+   spf_bufmgr_get_stats(&stats);
+   spf_bufmgr_class_stats_t *cls_ptr = &stats.class_stats[class_idx];
+   if ((2 != cls_ptr->num_bufs) || (BUFMGR_TEST_NUM_BUFS - 2 != cls_ptr->num_shrunk) || (0 != stats.grown_bytes) ||
+       (BUFMGR_TEST_NUM_BUFS != cls_ptr->max_in_use) || (0 != cls_ptr->num_in_use))
+   {
+      AR_MSG(DBG_ERROR_PRIO,
+             "bufmgr test: after shrinking %lu bufs, %lu shrunk, %lu grown bytes",
+             cls_ptr->num_bufs,
+             cls_ptr->num_shrunk,
+             stats.grown_bytes);
+      result = AR_EFAILED;
+   }
+
+   bufmgr_test_destroy(saved_ptr);
+   return result;
+}
+
+/********************************************************************************/
+static ar_result_t bufmgr_test_thread_entry(void *arg_ptr)
+{
+   bufmgr_test_thread_ctx_t *ctx_ptr = (bufmgr_test_thread_ctx_t *)arg_ptr;
+   posal_bufmgr_node_t       nodes[4];
+   uint32_t                  actual_size = 0;
+   ar_result_t               result      = AR_EOK;
+
+   /* all threads start together once launched */
+   while (0 == posal_atomic_get(ctx_ptr->start_ptr))
+   {
+      posal_timer_sleep(100);
+   }
+
+   for (uint32_t iter = 0; iter < BUFMGR_TEST_NUM_ITERS; iter++)
+   {
+      ctx_ptr->seed    = ctx_ptr->seed * 1103515245 + 12345;
+      uint32_t num     = 1 + ((ctx_ptr->seed >> 16) & 3);
+      uint32_t size    = 16 + ((ctx_ptr->seed >> 8) % 600);
+      uint8_t  pattern = (uint8_t)iter;
+
+      for (uint32_t i = 0; i < num; i++)
+      {
+         spf_bufmgr_poll_for_buffer(size, &nodes[i], &actual_size, POSAL_HEAP_DEFAULT);
+         memset(nodes[i].buf_ptr, pattern, size);
+      }
+      for (uint32_t i = 0; i < num; i++)
+      {
+         if ((((uint8_t *)nodes[i].buf_ptr)[0] != pattern) || (((uint8_t *)nodes[i].buf_ptr)[size - 1] != pattern))
+         {
+            result = AR_EFAILED;
+         }
+         spf_bufmgr_return_buf(nodes[i].buf_ptr);
+      }
+   }
+   ctx_ptr->result = result;
+   return result;
+}
+
+/* Threads get and return buffers concurrently, afterwards no buffer is in use and the grown bytes match the
+   buffers owned by the classes. */
+static ar_result_t bufmgr_test_threads()
+{
+   posal_bufmgr_t *         saved_ptr;
+   bufmgr_test_thread_ctx_t ctx[BUFMGR_TEST_NUM_THREADS];
+   spf_bufmgr_stats_t       stats;
+   ar_result_t              result = AR_EOK;
+   uint32_t                 grown  = 0;
+   posal_atomic_word_t      start_ptr;
+
+   if (AR_DID_FAIL(posal_atomic_word_create(&start_ptr, POSAL_HEAP_DEFAULT)))
+   {
+      return AR_EFAILED;
+   }
+   posal_atomic_set(start_ptr, 0);
+   if (AR_DID_FAIL(bufmgr_test_create(0, 0, &saved_ptr)))
+   {
+      posal_atomic_word_destroy(start_ptr);
+      return AR_EFAILED;
+   }
+
+   for (uint32_t t = 0; t < BUFMGR_TEST_NUM_THREADS; t++)
+   {
+      ctx[t].start_ptr = start_ptr;
+      ctx[t].seed      = 0x1234 + t;
+      ctx[t].result    = AR_EFAILED;
+      if (AR_DID_FAIL(posal_thread_launch(&ctx[t].thread,
+                                          "BUFMGR_TEST",
+                                          16 * 1024,
+                                          50,
+                                          bufmgr_test_thread_entry,
+                                          &ctx[t],
+                                          POSAL_HEAP_DEFAULT)))
+      {
+         ctx[t].thread = NULL;
+      }
+   }
+   posal_atomic_set(start_ptr, 1);
+   for (uint32_t t = 0; t < BUFMGR_TEST_NUM_THREADS; t++)
+   {
+      ar_result_t thread_result = AR_EFAILED;
+      if (ctx[t].thread)
+      {
+         posal_thread_join(ctx[t].thread, &thread_result);
+      }
+      result |= thread_result | ctx[t].result;
+   }
+
+   spf_bufmgr_get_stats(&stats);
+   for (uint32_t i = 0; i < SPF_BUFMGR_NUM_SIZE_CLASSES; i++)
+   {
+      spf_bufmgr_class_stats_t *cls_ptr = &stats.class_stats[i];
+      if ((0 != cls_ptr->num_in_use) || (cls_ptr->num_bufs != cls_ptr->num_grown - cls_ptr->num_shrunk))
+      {
+         AR_MSG(DBG_ERROR_PRIO,
+                "bufmgr test: class %lu has %lu bufs in use, %lu bufs, %lu grown, %lu shrunk",
+                i,
+                cls_ptr->num_in_use,
+                cls_ptr->num_bufs,
+                cls_ptr->num_grown,
+                cls_ptr->num_shrunk);
+         result = AR_EFAILED;
+      }
+      grown += cls_ptr->num_bufs * cls_ptr->buf_size;
+   }
+   if (grown != stats.grown_bytes)
+   {
+      AR_MSG(DBG_ERROR_PRIO, "bufmgr test: %lu grown bytes, classes own %lu", stats.grown_bytes, grown);
+      result = AR_EFAILED;
+   }
+
+   bufmgr_test_destroy(saved_ptr);
+   posal_atomic_word_destroy(start_ptr);
+   return result;
+}
+
+/********************************************************************************/
+ar_result_t spf_bufmgr_test()
+{
+   ar_result_t result = AR_EOK;
+
+   result |= bufmgr_test_grow();
+   result |= bufmgr_test_borrow();
+   result |= bufmgr_test_shrink();
+   result |= bufmgr_test_threads();
+
+   AR_MSG(DBG_HIGH_PRIO, "spf_bufmgr tests %s", AR_SUCCEEDED(result) ? "passed" : "FAILED");
+
+   return result;
+}
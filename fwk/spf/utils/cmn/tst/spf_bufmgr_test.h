@@ -0,0 +1,19 @@
+#ifndef __SPF_BUFMGR_TEST_H__
+#define __SPF_BUFMGR_TEST_H__
+/***
+ * \file spf_bufmgr_test.h
+ * \brief
+ *    Header file for the spf buffer manager tests.
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "spf_utils.h"
+
+/* Runs all the spf buffer manager tests, returns AR_EOK if all of them pass. spf_bufmgr_global_init() must be called
+   before, the tests swap in buffer managers of their own. */
+ar_result_t spf_bufmgr_test();
+
+#endif //__SPF_BUFMGR_TEST_H__
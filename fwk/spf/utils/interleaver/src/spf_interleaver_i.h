@@ -0,0 +1,49 @@
+/*========================================================================
+
+file spf_interleaver_i.h
+This file contains internal declarations of the vectorized interleaver and de-interleaver kernels
+
+   Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+   SPDX-License-Identifier: BSD-3-Clause-Clear
+======================================================================*/
+
+#ifndef SPF_INTERLEAVER_I_H
+#define SPF_INTERLEAVER_I_H
+
+#include "spf_interleaver.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* Vector kernels are available for x86-64 (SSE2, SSSE3 detected at runtime for 24 bit) and AArch64 (NEON).
+ * Hexagon keeps its own stereo assembly in spf_interleaver_island.c. */
+#if ((defined __x86_64__) || (defined __aarch64__)) && !((defined __hexagon__) || (defined __qdsp6__))
+#define SPF_INTERLEAVER_SIMD
+#endif
+
+#ifdef SPF_INTERLEAVER_SIMD
+/** Interleaves channels [0, *num_ch_done_ptr) for samples [0, return value) of 16/24/32 bit data.
+ *  The caller converts the remaining channels and samples with the scalar loops. */
+uint32_t spf_deintlv_to_intlv_simd(capi_buf_t *input_buf_ptr,
+                                   int8_t     *dst_ptr,
+                                   uint32_t    num_channels,
+                                   uint32_t    bytes_per_samp,
+                                   uint32_t    num_samp_per_ch,
+                                   uint32_t   *num_ch_done_ptr);
+
+/** De-interleaves dst channels [0, *num_ch_done_ptr) for samples [0, return value) of 16/24/32 bit data.
+ *  The caller converts the remaining channels and samples with the scalar loops. */
+uint32_t spf_intlv_to_deintlv_simd(int8_t     *src_ptr,
+                                   capi_buf_t *output_buf_ptr,
+                                   uint32_t    num_src_channels,
+                                   uint32_t    num_dst_channels,
+                                   uint32_t    bytes_per_samp,
+                                   uint32_t    num_samp_per_ch,
+                                   uint32_t   *num_ch_done_ptr);
+#endif // SPF_INTERLEAVER_SIMD
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+#endif // SPF_INTERLEAVER_I_H
@@ -11,7 +11,7 @@ SPDX-License-Identifier: BSD-3-Clause-Clear
 INCLUDE FILES FOR MODULE
 ========================================================================== */
 
-#include "spf_interleaver.h"
+#include "spf_interleaver_i.h"
 
 /* -----------------------------------------------------------------------
  ** Temp util function
@@ -46,6 +46,8 @@ ar_result_t spf_deintlv_to_intlv_v2(capi_buf_t *input_buf_ptr,
                                     uint32_t    num_samp_per_ch)
 {
    int i, j, k;
+   // channels [0, num_vec_ch) are already converted for samples [0, num_vec_samp) by the vector kernels
+   uint32_t num_vec_ch = 0, num_vec_samp = 0;
 
    if (1 == num_channels)
    {
@@ -56,6 +58,14 @@ ar_result_t spf_deintlv_to_intlv_v2(capi_buf_t *input_buf_ptr,
    }
    else
    {
+#ifdef SPF_INTERLEAVER_SIMD
+      num_vec_samp = spf_deintlv_to_intlv_simd(input_buf_ptr,
+                                               (int8_t *)output_buf_ptr->data_ptr,
+                                               num_channels,
+                                               bytes_per_samp,
+                                               num_samp_per_ch,
+                                               &num_vec_ch);
+#endif
       if (2 == bytes_per_samp)
       {
          int16_t *src_ptr = (int16_t *)input_buf_ptr[0].data_ptr;
@@ -81,8 +91,9 @@ ar_result_t spf_deintlv_to_intlv_v2(capi_buf_t *input_buf_ptr,
             for (j = 0; j < num_channels; j++)
             {
                src_ptr = (int16_t *)input_buf_ptr[j].data_ptr;
-               k       = j;
-               for (i = 0; i < num_samp_per_ch; i++)
+               i       = (j < num_vec_ch) ? num_vec_samp : 0;
+               k       = j + i * num_channels;
+               for (; i < num_samp_per_ch; i++)
                {
                   dst_ptr[k] = src_ptr[i];
                   k += num_channels;
@@ -100,8 +111,9 @@ ar_result_t spf_deintlv_to_intlv_v2(capi_buf_t *input_buf_ptr,
          for (j = 0; j < num_channels; j++)
          {
             src_ptr = (int8_t *)input_buf_ptr[j].data_ptr;
-            temp    = 0;
-            for (i = 0; i < num_samp_per_ch; i++)
+            i       = (j < num_vec_ch) ? num_vec_samp : 0;
+            temp    = i * bytes_per_samp;
+            for (; i < num_samp_per_ch; i++)
             {
                k = bytes_per_samp * (i * num_channels + j);
                byte_1 = src_ptr[temp + 0]; // load first byte in the sample
@@ -123,8 +135,9 @@ ar_result_t spf_deintlv_to_intlv_v2(capi_buf_t *input_buf_ptr,
          for (j = 0; j < num_channels; j++)
          {
             src_ptr = (int32_t *)input_buf_ptr[j].data_ptr;
-            k       = j;
-            for (i = 0; i < num_samp_per_ch; i++)
+            i       = (j < num_vec_ch) ? num_vec_samp : 0;
+            k       = j + i * num_channels;
+            for (; i < num_samp_per_ch; i++)
             {
                dst_ptr[k] = src_ptr[i];
                k += num_channels;
@@ -183,6 +196,8 @@ ar_result_t spf_intlv_to_deintlv_util_(capi_buf_t *input_buf_ptr,
    int32_t k = 0;
 
    uint32_t num_bufs_lens_to_update = updates_only_first_ch_length ? 1 : num_dst_channels;
+   // channels [0, num_vec_ch) are already converted for samples [0, num_vec_samp) by the vector kernels
+   uint32_t num_vec_ch = 0, num_vec_samp = 0;
 
    if(num_dst_channels > num_src_channels)
    {
@@ -198,6 +213,15 @@ ar_result_t spf_intlv_to_deintlv_util_(capi_buf_t *input_buf_ptr,
    }
    else
    {
+#ifdef SPF_INTERLEAVER_SIMD
+      num_vec_samp = spf_intlv_to_deintlv_simd((int8_t *)input_buf_ptr->data_ptr,
+                                               output_buf_ptr,
+                                               num_src_channels,
+                                               num_dst_channels,
+                                               bytes_per_samp,
+                                               num_samp_per_ch,
+                                               &num_vec_ch);
+#endif
       if (2 == bytes_per_samp)
       {
          int16_t *src_ptr = (int16_t *)input_buf_ptr->data_ptr;
@@ -225,8 +249,9 @@ ar_result_t spf_intlv_to_deintlv_util_(capi_buf_t *input_buf_ptr,
             for (j = 0; j < num_dst_channels; j++)
             {
                dst_ptr = (int16_t *)output_buf_ptr[j].data_ptr;
-               k       = j;
-               for (i = 0; i < num_samp_per_ch; i++)
+               i       = (j < num_vec_ch) ? num_vec_samp : 0;
+               k       = j + i * num_src_channels;
+               for (; i < num_samp_per_ch; i++)
                {
                   dst_ptr[i] = src_ptr[k];
                   k += num_src_channels;
@@ -244,9 +269,10 @@ ar_result_t spf_intlv_to_deintlv_util_(capi_buf_t *input_buf_ptr,
          for (j = 0; j < num_dst_channels; j++)
          {
             dst_ptr = (int8_t *)output_buf_ptr[j].data_ptr;
-            k       = bytes_per_samp * (j);
+            i       = (j < num_vec_ch) ? num_vec_samp : 0;
+            k       = bytes_per_samp * (j + i * num_src_channels);
             temp    = 0;
-            for (i = 0; i < num_samp_per_ch; i++)
+            for (; i < num_samp_per_ch; i++)
             {
                temp   = i * bytes_per_samp;
                byte_1 = src_ptr[k + 0]; // load first byte in the sample
@@ -268,8 +294,9 @@ ar_result_t spf_intlv_to_deintlv_util_(capi_buf_t *input_buf_ptr,
          for (j = 0; j < num_dst_channels; j++)
          {
             dst_ptr = (int32_t *)output_buf_ptr[j].data_ptr;
-            k       = j;
-            for (i = 0; i < num_samp_per_ch; i++)
+            i       = (j < num_vec_ch) ? num_vec_samp : 0;
+            k       = j + i * num_src_channels;
+            for (; i < num_samp_per_ch; i++)
             {
                dst_ptr[i] = src_ptr[k];
                k += num_src_channels;
@@ -0,0 +1,586 @@
+/*========================================================================
+
+ file spf_interleaver_simd.c
+This file contains vectorized interleaving/deinterleaving kernels for x86-64 and AArch64
+
+A group of g channels (g a power of two) is converted one 128-bit vector per channel at a time. Interleaving
+applies log2(g) rounds of zip (perfect shuffle) on the g channel vectors which yields g vectors of consecutive
+frames, de-interleaving applies the inverse unzip rounds. 24 bit samples are expanded to 32 bit lanes with a
+byte shuffle, converted as 32 bit and packed back.
+
+Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+SPDX-License-Identifier: BSD-3-Clause-Clear
+======================================================================*/
+
+/* =======================================================================
+INCLUDE FILES FOR MODULE
+========================================================================== */
+
+#include "spf_interleaver_i.h"
+
+#ifdef SPF_INTERLEAVER_SIMD
+#include <string.h>
+
+#if defined(__x86_64__)
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#else
+#include <arm_neon.h>
+#endif
+
+/* -----------------------------------------------------------------------
+ ** Constant / Define Declarations
+ ** ----------------------------------------------------------------------- */
+#define SPF_INTLV_VEC_BYTES 16
+#define SPF_INTLV_MAX_GROUP 8
+
+#define SPF_INTLV_INLINE static inline __attribute__((always_inline))
+// group loops have a compile time trip count and must be fully unrolled to keep the vectors in registers
+#define SPF_INTLV_UNROLL _Pragma("GCC unroll 8")
+
+#if defined(__x86_64__)
+typedef __m128i spf_intlv_vec_t;
+// pshufb is SSSE3, which is not part of the x86-64 baseline
+#define SPF_INTLV_TGT_BYTE_SHUFFLE __attribute__((target("ssse3")))
+#else
+typedef uint8x16_t spf_intlv_vec_t;
+#define SPF_INTLV_TGT_BYTE_SHUFFLE
+#endif
+
+// 24 bit samples <-> 32 bit lanes, 0x80 selects zero
+static const uint8_t spf_intlv_expand_24_tbl[SPF_INTLV_VEC_BYTES] = { 0, 1, 2,  0x80, 3,    4,    5,    0x80,
+                                                                      6, 7, 8,  0x80, 9,    10,   11,   0x80 };
+static const uint8_t spf_intlv_pack_24_tbl[SPF_INTLV_VEC_BYTES]   = { 0,  1,  2,  4,    5,    6,    8,    9,
+                                                                      10, 12, 13, 14,   0x80, 0x80, 0x80, 0x80 };
+
+/* -----------------------------------------------------------------------
+ ** Vector primitives
+ ** ----------------------------------------------------------------------- */
+#if defined(__x86_64__)
+SPF_INTLV_INLINE spf_intlv_vec_t spf_intlv_ld16(const int8_t *ptr)
+{
+   return _mm_loadu_si128((const __m128i *)ptr);
+}
+
+SPF_INTLV_INLINE void spf_intlv_st16(int8_t *ptr, spf_intlv_vec_t v)
+{
+   _mm_storeu_si128((__m128i *)ptr, v);
+}
+
+SPF_INTLV_INLINE spf_intlv_vec_t spf_intlv_ld8x2(const int8_t *lo_ptr, const int8_t *hi_ptr)
+{
+   return _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)lo_ptr), _mm_loadl_epi64((const __m128i *)hi_ptr));
+}
+
+SPF_INTLV_INLINE void spf_intlv_st8x2(int8_t *lo_ptr, int8_t *hi_ptr, spf_intlv_vec_t v)
+{
+   _mm_storel_epi64((__m128i *)lo_ptr, v);
+   _mm_storel_epi64((__m128i *)hi_ptr, _mm_unpackhi_epi64(v, v));
+}
+
+SPF_INTLV_INLINE spf_intlv_vec_t spf_intlv_ld12(const int8_t *ptr)
+{
+   int32_t word;
+   memcpy(&word, ptr + 8, sizeof(word));
+   return _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)ptr), _mm_cvtsi32_si128(word));
+}
+
+SPF_INTLV_INLINE void spf_intlv_st12(int8_t *ptr, spf_intlv_vec_t v)
+{
+   int32_t word = _mm_cvtsi128_si32(_mm_srli_si128(v, 8));
+   _mm_storel_epi64((__m128i *)ptr, v);
+   memcpy(ptr + 8, &word, sizeof(word));
+}
+
+SPF_INTLV_INLINE spf_intlv_vec_t spf_intlv_zip_lo(spf_intlv_vec_t a, spf_intlv_vec_t b, uint32_t w)
+{
+   return (2 == w) ? _mm_unpacklo_epi16(a, b) : _mm_unpacklo_epi32(a, b);
+}
+
+SPF_INTLV_INLINE spf_intlv_vec_t spf_intlv_zip_hi(spf_intlv_vec_t a, spf_intlv_vec_t b, uint32_t w)
+{
+   return (2 == w) ? _mm_unpackhi_epi16(a, b) : _mm_unpackhi_epi32(a, b);
+}
+
+SPF_INTLV_INLINE spf_intlv_vec_t spf_intlv_unzip_even(spf_intlv_vec_t a, spf_intlv_vec_t b, uint32_t w)
+{
+   if (2 == w)
+   {
+      // sign extended 16 bit values pack back without saturation
+      return _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(a, 16), 16), _mm_srai_epi32(_mm_slli_epi32(b, 16), 16));
+   }
+   return _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(2, 0, 2, 0)));
+}
+
+SPF_INTLV_INLINE spf_intlv_vec_t spf_intlv_unzip_odd(spf_intlv_vec_t a, spf_intlv_vec_t b, uint32_t w)
+{
+   if (2 == w)
+   {
+      return _mm_packs_epi32(_mm_srai_epi32(a, 16), _mm_srai_epi32(b, 16));
+   }
+   return _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(3, 1, 3, 1)));
+}
+
+SPF_INTLV_INLINE SPF_INTLV_TGT_BYTE_SHUFFLE spf_intlv_vec_t spf_intlv_shuffle_bytes(spf_intlv_vec_t v,
+                                                                                     const uint8_t *tbl_ptr)
+{
+   return _mm_shuffle_epi8(v, _mm_loadu_si128((const __m128i *)tbl_ptr));
+}
+
+static bool_t spf_intlv_has_byte_shuffle(void)
+{
+   return __builtin_cpu_supports("ssse3") ? TRUE : FALSE;
+}
+#else // __aarch64__
+SPF_INTLV_INLINE spf_intlv_vec_t spf_intlv_ld16(const int8_t *ptr)
+{
+   return vld1q_u8((const uint8_t *)ptr);
+}
+
+SPF_INTLV_INLINE void spf_intlv_st16(int8_t *ptr, spf_intlv_vec_t v)
+{
+   vst1q_u8((uint8_t *)ptr, v);
+}
+
+SPF_INTLV_INLINE spf_intlv_vec_t spf_intlv_ld8x2(const int8_t *lo_ptr, const int8_t *hi_ptr)
+{
+   return vcombine_u8(vld1_u8((const uint8_t *)lo_ptr), vld1_u8((const uint8_t *)hi_ptr));
+}
+
+SPF_INTLV_INLINE void spf_intlv_st8x2(int8_t *lo_ptr, int8_t *hi_ptr, spf_intlv_vec_t v)
+{
+   vst1_u8((uint8_t *)lo_ptr, vget_low_u8(v));
+   vst1_u8((uint8_t *)hi_ptr, vget_high_u8(v));
+}
+
+SPF_INTLV_INLINE spf_intlv_vec_t spf_intlv_ld12(const int8_t *ptr)
+{
+   uint32_t word;
+   memcpy(&word, ptr + 8, sizeof(word));
+   return vcombine_u8(vld1_u8((const uint8_t *)ptr), vreinterpret_u8_u32(vdup_n_u32(word)));
+}
+
+SPF_INTLV_INLINE void spf_intlv_st12(int8_t *ptr, spf_intlv_vec_t v)
+{
+   uint32_t word = vgetq_lane_u32(vreinterpretq_u32_u8(v), 2);
+   vst1_u8((uint8_t *)ptr, vget_low_u8(v));
+   memcpy(ptr + 8, &word, sizeof(word));
+}
+
+SPF_INTLV_INLINE spf_intlv_vec_t spf_intlv_zip_lo(spf_intlv_vec_t a, spf_intlv_vec_t b, uint32_t w)
+{
+   return (2 == w) ? vreinterpretq_u8_u16(vzip1q_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b)))
+                   : vreinterpretq_u8_u32(vzip1q_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b)));
+}
+
+SPF_INTLV_INLINE spf_intlv_vec_t spf_intlv_zip_hi(spf_intlv_vec_t a, spf_intlv_vec_t b, uint32_t w)
+{
+   return (2 == w) ? vreinterpretq_u8_u16(vzip2q_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b)))
+                   : vreinterpretq_u8_u32(vzip2q_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b)));
+}
+
+SPF_INTLV_INLINE spf_intlv_vec_t spf_intlv_unzip_even(spf_intlv_vec_t a, spf_intlv_vec_t b, uint32_t w)
+{
+   return (2 == w) ? vreinterpretq_u8_u16(vuzp1q_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b)))
+                   : vreinterpretq_u8_u32(vuzp1q_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b)));
+}
+
+SPF_INTLV_INLINE spf_intlv_vec_t spf_intlv_unzip_odd(spf_intlv_vec_t a, spf_intlv_vec_t b, uint32_t w)
+{
+   return (2 == w) ? vreinterpretq_u8_u16(vuzp2q_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b)))
+                   : vreinterpretq_u8_u32(vuzp2q_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b)));
+}
+
+SPF_INTLV_INLINE spf_intlv_vec_t spf_intlv_shuffle_bytes(spf_intlv_vec_t v, const uint8_t *tbl_ptr)
+{
+   return vqtbl1q_u8(v, vld1q_u8(tbl_ptr));
+}
+
+static bool_t spf_intlv_has_byte_shuffle(void)
+{
+   return TRUE;
+}
+#endif
+
+/* -----------------------------------------------------------------------
+ ** Tile kernels: g channels starting at ch_idx, 16 bytes worth of samples per channel starting at samp_idx
+ ** ----------------------------------------------------------------------- */
+SPF_INTLV_INLINE void spf_intlv_zip_rounds_(spf_intlv_vec_t *v, uint32_t g, uint32_t w)
+{
+   spf_intlv_vec_t t[SPF_INTLV_MAX_GROUP];
+   SPF_INTLV_UNROLL
+   for (uint32_t s = 1; s < g; s <<= 1)
+   {
+      SPF_INTLV_UNROLL
+      for (uint32_t k = 0; k < g / 2; k++)
+      {
+         t[2 * k]     = spf_intlv_zip_lo(v[k], v[k + g / 2], w);
+         t[2 * k + 1] = spf_intlv_zip_hi(v[k], v[k + g / 2], w);
+      }
+      SPF_INTLV_UNROLL
+      for (uint32_t k = 0; k < g; k++)
+      {
+         v[k] = t[k];
+      }
+   }
+}
+
+SPF_INTLV_INLINE void spf_intlv_unzip_rounds_(spf_intlv_vec_t *v, uint32_t g, uint32_t w)
+{
+   spf_intlv_vec_t t[SPF_INTLV_MAX_GROUP];
+   SPF_INTLV_UNROLL
+   for (uint32_t s = 1; s < g; s <<= 1)
+   {
+      SPF_INTLV_UNROLL
+      for (uint32_t k = 0; k < g / 2; k++)
+      {
+         t[k]         = spf_intlv_unzip_even(v[2 * k], v[2 * k + 1], w);
+         t[k + g / 2] = spf_intlv_unzip_odd(v[2 * k], v[2 * k + 1], w);
+      }
+      SPF_INTLV_UNROLL
+      for (uint32_t k = 0; k < g; k++)
+      {
+         v[k] = t[k];
+      }
+   }
+}
+
+/* Each output vector holds 16 / (g * w) frames of the group. When the group spans all channels the frames are
+ * contiguous, otherwise each frame's chunk of g * w bytes (16 or 8) is stored separately. */
+SPF_INTLV_INLINE void spf_intlv_tile_(capi_buf_t *input_buf_ptr,
+                                      int8_t     *dst_ptr,
+                                      uint32_t    num_channels,
+                                      uint32_t    ch_idx,
+                                      uint32_t    samp_idx,
+                                      uint32_t    w,
+                                      uint32_t    g)
+{
+   spf_intlv_vec_t v[SPF_INTLV_MAX_GROUP];
+
+   SPF_INTLV_UNROLL
+   for (uint32_t r = 0; r < g; r++)
+   {
+      v[r] = spf_intlv_ld16((int8_t *)input_buf_ptr[ch_idx + r].data_ptr + samp_idx * w);
+   }
+
+   spf_intlv_zip_rounds_(v, g, w);
+
+   SPF_INTLV_UNROLL
+   for (uint32_t k = 0; k < g; k++)
+   {
+      if (g == num_channels)
+      {
+         spf_intlv_st16(dst_ptr + samp_idx * num_channels * w + k * SPF_INTLV_VEC_BYTES, v[k]);
+      }
+      else if (SPF_INTLV_VEC_BYTES == g * w)
+      {
+         spf_intlv_st16(dst_ptr + ((samp_idx + k) * num_channels + ch_idx) * w, v[k]);
+      }
+      else
+      {
+         spf_intlv_st8x2(dst_ptr + ((samp_idx + 2 * k) * num_channels + ch_idx) * w,
+                         dst_ptr + ((samp_idx + 2 * k + 1) * num_channels + ch_idx) * w,
+                         v[k]);
+      }
+   }
+}
+
+SPF_INTLV_INLINE void spf_deintlv_tile_(int8_t     *src_ptr,
+                                        capi_buf_t *output_buf_ptr,
+                                        uint32_t    num_src_channels,
+                                        uint32_t    ch_idx,
+                                        uint32_t    samp_idx,
+                                        uint32_t    w,
+                                        uint32_t    g)
+{
+   spf_intlv_vec_t v[SPF_INTLV_MAX_GROUP];
+
+   SPF_INTLV_UNROLL
+   for (uint32_t k = 0; k < g; k++)
+   {
+      if (g == num_src_channels)
+      {
+         v[k] = spf_intlv_ld16(src_ptr + samp_idx * num_src_channels * w + k * SPF_INTLV_VEC_BYTES);
+      }
+      else if (SPF_INTLV_VEC_BYTES == g * w)
+      {
+         v[k] = spf_intlv_ld16(src_ptr + ((samp_idx + k) * num_src_channels + ch_idx) * w);
+      }
+      else
+      {
+         v[k] = spf_intlv_ld8x2(src_ptr + ((samp_idx + 2 * k) * num_src_channels + ch_idx) * w,
+                                src_ptr + ((samp_idx + 2 * k + 1) * num_src_channels + ch_idx) * w);
+      }
+   }
+
+   spf_intlv_unzip_rounds_(v, g, w);
+
+   SPF_INTLV_UNROLL
+   for (uint32_t r = 0; r < g; r++)
+   {
+      spf_intlv_st16((int8_t *)output_buf_ptr[ch_idx + r].data_ptr + samp_idx * w, v[r]);
+   }
+}
+
+/* 24 bit: 4 samples per vector, g is 4 (one frame chunk of 12 bytes per vector) or 2 when the data is stereo */
+SPF_INTLV_INLINE SPF_INTLV_TGT_BYTE_SHUFFLE void spf_intlv_tile_24_(capi_buf_t *input_buf_ptr,
+                                                          int8_t     *dst_ptr,
+                                                          uint32_t    num_channels,
+                                                          uint32_t    ch_idx,
+                                                          uint32_t    samp_idx,
+                                                          uint32_t    g)
+{
+   spf_intlv_vec_t v[SPF_INTLV_MAX_GROUP];
+
+   SPF_INTLV_UNROLL
+   for (uint32_t r = 0; r < g; r++)
+   {
+      v[r] = spf_intlv_shuffle_bytes(spf_intlv_ld12((int8_t *)input_buf_ptr[ch_idx + r].data_ptr + samp_idx * 3),
+                                     spf_intlv_expand_24_tbl);
+   }
+
+   spf_intlv_zip_rounds_(v, g, 4);
+
+   SPF_INTLV_UNROLL
+   for (uint32_t k = 0; k < g; k++)
+   {
+      int8_t *frame_ptr = (g == num_channels) ? (dst_ptr + (samp_idx * num_channels + k * 4) * 3)
+                                              : (dst_ptr + ((samp_idx + k) * num_channels + ch_idx) * 3);
+      spf_intlv_st12(frame_ptr, spf_intlv_shuffle_bytes(v[k], spf_intlv_pack_24_tbl));
+   }
+}
+
+SPF_INTLV_INLINE SPF_INTLV_TGT_BYTE_SHUFFLE void spf_deintlv_tile_24_(int8_t     *src_ptr,
+                                                            capi_buf_t *output_buf_ptr,
+                                                            uint32_t    num_src_channels,
+                                                            uint32_t    ch_idx,
+                                                            uint32_t    samp_idx,
+                                                            uint32_t    g)
+{
+   spf_intlv_vec_t v[SPF_INTLV_MAX_GROUP];
+
+   SPF_INTLV_UNROLL
+   for (uint32_t k = 0; k < g; k++)
+   {
+      int8_t *frame_ptr = (g == num_src_channels) ? (src_ptr + (samp_idx * num_src_channels + k * 4) * 3)
+                                                  : (src_ptr + ((samp_idx + k) * num_src_channels + ch_idx) * 3);
+      v[k] = spf_intlv_shuffle_bytes(spf_intlv_ld12(frame_ptr), spf_intlv_expand_24_tbl);
+   }
+
+   spf_intlv_unzip_rounds_(v, g, 4);
+
+   SPF_INTLV_UNROLL
+   for (uint32_t r = 0; r < g; r++)
+   {
+      spf_intlv_st12((int8_t *)output_buf_ptr[ch_idx + r].data_ptr + samp_idx * 3,
+                     spf_intlv_shuffle_bytes(v[r], spf_intlv_pack_24_tbl));
+   }
+}
+
+/* -----------------------------------------------------------------------
+ ** Drivers
+ ** ----------------------------------------------------------------------- */
+/* Returns the number of samples per vector for the sample width, 0 if it is not vectorized */
+static uint32_t spf_intlv_simd_lanes_(uint32_t bytes_per_samp)
+{
+   switch (bytes_per_samp)
+   {
+      case 2:
+         return 8;
+      case 3:
+         return spf_intlv_has_byte_shuffle() ? 4 : 0;
+      case 4:
+         return 4;
+      default:
+         return 0;
+   }
+}
+
+/* Number of leading channels covered by channel groups. The converted channels need not be all of the
+ * interleaved channels (num_ch <= num_intlv_ch), but groups smaller than a frame chunk of 8 bytes are only
+ * used when they are the whole frame. */
+static uint32_t spf_intlv_simd_num_ch_(uint32_t num_ch, uint32_t num_intlv_ch, uint32_t bytes_per_samp)
+{
+   uint32_t g_max = (2 == bytes_per_samp) ? 8 : 4;
+   uint32_t j     = 0;
+
+   if ((2 == num_intlv_ch) && (2 == num_ch))
+   {
+      return 2;
+   }
+   for (; num_ch - j >= g_max; j += g_max)
+   {
+   }
+   if ((3 != bytes_per_samp) && (num_ch - j >= g_max / 2))
+   {
+      j += g_max / 2;
+   }
+   return j;
+}
+
+static SPF_INTLV_TGT_BYTE_SHUFFLE void spf_intlv_24_(capi_buf_t *input_buf_ptr,
+                                                     int8_t     *dst_ptr,
+                                                     uint32_t    num_channels,
+                                                     uint32_t    num_ch,
+                                                     uint32_t    num_vec_samp)
+{
+   for (uint32_t i = 0; i < num_vec_samp; i += 4)
+   {
+      if (2 == num_ch)
+      {
+         spf_intlv_tile_24_(input_buf_ptr, dst_ptr, num_channels, 0, i, 2);
+         continue;
+      }
+      for (uint32_t j = 0; j < num_ch; j += 4)
+      {
+         spf_intlv_tile_24_(input_buf_ptr, dst_ptr, num_channels, j, i, 4);
+      }
+   }
+}
+
+static SPF_INTLV_TGT_BYTE_SHUFFLE void spf_deintlv_24_(int8_t     *src_ptr,
+                                                       capi_buf_t *output_buf_ptr,
+                                                       uint32_t    num_src_channels,
+                                                       uint32_t    num_ch,
+                                                       uint32_t    num_vec_samp)
+{
+   for (uint32_t i = 0; i < num_vec_samp; i += 4)
+   {
+      if (2 == num_ch)
+      {
+         spf_deintlv_tile_24_(src_ptr, output_buf_ptr, num_src_channels, 0, i, 2);
+         continue;
+      }
+      for (uint32_t j = 0; j < num_ch; j += 4)
+      {
+         spf_deintlv_tile_24_(src_ptr, output_buf_ptr, num_src_channels, j, i, 4);
+      }
+   }
+}
+
+uint32_t spf_deintlv_to_intlv_simd(capi_buf_t *input_buf_ptr,
+                                   int8_t     *dst_ptr,
+                                   uint32_t    num_channels,
+                                   uint32_t    bytes_per_samp,
+                                   uint32_t    num_samp_per_ch,
+                                   uint32_t   *num_ch_done_ptr)
+{
+   uint32_t lanes  = spf_intlv_simd_lanes_(bytes_per_samp);
+   uint32_t num_ch = lanes ? spf_intlv_simd_num_ch_(num_channels, num_channels, bytes_per_samp) : 0;
+
+   *num_ch_done_ptr = 0;
+   if (0 == num_ch)
+   {
+      return 0;
+   }
+
+   uint32_t num_vec_samp = num_samp_per_ch & ~(lanes - 1);
+
+   if (3 == bytes_per_samp)
+   {
+      spf_intlv_24_(input_buf_ptr, dst_ptr, num_channels, num_ch, num_vec_samp);
+   }
+   else if (2 == bytes_per_samp)
+   {
+      for (uint32_t i = 0; i < num_vec_samp; i += lanes)
+      {
+         uint32_t j = 0;
+         if (2 == num_ch)
+         {
+            spf_intlv_tile_(input_buf_ptr, dst_ptr, num_channels, 0, i, 2, 2);
+            continue;
+         }
+         for (; num_ch - j >= 8; j += 8)
+         {
+            spf_intlv_tile_(input_buf_ptr, dst_ptr, num_channels, j, i, 2, 8);
+         }
+         if (j < num_ch)
+         {
+            spf_intlv_tile_(input_buf_ptr, dst_ptr, num_channels, j, i, 2, 4);
+         }
+      }
+   }
+   else
+   {
+      for (uint32_t i = 0; i < num_vec_samp; i += lanes)
+      {
+         uint32_t j = 0;
+         for (; num_ch - j >= 4; j += 4)
+         {
+            spf_intlv_tile_(input_buf_ptr, dst_ptr, num_channels, j, i, 4, 4);
+         }
+         if (j < num_ch)
+         {
+            spf_intlv_tile_(input_buf_ptr, dst_ptr, num_channels, j, i, 4, 2);
+         }
+      }
+   }
+
+   *num_ch_done_ptr = num_ch;
+   return num_vec_samp;
+}
+
+uint32_t spf_intlv_to_deintlv_simd(int8_t     *src_ptr,
+                                   capi_buf_t *output_buf_ptr,
+                                   uint32_t    num_src_channels,
+                                   uint32_t    num_dst_channels,
+                                   uint32_t    bytes_per_samp,
+                                   uint32_t    num_samp_per_ch,
+                                   uint32_t   *num_ch_done_ptr)
+{
+   uint32_t lanes  = spf_intlv_simd_lanes_(bytes_per_samp);
+   uint32_t num_ch = lanes ? spf_intlv_simd_num_ch_(num_dst_channels, num_src_channels, bytes_per_samp) : 0;
+
+   *num_ch_done_ptr = 0;
+   if (0 == num_ch)
+   {
+      return 0;
+   }
+
+   uint32_t num_vec_samp = num_samp_per_ch & ~(lanes - 1);
+
+   if (3 == bytes_per_samp)
+   {
+      spf_deintlv_24_(src_ptr, output_buf_ptr, num_src_channels, num_ch, num_vec_samp);
+   }
+   else if (2 == bytes_per_samp)
+   {
+      for (uint32_t i = 0; i < num_vec_samp; i += lanes)
+      {
+         uint32_t j = 0;
+         if (2 == num_src_channels)
+         {
+            spf_deintlv_tile_(src_ptr, output_buf_ptr, num_src_channels, 0, i, 2, 2);
+            continue;
+         }
+         for (; num_ch - j >= 8; j += 8)
+         {
+            spf_deintlv_tile_(src_ptr, output_buf_ptr, num_src_channels, j, i, 2, 8);
+         }
+         if (j < num_ch)
+         {
+            spf_deintlv_tile_(src_ptr, output_buf_ptr, num_src_channels, j, i, 2, 4);
+         }
+      }
+   }
+   else
+   {
+      for (uint32_t i = 0; i < num_vec_samp; i += lanes)
+      {
+         uint32_t j = 0;
+         for (; num_ch - j >= 4; j += 4)
+         {
+            spf_deintlv_tile_(src_ptr, output_buf_ptr, num_src_channels, j, i, 4, 4);
+         }
+         if (j < num_ch)
+         {
+            spf_deintlv_tile_(src_ptr, output_buf_ptr, num_src_channels, j, i, 4, 2);
+         }
+      }
+   }
+
+   *num_ch_done_ptr = num_ch;
+   return num_vec_samp;
+}
+
+#endif // SPF_INTERLEAVER_SIMD
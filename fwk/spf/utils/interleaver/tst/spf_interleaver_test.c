@@ -0,0 +1,221 @@
+/***
+ * \file spf_interleaver_test.c
+ * \brief
+ *    This file tests that the interleaver (including the vector kernels where available) is bit-exact
+ *    with a plain per-sample reference conversion.
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "spf_interleaver_test.h"
+#include "posal.h"
+
+#define INTLV_TEST_MAX_CH 32
+#define INTLV_TEST_MAX_SAMPLES 480
+#define INTLV_TEST_GUARD_BYTES 16
+#define INTLV_TEST_GUARD_PATTERN 0xA5
+// every buffer is offset by this many bytes from the allocation so that vector loads and stores are unaligned
+#define INTLV_TEST_MISALIGN 8
+
+static const uint32_t intlv_test_bytes_per_samp[] = { 2, 3, 4, 8 };
+static const uint32_t intlv_test_num_samples[]    = { 0, 1, 3, 4, 7, 8, 9, 15, 16, 17, 33, 240, 479, 480 };
+
+typedef struct intlv_test_bufs_t
+{
+   int8_t    *intlv_ptr;                         // interleaved data
+   int8_t    *deintlv_ptr[INTLV_TEST_MAX_CH];     // de-interleaved data, one buffer per channel
+   int8_t    *ref_ptr;                           // reference output (interleaved or per channel)
+   capi_buf_t deintlv_bufs[INTLV_TEST_MAX_CH];
+   capi_buf_t intlv_buf;
+} intlv_test_bufs_t;
+
+static uint32_t intlv_test_rand_state = 0x12345678;
+
+static uint8_t intlv_test_rand_byte()
+{
+   intlv_test_rand_state = intlv_test_rand_state * 1664525 + 1013904223;
+   return (uint8_t)(intlv_test_rand_state >> 24);
+}
+
+static int8_t *intlv_test_alloc(uint32_t size)
+{
+   int8_t *mem_ptr = (int8_t *)posal_memory_malloc(size + INTLV_TEST_MISALIGN + INTLV_TEST_GUARD_BYTES,
+                                                   POSAL_HEAP_DEFAULT);
+   return mem_ptr ? (mem_ptr + INTLV_TEST_MISALIGN) : NULL;
+}
+
+static void intlv_test_free(int8_t *ptr)
+{
+   if (ptr)
+   {
+      posal_memory_free(ptr - INTLV_TEST_MISALIGN);
+   }
+}
+
+static void intlv_test_fill(int8_t *ptr, uint32_t size)
+{
+   for (uint32_t i = 0; i < size; i++)
+   {
+      ptr[i] = (int8_t)intlv_test_rand_byte();
+   }
+   memset(ptr + size, INTLV_TEST_GUARD_PATTERN, INTLV_TEST_GUARD_BYTES);
+}
+
+static void intlv_test_clear(int8_t *ptr, uint32_t size)
+{
+   memset(ptr, 0, size);
+   memset(ptr + size, INTLV_TEST_GUARD_PATTERN, INTLV_TEST_GUARD_BYTES);
+}
+
+static bool_t intlv_test_guard_intact(int8_t *ptr, uint32_t size)
+{
+   for (uint32_t i = 0; i < INTLV_TEST_GUARD_BYTES; i++)
+   {
+      if ((uint8_t)ptr[size + i] != INTLV_TEST_GUARD_PATTERN)
+      {
+         return FALSE;
+      }
+   }
+   return TRUE;
+}
+
+static ar_result_t intlv_test_deintlv_to_intlv(intlv_test_bufs_t *bufs_ptr, uint32_t num_ch, uint32_t bps, uint32_t n)
+{
+   uint32_t ch_bytes    = n * bps;
+   uint32_t intlv_bytes = ch_bytes * num_ch;
+
+   for (uint32_t j = 0; j < num_ch; j++)
+   {
+      intlv_test_fill(bufs_ptr->deintlv_ptr[j], ch_bytes);
+      bufs_ptr->deintlv_bufs[j].actual_data_len = ch_bytes;
+   }
+   intlv_test_clear(bufs_ptr->intlv_ptr, intlv_bytes);
+
+   for (uint32_t i = 0; i < n; i++)
+   {
+      for (uint32_t j = 0; j < num_ch; j++)
+      {
+         memcpy(bufs_ptr->ref_ptr + (i * num_ch + j) * bps, bufs_ptr->deintlv_ptr[j] + i * bps, bps);
+      }
+   }
+
+   ar_result_t result = spf_deintlv_to_intlv_v2(bufs_ptr->deintlv_bufs, &bufs_ptr->intlv_buf, num_ch, bps, n);
+
+   if (AR_DID_FAIL(result) || (intlv_bytes != bufs_ptr->intlv_buf.actual_data_len) ||
+       memcmp(bufs_ptr->intlv_ptr, bufs_ptr->ref_ptr, intlv_bytes) ||
+       !intlv_test_guard_intact(bufs_ptr->intlv_ptr, intlv_bytes))
+   {
+      AR_MSG(DBG_ERROR_PRIO,
+             "Interleaver test: deint to int mismatch, num_ch %lu, bytes_per_samp %lu, num_samples %lu",
+             num_ch,
+             bps,
+             n);
+      return AR_EFAILED;
+   }
+   return AR_EOK;
+}
+
+static ar_result_t intlv_test_intlv_to_deintlv(intlv_test_bufs_t *bufs_ptr,
+                                               uint32_t           num_src_ch,
+                                               uint32_t           num_dst_ch,
+                                               uint32_t           bps,
+                                               uint32_t           n)
+{
+   uint32_t ch_bytes    = n * bps;
+   uint32_t intlv_bytes = ch_bytes * num_src_ch;
+
+   intlv_test_fill(bufs_ptr->intlv_ptr, intlv_bytes);
+   bufs_ptr->intlv_buf.actual_data_len = intlv_bytes;
+   for (uint32_t j = 0; j < num_dst_ch; j++)
+   {
+      intlv_test_clear(bufs_ptr->deintlv_ptr[j], ch_bytes);
+   }
+
+   ar_result_t result =
+      spf_intlv_to_deintlv_v3(&bufs_ptr->intlv_buf, bufs_ptr->deintlv_bufs, num_src_ch, num_dst_ch, bps, n);
+   if (AR_DID_FAIL(result))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "Interleaver test: int to deint failed, bytes_per_samp %lu", bps);
+      return AR_EFAILED;
+   }
+
+   for (uint32_t j = 0; j < num_dst_ch; j++)
+   {
+      for (uint32_t i = 0; i < n; i++)
+      {
+         memcpy(bufs_ptr->ref_ptr + i * bps, bufs_ptr->intlv_ptr + (i * num_src_ch + j) * bps, bps);
+      }
+      if ((ch_bytes != bufs_ptr->deintlv_bufs[j].actual_data_len) ||
+          memcmp(bufs_ptr->deintlv_ptr[j], bufs_ptr->ref_ptr, ch_bytes) ||
+          !intlv_test_guard_intact(bufs_ptr->deintlv_ptr[j], ch_bytes))
+      {
+         AR_MSG(DBG_ERROR_PRIO,
+                "Interleaver test: int to deint mismatch, src ch %lu, dst ch %lu (at %lu), bytes_per_samp %lu, "
+                "num_samples %lu",
+                num_src_ch,
+                num_dst_ch,
+                j,
+                bps,
+                n);
+         return AR_EFAILED;
+      }
+   }
+   return AR_EOK;
+}
+
+ar_result_t spf_interleaver_test()
+{
+   ar_result_t       result = AR_EOK;
+   intlv_test_bufs_t bufs;
+   uint32_t          max_ch_bytes    = INTLV_TEST_MAX_SAMPLES * 8;
+   uint32_t          max_intlv_bytes = max_ch_bytes * INTLV_TEST_MAX_CH;
+   uint32_t          num_tests       = 0;
+
+   memset(&bufs, 0, sizeof(bufs));
+   bufs.intlv_ptr = intlv_test_alloc(max_intlv_bytes);
+   bufs.ref_ptr   = intlv_test_alloc(max_intlv_bytes);
+   result         = (bufs.intlv_ptr && bufs.ref_ptr) ? AR_EOK : AR_ENOMEMORY;
+   for (uint32_t j = 0; (j < INTLV_TEST_MAX_CH) && AR_SUCCEEDED(result); j++)
+   {
+      bufs.deintlv_ptr[j]                 = intlv_test_alloc(max_ch_bytes);
+      bufs.deintlv_bufs[j].data_ptr       = bufs.deintlv_ptr[j];
+      bufs.deintlv_bufs[j].max_data_len   = max_ch_bytes;
+      result                              = bufs.deintlv_ptr[j] ? AR_EOK : AR_ENOMEMORY;
+   }
+   bufs.intlv_buf.data_ptr     = bufs.intlv_ptr;
+   bufs.intlv_buf.max_data_len = max_intlv_bytes;
+
+   for (uint32_t b = 0; (b < SIZE_OF_AN_ARRAY(intlv_test_bytes_per_samp)) && AR_SUCCEEDED(result); b++)
+   {
+      uint32_t bps = intlv_test_bytes_per_samp[b];
+      for (uint32_t s = 0; (s < SIZE_OF_AN_ARRAY(intlv_test_num_samples)) && AR_SUCCEEDED(result); s++)
+      {
+         uint32_t n = intlv_test_num_samples[s];
+         for (uint32_t num_ch = 1; (num_ch <= INTLV_TEST_MAX_CH) && AR_SUCCEEDED(result); num_ch++)
+         {
+            result |= intlv_test_deintlv_to_intlv(&bufs, num_ch, bps, n);
+            result |= intlv_test_intlv_to_deintlv(&bufs, num_ch, num_ch, bps, n);
+            num_tests += 2;
+
+            // fewer output channels than interleaved channels (v3)
+            for (uint32_t num_dst_ch = 1; (num_dst_ch < num_ch) && AR_SUCCEEDED(result); num_dst_ch++)
+            {
+               result |= intlv_test_intlv_to_deintlv(&bufs, num_ch, num_dst_ch, bps, n);
+               num_tests++;
+            }
+         }
+      }
+   }
+
+   for (uint32_t j = 0; j < INTLV_TEST_MAX_CH; j++)
+   {
+      intlv_test_free(bufs.deintlv_ptr[j]);
+   }
+   intlv_test_free(bufs.intlv_ptr);
+   intlv_test_free(bufs.ref_ptr);
+
+   AR_MSG(DBG_HIGH_PRIO, "Interleaver test: %lu conversions checked, result 0x%lx", num_tests, result);
+   return result;
+}
@@ -0,0 +1,19 @@
+#ifndef __SPF_INTERLEAVER_TEST_H__
+#define __SPF_INTERLEAVER_TEST_H__
+/***
+ * \file spf_interleaver_test.h
+ * \brief
+ *    Header file for interleaver bit-exactness tests.
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "spf_interleaver.h"
+
+/* Compares the interleaver against reference scalar conversions for all supported sample widths,
+ * 1 to 32 channels, several frame lengths and unaligned buffers. Returns AR_EOK if all outputs match. */
+ar_result_t spf_interleaver_test();
+
+#endif //__SPF_INTERLEAVER_TEST_H__
@@ -0,0 +1,114 @@
+/***
+ * \file capi_library_thread_pool_test.c
+ * \brief
+ *    This file tests the CAPI library thread pool (th_pool): thread naming and fork-join.
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "capi_library_thread_pool_test.h"
+#include "posal.h"
+
+#define TH_POOL_TEST_NUM_NAMES (12)
+#define TH_POOL_TEST_NUM_THREADS (4)
+#define TH_POOL_TEST_NUM_JOBS (37)
+
+typedef struct th_pool_test_fj_ctx_t
+{
+   uint32_t in[TH_POOL_TEST_NUM_JOBS];
+   uint32_t out[TH_POOL_TEST_NUM_JOBS];
+} th_pool_test_fj_ctx_t;
+
+/********************************************************************************/
+/* Every thread gets a unique name ending with its full index, also past 10 threads and when the algo name has no
+   NULL char. */
+static ar_result_t th_pool_test_thread_names()
+{
+   const char full_name[TH_POOL_TH_NAME_SIZE]  = { 'L', 'I', 'M', 'T' };
+   const char short_name[TH_POOL_TH_NAME_SIZE] = "AB";
+   char       name[TH_POOL_THREAD_NAME_MAX_LEN];
+   char       expected[TH_POOL_THREAD_NAME_MAX_LEN];
+
+   for (uint32_t i = 0; i < TH_POOL_TEST_NUM_NAMES; i++)
+   {
+      th_pool_get_thread_name(full_name, i, name, sizeof(name));
+      snprintf(expected, sizeof(expected), "LIMTTHPL%lu", (unsigned long)i);
+      if (0 != strncmp(name, expected, sizeof(name)))
+      {
+         AR_MSG(DBG_ERROR_PRIO, "th_pool test: thread %lu has wrong name", i);
+         return AR_EFAILED;
+      }
+
+      th_pool_get_thread_name(short_name, i, name, sizeof(name));
+      snprintf(expected, sizeof(expected), "ABTHPL%lu", (unsigned long)i);
+      if (0 != strncmp(name, expected, sizeof(name)))
+      {
+         AR_MSG(DBG_ERROR_PRIO, "th_pool test: thread %lu has wrong name with short algo name", i);
+         return AR_EFAILED;
+      }
+   }
+
+   return AR_EOK;
+}
+
+/********************************************************************************/
+static void th_pool_test_job(void *context_ptr, uint32_t job_idx)
+{
+   th_pool_test_fj_ctx_t *ctx_ptr = (th_pool_test_fj_ctx_t *)context_ptr;
+
+   ctx_ptr->out[job_idx] = ctx_ptr->in[job_idx] * ctx_ptr->in[job_idx];
+}
+
+/* Pool with the longest algo name and all threads runs every fork-join job exactly once. */
+static ar_result_t th_pool_test_fork_join()
+{
+   ar_result_t           result                          = AR_EOK;
+   const char            th_name[TH_POOL_TH_NAME_SIZE]   = { 'T', 'E', 'S', 'T' };
+   th_pool_test_fj_ctx_t ctx;
+
+   th_pool_t *pool_ptr = th_pool_create(posal_thread_prio_get(), TH_POOL_TEST_NUM_THREADS, 4096, th_name);
+   if (NULL == pool_ptr)
+   {
+      AR_MSG(DBG_ERROR_PRIO, "th_pool test: pool creation failed");
+      return AR_EFAILED;
+   }
+
+   for (uint32_t iter = 0; (iter < 100) && AR_SUCCEEDED(result); iter++)
+   {
+      for (uint32_t i = 0; i < TH_POOL_TEST_NUM_JOBS; i++)
+      {
+         ctx.in[i]  = iter + i;
+         ctx.out[i] = 0;
+      }
+
+      result = th_pool_fork_join(pool_ptr, th_pool_test_job, &ctx, TH_POOL_TEST_NUM_JOBS);
+
+      for (uint32_t i = 0; (i < TH_POOL_TEST_NUM_JOBS) && AR_SUCCEEDED(result); i++)
+      {
+         if (ctx.out[i] != ctx.in[i] * ctx.in[i])
+         {
+            AR_MSG(DBG_ERROR_PRIO, "th_pool test: job %lu of iteration %lu was not run", i, iter);
+            result = AR_EFAILED;
+         }
+      }
+   }
+
+   th_pool_destroy(pool_ptr);
+
+   return result;
+}
+
+/********************************************************************************/
+ar_result_t capi_library_thread_pool_test()
+{
+   ar_result_t result = AR_EOK;
+
+   result |= th_pool_test_thread_names();
+   result |= th_pool_test_fork_join();
+
+   AR_MSG(DBG_HIGH_PRIO, "th_pool tests %s", AR_SUCCEEDED(result) ? "passed" : "FAILED");
+
+   return result;
+}
@@ -0,0 +1,18 @@
+#ifndef __CAPI_LIBRARY_THREAD_POOL_TEST_H__
+#define __CAPI_LIBRARY_THREAD_POOL_TEST_H__
+/***
+ * \file capi_library_thread_pool_test.h
+ * \brief
+ *    Header file for the CAPI library thread pool (th_pool) tests.
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "capi_library_thread_pool.h"
+
+/* Runs all the th_pool tests, returns AR_EOK if all of them pass */
+ar_result_t capi_library_thread_pool_test();
+
+#endif //__CAPI_LIBRARY_THREAD_POOL_TEST_H__
@@ -0,0 +1,49 @@
+/*
+ * gpr_lx_shm.h
+ *
+ * This file has the shared memory ring implementation of the GPR datalink
+ * layer for Linux.
+ *
+ * Both ends of a link map one memfd region holding a single producer/single
+ * consumer ring per direction. Packets are copied into the ring by the sender
+ * and handed to GPR in place on the receiver, the slot is reclaimed when GPR
+ * calls receive_done. An eventfd doorbell is rung only when the consumer is
+ * about to sleep, and the receiver thread drains every queued packet per
+ * wakeup.
+ *
+ * The region and doorbells are exchanged over an abstract unix socket named
+ * after the domain pair, the first end to come up owns the region and the
+ * second attaches to it. Both ends may live in the same process, which gives
+ * an in-process loopback. The owner hands the region out only once, so a
+ * restarted peer requires both ends to be re-initialized. Both ends check
+ * with SO_PEERCRED that the other one runs as the same user or as root.
+ *
+ * Record headers are written by the peer and are bounds checked against the
+ * ring and the maximum packet size before use. A peer that writes a bad
+ * record is dropped, its ring is not read anymore and sends to it fail.
+ *
+ * Ring space is reclaimed in order, so a packet that GPR holds blocks the
+ * reclaim of every packet behind it, even ones already returned. Once the
+ * sender wraps around to the held packet its sends fail with
+ * AR_ENORESOURCE until the packet is returned. GPR clients must return
+ * received packets promptly, one that needs the data for longer copies it
+ * and returns the packet.
+ *
+ * Copyright (c) Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "gpr_comdef.h"
+#include "ipc_dl_api.h"
+
+/******************************************************************************
+ * Defines                                                                    *
+ *****************************************************************************/
+/*IPC datalink init function called from gpr layer for the shared memory ring*/
+GPR_INTERNAL uint32_t ipc_dl_lx_shm_init(uint32_t                 src_domain_id,
+                                         uint32_t                 dest_domain_id,
+                                         const gpr_to_ipc_vtbl_t *p_gpr_to_ipc_vtbl,
+                                         ipc_to_gpr_vtbl_t **     pp_ipc_to_gpr_vtbl);
+
+/*IPC datalink de-init function called from gpr layer for the shared memory ring*/
+GPR_INTERNAL uint32_t ipc_dl_lx_shm_deinit(uint32_t src_domain_id, uint32_t dest_domain_id);
@@ -0,0 +1,758 @@
+/*
+ * gpr_lx_shm.c
+ *
+ * This file has the shared memory ring implementation of the GPR datalink
+ * layer for Linux. See gpr_lx_shm.h for the overview.
+ *
+ * Copyright (c) Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+#define LOG_TAG "gpr_dl_lx_shm"
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /*struct ucred*/
+#endif
+#include <stdlib.h>
+#include <stddef.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include "ar_osal_log.h"
+
+#include "gpr_comdef.h"
+#include "ipc_dl_api.h"
+#include "gpr_ids_domains.h"
+#include "gpr_lx_shm.h"
+#include "ar_osal_error.h"
+
+/*Bytes of ring per direction, must be a power of two*/
+#define GPR_DL_LX_SHM_RING_SIZE (256 * 1024)
+#define GPR_DL_LX_SHM_RING_MASK (GPR_DL_LX_SHM_RING_SIZE - 1)
+/*Largest packet accepted, keeps a full ring from being taken by one packet*/
+#define GPR_DL_LX_SHM_MAX_PKT_SIZE (GPR_DL_LX_SHM_RING_SIZE / 4)
+#define GPR_DL_LX_SHM_MAGIC 0x4C505247 /*"GPRL"*/
+#define GPR_DL_LX_SHM_SOCK_NAME "gpr_lx_shm_%u_%u"
+#define GPR_DL_LX_SHM_ATTACH_TIMEOUT_SEC 2
+#define GPR_DL_LX_SHM_NUM_FDS 3 /*memfd and one doorbell per ring*/
+
+/*Record flags*/
+#define GPR_DL_LX_SHM_REC_PAD  0x1 /*filler up to the end of the ring*/
+#define GPR_DL_LX_SHM_REC_DONE 0x2 /*receiver returned the packet*/
+
+#define GPR_DL_LX_SHM_ALIGN(x) (((x) + 7) & ~7u)
+
+/** Data receive notification callback type*/
+typedef uint32_t (*gpr_dl_lx_receive_cb)(void *ptr, uint32_t length);
+
+/** Data send done notification callback type*/
+typedef uint32_t (*gpr_dl_lx_send_done_cb)(void *ptr, uint32_t length);
+
+/*Header in front of every packet in the ring, packets stay 8 byte aligned*/
+typedef struct gpr_dl_lx_shm_rec{
+    uint32_t size;
+    uint32_t flags;
+}gpr_dl_lx_shm_rec_t;
+
+/*
+ * Single producer/single consumer ring. Indices are free running and only
+ * masked on access. tail is written by the producer, head and waiting by the
+ * consumer, so they are kept on separate cache lines.
+ */
+typedef struct gpr_dl_lx_shm_ring{
+    uint32_t tail __attribute__((aligned(64)));
+    uint32_t head __attribute__((aligned(64)));
+    uint32_t waiting;
+    uint8_t data[GPR_DL_LX_SHM_RING_SIZE] __attribute__((aligned(64)));
+}gpr_dl_lx_shm_ring_t;
+
+/*Layout of the shared region, ring[0] carries owner to peer packets*/
+typedef struct gpr_dl_lx_shm_region{
+    uint32_t magic;
+    uint32_t ring_size;
+    gpr_dl_lx_shm_ring_t ring[2];
+}gpr_dl_lx_shm_region_t;
+
+typedef struct gpr_dl_lx_shm_port{
+    uint32_t domain_id;
+    pthread_t receiver_thread;
+    bool thread_exit;
+    gpr_dl_lx_receive_cb rx_cb;
+    gpr_dl_lx_send_done_cb send_done;
+    gpr_dl_lx_shm_region_t *region;
+    gpr_dl_lx_shm_ring_t *tx_ring;
+    gpr_dl_lx_shm_ring_t *rx_ring;
+    int mem_fd;
+    int efd[2];         /*doorbells of ring[0] and ring[1]*/
+    int tx_efd;
+    int rx_efd;
+    int listen_fd;      /*owner only, until the peer attaches*/
+    int exit_efd;
+    uint32_t rx_rd;     /*next record to hand to gpr, ahead of rx_ring->head*/
+    bool peer_dropped;  /*peer corrupted the ring, nothing more is exchanged with it*/
+    pthread_mutex_t tx_lock;
+    pthread_mutex_t rx_lock;
+} gpr_dl_lx_shm_port_t;
+
+/*Array of structure pointers each member pointer corresponds to one domain*/
+static gpr_dl_lx_shm_port_t *gpr_dl_lx_shm_ports[GPR_PL_NUM_TOTAL_DOMAINS_V]={NULL};
+
+static uint32_t gpr_dl_lx_shm_send(uint32_t domain_id, void *buf, uint32_t size);
+
+static uint32_t gpr_dl_lx_shm_receive_done(uint32_t domain_id, void *buf);
+
+/*ipc datalink function table*/
+static ipc_to_gpr_vtbl_t gpr_dl_lx_shm_vtbl =
+{
+   gpr_dl_lx_shm_send,
+   gpr_dl_lx_shm_receive_done,
+};
+
+static inline uint32_t gpr_dl_lx_shm_rec_len(uint32_t size)
+{
+    return sizeof(gpr_dl_lx_shm_rec_t) + GPR_DL_LX_SHM_ALIGN(size);
+}
+
+/*
+ * Record sizes are written by the peer, so a record is used only if it lies
+ * inside the ring without wrapping and inside the published part [rd, end).
+ */
+static inline bool gpr_dl_lx_shm_rec_fits(uint32_t rd, uint32_t len, uint32_t end)
+{
+    uint32_t offset = rd & GPR_DL_LX_SHM_RING_MASK;
+
+    return (len >= sizeof(gpr_dl_lx_shm_rec_t)) &&
+           (len <= GPR_DL_LX_SHM_RING_SIZE - offset) &&
+           (len <= end - rd);
+}
+
+/*Stops using the ring of a peer that broke the record format*/
+static void gpr_dl_lx_shm_drop_peer(gpr_dl_lx_shm_port_t *dl_port, const char *where,
+                                    uint32_t idx, uint32_t val)
+{
+    if (!dl_port->peer_dropped)
+        AR_LOG_ERR(LOG_TAG,"%s: bad record at %u (%u) from domain %d, dropping peer",
+                   where, idx, val, dl_port->domain_id);
+    __atomic_store_n(&dl_port->peer_dropped, true, __ATOMIC_RELEASE);
+}
+
+/*Copies one packet into the ring. Called with tx_lock held.*/
+static uint32_t gpr_dl_lx_shm_ring_write(gpr_dl_lx_shm_ring_t *ring, void *buf, uint32_t size)
+{
+    gpr_dl_lx_shm_rec_t *rec;
+    uint32_t tail = ring->tail;
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    uint32_t need = gpr_dl_lx_shm_rec_len(size);
+    uint32_t offset = tail & GPR_DL_LX_SHM_RING_MASK;
+    uint32_t pad = 0;
+
+    /*Records never wrap, the rest of the ring is skipped instead*/
+    if (offset + need > GPR_DL_LX_SHM_RING_SIZE)
+        pad = GPR_DL_LX_SHM_RING_SIZE - offset;
+
+    if ((tail - head) + pad + need > GPR_DL_LX_SHM_RING_SIZE)
+        return AR_ENORESOURCE;
+
+    if (pad) {
+        rec = (gpr_dl_lx_shm_rec_t *)&ring->data[offset];
+        rec->size = pad - sizeof(gpr_dl_lx_shm_rec_t);
+        rec->flags = GPR_DL_LX_SHM_REC_PAD;
+        tail += pad;
+        offset = 0;
+    }
+
+    rec = (gpr_dl_lx_shm_rec_t *)&ring->data[offset];
+    rec->size = size;
+    rec->flags = 0;
+    memcpy(rec + 1, buf, size);
+
+    __atomic_store_n(&ring->tail, tail + need, __ATOMIC_RELEASE);
+    return AR_EOK;
+}
+
+/*
+ * Advances head over the records gpr has returned. Packets may be returned
+ * out of order, so head stops at the first one still in use.
+ * Called with rx_lock held.
+ */
+static void gpr_dl_lx_shm_reclaim(gpr_dl_lx_shm_port_t *dl_port)
+{
+    gpr_dl_lx_shm_ring_t *ring = dl_port->rx_ring;
+    uint32_t head = ring->head;
+    uint32_t rd = __atomic_load_n(&dl_port->rx_rd, __ATOMIC_ACQUIRE);
+    gpr_dl_lx_shm_rec_t *rec;
+
+    uint32_t len;
+
+    while (head != rd) {
+        rec = (gpr_dl_lx_shm_rec_t *)&ring->data[head & GPR_DL_LX_SHM_RING_MASK];
+        if (!(rec->flags & (GPR_DL_LX_SHM_REC_PAD | GPR_DL_LX_SHM_REC_DONE)))
+            break;
+        /*Records were checked by drain, but the peer can still rewrite them*/
+        len = gpr_dl_lx_shm_rec_len(__atomic_load_n(&rec->size, __ATOMIC_RELAXED));
+        if (!gpr_dl_lx_shm_rec_fits(head, len, rd)) {
+            gpr_dl_lx_shm_drop_peer(dl_port, "reclaim", head, len);
+            break;
+        }
+        head += len;
+    }
+    __atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+}
+
+static uint32_t gpr_dl_lx_shm_release(gpr_dl_lx_shm_port_t *dl_port, gpr_dl_lx_shm_rec_t *rec)
+{
+    pthread_mutex_lock(&dl_port->rx_lock);
+    if (rec->flags & GPR_DL_LX_SHM_REC_DONE) {
+        pthread_mutex_unlock(&dl_port->rx_lock);
+        AR_LOG_ERR(LOG_TAG,"%s:%d buffer already put error case", __func__, __LINE__);
+        return AR_EALREADY;
+    }
+    rec->flags |= GPR_DL_LX_SHM_REC_DONE;
+    gpr_dl_lx_shm_reclaim(dl_port);
+    pthread_mutex_unlock(&dl_port->rx_lock);
+    return AR_EOK;
+}
+
+/*Hands every published packet to gpr in place*/
+static void gpr_dl_lx_shm_drain(gpr_dl_lx_shm_port_t *dl_port)
+{
+    gpr_dl_lx_shm_ring_t *ring = dl_port->rx_ring;
+    uint32_t rd = dl_port->rx_rd;
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    gpr_dl_lx_shm_rec_t *rec;
+    uint32_t size, flags, status;
+    bool pad_seen = false;
+
+    uint32_t len;
+
+    if (dl_port->peer_dropped)
+        return;
+    if (tail - rd > GPR_DL_LX_SHM_RING_SIZE) {
+        gpr_dl_lx_shm_drop_peer(dl_port, "tail", tail, tail - rd);
+        return;
+    }
+
+    while (rd != tail) {
+        rec = (gpr_dl_lx_shm_rec_t *)&ring->data[rd & GPR_DL_LX_SHM_RING_MASK];
+        /*Read the header once, the peer may rewrite it at any time*/
+        size = __atomic_load_n(&rec->size, __ATOMIC_RELAXED);
+        flags = __atomic_load_n(&rec->flags, __ATOMIC_RELAXED);
+        len = (size <= GPR_DL_LX_SHM_RING_SIZE) ? gpr_dl_lx_shm_rec_len(size) : 0;
+        if (!gpr_dl_lx_shm_rec_fits(rd, len, tail) ||
+            (flags & ~GPR_DL_LX_SHM_REC_PAD) ||
+            ((flags & GPR_DL_LX_SHM_REC_PAD) &&
+             (((rd + len) & GPR_DL_LX_SHM_RING_MASK) != 0)) ||
+            (!(flags & GPR_DL_LX_SHM_REC_PAD) && (size > GPR_DL_LX_SHM_MAX_PKT_SIZE))) {
+            gpr_dl_lx_shm_drop_peer(dl_port, "drain", rd, size);
+            break;
+        }
+        rd += len;
+        /*Publish rd first, gpr may return the packet before rx_cb returns*/
+        __atomic_store_n(&dl_port->rx_rd, rd, __ATOMIC_RELEASE);
+
+        if (flags & GPR_DL_LX_SHM_REC_PAD) {
+            pad_seen = true;
+            continue;
+        }
+        AR_LOG_DEBUG(LOG_TAG,"received buffer size %d", size);
+        status = dl_port->rx_cb(rec + 1, size);
+        if (status != AR_EOK) {
+            AR_LOG_ERR(LOG_TAG,"%s:%d receive callback failed", __func__, __LINE__);
+            gpr_dl_lx_shm_release(dl_port, rec);
+        }
+        if (rd == tail) {
+            tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+            if (tail - rd > GPR_DL_LX_SHM_RING_SIZE) {
+                gpr_dl_lx_shm_drop_peer(dl_port, "tail", tail, tail - rd);
+                break;
+            }
+        }
+    }
+
+    if (pad_seen) {
+        pthread_mutex_lock(&dl_port->rx_lock);
+        gpr_dl_lx_shm_reclaim(dl_port);
+        pthread_mutex_unlock(&dl_port->rx_lock);
+    }
+}
+
+static socklen_t gpr_dl_lx_shm_sock_addr(struct sockaddr_un *addr,
+                                         uint32_t src_domain_id, uint32_t dst_domain_id)
+{
+    int len;
+
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    /*Abstract namespace, both ends derive the same name from the domain pair*/
+    len = snprintf(&addr->sun_path[1], sizeof(addr->sun_path) - 1, GPR_DL_LX_SHM_SOCK_NAME,
+                   (src_domain_id < dst_domain_id) ? src_domain_id : dst_domain_id,
+                   (src_domain_id < dst_domain_id) ? dst_domain_id : src_domain_id);
+    return (socklen_t)(offsetof(struct sockaddr_un, sun_path) + 1 + len);
+}
+
+/*
+ * The region is shared writable with the peer, so it is exchanged only with a
+ * process of the same user or root. Checked on both ends of the socket.
+ */
+static bool gpr_dl_lx_shm_peer_trusted(int sock)
+{
+    struct ucred cred;
+    socklen_t len = sizeof(cred);
+
+    if (getsockopt(sock, SOL_SOCKET, SO_PEERCRED, &cred, &len) < 0) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d SO_PEERCRED failed %d", __func__, __LINE__, errno);
+        return false;
+    }
+    if ((cred.uid != geteuid()) && (cred.uid != 0)) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d peer pid %d uid %u not trusted", __func__, __LINE__,
+                   cred.pid, cred.uid);
+        return false;
+    }
+    return true;
+}
+
+static uint32_t gpr_dl_lx_shm_map(gpr_dl_lx_shm_port_t *dl_port, bool owner)
+{
+    void *ptr = mmap(NULL, sizeof(gpr_dl_lx_shm_region_t), PROT_READ | PROT_WRITE,
+                     MAP_SHARED, dl_port->mem_fd, 0);
+    if (ptr == MAP_FAILED) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d mmap failed %d", __func__, __LINE__, errno);
+        return AR_ENOMEMORY;
+    }
+    dl_port->region = (gpr_dl_lx_shm_region_t *)ptr;
+
+    if (owner) {
+        dl_port->region->ring_size = GPR_DL_LX_SHM_RING_SIZE;
+        dl_port->region->magic = GPR_DL_LX_SHM_MAGIC;
+    } else if ((dl_port->region->magic != GPR_DL_LX_SHM_MAGIC) ||
+               (dl_port->region->ring_size != GPR_DL_LX_SHM_RING_SIZE)) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d region layout mismatch", __func__, __LINE__);
+        return AR_EUNSUPPORTED;
+    }
+
+    dl_port->tx_ring = &dl_port->region->ring[owner ? 0 : 1];
+    dl_port->tx_efd = dl_port->efd[owner ? 0 : 1];
+    dl_port->rx_ring = &dl_port->region->ring[owner ? 1 : 0];
+    dl_port->rx_efd = dl_port->efd[owner ? 1 : 0];
+    dl_port->rx_rd = dl_port->rx_ring->head;
+    return AR_EOK;
+}
+
+/*Creates the region and doorbells and starts listening for the peer*/
+static uint32_t gpr_dl_lx_shm_own(gpr_dl_lx_shm_port_t *dl_port,
+                                  struct sockaddr_un *addr, socklen_t addr_len)
+{
+    uint32_t status;
+
+    dl_port->listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (dl_port->listen_fd < 0) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d socket failed %d", __func__, __LINE__, errno);
+        return AR_EFAILED;
+    }
+    if (bind(dl_port->listen_fd, (struct sockaddr *)addr, addr_len) < 0) {
+        /*Lost the race against the peer, attach to its region instead*/
+        status = (errno == EADDRINUSE) ? AR_EALREADY : AR_EFAILED;
+        close(dl_port->listen_fd);
+        dl_port->listen_fd = -1;
+        return status;
+    }
+    if (listen(dl_port->listen_fd, 1) < 0) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d listen failed %d", __func__, __LINE__, errno);
+        return AR_EFAILED;
+    }
+
+    dl_port->mem_fd = (int)syscall(__NR_memfd_create, "gpr_lx_shm", 0);
+    if ((dl_port->mem_fd < 0) ||
+        (ftruncate(dl_port->mem_fd, sizeof(gpr_dl_lx_shm_region_t)) < 0)) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d memfd setup failed %d", __func__, __LINE__, errno);
+        return AR_ENOMEMORY;
+    }
+    dl_port->efd[0] = eventfd(0, EFD_CLOEXEC);
+    dl_port->efd[1] = eventfd(0, EFD_CLOEXEC);
+    if ((dl_port->efd[0] < 0) || (dl_port->efd[1] < 0)) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d eventfd failed %d", __func__, __LINE__, errno);
+        return AR_EFAILED;
+    }
+    return gpr_dl_lx_shm_map(dl_port, true);
+}
+
+/*Attaches to the region of an owner that is already listening*/
+static uint32_t gpr_dl_lx_shm_attach(gpr_dl_lx_shm_port_t *dl_port,
+                                     struct sockaddr_un *addr, socklen_t addr_len)
+{
+    int sock;
+    char dummy;
+    int fds[GPR_DL_LX_SHM_NUM_FDS];
+    char cbuf[CMSG_SPACE(sizeof(fds))];
+    struct iovec iov = { .iov_base = &dummy, .iov_len = 1 };
+    struct msghdr msg = { 0 };
+    struct cmsghdr *cmsg;
+    struct timeval tv = { .tv_sec = GPR_DL_LX_SHM_ATTACH_TIMEOUT_SEC };
+
+    sock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (sock < 0) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d socket failed %d", __func__, __LINE__, errno);
+        return AR_EFAILED;
+    }
+    if (connect(sock, (struct sockaddr *)addr, addr_len) < 0) {
+        close(sock);
+        return AR_ENOTEXIST;
+    }
+    if (!gpr_dl_lx_shm_peer_trusted(sock)) {
+        close(sock);
+        return AR_EFAILED;
+    }
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = cbuf;
+    msg.msg_controllen = sizeof(cbuf);
+    if (recvmsg(sock, &msg, MSG_CMSG_CLOEXEC) <= 0) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d no region from owner %d", __func__, __LINE__, errno);
+        close(sock);
+        return AR_EFAILED;
+    }
+    close(sock);
+
+    cmsg = CMSG_FIRSTHDR(&msg);
+    if ((cmsg == NULL) || (cmsg->cmsg_type != SCM_RIGHTS) ||
+        (cmsg->cmsg_len != CMSG_LEN(sizeof(fds)))) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d bad region message", __func__, __LINE__);
+        return AR_EFAILED;
+    }
+    memcpy(fds, CMSG_DATA(cmsg), sizeof(fds));
+    dl_port->mem_fd = fds[0];
+    dl_port->efd[0] = fds[1];
+    dl_port->efd[1] = fds[2];
+    return gpr_dl_lx_shm_map(dl_port, false);
+}
+
+/*Owner side, sends the region and doorbells to the peer once it connects*/
+static void gpr_dl_lx_shm_accept_peer(gpr_dl_lx_shm_port_t *dl_port)
+{
+    int sock;
+    char dummy = 0;
+    int fds[GPR_DL_LX_SHM_NUM_FDS] = { dl_port->mem_fd, dl_port->efd[0], dl_port->efd[1] };
+    char cbuf[CMSG_SPACE(sizeof(fds))];
+    struct iovec iov = { .iov_base = &dummy, .iov_len = 1 };
+    struct msghdr msg = { 0 };
+    struct cmsghdr *cmsg;
+
+    sock = accept(dl_port->listen_fd, NULL, NULL);
+    if (sock < 0) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d accept failed %d", __func__, __LINE__, errno);
+        return;
+    }
+    /*Keep listening, the expected peer may still connect*/
+    if (!gpr_dl_lx_shm_peer_trusted(sock)) {
+        close(sock);
+        return;
+    }
+
+    memset(cbuf, 0, sizeof(cbuf));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = cbuf;
+    msg.msg_controllen = sizeof(cbuf);
+    cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+    if (sendmsg(sock, &msg, MSG_NOSIGNAL) < 0) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d sending region failed %d", __func__, __LINE__, errno);
+        close(sock);
+        return;
+    }
+    close(sock);
+
+    AR_LOG_INFO(LOG_TAG,"%s:%d peer attached for domain id %d", __func__, __LINE__,
+            dl_port->domain_id);
+    close(dl_port->listen_fd);
+    dl_port->listen_fd = -1;
+}
+
+#define NUM_FDS 3
+
+static void *gpr_dl_lx_shm_receiver_loop(void *priv_data)
+{
+    gpr_dl_lx_shm_port_t *dl_port = (gpr_dl_lx_shm_port_t *)priv_data;
+    gpr_dl_lx_shm_ring_t *ring = dl_port->rx_ring;
+    struct pollfd pfd[NUM_FDS];
+    eventfd_t cnt;
+
+    pfd[0].fd = dl_port->rx_efd;
+    pfd[0].events = POLLIN;
+    pfd[1].fd = dl_port->exit_efd;
+    pfd[1].events = POLLIN;
+    pfd[2].fd = dl_port->listen_fd; /*negative fds are ignored by poll*/
+    pfd[2].events = POLLIN;
+
+    while (!dl_port->thread_exit) {
+        gpr_dl_lx_shm_drain(dl_port);
+
+        /*Ring of a dropped peer is not read anymore, only wait for exit*/
+        if (dl_port->peer_dropped) {
+            pfd[0].fd = -1;
+            pfd[2].fd = -1;
+            if ((poll(pfd, NUM_FDS, -1) < 0) && (errno == EINTR))
+                continue;
+            break;
+        }
+
+        /*
+         * Tell the producer we are about to sleep, then check once more so a
+         * packet published before the flag was seen is not missed.
+         */
+        __atomic_store_n(&ring->waiting, 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&ring->tail, __ATOMIC_RELAXED) != dl_port->rx_rd) {
+            __atomic_store_n(&ring->waiting, 0, __ATOMIC_RELAXED);
+            continue;
+        }
+
+        if (poll(pfd, NUM_FDS, -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            /*Poll errored out, treat it as a fatal error bail out*/
+            AR_LOG_ERR(LOG_TAG,"Poll failed error %s", strerror(errno));
+            break;
+        }
+        __atomic_store_n(&ring->waiting, 0, __ATOMIC_RELAXED);
+
+        if (pfd[0].revents & POLLIN)
+            eventfd_read(dl_port->rx_efd, &cnt);
+        if (pfd[2].revents & POLLIN) {
+            gpr_dl_lx_shm_accept_peer(dl_port);
+            pfd[2].fd = dl_port->listen_fd;
+        }
+        if (pfd[1].revents & POLLIN)
+            break;
+    }
+    AR_LOG_DEBUG(LOG_TAG,"%s:%d exiting receiver thread", __func__, __LINE__);
+    return NULL;
+}
+
+static void gpr_dl_lx_shm_port_free(gpr_dl_lx_shm_port_t *dl_port)
+{
+    if (dl_port->region)
+        munmap(dl_port->region, sizeof(gpr_dl_lx_shm_region_t));
+    if (dl_port->listen_fd >= 0)
+        close(dl_port->listen_fd);
+    if (dl_port->mem_fd >= 0)
+        close(dl_port->mem_fd);
+    if (dl_port->efd[0] >= 0)
+        close(dl_port->efd[0]);
+    if (dl_port->efd[1] >= 0)
+        close(dl_port->efd[1]);
+    if (dl_port->exit_efd >= 0)
+        close(dl_port->exit_efd);
+    pthread_mutex_destroy(&dl_port->tx_lock);
+    pthread_mutex_destroy(&dl_port->rx_lock);
+    free(dl_port);
+}
+
+static gpr_dl_lx_shm_port_t *gpr_dl_lx_shm_local_init(uint32_t src_domain_id, uint32_t dst_domain_id,
+                                                      const gpr_to_ipc_vtbl_t *p_gpr_to_ipc_vtbl,
+                                                      ipc_to_gpr_vtbl_t **pp_ipc_to_gpr_vtbl)
+{
+    gpr_dl_lx_shm_port_t *dl_port;
+    uint32_t status;
+    struct sockaddr_un addr;
+    socklen_t addr_len;
+    pthread_attr_t tattr;
+    struct sched_param param = { .sched_priority = 3 };
+
+    AR_LOG_INFO(LOG_TAG,"%s:%d port setup for src domain id %d and dst domain id %d",
+            __func__, __LINE__, src_domain_id, dst_domain_id);
+
+    if (gpr_dl_lx_shm_ports[dst_domain_id] != NULL){
+        AR_LOG_ERR(LOG_TAG,"%s:%d port already setup for domain id:%d", __func__, __LINE__,
+               dst_domain_id);
+        return gpr_dl_lx_shm_ports[dst_domain_id];
+    }
+    dl_port = (gpr_dl_lx_shm_port_t *)calloc(1, sizeof(gpr_dl_lx_shm_port_t));
+    if (dl_port == NULL){
+        AR_LOG_ERR(LOG_TAG,"%s:%d malloc failed", __func__, __LINE__);
+        return NULL;
+    }
+    dl_port->domain_id = dst_domain_id;
+    dl_port->thread_exit = false;
+    dl_port->mem_fd = -1;
+    dl_port->efd[0] = -1;
+    dl_port->efd[1] = -1;
+    dl_port->listen_fd = -1;
+    pthread_mutex_init(&dl_port->tx_lock, (const pthread_mutexattr_t *) NULL);
+    pthread_mutex_init(&dl_port->rx_lock, (const pthread_mutexattr_t *) NULL);
+
+    dl_port->exit_efd = eventfd(0, EFD_CLOEXEC);
+    if (dl_port->exit_efd < 0) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d eventfd failed %d", __func__, __LINE__, errno);
+        goto error;
+    }
+
+    addr_len = gpr_dl_lx_shm_sock_addr(&addr, src_domain_id, dst_domain_id);
+    status = gpr_dl_lx_shm_attach(dl_port, &addr, addr_len);
+    if (status == AR_ENOTEXIST) {
+        status = gpr_dl_lx_shm_own(dl_port, &addr, addr_len);
+        if (status == AR_EALREADY)
+            status = gpr_dl_lx_shm_attach(dl_port, &addr, addr_len);
+    }
+    if (status) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d region setup failed %d", __func__, __LINE__, status);
+        goto error;
+    }
+
+    /*
+     * The ring may already hold packets from the peer, so everything gpr needs
+     * to receive and return them is in place before the receiver starts.
+     */
+    dl_port->rx_cb = p_gpr_to_ipc_vtbl->receive;
+    dl_port->send_done = p_gpr_to_ipc_vtbl->send_done;
+    *pp_ipc_to_gpr_vtbl = &gpr_dl_lx_shm_vtbl;
+    gpr_dl_lx_shm_ports[dst_domain_id] = dl_port;
+
+    pthread_attr_init (&tattr);
+    pthread_attr_setschedparam (&tattr, &param);
+    pthread_attr_setschedpolicy(&tattr, SCHED_FIFO);
+    status = pthread_create(&dl_port->receiver_thread, &tattr,
+                    gpr_dl_lx_shm_receiver_loop, dl_port);
+    pthread_attr_destroy(&tattr);
+    if (status) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d error:%d pthread_create fail", __func__, __LINE__, status);
+        gpr_dl_lx_shm_ports[dst_domain_id] = NULL;
+        goto error;
+    }
+    return dl_port;
+error:
+    gpr_dl_lx_shm_port_free(dl_port);
+    return NULL;
+}
+
+static uint32_t gpr_dl_lx_shm_local_deinit(uint32_t src_domain_id, uint32_t dst_domain_id)
+{
+    uint32_t status = AR_EOK;
+    gpr_dl_lx_shm_port_t *dl_port;
+
+    if (gpr_dl_lx_shm_ports[dst_domain_id] == NULL) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d deinit already done", __func__, __LINE__);
+        return AR_EOK;
+    }
+    dl_port = gpr_dl_lx_shm_ports[dst_domain_id];
+    gpr_dl_lx_shm_ports[dst_domain_id] = NULL;
+
+    dl_port->thread_exit = true;
+    if (eventfd_write(dl_port->exit_efd, 1) < 0) {
+        /* proceed regardless with a error print */
+        AR_LOG_ERR(LOG_TAG,"%s:%d exit doorbell failed %d", __func__, __LINE__, errno);
+    }
+    status = pthread_join(dl_port->receiver_thread, NULL);
+    if (status){
+        AR_LOG_ERR(LOG_TAG,"%s:%d pthread_join failed", __func__, __LINE__);
+    }
+    gpr_dl_lx_shm_port_free(dl_port);
+    return status;
+}
+
+uint32_t ipc_dl_lx_shm_init(uint32_t src_domain_id,
+                            uint32_t dest_domain_id,
+                            const gpr_to_ipc_vtbl_t *p_gpr_to_ipc_vtbl,
+                            ipc_to_gpr_vtbl_t ** pp_ipc_to_gpr_vtbl)
+{
+    gpr_dl_lx_shm_port_t *dl_port;
+
+    if ((dest_domain_id >= GPR_PL_NUM_TOTAL_DOMAINS_V)
+        || (src_domain_id >= GPR_PL_NUM_TOTAL_DOMAINS_V)) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d invalid domain(src domain id %d, dst domain id %d)",
+                __func__, __LINE__, src_domain_id, dest_domain_id);
+        return AR_EBADPARAM;
+    }
+    if (!p_gpr_to_ipc_vtbl->receive || !p_gpr_to_ipc_vtbl->send_done) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d no gpr cbs error out", __func__, __LINE__);
+        return AR_EBADPARAM;
+    }
+
+    dl_port = gpr_dl_lx_shm_local_init(src_domain_id, dest_domain_id,
+                                       p_gpr_to_ipc_vtbl, pp_ipc_to_gpr_vtbl);
+    if (dl_port == NULL) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d local_init failed", __func__, __LINE__);
+        return AR_EFAILED;
+    }
+    return AR_EOK;
+}
+
+uint32_t ipc_dl_lx_shm_deinit(uint32_t src_domain_id, uint32_t dest_domain_id)
+{
+    if (dest_domain_id >= GPR_PL_NUM_TOTAL_DOMAINS_V)
+        return AR_EBADPARAM;
+    return gpr_dl_lx_shm_local_deinit(src_domain_id, dest_domain_id);
+}
+
+static uint32_t gpr_dl_lx_shm_send(uint32_t domain_id, void *buf, uint32_t size)
+{
+    uint32_t status;
+    gpr_dl_lx_shm_port_t *dl_port;
+    gpr_dl_lx_shm_ring_t *ring;
+
+    if ((domain_id >= GPR_PL_NUM_TOTAL_DOMAINS_V) ||
+        ((dl_port = gpr_dl_lx_shm_ports[domain_id]) == NULL)) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d port domain %d not initialized", __func__, __LINE__,
+              domain_id);
+        return AR_ENOTEXIST;
+    }
+    if (__atomic_load_n(&dl_port->peer_dropped, __ATOMIC_ACQUIRE)) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d peer of domain %d dropped", __func__, __LINE__, domain_id);
+        return AR_EFAILED;
+    }
+    if (size > GPR_DL_LX_SHM_MAX_PKT_SIZE) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d packet size %d too large", __func__, __LINE__, size);
+        return AR_EBADPARAM;
+    }
+    ring = dl_port->tx_ring;
+
+    pthread_mutex_lock(&dl_port->tx_lock);
+    status = gpr_dl_lx_shm_ring_write(ring, buf, size);
+    pthread_mutex_unlock(&dl_port->tx_lock);
+    if (status != AR_EOK) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d ring full for domain %d", __func__, __LINE__, domain_id);
+        return status;
+    }
+
+    /*Only wake the receiver if it is about to sleep, a busy one picks the packet up anyway*/
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ring->waiting, __ATOMIC_RELAXED))
+        eventfd_write(dl_port->tx_efd, 1);
+
+    dl_port->send_done(buf, size);
+    return AR_EOK;
+}
+
+static uint32_t gpr_dl_lx_shm_receive_done(uint32_t domain_id, void *buf)
+{
+    gpr_dl_lx_shm_port_t *dl_port;
+    uint8_t *data;
+
+    if ((domain_id >= GPR_PL_NUM_TOTAL_DOMAINS_V) ||
+        ((dl_port = gpr_dl_lx_shm_ports[domain_id]) == NULL)) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d port domain %d not initialized", __func__, __LINE__,
+              domain_id);
+        return AR_ENOTEXIST;
+    }
+    data = dl_port->rx_ring->data;
+    if (((uint8_t *)buf < data + sizeof(gpr_dl_lx_shm_rec_t)) ||
+        ((uint8_t *)buf >= data + GPR_DL_LX_SHM_RING_SIZE)) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d buffer not from ring", __func__, __LINE__);
+        return AR_EBADPARAM;
+    }
+    return gpr_dl_lx_shm_release(dl_port, (gpr_dl_lx_shm_rec_t *)buf - 1);
+}
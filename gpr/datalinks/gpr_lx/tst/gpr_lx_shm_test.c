@@ -0,0 +1,205 @@
+/*
+ * gpr_lx_shm_test.c
+ *
+ * Loopback test of the shared memory ring GPR datalink. Both ends of the
+ * link are set up in this process, the ADSP end owns the region and the APPS
+ * end attaches to it. The datalink source is included so that the test can
+ * write a corrupt record into the ring the way a faulty peer would.
+ *
+ * Copyright (c) Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+#include "../src/gpr_lx_shm.c"
+#include "gpr_lx_shm_test.h"
+
+#define TEST_NUM_PKTS 20000
+#define TEST_NUM_HELD 16
+#define TEST_WAIT_MS 2000
+
+/*Packets travel from the ADSP end (ports[APPS]) to the APPS end (ports[ADSP])*/
+#define TEST_TX_DOMAIN GPR_IDS_DOMAIN_ID_APPS_V
+#define TEST_RX_DOMAIN GPR_IDS_DOMAIN_ID_ADSP_V
+
+static ipc_to_gpr_vtbl_t *tx_vtbl;
+static ipc_to_gpr_vtbl_t *rx_vtbl;
+static volatile uint32_t rx_cnt;
+static volatile uint32_t rx_bad;
+static void *held[TEST_NUM_HELD];
+static uint32_t num_held;
+
+static uint32_t test_pkt_len(uint32_t n)
+{
+    return 8 + 4 * ((n * 7919) % 1000);
+}
+
+/*Checks order and payload, returns every fourth packet late and in reverse order*/
+static uint32_t test_rx_cb(void *ptr, uint32_t length)
+{
+    uint32_t *w = (uint32_t *)ptr;
+    uint32_t i;
+
+    if ((length != test_pkt_len(rx_cnt)) || (w[0] != length) || (w[1] != rx_cnt))
+        rx_bad++;
+    for (i = 2; i < length / 4; i++) {
+        if (w[i] != w[1] + i) {
+            rx_bad++;
+            break;
+        }
+    }
+    rx_cnt++;
+
+    if (((rx_cnt & 3) == 0) && (num_held < TEST_NUM_HELD)) {
+        held[num_held++] = ptr;
+    } else if (rx_vtbl->receive_done(TEST_RX_DOMAIN, ptr) != AR_EOK) {
+        rx_bad++;
+    }
+    if (num_held == TEST_NUM_HELD) {
+        while (num_held)
+            rx_vtbl->receive_done(TEST_RX_DOMAIN, held[--num_held]);
+    }
+    return AR_EOK;
+}
+
+static uint32_t test_unexpected_rx_cb(void *ptr, uint32_t length)
+{
+    rx_bad++;
+    return AR_EOK;
+}
+
+static uint32_t test_send_done(void *ptr, uint32_t length)
+{
+    return AR_EOK;
+}
+
+static bool test_wait(volatile uint32_t *val, uint32_t expected)
+{
+    for (uint32_t ms = 0; (*val != expected) && (ms < TEST_WAIT_MS); ms++)
+        usleep(1000);
+    return (*val == expected);
+}
+
+/*Every packet arrives once, in order and intact, although returned out of order*/
+static uint32_t test_loopback(void)
+{
+    uint32_t buf[1024];
+    uint32_t n, i, len;
+
+    for (n = 0; n < TEST_NUM_PKTS;) {
+        len = test_pkt_len(n);
+        buf[0] = len;
+        buf[1] = n;
+        for (i = 2; i < len / 4; i++)
+            buf[i] = n + i;
+        if (tx_vtbl->send(TEST_TX_DOMAIN, buf, len) == AR_EOK)
+            n++;
+        else
+            usleep(10);
+    }
+    if (!test_wait(&rx_cnt, TEST_NUM_PKTS) || rx_bad) {
+        AR_LOG_ERR(LOG_TAG,"loopback: received %u of %u, %u bad", rx_cnt, TEST_NUM_PKTS, rx_bad);
+        return AR_EFAILED;
+    }
+    while (num_held)
+        rx_vtbl->receive_done(TEST_RX_DOMAIN, held[--num_held]);
+
+    /*All returned, so the receiver has reclaimed everything*/
+    if (gpr_dl_lx_shm_ports[TEST_TX_DOMAIN]->tx_ring->head !=
+        gpr_dl_lx_shm_ports[TEST_TX_DOMAIN]->tx_ring->tail) {
+        AR_LOG_ERR(LOG_TAG,"loopback: ring space not reclaimed");
+        return AR_EFAILED;
+    }
+    return AR_EOK;
+}
+
+/*Writes a record with the given header at the tail, as a faulty peer would*/
+static void test_write_bad_rec(uint32_t size, uint32_t flags, uint32_t adv)
+{
+    gpr_dl_lx_shm_port_t *port = gpr_dl_lx_shm_ports[TEST_TX_DOMAIN];
+    gpr_dl_lx_shm_ring_t *ring = port->tx_ring;
+    gpr_dl_lx_shm_rec_t *rec;
+
+    pthread_mutex_lock(&port->tx_lock);
+    rec = (gpr_dl_lx_shm_rec_t *)&ring->data[ring->tail & GPR_DL_LX_SHM_RING_MASK];
+    rec->size = size;
+    rec->flags = flags;
+    __atomic_store_n(&ring->tail, ring->tail + adv, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&port->tx_lock);
+    eventfd_write(port->tx_efd, 1);
+}
+
+static uint32_t test_setup(gpr_to_ipc_vtbl_t *rx_cbs)
+{
+    static gpr_to_ipc_vtbl_t tx_cbs = { test_unexpected_rx_cb, test_send_done };
+
+    rx_cnt = 0;
+    rx_bad = 0;
+    num_held = 0;
+    if ((ipc_dl_lx_shm_init(TEST_RX_DOMAIN, TEST_TX_DOMAIN, &tx_cbs, &tx_vtbl) != AR_EOK) ||
+        (ipc_dl_lx_shm_init(TEST_TX_DOMAIN, TEST_RX_DOMAIN, rx_cbs, &rx_vtbl) != AR_EOK)) {
+        AR_LOG_ERR(LOG_TAG,"setup: datalink init failed");
+        return AR_EFAILED;
+    }
+    return AR_EOK;
+}
+
+static void test_teardown(void)
+{
+    ipc_dl_lx_shm_deinit(TEST_RX_DOMAIN, TEST_TX_DOMAIN);
+    ipc_dl_lx_shm_deinit(TEST_TX_DOMAIN, TEST_RX_DOMAIN);
+}
+
+/*
+ * A record whose size runs past the ring, past the published tail or above
+ * the maximum packet size gets the peer dropped without reaching gpr.
+ */
+static uint32_t test_bad_record(uint32_t size, uint32_t flags, uint32_t adv)
+{
+    static gpr_to_ipc_vtbl_t rx_cbs = { test_unexpected_rx_cb, test_send_done };
+    volatile uint32_t dropped = 0;
+    uint32_t status = AR_EOK;
+
+    if (test_setup(&rx_cbs) != AR_EOK)
+        return AR_EFAILED;
+
+    test_write_bad_rec(size, flags, adv);
+    for (uint32_t ms = 0; !dropped && (ms < TEST_WAIT_MS); ms++) {
+        dropped = __atomic_load_n(&gpr_dl_lx_shm_ports[TEST_RX_DOMAIN]->peer_dropped, __ATOMIC_ACQUIRE);
+        usleep(1000);
+    }
+    if (!dropped || rx_bad || (rx_vtbl->send(TEST_RX_DOMAIN, &size, sizeof(size)) == AR_EOK)) {
+        AR_LOG_ERR(LOG_TAG,"bad record size %u flags %u: dropped %u rx_bad %u", size, flags, dropped, rx_bad);
+        status = AR_EFAILED;
+    }
+    test_teardown();
+    return status;
+}
+
+uint32_t gpr_lx_shm_test(void)
+{
+    static gpr_to_ipc_vtbl_t rx_cbs = { test_rx_cb, test_send_done };
+    uint32_t status = AR_EOK;
+    uint32_t rec_hdr = sizeof(gpr_dl_lx_shm_rec_t);
+
+    if (test_setup(&rx_cbs) != AR_EOK)
+        return AR_EFAILED;
+    status |= test_loopback();
+    test_teardown();
+
+    /*size wraps the record length*/
+    status |= test_bad_record(0xFFFFFFF8, 0, 64);
+    /*size runs past the end of the ring*/
+    status |= test_bad_record(GPR_DL_LX_SHM_RING_SIZE, 0, 64);
+    /*size above the maximum packet size*/
+    status |= test_bad_record(GPR_DL_LX_SHM_MAX_PKT_SIZE + 8, 0, GPR_DL_LX_SHM_MAX_PKT_SIZE + 8 + rec_hdr);
+    /*size runs past the published tail*/
+    status |= test_bad_record(256, 0, 64);
+    /*padding that does not end at the end of the ring*/
+    status |= test_bad_record(64, GPR_DL_LX_SHM_REC_PAD, 64 + rec_hdr);
+    /*peer may not mark its own records returned*/
+    status |= test_bad_record(8, GPR_DL_LX_SHM_REC_DONE, 8 + rec_hdr);
+    /*tail more than a ring ahead*/
+    status |= test_bad_record(8, 0, GPR_DL_LX_SHM_RING_SIZE + 64);
+
+    AR_LOG_INFO(LOG_TAG,"gpr_lx_shm tests %s", (status == AR_EOK) ? "passed" : "FAILED");
+    return status;
+}
@@ -0,0 +1,17 @@
+/*
+ * gpr_lx_shm_test.h
+ *
+ * Loopback test of the shared memory ring GPR datalink.
+ *
+ * Copyright (c) Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+#ifndef GPR_LX_SHM_TEST_H
+#define GPR_LX_SHM_TEST_H
+
+#include <stdint.h>
+
+/*Runs the loopback tests in the calling process, returns AR_EOK on success*/
+uint32_t gpr_lx_shm_test(void);
+
+#endif /* GPR_LX_SHM_TEST_H */
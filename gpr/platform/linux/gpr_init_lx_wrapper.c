@@ -10,6 +10,7 @@
 #include <errno.h>
 #include "gpr_api_i.h"
 #include "gpr_lx.h"
+#include "gpr_lx_shm.h"
 #include <unistd.h>
 
 #ifdef GPR_USE_CUTILS
@@ -27,6 +28,16 @@
 #endif
 #endif
 
+/* Build with GPR_LX_SHM_DATALINK to talk to remote domains over the shared
+memory ring datalink instead of the pass-through character drivers */
+#ifdef GPR_LX_SHM_DATALINK
+#define GPR_LX_DL_INIT_FN ipc_dl_lx_shm_init
+#define GPR_LX_DL_DEINIT_FN ipc_dl_lx_shm_deinit
+#else
+#define GPR_LX_DL_INIT_FN ipc_dl_lx_init
+#define GPR_LX_DL_DEINIT_FN ipc_dl_lx_deinit
+#endif
+
 #define GPR_NUM_PACKETS_TYPE 3
 
 #define GPR_NUM_PACKETS_1 ( 100 )
@@ -69,6 +80,10 @@ GPR_INTERNAL void update_gpr_ipc_table(char *drv_path, uint16_t domain_id,
 {
    int fd = 0;
 
+#ifdef GPR_LX_SHM_DATALINK
+   /* No driver node is needed, the ring is set up with the peer process */
+   drv_path = NULL;
+#endif
    if (drv_path != NULL) {
        fd = access(drv_path, F_OK);
        if (fd == -1) {
@@ -80,8 +95,8 @@ GPR_INTERNAL void update_gpr_ipc_table(char *drv_path, uint16_t domain_id,
    ALOGD("%s:%d num_dom %d %d\n", __func__, __LINE__, num_domains, domain_id);
 
    gpr_lx_ipc_dl_table[num_domains].domain_id = domain_id;
-   gpr_lx_ipc_dl_table[num_domains].init_fn = ipc_dl_lx_init;
-   gpr_lx_ipc_dl_table[num_domains].deinit_fn = ipc_dl_lx_deinit;
+   gpr_lx_ipc_dl_table[num_domains].init_fn = GPR_LX_DL_INIT_FN;
+   gpr_lx_ipc_dl_table[num_domains].deinit_fn = GPR_LX_DL_DEINIT_FN;
    gpr_lx_ipc_dl_table[num_domains].supports_shared_mem = supp_shared_mem;
 
    num_domains++;
@@ -25,6 +25,7 @@ LOCAL_SRC_FILES := \
     src/divide_qx_island.c \
     src/crossfade.c \
     src/iir_tdf2.c \
+    src/biquad_cascade.c \
     src/buffer_converter.c \
     src/audio_buffer.cpp \
     src/audio_buffer32.c \
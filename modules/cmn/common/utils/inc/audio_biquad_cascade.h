@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+/**
+@file audio_biquad_cascade.h
+
+This file contains the multichannel biquad cascade function definitions.
+*/
+
+#ifndef _AUDIO_BIQUAD_CASCADE_H_
+#define _AUDIO_BIQUAD_CASCADE_H_
+
+#include "posal_types.h"
+
+/*=============================================================================
+      Constants
+=============================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* Number of channels filtered together in the SIMD lanes of one group */
+#define BIQUAD_CASCADE_LANES 4
+
+/*=============================================================================
+      Typedefs
+=============================================================================*/
+
+/** Cascade of TDF2 biquads applied to one channel.
+
+  The stages are laid out as an array of structures, coefs_ptr, mem_ptr and
+  shiftn_ptr point into the first stage and advance by stage_stride bytes per
+  stage. Every stage has the numerics of iirTDF2_16() / iirTDF2_32(), which is
+  called with the stage coefficients, states and shifts.
+*/
+typedef struct biquad_cascade_ch_t
+{
+   void  *in_ptr;       /**< Input samples, may be equal to out_ptr. */
+   void  *out_ptr;      /**< Output samples. */
+   int32 *coefs_ptr;    /**< b0, b1, b2, a1, a2 of the first stage. */
+   int64 *mem_ptr;      /**< w1, w2 of the first stage. */
+   int16 *shiftn_ptr;   /**< Numerator shift of the first stage. */
+   uint32 stage_stride; /**< Bytes from one stage to the next. */
+   int32  num_stages;   /**< Number of stages, 0 copies input to output. */
+   int16  shiftd;       /**< Denominator shift of all stages. */
+} biquad_cascade_ch_t;
+
+/*=============================================================================
+      Function Declarations
+=============================================================================*/
+
+/** @addtogroup dsp_algorithms
+@{ */
+
+/**
+  Filters 16 bit channels through their biquad cascades.
+
+  Up to BIQUAD_CASCADE_LANES channels are filtered at once in SIMD lanes and
+  all stages of a channel are applied per sample in a single pass over the
+  samples. The output is bit-exact with calling iirTDF2_16() stage by stage.
+  On Hexagon the channels are filtered stage by stage with iirTDF2_16().
+
+  @param[in,out] ch_ptr    Array of channel cascades, states are updated.
+  @param[in]     num_chs   Number of channels.
+  @param[in]     samples   Number of samples per channel.
+
+  @return
+  None.
+
+  @dependencies
+  None.
+*/
+void biquad_cascade_16(biquad_cascade_ch_t *ch_ptr, uint32 num_chs, int32 samples);
+
+/**
+  Filters 32 bit channels through their biquad cascades.
+
+  Same as biquad_cascade_16() with the numerics of iirTDF2_32().
+
+  @param[in,out] ch_ptr    Array of channel cascades, states are updated.
+  @param[in]     num_chs   Number of channels.
+  @param[in]     samples   Number of samples per channel.
+
+  @return
+  None.
+
+  @dependencies
+  None.
+*/
+void biquad_cascade_32(biquad_cascade_ch_t *ch_ptr, uint32 num_chs, int32 samples);
+
+/** @} */ /* end_addtogroup dsp_algorithms */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* _AUDIO_BIQUAD_CASCADE_H_ */
@@ -0,0 +1,550 @@
+/*
+ * Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+/* Multichannel cascade of TDF2 biquads.                                     */
+/*                                                                            */
+/* Channels are filtered in groups of BIQUAD_CASCADE_LANES, one channel per  */
+/* SIMD lane. The stages of a group are packed lane by lane and all of them  */
+/* are run per sample, so the recursions of the stages overlap and every     */
+/* sample block is read and written once per BQC_MAX_STAGES stages. Each     */
+/* stage computes exactly what the generic iirTDF2_16 / iirTDF2_32 does,     */
+/* with per lane shifts and stage counts.                                    */
+#include "audio_biquad_cascade.h"
+#include "audio_iir_tdf2.h"
+#include "audio_basic_op.h"
+#include "ar_defs.h"
+#include <stringl.h>
+
+#if !((defined __hexagon__) || (defined __qdsp6__))
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#define BQC_NEON
+#elif defined(__x86_64__)
+#include <immintrin.h>
+#define BQC_AVX2
+#define BQC_TGT_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+#define BQC_BLOCK_SIZE 16 // samples transposed into the lanes at a time
+#define BQC_MAX_STAGES 4  // stages packed into the lanes at a time, keeps the stack near 2 KB
+
+/*----------------------------------------------------------------------------
+ * Stage by stage reference, used on Hexagon and for channels not fit for the lanes
+ * -------------------------------------------------------------------------*/
+static inline int32 *bqc_coefs(const biquad_cascade_ch_t *ch_ptr, int32 stage)
+{
+   return (int32 *)((int8 *)ch_ptr->coefs_ptr + stage * ch_ptr->stage_stride);
+}
+
+static inline int64 *bqc_mem(const biquad_cascade_ch_t *ch_ptr, int32 stage)
+{
+   return (int64 *)((int8 *)ch_ptr->mem_ptr + stage * ch_ptr->stage_stride);
+}
+
+static inline int16 bqc_shiftn(const biquad_cascade_ch_t *ch_ptr, int32 stage)
+{
+   return *(int16 *)((int8 *)ch_ptr->shiftn_ptr + stage * ch_ptr->stage_stride);
+}
+
+static void bqc_ch_16(const biquad_cascade_ch_t *ch_ptr, int32 samples)
+{
+   int16 *in_ptr  = (int16 *)ch_ptr->in_ptr;
+   int16 *out_ptr = (int16 *)ch_ptr->out_ptr;
+   int32  s;
+
+   if (ch_ptr->num_stages <= 0)
+   {
+      if (in_ptr != out_ptr)
+      {
+         memscpy(out_ptr, samples * sizeof(int16), in_ptr, samples * sizeof(int16));
+      }
+      return;
+   }
+   for (s = 0; s < ch_ptr->num_stages; s++)
+   {
+      int32 *coefs_ptr = bqc_coefs(ch_ptr, s);
+      iirTDF2_16(in_ptr,
+                 out_ptr,
+                 samples,
+                 coefs_ptr,
+                 coefs_ptr + 3,
+                 bqc_mem(ch_ptr, s),
+                 bqc_shiftn(ch_ptr, s),
+                 ch_ptr->shiftd);
+      in_ptr = out_ptr;
+   }
+}
+
+static void bqc_ch_32(const biquad_cascade_ch_t *ch_ptr, int32 samples)
+{
+   int32 *in_ptr  = (int32 *)ch_ptr->in_ptr;
+   int32 *out_ptr = (int32 *)ch_ptr->out_ptr;
+   int32  s;
+
+   if (ch_ptr->num_stages <= 0)
+   {
+      if (in_ptr != out_ptr)
+      {
+         memscpy(out_ptr, samples * sizeof(int32), in_ptr, samples * sizeof(int32));
+      }
+      return;
+   }
+   for (s = 0; s < ch_ptr->num_stages; s++)
+   {
+      int32 *coefs_ptr = bqc_coefs(ch_ptr, s);
+      iirTDF2_32(in_ptr,
+                 out_ptr,
+                 samples,
+                 coefs_ptr,
+                 coefs_ptr + 3,
+                 bqc_mem(ch_ptr, s),
+                 bqc_shiftn(ch_ptr, s),
+                 ch_ptr->shiftd);
+      in_ptr = out_ptr;
+   }
+}
+
+#if defined(BQC_NEON) || defined(BQC_AVX2)
+/*----------------------------------------------------------------------------
+ * Lane parallel cascade
+ * -------------------------------------------------------------------------*/
+/* Right shift counts of one stage, see the generic iirTDF2_16 / iirTDF2_32:
+   b*x     >> x
+   y + p5  >> y, p5 = 1 << (y - 1)
+   a*yS    >> a                                                              */
+typedef struct bqc_shifts_t
+{
+   int32 x;
+   int32 y;
+   int32 a;
+} bqc_shifts_t;
+
+static bool_t bqc_get_shifts(int16 shiftn, int16 shiftd, bool_t is_16, bqc_shifts_t *sh_ptr)
+{
+   int32 diff      = shiftn - shiftd;
+   int32 max_shift = (shiftn < shiftd) ? shiftd : shiftn;
+
+   sh_ptr->x = 4 - ((diff < 0) ? diff : 0);
+   sh_ptr->a = ((diff > 0) ? diff : 0) + (is_16 ? (20 - GUARD_BITS_16) : 4);
+   sh_ptr->y = is_16 ? (12 + GUARD_BITS_16 - max_shift) : (28 - max_shift);
+
+   // the lanes only shift right, left shifts of y are left to the reference
+   return ((sh_ptr->y >= 1) && (sh_ptr->y < 63) && (sh_ptr->x < 63) && (sh_ptr->a < 63));
+}
+
+static bool_t bqc_fits_lanes(const biquad_cascade_ch_t *ch_ptr, bool_t is_16)
+{
+   bqc_shifts_t sh;
+   int32        s;
+
+   if (ch_ptr->num_stages <= 0)
+   {
+      return FALSE;
+   }
+   for (s = 0; s < ch_ptr->num_stages; s++)
+   {
+      if (!bqc_get_shifts(bqc_shiftn(ch_ptr, s), ch_ptr->shiftd, is_16, &sh))
+      {
+         return FALSE;
+      }
+   }
+   return TRUE;
+}
+
+#if defined(BQC_NEON)
+/*----------------------------------------------------------------------------
+ * AArch64 NEON, two 64 bit lanes per vector
+ * -------------------------------------------------------------------------*/
+typedef int32 bqc_lane_t;
+
+typedef struct bqc_stage_t
+{
+   int32  b0[BIQUAD_CASCADE_LANES];
+   int32  b1[BIQUAD_CASCADE_LANES];
+   int32  b2[BIQUAD_CASCADE_LANES];
+   int32  a1[BIQUAD_CASCADE_LANES];
+   int32  a2[BIQUAD_CASCADE_LANES];
+   int64  shx[BIQUAD_CASCADE_LANES]; // negative, vshl shifts right arithmetically
+   int64  shy[BIQUAD_CASCADE_LANES];
+   int64  sha[BIQUAD_CASCADE_LANES];
+   int64  round[BIQUAD_CASCADE_LANES];
+   uint32 active[BIQUAD_CASCADE_LANES];
+   int64  w1[BIQUAD_CASCADE_LANES];
+   int64  w2[BIQUAD_CASCADE_LANES];
+} bqc_stage_t;
+
+static inline bool_t bqc_has_simd(void)
+{
+   return TRUE;
+}
+
+static void bqc_pack_lane(bqc_stage_t *st_ptr, uint32 l, const int32 *coefs_ptr, const int64 *mem_ptr, const bqc_shifts_t *sh_ptr)
+{
+   st_ptr->b0[l]     = coefs_ptr[0];
+   st_ptr->b1[l]     = coefs_ptr[1];
+   st_ptr->b2[l]     = coefs_ptr[2];
+   st_ptr->a1[l]     = coefs_ptr[3];
+   st_ptr->a2[l]     = coefs_ptr[4];
+   st_ptr->shx[l]    = -sh_ptr->x;
+   st_ptr->shy[l]    = -sh_ptr->y;
+   st_ptr->sha[l]    = -sh_ptr->a;
+   st_ptr->round[l]  = (int64)1 << (sh_ptr->y - 1);
+   st_ptr->active[l] = 0xFFFFFFFF;
+   st_ptr->w1[l]     = mem_ptr[0];
+   st_ptr->w2[l]     = mem_ptr[1];
+}
+
+static void bqc_run(bqc_stage_t *st_ptr, int32 num_stages, bqc_lane_t *x_buf, int32 samples, bool_t is_16)
+{
+   int32 i, s;
+   for (i = 0; i < samples; i++)
+   {
+      int32x4_t x = vld1q_s32(x_buf + i * BIQUAD_CASCADE_LANES);
+      for (s = 0; s < num_stages; s++)
+      {
+         bqc_stage_t *p = st_ptr + s;
+         int32x4_t    b0 = vld1q_s32(p->b0), b1 = vld1q_s32(p->b1), b2 = vld1q_s32(p->b2);
+         int32x4_t    a1 = vld1q_s32(p->a1), a2 = vld1q_s32(p->a2);
+         int64x2_t    shx_lo = vld1q_s64(p->shx), shx_hi = vld1q_s64(p->shx + 2);
+         int64x2_t    sha_lo = vld1q_s64(p->sha), sha_hi = vld1q_s64(p->sha + 2);
+         int64x2_t    y_lo, y_hi, w1_lo, w1_hi, w2_lo, w2_hi;
+         int32x4_t    ys, xo;
+
+         // y = b0*x + w1, yS = sat32((y + p5) >> shiftY)
+         y_lo = vaddq_s64(vshlq_s64(vmull_s32(vget_low_s32(b0), vget_low_s32(x)), shx_lo), vld1q_s64(p->w1));
+         y_hi = vaddq_s64(vshlq_s64(vmull_high_s32(b0, x), shx_hi), vld1q_s64(p->w1 + 2));
+         y_lo = vshlq_s64(vaddq_s64(y_lo, vld1q_s64(p->round)), vld1q_s64(p->shy));
+         y_hi = vshlq_s64(vaddq_s64(y_hi, vld1q_s64(p->round + 2)), vld1q_s64(p->shy + 2));
+         ys   = vcombine_s32(vqmovn_s64(y_lo), vqmovn_s64(y_hi));
+
+         // w1 = b1*x - a1*yS + w2
+         w1_lo = vsubq_s64(vshlq_s64(vmull_s32(vget_low_s32(b1), vget_low_s32(x)), shx_lo),
+                           vshlq_s64(vmull_s32(vget_low_s32(a1), vget_low_s32(ys)), sha_lo));
+         w1_hi = vsubq_s64(vshlq_s64(vmull_high_s32(b1, x), shx_hi), vshlq_s64(vmull_high_s32(a1, ys), sha_hi));
+         w1_lo = vaddq_s64(w1_lo, vld1q_s64(p->w2));
+         w1_hi = vaddq_s64(w1_hi, vld1q_s64(p->w2 + 2));
+
+         // w2 = b2*x - a2*yS
+         w2_lo = vsubq_s64(vshlq_s64(vmull_s32(vget_low_s32(b2), vget_low_s32(x)), shx_lo),
+                           vshlq_s64(vmull_s32(vget_low_s32(a2), vget_low_s32(ys)), sha_lo));
+         w2_hi = vsubq_s64(vshlq_s64(vmull_high_s32(b2, x), shx_hi), vshlq_s64(vmull_high_s32(a2, ys), sha_hi));
+
+         vst1q_s64(p->w1, w1_lo);
+         vst1q_s64(p->w1 + 2, w1_hi);
+         vst1q_s64(p->w2, w2_lo);
+         vst1q_s64(p->w2 + 2, w2_hi);
+
+         if (is_16)
+         {
+            // sat16(sat32(yS + 0x1000) >> 13)
+            xo = vmovl_s16(vqmovn_s32(vshrq_n_s32(vqaddq_s32(ys, vdupq_n_s32(0x1000)), 16 - GUARD_BITS_16)));
+         }
+         else
+         {
+            xo = ys;
+         }
+         // lanes past their last stage pass the input through
+         x = vbslq_s32(vld1q_u32(p->active), xo, x);
+      }
+      vst1q_s32(x_buf + i * BIQUAD_CASCADE_LANES, x);
+   }
+}
+
+#else // BQC_NEON
+/*----------------------------------------------------------------------------
+ * x86-64 AVX2, four 64 bit lanes per vector, selected at runtime
+ * -------------------------------------------------------------------------*/
+typedef int64 bqc_lane_t;
+
+typedef struct bqc_stage_t
+{
+   int64 b0[BIQUAD_CASCADE_LANES]; // _mm256_mul_epi32 uses the low 32 bits of each lane
+   int64 b1[BIQUAD_CASCADE_LANES];
+   int64 b2[BIQUAD_CASCADE_LANES];
+   int64 a1[BIQUAD_CASCADE_LANES];
+   int64 a2[BIQUAD_CASCADE_LANES];
+   int64 rsx[BIQUAD_CASCADE_LANES];
+   int64 rsy[BIQUAD_CASCADE_LANES];
+   int64 rsa[BIQUAD_CASCADE_LANES];
+   int64 round[BIQUAD_CASCADE_LANES];
+   int64 active[BIQUAD_CASCADE_LANES];
+   int64 w1[BIQUAD_CASCADE_LANES];
+   int64 w2[BIQUAD_CASCADE_LANES];
+} bqc_stage_t;
+
+static bool_t bqc_has_simd(void)
+{
+   static int32 has_avx2 = -1;
+   if (has_avx2 < 0)
+   {
+      __builtin_cpu_init();
+      has_avx2 = __builtin_cpu_supports("avx2") ? 1 : 0;
+   }
+   return (bool_t)has_avx2;
+}
+
+static void bqc_pack_lane(bqc_stage_t *st_ptr, uint32 l, const int32 *coefs_ptr, const int64 *mem_ptr, const bqc_shifts_t *sh_ptr)
+{
+   st_ptr->b0[l]     = coefs_ptr[0];
+   st_ptr->b1[l]     = coefs_ptr[1];
+   st_ptr->b2[l]     = coefs_ptr[2];
+   st_ptr->a1[l]     = coefs_ptr[3];
+   st_ptr->a2[l]     = coefs_ptr[4];
+   st_ptr->rsx[l]    = sh_ptr->x;
+   st_ptr->rsy[l]    = sh_ptr->y;
+   st_ptr->rsa[l]    = sh_ptr->a;
+   st_ptr->round[l]  = (int64)1 << (sh_ptr->y - 1);
+   st_ptr->active[l] = -1;
+   st_ptr->w1[l]     = mem_ptr[0];
+   st_ptr->w2[l]     = mem_ptr[1];
+}
+
+#define BQC_LD(field) _mm256_loadu_si256((const __m256i *)(field))
+
+/* AVX2 has no 64 bit arithmetic shift, shift logically and extend the sign: (v >>> n ^ s) - s, s = 1 << (63 - n) */
+BQC_TGT_AVX2 static inline __m256i bqc_sra_avx2(__m256i v, __m256i n, __m256i s)
+{
+   return _mm256_sub_epi64(_mm256_xor_si256(_mm256_srlv_epi64(v, n), s), s);
+}
+
+BQC_TGT_AVX2 static void bqc_run_avx2(bqc_stage_t *st_ptr,
+                                      int32        num_stages,
+                                      bqc_lane_t * x_buf,
+                                      int32        samples,
+                                      bool_t       is_16)
+{
+   const __m256i sign  = _mm256_set1_epi64x((int64)0x8000000000000000ULL);
+   const __m256i max32 = _mm256_set1_epi64x(MAX_32);
+   const __m256i min32 = _mm256_set1_epi64x(MIN_32);
+   // the 16 bit output only sees values within 32 bits, the 32 bit operations keep the sign extension intact
+   const __m256i max_rnd16 = _mm256_set1_epi32(MAX_32 - 0x1000);
+   const __m256i rnd16     = _mm256_set1_epi64x(0x1000);
+   const __m256i max16     = _mm256_set1_epi32(MAX_16);
+   const __m256i min16     = _mm256_set1_epi32(MIN_16);
+   int32         i, s;
+
+   for (i = 0; i < samples; i++)
+   {
+      __m256i x = BQC_LD(x_buf + i * BIQUAD_CASCADE_LANES);
+      for (s = 0; s < num_stages; s++)
+      {
+         bqc_stage_t *p   = st_ptr + s;
+         __m256i      rsx = BQC_LD(p->rsx), sgx = _mm256_srlv_epi64(sign, rsx);
+         __m256i      rsa = BQC_LD(p->rsa), sga = _mm256_srlv_epi64(sign, rsa);
+         __m256i      rsy = BQC_LD(p->rsy);
+         __m256i      y, ys, w1, w2, xo;
+
+         // y = b0*x + w1, yS = sat32((y + p5) >> shiftY)
+         y  = _mm256_add_epi64(bqc_sra_avx2(_mm256_mul_epi32(BQC_LD(p->b0), x), rsx, sgx), BQC_LD(p->w1));
+         y  = bqc_sra_avx2(_mm256_add_epi64(y, BQC_LD(p->round)), rsy, _mm256_srlv_epi64(sign, rsy));
+         ys = _mm256_blendv_epi8(y, max32, _mm256_cmpgt_epi64(y, max32));
+         ys = _mm256_blendv_epi8(ys, min32, _mm256_cmpgt_epi64(min32, ys));
+
+         // w1 = b1*x - a1*yS + w2
+         w1 = _mm256_sub_epi64(bqc_sra_avx2(_mm256_mul_epi32(BQC_LD(p->b1), x), rsx, sgx),
+                               bqc_sra_avx2(_mm256_mul_epi32(BQC_LD(p->a1), ys), rsa, sga));
+         w1 = _mm256_add_epi64(w1, BQC_LD(p->w2));
+
+         // w2 = b2*x - a2*yS
+         w2 = _mm256_sub_epi64(bqc_sra_avx2(_mm256_mul_epi32(BQC_LD(p->b2), x), rsx, sgx),
+                               bqc_sra_avx2(_mm256_mul_epi32(BQC_LD(p->a2), ys), rsa, sga));
+
+         _mm256_storeu_si256((__m256i *)p->w1, w1);
+         _mm256_storeu_si256((__m256i *)p->w2, w2);
+
+         if (is_16)
+         {
+            // sat16(sat32(yS + 0x1000) >> 13), clamping yS first gives the same result without overflow
+            xo = _mm256_add_epi32(_mm256_min_epi32(ys, max_rnd16), rnd16);
+            xo = _mm256_srai_epi32(xo, 16 - GUARD_BITS_16);
+            xo = _mm256_max_epi32(_mm256_min_epi32(xo, max16), min16);
+         }
+         else
+         {
+            xo = ys;
+         }
+         // lanes past their last stage pass the input through
+         x = _mm256_blendv_epi8(x, xo, BQC_LD(p->active));
+      }
+      _mm256_storeu_si256((__m256i *)(x_buf + i * BIQUAD_CASCADE_LANES), x);
+   }
+}
+
+static void bqc_run(bqc_stage_t *st_ptr, int32 num_stages, bqc_lane_t *x_buf, int32 samples, bool_t is_16)
+{
+   bqc_run_avx2(st_ptr, num_stages, x_buf, samples, is_16);
+}
+#endif // BQC_NEON
+
+/* Filters up to BIQUAD_CASCADE_LANES channels, one per lane */
+static void bqc_group(biquad_cascade_ch_t **lane_ptrs, uint32 num_lanes, int32 samples, bool_t is_16)
+{
+   bqc_stage_t  stages[BQC_MAX_STAGES];
+   bqc_lane_t   x_buf[BQC_BLOCK_SIZE * BIQUAD_CASCADE_LANES];
+   bqc_shifts_t sh;
+   int32        max_stages = 0;
+   int32        s0, s, i, j;
+   uint32       l;
+
+   for (l = 0; l < num_lanes; l++)
+   {
+      if (lane_ptrs[l]->num_stages > max_stages)
+      {
+         max_stages = lane_ptrs[l]->num_stages;
+      }
+   }
+
+   // unused lanes stay zero, they have no active stage
+   memset(x_buf, 0, sizeof(x_buf));
+
+   for (s0 = 0; s0 < max_stages; s0 += BQC_MAX_STAGES)
+   {
+      int32 num_stages = s32_min_s32_s32(BQC_MAX_STAGES, max_stages - s0);
+
+      memset(stages, 0, sizeof(stages));
+      for (s = 0; s < num_stages; s++)
+      {
+         for (l = 0; l < num_lanes; l++)
+         {
+            const biquad_cascade_ch_t *ch_ptr = lane_ptrs[l];
+            if (s0 + s < ch_ptr->num_stages)
+            {
+               bqc_get_shifts(bqc_shiftn(ch_ptr, s0 + s), ch_ptr->shiftd, is_16, &sh);
+               bqc_pack_lane(&stages[s], l, bqc_coefs(ch_ptr, s0 + s), bqc_mem(ch_ptr, s0 + s), &sh);
+            }
+         }
+      }
+
+      for (i = 0; i < samples; i += BQC_BLOCK_SIZE)
+      {
+         int32 n = s32_min_s32_s32(BQC_BLOCK_SIZE, samples - i);
+
+         // the first stages read the input, the following ones continue on the output
+         for (l = 0; l < num_lanes; l++)
+         {
+            void *src_ptr = (0 == s0) ? lane_ptrs[l]->in_ptr : lane_ptrs[l]->out_ptr;
+            if (is_16)
+            {
+               const int16 *in_ptr = (const int16 *)src_ptr + i;
+               for (j = 0; j < n; j++)
+               {
+                  x_buf[j * BIQUAD_CASCADE_LANES + l] = in_ptr[j];
+               }
+            }
+            else
+            {
+               const int32 *in_ptr = (const int32 *)src_ptr + i;
+               for (j = 0; j < n; j++)
+               {
+                  x_buf[j * BIQUAD_CASCADE_LANES + l] = in_ptr[j];
+               }
+            }
+         }
+
+         bqc_run(stages, num_stages, x_buf, n, is_16);
+
+         for (l = 0; l < num_lanes; l++)
+         {
+            if (is_16)
+            {
+               int16 *out_ptr = (int16 *)lane_ptrs[l]->out_ptr + i;
+               for (j = 0; j < n; j++)
+               {
+                  out_ptr[j] = (int16)x_buf[j * BIQUAD_CASCADE_LANES + l];
+               }
+            }
+            else
+            {
+               int32 *out_ptr = (int32 *)lane_ptrs[l]->out_ptr + i;
+               for (j = 0; j < n; j++)
+               {
+                  out_ptr[j] = (int32)x_buf[j * BIQUAD_CASCADE_LANES + l];
+               }
+            }
+         }
+      }
+
+      // store back the states
+      for (s = 0; s < num_stages; s++)
+      {
+         for (l = 0; l < num_lanes; l++)
+         {
+            if (s0 + s < lane_ptrs[l]->num_stages)
+            {
+               int64 *mem_ptr = bqc_mem(lane_ptrs[l], s0 + s);
+               mem_ptr[0]     = stages[s].w1[l];
+               mem_ptr[1]     = stages[s].w2[l];
+            }
+         }
+      }
+   }
+}
+
+static void bqc_process(biquad_cascade_ch_t *ch_ptr, uint32 num_chs, int32 samples, bool_t is_16)
+{
+   biquad_cascade_ch_t *lane_ptrs[BIQUAD_CASCADE_LANES];
+   uint32               num_lanes = 0;
+   uint32               ch;
+
+   for (ch = 0; ch < num_chs; ch++)
+   {
+      if (!bqc_has_simd() || !bqc_fits_lanes(&ch_ptr[ch], is_16))
+      {
+         if (is_16)
+         {
+            bqc_ch_16(&ch_ptr[ch], samples);
+         }
+         else
+         {
+            bqc_ch_32(&ch_ptr[ch], samples);
+         }
+         continue;
+      }
+
+      lane_ptrs[num_lanes++] = &ch_ptr[ch];
+      if (BIQUAD_CASCADE_LANES == num_lanes)
+      {
+         bqc_group(lane_ptrs, num_lanes, samples, is_16);
+         num_lanes = 0;
+      }
+   }
+   if (num_lanes > 0)
+   {
+      bqc_group(lane_ptrs, num_lanes, samples, is_16);
+   }
+}
+
+void biquad_cascade_16(biquad_cascade_ch_t *ch_ptr, uint32 num_chs, int32 samples)
+{
+   bqc_process(ch_ptr, num_chs, samples, TRUE);
+}
+
+void biquad_cascade_32(biquad_cascade_ch_t *ch_ptr, uint32 num_chs, int32 samples)
+{
+   bqc_process(ch_ptr, num_chs, samples, FALSE);
+}
+
+#else // BQC_NEON || BQC_AVX2
+
+void biquad_cascade_16(biquad_cascade_ch_t *ch_ptr, uint32 num_chs, int32 samples)
+{
+   uint32 ch;
+   for (ch = 0; ch < num_chs; ch++)
+   {
+      bqc_ch_16(&ch_ptr[ch], samples);
+   }
+}
+
+void biquad_cascade_32(biquad_cascade_ch_t *ch_ptr, uint32 num_chs, int32 samples)
+{
+   uint32 ch;
+   for (ch = 0; ch < num_chs; ch++)
+   {
+      bqc_ch_32(&ch_ptr[ch], samples);
+   }
+}
+
+#endif // BQC_NEON || BQC_AVX2
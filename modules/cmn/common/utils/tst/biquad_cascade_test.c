@@ -0,0 +1,368 @@
+/*
+ * Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+/* Regression test for biquad_cascade_16 / biquad_cascade_32 against calling */
+/* iirTDF2_16 / iirTDF2_32 stage by stage on every channel.                  */
+/*                                                                            */
+/* Channel counts below, at and above the lane count of a group, including   */
+/* counts that are not a multiple of it, run with a different number of      */
+/* stages per channel (zero, odd, and more than one pack of lane stages),    */
+/* in place and out of place, over several calls of random length. Stable    */
+/* filters, arbitrary coefficients that drive the output into saturation,    */
+/* and shifts the lanes cannot represent, which make those channels fall     */
+/* back to the stage by stage path in the middle of a lane group, are all    */
+/* covered. Outputs and filter states must match bit for bit.                */
+/*                                                                            */
+/* Dependencies: biquad_cascade.c, iir_tdf2.c and the basic ops.             */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "audio_biquad_cascade.h"
+#include "audio_iir_tdf2.h"
+#include "audio_basic_op.h"
+
+#define BQC_TST_MAX_CHS 13
+#define BQC_TST_MAX_STAGES 9
+#define BQC_TST_NUM_SAMPLES 960
+#define BQC_TST_MAX_CALL 200
+
+// Coefficient sets, see bqc_tst_make_stage
+#define BQC_TST_STABLE 0
+#define BQC_TST_ARBITRARY 1
+#define BQC_TST_FALLBACK 2
+#define BQC_TST_NUM_KINDS 3
+
+/* One stage in the layout of the MSIIR and Popless EQ states: the cascade walks it with stage_stride */
+typedef struct bqc_tst_stage_t
+{
+   int32 coefs[5];
+   int16 shiftn;
+   int64 mem[2];
+} bqc_tst_stage_t;
+
+typedef struct bqc_tst_ch_t
+{
+   bqc_tst_stage_t stages[BQC_TST_MAX_STAGES];
+   int32           num_stages;
+   int16           shiftd;
+   bool_t          in_place;
+} bqc_tst_ch_t;
+
+static uint32       bqc_tst_seed;
+static bqc_tst_ch_t bqc_tst_chs[BQC_TST_MAX_CHS];
+static bqc_tst_ch_t bqc_tst_ref_chs[BQC_TST_MAX_CHS];
+static int32        bqc_tst_in[BQC_TST_MAX_CHS][BQC_TST_NUM_SAMPLES];
+static int32        bqc_tst_out[BQC_TST_MAX_CHS][BQC_TST_NUM_SAMPLES];
+static int32        bqc_tst_ref[BQC_TST_MAX_CHS][BQC_TST_NUM_SAMPLES];
+static uint32       bqc_tst_num_saturated;
+
+static uint32 bqc_tst_rand(void)
+{
+   // xorshift32
+   bqc_tst_seed ^= bqc_tst_seed << 13;
+   bqc_tst_seed ^= bqc_tst_seed >> 17;
+   bqc_tst_seed ^= bqc_tst_seed << 5;
+   return bqc_tst_seed;
+}
+
+static double bqc_tst_uniform(double lo, double hi)
+{
+   return lo + (hi - lo) * ((double)(bqc_tst_rand() >> 8) / (double)(1u << 24));
+}
+
+/* Coefficients are in Q(32 - shift), so |coef| must stay below 2^(shift - 1) */
+static int32 bqc_tst_to_q(double value, int16 shift)
+{
+   double scaled = value * ldexp(1.0, 32 - shift);
+   if (scaled >= 2147483647.0)
+   {
+      return MAX_32;
+   }
+   if (scaled <= -2147483648.0)
+   {
+      return MIN_32;
+   }
+   return (int32)scaled;
+}
+
+/* Stable stages have poles inside the unit circle and a modest gain. Arbitrary stages take any coefficient below 1.0
+ * and saturate. Fallback stages use a shift the lanes cannot represent, every other stage of a channel. */
+static void bqc_tst_make_stage(bqc_tst_ch_t *ch_ptr, int32 s, uint32 kind, bool_t is_16)
+{
+   bqc_tst_stage_t *st_ptr = &ch_ptr->stages[s];
+   double           r      = bqc_tst_uniform(0.3, 0.97);
+   double           theta  = bqc_tst_uniform(0.05, 3.1);
+   double           rz     = bqc_tst_uniform(0.0, 1.0);
+   double           phi    = bqc_tst_uniform(0.0, 3.14);
+   double           g      = bqc_tst_uniform(0.2, 1.0);
+
+   st_ptr->shiftn = (int16)(2 + (bqc_tst_rand() % 3));
+   if ((BQC_TST_FALLBACK == kind) && (s & 1))
+   {
+      // the lanes need 12 + GUARD_BITS_16 - max_shift >= 1 for 16 bit and 28 - max_shift >= 1 for 32 bit data
+      st_ptr->shiftn = (int16)((is_16 ? (12 + GUARD_BITS_16) : 28) + (bqc_tst_rand() % 3));
+   }
+
+   if (BQC_TST_ARBITRARY == kind)
+   {
+      for (int32 k = 0; k < 5; k++)
+      {
+         int16 shift      = (k < 3) ? st_ptr->shiftn : ch_ptr->shiftd;
+         st_ptr->coefs[k] = bqc_tst_to_q(bqc_tst_uniform(-1.0, 1.0), shift);
+      }
+   }
+   else
+   {
+      st_ptr->coefs[0] = bqc_tst_to_q(g, st_ptr->shiftn);
+      st_ptr->coefs[1] = bqc_tst_to_q(-2.0 * g * rz * cos(phi), st_ptr->shiftn);
+      st_ptr->coefs[2] = bqc_tst_to_q(g * rz * rz, st_ptr->shiftn);
+      st_ptr->coefs[3] = bqc_tst_to_q(-2.0 * r * cos(theta), ch_ptr->shiftd);
+      st_ptr->coefs[4] = bqc_tst_to_q(r * r, ch_ptr->shiftd);
+   }
+   st_ptr->mem[0] = 0;
+   st_ptr->mem[1] = 0;
+}
+
+static void bqc_tst_make_chs(uint32 num_chs, uint32 kind, bool_t is_16)
+{
+   for (uint32 ch = 0; ch < num_chs; ch++)
+   {
+      bqc_tst_ch_t *ch_ptr = &bqc_tst_chs[ch];
+
+      memset(ch_ptr, 0, sizeof(*ch_ptr));
+      // 0 copies the input, 1 to 3 stay in the first pack of lane stages, up to 9 needs three packs
+      ch_ptr->num_stages = (int32)(bqc_tst_rand() % (BQC_TST_MAX_STAGES + 1));
+      ch_ptr->shiftd     = (int16)(2 + (bqc_tst_rand() % 3));
+      ch_ptr->in_place   = (bqc_tst_rand() & 1);
+      for (int32 s = 0; s < ch_ptr->num_stages; s++)
+      {
+         bqc_tst_make_stage(ch_ptr, s, kind, is_16);
+      }
+      bqc_tst_ref_chs[ch] = *ch_ptr;
+   }
+}
+
+/* Noise at a random level, then silence, full scale steps and impulses */
+static void bqc_tst_make_input(uint32 num_chs, bool_t is_16)
+{
+   for (uint32 ch = 0; ch < num_chs; ch++)
+   {
+      uint32 shift = (is_16 ? 16 : 0) + (bqc_tst_rand() % 8);
+      for (uint32 n = 0; n < BQC_TST_NUM_SAMPLES; n++)
+      {
+         int32  value;
+         uint32 segment = (n * 8) / BQC_TST_NUM_SAMPLES;
+         int32  full    = is_16 ? MAX_16 : MAX_32;
+         switch (segment)
+         {
+            case 3:
+            {
+               value = 0;
+               break;
+            }
+            case 4:
+            {
+               value = ((n / 24) & 1) ? full : -full - 1;
+               break;
+            }
+            case 5:
+            {
+               value = (0 == (n % 40)) ? full : 0;
+               break;
+            }
+            default:
+            {
+               value = ((int32)bqc_tst_rand()) >> shift;
+               break;
+            }
+         }
+         bqc_tst_in[ch][n] = value;
+      }
+   }
+}
+
+static void bqc_tst_fill_desc(biquad_cascade_ch_t *desc_ptr, bqc_tst_ch_t *ch_ptr, void *in_ptr, void *out_ptr)
+{
+   desc_ptr->in_ptr       = in_ptr;
+   desc_ptr->out_ptr      = ch_ptr->in_place ? in_ptr : out_ptr;
+   desc_ptr->coefs_ptr    = ch_ptr->stages[0].coefs;
+   desc_ptr->mem_ptr      = ch_ptr->stages[0].mem;
+   desc_ptr->shiftn_ptr   = &ch_ptr->stages[0].shiftn;
+   desc_ptr->stage_stride = sizeof(bqc_tst_stage_t);
+   desc_ptr->num_stages   = ch_ptr->num_stages;
+   desc_ptr->shiftd       = ch_ptr->shiftd;
+}
+
+/* Runs the cascade over all samples in calls of random length and returns the number of mismatches */
+static uint32 bqc_tst_run_case(uint32 num_chs, bool_t is_16)
+{
+   static int16        in16[BQC_TST_MAX_CHS][BQC_TST_NUM_SAMPLES];
+   static int16        out16[BQC_TST_MAX_CHS][BQC_TST_NUM_SAMPLES];
+   static int16        ref_in16[BQC_TST_NUM_SAMPLES];
+   static int32        ref_in32[BQC_TST_NUM_SAMPLES];
+   biquad_cascade_ch_t desc[BQC_TST_MAX_CHS];
+   uint32              num_errors = 0;
+
+   bqc_tst_make_input(num_chs, is_16);
+   for (uint32 ch = 0; ch < num_chs; ch++)
+   {
+      for (uint32 n = 0; n < BQC_TST_NUM_SAMPLES; n++)
+      {
+         in16[ch][n] = (int16)bqc_tst_in[ch][n];
+      }
+   }
+   memset(out16, 0x5a, sizeof(out16));
+   memset(bqc_tst_out, 0x5a, sizeof(bqc_tst_out));
+   memcpy(bqc_tst_ref, bqc_tst_in, sizeof(bqc_tst_ref));
+
+   for (uint32 n = 0; n < BQC_TST_NUM_SAMPLES;)
+   {
+      int32 frame = (int32)(1 + (bqc_tst_rand() % BQC_TST_MAX_CALL));
+      frame       = (frame > (int32)(BQC_TST_NUM_SAMPLES - n)) ? (int32)(BQC_TST_NUM_SAMPLES - n) : frame;
+
+      for (uint32 ch = 0; ch < num_chs; ch++)
+      {
+         if (is_16)
+         {
+            bqc_tst_fill_desc(&desc[ch], &bqc_tst_chs[ch], &in16[ch][n], &out16[ch][n]);
+         }
+         else
+         {
+            bqc_tst_fill_desc(&desc[ch], &bqc_tst_chs[ch], &bqc_tst_in[ch][n], &bqc_tst_out[ch][n]);
+         }
+      }
+      if (is_16)
+      {
+         biquad_cascade_16(desc, num_chs, frame);
+      }
+      else
+      {
+         biquad_cascade_32(desc, num_chs, frame);
+      }
+
+      // Reference: every stage of every channel through the generic filter, in place on the reference buffer
+      for (uint32 ch = 0; ch < num_chs; ch++)
+      {
+         bqc_tst_ch_t *ch_ptr = &bqc_tst_ref_chs[ch];
+         for (int32 j = 0; j < frame; j++)
+         {
+            ref_in16[j] = (int16)bqc_tst_ref[ch][n + j];
+            ref_in32[j] = bqc_tst_ref[ch][n + j];
+         }
+         for (int32 s = 0; s < ch_ptr->num_stages; s++)
+         {
+            bqc_tst_stage_t *st_ptr = &ch_ptr->stages[s];
+            if (is_16)
+            {
+               iirTDF2_16(ref_in16, ref_in16, frame, st_ptr->coefs, st_ptr->coefs + 3, st_ptr->mem, st_ptr->shiftn,
+                          ch_ptr->shiftd);
+            }
+            else
+            {
+               iirTDF2_32(ref_in32, ref_in32, frame, st_ptr->coefs, st_ptr->coefs + 3, st_ptr->mem, st_ptr->shiftn,
+                          ch_ptr->shiftd);
+            }
+         }
+         for (int32 j = 0; j < frame; j++)
+         {
+            bqc_tst_ref[ch][n + j] = is_16 ? ref_in16[j] : ref_in32[j];
+         }
+      }
+      n += frame;
+   }
+
+   for (uint32 ch = 0; ch < num_chs; ch++)
+   {
+      bqc_tst_ch_t *ch_ptr  = &bqc_tst_chs[ch];
+      int32         full    = is_16 ? MAX_16 : MAX_32;
+      uint32        ch_errs = 0;
+
+      for (uint32 n = 0; n < BQC_TST_NUM_SAMPLES; n++)
+      {
+         int32 out;
+         if (is_16)
+         {
+            out = ch_ptr->in_place ? in16[ch][n] : out16[ch][n];
+         }
+         else
+         {
+            out = ch_ptr->in_place ? bqc_tst_in[ch][n] : bqc_tst_out[ch][n];
+         }
+         if ((bqc_tst_ref[ch][n] >= full) || (bqc_tst_ref[ch][n] < -full))
+         {
+            bqc_tst_num_saturated++;
+         }
+         if (out != bqc_tst_ref[ch][n])
+         {
+            if (0 == ch_errs)
+            {
+               printf("  channel %lu (%ld stages): first mismatch at sample %lu, %ld instead of %ld\n",
+                      (unsigned long)ch,
+                      (long)ch_ptr->num_stages,
+                      (unsigned long)n,
+                      (long)out,
+                      (long)bqc_tst_ref[ch][n]);
+            }
+            ch_errs++;
+         }
+      }
+      for (int32 s = 0; s < ch_ptr->num_stages; s++)
+      {
+         if (memcmp(ch_ptr->stages[s].mem, bqc_tst_ref_chs[ch].stages[s].mem, sizeof(ch_ptr->stages[s].mem)))
+         {
+            printf("  channel %lu: state of stage %ld differs\n", (unsigned long)ch, (long)s);
+            ch_errs++;
+         }
+      }
+      num_errors += ch_errs;
+   }
+   return num_errors;
+}
+
+int main(int argc, char *argv[])
+{
+   static const uint32 num_chs_list[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 13 };
+   static const char  *kind_names[]   = { "stable", "arbitrary", "fallback" };
+   uint32              num_cases = 0, num_failed = 0;
+
+   for (uint32 w = 0; w < 2; w++)
+   {
+      bool_t is_16 = (0 == w);
+      for (uint32 c = 0; c < sizeof(num_chs_list) / sizeof(num_chs_list[0]); c++)
+      {
+         for (uint32 kind = 0; kind < BQC_TST_NUM_KINDS; kind++)
+         {
+            // a few seeds per combination, so that stage counts and in place channels vary
+            for (uint32 rep = 0; rep < 4; rep++)
+            {
+               uint32 num_errors;
+
+               bqc_tst_seed = (num_cases * 2654435761u) + 7;
+               bqc_tst_make_chs(num_chs_list[c], kind, is_16);
+               num_errors = bqc_tst_run_case(num_chs_list[c], is_16);
+               num_cases++;
+               if (num_errors)
+               {
+                  num_failed++;
+                  printf("%s bit %lu channels %s seed %lu: %lu mismatches\n",
+                         is_16 ? "16" : "32",
+                         (unsigned long)num_chs_list[c],
+                         kind_names[kind],
+                         (unsigned long)rep,
+                         (unsigned long)num_errors);
+               }
+            }
+         }
+      }
+   }
+
+   printf("%lu of %lu cases failed, %lu reference samples at full scale\n",
+          (unsigned long)num_failed,
+          (unsigned long)num_cases,
+          (unsigned long)bqc_tst_num_saturated);
+   return num_failed ? 1 : 0;
+}
@@ -196,6 +196,48 @@ typedef struct pc_proc_info_t
 
 } pc_proc_info_t;
 
+// Sample types read and written by the fused conversion
+typedef enum pc_fused_samp_t {
+   PC_FUSED_INVALID_SAMP = 0,
+   PC_FUSED_S16,
+   PC_FUSED_S32,
+   PC_FUSED_F32,
+   PC_FUSED_F64,
+} pc_fused_samp_t;
+
+// Number of frames converted per block by the fused conversion
+#define PC_FUSED_BLOCK_SIZE 64
+
+// Single pass replacement for a chain of endianness, float <-> fixed, interleaving and byte conversion processes.
+// Selected at init when no channel mixer or resampler is needed. Each block of frames is read, converted and written
+// while it is in the cache, instead of one pass through the scratch buffers per process.
+typedef struct pc_fused_cnv_t
+{
+   // Flag to indicate if the fused conversion replaces the process chain
+   bool_t is_enabled;
+
+   // Sample types of the input and output buffers
+   pc_fused_samp_t in_type;
+   pc_fused_samp_t out_type;
+
+   // Byte swap while reading (ENDIANNESS_PRE) and while writing (ENDIANNESS_POST)
+   bool_t in_swap;
+   bool_t out_swap;
+
+   // Flag to indicate if the chain has a byte conversion process (BYTE_CNV_POST)
+   bool_t is_byte_cnv;
+
+   // Byte conversion as done on interleaved data, 32 to 16 bit conversion doesn't saturate in that case
+   bool_t is_intlv_byte_cnv;
+
+   // Fixed point sample type and Q factor before and after the byte conversion. Floating point data is converted
+   // from/to Q31 as in the float to fixed and fixed to float processes.
+   pc_fused_samp_t mid_in_type;
+   pc_fused_samp_t mid_out_type;
+   uint16_t        mid_in_q_factor;
+   uint16_t        mid_out_q_factor;
+} pc_fused_cnv_t;
+
 typedef struct pc_core_lib_t
 {
    // Memory pointer to the memory required for channel maps and remap buffers
@@ -230,6 +272,9 @@ typedef struct pc_core_lib_t
 
    // Temporary de-interleaved-unpacked buffer ptr holder for fwk output buffer
    capi_buf_t *remap_output_buf_ptr;
+
+   // Fused single pass conversion, used instead of the process chain when enabled
+   pc_fused_cnv_t fused_cnv;
 } pc_core_lib_t;
 
 // Main library structure for pcm converter
@@ -386,6 +431,9 @@ ar_result_t pc_deintlv_unpacked_v2_32_out(capi_buf_t *input_buf_ptr,
                                           uint16_t    q_factor_in,
                                           uint16_t    q_factor_out);
 
+/** Converts the remapped input into the remapped output in a single pass using the fused conversion */
+ar_result_t pc_fused_cnv_process(pc_lib_t *pc_ptr, capi_buf_t *input_buf_ptr, capi_buf_t *output_buf_ptr);
+
 ar_result_t pc_change_endianness(int8_t   *src_ptr,
                                  int8_t   *dest_ptr,
                                  uint32_t  src_actual_len,
@@ -0,0 +1,357 @@
+/*========================================================================
+
+ file pc_fused_cnv_island.cpp
+This file contains the fused single pass conversion of the pcm converter.
+
+Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+SPDX-License-Identifier: BSD-3-Clause-Clear
+======================================================================*/
+
+/* =======================================================================
+INCLUDE FILES FOR MODULE
+========================================================================== */
+
+#include "pc_converter.h"
+
+/*______________________________________________________________________________________________________________________
+   DESCRIPTION:
+   Each sample goes through the same operations as in the process chain it replaces, in the same order
+   1. Byte swap (pc_endianness_process)
+   2. Float to Q31 (pc_float_to_fixed_conv_process)
+   3. Byte conversion (pc_byte_morph_process)
+   4. Q31 to float (pc_fixed_to_float_conv_process)
+   5. Byte swap (pc_endianness_process)
+   Interleaving is done by the read and write strides, so the output is bit exact with the chain.
+______________________________________________________________________________________________________________________*/
+
+static const uint32_t PC_FUSED_IQ31 = (1 << PCM_Q_FACTOR_31);
+static const uint64_t PC_FUSED_DQ31 = (1ll << PCM_Q_FACTOR_31);
+
+typedef union pc_fused_f32_bits_t
+{
+   float32_t f;
+   uint32_t  u;
+} pc_fused_f32_bits_t;
+
+static inline uint16_t pc_fused_swap16(uint16_t val)
+{
+   return (uint16_t)(((val & 0xFF00) >> 8) | ((val & 0x00FF) << 8));
+}
+
+static inline uint32_t pc_fused_swap32(uint32_t val)
+{
+   return ((val & 0x000000FF) << 24 | (val & 0x0000FF00) << 8 | (val & 0x00FF0000) >> 8 | (val & 0xFF000000) >> 24);
+}
+
+static inline uint32_t pc_fused_bytes_per_samp(pc_fused_samp_t type)
+{
+   return (PC_FUSED_S16 == type) ? 2 : ((PC_FUSED_F64 == type) ? 8 : 4);
+}
+
+/*______________________________________________________________________________________________________________________
+   DESCRIPTION:
+   Reads num_samples samples of one channel, stride samples apart, into the block. Applies the input byte swap and the
+   float to fixed conversion.
+______________________________________________________________________________________________________________________*/
+static void pc_fused_read(pc_fused_cnv_t *cnv_ptr, int8_t *src_ptr, uint32_t stride, int32_t *blk_ptr, uint32_t num_samples)
+{
+   uint32_t i;
+
+   switch (cnv_ptr->in_type)
+   {
+      case PC_FUSED_S16:
+      {
+         int16_t *in_ptr = (int16_t *)src_ptr;
+         if (cnv_ptr->in_swap)
+         {
+            for (i = 0; i < num_samples; i++)
+            {
+               blk_ptr[i] = (int16_t)pc_fused_swap16((uint16_t)in_ptr[i * stride]);
+            }
+         }
+         else
+         {
+            for (i = 0; i < num_samples; i++)
+            {
+               blk_ptr[i] = in_ptr[i * stride];
+            }
+         }
+         break;
+      }
+      case PC_FUSED_S32:
+      {
+         int32_t *in_ptr = (int32_t *)src_ptr;
+         if (cnv_ptr->in_swap)
+         {
+            for (i = 0; i < num_samples; i++)
+            {
+               blk_ptr[i] = (int32_t)pc_fused_swap32((uint32_t)in_ptr[i * stride]);
+            }
+         }
+         else
+         {
+            for (i = 0; i < num_samples; i++)
+            {
+               blk_ptr[i] = in_ptr[i * stride];
+            }
+         }
+         break;
+      }
+      case PC_FUSED_F32:
+      {
+         const float32_t fq31 = (float32_t)(PC_FUSED_IQ31);
+         if (cnv_ptr->in_swap)
+         {
+            uint32_t *in_ptr = (uint32_t *)src_ptr;
+            for (i = 0; i < num_samples; i++)
+            {
+               pc_fused_f32_bits_t samp;
+               samp.u     = pc_fused_swap32(in_ptr[i * stride]);
+               blk_ptr[i] = (int32_t)(samp.f * fq31);
+            }
+         }
+         else
+         {
+            float32_t *in_ptr = (float32_t *)src_ptr;
+            for (i = 0; i < num_samples; i++)
+            {
+               blk_ptr[i] = (int32_t)(in_ptr[i * stride] * fq31);
+            }
+         }
+         break;
+      }
+      case PC_FUSED_F64:
+      {
+         const float64_t dq31   = (float64_t)(PC_FUSED_DQ31);
+         float64_t *     in_ptr = (float64_t *)src_ptr;
+         for (i = 0; i < num_samples; i++)
+         {
+            blk_ptr[i] = (int32_t)(in_ptr[i * stride] * dq31);
+         }
+         break;
+      }
+      default:
+      {
+         break;
+      }
+   }
+}
+
+/*______________________________________________________________________________________________________________________
+   DESCRIPTION:
+   Byte conversion of the block, same as pc_intlv_xx_out for interleaved data and pc_deintlv_unpacked_v2_xx_out for
+   deinterleaved data.
+______________________________________________________________________________________________________________________*/
+static void pc_fused_byte_cnv(pc_fused_cnv_t *cnv_ptr, int32_t *blk_ptr, uint32_t num_samples)
+{
+   uint32_t q_factor_in  = cnv_ptr->mid_in_q_factor;
+   uint32_t q_factor_out = cnv_ptr->mid_out_q_factor;
+   int32_t  min_value    = (int32_t)(-(1ll << q_factor_in));
+   int32_t  max_value    = (int32_t)((1ll << q_factor_in) - 1);
+   uint32_t shift;
+   uint32_t i;
+
+   if ((PC_FUSED_S16 == cnv_ptr->mid_in_type) && (PC_FUSED_S32 == cnv_ptr->mid_out_type))
+   {
+      /* Q15 -> Q31/27 conversion */
+      shift = q_factor_out - q_factor_in;
+      for (i = 0; i < num_samples; i++)
+      {
+         blk_ptr[i] = blk_ptr[i] << shift;
+      }
+   }
+   else if ((PC_FUSED_S32 == cnv_ptr->mid_in_type) && (PC_FUSED_S16 == cnv_ptr->mid_out_type))
+   {
+      /* Qn -> Q15 conversion, deinterleaved data is saturated to the input Q factor first */
+      shift = q_factor_in - PCM_Q_FACTOR_15;
+      if (cnv_ptr->is_intlv_byte_cnv)
+      {
+         for (i = 0; i < num_samples; i++)
+         {
+            blk_ptr[i] = (int16_t)(blk_ptr[i] >> shift);
+         }
+      }
+      else
+      {
+         for (i = 0; i < num_samples; i++)
+         {
+            int32_t temp32 = blk_ptr[i];
+            temp32         = (temp32 < min_value) ? min_value : temp32;
+            temp32         = (temp32 > max_value) ? max_value : temp32;
+            blk_ptr[i]     = (int16_t)(temp32 >> shift);
+         }
+      }
+   }
+   else if ((PC_FUSED_S32 == cnv_ptr->mid_in_type) && (PC_FUSED_S32 == cnv_ptr->mid_out_type))
+   {
+      if (q_factor_out >= q_factor_in)
+      {
+         shift = q_factor_out - q_factor_in;
+         for (i = 0; i < num_samples; i++)
+         {
+            int32_t temp32 = blk_ptr[i];
+            temp32         = (temp32 < min_value) ? min_value : temp32;
+            temp32         = (temp32 > max_value) ? max_value : temp32;
+            blk_ptr[i]     = temp32 << shift;
+         }
+      }
+      else
+      {
+         shift = q_factor_in - q_factor_out;
+         for (i = 0; i < num_samples; i++)
+         {
+            blk_ptr[i] = blk_ptr[i] >> shift;
+         }
+      }
+   }
+}
+
+/*______________________________________________________________________________________________________________________
+   DESCRIPTION:
+   Writes the block to num_samples samples of one channel, stride samples apart. Applies the fixed to float conversion
+   and the output byte swap.
+______________________________________________________________________________________________________________________*/
+static void pc_fused_write(pc_fused_cnv_t *cnv_ptr, int32_t *blk_ptr, int8_t *dst_ptr, uint32_t stride, uint32_t num_samples)
+{
+   uint32_t i;
+
+   switch (cnv_ptr->out_type)
+   {
+      case PC_FUSED_S16:
+      {
+         int16_t *out_ptr = (int16_t *)dst_ptr;
+         if (cnv_ptr->out_swap)
+         {
+            for (i = 0; i < num_samples; i++)
+            {
+               out_ptr[i * stride] = (int16_t)pc_fused_swap16((uint16_t)blk_ptr[i]);
+            }
+         }
+         else
+         {
+            for (i = 0; i < num_samples; i++)
+            {
+               out_ptr[i * stride] = (int16_t)blk_ptr[i];
+            }
+         }
+         break;
+      }
+      case PC_FUSED_S32:
+      {
+         int32_t *out_ptr = (int32_t *)dst_ptr;
+         if (cnv_ptr->out_swap)
+         {
+            for (i = 0; i < num_samples; i++)
+            {
+               out_ptr[i * stride] = (int32_t)pc_fused_swap32((uint32_t)blk_ptr[i]);
+            }
+         }
+         else
+         {
+            for (i = 0; i < num_samples; i++)
+            {
+               out_ptr[i * stride] = blk_ptr[i];
+            }
+         }
+         break;
+      }
+      case PC_FUSED_F32:
+      {
+         const float32_t fq31 = (float32_t)(PC_FUSED_IQ31);
+         if (cnv_ptr->out_swap)
+         {
+            uint32_t *out_ptr = (uint32_t *)dst_ptr;
+            for (i = 0; i < num_samples; i++)
+            {
+               pc_fused_f32_bits_t samp;
+               samp.f              = ((float32_t)blk_ptr[i]) / fq31;
+               out_ptr[i * stride] = pc_fused_swap32(samp.u);
+            }
+         }
+         else
+         {
+            float32_t *out_ptr = (float32_t *)dst_ptr;
+            for (i = 0; i < num_samples; i++)
+            {
+               out_ptr[i * stride] = ((float32_t)blk_ptr[i]) / fq31;
+            }
+         }
+         break;
+      }
+      case PC_FUSED_F64:
+      {
+         const float64_t dq31    = (float64_t)(PC_FUSED_DQ31);
+         float64_t *     out_ptr = (float64_t *)dst_ptr;
+         for (i = 0; i < num_samples; i++)
+         {
+            out_ptr[i * stride] = ((float64_t)blk_ptr[i]) / dq31;
+         }
+         break;
+      }
+      default:
+      {
+         break;
+      }
+   }
+}
+
+/*______________________________________________________________________________________________________________________
+   DESCRIPTION:
+   Converts the remapped input buffer into the remapped output buffer. Frames are converted in blocks of
+   PC_FUSED_BLOCK_SIZE, all channels of a block are done before moving to the next block so interleaved data is read or
+   written once while it is in the cache.
+   Like the process chain, only the first channel length is read and written for deinterleaved buffers.
+______________________________________________________________________________________________________________________*/
+ar_result_t pc_fused_cnv_process(pc_lib_t *pc_ptr, capi_buf_t *input_buf_ptr, capi_buf_t *output_buf_ptr)
+{
+   pc_fused_cnv_t *cnv_ptr      = &pc_ptr->core_lib.fused_cnv;
+   uint32_t        num_channels = pc_ptr->core_lib.input_media_fmt.num_channels;
+   bool_t          in_intlv     = (PC_INTERLEAVED == pc_ptr->core_lib.input_media_fmt.interleaving);
+   bool_t          out_intlv    = (PC_INTERLEAVED == pc_ptr->core_lib.output_media_fmt.interleaving);
+   uint32_t        in_bytes     = pc_fused_bytes_per_samp(cnv_ptr->in_type);
+   uint32_t        out_bytes    = pc_fused_bytes_per_samp(cnv_ptr->out_type);
+   uint32_t        in_stride    = in_intlv ? num_channels : 1;
+   uint32_t        out_stride   = out_intlv ? num_channels : 1;
+   uint32_t        num_frames   = 0;
+   int32_t         blk[PC_FUSED_BLOCK_SIZE];
+
+   if (0 == num_channels)
+   {
+      return AR_EFAILED;
+   }
+
+   num_frames = in_intlv ? (input_buf_ptr->actual_data_len / (in_bytes * num_channels))
+                         : (input_buf_ptr[0].actual_data_len / in_bytes);
+
+   for (uint32_t frame = 0; frame < num_frames; frame += PC_FUSED_BLOCK_SIZE)
+   {
+      uint32_t num_samples = MIN(PC_FUSED_BLOCK_SIZE, num_frames - frame);
+
+      for (uint32_t ch = 0; ch < num_channels; ch++)
+      {
+         int8_t *src_ptr = in_intlv ? (input_buf_ptr->data_ptr + (((frame * num_channels) + ch) * in_bytes))
+                                    : (input_buf_ptr[ch].data_ptr + (frame * in_bytes));
+         int8_t *dst_ptr = out_intlv ? (output_buf_ptr->data_ptr + (((frame * num_channels) + ch) * out_bytes))
+                                     : (output_buf_ptr[ch].data_ptr + (frame * out_bytes));
+
+         pc_fused_read(cnv_ptr, src_ptr, in_stride, blk, num_samples);
+         if (cnv_ptr->is_byte_cnv)
+         {
+            pc_fused_byte_cnv(cnv_ptr, blk, num_samples);
+         }
+         pc_fused_write(cnv_ptr, blk, dst_ptr, out_stride, num_samples);
+      }
+   }
+
+   // optimization: write/read only first ch lens, and assume same lens for rest of the chs
+   if (out_intlv)
+   {
+      output_buf_ptr->actual_data_len = num_frames * out_bytes * num_channels;
+   }
+   else
+   {
+      output_buf_ptr[0].actual_data_len = num_frames * out_bytes;
+   }
+
+   return AR_EOK;
+}
@@ -1134,6 +1134,137 @@ void pc_fill_proc_info(pc_lib_t *pc_ptr)
       }
    }
 }
+/*______________________________________________________________________________________________________________________
+   DESCRIPTION:
+   Returns the sample type of the media format as handled by the fused conversion.
+   24 bit packed data and Q factors not handled by the byte conversion return PC_FUSED_INVALID_SAMP.
+______________________________________________________________________________________________________________________*/
+static pc_fused_samp_t pc_get_fused_samp_type(pc_media_fmt_t *mf_ptr)
+{
+   if (PC_FLOATING_FORMAT == mf_ptr->data_format)
+   {
+      if (!pc_is_floating_point_data_format_supported())
+      {
+         return PC_FUSED_INVALID_SAMP;
+      }
+      if (PC_BW32_W32_FLOAT == mf_ptr->byte_combo)
+      {
+         return PC_FUSED_F32;
+      }
+      if (PC_BW64_W64_DOUBLE == mf_ptr->byte_combo)
+      {
+         return PC_FUSED_F64;
+      }
+   }
+   else if (PC_FIXED_FORMAT == mf_ptr->data_format)
+   {
+      if (PC_BW16_W16_Q15 == mf_ptr->byte_combo)
+      {
+         return PC_FUSED_S16;
+      }
+      if ((32 == mf_ptr->word_size) && ((PCM_Q_FACTOR_23 == mf_ptr->q_factor) ||
+                                        (PCM_Q_FACTOR_27 == mf_ptr->q_factor) || (PCM_Q_FACTOR_31 == mf_ptr->q_factor)))
+      {
+         return PC_FUSED_S32;
+      }
+   }
+   return PC_FUSED_INVALID_SAMP;
+}
+
+/*______________________________________________________________________________________________________________________
+   DESCRIPTION:
+   Enables the fused single pass conversion if the process chain only has endianness, float <-> fixed, interleaving and
+   byte conversion processes and at least two of them are enabled. Chains with channel mixer, resampler, 24 bit packed
+   data, deinterleaved packed buffers or 64 bit byte swap keep using the process chain.
+______________________________________________________________________________________________________________________*/
+static void pc_select_fused_cnv(pc_lib_t *pc_ptr)
+{
+   pc_fused_cnv_t *   cnv_ptr     = &pc_ptr->core_lib.fused_cnv;
+   pc_process_flags_t flags       = pc_ptr->core_lib.flags;
+   pc_media_fmt_t *   imf_ptr     = &pc_ptr->core_lib.input_media_fmt;
+   pc_media_fmt_t *   omf_ptr     = &pc_ptr->core_lib.output_media_fmt;
+   uint32_t           num_process = 0;
+
+   memset(cnv_ptr, 0, sizeof(pc_fused_cnv_t));
+
+   if (flags.CHANNEL_MIXER || flags.RESAMPLER_PRE || flags.RESAMPLER_POST || flags.BYTE_CNV_PRE ||
+       (imf_ptr->num_channels != omf_ptr->num_channels) || (PC_DEINTERLEAVED_PACKED == imf_ptr->interleaving) ||
+       (PC_DEINTERLEAVED_PACKED == omf_ptr->interleaving))
+   {
+      return;
+   }
+
+   for (uint32_t i = 0; i < NUMBER_OF_PROCESS; i++)
+   {
+      if (NULL != pc_ptr->core_lib.pc_proc_info[i].process)
+      {
+         num_process++;
+      }
+   }
+
+   // a single process already makes one pass
+   if (num_process < 2)
+   {
+      return;
+   }
+
+   cnv_ptr->in_type  = pc_get_fused_samp_type(imf_ptr);
+   cnv_ptr->out_type = pc_get_fused_samp_type(omf_ptr);
+   cnv_ptr->in_swap  = flags.ENDIANNESS_PRE;
+   cnv_ptr->out_swap = flags.ENDIANNESS_POST;
+
+   if ((PC_FUSED_INVALID_SAMP == cnv_ptr->in_type) || (PC_FUSED_INVALID_SAMP == cnv_ptr->out_type) ||
+       (cnv_ptr->in_swap && (PC_FUSED_F64 == cnv_ptr->in_type)) ||
+       (cnv_ptr->out_swap && (PC_FUSED_F64 == cnv_ptr->out_type)))
+   {
+      return;
+   }
+
+   // float to fixed conversion generates Q31, fixed to float conversion takes Q31
+   if (flags.DATA_CNV_FLOAT_TO_FIXED)
+   {
+      cnv_ptr->mid_in_type     = PC_FUSED_S32;
+      cnv_ptr->mid_in_q_factor = PCM_Q_FACTOR_31;
+   }
+   else if ((PC_FUSED_S16 == cnv_ptr->in_type) || (PC_FUSED_S32 == cnv_ptr->in_type))
+   {
+      cnv_ptr->mid_in_type     = cnv_ptr->in_type;
+      cnv_ptr->mid_in_q_factor = imf_ptr->q_factor;
+   }
+   else
+   {
+      return;
+   }
+
+   if (flags.DATA_CNV_FIXED_TO_FLOAT)
+   {
+      cnv_ptr->mid_out_type     = PC_FUSED_S32;
+      cnv_ptr->mid_out_q_factor = PCM_Q_FACTOR_31;
+   }
+   else if ((PC_FUSED_S16 == cnv_ptr->out_type) || (PC_FUSED_S32 == cnv_ptr->out_type))
+   {
+      cnv_ptr->mid_out_type     = cnv_ptr->out_type;
+      cnv_ptr->mid_out_q_factor = omf_ptr->q_factor;
+   }
+   else
+   {
+      return;
+   }
+
+   cnv_ptr->is_byte_cnv = (cnv_ptr->mid_in_type != cnv_ptr->mid_out_type) ||
+                          (cnv_ptr->mid_in_q_factor != cnv_ptr->mid_out_q_factor);
+   if (cnv_ptr->is_byte_cnv != (bool_t)flags.BYTE_CNV_POST)
+   {
+      return;
+   }
+
+   // byte conversion runs after INT_DEINT_PRE, on interleaved data only if neither interleaving process is present
+   cnv_ptr->is_intlv_byte_cnv = (PC_INTERLEAVED == imf_ptr->interleaving) && (!flags.INT_DEINT_PRE);
+   cnv_ptr->is_enabled        = TRUE;
+
+   CNV_MSG(pc_ptr->miid, DBG_HIGH_PRIO, "Fused conversion replaces %lu processes", num_process);
+}
+
 /*______________________________________________________________________________________________________________________
    DESCRIPTION:
    Checks if the channel mixer is needed or not.
@@ -1370,6 +1501,8 @@ ar_result_t pc_init(pc_lib_t *      pc_ptr,
 
    pc_fill_proc_info(pc_ptr);
 
+   pc_select_fused_cnv(pc_ptr);
+
    result = pc_check_create_resampler_instance(pc_ptr, heap_id, fir_rs_reinit);
 
    pc_reinit_ch_mixer(pc_ptr, channel_mixer_lib_size, coef_set_ptr);
@@ -586,6 +586,27 @@ ar_result_t pc_process(pc_lib_t *  pc_ptr,
       return AR_ENEEDMORE;
    }
 
+   // fused conversion reads each block of input before writing it, it needs separate input and output buffers
+   if ((pc_ptr->core_lib.fused_cnv.is_enabled) && (input_buf_ptr->data_ptr != output_buf_ptr->data_ptr))
+   {
+      capi_buf_t *fused_output_buf_ptr = pc_ptr->core_lib.remap_output_buf_ptr;
+      pc_remap_buffer(pc_ptr,
+                      input_buf_ptr,
+                      output_buf_ptr,
+                      scratch_buf_ptr_1,
+                      scratch_buf_ptr_2,
+                      next_input_buf_ptr,
+                      fused_output_buf_ptr,
+                      next_input_media_fmt_ptr,
+                      &pc_ptr->core_lib.output_media_fmt,
+                      FALSE);
+
+      result = pc_fused_cnv_process(pc_ptr, next_input_buf_ptr, fused_output_buf_ptr);
+
+      output_buf_ptr->actual_data_len = fused_output_buf_ptr->actual_data_len;
+      return result;
+   }
+
    for (uint32_t i = 0; i < NUMBER_OF_PROCESS; i++)
    {      if (NULL != pc_ptr->core_lib.pc_proc_info[i].process)
       {
@@ -0,0 +1,390 @@
+/*==============================================================================
+  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+  SPDX-License-Identifier: BSD-3-Clause-Clear
+  ==============================================================================*/
+
+/*============================================================================
+  FILE:          pc_fused_cnv_test.cpp
+
+  OVERVIEW:      Regression test for the fused conversion of the PCM converter.
+                 Every input/output media format pair is initialized with
+                 pc_init. For each pair that pc_init routes to the fused
+                 conversion, pc_process is run once with the fused conversion
+                 and once with the process chain it replaces, on the same
+                 random and edge case input, and the outputs must match bit
+                 for bit. This covers 16/32 bit fixed point in each Q factor,
+                 float and double, interleaved and deinterleaved unpacked
+                 buffers, byte swaps on either side, the non saturating 32 to
+                 16 bit conversion of interleaved data and float samples at
+                 and above full scale. Frame counts below, at and above the
+                 fused block size are used.
+
+  DEPENDENCIES:  PCM converter library, channel mixer and resampler
+                 libraries, posal.
+
+  ============================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pc_converter.h"
+
+#define PC_TST_MAX_CHS 8
+#define PC_TST_MAX_FRAMES 300
+#define PC_TST_MAX_BYTES (PC_TST_MAX_FRAMES * PC_TST_MAX_CHS * 8)
+#define PC_TST_NUM_CALLS 4
+
+typedef struct pc_tst_fmt_t
+{
+   const char *     name;
+   pc_data_format_t data_format;
+   uint16_t         bit_width;
+   uint16_t         word_size;
+   uint16_t         q_factor;
+} pc_tst_fmt_t;
+
+/* 24 bit packed is included to make sure it stays on the process chain */
+static const pc_tst_fmt_t pc_tst_fmts[] = {
+   { "Q15", PC_FIXED_FORMAT, 16, 16, PCM_Q_FACTOR_15 },
+   { "24/24 Q23", PC_FIXED_FORMAT, 24, 24, PCM_Q_FACTOR_23 },
+   { "24/32 Q23", PC_FIXED_FORMAT, 24, 32, PCM_Q_FACTOR_23 },
+   { "24/32 Q27", PC_FIXED_FORMAT, 24, 32, PCM_Q_FACTOR_27 },
+   { "Q31", PC_FIXED_FORMAT, 32, 32, PCM_Q_FACTOR_31 },
+   { "float", PC_FLOATING_FORMAT, 32, 32, PCM_Q_FACTOR_31 },
+   { "double", PC_FLOATING_FORMAT, 64, 64, PCM_Q_FACTOR_31 },
+};
+
+static const uint32_t pc_tst_num_chs[]               = { 1, 2, 3, 8 };
+static const uint32_t pc_tst_frames[]                = { 1, 63, 64, 65, 128, 129, 257, PC_TST_MAX_FRAMES };
+static uint16_t       pc_tst_ch_type[PC_TST_MAX_CHS] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+static uint32_t pc_tst_seed;
+static int8_t   pc_tst_in[PC_TST_MAX_BYTES];
+static int8_t   pc_tst_in_copy[PC_TST_MAX_BYTES];
+static int8_t   pc_tst_out[PC_TST_MAX_BYTES];
+static int8_t   pc_tst_ref[PC_TST_MAX_BYTES];
+static int8_t   pc_tst_scratch1[PC_TST_MAX_BYTES];
+static int8_t   pc_tst_scratch2[PC_TST_MAX_BYTES];
+
+// what the fused cases covered, all of it is required at the end
+static uint32_t pc_tst_num_fused, pc_tst_num_intlv_byte_cnv, pc_tst_num_in_swap, pc_tst_num_out_swap;
+static uint32_t pc_tst_num_float_in, pc_tst_num_double_in, pc_tst_num_float_out, pc_tst_num_double_out;
+static uint32_t pc_tst_num_wrapped;
+
+static uint32_t pc_tst_rand(void)
+{
+   // xorshift32
+   pc_tst_seed ^= pc_tst_seed << 13;
+   pc_tst_seed ^= pc_tst_seed >> 17;
+   pc_tst_seed ^= pc_tst_seed << 5;
+   return pc_tst_seed;
+}
+
+static void pc_tst_swap_bytes(int8_t *ptr, uint32_t num_bytes)
+{
+   for (uint32_t i = 0; i < num_bytes / 2; i++)
+   {
+      int8_t temp            = ptr[i];
+      ptr[i]                 = ptr[num_bytes - 1 - i];
+      ptr[num_bytes - 1 - i] = temp;
+   }
+}
+
+/* Random values in and around the Q format range, and the values at its edges */
+static int32_t pc_tst_fixed_sample(uint16_t q_factor)
+{
+   int32_t full_scale = (int32_t)((1ll << q_factor) - 1);
+
+   switch (pc_tst_rand() % 8)
+   {
+      case 0:
+         return (int32_t)pc_tst_rand();
+      case 1:
+      {
+         static const int32_t edges[] = { 0, 1, -1, INT32_MAX, INT32_MIN };
+         return edges[pc_tst_rand() % (sizeof(edges) / sizeof(edges[0]))];
+      }
+      case 2:
+         return (pc_tst_rand() & 1) ? full_scale : (-full_scale - 1);
+      case 3:
+         // just outside the Q format range, saturated by the deinterleaved byte conversion only
+         return (pc_tst_rand() & 1) ? (int32_t)(full_scale + 1 + (pc_tst_rand() & 0xFF))
+                                    : (int32_t)(-full_scale - 2 - (pc_tst_rand() & 0xFF));
+      default:
+         return (int32_t)((int64_t)(int32_t)pc_tst_rand() % (full_scale + 1ll));
+   }
+}
+
+/* Random values in [-1.25, 1.25), full scale, just above it and a few out of range values */
+static float64_t pc_tst_float_sample(void)
+{
+   switch (pc_tst_rand() % 8)
+   {
+      case 0:
+      {
+         static const float64_t edges[] = { 1.0, -1.0, 0.0, -0.0, 0.5, 1.0 + 1e-6, -1.0 - 1e-6, 2.0, -2.0, 1e-40 };
+         return edges[pc_tst_rand() % (sizeof(edges) / sizeof(edges[0]))];
+      }
+      case 1:
+         return (pc_tst_rand() & 1) ? 1.0 : -1.0;
+      default:
+         return ((float64_t)(int32_t)pc_tst_rand() / 2147483648.0) * 1.25;
+   }
+}
+
+static void pc_tst_fill_input(const pc_tst_fmt_t *fmt_ptr, bool_t swap, uint32_t num_samples)
+{
+   uint32_t num_bytes = fmt_ptr->word_size >> 3;
+
+   for (uint32_t i = 0; i < num_samples; i++)
+   {
+      int8_t *samp_ptr = pc_tst_in + (i * num_bytes);
+      if (PC_FLOATING_FORMAT == fmt_ptr->data_format)
+      {
+         float64_t value = pc_tst_float_sample();
+         if (64 == fmt_ptr->word_size)
+         {
+            memcpy(samp_ptr, &value, sizeof(value));
+         }
+         else
+         {
+            float32_t value32 = (float32_t)value;
+            memcpy(samp_ptr, &value32, sizeof(value32));
+         }
+      }
+      else if (16 == fmt_ptr->word_size)
+      {
+         int16_t value = (int16_t)pc_tst_fixed_sample(PCM_Q_FACTOR_15);
+         memcpy(samp_ptr, &value, sizeof(value));
+      }
+      else
+      {
+         int32_t value = pc_tst_fixed_sample(fmt_ptr->q_factor);
+         memcpy(samp_ptr, &value, num_bytes);
+      }
+
+      if (swap)
+      {
+         pc_tst_swap_bytes(samp_ptr, num_bytes);
+      }
+   }
+}
+
+static void pc_tst_fill_media_fmt(pc_media_fmt_t *     mf_ptr,
+                                  const pc_tst_fmt_t * fmt_ptr,
+                                  bool_t               is_big_endian,
+                                  bool_t               is_interleaved,
+                                  uint32_t             num_chs)
+{
+   memset(mf_ptr, 0, sizeof(pc_media_fmt_t));
+   mf_ptr->sampling_rate = 48000;
+   mf_ptr->endianness    = is_big_endian ? PC_BIG_ENDIAN : PC_LITTLE_ENDIAN;
+   mf_ptr->interleaving  = is_interleaved ? PC_INTERLEAVED : PC_DEINTERLEAVED_UNPACKED_V2;
+   mf_ptr->alignment     = PC_LSB_ALIGNED;
+   mf_ptr->data_format   = fmt_ptr->data_format;
+   mf_ptr->bit_width     = fmt_ptr->bit_width;
+   mf_ptr->word_size     = fmt_ptr->word_size;
+   mf_ptr->q_factor      = fmt_ptr->q_factor;
+   mf_ptr->num_channels  = num_chs;
+   mf_ptr->channel_type  = pc_tst_ch_type;
+   mf_ptr->byte_combo    = pc_classify_mf(mf_ptr);
+}
+
+/* Sets up the interleaved buffer or the unpacked channel buffers on top of data_ptr */
+static void pc_tst_setup_bufs(capi_buf_t *    bufs_ptr,
+                              int8_t *        data_ptr,
+                              pc_media_fmt_t *mf_ptr,
+                              uint32_t        num_frames,
+                              bool_t          is_input)
+{
+   uint32_t bytes_per_ch = num_frames * (mf_ptr->word_size >> 3);
+
+   memset(bufs_ptr, 0, sizeof(capi_buf_t) * PC_TST_MAX_CHS);
+   if (PC_INTERLEAVED == mf_ptr->interleaving)
+   {
+      bufs_ptr[0].data_ptr        = data_ptr;
+      bufs_ptr[0].max_data_len    = bytes_per_ch * mf_ptr->num_channels;
+      bufs_ptr[0].actual_data_len = is_input ? bufs_ptr[0].max_data_len : 0;
+      return;
+   }
+
+   for (uint32_t ch = 0; ch < mf_ptr->num_channels; ch++)
+   {
+      bufs_ptr[ch].data_ptr     = data_ptr + (ch * bytes_per_ch);
+      bufs_ptr[ch].max_data_len = bytes_per_ch;
+   }
+   bufs_ptr[0].actual_data_len = is_input ? bytes_per_ch : 0;
+}
+
+static ar_result_t pc_tst_process(pc_lib_t *      pc_ptr,
+                                  pc_media_fmt_t *imf_ptr,
+                                  pc_media_fmt_t *omf_ptr,
+                                  uint32_t        num_frames,
+                                  int8_t *        out_ptr,
+                                  uint32_t *      out_len_ptr)
+{
+   capi_buf_t in_bufs[PC_TST_MAX_CHS];
+   capi_buf_t out_bufs[PC_TST_MAX_CHS];
+   capi_buf_t scratch1 = { pc_tst_scratch1, 0, PC_TST_MAX_BYTES };
+   capi_buf_t scratch2 = { pc_tst_scratch2, 0, PC_TST_MAX_BYTES };
+
+   // the chain swaps the input in place, give each run its own copy
+   memcpy(pc_tst_in_copy, pc_tst_in, PC_TST_MAX_BYTES);
+   memset(out_ptr, 0x5A, PC_TST_MAX_BYTES);
+   pc_tst_setup_bufs(in_bufs, pc_tst_in_copy, imf_ptr, num_frames, TRUE);
+   pc_tst_setup_bufs(out_bufs, out_ptr, omf_ptr, num_frames, FALSE);
+
+   ar_result_t result = pc_process(pc_ptr, in_bufs, out_bufs, &scratch1, &scratch2);
+   *out_len_ptr       = out_bufs[0].actual_data_len;
+   return result;
+}
+
+static void pc_tst_count_wrapped(pc_lib_t *pc_ptr, uint32_t num_samples)
+{
+   pc_fused_cnv_t *cnv_ptr = &pc_ptr->core_lib.fused_cnv;
+
+   if (!cnv_ptr->is_intlv_byte_cnv || cnv_ptr->in_swap || (PC_FUSED_S32 != cnv_ptr->in_type) ||
+       (PC_FUSED_S16 != cnv_ptr->mid_out_type))
+   {
+      return;
+   }
+
+   // samples outside the Q format range, which the interleaved 32 to 16 bit conversion does not saturate
+   int32_t *in_ptr = (int32_t *)pc_tst_in;
+   int64_t  limit  = 1ll << cnv_ptr->mid_in_q_factor;
+   for (uint32_t i = 0; i < num_samples; i++)
+   {
+      if ((in_ptr[i] >= limit) || (in_ptr[i] < -limit))
+      {
+         pc_tst_num_wrapped++;
+      }
+   }
+}
+
+/* Returns the number of mismatching calls, or 0 if the pair isn't routed to the fused conversion */
+static uint32_t pc_tst_run_case(pc_media_fmt_t *imf_ptr, pc_media_fmt_t *omf_ptr, const pc_tst_fmt_t *in_fmt_ptr)
+{
+   pc_lib_t    pc;
+   bool_t      lib_enable = FALSE;
+   uint32_t    num_errors = 0;
+   ar_result_t result;
+
+   memset(&pc, 0, sizeof(pc));
+   result = pc_init(&pc, imf_ptr, omf_ptr, NULL, POSAL_HEAP_DEFAULT, &lib_enable, FALSE, 0, PCM_CNV);
+   if ((AR_EOK != result) || !lib_enable || !pc.core_lib.fused_cnv.is_enabled)
+   {
+      pc_deinit(&pc);
+      return 0;
+   }
+
+   pc_fused_cnv_t *cnv_ptr = &pc.core_lib.fused_cnv;
+   if ((24 == imf_ptr->word_size) || (24 == omf_ptr->word_size))
+   {
+      printf("24 bit packed samples must stay on the process chain\n");
+      pc_deinit(&pc);
+      return 1;
+   }
+
+   pc_tst_num_fused++;
+   pc_tst_num_intlv_byte_cnv += (cnv_ptr->is_byte_cnv && cnv_ptr->is_intlv_byte_cnv) ? 1 : 0;
+   pc_tst_num_in_swap += cnv_ptr->in_swap ? 1 : 0;
+   pc_tst_num_out_swap += cnv_ptr->out_swap ? 1 : 0;
+   pc_tst_num_float_in += (PC_FUSED_F32 == cnv_ptr->in_type) ? 1 : 0;
+   pc_tst_num_double_in += (PC_FUSED_F64 == cnv_ptr->in_type) ? 1 : 0;
+   pc_tst_num_float_out += (PC_FUSED_F32 == cnv_ptr->out_type) ? 1 : 0;
+   pc_tst_num_double_out += (PC_FUSED_F64 == cnv_ptr->out_type) ? 1 : 0;
+
+   for (uint32_t call = 0; call < PC_TST_NUM_CALLS; call++)
+   {
+      uint32_t num_frames = pc_tst_frames[pc_tst_rand() % (sizeof(pc_tst_frames) / sizeof(pc_tst_frames[0]))];
+      uint32_t num_chs    = imf_ptr->num_channels;
+      uint32_t out_len = 0, ref_len = 0;
+
+      pc_tst_fill_input(in_fmt_ptr, (PC_BIG_ENDIAN == imf_ptr->endianness), num_frames * num_chs);
+      pc_tst_count_wrapped(&pc, num_frames * num_chs);
+
+      cnv_ptr->is_enabled = TRUE;
+      ar_result_t fused_result = pc_tst_process(&pc, imf_ptr, omf_ptr, num_frames, pc_tst_out, &out_len);
+      cnv_ptr->is_enabled = FALSE;
+      ar_result_t ref_result = pc_tst_process(&pc, imf_ptr, omf_ptr, num_frames, pc_tst_ref, &ref_len);
+
+      // unused bytes of the output buffers are compared as well, neither path may write past the data
+      if ((fused_result != ref_result) || (out_len != ref_len) || memcmp(pc_tst_out, pc_tst_ref, PC_TST_MAX_BYTES))
+      {
+         num_errors++;
+      }
+   }
+
+   pc_deinit(&pc);
+   return num_errors;
+}
+
+int main(int argc, char *argv[])
+{
+   uint32_t num_fmts  = sizeof(pc_tst_fmts) / sizeof(pc_tst_fmts[0]);
+   uint32_t num_cases = 0, num_failed = 0;
+
+   pc_tst_seed = 0x1234567;
+   posal_init();
+
+   for (uint32_t i = 0; i < num_fmts; i++)
+   {
+      for (uint32_t o = 0; o < num_fmts; o++)
+      {
+         for (uint32_t c = 0; c < sizeof(pc_tst_num_chs) / sizeof(pc_tst_num_chs[0]); c++)
+         {
+            // bit 0/1: input/output big endian, bit 2/3: input/output interleaved
+            for (uint32_t layout = 0; layout < 16; layout++)
+            {
+               pc_media_fmt_t imf, omf;
+               pc_tst_fill_media_fmt(&imf, &pc_tst_fmts[i], layout & 1, (layout >> 2) & 1, pc_tst_num_chs[c]);
+               pc_tst_fill_media_fmt(&omf, &pc_tst_fmts[o], (layout >> 1) & 1, (layout >> 3) & 1, pc_tst_num_chs[c]);
+
+               uint32_t num_errors = pc_tst_run_case(&imf, &omf, &pc_tst_fmts[i]);
+               num_cases++;
+               if (num_errors)
+               {
+                  num_failed++;
+                  printf("%s %s %s -> %s %s %s, %lu channels: %lu of %d calls mismatch\n",
+                         pc_tst_fmts[i].name,
+                         (layout & 1) ? "BE" : "LE",
+                         ((layout >> 2) & 1) ? "interleaved" : "unpacked",
+                         pc_tst_fmts[o].name,
+                         ((layout >> 1) & 1) ? "BE" : "LE",
+                         ((layout >> 3) & 1) ? "interleaved" : "unpacked",
+                         (unsigned long)pc_tst_num_chs[c],
+                         (unsigned long)num_errors,
+                         PC_TST_NUM_CALLS);
+               }
+            }
+         }
+      }
+   }
+
+   printf("%lu of %lu format pairs fused, %lu failed\n",
+          (unsigned long)pc_tst_num_fused,
+          (unsigned long)num_cases,
+          (unsigned long)num_failed);
+   printf("fused coverage: %lu interleaved byte cnv (%lu samples out of Q range), %lu/%lu in/out swap, "
+          "%lu/%lu float in/out, %lu/%lu double in/out\n",
+          (unsigned long)pc_tst_num_intlv_byte_cnv,
+          (unsigned long)pc_tst_num_wrapped,
+          (unsigned long)pc_tst_num_in_swap,
+          (unsigned long)pc_tst_num_out_swap,
+          (unsigned long)pc_tst_num_float_in,
+          (unsigned long)pc_tst_num_float_out,
+          (unsigned long)pc_tst_num_double_in,
+          (unsigned long)pc_tst_num_double_out);
+
+   posal_deinit();
+
+   if ((0 == pc_tst_num_intlv_byte_cnv) || (0 == pc_tst_num_wrapped) || (0 == pc_tst_num_in_swap) ||
+       (0 == pc_tst_num_out_swap) || (0 == pc_tst_num_float_in) || (0 == pc_tst_num_float_out) ||
+       (0 == pc_tst_num_double_in) || (0 == pc_tst_num_double_out))
+   {
+      printf("fused conversion isn't selected for all the covered cases\n");
+      return -1;
+   }
+
+   return num_failed ? -1 : 0;
+}
@@ -19,6 +19,7 @@ LOCAL_EXPORT_C_INCLUDE_DIRS := \
 
 LOCAL_SRC_FILES := \
     capi/src/capi_sal.cpp \
+    capi/src/capi_sal_acc_island.cpp \
     capi/src/capi_sal_island.cpp \
     capi/src/capi_sal_md_utils_island.cpp \
     capi/src/capi_sal_port_utils.cpp \
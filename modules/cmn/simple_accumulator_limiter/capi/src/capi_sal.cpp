@@ -105,6 +105,15 @@ capi_err_t capi_sal_end(capi_t *_pif)
       me_ptr->started_in_port_index_arr = NULL;
    }
 
+#ifdef SAL_FUSED_ACC
+   if (NULL != me_ptr->acc_in_arr)
+   {
+      posal_memory_free(me_ptr->acc_in_arr);
+      me_ptr->acc_in_arr     = NULL;
+      me_ptr->acc_ch_in_pptr = NULL;
+   }
+#endif
+
    capi_result |= capi_sal_destroy_scratch_ptr_buf(me_ptr);
    me_ptr->vtbl.vtbl_ptr = NULL;
 
@@ -847,6 +856,25 @@ capi_err_t capi_sal_set_properties(capi_t *_pif, capi_proplist_t *props_ptr)
             }
             memset(me_ptr->started_in_port_index_arr, -1, me_ptr->num_in_ports * sizeof(int32_t));
 
+#ifdef SAL_FUSED_ACC
+            // accumulation queue and the per channel input pointer array, in one allocation
+            if (NULL != me_ptr->acc_in_arr)
+            {
+               posal_memory_free(me_ptr->acc_in_arr);
+            }
+            me_ptr->acc_in_arr =
+               (sal_acc_in_t *)posal_memory_malloc(me_ptr->num_in_ports * (sizeof(sal_acc_in_t) + sizeof(int8_t *)),
+                                                   (POSAL_HEAP_ID)me_ptr->heap_mem.heap_id);
+            if (NULL == me_ptr->acc_in_arr)
+            {
+               AR_MSG(DBG_ERROR_PRIO, "memory allocation failure");
+               capi_result |= CAPI_ENOMEMORY;
+               break;
+            }
+            me_ptr->acc_ch_in_pptr = (int8_t **)(me_ptr->acc_in_arr + me_ptr->num_in_ports);
+            me_ptr->num_acc_in     = 0;
+#endif
+
             // false (inactive) intialize
             memset(me_ptr->in_port_arr, 0, me_ptr->num_in_ports * sizeof(sal_in_port_array_t));
             for (uint32_t i = 0; i < me_ptr->num_in_ports; i++)
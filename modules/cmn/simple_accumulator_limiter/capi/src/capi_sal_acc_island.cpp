@@ -0,0 +1,461 @@
+/* ======================================================================== */
+/**
+   @file capi_sal_acc_island.cpp
+
+   Source file to implement the single pass N input accumulation of the
+   Simple Accumulator-Limiter (SAL) Module.
+*/
+
+/* =========================================================================
+   Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+   SPDX-License-Identifier: BSD-3-Clause-Clear
+   ========================================================================== */
+
+/*==========================================================================
+Include files
+========================================================================== */
+#include "capi_sal_utils.h"
+#include "audio_basic_op.h"
+
+#ifdef SAL_FUSED_ACC
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SAL_ACC_X86_AVX2
+#include <immintrin.h>
+#define SAL_ACC_AVX2_FN __attribute__((target("avx2")))
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define SAL_ACC_ARM_NEON
+#include <arm_neon.h>
+#endif
+
+/* Samples per channel accumulated at a time, small enough for the block to stay in L1 across the inputs */
+#define SAL_ACC_BLOCK_SAMPLES 256
+
+#define SAL_ACC_MAX_Q27 ((int32_t)((1 << PCM_Q_FACTOR_27) - 1))
+#define SAL_ACC_MIN_Q27 ((int32_t)(-(1 << PCM_Q_FACTOR_27)))
+
+/*==========================================================================
+  Portable kernels. They add one input at a time over the block, which is
+  also how the SIMD kernels handle their last few samples.
+========================================================================== */
+static void sal_acc_16_to_32(int8_t **in_pptr, uint32_t num_in, int8_t *acc_ptr, uint32_t num_samples)
+{
+   int32_t *out_ptr = (int32_t *)acc_ptr;
+   int16_t *in_ptr  = (int16_t *)in_pptr[0];
+
+   for (uint32_t k = 0; k < num_samples; k++)
+   {
+      out_ptr[k] = in_ptr[k];
+   }
+   for (uint32_t i = 1; i < num_in; i++)
+   {
+      in_ptr = (int16_t *)in_pptr[i];
+      for (uint32_t k = 0; k < num_samples; k++)
+      {
+         out_ptr[k] += in_ptr[k];
+      }
+   }
+}
+
+static void sal_acc_16_sat(int8_t **in_pptr, uint32_t num_in, int8_t *acc_ptr, uint32_t num_samples)
+{
+   int16_t *out_ptr = (int16_t *)acc_ptr;
+
+   memscpy(out_ptr, num_samples * sizeof(int16_t), in_pptr[0], num_samples * sizeof(int16_t));
+   for (uint32_t i = 1; i < num_in; i++)
+   {
+      int16_t *in_ptr = (int16_t *)in_pptr[i];
+      for (uint32_t k = 0; k < num_samples; k++)
+      {
+         int32_t sum = (int32_t)out_ptr[k] + in_ptr[k];
+         out_ptr[k]  = (int16_t)((sum > MAX_16) ? MAX_16 : ((sum < MIN_16) ? MIN_16 : sum));
+      }
+   }
+}
+
+static void sal_acc_32(int8_t **in_pptr, uint32_t num_in, int8_t *acc_ptr, uint32_t num_samples)
+{
+   uint32_t *out_ptr = (uint32_t *)acc_ptr;
+
+   memscpy(out_ptr, num_samples * sizeof(int32_t), in_pptr[0], num_samples * sizeof(int32_t));
+   for (uint32_t i = 1; i < num_in; i++)
+   {
+      uint32_t *in_ptr = (uint32_t *)in_pptr[i];
+      for (uint32_t k = 0; k < num_samples; k++)
+      {
+         // wraps like s32_add_s32_s32
+         out_ptr[k] += in_ptr[k];
+      }
+   }
+}
+
+static void sal_acc_q27_sat(int8_t **in_pptr, uint32_t num_in, int8_t *acc_ptr, uint32_t num_samples)
+{
+   int32_t *out_ptr = (int32_t *)acc_ptr;
+
+   memscpy(out_ptr, num_samples * sizeof(int32_t), in_pptr[0], num_samples * sizeof(int32_t));
+   for (uint32_t i = 1; i < num_in; i++)
+   {
+      int32_t *in_ptr = (int32_t *)in_pptr[i];
+      for (uint32_t k = 0; k < num_samples; k++)
+      {
+         int32_t sum = (int32_t)((uint32_t)out_ptr[k] + (uint32_t)in_ptr[k]);
+         out_ptr[k]  = (sum > SAL_ACC_MAX_Q27) ? SAL_ACC_MAX_Q27 : ((sum < SAL_ACC_MIN_Q27) ? SAL_ACC_MIN_Q27 : sum);
+      }
+   }
+}
+
+static void sal_acc_32_sat(int8_t **in_pptr, uint32_t num_in, int8_t *acc_ptr, uint32_t num_samples)
+{
+   int32_t *out_ptr = (int32_t *)acc_ptr;
+
+   memscpy(out_ptr, num_samples * sizeof(int32_t), in_pptr[0], num_samples * sizeof(int32_t));
+   for (uint32_t i = 1; i < num_in; i++)
+   {
+      int32_t *in_ptr = (int32_t *)in_pptr[i];
+      for (uint32_t k = 0; k < num_samples; k++)
+      {
+         int64_t sum = (int64_t)out_ptr[k] + in_ptr[k];
+         out_ptr[k]  = (sum > INT32_MAX) ? INT32_MAX : ((sum < INT32_MIN) ? INT32_MIN : (int32_t)sum);
+      }
+   }
+}
+
+/* Offsets all input pointers by the samples a SIMD kernel already handled and finishes with the portable kernel */
+static inline void sal_acc_tail(sal_acc_fused_func_t func_ptr,
+                                int8_t **            in_pptr,
+                                uint32_t             num_in,
+                                int8_t *             acc_ptr,
+                                uint32_t             done,
+                                uint32_t             num_samples,
+                                uint32_t             in_ws,
+                                uint32_t             acc_ws)
+{
+   if (done >= num_samples)
+   {
+      return;
+   }
+   for (uint32_t i = 0; i < num_in; i++)
+   {
+      in_pptr[i] += done * in_ws;
+   }
+   func_ptr(in_pptr, num_in, acc_ptr + (done * acc_ws), num_samples - done);
+}
+
+#if defined(SAL_ACC_X86_AVX2)
+/*==========================================================================
+  AVX2 kernels. Each vector of samples is read from every input and summed
+  in registers, so the scratch is written once.
+========================================================================== */
+SAL_ACC_AVX2_FN static void sal_acc_16_to_32_avx2(int8_t **in_pptr, uint32_t num_in, int8_t *acc_ptr, uint32_t num_samples)
+{
+   int32_t *out_ptr = (int32_t *)acc_ptr;
+   uint32_t k       = 0;
+
+   for (; k + 8 <= num_samples; k += 8)
+   {
+      __m256i acc = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)((int16_t *)in_pptr[0] + k)));
+      for (uint32_t i = 1; i < num_in; i++)
+      {
+         acc = _mm256_add_epi32(acc, _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)((int16_t *)in_pptr[i] + k))));
+      }
+      _mm256_storeu_si256((__m256i *)(out_ptr + k), acc);
+   }
+   sal_acc_tail(sal_acc_16_to_32, in_pptr, num_in, acc_ptr, k, num_samples, sizeof(int16_t), sizeof(int32_t));
+}
+
+SAL_ACC_AVX2_FN static void sal_acc_16_sat_avx2(int8_t **in_pptr, uint32_t num_in, int8_t *acc_ptr, uint32_t num_samples)
+{
+   int16_t *out_ptr = (int16_t *)acc_ptr;
+   uint32_t k       = 0;
+
+   for (; k + 16 <= num_samples; k += 16)
+   {
+      __m256i acc = _mm256_loadu_si256((const __m256i *)((int16_t *)in_pptr[0] + k));
+      for (uint32_t i = 1; i < num_in; i++)
+      {
+         acc = _mm256_adds_epi16(acc, _mm256_loadu_si256((const __m256i *)((int16_t *)in_pptr[i] + k)));
+      }
+      _mm256_storeu_si256((__m256i *)(out_ptr + k), acc);
+   }
+   sal_acc_tail(sal_acc_16_sat, in_pptr, num_in, acc_ptr, k, num_samples, sizeof(int16_t), sizeof(int16_t));
+}
+
+SAL_ACC_AVX2_FN static void sal_acc_32_avx2(int8_t **in_pptr, uint32_t num_in, int8_t *acc_ptr, uint32_t num_samples)
+{
+   int32_t *out_ptr = (int32_t *)acc_ptr;
+   uint32_t k       = 0;
+
+   for (; k + 8 <= num_samples; k += 8)
+   {
+      __m256i acc = _mm256_loadu_si256((const __m256i *)((int32_t *)in_pptr[0] + k));
+      for (uint32_t i = 1; i < num_in; i++)
+      {
+         acc = _mm256_add_epi32(acc, _mm256_loadu_si256((const __m256i *)((int32_t *)in_pptr[i] + k)));
+      }
+      _mm256_storeu_si256((__m256i *)(out_ptr + k), acc);
+   }
+   sal_acc_tail(sal_acc_32, in_pptr, num_in, acc_ptr, k, num_samples, sizeof(int32_t), sizeof(int32_t));
+}
+
+SAL_ACC_AVX2_FN static void sal_acc_q27_sat_avx2(int8_t **in_pptr, uint32_t num_in, int8_t *acc_ptr, uint32_t num_samples)
+{
+   int32_t *     out_ptr = (int32_t *)acc_ptr;
+   const __m256i max_q27 = _mm256_set1_epi32(SAL_ACC_MAX_Q27);
+   const __m256i min_q27 = _mm256_set1_epi32(SAL_ACC_MIN_Q27);
+   uint32_t      k       = 0;
+
+   for (; k + 8 <= num_samples; k += 8)
+   {
+      __m256i acc = _mm256_loadu_si256((const __m256i *)((int32_t *)in_pptr[0] + k));
+      for (uint32_t i = 1; i < num_in; i++)
+      {
+         acc = _mm256_add_epi32(acc, _mm256_loadu_si256((const __m256i *)((int32_t *)in_pptr[i] + k)));
+         acc = _mm256_max_epi32(_mm256_min_epi32(acc, max_q27), min_q27);
+      }
+      _mm256_storeu_si256((__m256i *)(out_ptr + k), acc);
+   }
+   sal_acc_tail(sal_acc_q27_sat, in_pptr, num_in, acc_ptr, k, num_samples, sizeof(int32_t), sizeof(int32_t));
+}
+
+/* Saturating 32 bit add: on overflow both operands have the sign the sum lacks */
+SAL_ACC_AVX2_FN static inline __m256i sal_acc_adds_epi32_avx2(__m256i a, __m256i b)
+{
+   __m256i sum = _mm256_add_epi32(a, b);
+   __m256i ovf = _mm256_and_si256(_mm256_xor_si256(a, sum), _mm256_xor_si256(b, sum));
+   __m256i sat = _mm256_xor_si256(_mm256_srai_epi32(a, 31), _mm256_set1_epi32(INT32_MAX));
+
+   return _mm256_castps_si256(
+      _mm256_blendv_ps(_mm256_castsi256_ps(sum), _mm256_castsi256_ps(sat), _mm256_castsi256_ps(ovf)));
+}
+
+SAL_ACC_AVX2_FN static void sal_acc_32_sat_avx2(int8_t **in_pptr, uint32_t num_in, int8_t *acc_ptr, uint32_t num_samples)
+{
+   int32_t *out_ptr = (int32_t *)acc_ptr;
+   uint32_t k       = 0;
+
+   for (; k + 8 <= num_samples; k += 8)
+   {
+      __m256i acc = _mm256_loadu_si256((const __m256i *)((int32_t *)in_pptr[0] + k));
+      for (uint32_t i = 1; i < num_in; i++)
+      {
+         acc = sal_acc_adds_epi32_avx2(acc, _mm256_loadu_si256((const __m256i *)((int32_t *)in_pptr[i] + k)));
+      }
+      _mm256_storeu_si256((__m256i *)(out_ptr + k), acc);
+   }
+   sal_acc_tail(sal_acc_32_sat, in_pptr, num_in, acc_ptr, k, num_samples, sizeof(int32_t), sizeof(int32_t));
+}
+#endif // SAL_ACC_X86_AVX2
+
+#if defined(SAL_ACC_ARM_NEON)
+/*==========================================================================
+  NEON kernels, same structure as the AVX2 ones.
+========================================================================== */
+static void sal_acc_16_to_32_neon(int8_t **in_pptr, uint32_t num_in, int8_t *acc_ptr, uint32_t num_samples)
+{
+   int32_t *out_ptr = (int32_t *)acc_ptr;
+   uint32_t k       = 0;
+
+   for (; k + 8 <= num_samples; k += 8)
+   {
+      int16x8_t in  = vld1q_s16((int16_t *)in_pptr[0] + k);
+      int32x4_t lo  = vmovl_s16(vget_low_s16(in));
+      int32x4_t hi  = vmovl_s16(vget_high_s16(in));
+      for (uint32_t i = 1; i < num_in; i++)
+      {
+         in = vld1q_s16((int16_t *)in_pptr[i] + k);
+         lo = vaddw_s16(lo, vget_low_s16(in));
+         hi = vaddw_s16(hi, vget_high_s16(in));
+      }
+      vst1q_s32(out_ptr + k, lo);
+      vst1q_s32(out_ptr + k + 4, hi);
+   }
+   sal_acc_tail(sal_acc_16_to_32, in_pptr, num_in, acc_ptr, k, num_samples, sizeof(int16_t), sizeof(int32_t));
+}
+
+static void sal_acc_16_sat_neon(int8_t **in_pptr, uint32_t num_in, int8_t *acc_ptr, uint32_t num_samples)
+{
+   int16_t *out_ptr = (int16_t *)acc_ptr;
+   uint32_t k       = 0;
+
+   for (; k + 8 <= num_samples; k += 8)
+   {
+      int16x8_t acc = vld1q_s16((int16_t *)in_pptr[0] + k);
+      for (uint32_t i = 1; i < num_in; i++)
+      {
+         acc = vqaddq_s16(acc, vld1q_s16((int16_t *)in_pptr[i] + k));
+      }
+      vst1q_s16(out_ptr + k, acc);
+   }
+   sal_acc_tail(sal_acc_16_sat, in_pptr, num_in, acc_ptr, k, num_samples, sizeof(int16_t), sizeof(int16_t));
+}
+
+static void sal_acc_32_neon(int8_t **in_pptr, uint32_t num_in, int8_t *acc_ptr, uint32_t num_samples)
+{
+   int32_t *out_ptr = (int32_t *)acc_ptr;
+   uint32_t k       = 0;
+
+   for (; k + 4 <= num_samples; k += 4)
+   {
+      int32x4_t acc = vld1q_s32((int32_t *)in_pptr[0] + k);
+      for (uint32_t i = 1; i < num_in; i++)
+      {
+         acc = vaddq_s32(acc, vld1q_s32((int32_t *)in_pptr[i] + k));
+      }
+      vst1q_s32(out_ptr + k, acc);
+   }
+   sal_acc_tail(sal_acc_32, in_pptr, num_in, acc_ptr, k, num_samples, sizeof(int32_t), sizeof(int32_t));
+}
+
+static void sal_acc_q27_sat_neon(int8_t **in_pptr, uint32_t num_in, int8_t *acc_ptr, uint32_t num_samples)
+{
+   int32_t *       out_ptr = (int32_t *)acc_ptr;
+   const int32x4_t max_q27 = vdupq_n_s32(SAL_ACC_MAX_Q27);
+   const int32x4_t min_q27 = vdupq_n_s32(SAL_ACC_MIN_Q27);
+   uint32_t        k       = 0;
+
+   for (; k + 4 <= num_samples; k += 4)
+   {
+      int32x4_t acc = vld1q_s32((int32_t *)in_pptr[0] + k);
+      for (uint32_t i = 1; i < num_in; i++)
+      {
+         acc = vaddq_s32(acc, vld1q_s32((int32_t *)in_pptr[i] + k));
+         acc = vmaxq_s32(vminq_s32(acc, max_q27), min_q27);
+      }
+      vst1q_s32(out_ptr + k, acc);
+   }
+   sal_acc_tail(sal_acc_q27_sat, in_pptr, num_in, acc_ptr, k, num_samples, sizeof(int32_t), sizeof(int32_t));
+}
+
+static void sal_acc_32_sat_neon(int8_t **in_pptr, uint32_t num_in, int8_t *acc_ptr, uint32_t num_samples)
+{
+   int32_t *out_ptr = (int32_t *)acc_ptr;
+   uint32_t k       = 0;
+
+   for (; k + 4 <= num_samples; k += 4)
+   {
+      int32x4_t acc = vld1q_s32((int32_t *)in_pptr[0] + k);
+      for (uint32_t i = 1; i < num_in; i++)
+      {
+         acc = vqaddq_s32(acc, vld1q_s32((int32_t *)in_pptr[i] + k));
+      }
+      vst1q_s32(out_ptr + k, acc);
+   }
+   sal_acc_tail(sal_acc_32_sat, in_pptr, num_in, acc_ptr, k, num_samples, sizeof(int32_t), sizeof(int32_t));
+}
+#endif // SAL_ACC_ARM_NEON
+
+sal_acc_fused_func_t capi_sal_acc_get_fused_func(sal_acc_mode_t mode, bool_t allow_simd)
+{
+   static const sal_acc_fused_func_t portable_func_arr[] = { sal_acc_16_to_32,
+                                                              sal_acc_16_sat,
+                                                              sal_acc_32,
+                                                              sal_acc_q27_sat,
+                                                              sal_acc_32_sat };
+   if (!allow_simd)
+   {
+      return portable_func_arr[mode];
+   }
+#if defined(SAL_ACC_X86_AVX2)
+   static const sal_acc_fused_func_t simd_func_arr[] = { sal_acc_16_to_32_avx2,
+                                                          sal_acc_16_sat_avx2,
+                                                          sal_acc_32_avx2,
+                                                          sal_acc_q27_sat_avx2,
+                                                          sal_acc_32_sat_avx2 };
+   if (__builtin_cpu_supports("avx2"))
+   {
+      return simd_func_arr[mode];
+   }
+#elif defined(SAL_ACC_ARM_NEON)
+   static const sal_acc_fused_func_t simd_func_arr[] = { sal_acc_16_to_32_neon,
+                                                          sal_acc_16_sat_neon,
+                                                          sal_acc_32_neon,
+                                                          sal_acc_q27_sat_neon,
+                                                          sal_acc_32_sat_neon };
+   return simd_func_arr[mode];
+#endif
+   return portable_func_arr[mode];
+}
+
+/*
+  Accumulates samples [start, end) of one channel. Samples every queued input has go through the fused function.
+  Beyond the shortest input, each input that still has data is added on its own, in queue order, and samples the first
+  input does not cover keep what the scratch held, as with per input accumulation.
+*/
+static void capi_sal_acc_block(capi_sal_t *me_ptr,
+                               uint32_t    ch,
+                               uint32_t    start,
+                               uint32_t    end,
+                               uint32_t    in_ws,
+                               uint32_t    acc_ws)
+{
+   sal_acc_in_t *in_arr     = me_ptr->acc_in_arr;
+   int8_t *      acc_ptr    = me_ptr->acc_out_scratch_arr[ch].data_ptr;
+   uint32_t      common_end = end;
+
+   for (uint32_t i = 0; i < me_ptr->num_acc_in; i++)
+   {
+      common_end = SAL_MIN(common_end, in_arr[i].num_samples_per_ch);
+   }
+
+   if (common_end > start)
+   {
+      for (uint32_t i = 0; i < me_ptr->num_acc_in; i++)
+      {
+         me_ptr->acc_ch_in_pptr[i] = in_arr[i].buf_ptr[ch].data_ptr + (start * in_ws);
+      }
+      me_ptr->input_process_info.acc_fused_func_ptr(me_ptr->acc_ch_in_pptr,
+                                                    me_ptr->num_acc_in,
+                                                    acc_ptr + (start * acc_ws),
+                                                    common_end - start);
+      start = common_end;
+   }
+
+   for (uint32_t i = 0; (start < end) && (i < me_ptr->num_acc_in); i++)
+   {
+      uint32_t in_end = SAL_MIN(end, in_arr[i].num_samples_per_ch);
+      if (in_end <= start)
+      {
+         continue;
+      }
+
+      int8_t *in_ptr = in_arr[i].buf_ptr[ch].data_ptr + (start * in_ws);
+      if (0 == i)
+      {
+         // a single input is just copied (and widened)
+         me_ptr->input_process_info.acc_fused_func_ptr(&in_ptr, 1, acc_ptr + (start * acc_ws), in_end - start);
+      }
+      else
+      {
+         me_ptr->input_process_info.accumulate_func_ptr(in_ptr, acc_ptr + (start * acc_ws), in_end - start);
+      }
+   }
+}
+
+void capi_sal_acc_process(capi_sal_t *me_ptr, uint32_t start, uint32_t end)
+{
+   uint32_t in_ws  = me_ptr->operating_mf_ptr->format.bits_per_sample >> 3;
+   uint32_t acc_ws = (SAL_ACC_16_TO_32 == me_ptr->input_process_info.acc_mode) ? sizeof(int32_t) : in_ws;
+
+   if (0 == me_ptr->num_acc_in)
+   {
+      return;
+   }
+
+   for (uint32_t ch = 0; ch < me_ptr->operating_mf_ptr->format.num_channels; ch++)
+   {
+      for (uint32_t blk_start = start; blk_start < end; blk_start += SAL_ACC_BLOCK_SAMPLES)
+      {
+         capi_sal_acc_block(me_ptr, ch, blk_start, SAL_MIN(end, blk_start + SAL_ACC_BLOCK_SAMPLES), in_ws, acc_ws);
+      }
+   }
+}
+
+void capi_sal_acc_finish(capi_sal_t *me_ptr, uint32_t start)
+{
+   capi_sal_acc_process(me_ptr, start, me_ptr->acc_num_samples_per_ch);
+   me_ptr->num_acc_in             = 0;
+   me_ptr->acc_num_samples_per_ch = 0;
+}
+
+#endif // SAL_FUSED_ACC
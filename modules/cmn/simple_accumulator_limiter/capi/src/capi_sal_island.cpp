@@ -391,6 +391,10 @@ capi_err_t capi_sal_process(capi_t *_pif, capi_stream_data_t *input[], capi_stre
 
    /* Loop and accumulate input data */
    bool_t first_port = TRUE;
+#ifdef SAL_FUSED_ACC
+   me_ptr->num_acc_in             = 0;
+   me_ptr->acc_num_samples_per_ch = 0;
+#endif
    for (uint32_t index = 0; index < me_ptr->num_in_ports_started; index++)
    {
       port_index = me_ptr->started_in_port_index_arr[index];
@@ -437,6 +441,14 @@ capi_err_t capi_sal_process(capi_t *_pif, capi_stream_data_t *input[], capi_stre
       first_port = FALSE;
    } // for port
 
+#ifdef SAL_FUSED_ACC
+   // when the limiter runs on the accumulated data, each limiter block is accumulated right before it is limited
+   if (!((input_qf <= output_qf) && capi_sal_check_limiting_required(me_ptr)))
+   {
+      capi_sal_acc_finish(me_ptr, 0);
+   }
+#endif
+
    output[0]->buf_ptr[0].actual_data_len = max_num_samples_per_ch * output_word_size_bytes;
 
    /* DTMF Stuff: output is copied from single input port if unmixed output flag is set */
@@ -526,6 +538,13 @@ static capi_err_t capi_sal_process_input_to_scratch(capi_sal_t *        me_ptr,
                                                     uint32_t            in_num_samples_per_ch,
                                                     bool_t              first_port)
 {
+#ifdef SAL_FUSED_ACC
+   // queued here and accumulated together with the other inputs, see capi_sal_acc_process
+   sal_acc_in_t *acc_in_ptr       = &me_ptr->acc_in_arr[me_ptr->num_acc_in++];
+   acc_in_ptr->buf_ptr            = input[port_idx]->buf_ptr;
+   acc_in_ptr->num_samples_per_ch = in_num_samples_per_ch;
+   me_ptr->acc_num_samples_per_ch = SAL_MAX(me_ptr->acc_num_samples_per_ch, in_num_samples_per_ch);
+#else
    for (uint32_t j = 0; j < me_ptr->operating_mf_ptr->format.num_channels; j++)
    {
       int8_t *in_ptr = input[port_idx]->buf_ptr[j].data_ptr;
@@ -561,6 +580,7 @@ static capi_err_t capi_sal_process_input_to_scratch(capi_sal_t *        me_ptr,
                                                         in_num_samples_per_ch);
       }
    }
+#endif // SAL_FUSED_ACC
 
    return CAPI_EOK;
 }
@@ -573,12 +593,17 @@ capi_err_t capi_sal_lim_loop_process(capi_sal_t *me_ptr, uint32_t max_num_sample
    uint32_t rem      = num - (den * q);
    uint32_t lim_samp = (num > den) ? den : num; // just one loop in this case
    uint32_t count    = 0;
+   uint32_t offset   = 0;
 #ifdef SAL_DBG_LOW
    SAL_MSG(me_ptr->iid, DBG_ERROR_PRIO, "num = %lu, den = %lu, q = %lu, lim_samp %lu", num, den, q, lim_samp);
 #endif
 
    while ((count <= q) && (lim_samp))
    {
+#ifdef SAL_FUSED_ACC
+      // accumulate the block while it is about to be limited, no-op if the scratch is already filled
+      capi_sal_acc_process(me_ptr, offset, offset + lim_samp);
+#endif
       if (LIMITER_SUCCESS !=
           limiter_process(&me_ptr->lib_mem, (void **)me_ptr->lim_out_ptr, me_ptr->lim_in_ptr, lim_samp))
       {
@@ -586,6 +611,7 @@ capi_err_t capi_sal_lim_loop_process(capi_sal_t *me_ptr, uint32_t max_num_sample
          return CAPI_EFAILED;
       }
       count++;
+      offset += lim_samp;
       if (count > q)
       {
          break;
@@ -602,6 +628,10 @@ capi_err_t capi_sal_lim_loop_process(capi_sal_t *me_ptr, uint32_t max_num_sample
          lim_samp = rem; // last run
       }
    }
+#ifdef SAL_FUSED_ACC
+   // inputs longer than the output still leave their data in the scratch, as per input accumulation did
+   capi_sal_acc_finish(me_ptr, offset);
+#endif
    return CAPI_EOK;
 }
 
@@ -702,10 +732,12 @@ capi_err_t capi_sal_set_input_process_info(capi_sal_t *me_ptr)
             me_ptr->input_process_info.alignment           = 0x3;
             me_ptr->input_process_info.accumulate_func_ptr = accumulate_bw_16_samples;
             me_ptr->input_process_info.upconvert_flag      = TRUE;
+            me_ptr->input_process_info.acc_mode            = SAL_ACC_16_TO_32;
          }
          else
          {
             me_ptr->input_process_info.accumulate_func_ptr = accumulate_bw_16_samples_sat;
+            me_ptr->input_process_info.acc_mode            = SAL_ACC_16_SAT;
          }
          break;
       }
@@ -714,16 +746,19 @@ capi_err_t capi_sal_set_input_process_info(capi_sal_t *me_ptr)
          if (me_ptr->limiter_enabled)
          {
             me_ptr->input_process_info.accumulate_func_ptr = accumulate_bw_32_samples_no_sat;
+            me_ptr->input_process_info.acc_mode            = SAL_ACC_32;
          }
          else
          {
             me_ptr->input_process_info.accumulate_func_ptr = accumulate_bw_32_samples_q27_sat;
+            me_ptr->input_process_info.acc_mode            = SAL_ACC_Q27_SAT;
          }
          break;
       }
       case QF_BPS_32:
       {
          me_ptr->input_process_info.accumulate_func_ptr = accumulate_bw_32_samples_with_sat;
+         me_ptr->input_process_info.acc_mode            = SAL_ACC_32_SAT;
          break;
       }
       default:
@@ -736,6 +771,10 @@ capi_err_t capi_sal_set_input_process_info(capi_sal_t *me_ptr)
          break;
       }
    }
+#ifdef SAL_FUSED_ACC
+   me_ptr->input_process_info.acc_fused_func_ptr =
+      capi_sal_acc_get_fused_func(me_ptr->input_process_info.acc_mode, TRUE);
+#endif
    return CAPI_EOK;
 }
 
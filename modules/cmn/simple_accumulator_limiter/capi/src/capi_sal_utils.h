@@ -35,6 +35,12 @@
 #define QDSP_ADD
 #endif
 
+/* Off Hexagon all inputs are accumulated in one pass per block, see capi_sal_acc_island.cpp. Hexagon keeps the
+ * per input Q6 kernels. */
+#ifndef __qdsp6__
+#define SAL_FUSED_ACC
+#endif
+
 #ifndef SAL_MAX
 #define SAL_MAX(m, n) (((m) > (n)) ? (m) : (n))
 #endif
@@ -193,10 +199,41 @@ typedef struct sal_flag_t
    /** when all ports are at gap */
 } sal_flag_t;
 
+typedef enum sal_acc_mode_t
+{
+   SAL_ACC_16_TO_32 = 0,
+   /* Q15 inputs accumulated into 32 bit without saturation, the limiter follows */
+   SAL_ACC_16_SAT,
+   /* Q15 inputs accumulated with 16 bit saturation */
+   SAL_ACC_32,
+   /* Q27 inputs accumulated without saturation, the limiter follows */
+   SAL_ACC_Q27_SAT,
+   /* Q27 inputs accumulated with saturation to the Q27 range */
+   SAL_ACC_32_SAT
+   /* Q31 inputs accumulated with 32 bit saturation */
+} sal_acc_mode_t;
+
+/* Accumulates num_in inputs into acc_ptr in one pass. in_pptr[0] initializes the accumulator and the others are added
+ * in order, so the saturating modes match adding one input at a time. */
+typedef void (*sal_acc_fused_func_t)(int8_t **in_pptr, uint32_t num_in, int8_t *acc_ptr, uint32_t num_samples);
+
+/* An input queued for accumulation in the current process call */
+typedef struct sal_acc_in_t
+{
+   capi_buf_t *buf_ptr;
+   /* per channel buffers of the input stream */
+   uint32_t num_samples_per_ch;
+   /* samples per channel to accumulate, including zeros pushed for flushing EOS */
+} sal_acc_in_t;
+
 typedef struct capi_sal_input_media_process_info_t
 {
    void (*accumulate_func_ptr)(int8_t *, int8_t *, uint32_t);
    /* ptr to accumulate function */
+   sal_acc_fused_func_t acc_fused_func_ptr;
+   /* ptr to the N input accumulate function */
+   sal_acc_mode_t acc_mode;
+   /* accumulation mode for the operating media format */
    uint8_t alignment;
    /* alignment required for input buf ptr */
    bool_t upconvert_flag;
@@ -232,6 +269,16 @@ typedef struct capi_sal_t
 #if __qdsp6__
    capi_buf_t acc_in_scratch_buf;
    /*  scratch buffer which is eight byte aligned, used for vector optimization */
+#endif
+#ifdef SAL_FUSED_ACC
+   sal_acc_in_t *acc_in_arr;
+   /* inputs queued for accumulation in this process call, in accumulation order. Array length is num_in_ports */
+   int8_t **acc_ch_in_pptr;
+   /* per channel input pointers handed to the fused accumulate function. Array length is num_in_ports */
+   uint32_t num_acc_in;
+   /* number of queued inputs, zero once the scratch holds the accumulated data */
+   uint32_t acc_num_samples_per_ch;
+   /* largest num_samples_per_ch among the queued inputs */
 #endif
    capi_buf_t *acc_out_scratch_arr;
    /*  memory to store as many channel buf pointers as there are input ports during process */
@@ -423,6 +470,16 @@ capi_err_t   capi_sal_dtmf(capi_sal_t *        me_ptr,
                            uint32_t            max_num_samples_per_ch,
                            uint32_t            input_word_size_bytes);
 capi_err_t capi_sal_lim_loop_process(capi_sal_t *me_ptr, uint32_t max_num_samples_per_ch, capi_stream_data_t *output[]);
+#ifdef SAL_FUSED_ACC
+////////////////////////////////////////////////acc_island.cpp////////////////////////////////////////////////
+/*Returns the N input accumulate function for the mode. With allow_simd the SIMD kernel is used when the CPU supports
+ * it, otherwise the portable kernel, which the SIMD kernels must match bit for bit*/
+sal_acc_fused_func_t capi_sal_acc_get_fused_func(sal_acc_mode_t mode, bool_t allow_simd);
+/*Accumulates samples [start, end) of the queued inputs into the scratch buffers*/
+void capi_sal_acc_process(capi_sal_t *me_ptr, uint32_t start, uint32_t end);
+/*Accumulates whatever the queued inputs still hold from start on, and empties the queue*/
+void capi_sal_acc_finish(capi_sal_t *me_ptr, uint32_t start);
+#endif
 void       downconvert_ws_32(int8_t *input_ch_buf, uint16_t shift_factor, uint32_t num_samp_per_ch);
 bool_t     capi_sal_inqf_greater_than_outqf(capi_sal_t *        me_ptr,
                                             uint32_t            input_qf,
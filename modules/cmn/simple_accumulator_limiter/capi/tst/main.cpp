@@ -0,0 +1,189 @@
+/*==========================================================================
+ * Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ *==========================================================================*/
+
+/**
+ * @file main.cpp
+ *
+ * Randomized test of the SAL N input accumulation kernels. Every mode runs on random
+ * inputs, input counts, lengths and alignments, and the SIMD kernel (AVX2 or NEON) must
+ * produce the same bytes as the portable kernel. Values are biased towards the
+ * saturation limits so the saturating modes clip often.
+ *
+ * Build with capi_sal_acc_island.cpp and link the spf library for memscpy.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "capi_sal_utils.h"
+#include "audio_basic_op.h"
+
+#ifndef SAL_FUSED_ACC
+#error "The N input accumulation is only built off Hexagon"
+#endif
+
+#define TST_NUM_ITERATIONS 20000
+#define TST_MAX_INPUTS 8
+#define TST_MAX_SAMPLES 300
+#define TST_MAX_OFFSET 7
+#define TST_GUARD_SAMPLES 8
+#define TST_GUARD_BYTE 0xA5
+
+static const char *tst_mode_names[] = { "16_to_32", "16_sat", "32", "q27_sat", "32_sat" };
+
+static uint32_t tst_seed = 0x5A17C0DE;
+
+static uint32_t tst_rand(void)
+{
+   // xorshift32, the same sequence on every host
+   tst_seed ^= tst_seed << 13;
+   tst_seed ^= tst_seed >> 17;
+   tst_seed ^= tst_seed << 5;
+   return tst_seed;
+}
+
+/* Random sample, close to full scale or to the Q27 limits half of the time */
+static int32_t tst_rand_sample(sal_acc_mode_t mode)
+{
+   uint32_t r = tst_rand();
+
+   if ((SAL_ACC_16_TO_32 == mode) || (SAL_ACC_16_SAT == mode))
+   {
+      switch (r & 3)
+      {
+         case 0:
+            return (int16_t)(MAX_16 - (int32_t)((r >> 8) & 0xFF));
+         case 1:
+            return (int16_t)(MIN_16 + (int32_t)((r >> 8) & 0xFF));
+         default:
+            return (int16_t)(r >> 16);
+      }
+   }
+
+   switch (r & 7)
+   {
+      case 0:
+         return INT32_MAX - (int32_t)((r >> 8) & 0xFFFF);
+      case 1:
+         return INT32_MIN + (int32_t)((r >> 8) & 0xFFFF);
+      case 2:
+         return (1 << PCM_Q_FACTOR_27) - (int32_t)((r >> 8) & 0xFFFF);
+      case 3:
+         return -(1 << PCM_Q_FACTOR_27) + (int32_t)((r >> 8) & 0xFFFF);
+      case 4:
+      case 5:
+         // within the Q27 range, as the module sees it
+         return (int32_t)tst_rand() >> 4;
+      default:
+         return (int32_t)tst_rand();
+   }
+}
+
+static bool_t tst_run_one(sal_acc_mode_t mode, sal_acc_fused_func_t simd_func, sal_acc_fused_func_t portable_func)
+{
+   static int8_t in_buf[TST_MAX_INPUTS][(TST_MAX_SAMPLES + TST_MAX_OFFSET + 1) * sizeof(int32_t)];
+   static int8_t simd_out[(TST_MAX_SAMPLES + TST_MAX_OFFSET + TST_GUARD_SAMPLES) * sizeof(int32_t)];
+   static int8_t portable_out[sizeof(simd_out)];
+
+   uint32_t in_ws       = ((SAL_ACC_16_TO_32 == mode) || (SAL_ACC_16_SAT == mode)) ? sizeof(int16_t) : sizeof(int32_t);
+   uint32_t acc_ws      = (SAL_ACC_16_TO_32 == mode) ? sizeof(int32_t) : in_ws;
+   uint32_t num_in      = 1 + (tst_rand() % TST_MAX_INPUTS);
+   uint32_t num_samples = tst_rand() % (TST_MAX_SAMPLES + 1);
+   uint32_t out_offset  = tst_rand() % (TST_MAX_OFFSET + 1);
+   int8_t * simd_in_pptr[TST_MAX_INPUTS];
+   int8_t * portable_in_pptr[TST_MAX_INPUTS];
+
+   for (uint32_t i = 0; i < num_in; i++)
+   {
+      // unaligned starts exercise the unaligned loads of the SIMD kernels
+      int8_t *in_ptr = in_buf[i] + ((tst_rand() % (TST_MAX_OFFSET + 1)) * in_ws);
+      for (uint32_t k = 0; k < num_samples; k++)
+      {
+         int32_t v = tst_rand_sample(mode);
+         if (sizeof(int16_t) == in_ws)
+         {
+            ((int16_t *)in_ptr)[k] = (int16_t)v;
+         }
+         else
+         {
+            ((int32_t *)in_ptr)[k] = v;
+         }
+      }
+      // the kernels advance the pointers they are given
+      simd_in_pptr[i]     = in_ptr;
+      portable_in_pptr[i] = in_ptr;
+   }
+
+   memset(simd_out, TST_GUARD_BYTE, sizeof(simd_out));
+   memset(portable_out, TST_GUARD_BYTE, sizeof(portable_out));
+
+   simd_func(simd_in_pptr, num_in, simd_out + (out_offset * acc_ws), num_samples);
+   portable_func(portable_in_pptr, num_in, portable_out + (out_offset * acc_ws), num_samples);
+
+   if (0 == memcmp(simd_out, portable_out, sizeof(simd_out)))
+   {
+      return TRUE;
+   }
+
+   for (uint32_t b = 0; b < sizeof(simd_out); b++)
+   {
+      if (simd_out[b] != portable_out[b])
+      {
+         printf("FAIL mode %s, %lu inputs, %lu samples, output offset %lu: first difference at sample %ld\n",
+                tst_mode_names[mode],
+                (unsigned long)num_in,
+                (unsigned long)num_samples,
+                (unsigned long)out_offset,
+                (long)(b / acc_ws) - (long)out_offset);
+         break;
+      }
+   }
+   return FALSE;
+}
+
+int main(int argc, char *argv[])
+{
+   uint32_t num_failed   = 0;
+   uint32_t num_compared = 0;
+
+   if (argc > 1)
+   {
+      tst_seed = (uint32_t)strtoul(argv[1], NULL, 0);
+   }
+
+   for (uint32_t m = SAL_ACC_16_TO_32; m <= SAL_ACC_32_SAT; m++)
+   {
+      sal_acc_mode_t       mode          = (sal_acc_mode_t)m;
+      sal_acc_fused_func_t simd_func     = capi_sal_acc_get_fused_func(mode, TRUE);
+      sal_acc_fused_func_t portable_func = capi_sal_acc_get_fused_func(mode, FALSE);
+      uint32_t             mode_failed   = 0;
+
+      if (simd_func == portable_func)
+      {
+         printf("mode %s: no SIMD kernel on this CPU, skipped\n", tst_mode_names[mode]);
+         continue;
+      }
+
+      for (uint32_t n = 0; n < TST_NUM_ITERATIONS; n++)
+      {
+         if (!tst_run_one(mode, simd_func, portable_func))
+         {
+            mode_failed++;
+         }
+      }
+      num_compared += TST_NUM_ITERATIONS;
+      num_failed += mode_failed;
+      printf("mode %s: %lu of %lu runs differ\n",
+             tst_mode_names[mode],
+             (unsigned long)mode_failed,
+             (unsigned long)TST_NUM_ITERATIONS);
+   }
+
+   printf("SAL accumulation kernel tests %s (%lu runs compared)\n",
+          (0 == num_failed) ? "passed" : "FAILED",
+          (unsigned long)num_compared);
+   return (0 == num_failed) ? 0 : 1;
+}
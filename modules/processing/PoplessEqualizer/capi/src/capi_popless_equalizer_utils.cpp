@@ -1433,6 +1433,36 @@ capi_err_t capi_p_eq_process_eq(capi_p_eq_t *       me_ptr,
    int32    byte_sample_convert = me_ptr->lib_static_vars.data_width / 16;
    uint32_t num_samples         = input[0]->buf_ptr[0].actual_data_len >> byte_sample_convert;
 
+   if (!(equalizer_is_cross_fade_active(me_ptr) && !me_ptr->volume_ramp))
+   {
+      /* no crossfading between instances, filter the channels together */
+      eq_lib_t *eq_lib_ptrs[EQUALIZER_MAX_CHANNELS];
+      int8_t *  inp_ch_ptrs[EQUALIZER_MAX_CHANNELS];
+      int8_t *  out_ch_ptrs[EQUALIZER_MAX_CHANNELS];
+      uint32_t  offset = me_ptr->vol_ctrl_to_peq_state ? (me_ptr->prev_transition_num_samples << byte_sample_convert) : 0;
+
+      for (uint32_t ch = 0; ch < me_ptr->num_channels; ch++)
+      {
+         eq_lib_ptrs[ch] = &(me_ptr->lib_instances[ch][CUR_INST]);
+         inp_ch_ptrs[ch] = input[0]->buf_ptr[ch].data_ptr + offset;
+         out_ch_ptrs[ch] = output[0]->buf_ptr[ch].data_ptr + offset;
+      }
+
+      lib_result = eq_process_mch(eq_lib_ptrs, out_ch_ptrs, inp_ch_ptrs, me_ptr->num_channels, num_samples);
+
+      if (EQ_SUCCESS != lib_result)
+      {
+         P_EQ_MSG(me_ptr->miid, DBG_ERROR_PRIO, "CAPI P_EQ: library process failed with error %lu", lib_result);
+         result = CAPI_EFAILED;
+      }
+      for (uint32_t ch = 0; ch < me_ptr->num_channels; ch++)
+      {
+         output[0]->buf_ptr[ch].actual_data_len = (num_samples << byte_sample_convert);
+         input[0]->buf_ptr[ch].actual_data_len  = (num_samples << byte_sample_convert);
+      }
+      return result;
+   }
+
    for (int32_t ch = 0; ch < (int)me_ptr->num_channels; ch++)
    {
       eq_lib_t *eq_lib_ptr[TOTAL_INST];
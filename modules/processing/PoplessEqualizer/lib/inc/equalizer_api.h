@@ -120,6 +120,15 @@ EQ_RESULT eq_process(eq_lib_t *eq_lib_ptr[TOTAL_INST], int8 *out_ptr, int8 *in_p
 // 4. to do cross fade, cross fade total period must be set in such a way that following relationship is true otherwise library will return error: sample_per_channel <= cross fade total period(in samples)
 
 
+// EQ processing of several channels with one EQ instance each (no cross fade between instances)
+// eq_lib_ptrs: [in, out] Array of pointers to lib structures, one per channel
+// out_ptrs: [out] Array of pointers to output PCM samples
+// in_ptrs: [in] Array of pointers to input PCM samples
+// num_chs: [in] Number of channels
+// sample_per_channel: [in] Number of samples to be processed per channel
+EQ_RESULT eq_process_mch(eq_lib_t *eq_lib_ptrs[], int8 *out_ptrs[], int8 *in_ptrs[], uint32 num_chs, uint32 sample_per_channel);
+
+
 
 
 
@@ -12,6 +12,7 @@
 
 #include "audio_basic_op.h"
 #include "audio_iir_tdf2.h"
+#include "audio_biquad_cascade.h"
 #include "audio_divide_qx.h"
 #include "audio_log10.h"
 #include "audio_exp10.h"
@@ -1176,6 +1177,57 @@ EQ_RESULT eq_set_param(eq_lib_t* eq_lib_ptr, uint32 param_id, int8* mem_ptr, uin
 
 
 
+/*======================================================================
+
+  FUNCTION      eq_on_off_cross_fade
+
+  DESCRIPTION   Cross fade between EQ output and bypass input while EQ
+                is turned on or off.
+
+  PARAMETERS    eq_cur_lib_mem_ptr: [in] Pointer to lib memory
+out_ptr: [in, out] Pointer to single channel EQ output PCM samples
+in_ptr: [in] Pointer to single channel input PCM samples
+sample_per_channel: [in] Number of samples to be processed
+
+SIDE EFFECTS  None.
+
+======================================================================*/
+static EQ_RESULT eq_on_off_cross_fade(eq_lib_mem_t* eq_cur_lib_mem_ptr, int8 *out_ptr, int8 *in_ptr, uint32 sample_per_channel)
+{
+    int8* cross_fade_in_ptr[TOTAL_INPUT];
+    uint32  paramSize;
+
+    if (eq_cur_lib_mem_ptr->eq_mode == EQ_DISABLE){  //Turning off
+        cross_fade_in_ptr[CUR_INPUT]=(int8*)out_ptr; //EQ effects
+        cross_fade_in_ptr[NEW_INPUT]=(int8*)in_ptr;  //bypass input
+    }
+    else{                                            //Turning on
+        cross_fade_in_ptr[CUR_INPUT]=(int8*)in_ptr;  //bypass input
+        cross_fade_in_ptr[NEW_INPUT]=(int8*)out_ptr; //EQ effects
+    }
+
+    // sanity check
+    if (eq_cur_lib_mem_ptr->cross_fade_lib_mem.cross_fade_lib_mem_ptr == NULL)
+        return EQ_FAILURE;
+
+    // do cross fade between outputs of existing and new EQ effects and store results back into existing EQ output data buffer
+    if(audio_cross_fade_process(&eq_cur_lib_mem_ptr->cross_fade_lib_mem, out_ptr, cross_fade_in_ptr, sample_per_channel) != CROSS_FADE_SUCCESS)
+    {
+        return EQ_FAILURE;
+    }
+
+    // update on-off crossfade mode
+    // when ramp up/down is done, on-off crossfade mode is set to 0.
+    if(audio_cross_fade_get_param(&eq_cur_lib_mem_ptr->cross_fade_lib_mem, CROSS_FADE_PARAM_MODE, (int8*)&eq_cur_lib_mem_ptr->eq_on_off_crossfade_mode, sizeof(eq_cross_fade_mode_t), &paramSize) != CROSS_FADE_SUCCESS)
+    {
+        return EQ_FAILURE;
+    }
+
+    return EQ_SUCCESS;
+}
+
+
+
 /*======================================================================
 
   FUNCTION      eq_process
@@ -1226,35 +1278,10 @@ EQ_RESULT eq_process(eq_lib_t *eq_lib_ptr[TOTAL_INST], int8 *out_ptr, int8 *in_p
         }
 
         if(eq_cur_lib_mem_ptr->eq_on_off_crossfade_mode == EQ_TRUE){
-            int8* cross_fade_in_ptr[TOTAL_INPUT];
-            uint32  paramSize;
-
-            if (eq_cur_lib_mem_ptr->eq_mode == EQ_DISABLE){  //Turning off
-                cross_fade_in_ptr[CUR_INPUT]=(int8*)out_ptr; //EQ effects
-                cross_fade_in_ptr[NEW_INPUT]=(int8*)in_ptr;  //bypass input
-            }
-            else{                                            //Turning on
-                cross_fade_in_ptr[CUR_INPUT]=(int8*)in_ptr;  //bypass input
-                cross_fade_in_ptr[NEW_INPUT]=(int8*)out_ptr; //EQ effects
-            }
-
-            // sanity check
-            if (eq_cur_lib_mem_ptr->cross_fade_lib_mem.cross_fade_lib_mem_ptr == NULL)
-                return EQ_FAILURE;
-
-            // do cross fade between outputs of existing and new EQ effects and store results back into existing EQ output data buffer
-            if(audio_cross_fade_process(&eq_cur_lib_mem_ptr->cross_fade_lib_mem, out_ptr, cross_fade_in_ptr, sample_per_channel) != CROSS_FADE_SUCCESS)
+            if (eq_on_off_cross_fade(eq_cur_lib_mem_ptr, out_ptr, in_ptr, sample_per_channel) != EQ_SUCCESS)
             {
                 return EQ_FAILURE;
             }
-
-            // update on-off crossfade mode
-            // when ramp up/down is done, on-off crossfade mode is set to 0.
-            if(audio_cross_fade_get_param(&eq_cur_lib_mem_ptr->cross_fade_lib_mem, CROSS_FADE_PARAM_MODE, (int8*)&eq_cur_lib_mem_ptr->eq_on_off_crossfade_mode, sizeof(eq_cross_fade_mode_t), &paramSize) != CROSS_FADE_SUCCESS)
-            {
-                return EQ_FAILURE;
-            }
-
         }
         // if the new EQ lib does not exist, it means no need to do cross fading
         // on/off cross-fading and generic cross-fading can't happen at the same time
@@ -1317,6 +1344,97 @@ EQ_RESULT eq_process(eq_lib_t *eq_lib_ptr[TOTAL_INST], int8 *out_ptr, int8 *in_p
 
 
 
+
+/*======================================================================
+
+  FUNCTION      eq_process_mch
+
+  DESCRIPTION   EQ processing of several channels with one EQ instance
+                each. The EQ filters of BIQUAD_CASCADE_LANES channels are
+                run together.
+
+  DEPENDENCIES  Input pointers must not be NULL.
+
+
+  PARAMETERS    eq_lib_ptrs: [in] Array of pointers to lib structures
+out_ptrs: [out] Array of pointers to output PCM samples
+in_ptrs: [in] Array of pointers to input PCM samples
+num_chs: [in] Number of channels
+sample_per_channel: [in] Number of samples to be processed
+
+SIDE EFFECTS  None.
+
+======================================================================*/
+EQ_RESULT eq_process_mch(eq_lib_t *eq_lib_ptrs[], int8 *out_ptrs[], int8 *in_ptrs[], uint32 num_chs, uint32 sample_per_channel)
+{
+    eq_lib_mem_t* eq_mem_ptrs[BIQUAD_CASCADE_LANES];
+    msiir_lib_t*  msiir_lib_ptrs[BIQUAD_CASCADE_LANES];
+    void*         msiir_out_ptrs[BIQUAD_CASCADE_LANES];
+    void*         msiir_in_ptrs[BIQUAD_CASCADE_LANES];
+    uint32        ch_idx[BIQUAD_CASCADE_LANES];
+    uint32        num_msiir = 0;
+    uint32        byte_per_sample, ch, i;
+
+    // add sanity check
+    if(eq_lib_ptrs == NULL || out_ptrs == NULL || in_ptrs == NULL)
+        return EQ_FAILURE;
+
+    for (ch = 0; ch < num_chs; ch++)
+    {
+        eq_lib_mem_t* eq_cur_lib_mem_ptr;
+
+        if(eq_lib_ptrs[ch] == NULL || out_ptrs[ch] == NULL || in_ptrs[ch] == NULL)
+            return EQ_FAILURE;
+
+        eq_cur_lib_mem_ptr = (eq_lib_mem_t*)eq_lib_ptrs[ch]->lib_mem_ptr;
+        if(eq_cur_lib_mem_ptr == NULL )
+            return EQ_FAILURE;
+
+        if(eq_cur_lib_mem_ptr->eq_static_struct_ptr->data_width == 16)
+            byte_per_sample = 2;
+        else if(eq_cur_lib_mem_ptr->eq_static_struct_ptr->data_width == 32)
+            byte_per_sample = 4;
+        else
+            return EQ_FAILURE;
+
+        if(eq_cur_lib_mem_ptr->eq_mode == EQ_DISABLE && eq_cur_lib_mem_ptr->eq_on_off_crossfade_mode == EQ_FALSE){
+            memscpy(out_ptrs[ch], byte_per_sample*sample_per_channel, in_ptrs[ch], byte_per_sample*sample_per_channel);
+        }
+        else{ // collect for EQ
+            eq_mem_ptrs[num_msiir] = eq_cur_lib_mem_ptr;
+            msiir_lib_ptrs[num_msiir] = &eq_cur_lib_mem_ptr->msiir_lib_mem;
+            msiir_out_ptrs[num_msiir] = (void*)out_ptrs[ch];
+            msiir_in_ptrs[num_msiir] = (void*)in_ptrs[ch];
+            ch_idx[num_msiir] = ch;
+            num_msiir++;
+        }
+
+        if (num_msiir == BIQUAD_CASCADE_LANES || (num_msiir > 0 && ch + 1 == num_chs))
+        {
+            // do processing for existing EQ effects
+            if (msiir_process_mch_v2(msiir_lib_ptrs, msiir_out_ptrs, msiir_in_ptrs, num_msiir, sample_per_channel) != MSIIR_SUCCESS)
+            {
+                return EQ_FAILURE;
+            }
+
+            for (i = 0; i < num_msiir; i++)
+            {
+                if(eq_mem_ptrs[i]->eq_on_off_crossfade_mode == EQ_TRUE){
+                    if (eq_on_off_cross_fade(eq_mem_ptrs[i], out_ptrs[ch_idx[i]], in_ptrs[ch_idx[i]], sample_per_channel) != EQ_SUCCESS)
+                    {
+                        return EQ_FAILURE;
+                    }
+                }
+            }
+            num_msiir = 0;
+        }
+    }
+
+    return EQ_SUCCESS;
+}
+
+
+
 // design msiir coeffs and re-format to the way required by msiir lib
 EQ_RESULT eq_msiir_design(eq_lib_mem_t*  eq_lib_mem_ptr, eq_msiir_settings_t   *eq_msiir_settings_ptr)
 {
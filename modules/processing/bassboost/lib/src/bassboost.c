@@ -13,6 +13,7 @@
 #include "filter_design.h"
 #include "audio_clips.h"
 #include "drc_calib_api.h"
+#include "audio_biquad_cascade.h"
 
 void buffer32_copy
 (
@@ -407,6 +408,25 @@ void bb32_crossmix_panner(int32 *dest, int32 *src1, int32 *src2, pannerStruct *p
 }
 
 
+/* filter the onset of channels [ch0, ch0 + num) into the bass and the band buffers */
+static void filter_chs(bassboost_private_t *obj_ptr, void **bass_buf, void **band_buf, void **onset_buf,
+                       int32 ch0, int32 num, int32 samples)
+{
+   msiir_lib_t *fltr_ptrs[BIQUAD_CASCADE_LANES];
+   int32 i;
+
+   // filter input, put bass part in bass buf
+   for (i = 0; i < num; ++i) {
+      fltr_ptrs[i] = &obj_ptr->bass_fltrs[ch0 + i];
+   }
+   msiir_process_mch_v2(fltr_ptrs, &bass_buf[ch0], &onset_buf[ch0], num, samples);
+   // filter input, put band pass portion in out buf as scratch
+   for (i = 0; i < num; ++i) {
+      fltr_ptrs[i] = &obj_ptr->band_fltrs[ch0 + i];
+   }
+   msiir_process_mch_v2(fltr_ptrs, &band_buf[ch0], &onset_buf[ch0], num, samples);
+}
+
 static BASSBOOST_RESULT bassboost_proc16(bassboost_private_t *obj_ptr, int16 **out_ptr, int16 **in_ptr, int32 samples)
 {
    int32 num_chs = obj_ptr->static_vars.num_chs;
@@ -416,7 +436,7 @@ static BASSBOOST_RESULT bassboost_proc16(bassboost_private_t *obj_ptr, int16 **o
    pannerStruct *strength  = &obj_ptr->strenghth_fader;
    pannerStruct *onset     = obj_ptr->onset_fader;
    pannerStruct *onoff = obj_ptr->onoff_fader;
-   int32 ch;
+   int32 ch, ch0;
 
    // bypass mode (low MIPS)
    if (0 >= obj_ptr->onoff_fader->sampleCounter && 0 == obj_ptr->enable) {
@@ -428,20 +448,22 @@ static BASSBOOST_RESULT bassboost_proc16(bassboost_private_t *obj_ptr, int16 **o
       return BASSBOOST_SUCCESS;
       }
 
-      for (ch = 0; ch < num_chs; ++ch) {
-      // fade in or copy input samples
-      buffer_fill_with_panner(onset_buf[ch], in_ptr[ch], &onset[ch], samples);
-      // filter input, put bass part in bass buf
-      msiir_process_v2(&obj_ptr->bass_fltrs[ch], bass_buf[ch], onset_buf[ch], samples);
-      // filter input, put band pass portion in out buf as scratch
-      msiir_process_v2(&obj_ptr->band_fltrs[ch], out_ptr[ch], onset_buf[ch], samples);
-      // copy input to mix buf
-      buffer32_copy16(mix_buf[ch], onset_buf[ch], samples);
-      // mix band pass signal into bass buf: bass+0.5*band
-      buffer_mix(bass_buf[ch], out_ptr[ch], Q15_HALF, samples);
-      // inplace delay mixing buf contents
-      delayline32_inplace_delay(mix_buf[ch], &obj_ptr->delaylines[ch], samples);
+   for (ch0 = 0; ch0 < num_chs; ch0 += BIQUAD_CASCADE_LANES) {
+      int32 ch_end = s32_min_s32_s32(ch0 + BIQUAD_CASCADE_LANES, num_chs);
+      for (ch = ch0; ch < ch_end; ++ch) {
+         // fade in or copy input samples
+         buffer_fill_with_panner(onset_buf[ch], in_ptr[ch], &onset[ch], samples);
       }
+      filter_chs(obj_ptr, (void **)bass_buf, (void **)out_ptr, (void **)onset_buf, ch0, ch_end - ch0, samples);
+      for (ch = ch0; ch < ch_end; ++ch) {
+         // copy input to mix buf
+         buffer32_copy16(mix_buf[ch], onset_buf[ch], samples);
+         // mix band pass signal into bass buf: bass+0.5*band
+         buffer_mix(bass_buf[ch], out_ptr[ch], Q15_HALF, samples);
+         // inplace delay mixing buf contents
+         delayline32_inplace_delay(mix_buf[ch], &obj_ptr->delaylines[ch], samples);
+      }
+   }
 
    // apply drc on bass
    drc_process(&obj_ptr->drc_lib, (int8 **)bass_buf, (int8 **)bass_buf, samples);
@@ -466,7 +488,7 @@ static BASSBOOST_RESULT bassboost_proc32(bassboost_private_t *obj_ptr, int32 **o
    pannerStruct *strength  = &obj_ptr->strenghth_fader;
    pannerStruct *onset     = obj_ptr->onset_fader;
    pannerStruct *onoff     = obj_ptr->onoff_fader;
-   int32 ch;
+   int32 ch, ch0;
 
    // bypass mode (low MIPS)
    if (0 >= obj_ptr->onoff_fader->sampleCounter && 0 == obj_ptr->enable) {
@@ -478,20 +500,22 @@ static BASSBOOST_RESULT bassboost_proc32(bassboost_private_t *obj_ptr, int32 **o
       return BASSBOOST_SUCCESS;
    }
 
-   for (ch = 0; ch < num_chs; ++ch) {
-      // fade in or copy input samples
-      buffer32_fill_panner(onset_buf[ch], in_ptr[ch], &onset[ch], samples);
-      // filter input, put bass part in bass buf
-      msiir_process_v2(&obj_ptr->bass_fltrs[ch], bass_buf[ch], onset_buf[ch], samples);
-      // filter input, put band pass portion in out buf as scratch
-      msiir_process_v2(&obj_ptr->band_fltrs[ch], out_ptr[ch], onset_buf[ch], samples);
+   for (ch0 = 0; ch0 < num_chs; ch0 += BIQUAD_CASCADE_LANES) {
+      int32 ch_end = s32_min_s32_s32(ch0 + BIQUAD_CASCADE_LANES, num_chs);
+      for (ch = ch0; ch < ch_end; ++ch) {
+         // fade in or copy input samples
+         buffer32_fill_panner(onset_buf[ch], in_ptr[ch], &onset[ch], samples);
+      }
+      filter_chs(obj_ptr, (void **)bass_buf, (void **)out_ptr, (void **)onset_buf, ch0, ch_end - ch0, samples);
+      for (ch = ch0; ch < ch_end; ++ch) {
          // copy input to mix buf
-      buffer32_copy(mix_buf[ch], onset_buf[ch], samples);
+         buffer32_copy(mix_buf[ch], onset_buf[ch], samples);
          // mix band pass signal into bass buf: bass+0.5*band
-      buffer32_mix16(bass_buf[ch], out_ptr[ch], Q15_HALF, samples);
-      // inplace delay mixing buf contents
-      delayline32_inplace_delay(mix_buf[ch], &obj_ptr->delaylines[ch], samples);
+         buffer32_mix16(bass_buf[ch], out_ptr[ch], Q15_HALF, samples);
+         // inplace delay mixing buf contents
+         delayline32_inplace_delay(mix_buf[ch], &obj_ptr->delaylines[ch], samples);
       }
+   }
 
    // apply drc on bass
    drc_process(&obj_ptr->drc_lib, (int8 **)bass_buf, (int8 **)bass_buf, samples);
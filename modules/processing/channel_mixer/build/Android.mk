@@ -24,6 +24,7 @@ LOCAL_SRC_FILES := \
     capi/src/capi_chmixer_utils.cpp \
     lib/src/ChannelMixerLib.c \
     lib/src/ChannelMixerLib_island.c \
+    lib/src/ChannelMixerKernels_island.c \
     lib/src/ChannelMixerRemapRules.c
 
 LOCAL_CFLAGS    += -O3 -Wall -ffixed-x18
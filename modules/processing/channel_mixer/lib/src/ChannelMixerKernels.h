@@ -0,0 +1,58 @@
+#ifndef CHANNEL_MIXER_KERNELS_H
+#define CHANNEL_MIXER_KERNELS_H
+
+/*============================================================================
+  @file ChannelMixerKernels.h
+
+  Block kernels of the Channel Mixer process. */
+
+/*=========================================================================
+Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+SPDX-License-Identifier: BSD-3-Clause-Clear
+========================================================================= */
+
+#include "AudioComdef.h"
+#include "ar_defs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+// Number of samples mixed per block. The inputs of a block stay in the data cache while all output channels of the
+// block are generated, the accumulators of one output channel stay on the stack.
+#define CH_MIXER_BLOCK_SIZE 64
+
+// Guard bits of the 16 bit accumulator, each Q14 product is right shifted by this before accumulation.
+#define CH_MIXER_GUARD_BITS_16 4
+
+/*
+@brief Multiply a block of 16 bit input samples with a Q14 coefficient and accumulate.
+       acc[i] = (isFirst ? 0 : acc[i]) + ((in[i] * coeff) >> CH_MIXER_GUARD_BITS_16)
+
+       The caller guarantees the 32 bit accumulator cannot overflow for the coefficients of the output channel.
+*/
+void ChMixerMacBlock16(int32 *acc, const int16 *in, int16 coeff, uint32 numSamples, bool_t isFirst);
+
+/*
+@brief Multiply a block of 32 bit input samples with a Q14 coefficient and accumulate exactly in 64 bit.
+       acc[i] = (isFirst ? 0 : acc[i]) + (in[i] * coeff)
+*/
+void ChMixerMacBlock32(int64 *acc, const int32 *in, int16 coeff, uint32 numSamples, bool_t isFirst);
+
+/*
+@brief Convert a block of 16 bit path accumulators back to the input Q factor with saturation.
+       out[i] = sat16(acc[i] >> (Q14 - CH_MIXER_GUARD_BITS_16))
+*/
+void ChMixerStoreBlock16(int16 *out, const int32 *acc, uint32 numSamples);
+
+/*
+@brief Convert a block of 32 bit path accumulators back to the input Q factor with saturation.
+       out[i] = sat32(acc[i] >> Q14)
+*/
+void ChMixerStoreBlock32(int32 *out, const int64 *acc, uint32 numSamples);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif /* __cplusplus */
+
+#endif // #ifndef CHANNEL_MIXER_KERNELS_H
@@ -0,0 +1,278 @@
+/*============================================================================
+  @file ChannelMixerKernels_island.c
+
+  Block kernels of the Channel Mixer process.
+
+  The 16 bit path keeps the numerics of the original per sample loop: each
+  Q14 product is right shifted by the guard bits and summed in 32 bit. The
+  32 bit path sums exact 48 bit products in 64 bit. Both are order
+  independent, so the NEON / AVX2 versions are bit-exact with the scalar
+  loops.
+
+        Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+        SPDX-License-Identifier: BSD-3-Clause-Clear
+
+============================================================================*/
+
+/*----------------------------------------------------------------------------
+ * Include Files
+ * -------------------------------------------------------------------------*/
+#include "ChannelMixerKernels.h"
+#include "ChannelMixerRemapRules.h"
+#include "audio_basic_op.h"
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#define CH_MIXER_NEON
+#elif defined(__x86_64__)
+#include <immintrin.h>
+#define CH_MIXER_AVX2
+#define CH_MIXER_TGT_AVX2 __attribute__((target("avx2")))
+#endif
+
+#define CH_MIXER_STORE_SHIFT_16 (Q14_FACTOR - CH_MIXER_GUARD_BITS_16)
+
+/*----------------------------------------------------------------------------
+ * Scalar loops, also used for the tails of the vector loops
+ * -------------------------------------------------------------------------*/
+static inline void ch_mixer_mac16_c(int32 *acc, const int16 *in, int16 coeff, uint32 i, uint32 n, bool_t isFirst)
+{
+   if (isFirst)
+   {
+      for (; i < n; i++)
+      {
+         acc[i] = s32_shr_s32(s32_mult_s16_s16(in[i], coeff), CH_MIXER_GUARD_BITS_16);
+      }
+   }
+   else
+   {
+      for (; i < n; i++)
+      {
+         acc[i] += s32_shr_s32(s32_mult_s16_s16(in[i], coeff), CH_MIXER_GUARD_BITS_16);
+      }
+   }
+}
+
+static inline void ch_mixer_mac32_c(int64 *acc, const int32 *in, int16 coeff, uint32 i, uint32 n, bool_t isFirst)
+{
+   if (isFirst)
+   {
+      for (; i < n; i++)
+      {
+         acc[i] = (int64)in[i] * coeff;
+      }
+   }
+   else
+   {
+      for (; i < n; i++)
+      {
+         acc[i] += (int64)in[i] * coeff;
+      }
+   }
+}
+
+static inline void ch_mixer_store16_c(int16 *out, const int32 *acc, uint32 i, uint32 n)
+{
+   for (; i < n; i++)
+   {
+      out[i] = s16_saturate_s32(s32_shr_s32(acc[i], CH_MIXER_STORE_SHIFT_16));
+   }
+}
+
+static inline void ch_mixer_store32_c(int32 *out, const int64 *acc, uint32 i, uint32 n)
+{
+   for (; i < n; i++)
+   {
+      out[i] = s32_saturate_s64(s64_shl_s64(acc[i], -Q14_FACTOR));
+   }
+}
+
+#if defined(CH_MIXER_NEON)
+/*----------------------------------------------------------------------------
+ * AArch64 NEON
+ * -------------------------------------------------------------------------*/
+void ChMixerMacBlock16(int32 *acc, const int16 *in, int16 coeff, uint32 numSamples, bool_t isFirst)
+{
+   uint32 i = 0;
+   for (; i + 8 <= numSamples; i += 8)
+   {
+      int16x8_t x  = vld1q_s16(in + i);
+      int32x4_t p0 = vshrq_n_s32(vmull_n_s16(vget_low_s16(x), coeff), CH_MIXER_GUARD_BITS_16);
+      int32x4_t p1 = vshrq_n_s32(vmull_n_s16(vget_high_s16(x), coeff), CH_MIXER_GUARD_BITS_16);
+      if (!isFirst)
+      {
+         p0 = vaddq_s32(p0, vld1q_s32(acc + i));
+         p1 = vaddq_s32(p1, vld1q_s32(acc + i + 4));
+      }
+      vst1q_s32(acc + i, p0);
+      vst1q_s32(acc + i + 4, p1);
+   }
+   ch_mixer_mac16_c(acc, in, coeff, i, numSamples, isFirst);
+}
+
+void ChMixerMacBlock32(int64 *acc, const int32 *in, int16 coeff, uint32 numSamples, bool_t isFirst)
+{
+   uint32 i = 0;
+   for (; i + 4 <= numSamples; i += 4)
+   {
+      int32x4_t x = vld1q_s32(in + i);
+      int64x2_t a0, a1;
+      if (isFirst)
+      {
+         a0 = vmull_n_s32(vget_low_s32(x), coeff);
+         a1 = vmull_high_n_s32(x, coeff);
+      }
+      else
+      {
+         a0 = vmlal_n_s32(vld1q_s64(acc + i), vget_low_s32(x), coeff);
+         a1 = vmlal_high_n_s32(vld1q_s64(acc + i + 2), x, coeff);
+      }
+      vst1q_s64(acc + i, a0);
+      vst1q_s64(acc + i + 2, a1);
+   }
+   ch_mixer_mac32_c(acc, in, coeff, i, numSamples, isFirst);
+}
+
+void ChMixerStoreBlock16(int16 *out, const int32 *acc, uint32 numSamples)
+{
+   uint32 i = 0;
+   for (; i + 8 <= numSamples; i += 8)
+   {
+      // Truncating shift followed by a saturating narrow, same as sat16(acc >> shift)
+      int16x4_t y0 = vqshrn_n_s32(vld1q_s32(acc + i), CH_MIXER_STORE_SHIFT_16);
+      int16x4_t y1 = vqshrn_n_s32(vld1q_s32(acc + i + 4), CH_MIXER_STORE_SHIFT_16);
+      vst1q_s16(out + i, vcombine_s16(y0, y1));
+   }
+   ch_mixer_store16_c(out, acc, i, numSamples);
+}
+
+void ChMixerStoreBlock32(int32 *out, const int64 *acc, uint32 numSamples)
+{
+   uint32 i = 0;
+   for (; i + 4 <= numSamples; i += 4)
+   {
+      int32x2_t y0 = vqshrn_n_s64(vld1q_s64(acc + i), Q14_FACTOR);
+      int32x2_t y1 = vqshrn_n_s64(vld1q_s64(acc + i + 2), Q14_FACTOR);
+      vst1q_s32(out + i, vcombine_s32(y0, y1));
+   }
+   ch_mixer_store32_c(out, acc, i, numSamples);
+}
+
+#else // CH_MIXER_NEON
+
+#if defined(CH_MIXER_AVX2)
+/*----------------------------------------------------------------------------
+ * x86-64 AVX2, selected at runtime
+ * -------------------------------------------------------------------------*/
+static int32 ch_mixer_has_avx2(void)
+{
+   static int32 has_avx2 = -1;
+   if (has_avx2 < 0)
+   {
+      __builtin_cpu_init();
+      has_avx2 = __builtin_cpu_supports("avx2") ? 1 : 0;
+   }
+   return has_avx2;
+}
+
+CH_MIXER_TGT_AVX2 static void ch_mixer_mac16_avx2(int32       *acc,
+                                                  const int16 *in,
+                                                  int16        coeff,
+                                                  uint32       numSamples,
+                                                  bool_t       isFirst)
+{
+   __m256i c = _mm256_set1_epi32(coeff);
+   uint32  i = 0;
+   for (; i + 8 <= numSamples; i += 8)
+   {
+      __m256i x = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(in + i)));
+      __m256i p = _mm256_srai_epi32(_mm256_mullo_epi32(x, c), CH_MIXER_GUARD_BITS_16);
+      if (!isFirst)
+      {
+         p = _mm256_add_epi32(p, _mm256_loadu_si256((const __m256i *)(acc + i)));
+      }
+      _mm256_storeu_si256((__m256i *)(acc + i), p);
+   }
+   ch_mixer_mac16_c(acc, in, coeff, i, numSamples, isFirst);
+}
+
+CH_MIXER_TGT_AVX2 static void ch_mixer_mac32_avx2(int64       *acc,
+                                                  const int32 *in,
+                                                  int16        coeff,
+                                                  uint32       numSamples,
+                                                  bool_t       isFirst)
+{
+   // _mm256_mul_epi32 multiplies the sign extended low 32 bits of each 64 bit lane
+   __m256i c = _mm256_set1_epi64x(coeff);
+   uint32  i = 0;
+   for (; i + 4 <= numSamples; i += 4)
+   {
+      __m256i x = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)(in + i)));
+      __m256i p = _mm256_mul_epi32(x, c);
+      if (!isFirst)
+      {
+         p = _mm256_add_epi64(p, _mm256_loadu_si256((const __m256i *)(acc + i)));
+      }
+      _mm256_storeu_si256((__m256i *)(acc + i), p);
+   }
+   ch_mixer_mac32_c(acc, in, coeff, i, numSamples, isFirst);
+}
+
+CH_MIXER_TGT_AVX2 static void ch_mixer_store16_avx2(int16 *out, const int32 *acc, uint32 numSamples)
+{
+   uint32 i = 0;
+   for (; i + 16 <= numSamples; i += 16)
+   {
+      __m256i a0 = _mm256_srai_epi32(_mm256_loadu_si256((const __m256i *)(acc + i)), CH_MIXER_STORE_SHIFT_16);
+      __m256i a1 = _mm256_srai_epi32(_mm256_loadu_si256((const __m256i *)(acc + i + 8)), CH_MIXER_STORE_SHIFT_16);
+      // packs saturates per 128 bit lane, restore the sample order afterwards
+      __m256i y = _mm256_permute4x64_epi64(_mm256_packs_epi32(a0, a1), 0xD8);
+      _mm256_storeu_si256((__m256i *)(out + i), y);
+   }
+   ch_mixer_store16_c(out, acc, i, numSamples);
+}
+#endif // CH_MIXER_AVX2
+
+void ChMixerMacBlock16(int32 *acc, const int16 *in, int16 coeff, uint32 numSamples, bool_t isFirst)
+{
+#if defined(CH_MIXER_AVX2)
+   if (ch_mixer_has_avx2())
+   {
+      ch_mixer_mac16_avx2(acc, in, coeff, numSamples, isFirst);
+      return;
+   }
+#endif
+   ch_mixer_mac16_c(acc, in, coeff, 0, numSamples, isFirst);
+}
+
+void ChMixerMacBlock32(int64 *acc, const int32 *in, int16 coeff, uint32 numSamples, bool_t isFirst)
+{
+#if defined(CH_MIXER_AVX2)
+   if (ch_mixer_has_avx2())
+   {
+      ch_mixer_mac32_avx2(acc, in, coeff, numSamples, isFirst);
+      return;
+   }
+#endif
+   ch_mixer_mac32_c(acc, in, coeff, 0, numSamples, isFirst);
+}
+
+void ChMixerStoreBlock16(int16 *out, const int32 *acc, uint32 numSamples)
+{
+#if defined(CH_MIXER_AVX2)
+   if (ch_mixer_has_avx2())
+   {
+      ch_mixer_store16_avx2(out, acc, numSamples);
+      return;
+   }
+#endif
+   ch_mixer_store16_c(out, acc, 0, numSamples);
+}
+
+void ChMixerStoreBlock32(int32 *out, const int64 *acc, uint32 numSamples)
+{
+   // AVX2 has no 64 bit arithmetic shift, the scalar loop is used on x86 as well
+   ch_mixer_store32_c(out, acc, 0, numSamples);
+}
+
+#endif // CH_MIXER_NEON
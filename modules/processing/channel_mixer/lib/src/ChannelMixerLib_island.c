@@ -19,6 +19,7 @@ SPDX-License-Identifier: BSD-3-Clause-Clear
 
 #include "ChannelMixerLib.h"
 #include "ChannelMixerRemapRules.h"
+#include "ChannelMixerKernels.h"
 #include "audio_basic_op.h"
 
 void ChMixerTrivialCopy(ChMixerStateStruct *pState, void **output, void **input, uint32 numSamples);
@@ -78,6 +79,52 @@ void ChMixerTrivialCopy(ChMixerStateStruct *pState, void **output, void **input,
 }
 
 
+/*
+@brief Collect the input channels and coefficients contributing to an output channel.
+
+@param pState : [in] Pointer to the state structure
+@param outputChIndex : [in] Output channel whose row of the mixer matrix is collected
+@param activeIn : [out] Input channel indices with a non zero coefficient
+@param activeCoeff : [out] Coefficients of those input channels
+@param sumAbsCoeff : [out] Sum of the magnitudes of the coefficients
+
+Return value: Number of contributing input channels
+*/
+static uint32 ChMixerGetActiveRow(ChMixerStateStruct *pState,
+                                  uint32              outputChIndex,
+                                  uint32 *            activeIn,
+                                  int16 *             activeCoeff,
+                                  uint32 *            sumAbsCoeff)
+{
+   int16 *pMatrixCoeffL16Q14 = pState->ptrCoeff + pState->numInputCh * outputChIndex;
+   int8 * inputStep          = &pState->dynState.pInputStepMatrix[outputChIndex * (pState->numInputCh + 1)];
+   uint32 numActive          = 0;
+   uint32 inputChIndex;
+
+   *sumAbsCoeff = 0;
+   for (inputChIndex = *inputStep; (inputChIndex < pState->numInputCh) && (numActive < CH_MIXER_MAX_NUM_CH);
+        inputChIndex = *(++inputStep))
+   {
+      int16 coeff            = pMatrixCoeffL16Q14[inputChIndex];
+      activeIn[numActive]    = inputChIndex;
+      activeCoeff[numActive] = coeff;
+      *sumAbsCoeff += (coeff < 0) ? -(int32)coeff : coeff;
+      numActive++;
+   }
+   return numActive;
+}
+
+/*
+@brief Returns whether the 16 bit path accumulator of an output channel can overflow.
+       Each product is at most 2^15 * |coeff| before the guard bit shift, which rounds negative products away from
+       zero by at most one, so the sum of the coefficient magnitudes bounds the accumulator. This only happens with
+       more than 31 contributing channels and near full scale coefficients.
+*/
+static inline bool_t ChMixerRowNeedsWideAcc16(uint32 sumAbsCoeff, uint32 numActive)
+{
+   return ((((uint64)sumAbsCoeff << 15) >> CH_MIXER_GUARD_BITS_16) + numActive > (uint64)MAX_32);
+}
+
 /*
 @brief Apply the Channel mixing algorithm
 
@@ -88,16 +135,10 @@ void ChMixerTrivialCopy(ChMixerStateStruct *pState, void **output, void **input,
 */
 void ChMixerProcess(void *pCMState, void **output, void **input, uint32 numSamples)
 {
-
-   uint32 sampleIndex;
-   uint32 outputChIndex;
-   uint32 inputChIndex;
-   int16 *pMatrixCoeffL16Q14;
-   // int16 *pMatrixCoeffStartL16Q14;
-   int8 *              inputStep;
-   int32               tempL32, prodL32;
-   int64               tempL64, prodL64;
    ChMixerStateStruct *pState = (ChMixerStateStruct *)pCMState;
+   uint32              outputChIndex, blockStart, blockSize, k, numActive, sumAbsCoeff;
+   uint32              activeIn[CH_MIXER_MAX_NUM_CH];
+   int16               activeCoeff[CH_MIXER_MAX_NUM_CH];
 
    if (pState->isTrivialCopy)
    {
@@ -105,84 +146,85 @@ void ChMixerProcess(void *pCMState, void **output, void **input, uint32 numSampl
       return;
    }
 
-   if (16 == pState->dataBitWidth)
+   // output[output channel i][sample] = sum over input channels j of
+   //                                    matrix[output channel i][input channel j] * input[input channel j][sample]
+   // The samples are processed in blocks. All output channels of a block are generated before moving to the next
+   // block, so the input samples of the block are fetched from memory once and then reused from the cache. Only input
+   // channels with a non zero coefficient are visited, and each one is applied to the whole block at once.
+   for (blockStart = 0; blockStart < numSamples; blockStart += blockSize)
    {
-      // Generate output one channel at a time. This helps in reducing cache thrashing
+      blockSize = numSamples - blockStart;
+      if (blockSize > CH_MIXER_BLOCK_SIZE)
+      {
+         blockSize = CH_MIXER_BLOCK_SIZE;
+      }
+
       for (outputChIndex = 0; outputChIndex < pState->numOutputCh; outputChIndex++)
       {
-         // Matrix coefficients of the row corresponding to the output channel
-         pMatrixCoeffL16Q14 = pState->ptrCoeff + pState->numInputCh * outputChIndex;
+         numActive = ChMixerGetActiveRow(pState, outputChIndex, activeIn, activeCoeff, &sumAbsCoeff);
 
-         for (sampleIndex = 0; sampleIndex < numSamples; sampleIndex++)
+         if (16 == pState->dataBitWidth)
          {
-            inputStep = &pState->dynState.pInputStepMatrix[outputChIndex * (pState->numInputCh + 1)];
-            // output[output channel i][sample] = matrix[output channel i ][input channel j] *
-            //                                       input[input channel j][sample]
-            // The above product is calculated for all input channels and the products are summed.
-            // The data ordering can be exploited to write memory access based on pointers so that
-            // the compiler can generate efficient code. For e.g
-            // (1) All the output samples for a channel are stored one after the other. Hence in the
-            //     above equation, output[output channel i][sample] is just *output[channel]++
-            // (2) Similarly for calculating the output samples for a channel, only the factors in
-            //     a particular row in the matrix are required. Since C implements matrices row-wise,
-            //     we can access these coefficients as matrixCoeff++
-            // (3) Input samples of all the channels must be accessed even for calculating output samples
-            //     for one channels. So we initialize a local array with starting addresses of all input
-            //     channels and increment each one of them as required.
-            tempL32 = 0;
-            for (inputChIndex = *inputStep; inputChIndex < pState->numInputCh; inputChIndex = *(++inputStep))
+            int16 *out_ch_data_ptr = (int16 *)output[outputChIndex] + blockStart;
+            if (0 == numActive)
             {
-               int16 *in_ch_data_ptr = (int16 *)input[inputChIndex];
-               prodL32 = s32_mult_s16_s16(*(in_ch_data_ptr + sampleIndex), pMatrixCoeffL16Q14[inputChIndex]);
-
-               // Maximum number of channels is 8, so this should avoid any overflow
-               // We right shift by 4 to provide enough guard bits.
-               prodL32 = s32_shr_s32(prodL32, 4);
-               tempL32 = s32_add_s32_s32(tempL32, prodL32);
+               memset(out_ch_data_ptr, 0, blockSize * sizeof(int16));
+            }
+            else if (!ChMixerRowNeedsWideAcc16(sumAbsCoeff, numActive))
+            {
+               // Each Q14 product is right shifted by the guard bits before the 32 bit accumulation
+               int32 accL32[CH_MIXER_BLOCK_SIZE];
+               for (k = 0; k < numActive; k++)
+               {
+                  ChMixerMacBlock16(accL32,
+                                    (int16 *)input[activeIn[k]] + blockStart,
+                                    activeCoeff[k],
+                                    blockSize,
+                                    (0 == k));
+               }
+               // Do the remaining right-shift to get it back to same QFactor as input
+               ChMixerStoreBlock16(out_ch_data_ptr, accL32, blockSize);
+            }
+            else
+            {
+               // Same products and guard bits, accumulated in 64 bit so that the sum saturates instead of wrapping
+               uint32 sampleIndex;
+               for (sampleIndex = 0; sampleIndex < blockSize; sampleIndex++)
+               {
+                  int64 tempL64 = 0;
+                  for (k = 0; k < numActive; k++)
+                  {
+                     int16 *in_ch_data_ptr = (int16 *)input[activeIn[k]] + blockStart;
+                     tempL64 += s32_shr_s32(s32_mult_s16_s16(in_ch_data_ptr[sampleIndex], activeCoeff[k]),
+                                            CH_MIXER_GUARD_BITS_16);
+                  }
+                  out_ch_data_ptr[sampleIndex] =
+                     s16_saturate_s32(s32_saturate_s64(s64_shl_s64(tempL64, -(Q14_FACTOR - CH_MIXER_GUARD_BITS_16))));
+               }
             }
-            // Do the remaining right-shift to get it back to same QFactor as input
-             int16 *out_ch_data_ptr = (int16 *)output[outputChIndex];
-            *(out_ch_data_ptr + sampleIndex) = s16_saturate_s32(s32_shr_s32(tempL32, Q14_FACTOR - 4));
          }
-      }
-   }
-   else
-   {
-      // Generate output one channel at a time. This helps in reducing cache thrashing
-      for (outputChIndex = 0; outputChIndex < pState->numOutputCh; outputChIndex++)
-      {
-         // Calculate the starting address for the input channels
-
-         // Matrix coefficients of the row corresponding to the output channel
-         pMatrixCoeffL16Q14 = pState->ptrCoeff + pState->numInputCh * outputChIndex;
-
-         for (sampleIndex = 0; sampleIndex < numSamples; sampleIndex++)
+         else
          {
-            inputStep = &pState->dynState.pInputStepMatrix[outputChIndex * (pState->numInputCh + 1)];
-            // output[output channel i][sample] = matrix[output channel i ][input channel j] *
-            //                                       input[input channel j][sample]
-            // The above product is calculated for all input channels and the products are summed.
-            // The data ordering can be exploited to write memory access based on pointers so that
-            // the compiler can generate efficient code. For e.g
-            // (1) All the output samples for a channel are stored one after the other. Hence in the
-            //     above equation, output[output channel i][sample] is just *output[channel]++
-            // (2) Similarly for calculating the output samples for a channel, only the factors in
-            //     a particular row in the matrix are required. Since C implements matrices row-wise,
-            //     we can access these coefficients as matrixCoeff++
-            // (3) Input samples of all the channels must be accessed even for calculating output samples
-            //     for one channels. So we initialize a local array with starting addresses of all input
-            //     channels and increment each one of them as required.
-            tempL64 = 0;
-            for (inputChIndex = *inputStep; inputChIndex < pState->numInputCh; inputChIndex = *(++inputStep))
+            int32 *out_ch_data_ptr = (int32 *)output[outputChIndex] + blockStart;
+            if (0 == numActive)
+            {
+               memset(out_ch_data_ptr, 0, blockSize * sizeof(int32));
+            }
+            else
             {
-               int32 *in_ch_data_ptr = (int32 *)input[inputChIndex];
-               prodL64 = s64_mult_s32_s16(*(in_ch_data_ptr + sampleIndex), pMatrixCoeffL16Q14[inputChIndex]);
-               // Maximum number of channels is 8, so there are enough bits to avoid overflow
-               tempL64 = s64_add_s64_s64(tempL64, prodL64);
+               // 48 bit products, at most 32 of them, cannot overflow the 64 bit accumulator
+               int64 accL64[CH_MIXER_BLOCK_SIZE];
+               for (k = 0; k < numActive; k++)
+               {
+                  ChMixerMacBlock32(accL64,
+                                    (int32 *)input[activeIn[k]] + blockStart,
+                                    activeCoeff[k],
+                                    blockSize,
+                                    (0 == k));
+               }
+               // Do the remaining right-shift to get it back to same QFactor as input
+               ChMixerStoreBlock32(out_ch_data_ptr, accL64, blockSize);
             }
-            // Do the remaining right-shift to get it back to same QFactor as input
-            int32 *out_ch_data_ptr = (int32 *)output[outputChIndex];
-            *(out_ch_data_ptr + sampleIndex) = s32_saturate_s64(s64_shl_s64(tempL64, -Q14_FACTOR));
          }
       }
    }
@@ -0,0 +1,342 @@
+/*==============================================================================
+  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+  SPDX-License-Identifier: BSD-3-Clause-Clear
+  ==============================================================================*/
+
+/*============================================================================
+  FILE:          main.c
+
+  OVERVIEW:      Regression test for the Channel Mixer library against the
+                 per sample loop that ChMixerProcess used before the block
+                 kernels. Custom matrices with 8, 16, 24 and 32 input
+                 channels are mixed to several output channel counts, for
+                 16 and 32 bit data, in random frame sizes around the
+                 kernel block size. Dense, sparse (including all zero rows)
+                 and full scale matrices are covered, with noise, silence
+                 and full scale inputs.
+
+                 The reference walks the input step matrix per sample like
+                 the original loop and must be matched bit for bit. It sums
+                 in 64 bit, which equals the original 32 bit sum of the 16
+                 bit path wherever that sum does not wrap. For full scale
+                 matrices with many channels the original sum wrapped; the
+                 library must saturate there instead, which is what the
+                 reference does. Those cases are counted to make sure they
+                 are exercised.
+
+  DEPENDENCIES:  ChannelMixerLib.c, ChannelMixerLib_island.c,
+                 ChannelMixerKernels_island.c, ChannelMixerRemapRules.c and
+                 the audio utilities of modules/cmn/common/utils.
+
+  ============================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ChannelMixerLib.h"
+#include "ChannelMixerRemapRules.h"
+#include "audio_basic_op.h"
+
+/* -----------------------------------------------------------------------
+** Constant / Define Declarations
+** ----------------------------------------------------------------------- */
+#define CH_MIXER_TST_NUM_SAMPLES 1200
+#define CH_MIXER_TST_MAX_FRAME 257
+
+// Matrix kinds, see ch_mixer_tst_make_matrix
+#define CH_MIXER_TST_DENSE 0
+#define CH_MIXER_TST_SPARSE 1
+#define CH_MIXER_TST_FULL_SCALE 2
+#define CH_MIXER_TST_NUM_KINDS 3
+
+/* -----------------------------------------------------------------------
+** Global Data
+** ----------------------------------------------------------------------- */
+static uint32 ch_mixer_tst_seed;
+static int32  ch_mixer_tst_in[CH_MIXER_MAX_NUM_CH][CH_MIXER_TST_NUM_SAMPLES];
+static int32  ch_mixer_tst_out[CH_MIXER_MAX_NUM_CH][CH_MIXER_TST_NUM_SAMPLES];
+static int32  ch_mixer_tst_ref[CH_MIXER_MAX_NUM_CH][CH_MIXER_TST_NUM_SAMPLES];
+static int16  ch_mixer_tst_coeffs[CH_MIXER_MAX_NUM_CH * CH_MIXER_MAX_NUM_CH];
+static uint32 ch_mixer_tst_num_wrapped;
+
+/* -----------------------------------------------------------------------
+** Function Definitions
+** ----------------------------------------------------------------------- */
+static uint32 ch_mixer_tst_rand(void)
+{
+   // xorshift32
+   ch_mixer_tst_seed ^= ch_mixer_tst_seed << 13;
+   ch_mixer_tst_seed ^= ch_mixer_tst_seed >> 17;
+   ch_mixer_tst_seed ^= ch_mixer_tst_seed << 5;
+   return ch_mixer_tst_seed;
+}
+
+static int32 ch_mixer_tst_full_scale(uint32 data_width, bool_t negative)
+{
+   if (16 == data_width)
+   {
+      return negative ? MIN_16 : MAX_16;
+   }
+   return negative ? MIN_32 : MAX_32;
+}
+
+/* Dense rows use every input, sparse rows about one in eight and some rows none, full scale rows use every input
+ * at the largest coefficient magnitudes so that the sum needs more than the 32 bit headroom of the 16 bit path. */
+static void ch_mixer_tst_make_matrix(uint32 num_in, uint32 num_out, uint32 kind)
+{
+   for (uint32 o = 0; o < num_out; o++)
+   {
+      bool_t zero_row = (CH_MIXER_TST_SPARSE == kind) && (0 == (ch_mixer_tst_rand() % 4));
+      for (uint32 i = 0; i < num_in; i++)
+      {
+         int16 coeff = 0;
+         switch (kind)
+         {
+            case CH_MIXER_TST_DENSE:
+            {
+               coeff = (int16)ch_mixer_tst_rand();
+               coeff = (0 == coeff) ? 1 : coeff;
+               break;
+            }
+            case CH_MIXER_TST_SPARSE:
+            {
+               if (!zero_row && (0 == (ch_mixer_tst_rand() % 8)))
+               {
+                  coeff = (int16)((ch_mixer_tst_rand() % 32767) + 1);
+                  coeff = (ch_mixer_tst_rand() & 1) ? -coeff : coeff;
+               }
+               break;
+            }
+            default:
+            {
+               // Same sign per row, the last row alternates to also cover cancellation. Negative rows are -1.0
+               // throughout: with 32 inputs at negative full scale their sum is 2^31, the one case past the 32 bit
+               // headroom of the 16 bit path.
+               if ((o == num_out - 1) && (num_out > 1))
+               {
+                  coeff = (int16)((i & 1) ? MIN_16 : MAX_16);
+               }
+               else if (o & 1)
+               {
+                  coeff = MIN_16;
+               }
+               else
+               {
+                  coeff = (int16)(MAX_16 - (int16)(ch_mixer_tst_rand() % 64));
+               }
+               break;
+            }
+         }
+         ch_mixer_tst_coeffs[o * num_in + i] = coeff;
+      }
+   }
+}
+
+/* Noise, then silence, then every input at positive and at negative full scale, then single channel impulses */
+static void ch_mixer_tst_make_input(uint32 num_in, uint32 data_width)
+{
+   uint32 shift = 32 - data_width;
+   for (uint32 i = 0; i < num_in; i++)
+   {
+      for (uint32 n = 0; n < CH_MIXER_TST_NUM_SAMPLES; n++)
+      {
+         int32  value;
+         uint32 segment = (n * 8) / CH_MIXER_TST_NUM_SAMPLES;
+         switch (segment)
+         {
+            case 2:
+            {
+               value = 0;
+               break;
+            }
+            case 3:
+            case 4:
+            {
+               value = ch_mixer_tst_full_scale(data_width, (4 == segment));
+               break;
+            }
+            case 5:
+            {
+               value = ((n % num_in) == i) ? ch_mixer_tst_full_scale(data_width, (n & 1)) : 0;
+               break;
+            }
+            default:
+            {
+               value = ((int32)ch_mixer_tst_rand()) >> shift;
+               break;
+            }
+         }
+         ch_mixer_tst_in[i][n] = value;
+      }
+   }
+}
+
+/* The per sample loop of the original ChMixerProcess, with a 64 bit sum in the 16 bit path */
+static void ch_mixer_tst_reference(ChMixerStateStruct *pState)
+{
+   for (uint32 o = 0; o < pState->numOutputCh; o++)
+   {
+      int16 *pMatrixCoeffL16Q14 = pState->ptrCoeff + pState->numInputCh * o;
+      for (uint32 n = 0; n < CH_MIXER_TST_NUM_SAMPLES; n++)
+      {
+         int8  *inputStep = &pState->dynState.pInputStepMatrix[o * (pState->numInputCh + 1)];
+         int64  tempL64   = 0;
+         for (uint32 i = *inputStep; i < pState->numInputCh; i = *(++inputStep))
+         {
+            if (16 == pState->dataBitWidth)
+            {
+               tempL64 += s32_shr_s32(s32_mult_s16_s16((int16)ch_mixer_tst_in[i][n], pMatrixCoeffL16Q14[i]), 4);
+            }
+            else
+            {
+               tempL64 += s64_mult_s32_s16(ch_mixer_tst_in[i][n], pMatrixCoeffL16Q14[i]);
+            }
+         }
+         if (16 == pState->dataBitWidth)
+         {
+            if ((tempL64 > MAX_32) || (tempL64 < MIN_32))
+            {
+               ch_mixer_tst_num_wrapped++;
+            }
+            ch_mixer_tst_ref[o][n] = s16_saturate_s32(s32_saturate_s64(s64_shl_s64(tempL64, -(Q14_FACTOR - 4))));
+         }
+         else
+         {
+            ch_mixer_tst_ref[o][n] = s32_saturate_s64(s64_shl_s64(tempL64, -Q14_FACTOR));
+         }
+      }
+   }
+}
+
+/* Runs the library over the input in random frame sizes and returns the number of samples that differ */
+static uint32 ch_mixer_tst_run_case(uint32 num_in, uint32 num_out, uint32 data_width)
+{
+   static int16   in16[CH_MIXER_MAX_NUM_CH][CH_MIXER_TST_NUM_SAMPLES];
+   static int16   out16[CH_MIXER_MAX_NUM_CH][CH_MIXER_TST_NUM_SAMPLES];
+   ChMixerChType  in_map[CH_MIXER_MAX_NUM_CH];
+   ChMixerChType  out_map[CH_MIXER_MAX_NUM_CH];
+   void          *in_ptrs[CH_MIXER_MAX_NUM_CH];
+   void          *out_ptrs[CH_MIXER_MAX_NUM_CH];
+   uint32         mem_size   = 0;
+   uint32         num_errors = 0;
+   void          *mem_ptr;
+
+   for (uint32 i = 0; i < CH_MIXER_MAX_NUM_CH; i++)
+   {
+      in_map[i]  = (ChMixerChType)(i + 1);
+      out_map[i] = (ChMixerChType)(i + 1);
+   }
+
+   ChMixerGetInstanceSize(&mem_size, num_in, num_out);
+   mem_ptr = malloc(mem_size);
+   if ((NULL == mem_ptr) ||
+       (CH_MIXER_SUCCESS !=
+        ChMixerSetParam(mem_ptr, mem_size, num_in, in_map, num_out, out_map, data_width, ch_mixer_tst_coeffs)))
+   {
+      printf("set param failed for %lu to %lu channels\n", (unsigned long)num_in, (unsigned long)num_out);
+      free(mem_ptr);
+      return 1;
+   }
+
+   ch_mixer_tst_make_input(num_in, data_width);
+   for (uint32 i = 0; i < num_in; i++)
+   {
+      for (uint32 n = 0; n < CH_MIXER_TST_NUM_SAMPLES; n++)
+      {
+         in16[i][n] = (int16)ch_mixer_tst_in[i][n];
+      }
+   }
+   memset(ch_mixer_tst_out, 0x5a, sizeof(ch_mixer_tst_out));
+   memset(out16, 0x5a, sizeof(out16));
+
+   for (uint32 n = 0; n < CH_MIXER_TST_NUM_SAMPLES;)
+   {
+      uint32 frame = 1 + (ch_mixer_tst_rand() % CH_MIXER_TST_MAX_FRAME);
+      frame        = (frame > CH_MIXER_TST_NUM_SAMPLES - n) ? (CH_MIXER_TST_NUM_SAMPLES - n) : frame;
+      for (uint32 i = 0; i < num_in; i++)
+      {
+         in_ptrs[i] = (16 == data_width) ? (void *)&in16[i][n] : (void *)&ch_mixer_tst_in[i][n];
+      }
+      for (uint32 o = 0; o < num_out; o++)
+      {
+         out_ptrs[o] = (16 == data_width) ? (void *)&out16[o][n] : (void *)&ch_mixer_tst_out[o][n];
+      }
+      ChMixerProcess(mem_ptr, out_ptrs, in_ptrs, frame);
+      n += frame;
+   }
+
+   ch_mixer_tst_reference((ChMixerStateStruct *)mem_ptr);
+
+   for (uint32 o = 0; o < num_out; o++)
+   {
+      for (uint32 n = 0; n < CH_MIXER_TST_NUM_SAMPLES; n++)
+      {
+         int32 out = (16 == data_width) ? (int32)out16[o][n] : ch_mixer_tst_out[o][n];
+         if (out != ch_mixer_tst_ref[o][n])
+         {
+            if (0 == num_errors)
+            {
+               printf("  first mismatch at output %lu sample %lu: %ld, expected %ld\n",
+                      (unsigned long)o,
+                      (unsigned long)n,
+                      (long)out,
+                      (long)ch_mixer_tst_ref[o][n]);
+            }
+            num_errors++;
+         }
+      }
+   }
+   free(mem_ptr);
+   return num_errors;
+}
+
+int main(int argc, char *argv[])
+{
+   static const uint32 num_in_list[]  = { 8, 16, 24, 32 };
+   static const uint32 num_out_list[] = { 1, 2, 6, 8, 16, 24, 32 };
+   static const uint32 widths[]       = { 16, 32 };
+   static const char  *kind_names[]   = { "dense", "sparse", "full scale" };
+   uint32              num_cases = 0, num_failed = 0;
+
+   for (uint32 w = 0; w < sizeof(widths) / sizeof(widths[0]); w++)
+   {
+      for (uint32 a = 0; a < sizeof(num_in_list) / sizeof(num_in_list[0]); a++)
+      {
+         for (uint32 b = 0; b < sizeof(num_out_list) / sizeof(num_out_list[0]); b++)
+         {
+            for (uint32 kind = 0; kind < CH_MIXER_TST_NUM_KINDS; kind++)
+            {
+               uint32 num_errors;
+
+               ch_mixer_tst_seed = (num_cases * 2654435761u) + 7;
+               ch_mixer_tst_make_matrix(num_in_list[a], num_out_list[b], kind);
+               num_errors = ch_mixer_tst_run_case(num_in_list[a], num_out_list[b], widths[w]);
+               num_cases++;
+               if (num_errors)
+               {
+                  num_failed++;
+                  printf("%lu bit %lu to %lu channels %s: %lu samples off the reference\n",
+                         (unsigned long)widths[w],
+                         (unsigned long)num_in_list[a],
+                         (unsigned long)num_out_list[b],
+                         kind_names[kind],
+                         (unsigned long)num_errors);
+               }
+            }
+         }
+      }
+   }
+
+   // The full scale matrices must have driven the 16 bit path past its 32 bit headroom
+   if (0 == ch_mixer_tst_num_wrapped)
+   {
+      printf("no case exceeded the 32 bit headroom of the 16 bit path\n");
+      num_failed++;
+   }
+
+   printf("%lu of %lu cases failed, %lu samples past the 32 bit headroom\n",
+          (unsigned long)num_failed,
+          (unsigned long)num_cases,
+          (unsigned long)ch_mixer_tst_num_wrapped);
+   return num_failed ? 1 : 0;
+}
@@ -67,6 +67,7 @@
 *      - #PARAM_ID_FIR_ENABLE \n
 *      - #PARAM_ID_FIR_FILTER_MAX_TAP_LENGTH \n
 *      - #PARAM_ID_FIR_FILTER_CONFIG \n
+*      - #PARAM_ID_FIR_FILTER_FFT_CONFIG \n
 *
 * Supported Input Media Format:\n
 *  - Data Format          : FIXED_POINT\n
@@ -721,6 +722,35 @@ struct param_id_fir_filter_crossfade_cfg_v2_t
 /* Typedef Structure for the filter coefficients parameter of Fir filter module. */
 typedef struct param_id_fir_filter_crossfade_cfg_v2_t param_id_fir_filter_crossfade_cfg_v2_t;
 
+/** @ingroup ar_spf_mod_fir_macros
+    ID of the FIR filter FFT convolution parameter used by
+    MODULE_ID_FIR_FILTER. */
+#define PARAM_ID_FIR_FILTER_FFT_CONFIG 0x08001AA2
+/** @h2xmlp_parameter   {"PARAM_ID_FIR_FILTER_FFT_CONFIG", PARAM_ID_FIR_FILTER_FFT_CONFIG }
+    @h2xmlp_description {Enables partitioned FFT convolution for long filters. Filters with at least
+                         fft_taps_threshold taps apply their first 256 taps in time domain and the remaining
+                         taps in 256 tap partitions in frequency domain. This adds no delay and reduces the
+                         processing cost of long filters. The output is not bit-exact with time domain
+                         filtering. Changing it recreates the filter memory, which clears the filter
+                         history.}
+    @h2xmlp_toolPolicy  {RTC, Calibration} */
+
+#include "spf_begin_pack.h"
+#include "spf_begin_pragma.h"
+struct param_id_fir_filter_fft_cfg_t
+{
+   uint32_t fft_taps_threshold;
+   /**< @h2xmle_description  {Minimum number of taps for which the FFT convolution is used.
+                              0 disables the FFT convolution. Values up to 256 behave like 257.}
+        @h2xmle_default      {0}  */
+}
+#include "spf_end_pragma.h"
+#include "spf_end_pack.h"
+;
+
+/* Typedef Structure for the FFT convolution parameter of Fir filter module. */
+typedef struct param_id_fir_filter_fft_cfg_t param_id_fir_filter_fft_cfg_t;
+
 /**
 	@h2xml_Select					{param_id_module_enable_t}
    @h2xmlm_InsertParameter
@@ -784,6 +814,11 @@ typedef struct param_id_fir_filter_crossfade_cfg_v2_t param_id_fir_filter_crossf
    @h2xmlm_InsertParameter
 */
 
+/**
+    @h2xml_Select                    {param_id_fir_filter_fft_cfg_t}
+   @h2xmlm_InsertParameter
+*/
+
 /** @}                   <-- End of the Module -->*/
 
 #endif //API_FIR_H
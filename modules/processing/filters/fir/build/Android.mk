@@ -27,7 +27,9 @@ LOCAL_SRC_FILES := \
     capi/src/capi_fir_filter_utils_v2.cpp \
     capi/src/capi_fir_filter_xfade_utils.cpp \
     lib/src/fir_lib.c \
-    lib/src/fir_lib_process.c
+    lib/src/fir_lib_process.c \
+    lib/src/fir_lib_mac.c \
+    lib/src/fir_lib_fft.c
 
 LOCAL_CFLAGS    += -O3 -Wall -ffixed-x18
 
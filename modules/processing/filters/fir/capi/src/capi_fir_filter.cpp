@@ -307,6 +307,7 @@ capi_err_t capi_fir_set_param(capi_t *                _pif,
    {
       case PARAM_ID_MODULE_ENABLE:
       case INTF_EXTN_PARAM_ID_PERIOD:
+      case PARAM_ID_FIR_FILTER_FFT_CONFIG:
 	     break;
       case PARAM_ID_FIR_FILTER_MAX_TAP_LENGTH:
       case PARAM_ID_FIR_FILTER_CONFIG:
@@ -698,6 +699,40 @@ capi_err_t capi_fir_set_param(capi_t *                _pif,
          }
          break;
       }
+      case PARAM_ID_FIR_FILTER_FFT_CONFIG:
+      {
+         if (param_size < sizeof(param_id_fir_filter_fft_cfg_t))
+         {
+            FIR_MSG(me_ptr->miid, DBG_ERROR_PRIO, "FFT config SetParam 0x%lx, invalid param size %lx ", param_id, param_size);
+            capi_result = CAPI_ENEEDMORE;
+            break;
+         }
+         param_id_fir_filter_fft_cfg_t *fft_cfg_ptr = (param_id_fir_filter_fft_cfg_t *)params_ptr->data_ptr;
+
+         if (fft_cfg_ptr->fft_taps_threshold == me_ptr->fft_taps_threshold)
+         {
+            FIR_MSG(me_ptr->miid, DBG_HIGH_PRIO, "No change in FFT config");
+            break;
+         }
+         me_ptr->fft_taps_threshold = fft_cfg_ptr->fft_taps_threshold;
+
+         // library memory depends on the threshold, recreate the library instances with the cached configs
+         if (VERSION_V2 == me_ptr->cfg_version)
+         {
+            capi_result = capi_fir_check_create_lib_instance_v2(me_ptr, FALSE);
+         }
+         else if (VERSION_V1 == me_ptr->cfg_version)
+         {
+            capi_result = capi_fir_check_create_lib_instance(me_ptr, FALSE);
+         }
+         if (CAPI_FAILED(capi_result))
+         {
+            FIR_MSG(me_ptr->miid, DBG_ERROR_PRIO, "FFT config SetParam 0x%lx failed.", param_id);
+            break;
+         }
+         FIR_MSG(me_ptr->miid, DBG_HIGH_PRIO, "FFT taps threshold set to %lu", me_ptr->fft_taps_threshold);
+         break;
+      }
 
       default:
       {
@@ -732,6 +767,7 @@ static capi_err_t capi_fir_get_param(capi_t *                _pif,
    switch (param_id)
    {
       case PARAM_ID_MODULE_ENABLE:
+      case PARAM_ID_FIR_FILTER_FFT_CONFIG:
 	     break;
       case PARAM_ID_FIR_FILTER_MAX_TAP_LENGTH:
       case PARAM_ID_FIR_FILTER_CONFIG:
@@ -783,6 +819,21 @@ static capi_err_t capi_fir_get_param(capi_t *                _pif,
          }
          break;
       }
+      case PARAM_ID_FIR_FILTER_FFT_CONFIG:
+      {
+         if (params_ptr->max_data_len >= sizeof(param_id_fir_filter_fft_cfg_t))
+         {
+            param_id_fir_filter_fft_cfg_t *fft_cfg_ptr = (param_id_fir_filter_fft_cfg_t *)(params_ptr->data_ptr);
+            fft_cfg_ptr->fft_taps_threshold            = me_ptr->fft_taps_threshold;
+            params_ptr->actual_data_len                = sizeof(param_id_fir_filter_fft_cfg_t);
+         }
+         else
+         {
+            FIR_MSG(miid, DBG_ERROR_PRIO, "Get FFT config, Bad param size %lu", params_ptr->max_data_len);
+            capi_result = CAPI_ENEEDMORE;
+         }
+         break;
+      }
       case PARAM_ID_FIR_FILTER_MAX_TAP_LENGTH:
       {
          if (NULL != me_ptr->cache_fir_max_tap)
@@ -971,6 +971,8 @@ uint32_t capi_fir_get_kpps(capi_fir_t *me_ptr)
    {
       coeff_width = me_ptr->fir_channel_lib[ch].fir_config_variables.coef_width;
       num_taps    = me_ptr->fir_channel_lib[ch].fir_config_variables.num_taps;
+      // long filters may run as (cheaper) partitioned FFT convolution
+      num_taps    = fir_get_equivalent_taps(num_taps, me_ptr->fft_taps_threshold);
       if ((16 == data_width) && (16 == coeff_width))
       {
          kpps_value += (0.00025) * num_taps * sampling_freq;
@@ -1360,6 +1362,7 @@ void capi_fir_set_static_params(capi_fir_t *me_ptr)
       fir_channel_lib[chan_num].fir_static_variables.data_width    = me_ptr->input_media_fmt[0].format.bits_per_sample;
       fir_channel_lib[chan_num].fir_static_variables.sampling_rate = me_ptr->input_media_fmt[0].format.sampling_rate;
       fir_channel_lib[chan_num].fir_static_variables.frame_size    = CAPI_MAX_PROCESS_FRAME_SIZE;
+      fir_channel_lib[chan_num].fir_static_variables.fft_taps_threshold = me_ptr->fft_taps_threshold;
 
       channel_map = ((uint64_t)1) << me_ptr->input_media_fmt[0].channel_type[chan_num];
 
@@ -179,6 +179,7 @@ typedef struct capi_fir_t
 
    uint32_t is_module_in_voice_graph; // helps to classify where the module is placed.
    uint32_t frame_size_in_samples;    // specify the frame-size for the library to create buffers.
+   uint32_t fft_taps_threshold;       // PARAM_ID_FIR_FILTER_FFT_CONFIG, 0: FFT convolution disabled
 
    uint32_t miid;
    // flag to detect if higher than 63 channel map received or not
@@ -584,6 +584,7 @@ void capi_fir_set_static_params_v2(capi_fir_t *me_ptr, uint32_t per_cfg_base_pay
       fir_channel_lib[chan_num].fir_static_variables.data_width   = me_ptr->input_media_fmt[0].format.bits_per_sample;
       fir_channel_lib[chan_num].fir_static_variables.sampling_rate = me_ptr->input_media_fmt[0].format.sampling_rate;
       fir_channel_lib[chan_num].fir_static_variables.frame_size    = CAPI_MAX_PROCESS_FRAME_SIZE;
+      fir_channel_lib[chan_num].fir_static_variables.fft_taps_threshold = me_ptr->fft_taps_threshold;
 
       channel_type = me_ptr->input_media_fmt[0].channel_type[chan_num];
       for (uint32_t count = 0; count < num_cfg; count++)
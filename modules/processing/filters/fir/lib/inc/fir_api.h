@@ -39,6 +39,7 @@ typedef struct fir_static_struct_t
    uint32   sampling_rate;					// Sampling rate
    uint32	max_num_taps;					// Max FIR filter length
    uint32   frame_size;                     // Frame size in samples
+   uint32   fft_taps_threshold;             // Filters with at least this many taps use partitioned FFT convolution, 0: disabled
 } fir_static_struct_t;
 
 
@@ -100,6 +101,11 @@ FIR_RESULT fir_set_param(fir_lib_t *fir_lib_ptr, uint32 param_id, int8 *mem_ptr,
 // param_size_ptr: [out] Pointer to param size which indicates the size of the retrieved param(s)
 FIR_RESULT fir_get_param(fir_lib_t *fir_lib_ptr, uint32 param_id, int8 *mem_ptr, uint32 mem_size, uint32 *param_size_ptr);
 
+// number of time domain taps with the same processing cost as a num_taps filter (for kpps estimates)
+// num_taps: [in] Filter length
+// fft_taps_threshold: [in] FFT convolution threshold the lib was created with, see fir_static_struct_t
+uint32 fir_get_equivalent_taps(uint32 num_taps, uint32 fft_taps_threshold);
+
 
 
 
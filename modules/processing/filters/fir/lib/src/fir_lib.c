@@ -53,6 +53,7 @@ FIR_RESULT fir_get_mem_req(fir_lib_mem_requirements_t *fir_lib_mem_requirements_
 	uint32 stateStructSize, stateSize;
 	uint32 historyBufferSize, outputSize=0;
 	uint32 prevOutputBufferSize;
+	uint32 fftStateSize;
 	uint32 size;
 
 	// clear memory
@@ -80,7 +81,7 @@ FIR_RESULT fir_get_mem_req(fir_lib_mem_requirements_t *fir_lib_mem_requirements_
 
 	//coefBufferSize = (uint32)(COEF_16BIT == fir_static_struct_ptr->coef_width ? s64_shl_s64(fir_static_struct_ptr->max_num_taps,1) : s64_shl_s64(fir_static_struct_ptr->max_num_taps,2));
 	//coefBufferSize = (uint32)(ALIGN8(coefBufferSize));
-	historyBufferSize = (uint32)(DATA_16BIT == fir_static_struct_ptr->data_width ? s64_shl_s64(fir_static_struct_ptr->max_num_taps,1) : s64_shl_s64(fir_static_struct_ptr->max_num_taps,2));
+	historyBufferSize = (uint32)(DATA_16BIT == fir_static_struct_ptr->data_width ? s64_shl_s64(fir_static_struct_ptr->max_num_taps * FIR_HISTORY_COPIES,1) : s64_shl_s64(fir_static_struct_ptr->max_num_taps * FIR_HISTORY_COPIES,2));
 #ifdef QDSP6_ASM_OPT_FIR_FILTER
 	historyBufferSize += (uint32)(DATA_16BIT == fir_static_struct_ptr->data_width ? s64_shl_s64(MAX_PROCESS_FRAME_SIZE,1) : s64_shl_s64(MAX_PROCESS_FRAME_SIZE,2));           // [<-----STATE(=TAPS-1)----->][<------INPUT BLOCK------>] //INPUT BLOCK = 5ms of 48KHz Sampling rate = 240
 	outputSize = (uint32)(DATA_16BIT == fir_static_struct_ptr->data_width ?s64_shl_s64(MAX_PROCESS_FRAME_SIZE,1) : s64_shl_s64(MAX_PROCESS_FRAME_SIZE,2));
@@ -91,6 +92,9 @@ FIR_RESULT fir_get_mem_req(fir_lib_mem_requirements_t *fir_lib_mem_requirements_
 	prevOutputBufferSize = (uint32)(DATA_16BIT == fir_static_struct_ptr->data_width ? s64_shl_s64(fir_static_struct_ptr->frame_size, 1) : s64_shl_s64(fir_static_struct_ptr->frame_size, 2));
 	prevOutputBufferSize = (uint32)(ALIGN8(prevOutputBufferSize));
 
+	// partitioned FFT convolution state, 0 unless enabled for long filters
+	fftStateSize = fir_lib_fft_get_mem_size(fir_static_struct_ptr->max_num_taps, fir_static_struct_ptr->fft_taps_threshold);
+
 	// lib memory arrangement
 
 	// -------------------  ----> fir_lib_mem_requirements_ptr->lib_mem_size
@@ -124,10 +128,14 @@ FIR_RESULT fir_get_mem_req(fir_lib_mem_requirements_t *fir_lib_mem_requirements_
 	// -------------------
 	// prev output buffer
 	// -------------------
+	// fft state (for current cfg, if enabled)
+	// -------------------
+	// fft state (for prev cfg, if enabled)
+	// -------------------
 
 	// total lib mem needed = fir_lib_mem_t + fir_static_struct_t + fir_feature_mode_t + fir_processing_t + fir_state_struct_t + stateSize + coeff_buffer + history_buffer
 	fir_lib_mem_requirements_ptr->lib_mem_size = libMemStructSize + staticStructSize + featureModeStructSize + crossFadingStructSize + pannerStructSize + cfgStructSize*3 +
-												(stateStructSize + stateSize + historyBufferSize)*2 + prevOutputBufferSize + outputSize * 2;
+												(stateStructSize + stateSize + historyBufferSize)*2 + prevOutputBufferSize + outputSize * 2 + fftStateSize * 2;
 
 	// maximal lib stack mem consumption
 	fir_lib_mem_requirements_ptr->lib_stack_size = FIR_MAX_STACK_SIZE;
@@ -159,7 +167,7 @@ FIR_RESULT fir_init_memory(fir_lib_t *fir_lib_ptr, fir_static_struct_t *fir_stat
 	int8 *pTemp= pMem;
 
 	uint32 libMemSize, libMemStructSize, staticStructSize, featureModeStructSize, crossFadingStructSize, pannerStructSize, cfgStructSize, stateStructSize, stateSize;
-	uint32 historyBufferSize, prevOutputBufferSize, outputSize=0;
+	uint32 historyBufferSize, prevOutputBufferSize, outputSize=0, fftStateSize;
 	// re-calculate lib mem size
 	libMemStructSize = ALIGN8(sizeof(fir_lib_mem_t));
 	staticStructSize = ALIGN8(sizeof(fir_static_struct_t));
@@ -173,7 +181,7 @@ FIR_RESULT fir_init_memory(fir_lib_t *fir_lib_ptr, fir_static_struct_t *fir_stat
 
 	//coefBufferSize = (uint32)(COEF_16BIT == fir_static_struct_ptr->coef_width ? s64_shl_s64(fir_static_struct_ptr->max_num_taps,1) : s64_shl_s64(fir_static_struct_ptr->max_num_taps,2));
 	//coefBufferSize = (uint32)(ALIGN8(coefBufferSize));
-	historyBufferSize = (uint32)(DATA_16BIT == fir_static_struct_ptr->data_width ? s64_shl_s64((fir_static_struct_ptr->max_num_taps),1) : s64_shl_s64((fir_static_struct_ptr->max_num_taps),2));
+	historyBufferSize = (uint32)(DATA_16BIT == fir_static_struct_ptr->data_width ? s64_shl_s64((fir_static_struct_ptr->max_num_taps * FIR_HISTORY_COPIES),1) : s64_shl_s64((fir_static_struct_ptr->max_num_taps * FIR_HISTORY_COPIES),2));
 #ifdef QDSP6_ASM_OPT_FIR_FILTER
 	historyBufferSize += (uint32)(DATA_16BIT == fir_static_struct_ptr->data_width ? s64_shl_s64(MAX_PROCESS_FRAME_SIZE,1) : s64_shl_s64(MAX_PROCESS_FRAME_SIZE,2));           // [<-----STATE(=TAPS-1)----->][<------INPUT BLOCK------>] //INPUT BLOCK = 5ms of 48KHz Sampling rate = 240
 	outputSize = (uint32)(DATA_16BIT == fir_static_struct_ptr->data_width ?s64_shl_s64(MAX_PROCESS_FRAME_SIZE,1) : s64_shl_s64(MAX_PROCESS_FRAME_SIZE,2));
@@ -184,9 +192,11 @@ FIR_RESULT fir_init_memory(fir_lib_t *fir_lib_ptr, fir_static_struct_t *fir_stat
 	prevOutputBufferSize = (uint32)(DATA_16BIT == fir_static_struct_ptr->data_width ? s64_shl_s64(fir_static_struct_ptr->frame_size, 1) : s64_shl_s64(fir_static_struct_ptr->frame_size, 2));
 	prevOutputBufferSize = (uint32)(ALIGN8(prevOutputBufferSize));
 
-	// total lib mem needed = fir_lib_mem_t + fir_static_struct_t + fir_feature_mode_t + fir_processing_t + fir_state_struct_t + stateSize + delay buffer
+	fftStateSize = fir_lib_fft_get_mem_size(fir_static_struct_ptr->max_num_taps, fir_static_struct_ptr->fft_taps_threshold);
+
+	// total lib mem needed = fir_lib_mem_t + fir_static_struct_t + fir_feature_mode_t + fir_processing_t + fir_state_struct_t + stateSize + delay buffer + fft states
 	libMemSize = libMemStructSize + staticStructSize + featureModeStructSize + crossFadingStructSize + pannerStructSize + cfgStructSize * 3 +
-				(stateStructSize + stateSize + historyBufferSize) * 2 + prevOutputBufferSize + outputSize * 2;
+				(stateStructSize + stateSize + historyBufferSize) * 2 + prevOutputBufferSize + outputSize * 2 + fftStateSize * 2;
 
 	// error out if the mem space given is not enough
 	if (memSize < libMemSize)
@@ -231,6 +241,10 @@ FIR_RESULT fir_init_memory(fir_lib_t *fir_lib_ptr, fir_static_struct_t *fir_stat
 	// -------------------
 	// prev output buffer
 	// -------------------
+	// fft state (for current cfg, if enabled)
+	// -------------------
+	// fft state (for prev cfg, if enabled)
+	// -------------------
 
 	// lib memory partition starts here
 	pFIRLibMem = (fir_lib_mem_t*)fir_lib_ptr->lib_mem_ptr;				// allocate memory for fir_lib_mem_t
@@ -243,6 +257,7 @@ FIR_RESULT fir_init_memory(fir_lib_t *fir_lib_ptr, fir_static_struct_t *fir_stat
 	pFIRLibMem->fir_static_struct_ptr->sampling_rate = fir_static_struct_ptr->sampling_rate;
 	pFIRLibMem->fir_static_struct_ptr->max_num_taps = fir_static_struct_ptr->max_num_taps;
 	pFIRLibMem->fir_static_struct_ptr->frame_size = fir_static_struct_ptr->frame_size;
+	pFIRLibMem->fir_static_struct_ptr->fft_taps_threshold = fir_static_struct_ptr->fft_taps_threshold;
 	pTemp += pFIRLibMem->fir_static_struct_size;						// pTemp points to where fir_feature_mode_t will be located
 
 	pFIRLibMem->fir_feature_mode_ptr = (fir_feature_mode_t*)pTemp;      // init fir_lib_mem_t; allocate memory for fir_feature_mode_t
@@ -333,6 +348,14 @@ FIR_RESULT fir_init_memory(fir_lib_t *fir_lib_ptr, fir_static_struct_t *fir_stat
 	pFIRLibMem->prev_fir_state_struct_ptr->fir_data.output = pTemp ;
 	pTemp += outputSize ;         //assigning pointer to output buffer
 #endif
+	// fft states
+	if (0 != fftStateSize)
+	{
+		fir_lib_fft_init_memory(&pFIRLibMem->fir_state_struct_ptr->fir_data, pTemp, fir_static_struct_ptr->max_num_taps, fir_static_struct_ptr->fft_taps_threshold);
+		pTemp += fftStateSize;
+		fir_lib_fft_init_memory(&pFIRLibMem->prev_fir_state_struct_ptr->fir_data, pTemp, fir_static_struct_ptr->max_num_taps, fir_static_struct_ptr->fft_taps_threshold);
+		pTemp += fftStateSize;
+	}
 	// update fir processing mode
 	fir_processing_mode(pFIRLibMem->fir_static_struct_ptr, pFIRLibMem->fir_state_struct_ptr, pFIRLibMem->fir_config_struct_ptr);
 
@@ -534,6 +557,7 @@ FIR_RESULT fir_set_param(fir_lib_t* pFIRLib, uint32 paramID, int8* pMem, uint32
 
 						pFIRLibMem->fir_state_struct_ptr->fir_data.taps = pFIRLibMem->fir_config_struct_ptr->num_taps;
 						pFIRLibMem->fir_state_struct_ptr->fir_data.coeffs = (void *)pFIRLibMem->fir_config_struct_ptr->coeffs_ptr;
+						fir_lib_fft_invalidate(&pFIRLibMem->fir_state_struct_ptr->fir_data);
 						if ((pFIRLibMem->fir_cross_fading_struct_ptr->fir_cross_fading_mode == 1) && (*(pFIRLibMem->fir_feature_mode_ptr) == 1))
 						{
 							pFIRLibMem->fir_config_flag = 1;
@@ -557,9 +581,11 @@ FIR_RESULT fir_set_param(fir_lib_t* pFIRLib, uint32 paramID, int8* pMem, uint32
 
 								pFIRLibMem->prev_fir_state_struct_ptr->fir_data.taps = pFIRLibMem->fir_state_struct_ptr->fir_data.taps;
 								pFIRLibMem->prev_fir_state_struct_ptr->fir_data.coeffs = pFIRLibMem->fir_state_struct_ptr->fir_data.coeffs;
-								uint32 frameBytes = (DATA_16BIT == pFIRLibMem->fir_static_struct_ptr->data_width ? s64_shl_s64(pFIRLibMem->fir_static_struct_ptr->max_num_taps, 1) : s64_shl_s64(pFIRLibMem->fir_static_struct_ptr->max_num_taps, 2));
+								fir_lib_fft_invalidate(&pFIRLibMem->prev_fir_state_struct_ptr->fir_data);
+								uint32 frameBytes = (DATA_16BIT == pFIRLibMem->fir_static_struct_ptr->data_width ? s64_shl_s64(pFIRLibMem->fir_static_struct_ptr->max_num_taps * FIR_HISTORY_COPIES, 1) : s64_shl_s64(pFIRLibMem->fir_static_struct_ptr->max_num_taps * FIR_HISTORY_COPIES, 2));
 								memscpy(pFIRLibMem->prev_fir_state_struct_ptr->fir_data.history, frameBytes, pFIRLibMem->fir_state_struct_ptr->fir_data.history, frameBytes);
 								pFIRLibMem->prev_fir_state_struct_ptr->fir_data.mem_idx = pFIRLibMem->fir_state_struct_ptr->fir_data.mem_idx;
+								pFIRLibMem->prev_fir_state_struct_ptr->fir_data.mirror_taps = pFIRLibMem->fir_state_struct_ptr->fir_data.mirror_taps;
 
 								pFIRLibMem->prev_fir_config_flag = 1;
 								pFIRLibMem->fir_config_struct_ptr->coefQFactor = tmpCfgPtr->coefQFactor;
@@ -569,6 +595,7 @@ FIR_RESULT fir_set_param(fir_lib_t* pFIRLib, uint32 paramID, int8* pMem, uint32
 
 								pFIRLibMem->fir_state_struct_ptr->fir_data.taps = pFIRLibMem->fir_config_struct_ptr->num_taps;
 								pFIRLibMem->fir_state_struct_ptr->fir_data.coeffs = (void *)pFIRLibMem->fir_config_struct_ptr->coeffs_ptr;
+								fir_lib_fft_invalidate(&pFIRLibMem->fir_state_struct_ptr->fir_data);
 
 								// trigger cross-fading
 								// initialize panner structure
@@ -594,6 +621,7 @@ FIR_RESULT fir_set_param(fir_lib_t* pFIRLib, uint32 paramID, int8* pMem, uint32
 
 								pFIRLibMem->fir_state_struct_ptr->fir_data.taps = pFIRLibMem->fir_config_struct_ptr->num_taps;
 								pFIRLibMem->fir_state_struct_ptr->fir_data.coeffs = (void*)pFIRLibMem->fir_config_struct_ptr->coeffs_ptr;
+								fir_lib_fft_invalidate(&pFIRLibMem->fir_state_struct_ptr->fir_data);
 
 								if (pFIRLibMem->fir_cross_fading_struct_ptr->fir_cross_fading_mode == 1)
 								{
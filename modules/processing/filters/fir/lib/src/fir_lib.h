@@ -50,6 +50,18 @@ void fir_c32xd32_asm(int32 *memPtr, int32 *reverse_coeff, int nInputProcSize, in
 #define FIR_CROSS_FADING_MODE_DEFAULT 0
 #define FIR_TRANSITION_PERIOD_MS_DEFAULT 20
 
+// Number of copies of the delay line kept in the history buffer. The generic kernels write every input sample
+// at idx and idx + taps, so the taps of each output sample are one contiguous window (no wrap in the MAC loop).
+#ifdef QDSP6_ASM_OPT_FIR_FILTER
+#define FIR_HISTORY_COPIES 1
+#else
+#define FIR_HISTORY_COPIES 2
+#endif
+
+// Block length of the partitioned FFT convolution (generic kernels only). The first FIR_FFT_PARTITION_LEN taps are
+// always applied in time domain, so the FFT mode adds no delay.
+#define FIR_FFT_PARTITION_LEN 256
+
 /*----------------------------------------------------------------------------
  * Type Declarations
  * -------------------------------------------------------------------------*/
@@ -81,6 +93,29 @@ typedef enum FIRProcessMode
 	COEF32XDATA32 = 3
 } FIRProcessMode;
 
+// Partitioned FFT convolution state, see fir_lib_fft.c. Spectra are stored as FIR_FFT_PARTITION_LEN real parts
+// followed by FIR_FFT_PARTITION_LEN imaginary parts; the imaginary part of DC holds the (real) Nyquist bin.
+typedef struct fir_fft_state_t
+{
+	uint32 taps_threshold;   // filters with at least this many taps use the FFT mode
+	int32  max_parts;        // partitions the memory is sized for
+	int32  num_parts;        // partitions of the current filter (taps beyond the first block)
+	int32  taps;             // taps the partition spectra were computed for
+	int32  is_valid;         // 0 when the spectra must be recomputed from the coeffs and the history
+	int32  pos;              // samples in the current block
+	int32  fdl_idx;          // slot of the newest input spectrum
+	int16  *bitrev;          // bit reversal table
+	float  *tw_cos;          // cos(2*pi*k/(2*FIR_FFT_PARTITION_LEN))
+	float  *tw_sin;          // sin(2*pi*k/(2*FIR_FFT_PARTITION_LEN))
+	float  *coef_spec;       // max_parts partition spectra
+	float  *fdl;             // max_parts input spectra (frequency domain delay line)
+	float  *frame;           // [previous block | current block] input samples
+	float  *out;             // frequency domain output, last block is used for the current block
+	float  *acc;             // spectrum accumulator
+	float  *scratch_re;      // complex FFT scratch
+	float  *scratch_im;
+} fir_fft_state_t;
+
 // defined in audio_common library
 typedef struct fir_filter_t
 {
@@ -88,6 +123,10 @@ typedef struct fir_filter_t
     int32   taps;                      /* filter taps                       */
     void    *history;                  /* filter memory (history)           */
     void    *coeffs;                   /* filter coefficients               */
+    int32   mirror_taps;               /* taps for which the second copy of */
+                                       /* the history is valid (generic)    */
+    fir_fft_state_t *fft_state;        /* partitioned FFT convolution state, */
+                                       /* NULL if not used                  */
 #ifdef QDSP6_ASM_OPT_FIR_FILTER
     void    *output;                   /* output                            */
 #endif
@@ -147,6 +186,28 @@ void fir_lib_process_c32xd16_rnd(fir_filter_t *filter, int16 *dest, int16 *src,
 void fir_lib_process_c16xd32_rnd(fir_filter_t *filter, int32 *dest, int32 *src, int32 samples, int16 qx);
 void fir_lib_process_c32xd32_rnd(fir_filter_t *filter, int32 *dest, int32 *src, int32 samples, int16 qx);
 
+#ifndef QDSP6_ASM_OPT_FIR_FILTER
+// sum (c[k] * x[k]), k = 0, ..., taps-1 without rounding or saturation; NEON on AArch64, AVX2 (runtime detected)
+// on x86-64, plain C elsewhere
+int64 fir_lib_mac_c16xd16(const int16 *c, const int16 *x, int32 taps);
+int64 fir_lib_mac_c16xd32(const int16 *c, const int32 *x, int32 taps);
+int64 fir_lib_mac_c32xd32(const int32 *c, const int32 *x, int32 taps);
+int64 fir_lib_mac_c32xd16(const int32 *c, const int16 *x, int32 taps);
+
+// Partitioned FFT convolution for filters with at least taps_threshold taps. fir_lib_fft_select returns 1 when the
+// filter must be processed with the fir_lib_fft_process functions.
+int32 fir_lib_fft_select(fir_filter_t *filter);
+void fir_lib_fft_process_c16xd16_rnd(fir_filter_t *filter, int16 *dest, int16 *src, int32 samples, int16 qx);
+void fir_lib_fft_process_c32xd16_rnd(fir_filter_t *filter, int16 *dest, int16 *src, int32 samples, int16 qx);
+void fir_lib_fft_process_c16xd32_rnd(fir_filter_t *filter, int32 *dest, int32 *src, int32 samples, int16 qx);
+void fir_lib_fft_process_c32xd32_rnd(fir_filter_t *filter, int32 *dest, int32 *src, int32 samples, int16 qx);
+#endif
+
+// FFT state memory (0 if the FFT mode is not used), its init, and invalidation after coeffs or history changes
+uint32 fir_lib_fft_get_mem_size(uint32 max_num_taps, uint32 taps_threshold);
+void fir_lib_fft_init_memory(fir_filter_t *filter, int8 *mem_ptr, uint32 max_num_taps, uint32 taps_threshold);
+void fir_lib_fft_invalidate(fir_filter_t *filter);
+
 /*----------------------------------------------------------------------------
 * Local function
 * -------------------------------------------------------------------------*/
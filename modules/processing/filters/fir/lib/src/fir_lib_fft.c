@@ -0,0 +1,590 @@
+/*============================================================================
+  @file fir_lib_fft.c
+
+  Partitioned FFT (uniformly partitioned overlap-save) convolution for long
+  FIR filters, used by the generic (non Hexagon) process functions when the
+  filter has at least fft_taps_threshold taps.
+
+  The first FIR_FFT_PARTITION_LEN taps are applied in time domain on the
+  filter history, exactly like the regular kernels. The remaining taps are
+  split into FIR_FFT_PARTITION_LEN long partitions that are applied in
+  frequency domain once per block. A partition that starts at tap
+  FIR_FFT_PARTITION_LEN only needs input that is at least one block old, so
+  the frequency domain part is always ready before its output is due and no
+  delay is added. The frequency domain part uses single precision float, so
+  the output is not bit-exact with the time domain kernels.
+
+        Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+        SPDX-License-Identifier: BSD-3-Clause-Clear
+
+============================================================================*/
+
+/*----------------------------------------------------------------------------
+ * Include Files
+ * -------------------------------------------------------------------------*/
+#include "fir_lib.h"
+#include "audio_basic_op.h"
+#include "audio_basic_op_ext.h"
+#include "stringl.h"
+
+#ifndef QDSP6_ASM_OPT_FIR_FILTER
+
+/*----------------------------------------------------------------------------
+ * Constants Definition
+ * -------------------------------------------------------------------------*/
+#define FIR_FFT_BLOCK_LEN FIR_FFT_PARTITION_LEN        // B: samples per block, complex FFT size
+#define FIR_FFT_FRAME_LEN (2 * FIR_FFT_PARTITION_LEN)  // N: real FFT size, [previous block | current block]
+#define FIR_FFT_SPEC_LEN (2 * FIR_FFT_PARTITION_LEN)   // floats per spectrum, see fir_fft_state_t
+#define FIR_FFT_PI 3.14159265358979323846
+
+// per sample cost of the transforms, in time domain taps (used for the kpps estimate only)
+#define FIR_FFT_TRANSFORM_COST_TAPS 64
+
+// Range the frequency domain part is clipped to before it is added to the time domain part. 2^62 saturates the
+// output for every Q factor (at most 31 with 32 bit data), and leaves room for a time domain part of up to 2^62.
+#define FIR_FFT_TAIL_LIMIT 4611686018427387904.0f
+
+static inline uint32 fir_fft_align8(uint32 size)
+{
+   return ALIGN8(size);
+}
+
+static inline int32 fir_fft_num_parts(int32 taps)
+{
+   return (taps - FIR_FFT_BLOCK_LEN + FIR_FFT_BLOCK_LEN - 1) / FIR_FFT_BLOCK_LEN;
+}
+
+static inline int32 fir_fft_is_long_filter(int32 taps, uint32 taps_threshold)
+{
+   return ((0 != taps_threshold) && ((uint32)taps >= taps_threshold) && (taps > FIR_FFT_BLOCK_LEN)) ? 1 : 0;
+}
+
+/*----------------------------------------------------------------------------
+ * Transforms
+ * -------------------------------------------------------------------------*/
+/* sin and cos of theta in [0, pi), Taylor series around 0 or pi/2 (no libm dependency, called only at init) */
+static void fir_fft_sin_cos(double theta, float *sin_ptr, float *cos_ptr)
+{
+   int32  is_obtuse = (theta > FIR_FFT_PI / 2) ? 1 : 0;
+   double x         = is_obtuse ? (FIR_FFT_PI - theta) : theta;
+   double x2        = x * x;
+   double s = x, c = 1.0, term_s = x, term_c = 1.0;
+
+   for (int32 n = 1; n < 12; n++)
+   {
+      term_s *= -x2 / ((2 * n) * (2 * n + 1));
+      term_c *= -x2 / ((2 * n - 1) * (2 * n));
+      s += term_s;
+      c += term_c;
+   }
+
+   *sin_ptr = (float)s;
+   *cos_ptr = (float)(is_obtuse ? -c : c);
+}
+
+/* In place forward complex FFT of FIR_FFT_BLOCK_LEN points, split real and imaginary arrays, no scaling. */
+static void fir_fft_complex(fir_fft_state_t *fft, float *re, float *im)
+{
+   const float *tw_cos = fft->tw_cos;
+   const float *tw_sin = fft->tw_sin;
+
+   for (int32 i = 0; i < FIR_FFT_BLOCK_LEN; i++)
+   {
+      int32 j = fft->bitrev[i];
+      if (j > i)
+      {
+         float tr = re[i], ti = im[i];
+         re[i] = re[j];
+         im[i] = im[j];
+         re[j] = tr;
+         im[j] = ti;
+      }
+   }
+
+   for (int32 len = 2; len <= FIR_FFT_BLOCK_LEN; len <<= 1)
+   {
+      int32 half = len >> 1;
+      // exp(-2*pi*i*j/len) is entry j*(FIR_FFT_FRAME_LEN/len) of the FIR_FFT_FRAME_LEN point table
+      int32 tw_step = FIR_FFT_FRAME_LEN / len;
+
+      for (int32 j = 0; j < half; j++)
+      {
+         float wr = tw_cos[j * tw_step];
+         float wi = -tw_sin[j * tw_step];
+
+         for (int32 a = j; a < FIR_FFT_BLOCK_LEN; a += len)
+         {
+            int32 b  = a + half;
+            float tr = re[b] * wr - im[b] * wi;
+            float ti = re[b] * wi + im[b] * wr;
+            re[b]    = re[a] - tr;
+            im[b]    = im[a] - ti;
+            re[a] += tr;
+            im[a] += ti;
+         }
+      }
+   }
+}
+
+/* Inverse complex FFT, no scaling: conj(FFT(conj(z))) */
+static void fir_fft_complex_inv(fir_fft_state_t *fft, float *re, float *im)
+{
+   for (int32 i = 0; i < FIR_FFT_BLOCK_LEN; i++)
+   {
+      im[i] = -im[i];
+   }
+   fir_fft_complex(fft, re, im);
+   for (int32 i = 0; i < FIR_FFT_BLOCK_LEN; i++)
+   {
+      im[i] = -im[i];
+   }
+}
+
+/* Real FFT of FIR_FFT_FRAME_LEN samples (x) into spec_ptr: re[0..B) followed by im[0..B), where im[0] holds the
+ * (real) bin at B. Uses the scratch buffers. */
+static void fir_fft_real(fir_fft_state_t *fft, const float *x, float *spec_ptr)
+{
+   float *zr = fft->scratch_re;
+   float *zi = fft->scratch_im;
+   float *xr = spec_ptr;
+   float *xi = spec_ptr + FIR_FFT_BLOCK_LEN;
+
+   // even samples as real part, odd samples as imaginary part
+   for (int32 n = 0; n < FIR_FFT_BLOCK_LEN; n++)
+   {
+      zr[n] = x[2 * n];
+      zi[n] = x[2 * n + 1];
+   }
+   fir_fft_complex(fft, zr, zi);
+
+   xr[0] = zr[0] + zi[0];
+   xi[0] = zr[0] - zi[0];
+   for (int32 k = 1; k < FIR_FFT_BLOCK_LEN; k++)
+   {
+      float ar = zr[k], ai = zi[k];
+      float br = zr[FIR_FFT_BLOCK_LEN - k], bi = -zi[FIR_FFT_BLOCK_LEN - k];
+      // even and odd sample spectra
+      float er = 0.5f * (ar + br), ei = 0.5f * (ai + bi);
+      float o_re = 0.5f * (ai - bi), o_im = -0.5f * (ar - br);
+      // X = E + exp(-2*pi*i*k/N) * O
+      float wr = fft->tw_cos[k], wi = -fft->tw_sin[k];
+      xr[k]    = er + (wr * o_re - wi * o_im);
+      xi[k]    = ei + (wr * o_im + wi * o_re);
+   }
+}
+
+/* Inverse of fir_fft_real scaled by FIR_FFT_FRAME_LEN, into x. Uses the scratch buffers. */
+static void fir_fft_real_inv(fir_fft_state_t *fft, const float *spec_ptr, float *x)
+{
+   float       *zr = fft->scratch_re;
+   float       *zi = fft->scratch_im;
+   const float *xr = spec_ptr;
+   const float *xi = spec_ptr + FIR_FFT_BLOCK_LEN;
+
+   zr[0] = xr[0] + xi[0];
+   zi[0] = xr[0] - xi[0];
+   for (int32 k = 1; k < FIR_FFT_BLOCK_LEN; k++)
+   {
+      float ar = xr[k], ai = xi[k];
+      float br = xr[FIR_FFT_BLOCK_LEN - k], bi = -xi[FIR_FFT_BLOCK_LEN - k];
+      // 2*E and 2*O, O = (X[k] - conj(X[B-k])) * exp(2*pi*i*k/N) / 2
+      float er = ar + br, ei = ai + bi;
+      float dr = ar - br, di = ai - bi;
+      float wr = fft->tw_cos[k], wi = fft->tw_sin[k];
+      float o_re = dr * wr - di * wi, o_im = dr * wi + di * wr;
+      // Z = E + i*O
+      zr[k] = er - o_im;
+      zi[k] = ei + o_re;
+   }
+   fir_fft_complex_inv(fft, zr, zi);
+
+   for (int32 n = 0; n < FIR_FFT_BLOCK_LEN; n++)
+   {
+      x[2 * n]     = zr[n];
+      x[2 * n + 1] = zi[n];
+   }
+}
+
+/*----------------------------------------------------------------------------
+ * Partitioned convolution
+ * -------------------------------------------------------------------------*/
+static inline float fir_fft_load(const void *ptr, int32 width, int32 i)
+{
+   return (16 == width) ? (float)((const int16 *)ptr)[i] : (float)((const int32 *)ptr)[i];
+}
+
+/* Sums the products of the input spectra with the partition spectra and transforms the result back; the last
+ * block of it is the frequency domain output for the next block of samples. */
+static void fir_fft_update_tail(fir_fft_state_t *fft)
+{
+   float *acc_re = fft->acc;
+   float *acc_im = fft->acc + FIR_FFT_BLOCK_LEN;
+
+   memset(fft->acc, 0, FIR_FFT_SPEC_LEN * sizeof(float));
+
+   for (int32 p = 0; p < fft->num_parts; p++)
+   {
+      int32        slot = fft->fdl_idx - p;
+      const float *x_re = fft->fdl + ((slot < 0) ? (slot + fft->num_parts) : slot) * FIR_FFT_SPEC_LEN;
+      const float *x_im = x_re + FIR_FFT_BLOCK_LEN;
+      const float *h_re = fft->coef_spec + p * FIR_FFT_SPEC_LEN;
+      const float *h_im = h_re + FIR_FFT_BLOCK_LEN;
+
+      // DC and bin B are real, packed in the re[0] and im[0]
+      acc_re[0] += x_re[0] * h_re[0];
+      acc_im[0] += x_im[0] * h_im[0];
+      for (int32 k = 1; k < FIR_FFT_BLOCK_LEN; k++)
+      {
+         acc_re[k] += x_re[k] * h_re[k] - x_im[k] * h_im[k];
+         acc_im[k] += x_re[k] * h_im[k] + x_im[k] * h_re[k];
+      }
+   }
+
+   fir_fft_real_inv(fft, fft->acc, fft->out);
+}
+
+/* Called when a block of input is complete. */
+static void fir_fft_process_block(fir_fft_state_t *fft)
+{
+   fft->fdl_idx = (fft->fdl_idx + 1 == fft->num_parts) ? 0 : (fft->fdl_idx + 1);
+   fir_fft_real(fft, fft->frame, fft->fdl + fft->fdl_idx * FIR_FFT_SPEC_LEN);
+   fir_fft_update_tail(fft);
+
+   // current block becomes the first half of the next frame
+   memscpy(fft->frame,
+           FIR_FFT_BLOCK_LEN * sizeof(float),
+           fft->frame + FIR_FFT_BLOCK_LEN,
+           FIR_FFT_BLOCK_LEN * sizeof(float));
+   fft->pos = 0;
+}
+
+/* Stores x in the current block and returns the frequency domain output for it, rounded to int64. */
+static inline int64 fir_fft_push(fir_fft_state_t *fft, float x)
+{
+   float tail = fft->out[FIR_FFT_BLOCK_LEN + fft->pos];
+
+   fft->frame[FIR_FFT_BLOCK_LEN + fft->pos] = x;
+   if (++fft->pos == FIR_FFT_BLOCK_LEN)
+   {
+      fir_fft_process_block(fft);
+   }
+
+   if (tail > FIR_FFT_TAIL_LIMIT)
+   {
+      tail = FIR_FFT_TAIL_LIMIT;
+   }
+   else if (tail < -FIR_FFT_TAIL_LIMIT)
+   {
+      tail = -FIR_FFT_TAIL_LIMIT;
+   }
+   return (int64)((tail >= 0.0f) ? (tail + 0.5f) : (tail - 0.5f));
+}
+
+/* Computes the partition spectra of the current coefficients, scaled by 1/FIR_FFT_FRAME_LEN for the inverse. */
+static void fir_fft_load_coeffs(fir_filter_t *filter, int32 coef_width)
+{
+   fir_fft_state_t *fft   = filter->fft_state;
+   float           *frame = fft->out; // free until the tail is updated
+   float            scale = 1.0f / FIR_FFT_FRAME_LEN;
+
+   fft->num_parts = fir_fft_num_parts(filter->taps);
+   for (int32 p = 0; p < fft->num_parts; p++)
+   {
+      int32 first_tap = (p + 1) * FIR_FFT_BLOCK_LEN;
+
+      memset(frame, 0, FIR_FFT_FRAME_LEN * sizeof(float));
+      for (int32 m = 0; (m < FIR_FFT_BLOCK_LEN) && (first_tap + m < filter->taps); m++)
+      {
+         frame[m] = scale * fir_fft_load(filter->coeffs, coef_width, first_tap + m);
+      }
+      fir_fft_real(fft, frame, fft->coef_spec + p * FIR_FFT_SPEC_LEN);
+   }
+   fft->taps = filter->taps;
+}
+
+/* Rebuilds the input spectra from the time domain history, starting a new block at the current sample. The
+ * history has the last taps samples, which is all the filter output depends on. */
+static void fir_fft_load_history(fir_filter_t *filter, int32 data_width)
+{
+   fir_fft_state_t *fft      = filter->fft_state;
+   int32            taps     = filter->taps;
+   int32            next_idx = filter->mem_idx;
+
+   // sample of age a (1 is the newest) is at next_idx + a, in either copy of the delay line
+   for (int32 p = fft->num_parts - 1; p >= 0; p--)
+   {
+      int32 oldest_age = (p + 2) * FIR_FFT_BLOCK_LEN;
+      for (int32 i = 0; i < FIR_FFT_FRAME_LEN; i++)
+      {
+         int32 age     = oldest_age - i;
+         fft->frame[i] = (age <= taps) ? fir_fft_load(filter->history, data_width, next_idx + age) : 0.0f;
+      }
+      fir_fft_real(fft, fft->frame, fft->fdl + (fft->num_parts - 1 - p) * FIR_FFT_SPEC_LEN);
+   }
+   fft->fdl_idx = fft->num_parts - 1;
+
+   // newest block is the first half of the next frame
+   memscpy(fft->frame,
+           FIR_FFT_BLOCK_LEN * sizeof(float),
+           fft->frame + FIR_FFT_BLOCK_LEN,
+           FIR_FFT_BLOCK_LEN * sizeof(float));
+   fft->pos = 0;
+}
+
+/* Brings the frequency domain state in line with the filter before processing. */
+static void fir_fft_prepare(fir_filter_t *filter, int32 coef_width, int32 data_width)
+{
+   fir_fft_state_t *fft = filter->fft_state;
+
+   if ((0 == fft->is_valid) || (fft->taps != filter->taps))
+   {
+      fir_fft_load_coeffs(filter, coef_width);
+      fir_fft_load_history(filter, data_width);
+      fir_fft_update_tail(fft);
+      fft->is_valid = 1;
+   }
+}
+
+/*----------------------------------------------------------------------------
+ * Function Definitions
+ * -------------------------------------------------------------------------*/
+uint32 fir_lib_fft_get_mem_size(uint32 max_num_taps, uint32 taps_threshold)
+{
+   uint32 max_parts;
+
+   if (!fir_fft_is_long_filter((int32)max_num_taps, taps_threshold))
+   {
+      return 0;
+   }
+   max_parts = fir_fft_num_parts((int32)max_num_taps);
+
+   return fir_fft_align8(sizeof(fir_fft_state_t)) +
+          fir_fft_align8(FIR_FFT_BLOCK_LEN * sizeof(int16)) +          // bit reversal table
+          2 * FIR_FFT_BLOCK_LEN * sizeof(float) +                      // twiddles
+          2 * max_parts * FIR_FFT_SPEC_LEN * sizeof(float) +           // partition and input spectra
+          (FIR_FFT_FRAME_LEN * 2 + FIR_FFT_SPEC_LEN + 2 * FIR_FFT_BLOCK_LEN) * sizeof(float); // frame, out, acc, scratch
+}
+
+void fir_lib_fft_init_memory(fir_filter_t *filter, int8 *mem_ptr, uint32 max_num_taps, uint32 taps_threshold)
+{
+   fir_fft_state_t *fft = (fir_fft_state_t *)mem_ptr;
+   int32            max_parts = fir_fft_num_parts((int32)max_num_taps);
+   int32            log2_len  = 0;
+
+   // memory is cleared by fir_init_memory
+   mem_ptr += fir_fft_align8(sizeof(fir_fft_state_t));
+   fft->taps_threshold = taps_threshold;
+   fft->max_parts      = max_parts;
+
+   fft->bitrev = (int16 *)mem_ptr;
+   mem_ptr += fir_fft_align8(FIR_FFT_BLOCK_LEN * sizeof(int16));
+   fft->tw_cos = (float *)mem_ptr;
+   mem_ptr += FIR_FFT_BLOCK_LEN * sizeof(float);
+   fft->tw_sin = (float *)mem_ptr;
+   mem_ptr += FIR_FFT_BLOCK_LEN * sizeof(float);
+   fft->coef_spec = (float *)mem_ptr;
+   mem_ptr += max_parts * FIR_FFT_SPEC_LEN * sizeof(float);
+   fft->fdl = (float *)mem_ptr;
+   mem_ptr += max_parts * FIR_FFT_SPEC_LEN * sizeof(float);
+   fft->frame = (float *)mem_ptr;
+   mem_ptr += FIR_FFT_FRAME_LEN * sizeof(float);
+   fft->out = (float *)mem_ptr;
+   mem_ptr += FIR_FFT_FRAME_LEN * sizeof(float);
+   fft->acc = (float *)mem_ptr;
+   mem_ptr += FIR_FFT_SPEC_LEN * sizeof(float);
+   fft->scratch_re = (float *)mem_ptr;
+   mem_ptr += FIR_FFT_BLOCK_LEN * sizeof(float);
+   fft->scratch_im = (float *)mem_ptr;
+
+   while ((1 << log2_len) < FIR_FFT_BLOCK_LEN)
+   {
+      log2_len++;
+   }
+   for (int32 i = 0; i < FIR_FFT_BLOCK_LEN; i++)
+   {
+      int32 r = 0;
+      for (int32 b = 0; b < log2_len; b++)
+      {
+         r |= ((i >> b) & 1) << (log2_len - 1 - b);
+      }
+      fft->bitrev[i] = (int16)r;
+   }
+   for (int32 k = 0; k < FIR_FFT_BLOCK_LEN; k++)
+   {
+      fir_fft_sin_cos((2.0 * FIR_FFT_PI * k) / FIR_FFT_FRAME_LEN, &fft->tw_sin[k], &fft->tw_cos[k]);
+   }
+
+   filter->fft_state = fft;
+}
+
+void fir_lib_fft_invalidate(fir_filter_t *filter)
+{
+   if (NULL != filter->fft_state)
+   {
+      filter->fft_state->is_valid = 0;
+   }
+}
+
+int32 fir_lib_fft_select(fir_filter_t *filter)
+{
+   fir_fft_state_t *fft = filter->fft_state;
+
+   if (NULL == fft)
+   {
+      return 0;
+   }
+   if (!fir_fft_is_long_filter(filter->taps, fft->taps_threshold) || (fir_fft_num_parts(filter->taps) > fft->max_parts))
+   {
+      // time domain kernels don't update the input spectra
+      fft->is_valid = 0;
+      return 0;
+   }
+   return 1;
+}
+
+uint32 fir_get_equivalent_taps(uint32 num_taps, uint32 fft_taps_threshold)
+{
+   if (!fir_fft_is_long_filter((int32)num_taps, fft_taps_threshold))
+   {
+      return num_taps;
+   }
+   // time domain part, transforms, and one complex multiply per bin per partition
+   return FIR_FFT_BLOCK_LEN + FIR_FFT_TRANSFORM_COST_TAPS + 4 * fir_fft_num_parts((int32)num_taps);
+}
+
+void fir_lib_fft_process_c16xd16_rnd(fir_filter_t *filter, int16 *dest, int16 *src, int32 samples, int16 qx)
+{
+   int32  i;
+   int16  shift      = s16_sub_s16_s16(15, qx);
+   int32  idx        = filter->mem_idx;
+   int32  taps       = filter->taps;
+   int16 *filter_mem = (int16 *)filter->history;
+   int16 *coeff_ptr  = (int16 *)filter->coeffs;
+   int64  y64;
+
+   fir_fft_prepare(filter, COEF_16BIT, DATA_16BIT);
+
+   for (i = 0; i < samples; ++i)
+   {
+      int16 x = *src++;
+      filter_mem[idx] = filter_mem[idx + taps] = x;
+
+      // first partition in time domain, the rest from the frequency domain
+      y64 = fir_lib_mac_c16xd16(coeff_ptr, &filter_mem[idx], FIR_FFT_BLOCK_LEN) + fir_fft_push(filter->fft_state, x);
+      y64 = s64_shl_s64(y64, 1);
+
+      idx = (0 == idx) ? (taps - 1) : (idx - 1);
+
+      *dest++ = s16_extract_s64_h_sat(s64_add_s64_s32(s64_shl_s64(y64, shift), 0x8000));
+   }
+
+   filter->mem_idx = idx;
+}
+
+void fir_lib_fft_process_c16xd32_rnd(fir_filter_t *filter, int32 *dest, int32 *src, int32 samples, int16 qx)
+{
+   int32  i;
+   int32  idx         = filter->mem_idx;
+   int32  taps        = filter->taps;
+   int32 *filter_mem  = (int32 *)filter->history;
+   int16 *coeff_ptr   = (int16 *)filter->coeffs;
+   int64  y64;
+   int16  neg_qx      = -qx;
+   int32  tmpShiftL32 = (qx > 0) ? (((int32)1) << (qx - 1)) : 0;
+
+   fir_fft_prepare(filter, COEF_16BIT, DATA_32BIT);
+
+   for (i = 0; i < samples; ++i)
+   {
+      int32 x = *src++;
+      filter_mem[idx] = filter_mem[idx + taps] = x;
+
+      y64 = fir_lib_mac_c16xd32(coeff_ptr, &filter_mem[idx], FIR_FFT_BLOCK_LEN) +
+            fir_fft_push(filter->fft_state, (float)x);
+
+      idx = (0 == idx) ? (taps - 1) : (idx - 1);
+
+      *dest++ = s32_saturate_s64(s64_shl_s64(s64_add_s64_s32(y64, tmpShiftL32), neg_qx));
+   }
+
+   filter->mem_idx = idx;
+}
+
+void fir_lib_fft_process_c32xd32_rnd(fir_filter_t *filter, int32 *dest, int32 *src, int32 samples, int16 qx)
+{
+   int32  i;
+   int32  idx         = filter->mem_idx;
+   int32  taps        = filter->taps;
+   int32 *filter_mem  = (int32 *)filter->history;
+   int32 *coeff_ptr   = (int32 *)filter->coeffs;
+   int64  y64;
+   int16  neg_qx      = -qx;
+   int64  tmpShiftL64 = (qx > 0) ? (((int64)1) << (qx - 1)) : 0;
+
+   fir_fft_prepare(filter, COEF_32BIT, DATA_32BIT);
+
+   for (i = 0; i < samples; ++i)
+   {
+      int32 x = *src++;
+      filter_mem[idx] = filter_mem[idx + taps] = x;
+
+      y64 = fir_lib_mac_c32xd32(coeff_ptr, &filter_mem[idx], FIR_FFT_BLOCK_LEN) +
+            fir_fft_push(filter->fft_state, (float)x);
+
+      idx = (0 == idx) ? (taps - 1) : (idx - 1);
+
+      *dest++ = s32_saturate_s64(s64_shl_s64(s64_add_s64_s64(y64, tmpShiftL64), neg_qx));
+   }
+
+   filter->mem_idx = idx;
+}
+
+void fir_lib_fft_process_c32xd16_rnd(fir_filter_t *filter, int16 *dest, int16 *src, int32 samples, int16 qx)
+{
+   int32  i;
+   int32  idx         = filter->mem_idx;
+   int32  taps        = filter->taps;
+   int16 *filter_mem  = (int16 *)filter->history;
+   int32 *coeff_ptr   = (int32 *)filter->coeffs;
+   int64  y64;
+   int16  neg_qx      = -qx;
+   int64  tmpShiftL64 = (qx > 0) ? (((int64)1) << (qx - 1)) : 0;
+
+   fir_fft_prepare(filter, COEF_32BIT, DATA_16BIT);
+
+   for (i = 0; i < samples; ++i)
+   {
+      int16 x = *src++;
+      filter_mem[idx] = filter_mem[idx + taps] = x;
+
+      y64 = fir_lib_mac_c32xd16(coeff_ptr, &filter_mem[idx], FIR_FFT_BLOCK_LEN) + fir_fft_push(filter->fft_state, x);
+
+      idx = (0 == idx) ? (taps - 1) : (idx - 1);
+
+      *dest++ = s16_saturate_s32(s32_saturate_s64(s64_shl_s64(s64_add_s64_s64(y64, tmpShiftL64), neg_qx)));
+   }
+
+   filter->mem_idx = idx;
+}
+
+#else // QDSP6_ASM_OPT_FIR_FILTER
+
+uint32 fir_lib_fft_get_mem_size(uint32 max_num_taps, uint32 taps_threshold)
+{
+   return 0;
+}
+
+void fir_lib_fft_init_memory(fir_filter_t *filter, int8 *mem_ptr, uint32 max_num_taps, uint32 taps_threshold)
+{
+}
+
+void fir_lib_fft_invalidate(fir_filter_t *filter)
+{
+}
+
+uint32 fir_get_equivalent_taps(uint32 num_taps, uint32 fft_taps_threshold)
+{
+   return num_taps;
+}
+
+#endif // QDSP6_ASM_OPT_FIR_FILTER
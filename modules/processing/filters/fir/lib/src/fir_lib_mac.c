@@ -0,0 +1,326 @@
+/*============================================================================
+  @file fir_lib_mac.c
+
+  Dot product kernels used by the generic (non Hexagon) FIR process functions.
+
+  Each kernel returns sum (c[k] * x[k]), k = 0, ..., taps-1 in 64 bit without
+  any intermediate saturation or rounding, so the NEON / AVX2 versions are
+  bit-exact with the scalar loop (the sum is exact in any order).
+
+        Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+        SPDX-License-Identifier: BSD-3-Clause-Clear
+
+============================================================================*/
+
+/*----------------------------------------------------------------------------
+ * Include Files
+ * -------------------------------------------------------------------------*/
+#include "fir_lib.h"
+
+#ifndef QDSP6_ASM_OPT_FIR_FILTER
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#define FIR_MAC_NEON
+#elif defined(__x86_64__)
+#include <immintrin.h>
+#define FIR_MAC_AVX2
+#define FIR_MAC_TGT_AVX2 __attribute__((target("avx2")))
+#endif
+
+/*----------------------------------------------------------------------------
+ * Scalar tails
+ * -------------------------------------------------------------------------*/
+static inline int64 fir_mac_tail_c16xd16(int64 y64, const int16 *c, const int16 *x, int32 k, int32 taps)
+{
+   for (; k < taps; k++)
+   {
+      y64 += (int64)((int32)c[k] * (int32)x[k]);
+   }
+   return y64;
+}
+
+static inline int64 fir_mac_tail_c16xd32(int64 y64, const int16 *c, const int32 *x, int32 k, int32 taps)
+{
+   for (; k < taps; k++)
+   {
+      y64 += (int64)x[k] * c[k];
+   }
+   return y64;
+}
+
+static inline int64 fir_mac_tail_c32xd32(int64 y64, const int32 *c, const int32 *x, int32 k, int32 taps)
+{
+   for (; k < taps; k++)
+   {
+      y64 += (int64)x[k] * c[k];
+   }
+   return y64;
+}
+
+static inline int64 fir_mac_tail_c32xd16(int64 y64, const int32 *c, const int16 *x, int32 k, int32 taps)
+{
+   for (; k < taps; k++)
+   {
+      y64 += (int64)x[k] * c[k];
+   }
+   return y64;
+}
+
+#ifdef FIR_MAC_NEON
+/*----------------------------------------------------------------------------
+ * AArch64 NEON
+ * -------------------------------------------------------------------------*/
+int64 fir_lib_mac_c16xd16(const int16 *c, const int16 *x, int32 taps)
+{
+   int64x2_t acc0 = vdupq_n_s64(0);
+   int64x2_t acc1 = vdupq_n_s64(0);
+   int32     k    = 0;
+
+   for (; k + 8 <= taps; k += 8)
+   {
+      int16x8_t cv = vld1q_s16(c + k);
+      int16x8_t xv = vld1q_s16(x + k);
+      // 16x16 products are exact in 32 bit, pairwise accumulate into 64 bit
+      acc0 = vpadalq_s32(acc0, vmull_s16(vget_low_s16(cv), vget_low_s16(xv)));
+      acc1 = vpadalq_s32(acc1, vmull_high_s16(cv, xv));
+   }
+
+   return fir_mac_tail_c16xd16(vaddvq_s64(vaddq_s64(acc0, acc1)), c, x, k, taps);
+}
+
+int64 fir_lib_mac_c16xd32(const int16 *c, const int32 *x, int32 taps)
+{
+   int64x2_t acc0 = vdupq_n_s64(0);
+   int64x2_t acc1 = vdupq_n_s64(0);
+   int32     k    = 0;
+
+   for (; k + 8 <= taps; k += 8)
+   {
+      int16x8_t cv = vld1q_s16(c + k);
+      int32x4_t c0 = vmovl_s16(vget_low_s16(cv));
+      int32x4_t c1 = vmovl_high_s16(cv);
+      int32x4_t x0 = vld1q_s32(x + k);
+      int32x4_t x1 = vld1q_s32(x + k + 4);
+      acc0         = vmlal_s32(acc0, vget_low_s32(c0), vget_low_s32(x0));
+      acc1         = vmlal_high_s32(acc1, c0, x0);
+      acc0         = vmlal_s32(acc0, vget_low_s32(c1), vget_low_s32(x1));
+      acc1         = vmlal_high_s32(acc1, c1, x1);
+   }
+
+   return fir_mac_tail_c16xd32(vaddvq_s64(vaddq_s64(acc0, acc1)), c, x, k, taps);
+}
+
+int64 fir_lib_mac_c32xd32(const int32 *c, const int32 *x, int32 taps)
+{
+   int64x2_t acc0 = vdupq_n_s64(0);
+   int64x2_t acc1 = vdupq_n_s64(0);
+   int32     k    = 0;
+
+   for (; k + 4 <= taps; k += 4)
+   {
+      int32x4_t cv = vld1q_s32(c + k);
+      int32x4_t xv = vld1q_s32(x + k);
+      acc0         = vmlal_s32(acc0, vget_low_s32(cv), vget_low_s32(xv));
+      acc1         = vmlal_high_s32(acc1, cv, xv);
+   }
+
+   return fir_mac_tail_c32xd32(vaddvq_s64(vaddq_s64(acc0, acc1)), c, x, k, taps);
+}
+
+int64 fir_lib_mac_c32xd16(const int32 *c, const int16 *x, int32 taps)
+{
+   int64x2_t acc0 = vdupq_n_s64(0);
+   int64x2_t acc1 = vdupq_n_s64(0);
+   int32     k    = 0;
+
+   for (; k + 8 <= taps; k += 8)
+   {
+      int16x8_t xv = vld1q_s16(x + k);
+      int32x4_t x0 = vmovl_s16(vget_low_s16(xv));
+      int32x4_t x1 = vmovl_high_s16(xv);
+      int32x4_t c0 = vld1q_s32(c + k);
+      int32x4_t c1 = vld1q_s32(c + k + 4);
+      acc0         = vmlal_s32(acc0, vget_low_s32(c0), vget_low_s32(x0));
+      acc1         = vmlal_high_s32(acc1, c0, x0);
+      acc0         = vmlal_s32(acc0, vget_low_s32(c1), vget_low_s32(x1));
+      acc1         = vmlal_high_s32(acc1, c1, x1);
+   }
+
+   return fir_mac_tail_c32xd16(vaddvq_s64(vaddq_s64(acc0, acc1)), c, x, k, taps);
+}
+
+#else // FIR_MAC_NEON
+
+/*----------------------------------------------------------------------------
+ * Portable C, written so that the compiler can vectorize it
+ * -------------------------------------------------------------------------*/
+static int64 fir_mac_c16xd16_c(const int16 *c, const int16 *x, int32 taps)
+{
+   return fir_mac_tail_c16xd16(0, c, x, 0, taps);
+}
+
+static int64 fir_mac_c16xd32_c(const int16 *c, const int32 *x, int32 taps)
+{
+   return fir_mac_tail_c16xd32(0, c, x, 0, taps);
+}
+
+static int64 fir_mac_c32xd32_c(const int32 *c, const int32 *x, int32 taps)
+{
+   return fir_mac_tail_c32xd32(0, c, x, 0, taps);
+}
+
+static int64 fir_mac_c32xd16_c(const int32 *c, const int16 *x, int32 taps)
+{
+   return fir_mac_tail_c32xd16(0, c, x, 0, taps);
+}
+
+#ifdef FIR_MAC_AVX2
+/*----------------------------------------------------------------------------
+ * x86-64 AVX2, selected at runtime
+ * -------------------------------------------------------------------------*/
+static int32 fir_mac_has_avx2(void)
+{
+   static int32 has_avx2 = -1;
+   if (has_avx2 < 0)
+   {
+      has_avx2 = __builtin_cpu_supports("avx2") ? 1 : 0;
+   }
+   return has_avx2;
+}
+
+FIR_MAC_TGT_AVX2 static inline int64 fir_mac_hsum_avx2(__m256i acc)
+{
+   __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+   return (int64)_mm_cvtsi128_si64(sum) + (int64)_mm_extract_epi64(sum, 1);
+}
+
+/* 8 signed 32 bit lanes of c and x: accumulates the 64 bit products of the even lanes into acc0 and of the odd
+ * lanes into acc1. */
+#define FIR_MAC_AVX2_MUL32(acc0, acc1, cv, xv)                                                                        \
+   do                                                                                                                \
+   {                                                                                                                 \
+      acc0 = _mm256_add_epi64(acc0, _mm256_mul_epi32(cv, xv));                                                       \
+      acc1 = _mm256_add_epi64(acc1, _mm256_mul_epi32(_mm256_srli_epi64(cv, 32), _mm256_srli_epi64(xv, 32)));         \
+   } while (0)
+
+FIR_MAC_TGT_AVX2 static int64 fir_mac_c16xd16_avx2(const int16 *c, const int16 *x, int32 taps)
+{
+   __m256i acc0 = _mm256_setzero_si256();
+   __m256i acc1 = _mm256_setzero_si256();
+   int32   k    = 0;
+
+   for (; k + 16 <= taps; k += 16)
+   {
+      __m256i cv = _mm256_loadu_si256((const __m256i *)(c + k));
+      __m256i xv = _mm256_loadu_si256((const __m256i *)(x + k));
+      // exact 32 bit products from the low and high halves of the 16x16 products
+      __m256i lo = _mm256_mullo_epi16(cv, xv);
+      __m256i hi = _mm256_mulhi_epi16(cv, xv);
+      __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+      __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+      acc0       = _mm256_add_epi64(acc0, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(p0)));
+      acc1       = _mm256_add_epi64(acc1, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(p0, 1)));
+      acc0       = _mm256_add_epi64(acc0, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(p1)));
+      acc1       = _mm256_add_epi64(acc1, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(p1, 1)));
+   }
+
+   return fir_mac_tail_c16xd16(fir_mac_hsum_avx2(_mm256_add_epi64(acc0, acc1)), c, x, k, taps);
+}
+
+FIR_MAC_TGT_AVX2 static int64 fir_mac_c16xd32_avx2(const int16 *c, const int32 *x, int32 taps)
+{
+   __m256i acc0 = _mm256_setzero_si256();
+   __m256i acc1 = _mm256_setzero_si256();
+   int32   k    = 0;
+
+   for (; k + 8 <= taps; k += 8)
+   {
+      __m256i cv = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(c + k)));
+      __m256i xv = _mm256_loadu_si256((const __m256i *)(x + k));
+      FIR_MAC_AVX2_MUL32(acc0, acc1, cv, xv);
+   }
+
+   return fir_mac_tail_c16xd32(fir_mac_hsum_avx2(_mm256_add_epi64(acc0, acc1)), c, x, k, taps);
+}
+
+FIR_MAC_TGT_AVX2 static int64 fir_mac_c32xd32_avx2(const int32 *c, const int32 *x, int32 taps)
+{
+   __m256i acc0 = _mm256_setzero_si256();
+   __m256i acc1 = _mm256_setzero_si256();
+   int32   k    = 0;
+
+   for (; k + 8 <= taps; k += 8)
+   {
+      __m256i cv = _mm256_loadu_si256((const __m256i *)(c + k));
+      __m256i xv = _mm256_loadu_si256((const __m256i *)(x + k));
+      FIR_MAC_AVX2_MUL32(acc0, acc1, cv, xv);
+   }
+
+   return fir_mac_tail_c32xd32(fir_mac_hsum_avx2(_mm256_add_epi64(acc0, acc1)), c, x, k, taps);
+}
+
+FIR_MAC_TGT_AVX2 static int64 fir_mac_c32xd16_avx2(const int32 *c, const int16 *x, int32 taps)
+{
+   __m256i acc0 = _mm256_setzero_si256();
+   __m256i acc1 = _mm256_setzero_si256();
+   int32   k    = 0;
+
+   for (; k + 8 <= taps; k += 8)
+   {
+      __m256i cv = _mm256_loadu_si256((const __m256i *)(c + k));
+      __m256i xv = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(x + k)));
+      FIR_MAC_AVX2_MUL32(acc0, acc1, cv, xv);
+   }
+
+   return fir_mac_tail_c32xd16(fir_mac_hsum_avx2(_mm256_add_epi64(acc0, acc1)), c, x, k, taps);
+}
+#endif // FIR_MAC_AVX2
+
+int64 fir_lib_mac_c16xd16(const int16 *c, const int16 *x, int32 taps)
+{
+#ifdef FIR_MAC_AVX2
+   if (fir_mac_has_avx2())
+   {
+      return fir_mac_c16xd16_avx2(c, x, taps);
+   }
+#endif
+   return fir_mac_c16xd16_c(c, x, taps);
+}
+
+int64 fir_lib_mac_c16xd32(const int16 *c, const int32 *x, int32 taps)
+{
+#ifdef FIR_MAC_AVX2
+   if (fir_mac_has_avx2())
+   {
+      return fir_mac_c16xd32_avx2(c, x, taps);
+   }
+#endif
+   return fir_mac_c16xd32_c(c, x, taps);
+}
+
+int64 fir_lib_mac_c32xd32(const int32 *c, const int32 *x, int32 taps)
+{
+#ifdef FIR_MAC_AVX2
+   if (fir_mac_has_avx2())
+   {
+      return fir_mac_c32xd32_avx2(c, x, taps);
+   }
+#endif
+   return fir_mac_c32xd32_c(c, x, taps);
+}
+
+int64 fir_lib_mac_c32xd16(const int32 *c, const int16 *x, int32 taps)
+{
+#ifdef FIR_MAC_AVX2
+   if (fir_mac_has_avx2())
+   {
+      return fir_mac_c32xd16_avx2(c, x, taps);
+   }
+#endif
+   return fir_mac_c32xd16_c(c, x, taps);
+}
+
+#endif // FIR_MAC_NEON
+
+#endif // QDSP6_ASM_OPT_FIR_FILTER
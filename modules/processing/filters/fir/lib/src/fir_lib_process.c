@@ -34,19 +34,21 @@ void fir_lib_reset(fir_filter_t *filter, int32 data_width)
 
     // reset filter memory index
     filter->mem_idx = 0;
+    filter->mirror_taps = filter->taps;
+    fir_lib_fft_invalidate(filter);
 
-    // clean filter histories
+    // clean filter histories (all copies of the delay line)
     switch (data_width) {
     case 16:
        ptr16 = (int16 *)filter->history;
-       for (i = 0; i < filter->taps; ++i) {
+       for (i = 0; i < filter->taps * FIR_HISTORY_COPIES; ++i) {
           *ptr16++ = 0;
        }
        break;
 
     case 32:
        ptr32 = (int32 *)filter->history;
-       for (i = 0; i < filter->taps; ++i)
+       for (i = 0; i < filter->taps * FIR_HISTORY_COPIES; ++i)
        {
           *ptr32++ = 0;
        }
@@ -246,42 +248,56 @@ void fir_lib_process_c32xd16_rnd(fir_filter_t *filter, int16 *dest, int16 *src,
 
 #else
 
+/* Rebuilds the second copy of the delay line from the first one when the taps changed since it was last written.
+ * The first copy always holds the same samples as the original circular buffer. */
+static void fir_lib_sync_history_copy(fir_filter_t *filter, uint32 bytes_per_sample)
+{
+	int8   *mem_ptr = (int8 *)filter->history;
+	uint32 copy_bytes = (uint32)filter->taps * bytes_per_sample;
+
+	if (filter->mirror_taps == filter->taps) {
+		return;
+	}
+
+	memscpy(mem_ptr + copy_bytes, copy_bytes, mem_ptr, copy_bytes);
+	if (filter->mem_idx >= filter->taps) {
+		filter->mem_idx = filter->mem_idx % filter->taps;
+	}
+	filter->mirror_taps = filter->taps;
+}
 
 void fir_lib_process_c16xd16_rnd(fir_filter_t *filter, int16 *dest, int16 *src, int32 samples, int16 qx)
 {
 
-	int32   i, j;
+	int32   i;
 	int16   shift;
-	int32   idx = filter->mem_idx;
+	int32   idx;
 	int32   taps = filter->taps;
 	int16   *filter_mem = (int16 *)filter->history;
-	int16   *coeff_ptr = NULL;
+	int16   *coeff_ptr = (int16 *)filter->coeffs;
 	int64   y64;
-	//int16   value;
 	// determine the up-shift amount according to Q factor
 	shift = s16_sub_s16_s16(15, qx);
 
-	for (i = 0; i < samples; ++i) {
+	fir_lib_sync_history_copy(filter, sizeof(int16));
+	// long filters go through the partitioned FFT convolution
+	if (fir_lib_fft_select(filter)) {
+		fir_lib_fft_process_c16xd16_rnd(filter, dest, src, samples, qx);
+		return;
+	}
 
-		// update "current" sample with the new input
-		filter_mem[idx] = *src++;
+	idx = filter->mem_idx;
 
-		// reset coeff ptr & accum
-		coeff_ptr = (int16 *)filter->coeffs;
-		y64 = 0;
-
-		for (j = 0; j < taps - 1; ++j) {
-			// convolution, y = sum (c[k] * x[n-k]) , k = 0, ..., taps-1
-			//value=filter_mem[idx];
-			y64 = s64_mac_s64_s16_s16_s1(y64, *coeff_ptr++, filter_mem[idx]);
+	for (i = 0; i < samples; ++i) {
 
-			// wrap around circular buf
-			idx = s32_modwrap_s32_u32(idx + 1, taps);
-		} // end of j loop
+		// update "current" sample with the new input, in both copies of the delay line
+		filter_mem[idx] = filter_mem[idx + taps] = *src++;
 
-		// process last sample, then current idx points to the next input position
-		y64 = s64_mac_s64_s16_s16_s1(y64, *coeff_ptr++, filter_mem[idx]);
+		// convolution, y = sum (c[k] * x[n-k]) , k = 0, ..., taps-1; x[n-k] is at idx + k
+		y64 = s64_shl_s64(fir_lib_mac_c16xd16(coeff_ptr, &filter_mem[idx], taps), 1);
 
+		// next input goes one position back
+		idx = (0 == idx) ? (taps - 1) : (idx - 1);
 
 		// shift and output sample
 		*dest++ = s16_extract_s64_h_sat(s64_add_s64_s32(s64_shl_s64(y64, shift), 0x8000));
@@ -296,11 +312,11 @@ void fir_lib_process_c16xd16_rnd(fir_filter_t *filter, int16 *dest, int16 *src,
 
 void fir_lib_process_c16xd32_rnd(fir_filter_t *filter, int32 *dest, int32 *src, int32 samples, int16 qx)
 {
-	   int32   i, j;
-	   int32   idx = filter->mem_idx;
+	   int32   i;
+	   int32   idx;
 	   int32   taps = filter->taps;
 	   int32   *filter_mem = (int32 *)filter->history;
-	   int16   *coeff_ptr = NULL;
+	   int16   *coeff_ptr = (int16 *)filter->coeffs;
 	   int64   y64;
 	   int16   neg_qx = -qx;
 	   int32   tmpShiftL32=0;
@@ -308,22 +324,23 @@ void fir_lib_process_c16xd32_rnd(fir_filter_t *filter, int32 *dest, int32 *src,
 	   if(qx > 0)
 			tmpShiftL32 = ((int32)1) << (qx-1);
 
-	   for (i = 0; i < samples; ++i) {
-	      // update "current" sample with new input
-	      filter_mem[idx] = *src++;
+	   fir_lib_sync_history_copy(filter, sizeof(int32));
+	   // long filters go through the partitioned FFT convolution
+	   if (fir_lib_fft_select(filter)) {
+	      fir_lib_fft_process_c16xd32_rnd(filter, dest, src, samples, qx);
+	      return;
+	   }
 
-	      // reset coeff ptr & accum
-	      coeff_ptr = (int16 *)filter->coeffs;
-	      y64 = 0;
+	   idx = filter->mem_idx;
+
+	   for (i = 0; i < samples; ++i) {
+	      // update "current" sample with new input, in both copies of the delay line
+	      filter_mem[idx] = filter_mem[idx + taps] = *src++;
 
-	      for (j = 0; j < taps-1; ++j) {
-	         // convolution, y = sum (c[k] * x[n-k]) , k = 0, ..., taps-1
-	         y64 = s64_mac_s32_s32(y64, filter_mem[idx], (int32)*coeff_ptr++);
-	         idx = s32_modwrap_s32_u32(idx+1, taps);
-	      } // end of j loop
+	      // convolution, y = sum (c[k] * x[n-k]) , k = 0, ..., taps-1
+	      y64 = fir_lib_mac_c16xd32(coeff_ptr, &filter_mem[idx], taps);
 
-	      // process last sample, then current idx points to the next input position
-	      y64 = s64_mac_s32_s32(y64, filter_mem[idx], (int32)(*coeff_ptr++));
+	      idx = (0 == idx) ? (taps - 1) : (idx - 1);
 
 	      // round, shift and output sample
 	      *dest++ = s32_saturate_s64(s64_shl_s64(s64_add_s64_s32(y64, tmpShiftL32), neg_qx));
@@ -337,11 +354,11 @@ void fir_lib_process_c16xd32_rnd(fir_filter_t *filter, int32 *dest, int32 *src,
 void fir_lib_process_c32xd32_rnd(fir_filter_t *filter, int32 *dest, int32 *src, int32 samples, int16 qx)
 {
 
-	   int32   i, j;
-	   int32   idx = filter->mem_idx;
+	   int32   i;
+	   int32   idx;
 	   int32   taps = filter->taps;
 	   int32   *filter_mem = (int32 *)filter->history;
-	   int32   *coeff_ptr = NULL;
+	   int32   *coeff_ptr = (int32 *)filter->coeffs;
 	   int64   y64;
 	   int16   neg_qx = -qx;
 	   int64   tmpShiftL64 =0;
@@ -349,26 +366,26 @@ void fir_lib_process_c32xd32_rnd(fir_filter_t *filter, int32 *dest, int32 *src,
 	   if(qx > 0)
 			tmpShiftL64 = ((int64)1) << (qx-1);
 
-	   for (i = 0; i < samples; ++i) {
+	   fir_lib_sync_history_copy(filter, sizeof(int32));
+	   // long filters go through the partitioned FFT convolution
+	   if (fir_lib_fft_select(filter)) {
+	      fir_lib_fft_process_c32xd32_rnd(filter, dest, src, samples, qx);
+	      return;
+	   }
 
-	      // update "current" sample with new input
-	      filter_mem[idx] = *src++;
+	   idx = filter->mem_idx;
+
+	   for (i = 0; i < samples; ++i) {
 
-	      // reset coeff ptr & accum
-	      coeff_ptr = (int32 *)filter->coeffs;
-	      y64 = 0;
+	      // update "current" sample with new input, in both copies of the delay line
+	      filter_mem[idx] = filter_mem[idx + taps] = *src++;
 
-	      for (j = 0; j < taps-1; ++j) {
-	         // convolution, y = sum (c[k] * x[n-k]) , k = 0, ..., taps-1
-	         y64 = s64_mac_s32_s32(y64, filter_mem[idx], *coeff_ptr++);
-	         idx = s32_modwrap_s32_u32(idx+1, taps);
-	      } // end of j loop
+	      // convolution, y = sum (c[k] * x[n-k]) , k = 0, ..., taps-1
+	      y64 = fir_lib_mac_c32xd32(coeff_ptr, &filter_mem[idx], taps);
 
-	      // process last sample, then current idx points to the next input position
-	      y64 = s64_mac_s32_s32(y64, filter_mem[idx], *coeff_ptr++);
+	      idx = (0 == idx) ? (taps - 1) : (idx - 1);
 
 	      // shift and output sample
-	      //*dest++ = s32_saturate_s64(s64_shl_s64(y64, neg_qx));
 		  *dest++ = s32_saturate_s64(s64_shl_s64(s64_add_s64_s64(y64, tmpShiftL64), neg_qx));
 
 	   } // end of i loop
@@ -383,11 +400,11 @@ void fir_lib_process_c32xd32_rnd(fir_filter_t *filter, int32 *dest, int32 *src,
 /* 32 coeff, 16 data */
 void fir_lib_process_c32xd16_rnd(fir_filter_t *filter, int16 *dest, int16 *src, int32 samples, int16 qx)
 {
-	   int32   i, j;
-	   int32   idx = filter->mem_idx;
+	   int32   i;
+	   int32   idx;
 	   int32   taps = filter->taps;
 	   int16   *filter_mem = (int16 *)filter->history;
-	   int32   *coeff_ptr = NULL;
+	   int32   *coeff_ptr = (int32 *)filter->coeffs;
 	   int64   y64;
 	   int16   neg_qx = -qx;
 	   int64   tmpShiftL64=0;
@@ -395,26 +412,26 @@ void fir_lib_process_c32xd16_rnd(fir_filter_t *filter, int16 *dest, int16 *src,
 	   if(qx > 0)
 			tmpShiftL64 = ((int64)1) << (qx-1);
 
-	   for (i = 0; i < samples; ++i) {
+	   fir_lib_sync_history_copy(filter, sizeof(int16));
+	   // long filters go through the partitioned FFT convolution
+	   if (fir_lib_fft_select(filter)) {
+	      fir_lib_fft_process_c32xd16_rnd(filter, dest, src, samples, qx);
+	      return;
+	   }
 
-	      // update "current" sample with the new input
-	      filter_mem[idx] = *src++;
+	   idx = filter->mem_idx;
+
+	   for (i = 0; i < samples; ++i) {
 
-	      // reset coeff ptr & accum
-	      coeff_ptr = (int32 *)filter->coeffs;
-	      y64 = 0;
+	      // update "current" sample with the new input, in both copies of the delay line
+	      filter_mem[idx] = filter_mem[idx + taps] = *src++;
 
-	      for (j = 0; j < taps-1; ++j) {
-	         // convolution, y = sum (c[k] * x[n-k]) , k = 0, ..., taps-1
-	         y64 = s64_mac_s32_s32(y64, (int32)filter_mem[idx], *coeff_ptr++);
-	         idx = s32_modwrap_s32_u32(idx+1, taps);
-	      }
+	      // convolution, y = sum (c[k] * x[n-k]) , k = 0, ..., taps-1
+	      y64 = fir_lib_mac_c32xd16(coeff_ptr, &filter_mem[idx], taps);
 
-	      // process last sample, then current idx points to the next input position
-	      y64 = s64_mac_s32_s32(y64, (int32)filter_mem[idx], *coeff_ptr++);
+	      idx = (0 == idx) ? (taps - 1) : (idx - 1);
 
 	      // shift and output sample
-	      //*dest++ = s16_saturate_s32(s32_saturate_s64(s64_shl_s64(y64, neg_qx)));
 		  *dest++ = s16_saturate_s32(s32_saturate_s64(s64_shl_s64(s64_add_s64_s64(y64, tmpShiftL64), neg_qx)));
 
 	   } // end of i loop
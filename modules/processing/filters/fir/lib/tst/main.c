@@ -0,0 +1,420 @@
+/*==============================================================================
+  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+  SPDX-License-Identifier: BSD-3-Clause-Clear
+  ==============================================================================*/
+
+/*============================================================================
+  FILE:          main.c
+
+  OVERVIEW:      Regression test for the FIR library against the direct form
+                 filter. Every combination of 16/32 bit data and coefficients
+                 runs through fir_module_process for a range of tap counts
+                 (odd, even, around the kernel block sizes and up to the
+                 maximum), coefficient Q factors, random frame sizes, and
+                 inputs of silence, noise, impulses and full scale edge
+                 values, with coefficients that make the output saturate.
+                 Coefficient updates with and without a reset are covered.
+
+                 The reference is the per sample circular buffer loop the
+                 generic kernels replaced, on a linear history. The time
+                 domain kernels must match it bit for bit.
+
+                 Filters at or above fft_taps_threshold go through the
+                 partitioned FFT convolution, whose single precision float
+                 part is not bit-exact. For coefficients with an L1 norm of
+                 up to 2.0, their output may deviate from the direct form by
+                 FIR_TST_FFT_TOL_16 LSB for 16 bit data and by
+                 FIR_TST_FFT_TOL_32 LSB (about -114 dBFS) for 32 bit data.
+                 The error grows with the L1 norm, so the tolerance is scaled
+                 by it for the full scale coefficient sets. Filters below the
+                 threshold must still match exactly.
+
+  DEPENDENCIES:  fir_lib.c, fir_lib_process.c, fir_lib_mac.c, fir_lib_fft.c
+                 and the audio utilities of modules/cmn/common/utils.
+
+  ============================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fir_api.h"
+#include "audio_basic_op.h"
+#include "audio_basic_op_ext.h"
+
+/* -----------------------------------------------------------------------
+** Constant / Define Declarations
+** ----------------------------------------------------------------------- */
+#define FIR_TST_MAX_TAPS 2048
+#define FIR_TST_FRAME_SIZE 480
+#define FIR_TST_NUM_SAMPLES 4800
+#define FIR_TST_FFT_THRESHOLD 512
+#define FIR_TST_FFT_TOL_16 1
+#define FIR_TST_FFT_TOL_32 4096
+
+/* -----------------------------------------------------------------------
+** Type Declarations
+** ----------------------------------------------------------------------- */
+typedef struct fir_tst_case_t
+{
+   uint32 data_width;
+   uint32 coef_width;
+   int16  qx;
+   int32  taps;
+   int32  kind; // coefficient set, see fir_tst_make_coeffs
+} fir_tst_case_t;
+
+/* -----------------------------------------------------------------------
+** Global Data
+** ----------------------------------------------------------------------- */
+static uint32 fir_tst_seed;
+static int32  fir_tst_in[FIR_TST_NUM_SAMPLES];
+static int32  fir_tst_out[FIR_TST_NUM_SAMPLES];
+static int32  fir_tst_ref[FIR_TST_NUM_SAMPLES];
+static int32  fir_tst_coeffs[2][FIR_TST_MAX_TAPS];
+
+/* -----------------------------------------------------------------------
+** Function Definitions
+** ----------------------------------------------------------------------- */
+static uint32 fir_tst_rand(void)
+{
+   // xorshift32
+   fir_tst_seed ^= fir_tst_seed << 13;
+   fir_tst_seed ^= fir_tst_seed >> 17;
+   fir_tst_seed ^= fir_tst_seed << 5;
+   return fir_tst_seed;
+}
+
+/* Random coefficients with about gain_q8 / 256 L1 norm; kind 1 is a delayed unit impulse, kind 2 full scale taps
+   of alternating sign that saturate the output on edge value inputs. Returns the L1 norm in Q8. */
+static int64 fir_tst_make_coeffs(int32 *coeffs_ptr, const fir_tst_case_t *case_ptr, int32 gain_q8)
+{
+   int32 max_coef = (COEF_16BIT == case_ptr->coef_width) ? MAX_16 : MAX_32;
+   int64 unity    = (int64)1 << case_ptr->qx;
+   int64 l1_norm  = 0;
+   int64 max_tap  = max_coef;
+
+   // the 64 bit accumulator of the direct form must not wrap
+   if ((COEF_32BIT == case_ptr->coef_width) && (DATA_32BIT == case_ptr->data_width) && (case_ptr->taps > 1))
+   {
+      max_tap = ((int64)1 << 31) / case_ptr->taps;
+   }
+
+   for (int32 k = 0; k < case_ptr->taps; k++)
+   {
+      int64 c;
+
+      if (1 == case_ptr->kind)
+      {
+         c = (k == case_ptr->taps / 3) ? unity : 0;
+      }
+      else if (2 == case_ptr->kind)
+      {
+         c = (k & 1) ? -max_tap : max_tap;
+      }
+      else
+      {
+         c = ((int64)((int32)fir_tst_rand() >> 8) * unity * gain_q8 / case_ptr->taps) >> 30;
+      }
+      c           = (c > max_coef) ? max_coef : ((c < -(int64)max_coef - 1) ? -(int64)max_coef - 1 : c);
+      coeffs_ptr[k] = (int32)c;
+      l1_norm += (c < 0) ? -c : c;
+   }
+   return (l1_norm << 8) >> case_ptr->qx;
+}
+
+static void fir_tst_make_input(uint32 data_width)
+{
+   int32 max_in = (DATA_16BIT == data_width) ? MAX_16 : MAX_32;
+   int32 min_in = -max_in - 1;
+
+   for (int32 n = 0; n < FIR_TST_NUM_SAMPLES;)
+   {
+      int32 len  = 1 + (int32)(fir_tst_rand() % 700);
+      int32 kind = (int32)(fir_tst_rand() % 6);
+
+      for (; (len > 0) && (n < FIR_TST_NUM_SAMPLES); len--, n++)
+      {
+         int32 v;
+         switch (kind)
+         {
+            case 0:
+               v = 0;
+               break;
+            case 1:
+               v = (int32)fir_tst_rand() >> ((DATA_16BIT == data_width) ? 16 : 0);
+               break;
+            case 2:
+               v = (0 == fir_tst_rand() % 50) ? ((fir_tst_rand() & 1) ? max_in : min_in) : 0;
+               break;
+            case 3:
+               v = (n & 1) ? min_in : max_in;
+               break;
+            case 4:
+               v = max_in;
+               break;
+            default:
+               v = ((int32)fir_tst_rand() >> ((DATA_16BIT == data_width) ? 20 : 4));
+               break;
+         }
+         fir_tst_in[n] = v;
+      }
+   }
+}
+
+/* Direct form output sample n, rounded and saturated like the per sample circular buffer loop */
+static int32 fir_tst_ref_sample(const fir_tst_case_t *case_ptr, const int32 *coeffs_ptr, int32 n, int32 first)
+{
+   int64 y64 = 0;
+   int16 qx  = case_ptr->qx;
+
+   for (int32 k = 0; (k < case_ptr->taps) && (n - k >= first); k++)
+   {
+      int32 x = fir_tst_in[n - k];
+      int32 c = coeffs_ptr[k];
+
+      if ((DATA_16BIT == case_ptr->data_width) && (COEF_16BIT == case_ptr->coef_width))
+      {
+         y64 = s64_mac_s64_s16_s16_s1(y64, (int16)c, (int16)x);
+      }
+      else
+      {
+         y64 = s64_mac_s32_s32(y64, x, c);
+      }
+   }
+
+   if (DATA_16BIT == case_ptr->data_width)
+   {
+      if (COEF_16BIT == case_ptr->coef_width)
+      {
+         return s16_extract_s64_h_sat(s64_add_s64_s32(s64_shl_s64(y64, s16_sub_s16_s16(15, qx)), 0x8000));
+      }
+      int64 rnd = (qx > 0) ? ((int64)1 << (qx - 1)) : 0;
+      return s16_saturate_s32(s32_saturate_s64(s64_shl_s64(s64_add_s64_s64(y64, rnd), -qx)));
+   }
+   int64 rnd = (qx > 0) ? ((int64)1 << (qx - 1)) : 0;
+   return s32_saturate_s64(s64_shl_s64(s64_add_s64_s64(y64, rnd), -qx));
+}
+
+static void fir_tst_set_config(fir_lib_t *lib_ptr, const fir_tst_case_t *case_ptr, void *coeffs_ptr)
+{
+   fir_config_struct_t cfg;
+
+   memset(&cfg, 0, sizeof(cfg));
+   cfg.coeffs_ptr  = (uint64)(uintptr_t)coeffs_ptr;
+   cfg.coef_width  = case_ptr->coef_width;
+   cfg.coefQFactor = case_ptr->qx;
+   cfg.num_taps    = (int16)case_ptr->taps;
+   fir_set_param(lib_ptr, FIR_PARAM_CONFIG, (int8 *)&cfg, sizeof(cfg));
+}
+
+/* Runs one case through the library in random frames, switching coefficients midway, and compares every output
+   sample with the direct form. Returns the number of samples that deviate by more than tolerance per 2.0 of L1 norm
+   of the coefficients, and the largest deviation in max_dev_ptr. */
+static uint32 fir_tst_run_case(const fir_tst_case_t *case_ptr,
+                               uint32                fft_taps_threshold,
+                               uint32                tolerance,
+                               uint32 *              max_dev_ptr)
+{
+   static int16               coeffs16[2][FIR_TST_MAX_TAPS];
+   static int16               io16[2][FIR_TST_FRAME_SIZE];
+   static int32               io32[2][FIR_TST_FRAME_SIZE];
+   fir_static_struct_t        static_vars;
+   fir_lib_mem_requirements_t mem_req;
+   fir_lib_t                  lib;
+   fir_feature_mode_t         mode = FIR_ENABLED;
+   void *                     coeffs_pptr[2];
+   int8 *                     mem_ptr;
+   int32                      switch_at, reset_at, first = 0, set = 0;
+   uint32                     num_errors = 0;
+   int64                      l1_norm_q8;
+
+   *max_dev_ptr = 0;
+
+   memset(&static_vars, 0, sizeof(static_vars));
+   static_vars.data_width         = case_ptr->data_width;
+   static_vars.sampling_rate      = 48000;
+   static_vars.max_num_taps       = FIR_TST_MAX_TAPS;
+   static_vars.frame_size         = FIR_TST_FRAME_SIZE;
+   static_vars.fft_taps_threshold = fft_taps_threshold;
+
+   if ((FIR_SUCCESS != fir_get_mem_req(&mem_req, &static_vars)) ||
+       (NULL == (mem_ptr = (int8 *)calloc(1, mem_req.lib_mem_size))) ||
+       (FIR_SUCCESS != fir_init_memory(&lib, &static_vars, mem_ptr, mem_req.lib_mem_size)))
+   {
+      printf("fir init failed\n");
+      return 1;
+   }
+
+   // gain of 0.5 to 2, the second set has the same tap count
+   l1_norm_q8 = fir_tst_make_coeffs(fir_tst_coeffs[0], case_ptr, 128 + (int32)(fir_tst_rand() % 384));
+   l1_norm_q8 += fir_tst_make_coeffs(fir_tst_coeffs[1], case_ptr, 128 + (int32)(fir_tst_rand() % 384));
+   l1_norm_q8 >>= 1;
+
+   // the error of the float convolution grows with the filter gain
+   if (l1_norm_q8 > 512)
+   {
+      tolerance *= (uint32)((l1_norm_q8 + 511) / 512);
+   }
+   for (int32 s = 0; s < 2; s++)
+   {
+      coeffs_pptr[s] = fir_tst_coeffs[s];
+      if (COEF_16BIT == case_ptr->coef_width)
+      {
+         for (int32 k = 0; k < case_ptr->taps; k++)
+         {
+            coeffs16[s][k] = (int16)fir_tst_coeffs[s][k];
+         }
+         coeffs_pptr[s] = coeffs16[s];
+      }
+   }
+
+   fir_tst_make_input(case_ptr->data_width);
+
+   fir_set_param(&lib, FIR_PARAM_FEATURE_MODE, (int8 *)&mode, sizeof(mode));
+   fir_tst_set_config(&lib, case_ptr, coeffs_pptr[0]);
+
+   // new coefficients on the running history, then a reset with the first set again
+   switch_at = FIR_TST_NUM_SAMPLES / 3;
+   reset_at  = (2 * FIR_TST_NUM_SAMPLES) / 3;
+
+   for (int32 n = 0; n < FIR_TST_NUM_SAMPLES;)
+   {
+      int32 samples = 1 + (int32)(fir_tst_rand() % FIR_TST_FRAME_SIZE);
+
+      if ((n < switch_at) && (n + samples > switch_at))
+      {
+         samples = switch_at - n;
+      }
+      if ((n < reset_at) && (n + samples > reset_at))
+      {
+         samples = reset_at - n;
+      }
+      if (n + samples > FIR_TST_NUM_SAMPLES)
+      {
+         samples = FIR_TST_NUM_SAMPLES - n;
+      }
+      if (n == switch_at)
+      {
+         set = 1;
+         fir_tst_set_config(&lib, case_ptr, coeffs_pptr[set]);
+      }
+      if (n == reset_at)
+      {
+         set   = 0;
+         first = n;
+         fir_tst_set_config(&lib, case_ptr, coeffs_pptr[set]);
+         fir_set_param(&lib, FIR_PARAM_RESET, NULL, 0);
+      }
+
+      for (int32 k = 0; k < samples; k++)
+      {
+         io16[0][k] = (int16)fir_tst_in[n + k];
+         io32[0][k] = fir_tst_in[n + k];
+      }
+      if (DATA_16BIT == case_ptr->data_width)
+      {
+         fir_module_process(&lib, (int8 *)io16[1], (int8 *)io16[0], (uint32)samples);
+      }
+      else
+      {
+         fir_module_process(&lib, (int8 *)io32[1], (int8 *)io32[0], (uint32)samples);
+      }
+
+      for (int32 k = 0; k < samples; k++, n++)
+      {
+         fir_tst_out[n] = (DATA_16BIT == case_ptr->data_width) ? io16[1][k] : io32[1][k];
+         fir_tst_ref[n] = fir_tst_ref_sample(case_ptr, fir_tst_coeffs[set], n, first);
+
+         int64  diff = (int64)fir_tst_out[n] - fir_tst_ref[n];
+         uint32 dev  = (uint32)((diff < 0) ? -diff : diff);
+         *max_dev_ptr = (dev > *max_dev_ptr) ? dev : *max_dev_ptr;
+         if (dev > tolerance)
+         {
+            num_errors++;
+         }
+      }
+   }
+
+   free(mem_ptr);
+   return num_errors;
+}
+
+int main(void)
+{
+   static const int32 taps_list[] = { 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 33, 64, 127, 255, 256, 257, 511, 1000, 2047, 2048 };
+   // around the threshold and the partition boundaries of the FFT mode
+   static const int32 fft_taps_list[] = { 1, 256, 511, 512, 513, 767, 768, 1000, 1024, 1025, 1500, 2047, 2048 };
+   static const struct
+   {
+      uint32 data_width;
+      uint32 coef_width;
+      int16  qx_min;
+      int16  qx_max;
+   } modes[] = {
+      { DATA_16BIT, COEF_16BIT, 12, 15 },
+      { DATA_16BIT, COEF_32BIT, 27, 31 },
+      { DATA_32BIT, COEF_16BIT, 12, 15 },
+      { DATA_32BIT, COEF_32BIT, 27, 31 },
+   };
+   uint32 num_cases = 0, num_failed = 0;
+   uint32 fft_max_dev[2] = { 0, 0 };
+
+   for (uint32 fft = 0; fft < 2; fft++)
+   {
+      const int32 *list_ptr       = fft ? fft_taps_list : taps_list;
+      uint32       list_len       = fft ? (sizeof(fft_taps_list) / sizeof(fft_taps_list[0]))
+                                        : (sizeof(taps_list) / sizeof(taps_list[0]));
+      uint32       fft_threshold  = fft ? FIR_TST_FFT_THRESHOLD : 0;
+
+      for (uint32 m = 0; m < sizeof(modes) / sizeof(modes[0]); m++)
+      {
+         for (uint32 t = 0; t < list_len; t++)
+         {
+            for (int32 kind = 0; kind < 3; kind++)
+            {
+               fir_tst_case_t tst_case;
+               uint32         num_errors, max_dev, tolerance = 0;
+
+               fir_tst_seed        = (num_cases * 2654435761u) + 7;
+               tst_case.data_width = modes[m].data_width;
+               tst_case.coef_width = modes[m].coef_width;
+               tst_case.qx = (int16)(modes[m].qx_min + (int16)(fir_tst_rand() % (modes[m].qx_max - modes[m].qx_min + 1)));
+               tst_case.taps = list_ptr[t];
+               tst_case.kind = kind;
+
+               if (fft && (tst_case.taps >= FIR_TST_FFT_THRESHOLD))
+               {
+                  tolerance = (DATA_16BIT == tst_case.data_width) ? FIR_TST_FFT_TOL_16 : FIR_TST_FFT_TOL_32;
+               }
+
+               num_errors = fir_tst_run_case(&tst_case, fft_threshold, tolerance, &max_dev);
+               num_cases++;
+               if (tolerance)
+               {
+                  uint32 w        = (DATA_16BIT == tst_case.data_width) ? 0 : 1;
+                  fft_max_dev[w] = (max_dev > fft_max_dev[w]) ? max_dev : fft_max_dev[w];
+               }
+               if (num_errors)
+               {
+                  num_failed++;
+                  printf("%s data %lu coef %lu q%d taps %ld kind %ld: %lu samples off the direct form, by up to %lu\n",
+                         fft ? "fft" : "time",
+                         (unsigned long)tst_case.data_width,
+                         (unsigned long)tst_case.coef_width,
+                         tst_case.qx,
+                         (long)tst_case.taps,
+                         (long)kind,
+                         (unsigned long)num_errors,
+                         (unsigned long)max_dev);
+               }
+            }
+         }
+      }
+   }
+
+   printf("fir fft mode max deviation: %lu LSB (16 bit), %lu LSB (32 bit)\n",
+          (unsigned long)fft_max_dev[0],
+          (unsigned long)fft_max_dev[1]);
+   printf("fir direct form test: %lu cases, %s\n", (unsigned long)num_cases, num_failed ? "FAILED" : "passed");
+   return num_failed ? 1 : 0;
+}
@@ -15,6 +15,7 @@
  * Include files
  * -----------------------------------------------------------------------*/
 #include "capi_multistageiir_utils.h"
+#include "audio_biquad_cascade.h"
 /*------------------------------------------------------------------------
  * Static declarations
  * -----------------------------------------------------------------------*/
@@ -94,23 +95,41 @@ static capi_err_t capi_multistageiir_process(capi_t *            _pif,
          MSIIR_MSG(me->miid, DBG_ERROR_PRIO, "CAPI MSIIR : cross fade set param failed");
       }
    }
-   // the library will loop through all the channels, and if the IIR are not enabled, the
-   // library will copy_input_to_output
+   // the enabled channels are filtered together, BIQUAD_CASCADE_LANES at a time
+   msiir_lib_t *lib_ptrs[BIQUAD_CASCADE_LANES];
+   void *       lib_inp_ptrs[BIQUAD_CASCADE_LANES];
+   void *       lib_out_ptrs[BIQUAD_CASCADE_LANES];
+   uint32_t     num_libs = 0;
    for (uint32_t ch = 0; ch < me->media_fmt[0].format.num_channels; ch++)
    {
-      MSIIR_RESULT      result_lib            = MSIIR_SUCCESS;
-      CROSS_FADE_RESULT result_cross_fade_lib = CROSS_FADE_SUCCESS;
-
       if (me->enable_flag[ch])
       {
-         result_lib = msiir_process_v2(&(me->msiir_lib[ch]), out_ptr[ch], inp_ptr[ch], num_samples);
-
+         lib_ptrs[num_libs]     = &(me->msiir_lib[ch]);
+         lib_inp_ptrs[num_libs] = inp_ptr[ch];
+         lib_out_ptrs[num_libs] = out_ptr[ch];
+         num_libs++;
+      }
+      if ((BIQUAD_CASCADE_LANES == num_libs) ||
+          ((num_libs > 0) && (ch + 1 == me->media_fmt[0].format.num_channels)))
+      {
+         MSIIR_RESULT result_lib = msiir_process_mch_v2(lib_ptrs, lib_out_ptrs, lib_inp_ptrs, num_libs, num_samples);
          if (MSIIR_SUCCESS != result_lib)
          {
             MSIIR_MSG(me->miid, DBG_ERROR_PRIO, "CAPI MSIIR : library process failed %d", result_lib);
             return CAPI_EFAILED;
          }
+         num_libs = 0;
+      }
+   }
 
+   // if the IIR are not enabled, copy_input_to_output
+   for (uint32_t ch = 0; ch < me->media_fmt[0].format.num_channels; ch++)
+   {
+      MSIIR_RESULT      result_lib            = MSIIR_SUCCESS;
+      CROSS_FADE_RESULT result_cross_fade_lib = CROSS_FADE_SUCCESS;
+
+      if (me->enable_flag[ch])
+      {
          // if the new msiir filters exist, check for cross fading processing
          if (NULL != me->msiir_new_lib[ch].mem_ptr)
          {
@@ -59,6 +59,14 @@ typedef struct msiir_lib_t {           // ** library struct
 // samples: [in] number of samples to be processed per channel
 MSIIR_RESULT msiir_process_v2(msiir_lib_t *lib_ptr, void *out_ptr, void *in_ptr, uint32 samples);
 
+// ** Process one block of samples (several channels, one library each)
+// lib_ptrs: [in] array of pointers to library structures
+// out_ptrs: [out] array of pointers to output sample blocks
+// in_ptrs: [in] array of pointers to input sample blocks
+// num_chs: [in] number of channels
+// samples: [in] number of samples to be processed per channel
+MSIIR_RESULT msiir_process_mch_v2(msiir_lib_t **lib_ptrs, void **out_ptrs, void **in_ptrs, uint32 num_chs, uint32 samples);
+
 // ** Get library memory requirements
 // mem_req_ptr: [out] pointer to mem requirements structure
 // msiir_static_vars_t: [in] pointer to static variable structure
@@ -7,7 +7,7 @@
                      INCLUDE FILES FOR MODULE
 ========================================================================== */
 #include "CMultiStageIIR.h"
-#include "audio_iir_tdf2.h"
+#include "audio_biquad_cascade.h"
 #include <stringl.h>
 #include "audio_basic_op.h"
 #include "ar_defs.h"
@@ -17,17 +17,20 @@
 /*-----------------------------------------------------------------------
 ** Internal function declarations
 **-----------------------------------------------------------------------*/
+/* Denominator shift factor of all biquad stages */
+#define MSIIR_DEN_SHIFT_FAC 2
+
 PPStatus msiir_process_one_channel(   CMultiStageIIRLib *CMultiStageIIR_obj,
+                                    biquad_cascade_ch_t *pCascade,
+                                    boolean *pbFilter,
                                     void* pOut,
                                     void* pInp,
                                     int32 iNrOfSamples,
                                     uint16 k);
 
-PPStatus apply_multistage_iir(
-        MSIIRDataStruct* pMultiStageIIRStruct,
-        int16 iNumIIRStages,
-        void* pOut,
-        void* pInp,
+void apply_multistage_iir(
+        biquad_cascade_ch_t* pCascades,
+        uint16 uiNumCascades,
         int32 iNrOfSamples,
         int16 uiBitsPerSample);
 
@@ -182,10 +185,14 @@ PPStatus msiir_initialize(CMultiStageIIRLib *CMultiStageIIR_obj,
 }
 
 /*
-    Calls Process_one_channel for every channel
+    Prepares every channel and filters the enabled ones together,
+    BIQUAD_CASCADE_LANES channels at a time
 */
 PPStatus msiir_process(CMultiStageIIRLib *CMultiStageIIR_obj, void** pOut, void** pInp, int32 iNrOfSamples)
 {
+    biquad_cascade_ch_t cascades[BIQUAD_CASCADE_LANES];
+    uint16 numCascades = 0;
+    boolean bFilter;
     PPStatus result;
     uint16 k;
 
@@ -193,54 +200,54 @@ PPStatus msiir_process(CMultiStageIIRLib *CMultiStageIIR_obj, void** pOut, void*
         return PPFAILURE;
     }
 
-    if (CMultiStageIIR_obj->uiBitsPerSample == 16)
+    for (k = 0; k < CMultiStageIIR_obj->uiNumChannels; ++k)
     {
-        int16** pInp_cast;
-        int16** pOut_cast;
-        pInp_cast = (int16**)pInp;
-        pOut_cast = (int16**)pOut;
-        for (k = 0; k < CMultiStageIIR_obj->uiNumChannels; ++k)
+        result = msiir_process_one_channel(
+            CMultiStageIIR_obj,
+            &cascades[numCascades],
+            &bFilter,
+            *(pOut + k),
+            *(pInp + k),
+            iNrOfSamples,
+            k);
+        if (PPSUCCESS != result) {
+            return result;
+        }
+        if (bFilter)
         {
-            result = msiir_process_one_channel(
-                CMultiStageIIR_obj,
-                *(pOut_cast + k),
-                *(pInp_cast + k),
-                iNrOfSamples,
-                k);
-            if (PPSUCCESS != result) {
-                return result;
-            }
+            numCascades++;
         }
-    }
-    else
-    {
-        int32** pInp_cast;
-        int32** pOut_cast;
-        pInp_cast = (int32**)pInp;
-        pOut_cast = (int32**)pOut;
-        for (k = 0; k < CMultiStageIIR_obj->uiNumChannels; ++k)
+        if (BIQUAD_CASCADE_LANES == numCascades)
         {
-            result = msiir_process_one_channel(
-                CMultiStageIIR_obj,
-                *(pOut_cast + k),
-                *(pInp_cast + k),
-                iNrOfSamples,
-                k);
-            if (PPSUCCESS != result) {
-                return result;
-            }
+            apply_multistage_iir(cascades, numCascades, iNrOfSamples, CMultiStageIIR_obj->uiBitsPerSample);
+            numCascades = 0;
         }
     }
+    if (numCascades > 0)
+    {
+        apply_multistage_iir(cascades, numCascades, iNrOfSamples, CMultiStageIIR_obj->uiBitsPerSample);
+    }
     return PPSUCCESS;
 }
 
-PPStatus msiir_process_one_channel(CMultiStageIIRLib *CMultiStageIIR_obj, void* pOut, void* pInp, int32 iNrOfSamples, uint16 k)
+/*
+    Handles bypass, zero gain and pregain of one channel. When the channel
+    needs filtering, pCascade is set up and *pbFilter is set to TRUE
+*/
+PPStatus msiir_process_one_channel(CMultiStageIIRLib *CMultiStageIIR_obj,
+                                   biquad_cascade_ch_t *pCascade,
+                                   boolean *pbFilter,
+                                   void* pOut,
+                                   void* pInp,
+                                   int32 iNrOfSamples,
+                                   uint16 k)
 {
     // k = channel number
     int32 STFPreGain_k;
     MSIIRDataStruct* pIIR_k;
     int16 numStages_k;
 
+    *pbFilter = FALSE;
     numStages_k = *(CMultiStageIIR_obj->puiNumIIRStages + k);
     pIIR_k = *(CMultiStageIIR_obj->ppMultiStageIIRStruct + k);
 
@@ -270,20 +277,9 @@ PPStatus msiir_process_one_channel(CMultiStageIIRLib *CMultiStageIIR_obj, void*
         return PPSUCCESS;
     }
 
-    PPStatus result = PPSUCCESS;
-    if (MSIIR_UNITY_PREGAIN == STFPreGain_k)
-    {
-        result = apply_multistage_iir(
-                pIIR_k,
-                numStages_k,
-                pOut,
-                pInp,
-                iNrOfSamples,
-                CMultiStageIIR_obj->uiBitsPerSample);
-    }
-    else
+    if (MSIIR_UNITY_PREGAIN != STFPreGain_k)
     {
-        result = msiir_apply_stf_pregain(
+        PPStatus result = msiir_apply_stf_pregain(
                 STFPreGain_k,
                 MSIIR_Q_PREGAIN,
                 pOut,
@@ -294,91 +290,39 @@ PPStatus msiir_process_one_channel(CMultiStageIIRLib *CMultiStageIIR_obj, void*
         {
             return result;
         }
-        result = apply_multistage_iir(
-                pIIR_k,
-                numStages_k,
-                pOut,
-                pOut,
-                iNrOfSamples,
-                CMultiStageIIR_obj->uiBitsPerSample);
+        /* filter in place on the output */
+        pInp = pOut;
     }
 
-    return result;
+    pCascade->in_ptr = pInp;
+    pCascade->out_ptr = pOut;
+    pCascade->coefs_ptr = &pIIR_k->nIIRFilterCoeffs[0];
+    pCascade->mem_ptr = &pIIR_k->iFiltMemory[0];
+    pCascade->shiftn_ptr = &pIIR_k->IIRFilterNumShiftFactor;
+    pCascade->stage_stride = sizeof(MSIIRDataStruct);
+    pCascade->num_stages = numStages_k;
+    pCascade->shiftd = MSIIR_DEN_SHIFT_FAC;
+    *pbFilter = TRUE;
+
+    return PPSUCCESS;
 }
 
 
 /*
-    Call iirTDF2 for all the stages
+    Run the biquad stages of the channels
     If-Else block for data = 16-bit OR 32-bit
 */
-PPStatus apply_multistage_iir(MSIIRDataStruct* pMultiStageIIRStruct,
-                             int16 iNumIIRStages,
-                             void *pOut,
-                             void *pInp,
-                             int32 iNrOfSamples,
-                             int16 uiBitsPerSample)
+void apply_multistage_iir(biquad_cascade_ch_t* pCascades,
+                          uint16 uiNumCascades,
+                          int32 iNrOfSamples,
+                          int16 uiBitsPerSample)
 {
-    int32 i;
-    const int16 iDenShiftFac = 2;
-    MSIIRDataStruct* pIIR;
-
-    pIIR = pMultiStageIIRStruct;
-
     if (uiBitsPerSample == 16)
     {
-        int16 * pInp_new;
-        int16 * pOut_new;
-        pInp_new = (int16*)pInp;
-        pOut_new = (int16*)pOut;
-
-        for (i = 0; i < iNumIIRStages; i++)
-        {
-            /* Filtering subroutine */
-            iirTDF2_16(
-                    pInp_new,
-                    pOut_new,
-                    iNrOfSamples,
-                    &pIIR->nIIRFilterCoeffs[0],
-                    &pIIR->nIIRFilterCoeffs[MULTISTAGE_IIR_NUM_COEFFS],
-                    &pIIR->iFiltMemory[0],
-                    pIIR->IIRFilterNumShiftFactor,
-                    iDenShiftFac
-                    );
-
-            /* For in-place computation, use output buffer (pointer) to feed into input buffer for next iteration */
-            pInp_new = pOut_new;
-
-            /* Increment IIR Filter structure pointer for the next biquad stage */
-            pIIR++;
-        }
+        biquad_cascade_16(pCascades, uiNumCascades, iNrOfSamples);
     } else {
-        int32 * pInp_new;
-        int32 * pOut_new;
-        pInp_new = (int32*)pInp;
-        pOut_new = (int32*)pOut;
-
-        for (i = 0; i < iNumIIRStages; i++)
-        {
-            /* Filtering subroutine */
-            iirTDF2_32(
-                    pInp_new,
-                    pOut_new,
-                    iNrOfSamples,
-                    &pIIR->nIIRFilterCoeffs[0],
-                    &pIIR->nIIRFilterCoeffs[MULTISTAGE_IIR_NUM_COEFFS],
-                    &pIIR->iFiltMemory[0],
-                    pIIR->IIRFilterNumShiftFactor,
-                    iDenShiftFac
-                    );
-
-            /* For in-place computation, use output buffer (pointer) to feed into  input buffer for next iteration */
-            pInp_new = pOut_new;
-
-            /* Increment IIR Filter structure pointer for the next stage */
-            pIIR++;
-        }
+        biquad_cascade_32(pCascades, uiNumCascades, iNrOfSamples);
     }
-    return PPSUCCESS;
 }
 
 
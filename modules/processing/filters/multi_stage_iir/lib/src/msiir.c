@@ -14,7 +14,7 @@
 #include "simple_mm.h"
 #include "audio_dsp.h"
 #include "audio_dsp32.h"
-#include "audio_iir_tdf2.h"
+#include "audio_biquad_cascade.h"
 #include "stringl.h"
 #ifdef AVS_BUILD_SOS
 #include "capi_cmn.h"
@@ -43,92 +43,44 @@ static void set_default(mult_stage_iir_t *obj_ptr)
    // by using parameter id MSIIR_PARAM_CONFIG
 }
 
-/* process for 16 bit data */
-static MSIIR_RESULT process_16(mult_stage_iir_t *obj_ptr, int16 *out_ptr, int16 *in_ptr, int32 samples)
+/* apply the pre gain of one channel, returns where the sos sections start from or NULL when the output is done */
+static void *apply_pregain(mult_stage_iir_t *obj_ptr, void *out_ptr, void *in_ptr, int32 samples)
 {
-   iir_data_t* iir_ptr = obj_ptr->sos;
-   int16 *sos_in_ptr = in_ptr;
-   int32 i;
+   int32 bytes_per_sample = (16 == obj_ptr->static_vars.data_width) ? sizeof(int16) : sizeof(int32);
 
    // 1. if zero gain, directly output zero
    if (0 == obj_ptr->pre_gain) {
-      buffer_empty(out_ptr, samples);
-      return MSIIR_SUCCESS;
+      memset(out_ptr, 0, samples*bytes_per_sample);
+      return NULL;
    }
 
    // 2. if not unity pregain, apply it and store to output
    if (c_unity_pregain != obj_ptr->pre_gain) {
-      buffer16_fill32(out_ptr, in_ptr, obj_ptr->pre_gain, MSIIR_Q_PREGAIN, samples);
-      sos_in_ptr = out_ptr; // later, process from the scratch mem (output)
+      if (16 == obj_ptr->static_vars.data_width) {
+         buffer16_fill32((int16 *)out_ptr, (int16 *)in_ptr, obj_ptr->pre_gain, MSIIR_Q_PREGAIN, samples);
+      } else {
+         buffer32_fill32((int32 *)out_ptr, (int32 *)in_ptr, obj_ptr->pre_gain, MSIIR_Q_PREGAIN, samples);
+      }
+      in_ptr = out_ptr; // later, process from the scratch mem (output)
    }
 
-   // 3. process sos sections
+   // 3. bypass for invalid stage count
    if (obj_ptr->num_stages <= 0) {
-      // bypass for invalid stage count
-      buffer_copy(out_ptr, sos_in_ptr, samples);
-      return MSIIR_SUCCESS;
+      memscpy(out_ptr, samples*bytes_per_sample, in_ptr, samples*bytes_per_sample);
+      return NULL;
    }
 
-   for (i = 0; i < obj_ptr->num_stages; i++) {
-      // filtering subroutine
-      iirTDF2_16(sos_in_ptr, out_ptr, samples,
-         &iir_ptr->coeffs[0],
-         &iir_ptr->coeffs[MSIIR_NUM_COEFFS],
-         &iir_ptr->states[0],
-         (int16)iir_ptr->shift_factor,
-         MSIIR_DEN_SHIFT);
-
-      // feed correct ptrs for the next iteration
-      sos_in_ptr = out_ptr;
-
-      // point to the next biquad
-      iir_ptr++;
-   }
-   return MSIIR_SUCCESS;
+   return in_ptr;
 }
 
-/* process for 32 bit data */
-static MSIIR_RESULT process_32(mult_stage_iir_t *obj_ptr, int32 *out_ptr, int32 *in_ptr, int32 samples)
+/* process sos sections of the collected channels */
+static void process_sos(biquad_cascade_ch_t *cascades, uint32 num_cascades, int32 data_width, int32 samples)
 {
-   iir_data_t* iir_ptr = obj_ptr->sos;
-   int32 *sos_in_ptr = in_ptr;
-   int32 i;
-
-   // 1. if zero gain, output zero
-   if (0 == obj_ptr->pre_gain) {
-      memset(out_ptr, 0, samples*sizeof(*out_ptr));
-      return MSIIR_SUCCESS;
-   }
-
-   // 2. if not unity pregain apply it and store to output mem
-   if (c_unity_pregain != obj_ptr->pre_gain) {
-      buffer32_fill32(out_ptr, in_ptr, obj_ptr->pre_gain, MSIIR_Q_PREGAIN, samples);
-      sos_in_ptr = out_ptr; // later, process from the scratch mem (output)
-   }
-
-   // 3. process sos sections
-   if (obj_ptr->num_stages <= 0) {
-      // bypass for invalid stage count
-      memscpy(out_ptr,samples*sizeof(*out_ptr), sos_in_ptr, samples*sizeof(*out_ptr));
-      return MSIIR_SUCCESS;
-   }
-
-   for (i = 0; i < obj_ptr->num_stages; i++) {
-      // filtering subroutine
-      iirTDF2_32(sos_in_ptr, out_ptr, samples,
-         &iir_ptr->coeffs[0],
-         &iir_ptr->coeffs[MSIIR_NUM_COEFFS],
-         &iir_ptr->states[0],
-         (int16)iir_ptr->shift_factor,
-         MSIIR_DEN_SHIFT);
-
-      // feed correct pointer for the next iteration
-      sos_in_ptr = out_ptr;
-
-      // point to the next biquad
-      iir_ptr++;
+   if (16 == data_width) {
+      biquad_cascade_16(cascades, num_cascades, samples);
+   } else {
+      biquad_cascade_32(cascades, num_cascades, samples);
    }
-   return MSIIR_SUCCESS;
 }
 
 
@@ -139,17 +91,57 @@ static MSIIR_RESULT process_32(mult_stage_iir_t *obj_ptr, int32 *out_ptr, int32
 // ** Processing one block of samples with IIRTDF2 implementation
 MSIIR_RESULT msiir_process_v2(msiir_lib_t *lib_ptr, void *out_ptr, void *in_ptr, uint32 samples)
 {
-   mult_stage_iir_t *obj_ptr = (mult_stage_iir_t *)lib_ptr->mem_ptr;
+   return msiir_process_mch_v2(&lib_ptr, &out_ptr, &in_ptr, 1, samples);
+}
 
-   if (16 == obj_ptr->static_vars.data_width) {
-      return process_16(obj_ptr, (int16 *)out_ptr, (int16 *)in_ptr, samples);
+// ** Processing one block of samples of several channels, the sos sections of
+// BIQUAD_CASCADE_LANES channels are run together
+MSIIR_RESULT msiir_process_mch_v2(msiir_lib_t **lib_ptrs, void **out_ptrs, void **in_ptrs, uint32 num_chs, uint32 samples)
+{
+   biquad_cascade_ch_t cascades[BIQUAD_CASCADE_LANES];
+   uint32 num_cascades = 0;
+   int32 data_width = 0;
+   uint32 ch;
+
+   for (ch = 0; ch < num_chs; ++ch) {
+      mult_stage_iir_t *obj_ptr = (mult_stage_iir_t *)lib_ptrs[ch]->mem_ptr;
+      biquad_cascade_ch_t *cascade_ptr;
+      void *sos_in_ptr;
+
+      if (16 != obj_ptr->static_vars.data_width && 32 != obj_ptr->static_vars.data_width) {
+         return MSIIR_FAILURE;   // invalid data width
+      }
+      // channels are grouped by data width
+      if (num_cascades > 0 && data_width != obj_ptr->static_vars.data_width) {
+         process_sos(cascades, num_cascades, data_width, samples);
+         num_cascades = 0;
+      }
+      data_width = obj_ptr->static_vars.data_width;
 
-   } else if (32 == obj_ptr->static_vars.data_width) {
-      return process_32(obj_ptr, (int32 *)out_ptr, (int32 *)in_ptr, samples);
+      sos_in_ptr = apply_pregain(obj_ptr, out_ptrs[ch], in_ptrs[ch], samples);
+      if (NULL == sos_in_ptr) {
+         continue;
+      }
 
-   } else {
-      return MSIIR_FAILURE;   // invalid data width
+      cascade_ptr = &cascades[num_cascades++];
+      cascade_ptr->in_ptr = sos_in_ptr;
+      cascade_ptr->out_ptr = out_ptrs[ch];
+      cascade_ptr->coefs_ptr = &obj_ptr->sos[0].coeffs[0];
+      cascade_ptr->mem_ptr = &obj_ptr->sos[0].states[0];
+      cascade_ptr->shiftn_ptr = &obj_ptr->sos[0].shift_factor;
+      cascade_ptr->stage_stride = sizeof(iir_data_t);
+      cascade_ptr->num_stages = obj_ptr->num_stages;
+      cascade_ptr->shiftd = MSIIR_DEN_SHIFT;
+
+      if (BIQUAD_CASCADE_LANES == num_cascades) {
+         process_sos(cascades, num_cascades, data_width, samples);
+         num_cascades = 0;
+      }
+   }
+   if (num_cascades > 0) {
+      process_sos(cascades, num_cascades, data_width, samples);
    }
+   return MSIIR_SUCCESS;
 }
 
 // ** Get memory requirements
@@ -239,7 +231,7 @@ MSIIR_RESULT msiir_set_param(msiir_lib_t* lib_ptr, uint32 param_id, void* param_
                // copy coeffs
                obj_ptr->sos[i].coeffs[j] = (coeffs_ptr+i)->iir_coeffs[j];
             }
-            obj_ptr->sos[i].shift_factor = (coeffs_ptr+i)->shift_factor;
+            obj_ptr->sos[i].shift_factor = (int16)(coeffs_ptr+i)->shift_factor;
          }
          // reset lib after config change
          if (1 == reset_flag) {
@@ -20,7 +20,7 @@ extern "C" {
 #define MSIIR_FILTER_STATES      (2)         // mem length per biquad
 #define MSIIR_DEN_SHIFT          (2)         // fixed denominator shift factor
 
-static const int32 msiir_max_stack_size = 2000;    // worst case stack mem
+static const int32 msiir_max_stack_size = 3000;    // worst case stack mem, lane packed biquad cascade
 static const int32 c_unity_pregain = 134217728;    // unity gain (Q27)
 
 /*----------------------------------------------------------------------------
@@ -29,7 +29,7 @@ static const int32 c_unity_pregain = 134217728;    // unity gain (Q27)
 typedef struct iir_data_t {                  // ** second order section type
    int64             states[MSIIR_FILTER_STATES];
    int32             coeffs[MSIIR_COEFF_LENGTH];
-   int32             shift_factor;
+   int16             shift_factor;         //    numerator shift, int16 as used by the filter
 } iir_data_t;
 
 typedef struct mult_stage_iir_t{             // ** multi stage IIR 
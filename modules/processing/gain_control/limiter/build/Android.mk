@@ -16,7 +16,8 @@ LOCAL_EXPORT_C_INCLUDE_DIRS := \
 
 LOCAL_SRC_FILES := \
     lib/src/limiter.c \
-    lib/src/limiter24.c
+    lib/src/limiter24.c \
+    lib/src/limiter_kernels.c
 
 LOCAL_CFLAGS    += -O3 -Wall -ffixed-x18
 
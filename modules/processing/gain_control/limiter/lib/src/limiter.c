@@ -184,6 +184,65 @@ int32 search_global_peak(int32 *history_peak_buf, int32 num_history_peaks)
 }
 
 #ifndef LIM_ASM
+static const int32 c_min_block_smps = 16; // shortest steady-state run handed to the block kernels
+
+/*----------------------------------------------------------------------------
+Gain smoothing time constant (Q31) of process_with_history_peak() for a sample
+of magnitude absL32, before the caller bounds it to unity.
+----------------------------------------------------------------------------*/
+static int64 history_peak_time_const(limiter_tuning_v2_t *tuning_ptr,
+                                     int32                gain_q27,
+                                     int32                target_gain_q27,
+                                     int32                absL32,
+                                     int32                q_factor)
+{
+   int64  accu64;
+   uint32 time_const, time_coef;
+
+   if (gain_q27 < target_gain_q27)
+   {
+      time_coef  = tuning_ptr->release_coef;
+      time_const = tuning_ptr->gain_release;
+   }
+   else
+   {
+      time_coef  = tuning_ptr->attack_coef;
+      time_const = tuning_ptr->gain_attack;
+   }
+
+   // accu64 = (1-coef)*abs(x) + coef
+   accu64 = s64_mult_s32_s32_shift(s32_sub_s32_s32_sat(c_unity_q15, (int32)time_coef),
+                                   absL32,
+                                   32 - (int16)q_factor);                // Q15
+   accu64 = s64_add_s32_s32(s32_saturate_s64(accu64), (int32)time_coef); // Q15
+
+   // time_const = accu64 * gain_release, Q31
+   return s64_mult_s32_u32_shift(s32_saturate_s64(accu64), time_const, 17);
+}
+
+/*----------------------------------------------------------------------------
+Checks that gain smoothing leaves the gain unchanged for every sample up to
+magnitude peak, which is where the gain stalls a few LSBs short of its target.
+With a speed coef up to unity the time constant grows with the magnitude and
+the step grows with the time constant, so checking the peak covers them all.
+----------------------------------------------------------------------------*/
+static bool_t history_peak_gain_is_stalled(limiter_tuning_v2_t *tuning_ptr,
+                                           int32                gain_q27,
+                                           int32                target_gain_q27,
+                                           int32                peak,
+                                           int32                q_factor)
+{
+   uint32 time_coef = (gain_q27 < target_gain_q27) ? tuning_ptr->release_coef : tuning_ptr->attack_coef;
+   int64  time_const = history_peak_time_const(tuning_ptr, gain_q27, target_gain_q27, peak, q_factor);
+
+   if ((time_coef > (uint32)c_unity_q15) || (time_const < 0) || (time_const > (int64)c_unity_q31))
+   {
+      return FALSE;
+   }
+   return (0 == s32_saturate_s64(
+                   s64_mult_s32_u32_shift(s32_sub_s32_s32_sat(target_gain_q27, gain_q27), (uint32)time_const, 1)));
+}
+
 /*----------------------------------------------------------------------------
 Apply gain smoothing logic to smooth the gain, so that the gain will achieve
 the target gain within pre-defined time constant.
@@ -205,10 +264,14 @@ static void process_with_history_peak(limiter_per_ch_t *per_ch_ptr,
    int32  j, gp_change_flag = 0;
    int64  accu64;
    int32  inpL32, attn32, absL32, iq32 /*, prod32*/;
+   int32  run, in_peak, dly_peak, fast_from = 0;
+   int32 *dly_ptr;
+   int64  out_bound;
+   bool_t is_steady;
    int32  cur_idx, peak_subbuf_idx, prev_peak_idx, max_wait_smps_m1;
    int32  global_peak, local_max_peak, new_global_peak;
    int32  threshold, hard_thresh, gain_diff_q27;
-   uint32 time_const, time_coef;
+   uint32 time_const;
    int32  target_gain_q27, gain_q27;
 
    threshold   = per_ch_ptr->shifted_threshold;
@@ -225,8 +288,56 @@ static void process_with_history_peak(limiter_per_ch_t *per_ch_ptr,
    target_gain_q27 = per_ch_ptr->target_gain_q27;
    gain_q27        = per_ch_ptr->gain_q27;
 
+   // Without a delay, the global peak check of the per sample path below reads delay_buf[0] although the delay
+   // line holds no samples. The block path cannot reproduce that read, so the delayless mode stays per sample.
+   if (dly_smps_m1 < 0)
+   {
+      fast_from = samples;
+   }
+
    for (j = 0; j < samples; ++j)
    {
+      /************************************************************************
+      Steady state: nothing up to the next history sub-buffer boundary or delay
+      line wrap can raise the global peak, and the gain is at its target or
+      stalled short of it. Only the gain application is left to do then, and it
+      is done on the whole run.
+       *************************************************************************/
+      if ((j >= fast_from) && (hard_thresh >= 0))
+      {
+         run     = s32_min_s32_s32(samples - j, max_wait_smps_m1 - peak_subbuf_idx);
+         run     = s32_min_s32_s32(run, dly_smps_m1 + 1 - cur_idx);
+         dly_ptr = &per_ch_ptr->delay_buf[cur_idx];
+
+         if (run >= c_min_block_smps)
+         {
+            in_peak  = lim_max_abs(&scratch32[j], run);
+            dly_peak = lim_max_abs(dly_ptr, run);
+
+            is_steady = (gain_q27 == target_gain_q27);
+            if (!is_steady &&
+                history_peak_gain_is_stalled(&per_ch_ptr->tuning_params, gain_q27, target_gain_q27, in_peak, q_factor))
+            {
+               // A stalled gain also must not reach the hard limiter, which snaps it to the target
+               out_bound = (((int64)dly_peak + 1) * ((gain_q27 < 0) ? -(int64)gain_q27 : gain_q27) + 0x4000000) >> 27;
+               is_steady = (out_bound <= hard_thresh);
+            }
+
+            if (is_steady && (s32_max_s32_s32(local_max_peak, in_peak) <= global_peak) && (dly_peak <= global_peak))
+            {
+               lim_delay_apply_gain(&scratch32[j], dly_ptr, gain_q27, -hard_thresh, hard_thresh, run);
+               cur_idx = s32_modwrap_s32_u32(cur_idx + run, dly_smps_m1 + 1);
+
+               local_max_peak = s32_max_s32_s32(local_max_peak, in_peak);
+               peak_subbuf_idx += run;
+               j += run - 1;
+               continue;
+            }
+         }
+
+         // Leave this run to the per sample path
+         fast_from = j + run;
+      }
 
       // Extract and store the current input data
       inpL32 = scratch32[j];
@@ -298,25 +409,11 @@ static void process_with_history_peak(limiter_per_ch_t *per_ch_ptr,
        *************************************************************************/
       if (gain_q27 != target_gain_q27)
       { // do gain smoothing
-         if (gain_q27 < target_gain_q27)
-         {
-            time_coef  = per_ch_ptr->tuning_params.release_coef;
-            time_const = per_ch_ptr->tuning_params.gain_release;
-         }
-         else
-         {
-            time_coef  = per_ch_ptr->tuning_params.attack_coef;
-            time_const = per_ch_ptr->tuning_params.gain_attack;
-         }
-
-         // accu64 = (1-coef)*abs(x) + coef
-         accu64 = s64_mult_s32_s32_shift(s32_sub_s32_s32_sat(c_unity_q15, (int32)time_coef),
-                                         absL32,
-                                         32 - (int16)q_factor);                // Q15
-         accu64 = s64_add_s32_s32(s32_saturate_s64(accu64), (int32)time_coef); // Q15
-
-         // time_const = accu64 * gain_release, Q31
-         time_const = (uint32)s64_mult_s32_u32_shift(s32_saturate_s64(accu64), time_const, 17);
+         time_const = (uint32)history_peak_time_const(&per_ch_ptr->tuning_params,
+                                                      gain_q27,
+                                                      target_gain_q27,
+                                                      absL32,
+                                                      q_factor);
 
          // limit the time_const uppper bound to be 1
          time_const = time_const > c_unity_q31 ? c_unity_q31 : time_const;
@@ -370,6 +467,66 @@ static void process_with_history_peak(limiter_per_ch_t *per_ch_ptr,
    return;
 }
 
+/*----------------------------------------------------------------------------
+process_delay_zc() for a block in which the gain cannot change: gain_var sits
+at a fixed point of the release step, so every zero-crossing update gives back
+the current gain, and no pending zero-crossing peak or new sample can trigger
+an attack. The zero-crossing tracking still runs per sample, the gain is
+applied to the delay line as a block.
+----------------------------------------------------------------------------*/
+static void process_delay_zc_steady(limiter_per_ch_t *per_ch_ptr, int32 *scratch32, int32 dly_smps_m1, int32 samples)
+{
+   int32 j, run;
+   int32 inpL32, absL32;
+   int32 cur_idx, dly_idx, prev_zc_idx, local_max_peak, prev_sample_l32;
+
+   cur_idx         = per_ch_ptr->cur_idx;
+   prev_zc_idx     = per_ch_ptr->prev_zc_idx;
+   local_max_peak  = per_ch_ptr->local_max_peak;
+   prev_sample_l32 = per_ch_ptr->prev_sample_l32;
+   dly_idx         = cur_idx;
+
+   // Same zero-crossing bookkeeping as process_delay_zc(), in plain C as this is the only per sample work left
+   for (j = 0; j < samples; ++j)
+   {
+      inpL32 = scratch32[j];
+      absL32 = (MIN_32 == inpL32) ? MAX_32 : ((inpL32 < 0) ? -inpL32 : inpL32);
+
+      if (cur_idx == prev_zc_idx)
+      {
+         per_ch_ptr->zc_buf[cur_idx] = local_max_peak;
+         local_max_peak              = absL32;
+      }
+      else if ((int64)inpL32 * prev_sample_l32 <= 0)
+      {
+         per_ch_ptr->zc_buf[prev_zc_idx] = local_max_peak;
+         prev_zc_idx                     = cur_idx;
+         local_max_peak                  = absL32;
+      }
+      else
+      {
+         per_ch_ptr->zc_buf[cur_idx] = 0;
+         local_max_peak              = (absL32 > local_max_peak) ? absL32 : local_max_peak;
+      }
+
+      prev_sample_l32 = inpL32;
+      cur_idx         = (cur_idx == dly_smps_m1) ? 0 : cur_idx + 1;
+   }
+
+   // Pass the block through the delay line, one contiguous run at a time
+   for (j = 0; j < samples; j += run)
+   {
+      run = s32_min_s32_s32(samples - j, dly_smps_m1 + 1 - dly_idx);
+      lim_delay_apply_gain(&scratch32[j], &per_ch_ptr->delay_buf[dly_idx], per_ch_ptr->gain_q27, MIN_32, MAX_32, run);
+      dly_idx = s32_modwrap_s32_u32(dly_idx + run, dly_smps_m1 + 1);
+   }
+
+   per_ch_ptr->cur_idx         = cur_idx;
+   per_ch_ptr->prev_zc_idx     = prev_zc_idx;
+   per_ch_ptr->local_max_peak  = local_max_peak;
+   per_ch_ptr->prev_sample_l32 = prev_sample_l32;
+}
+
 /*----------------------------------------------------------------------------
 Detects zero crossing on the input signal and updates the limiter data
 structure. The limiter alogorithm is based on Pei Xiang's investigation and
@@ -387,7 +544,7 @@ static void process_delay_zc(limiter_per_ch_t *per_ch_ptr, int32 *scratch32, int
    int32                j;
    int64                accu64, prod64;
    int32                inpL32, accu32, attn32, absL32;
-   int32                current_zc_buf_value, iq32;
+   int32                current_zc_buf_value, iq32, peak;
    int32                cur_idx, prev_zc_idx, local_max_peak, prev_sample_l32;
    int32                threshold, gc;
    int32                gain_var_q27, gain_q27;
@@ -405,6 +562,20 @@ static void process_delay_zc(limiter_per_ch_t *per_ch_ptr, int32 *scratch32, int
    gain_var_q27 = per_ch_ptr->gain_var_q27;
    gain_q27     = per_ch_ptr->gain_q27;
 
+   // The gain holds while no peak, pending or new, exceeds the threshold after the gain.
+   // A non-negative gain keeps that test monotonic, so the largest peak covers the block.
+   if ((gain_var_q27 == s32_mult_s32_s16_rnd_sat(gain_var_q27, (int16)gc)) &&
+       (gain_q27 == s32_sub_s32_s32_sat(c_gain_unity, gain_var_q27)) && (gain_q27 >= 0))
+   {
+      peak = s32_max_s32_s32(s32_max_s32_s32(local_max_peak, lim_max_abs(scratch32, samples)),
+                             lim_max_abs(per_ch_ptr->zc_buf, dly_smps_m1 + 1));
+      if (s32_saturate_s64(s64_mult_s32_s32_shift(peak, gain_q27, 5)) <= threshold)
+      {
+         process_delay_zc_steady(per_ch_ptr, scratch32, dly_smps_m1, samples);
+         return;
+      }
+   }
+
    for (j = 0; j < samples; ++j)
    {
 
@@ -558,6 +729,34 @@ static void process_delayless_zc(limiter_per_ch_t *per_ch_ptr, int32 *scratch32,
    gain_var_q27    = per_ch_ptr->gain_var_q27;
    gain_q27        = per_ch_ptr->gain_q27;
 
+   // The gain holds while gain_var sits at a fixed point of the release step and no sample exceeds
+   // the threshold after the gain, so only the wait time counter has to follow the zero-crossings.
+   // A non-negative gain keeps the threshold test monotonic, so the largest sample covers the block.
+   tmp32 = s32_sub_s32_s32_sat(c_gain_unity, gain_var_q27);
+   if ((samples > 0) && (gain_var_q27 == s32_mult_s32_s16_rnd_sat(gain_var_q27, gc)) && (tmp32 >= 0) &&
+       (s32_saturate_s64(s64_mult_s32_s32_shift(lim_max_abs(scratch32, samples), tmp32, 5)) <= threshold))
+   {
+      for (j = 0; j < samples; ++j)
+      {
+         inpL32 = scratch32[j];
+
+         if (((int64)inpL32 * prev_sample_l32 < 0) || (0 == inpL32) || (cur_idx > max_wait_smps_m1))
+         {
+            cur_idx = 0;
+         }
+         prev_sample_l32 = inpL32;
+         cur_idx++;
+      }
+
+      gain_q27 = s32_sub_s32_s32(c_gain_unity, gain_var_q27);
+      lim_apply_gain(scratch32, gain_q27, MIN_32, MAX_32, samples);
+
+      per_ch_ptr->prev_sample_l32 = prev_sample_l32;
+      per_ch_ptr->cur_idx         = cur_idx;
+      per_ch_ptr->gain_q27        = gain_q27;
+      return;
+   }
+
    for (j = 0; j < samples; ++j)
    {
       // Extract and store the current input data
@@ -632,7 +831,6 @@ static void process_delayless_zc(limiter_per_ch_t *per_ch_ptr, int32 *scratch32,
 
 static void apply_makeup_gain(limiter_private_t *obj_ptr, void **out_ptr, int32 samples, uint32_t ch)
 {
-   int64                accu64;
    int32 *              out_ptr32;
    int16 *              out_ptr16;
    limiter_per_ch_t *   per_ch_ptr = &obj_ptr->per_ch[ch];
@@ -647,13 +845,8 @@ static void apply_makeup_gain(limiter_private_t *obj_ptr, void **out_ptr, int32
       }
       else
       {
-         for (uint32_t j = 0; j < samples; ++j)
-         {
-            // Multiply output with the Q7.16 make-up gain
-            accu64 = s64_add_s64_s32(s64_mult_s32_s32(obj_ptr->scratch_buf[j], per_ch_ptr->makeup_gain_q16), 0x8000);
-            // Copy the audio output from the local buffer
-            out_ptr32[j] = s32_saturate_s64(s64_shl_s64(accu64, -16));
-         }
+         // Multiply output with the Q7.16 make-up gain
+         lim_makeup_gain32(out_ptr32, obj_ptr->scratch_buf, per_ch_ptr->makeup_gain_q16, samples);
       }
    }
    else
@@ -661,20 +854,12 @@ static void apply_makeup_gain(limiter_private_t *obj_ptr, void **out_ptr, int32
       out_ptr16 = (int16 *)out_ptr[ch];
       if (c_mgain_unity == tuning_ptr->makeup_gain)
       {
-         for (uint32_t j = 0; j < samples; ++j)
-         {
-            out_ptr16[j] = s16_saturate_s32(obj_ptr->scratch_buf[j]);
-         }
+         lim_sat16(out_ptr16, obj_ptr->scratch_buf, samples);
       }
       else
       {
-         for (uint32_t j = 0; j < samples; ++j)
-         {
-            // Multiply 32bit output with the Q7.16 make-up gain, and rounding
-            accu64 = s64_add_s64_s32(s64_mult_s32_s32(obj_ptr->scratch_buf[j], per_ch_ptr->makeup_gain_q16), 0x8000);
-            // Copy the audio output from the local buffer
-            out_ptr16[j] = s16_extract_s64_h_sat(accu64);
-         }
+         // Multiply 32bit output with the Q7.16 make-up gain, and rounding
+         lim_makeup_gain16(out_ptr16, obj_ptr->scratch_buf, per_ch_ptr->makeup_gain_q16, samples);
       }
    } // end of 16 bit makeup gain
 }
@@ -80,6 +80,25 @@ typedef struct limiter_private_t {        // ** main private structure
    int32                bypass_smps;      //    bypass transition samples
 } limiter_private_t;
 
+#ifndef LIM_ASM
+/*----------------------------------------------------------------------------
+ * Block kernels (limiter_kernels.c), bit-exact with the per sample code
+ * -------------------------------------------------------------------------*/
+// largest saturated absolute value in the buffer, 0 if empty
+int32 lim_max_abs(const int32 *in_ptr, int32 samples);
+
+// io = clamp(round(delay * gain >> 27), min_out, max_out) and delay = io, sample by sample
+void lim_delay_apply_gain(int32 *io_ptr, int32 *delay_ptr, int32 gain_q27, int32 min_out, int32 max_out, int32 samples);
+
+// io = clamp(round(io * gain >> 27), min_out, max_out)
+void lim_apply_gain(int32 *io_ptr, int32 gain_q27, int32 min_out, int32 max_out, int32 samples);
+
+// makeup gain (Q16) to 32 and 16 bit outputs, and unity gain to 16 bit output
+void lim_makeup_gain32(int32 *out_ptr, const int32 *in_ptr, int32 mgain_q16, int32 samples);
+void lim_makeup_gain16(int16 *out_ptr, const int32 *in_ptr, int32 mgain_q16, int32 samples);
+void lim_sat16(int16 *out_ptr, const int32 *in_ptr, int32 samples);
+#endif // LIM_ASM
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -0,0 +1,440 @@
+/*============================================================================
+  @file limiter_kernels.c
+
+  Block kernels used by the C implementation of the limiter to handle runs of
+  samples where the gain does not change, and to apply the makeup gain.
+  All kernels are bit-exact with the per sample basic-op code in limiter.c.
+
+        Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+        SPDX-License-Identifier: BSD-3-Clause-Clear
+============================================================================*/
+
+/*----------------------------------------------------------------------------
+   Include Files
+----------------------------------------------------------------------------*/
+#include "limiter.h"
+#include "audio_basic_op_ext.h"
+
+#ifndef LIM_ASM
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define LIM_X86_AVX2
+#include <immintrin.h>
+#define LIM_AVX2_FN __attribute__((target("avx2")))
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define LIM_ARM_NEON
+#include <arm_neon.h>
+#endif
+
+/*----------------------------------------------------------------------------
+   Portable kernels, also used for the samples left over by the SIMD kernels
+----------------------------------------------------------------------------*/
+static int32 lim_max_abs_c(const int32 *in_ptr, int32 samples, int32 max_abs)
+{
+   for (int32 j = 0; j < samples; ++j)
+   {
+      max_abs = s32_max_s32_s32(max_abs, (int32)u32_abs_s32_sat(in_ptr[j]));
+   }
+   return max_abs;
+}
+
+static void lim_delay_apply_gain_c(int32 *io_ptr,
+                                   int32 *delay_ptr,
+                                   int32  gain_q27,
+                                   int32  min_out,
+                                   int32  max_out,
+                                   int32  samples)
+{
+   int32 in32, out32;
+
+   for (int32 j = 0; j < samples; ++j)
+   {
+      in32  = io_ptr[j];
+      out32 = s32_saturate_s64(s64_shl_s64(s64_add_s64_s64(s64_mult_s32_s32(delay_ptr[j], gain_q27), 0x4000000), -27));
+
+      io_ptr[j]    = (out32 > max_out) ? max_out : ((out32 < min_out) ? min_out : out32);
+      delay_ptr[j] = in32;
+   }
+}
+
+static void lim_apply_gain_c(int32 *io_ptr, int32 gain_q27, int32 min_out, int32 max_out, int32 samples)
+{
+   int32 out32;
+
+   for (int32 j = 0; j < samples; ++j)
+   {
+      out32     = s32_saturate_s64(s64_shl_s64(s64_add_s64_s64(s64_mult_s32_s32(io_ptr[j], gain_q27), 0x4000000), -27));
+      io_ptr[j] = (out32 > max_out) ? max_out : ((out32 < min_out) ? min_out : out32);
+   }
+}
+
+static void lim_makeup_gain32_c(int32 *out_ptr, const int32 *in_ptr, int32 mgain_q16, int32 samples)
+{
+   for (int32 j = 0; j < samples; ++j)
+   {
+      out_ptr[j] = s32_saturate_s64(s64_shl_s64(s64_add_s64_s32(s64_mult_s32_s32(in_ptr[j], mgain_q16), 0x8000), -16));
+   }
+}
+
+static void lim_sat16_c(int16 *out_ptr, const int32 *in_ptr, int32 samples)
+{
+   for (int32 j = 0; j < samples; ++j)
+   {
+      out_ptr[j] = s16_saturate_s32(in_ptr[j]);
+   }
+}
+
+static void lim_makeup_gain16_c(int16 *out_ptr, const int32 *in_ptr, int32 mgain_q16, int32 samples)
+{
+   for (int32 j = 0; j < samples; ++j)
+   {
+      out_ptr[j] = s16_extract_s64_h_sat(s64_add_s64_s32(s64_mult_s32_s32(in_ptr[j], mgain_q16), 0x8000));
+   }
+}
+
+#if defined(LIM_X86_AVX2)
+/*----------------------------------------------------------------------------
+   AVX2 kernels, 8 samples at a time. AVX2 has no 64 bit arithmetic shift or
+   64 bit min/max, so both are built from the logical shift and compares.
+----------------------------------------------------------------------------*/
+LIM_AVX2_FN static inline __m256i lim_sra_epi64_avx2(__m256i x, int32 shift)
+{
+   __m256i sign = _mm256_cmpgt_epi64(_mm256_setzero_si256(), x);
+
+   return _mm256_or_si256(_mm256_srl_epi64(x, _mm_cvtsi32_si128(shift)),
+                          _mm256_sll_epi64(sign, _mm_cvtsi32_si128(64 - shift)));
+}
+
+LIM_AVX2_FN static inline __m256i lim_clamp_epi64_avx2(__m256i x, __m256i lo64, __m256i hi64)
+{
+   x = _mm256_blendv_epi8(x, hi64, _mm256_cmpgt_epi64(x, hi64));
+   return _mm256_blendv_epi8(x, lo64, _mm256_cmpgt_epi64(lo64, x));
+}
+
+/* clamp((x * gain + rnd) >> shift) for 8 lanes; lo64/hi64 must be within the int32 range */
+LIM_AVX2_FN static inline __m256i lim_mult_rnd_shift_avx2(__m256i x,
+                                                          __m256i gain,
+                                                          __m256i rnd64,
+                                                          int32   shift,
+                                                          __m256i lo64,
+                                                          __m256i hi64)
+{
+   __m256i even = _mm256_add_epi64(_mm256_mul_epi32(x, gain), rnd64);
+   __m256i odd  = _mm256_add_epi64(_mm256_mul_epi32(_mm256_srli_epi64(x, 32), gain), rnd64);
+
+   even = lim_clamp_epi64_avx2(lim_sra_epi64_avx2(even, shift), lo64, hi64);
+   odd  = lim_clamp_epi64_avx2(lim_sra_epi64_avx2(odd, shift), lo64, hi64);
+
+   return _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+}
+
+/* Saturating abs, as u32_abs_s32_sat(): INT32_MIN maps to INT32_MAX */
+LIM_AVX2_FN static inline __m256i lim_abs_sat_epi32_avx2(__m256i x)
+{
+   return _mm256_min_epu32(_mm256_abs_epi32(x), _mm256_set1_epi32(0x7FFFFFFF));
+}
+
+LIM_AVX2_FN static int32 lim_max_abs_avx2(const int32 *in_ptr, int32 samples)
+{
+   __m256i max_v = _mm256_setzero_si256();
+   int32   j     = 0;
+   int32   max_arr[8];
+
+   for (; j + 8 <= samples; j += 8)
+   {
+      max_v = _mm256_max_epi32(max_v, lim_abs_sat_epi32_avx2(_mm256_loadu_si256((const __m256i *)(in_ptr + j))));
+   }
+   _mm256_storeu_si256((__m256i *)max_arr, max_v);
+
+   return lim_max_abs_c(in_ptr + j, samples - j, lim_max_abs_c(max_arr, 8, 0));
+}
+
+LIM_AVX2_FN static void lim_delay_apply_gain_avx2(int32 *io_ptr,
+                                                  int32 *delay_ptr,
+                                                  int32  gain_q27,
+                                                  int32  min_out,
+                                                  int32  max_out,
+                                                  int32  samples)
+{
+   __m256i gain  = _mm256_set1_epi32(gain_q27);
+   __m256i rnd64 = _mm256_set1_epi64x(0x4000000);
+   __m256i lo64  = _mm256_set1_epi64x(min_out);
+   __m256i hi64  = _mm256_set1_epi64x(max_out);
+   int32   j     = 0;
+
+   for (; j + 8 <= samples; j += 8)
+   {
+      __m256i in_v  = _mm256_loadu_si256((const __m256i *)(io_ptr + j));
+      __m256i dly_v = _mm256_loadu_si256((const __m256i *)(delay_ptr + j));
+
+      _mm256_storeu_si256((__m256i *)(io_ptr + j), lim_mult_rnd_shift_avx2(dly_v, gain, rnd64, 27, lo64, hi64));
+      _mm256_storeu_si256((__m256i *)(delay_ptr + j), in_v);
+   }
+   lim_delay_apply_gain_c(io_ptr + j, delay_ptr + j, gain_q27, min_out, max_out, samples - j);
+}
+
+LIM_AVX2_FN static void lim_apply_gain_avx2(int32 *io_ptr, int32 gain_q27, int32 min_out, int32 max_out, int32 samples)
+{
+   __m256i gain  = _mm256_set1_epi32(gain_q27);
+   __m256i rnd64 = _mm256_set1_epi64x(0x4000000);
+   __m256i lo64  = _mm256_set1_epi64x(min_out);
+   __m256i hi64  = _mm256_set1_epi64x(max_out);
+   int32   j     = 0;
+
+   for (; j + 8 <= samples; j += 8)
+   {
+      __m256i in_v = _mm256_loadu_si256((const __m256i *)(io_ptr + j));
+
+      _mm256_storeu_si256((__m256i *)(io_ptr + j), lim_mult_rnd_shift_avx2(in_v, gain, rnd64, 27, lo64, hi64));
+   }
+   lim_apply_gain_c(io_ptr + j, gain_q27, min_out, max_out, samples - j);
+}
+
+LIM_AVX2_FN static void lim_makeup_gain32_avx2(int32 *out_ptr, const int32 *in_ptr, int32 mgain_q16, int32 samples)
+{
+   __m256i gain  = _mm256_set1_epi32(mgain_q16);
+   __m256i rnd64 = _mm256_set1_epi64x(0x8000);
+   __m256i lo64  = _mm256_set1_epi64x(MIN_32);
+   __m256i hi64  = _mm256_set1_epi64x(MAX_32);
+   int32   j     = 0;
+
+   for (; j + 8 <= samples; j += 8)
+   {
+      __m256i in_v = _mm256_loadu_si256((const __m256i *)(in_ptr + j));
+
+      _mm256_storeu_si256((__m256i *)(out_ptr + j), lim_mult_rnd_shift_avx2(in_v, gain, rnd64, 16, lo64, hi64));
+   }
+   lim_makeup_gain32_c(out_ptr + j, in_ptr + j, mgain_q16, samples - j);
+}
+
+/* Packs two vectors of 8 int32 into 16 saturated int16 in order */
+LIM_AVX2_FN static inline __m256i lim_pack_epi32_avx2(__m256i a, __m256i b)
+{
+   return _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xD8);
+}
+
+LIM_AVX2_FN static void lim_sat16_avx2(int16 *out_ptr, const int32 *in_ptr, int32 samples)
+{
+   int32 j = 0;
+
+   for (; j + 16 <= samples; j += 16)
+   {
+      __m256i a = _mm256_loadu_si256((const __m256i *)(in_ptr + j));
+      __m256i b = _mm256_loadu_si256((const __m256i *)(in_ptr + j + 8));
+
+      _mm256_storeu_si256((__m256i *)(out_ptr + j), lim_pack_epi32_avx2(a, b));
+   }
+   lim_sat16_c(out_ptr + j, in_ptr + j, samples - j);
+}
+
+LIM_AVX2_FN static void lim_makeup_gain16_avx2(int16 *out_ptr, const int32 *in_ptr, int32 mgain_q16, int32 samples)
+{
+   __m256i gain  = _mm256_set1_epi32(mgain_q16);
+   __m256i rnd64 = _mm256_set1_epi64x(0x8000);
+   __m256i lo64  = _mm256_set1_epi64x(MIN_32);
+   __m256i hi64  = _mm256_set1_epi64x(MAX_32);
+   int32   j     = 0;
+
+   // s16_extract_s64_h_sat(): saturate to 32 bits first, then take the high half
+   for (; j + 16 <= samples; j += 16)
+   {
+      __m256i a = _mm256_loadu_si256((const __m256i *)(in_ptr + j));
+      __m256i b = _mm256_loadu_si256((const __m256i *)(in_ptr + j + 8));
+
+      a = _mm256_srai_epi32(lim_mult_rnd_shift_avx2(a, gain, rnd64, 0, lo64, hi64), 16);
+      b = _mm256_srai_epi32(lim_mult_rnd_shift_avx2(b, gain, rnd64, 0, lo64, hi64), 16);
+      _mm256_storeu_si256((__m256i *)(out_ptr + j), lim_pack_epi32_avx2(a, b));
+   }
+   lim_makeup_gain16_c(out_ptr + j, in_ptr + j, mgain_q16, samples - j);
+}
+
+#define LIM_SIMD_AVAILABLE() __builtin_cpu_supports("avx2")
+#define LIM_SIMD_FN(name) name##_avx2
+
+#elif defined(LIM_ARM_NEON)
+/*----------------------------------------------------------------------------
+   NEON kernels, 4 samples at a time. The rounding narrowing shifts round and
+   saturate on the full 64 bit product, matching the basic-op sequence.
+----------------------------------------------------------------------------*/
+static int32 lim_max_abs_neon(const int32 *in_ptr, int32 samples)
+{
+   int32x4_t max_v = vdupq_n_s32(0);
+   int32     j     = 0;
+
+   for (; j + 4 <= samples; j += 4)
+   {
+      max_v = vmaxq_s32(max_v, vqabsq_s32(vld1q_s32(in_ptr + j)));
+   }
+   return lim_max_abs_c(in_ptr + j, samples - j, vmaxvq_s32(max_v));
+}
+
+static inline int32x4_t lim_mult_q27_neon(int32x4_t x, int32x2_t gain, int32x4_t lo, int32x4_t hi)
+{
+   int32x4_t out = vcombine_s32(vqrshrn_n_s64(vmull_s32(vget_low_s32(x), gain), 27),
+                                vqrshrn_n_s64(vmull_high_s32(x, vcombine_s32(gain, gain)), 27));
+
+   return vminq_s32(vmaxq_s32(out, lo), hi);
+}
+
+static void lim_delay_apply_gain_neon(int32 *io_ptr,
+                                      int32 *delay_ptr,
+                                      int32  gain_q27,
+                                      int32  min_out,
+                                      int32  max_out,
+                                      int32  samples)
+{
+   int32x2_t gain = vdup_n_s32(gain_q27);
+   int32x4_t lo   = vdupq_n_s32(min_out);
+   int32x4_t hi   = vdupq_n_s32(max_out);
+   int32     j    = 0;
+
+   for (; j + 4 <= samples; j += 4)
+   {
+      int32x4_t in_v  = vld1q_s32(io_ptr + j);
+      int32x4_t dly_v = vld1q_s32(delay_ptr + j);
+
+      vst1q_s32(io_ptr + j, lim_mult_q27_neon(dly_v, gain, lo, hi));
+      vst1q_s32(delay_ptr + j, in_v);
+   }
+   lim_delay_apply_gain_c(io_ptr + j, delay_ptr + j, gain_q27, min_out, max_out, samples - j);
+}
+
+static void lim_apply_gain_neon(int32 *io_ptr, int32 gain_q27, int32 min_out, int32 max_out, int32 samples)
+{
+   int32x2_t gain = vdup_n_s32(gain_q27);
+   int32x4_t lo   = vdupq_n_s32(min_out);
+   int32x4_t hi   = vdupq_n_s32(max_out);
+   int32     j    = 0;
+
+   for (; j + 4 <= samples; j += 4)
+   {
+      vst1q_s32(io_ptr + j, lim_mult_q27_neon(vld1q_s32(io_ptr + j), gain, lo, hi));
+   }
+   lim_apply_gain_c(io_ptr + j, gain_q27, min_out, max_out, samples - j);
+}
+
+static void lim_makeup_gain32_neon(int32 *out_ptr, const int32 *in_ptr, int32 mgain_q16, int32 samples)
+{
+   int32x4_t gain = vdupq_n_s32(mgain_q16);
+   int32     j    = 0;
+
+   for (; j + 4 <= samples; j += 4)
+   {
+      int32x4_t in_v = vld1q_s32(in_ptr + j);
+
+      vst1q_s32(out_ptr + j,
+                vcombine_s32(vqrshrn_n_s64(vmull_s32(vget_low_s32(in_v), vget_low_s32(gain)), 16),
+                             vqrshrn_n_s64(vmull_high_s32(in_v, gain), 16)));
+   }
+   lim_makeup_gain32_c(out_ptr + j, in_ptr + j, mgain_q16, samples - j);
+}
+
+static void lim_sat16_neon(int16 *out_ptr, const int32 *in_ptr, int32 samples)
+{
+   int32 j = 0;
+
+   for (; j + 8 <= samples; j += 8)
+   {
+      vst1q_s16(out_ptr + j, vcombine_s16(vqmovn_s32(vld1q_s32(in_ptr + j)), vqmovn_s32(vld1q_s32(in_ptr + j + 4))));
+   }
+   lim_sat16_c(out_ptr + j, in_ptr + j, samples - j);
+}
+
+static void lim_makeup_gain16_neon(int16 *out_ptr, const int32 *in_ptr, int32 mgain_q16, int32 samples)
+{
+   int32x4_t gain  = vdupq_n_s32(mgain_q16);
+   int64x2_t rnd64 = vdupq_n_s64(0x8000);
+   int32     j     = 0;
+
+   // s16_extract_s64_h_sat(): saturate to 32 bits first, then take the high half
+   for (; j + 4 <= samples; j += 4)
+   {
+      int32x4_t in_v  = vld1q_s32(in_ptr + j);
+      int32x4_t sat_v = vcombine_s32(vqmovn_s64(vaddq_s64(vmull_s32(vget_low_s32(in_v), vget_low_s32(gain)), rnd64)),
+                                     vqmovn_s64(vaddq_s64(vmull_high_s32(in_v, gain), rnd64)));
+
+      vst1_s16(out_ptr + j, vshrn_n_s32(sat_v, 16));
+   }
+   lim_makeup_gain16_c(out_ptr + j, in_ptr + j, mgain_q16, samples - j);
+}
+
+#define LIM_SIMD_AVAILABLE() 1
+#define LIM_SIMD_FN(name) name##_neon
+
+#endif
+
+/*----------------------------------------------------------------------------
+   Entry points
+----------------------------------------------------------------------------*/
+int32 lim_max_abs(const int32 *in_ptr, int32 samples)
+{
+#ifdef LIM_SIMD_FN
+   if (LIM_SIMD_AVAILABLE())
+   {
+      return LIM_SIMD_FN(lim_max_abs)(in_ptr, samples);
+   }
+#endif
+   return lim_max_abs_c(in_ptr, samples, 0);
+}
+
+void lim_delay_apply_gain(int32 *io_ptr, int32 *delay_ptr, int32 gain_q27, int32 min_out, int32 max_out, int32 samples)
+{
+#ifdef LIM_SIMD_FN
+   if (LIM_SIMD_AVAILABLE())
+   {
+      LIM_SIMD_FN(lim_delay_apply_gain)(io_ptr, delay_ptr, gain_q27, min_out, max_out, samples);
+      return;
+   }
+#endif
+   lim_delay_apply_gain_c(io_ptr, delay_ptr, gain_q27, min_out, max_out, samples);
+}
+
+void lim_apply_gain(int32 *io_ptr, int32 gain_q27, int32 min_out, int32 max_out, int32 samples)
+{
+#ifdef LIM_SIMD_FN
+   if (LIM_SIMD_AVAILABLE())
+   {
+      LIM_SIMD_FN(lim_apply_gain)(io_ptr, gain_q27, min_out, max_out, samples);
+      return;
+   }
+#endif
+   lim_apply_gain_c(io_ptr, gain_q27, min_out, max_out, samples);
+}
+
+void lim_makeup_gain32(int32 *out_ptr, const int32 *in_ptr, int32 mgain_q16, int32 samples)
+{
+#ifdef LIM_SIMD_FN
+   if (LIM_SIMD_AVAILABLE())
+   {
+      LIM_SIMD_FN(lim_makeup_gain32)(out_ptr, in_ptr, mgain_q16, samples);
+      return;
+   }
+#endif
+   lim_makeup_gain32_c(out_ptr, in_ptr, mgain_q16, samples);
+}
+
+void lim_sat16(int16 *out_ptr, const int32 *in_ptr, int32 samples)
+{
+#ifdef LIM_SIMD_FN
+   if (LIM_SIMD_AVAILABLE())
+   {
+      LIM_SIMD_FN(lim_sat16)(out_ptr, in_ptr, samples);
+      return;
+   }
+#endif
+   lim_sat16_c(out_ptr, in_ptr, samples);
+}
+
+void lim_makeup_gain16(int16 *out_ptr, const int32 *in_ptr, int32 mgain_q16, int32 samples)
+{
+#ifdef LIM_SIMD_FN
+   if (LIM_SIMD_AVAILABLE())
+   {
+      LIM_SIMD_FN(lim_makeup_gain16)(out_ptr, in_ptr, mgain_q16, samples);
+      return;
+   }
+#endif
+   lim_makeup_gain16_c(out_ptr, in_ptr, mgain_q16, samples);
+}
+
+#endif // LIM_ASM
@@ -0,0 +1,282 @@
+/*==============================================================================
+  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+  SPDX-License-Identifier: BSD-3-Clause-Clear
+  ==============================================================================*/
+
+/*============================================================================
+  FILE:          main.c
+
+  OVERVIEW:      Bit-exactness test for the C limiter. Runs random
+                 configurations (16/32 bit, Q15/Q27/Q31, delay and delayless,
+                 zero-crossing and history peak modes, makeup gain, makeup gain
+                 only mode and bypass) on random blocks of silence, noise and
+                 tones, and hashes every output sample.
+
+                 LIM_TST_EXPECTED_HASH is the hash of the per sample limiter,
+                 before the block kernels of limiter_kernels.c were added. Any
+                 change of the output, in any configuration, changes the hash.
+                 The signals use integer math only, so the hash does not depend
+                 on the host math library.
+
+                 usage: limiter_test [num_configs [dump_file]]
+                 The expected hash holds for the default number of
+                 configurations. dump_file receives the raw output, to find the
+                 first difference between two builds with cmp.
+
+  DEPENDENCIES:  limiter.c, limiter24.c, limiter_kernels.c and the audio
+                 utilities of modules/cmn/common/utils.
+
+  ============================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "limiter_api.h"
+#include "audio_basic_op.h"
+
+/* -----------------------------------------------------------------------
+** Constant / Define Declarations
+** ----------------------------------------------------------------------- */
+#define LIM_TST_NUM_CONFIGS 30000
+#define LIM_TST_EXPECTED_HASH 0x95ABB45A31F9175EULL
+#define LIM_TST_MAX_BLOCK 1032
+#define LIM_TST_MAX_CHS 2
+
+/* -----------------------------------------------------------------------
+** Global Data
+** ----------------------------------------------------------------------- */
+static uint32 lim_tst_seed;
+
+/* -----------------------------------------------------------------------
+** Function Definitions
+** ----------------------------------------------------------------------- */
+static uint32 lim_tst_rand(void)
+{
+   // xorshift32
+   lim_tst_seed ^= lim_tst_seed << 13;
+   lim_tst_seed ^= lim_tst_seed >> 17;
+   lim_tst_seed ^= lim_tst_seed << 5;
+   return lim_tst_seed;
+}
+
+/* Uniform in [0, 32767] */
+static int32 lim_tst_rand_q15(void)
+{
+   return (int32)(lim_tst_rand() >> 17);
+}
+
+/* Parabolic sine of a Q32 phase, Q15 */
+static int32 lim_tst_sine(uint32 phase)
+{
+   int32 t = (int32)phase >> 16;
+
+   return (int32)(((int64)t * (32768 - ((t < 0) ? -t : t))) >> 13);
+}
+
+static uint64 lim_tst_hash(uint64 hash, const uint8 *data_ptr, uint32 size)
+{
+   // FNV-1a
+   for (uint32 i = 0; i < size; i++)
+   {
+      hash = (hash ^ data_ptr[i]) * 0x100000001B3ULL;
+   }
+   return hash;
+}
+
+static void lim_tst_set_tuning(limiter_lib_t *lib_ptr, int32 ch, int32 data_width)
+{
+   limiter_tuning_v2_t tuning;
+   int32               unity = (16 == data_width) ? 32767 : (1 << 27);
+
+   memset(&tuning, 0, sizeof(tuning));
+   tuning.ch_idx    = ch;
+   tuning.threshold = (int32)(((int64)unity * (1024 + (lim_tst_rand() % 31744))) >> 15); // ~ -30 dB to 0 dB
+
+   // Q8, 0 dB half of the time, else -12 dB to +12 dB
+   tuning.makeup_gain = (lim_tst_rand() % 2) ? 256 : (int32)(64 + (lim_tst_rand() % 960));
+
+   tuning.gc       = (0 == lim_tst_rand() % 3) ? 32440 : lim_tst_rand_q15();
+   tuning.max_wait = (int32)(lim_tst_rand() % 330);
+
+   // mostly short time constants, so the gain settles within a block
+   tuning.gain_attack  = (uint32)(((uint64)lim_tst_rand_q15() * lim_tst_rand_q15()) << 1);
+   tuning.gain_release = (uint32)(((((uint64)lim_tst_rand_q15() * lim_tst_rand_q15()) >> 15) * lim_tst_rand_q15()) << 1);
+   tuning.attack_coef  = (lim_tst_rand() % 2) ? 32768 : (1 + (lim_tst_rand() % (32768 * 4)));
+   tuning.release_coef = (lim_tst_rand() % 2) ? 32768 : (1 + (lim_tst_rand() % (32768 * 4)));
+
+   tuning.hard_threshold = tuning.threshold;
+   if (lim_tst_rand() % 2)
+   {
+      tuning.hard_threshold += (int32)(((int64)tuning.threshold * lim_tst_rand_q15()) >> 15);
+   }
+
+   limiter_set_param(lib_ptr, LIMITER_PARAM_TUNING_V2, &tuning, sizeof(tuning));
+}
+
+/* Runs one random configuration over a few random blocks and hashes the output */
+static uint64 lim_tst_run_config(uint32 config_idx, uint64 hash, FILE *dump_ptr)
+{
+   static const int32       sample_rates[] = { 8000, 16000, 44100, 48000, 96000 };
+   static int32             in_buf[LIM_TST_MAX_CHS][LIM_TST_MAX_BLOCK];
+   static int32             out_buf[LIM_TST_MAX_CHS][LIM_TST_MAX_BLOCK];
+   limiter_static_vars_v2_t static_vars;
+   limiter_mem_req_t        mem_req;
+   limiter_lib_t            lib;
+   void *                   mem_ptr;
+   int64                    full_scale;
+   int32                    max_in, delay_mode, num_blocks;
+   uint32                   phase = 0, phase_step, amp;
+
+   lim_tst_seed = (config_idx * 2654435761u) + 7;
+
+   static_vars.data_width     = (lim_tst_rand() % 2) ? 16 : 32;
+   static_vars.q_factor       = (16 == static_vars.data_width) ? 15 : ((lim_tst_rand() % 2) ? 27 : 31);
+   static_vars.sample_rate    = sample_rates[lim_tst_rand() % 5];
+   static_vars.max_block_size = 32 + (lim_tst_rand() % 1000);
+   static_vars.num_chs        = 1 + (lim_tst_rand() % LIM_TST_MAX_CHS);
+
+   // no delay, up to ~10 ms, or a short one (Q15 seconds)
+   delay_mode                 = lim_tst_rand() % 3;
+   static_vars.delay          = (0 == delay_mode) ? 0 : (int32)(lim_tst_rand() % ((1 == delay_mode) ? 330 : 40));
+   static_vars.history_winlen = (lim_tst_rand() % 2) ? 0 : (int32)(1 + (lim_tst_rand() % 1300));
+
+   if ((LIMITER_SUCCESS != limiter_get_mem_req_v2(&mem_req, &static_vars)) ||
+       (NULL == (mem_ptr = calloc(1, mem_req.mem_size + 64))))
+   {
+      return lim_tst_hash(hash, (const uint8 *)"memreq", 6);
+   }
+
+   if (LIMITER_SUCCESS != limiter_init_mem_v2(&lib, &static_vars, mem_ptr, mem_req.mem_size))
+   {
+      free(mem_ptr);
+      return lim_tst_hash(hash, (const uint8 *)"init", 4);
+   }
+
+   for (int32 ch = 0; ch < static_vars.num_chs; ch++)
+   {
+      lim_tst_set_tuning(&lib, ch, static_vars.data_width);
+   }
+
+   if (0 == lim_tst_rand() % 8)
+   {
+      int32 mode = MAKEUPGAIN_ONLY;
+      limiter_set_param(&lib, LIMITER_PARAM_MODE, &mode, sizeof(mode));
+   }
+
+   full_scale = (int64)1 << static_vars.q_factor;
+   max_in     = (16 == static_vars.data_width) ? MAX_16 : MAX_32;
+   amp        = (uint32)lim_tst_rand_q15() + (uint32)(lim_tst_rand_q15() >> 2); // up to ~1.25 full scale, Q15
+   phase_step = 4000000 + (lim_tst_rand() % 300000000);                        // ~ 50 Hz to 3 kHz at 48 kHz
+
+   num_blocks = 3 + (int32)(lim_tst_rand() % 20);
+   for (int32 b = 0; b < num_blocks; b++)
+   {
+      uint32 samples = 1 + (lim_tst_rand() % static_vars.max_block_size);
+      int32  kind    = (int32)(lim_tst_rand() % 5);
+      int32 *in_pptr[LIM_TST_MAX_CHS];
+      void * out_pptr[LIM_TST_MAX_CHS];
+
+      if (0 == lim_tst_rand() % 3)
+      {
+         samples = static_vars.max_block_size;
+      }
+      if (0 == lim_tst_rand() % 4)
+      {
+         amp        = (uint32)(((uint64)lim_tst_rand_q15() * lim_tst_rand_q15() * 3) >> 16);
+         phase_step = 1800000 + (lim_tst_rand() % 450000000);
+      }
+      if (0 == lim_tst_rand() % 10)
+      {
+         int32 bypass = (int32)(lim_tst_rand() % 2);
+         limiter_set_param(&lib, LIMITER_PARAM_BYPASS, &bypass, sizeof(bypass));
+      }
+
+      for (int32 ch = 0; ch < static_vars.num_chs; ch++)
+      {
+         uint32 ch_phase = phase + ((uint32)ch << 30);
+
+         for (uint32 k = 0; k < samples; k++)
+         {
+            int64 v;
+
+            if (0 == kind)
+            {
+               v = 0;
+            }
+            else if (1 == kind)
+            {
+               v = ((int64)amp * ((int32)lim_tst_rand_q15() * 2 - 32767)) >> 15;
+            }
+            else
+            {
+               v = ((int64)amp * lim_tst_sine(ch_phase)) >> 15;
+               ch_phase += phase_step;
+            }
+            if ((4 == kind) && (0 == lim_tst_rand() % 200))
+            {
+               v = (((int32)lim_tst_rand_q15() * 2 - 32767) * 3) >> 1; // click up to 1.5 full scale
+            }
+
+            v = (v * full_scale) >> 15;
+            v = (v > max_in) ? max_in : ((v < -(int64)max_in - 1) ? -(int64)max_in - 1 : v);
+            in_buf[ch][k] = (16 == static_vars.data_width) ? (int32)(int16)v : (int32)v;
+         }
+         in_pptr[ch]  = in_buf[ch];
+         out_pptr[ch] = out_buf[ch];
+      }
+      phase += samples * phase_step;
+
+      memset(out_buf, 0x5A, sizeof(out_buf));
+      limiter_process(&lib, out_pptr, in_pptr, samples);
+
+      for (int32 ch = 0; ch < static_vars.num_chs; ch++)
+      {
+         uint32 size = samples * (static_vars.data_width >> 3);
+
+         hash = lim_tst_hash(hash, (const uint8 *)out_buf[ch], size);
+         if (NULL != dump_ptr)
+         {
+            fwrite(out_buf[ch], 1, size, dump_ptr);
+         }
+      }
+   }
+
+   free(mem_ptr);
+   return hash;
+}
+
+int main(int argc, char *argv[])
+{
+   uint32 num_configs = LIM_TST_NUM_CONFIGS;
+   FILE * dump_ptr    = NULL;
+   uint64 hash        = 0xCBF29CE484222325ULL;
+
+   if (argc > 1)
+   {
+      num_configs = (uint32)strtoul(argv[1], NULL, 0);
+   }
+   if ((argc > 2) && (NULL == (dump_ptr = fopen(argv[2], "wb"))))
+   {
+      printf("Cannot open %s\n", argv[2]);
+      return 1;
+   }
+
+   for (uint32 i = 0; i < num_configs; i++)
+   {
+      hash = lim_tst_run_config(i, hash, dump_ptr);
+   }
+
+   if (NULL != dump_ptr)
+   {
+      fclose(dump_ptr);
+   }
+
+   printf("limiter output hash over %lu configurations: 0x%016llx\n", (unsigned long)num_configs, (unsigned long long)hash);
+   if (LIM_TST_NUM_CONFIGS != num_configs)
+   {
+      return 0;
+   }
+
+   printf("limiter bit-exactness test %s\n", (LIM_TST_EXPECTED_HASH == hash) ? "passed" : "FAILED");
+   return (LIM_TST_EXPECTED_HASH == hash) ? 0 : 1;
+}
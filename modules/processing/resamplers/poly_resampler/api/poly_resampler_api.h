@@ -0,0 +1,214 @@
+/*========================================================================*/
+/**
+@file poly_resampler_api.h
+
+@brief poly_resampler_api.h: This file contains the Module Id, Param IDs and configuration
+    structures exposed by the Polyphase Resampler Module.
+*/
+/*=======================================================================
+  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+  SPDX-License-Identifier: BSD-3-Clause-Clear
+=========================================================================*/
+
+#ifndef POLY_RESAMPLER_API_H
+#define POLY_RESAMPLER_API_H
+
+/*------------------------------------------------------------------------
+ * Include files
+ * -----------------------------------------------------------------------*/
+#include "module_cmn_api.h"
+#include "imcl_fwk_intent_api.h"
+
+/**
+    @h2xml_title1          {POLYPHASE RESAMPLER API}
+    @h2xml_title_agile_rev {POLYPHASE RESAMPLER API}
+    @h2xml_title_date      {October 17, 2026}
+ */
+
+/*==============================================================================
+   Constants
+==============================================================================*/
+/** @ingroup ar_spf_mod_poly_resam_macros
+    Size of the stack for the Polyphase Resampler module. */
+#define POLY_RS_STACK_SIZE 2048
+
+/** @ingroup ar_spf_mod_poly_resam_macros
+    Maximum ports for the Polyphase Resampler module. */
+#define POLY_RS_MAX_PORTS 1
+
+/** @ingroup ar_spf_mod_poly_resam_macros
+    ID of the Polyphase Resampler module.
+
+    This module converts between any two sampling rates from 1 kHz to 768 kHz with windowed-sinc
+    polyphase filters. The conversion ratio can be trimmed continuously, either manually or from the
+    drift reported on a timer drift control port, to keep a stream locked to another clock.
+
+    @subhead4{Supported parameter IDs}
+    - #PARAM_ID_POLY_RESAMPLER_OUT_CFG @lstsp1
+    - #PARAM_ID_POLY_RESAMPLER_CONFIG @lstsp1
+    - #PARAM_ID_POLY_RESAMPLER_RATIO_ADJUST
+
+    @subhead4{Supported input media format ID}
+    - Data Format          : FIXED_POINT @lstsp1
+    - fmt_id               : Don't care @lstsp1
+    - Sample Rates         : 1000 to 768000 (Hz) @lstsp1
+    - Number of channels   : 1 to 128 @lstsp1
+    - Channel type         : 0 to 128 @lstsp1
+    - Bits per sample      : 16, 32 @lstsp1
+    - Q format             : 15 for 16 bits; 27, 31 for 32 bits @lstsp1
+    - Interleaving         : de-interleaved unpacked @lstsp1
+    - Signed/unsigned      : Signed
+ */
+#define MODULE_ID_POLY_RESAMPLER 0x07001180
+/**
+    @h2xmlm_module                {"MODULE_ID_POLY_RESAMPLER",
+                                   MODULE_ID_POLY_RESAMPLER}
+    @h2xmlm_displayName           {"Polyphase Resampler"}
+    @h2xmlm_modSearchKeys         {resampler, Audio}
+    @h2xmlm_description           {ID of the Polyphase Resampler module.\n
+
+     - This module converts between any two sampling rates with windowed-sinc polyphase filters.
+     The conversion ratio follows the drift reported on the timer drift control port.\n
+     - This module supports the following parameter IDs\n
+     - #PARAM_ID_POLY_RESAMPLER_OUT_CFG\n
+     - #PARAM_ID_POLY_RESAMPLER_CONFIG\n
+     - #PARAM_ID_POLY_RESAMPLER_RATIO_ADJUST\n
+
+ *  - Supported Input Media Format: \n
+ *  - Data Format          : FIXED_POINT \n
+ *  - fmt_id               : Don't care\n
+ *  - Sample Rates         : 1000 to 768000 (Hz)\n
+ *  - Number of channels   : 1 to 128\n
+ *  - Channel type         : 0 to 128\n
+ *  - Bits per sample      : 16, 32\n
+ *  - Q format             : 15 for 16 bits; 27, 31 for 32 bits\n
+ *  - Interleaving         : de-interleaved unpacked\n
+ *  - Signed/unsigned      : Signed}
+
+    @h2xmlm_dataMaxInputPorts     {POLY_RS_MAX_PORTS}
+    @h2xmlm_dataInputPorts        {IN=2}
+    @h2xmlm_dataMaxOutputPorts    {POLY_RS_MAX_PORTS}
+    @h2xmlm_dataOutputPorts       {OUT=1}
+    @h2xmlm_ctrlDynamicPortIntent {"Timer drift info"=INTENT_ID_TIMER_DRIFT_INFO, maxPorts= 1}
+    @h2xmlm_supportedContTypes    {APM_CONTAINER_TYPE_SC, APM_CONTAINER_TYPE_GC}
+    @h2xmlm_isOffloadable         {true}
+    @h2xmlm_stackSize             {POLY_RS_STACK_SIZE}
+    @h2xmlm_ToolPolicy            {Calibration}
+
+    @{                   <-- Start of the Module -->
+*/
+/*------------------------------------------------------------------------
+ * Macros, Defines, Type declarations
+ * -----------------------------------------------------------------------*/
+
+/** @ingroup ar_spf_mod_poly_resam_macros
+    Output sample rate of the module. */
+#define PARAM_ID_POLY_RESAMPLER_OUT_CFG 0x08001BB0
+typedef struct param_id_poly_resampler_out_cfg_t param_id_poly_resampler_out_cfg_t;
+
+/** @h2xmlp_parameter   {"PARAM_ID_POLY_RESAMPLER_OUT_CFG", PARAM_ID_POLY_RESAMPLER_OUT_CFG}
+    @h2xmlp_description {Specifies the output sample rate.}
+    @h2xmlp_toolPolicy  {Calibration; RTC} */
+
+/** @ingroup ar_spf_mod_poly_resam_macros
+    Specifies the output sample rate. */
+
+#include "spf_begin_pack.h"
+struct param_id_poly_resampler_out_cfg_t
+{
+   int32_t sampling_rate;
+   /**< Specifies the output sample rate; 0 is invalid. */
+
+   /**< @h2xmle_description {Specifies the output sample rate. PARAM_VAL_NATIVE keeps the input
+                             sample rate; 0 is invalid.}
+        @h2xmle_range       {-2..768000}
+        @h2xmle_default     {-1} */
+}
+#include "spf_end_pack.h"
+;
+
+/** @ingroup ar_spf_mod_poly_resam_macros
+    Filter quality: 16 taps (~50 dB stop band, lowest delay). */
+#define POLY_RESAMPLER_QUALITY_LOW_LATENCY 0
+
+/** @ingroup ar_spf_mod_poly_resam_macros
+    Filter quality: 32 taps (~75 dB stop band). */
+#define POLY_RESAMPLER_QUALITY_STANDARD 1
+
+/** @ingroup ar_spf_mod_poly_resam_macros
+    Filter quality: 64 taps (~95 dB stop band). */
+#define POLY_RESAMPLER_QUALITY_HIGH 2
+
+/** @ingroup ar_spf_mod_poly_resam_macros
+    Filter quality and drift tracking. */
+#define PARAM_ID_POLY_RESAMPLER_CONFIG 0x08001BB1
+typedef struct param_id_poly_resampler_config_t param_id_poly_resampler_config_t;
+
+/** @h2xmlp_parameter   {"PARAM_ID_POLY_RESAMPLER_CONFIG", PARAM_ID_POLY_RESAMPLER_CONFIG}
+    @h2xmlp_description {Configures the filter quality and how the conversion ratio follows the drift
+                         reported on the timer drift control port.}
+    @h2xmlp_toolPolicy  {Calibration; RTC} */
+
+/** @ingroup ar_spf_mod_poly_resam_macros
+    Configures the filter quality and the drift tracking. */
+
+#include "spf_begin_pack.h"
+struct param_id_poly_resampler_config_t
+{
+   uint32_t quality;
+   /**< Filter quality. Downsampling lengthens the filter by the ratio. */
+
+   /**< @h2xmle_description {Filter quality. Downsampling lengthens the filter by the ratio.}
+        @h2xmle_rangeList   {"LOW_LATENCY"=0;
+                             "STANDARD"=1;
+                             "HIGH"=2}
+        @h2xmle_default     {1} */
+
+   uint32_t drift_settle_ms;
+   /**< Time over which an accumulated drift error is corrected. */
+
+   /**< @h2xmle_description {Time over which an accumulated drift error is corrected. Shorter values
+                             track faster at the cost of larger momentary ratio changes.}
+        @h2xmle_range       {10..60000}
+        @h2xmle_default     {1000} */
+
+   uint32_t max_adjust_ppm;
+   /**< Largest ratio trim applied for drift correction, in parts per million. */
+
+   /**< @h2xmle_description {Largest ratio trim applied for drift correction, in parts per million.}
+        @h2xmle_range       {0..10000}
+        @h2xmle_default     {1000} */
+}
+#include "spf_end_pack.h"
+;
+
+/** @ingroup ar_spf_mod_poly_resam_macros
+    Manual trim of the conversion ratio. */
+#define PARAM_ID_POLY_RESAMPLER_RATIO_ADJUST 0x08001BB2
+typedef struct param_id_poly_resampler_ratio_adjust_t param_id_poly_resampler_ratio_adjust_t;
+
+/** @h2xmlp_parameter   {"PARAM_ID_POLY_RESAMPLER_RATIO_ADJUST", PARAM_ID_POLY_RESAMPLER_RATIO_ADJUST}
+    @h2xmlp_description {Trims the conversion ratio. The trim adds to the drift correction. A get
+                         returns the total trim applied at the last process call.}
+    @h2xmlp_toolPolicy  {RTC} */
+
+/** @ingroup ar_spf_mod_poly_resam_macros
+    Trims the conversion ratio. */
+
+#include "spf_begin_pack.h"
+struct param_id_poly_resampler_ratio_adjust_t
+{
+   int32_t adjust_ppb;
+   /**< Ratio trim in parts per billion. A positive value consumes input faster, which produces
+        fewer output samples per input sample. */
+
+   /**< @h2xmle_description {Ratio trim in parts per billion. A positive value consumes input faster,
+                             which produces fewer output samples per input sample.}
+        @h2xmle_range       {-10000000..10000000}
+        @h2xmle_default     {0} */
+}
+#include "spf_end_pack.h"
+;
+
+/** @}                   <-- End of the Module -->*/
+#endif /* POLY_RESAMPLER_API_H */
@@ -0,0 +1,43 @@
+/* ======================================================================== */
+/**
+@file capi_poly_resampler.h
+
+   Header file to implement the Common Audio Processor Interface
+   for the Polyphase Resampler module
+*/
+
+/* =========================================================================
+  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+  SPDX-License-Identifier: BSD-3-Clause-Clear
+  ========================================================================== */
+
+/*------------------------------------------------------------------------
+ * Include files
+ * -----------------------------------------------------------------------*/
+#ifndef CAPI_POLY_RESAMPLER_H
+#define CAPI_POLY_RESAMPLER_H
+
+#include "capi.h"
+#include "ar_defs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+* Get static properties of the Polyphase Resampler module such as
+* memory, stack requirements etc.
+*/
+capi_err_t capi_poly_resampler_get_static_properties(capi_proplist_t *init_set_properties,
+                                                     capi_proplist_t *static_properties);
+
+/**
+* Instantiates(and allocates) the module memory.
+*/
+capi_err_t capi_poly_resampler_init(capi_t *_pif, capi_proplist_t *init_set_properties);
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif // CAPI_POLY_RESAMPLER_H
@@ -0,0 +1,326 @@
+/* =========================================================================
+  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+  SPDX-License-Identifier: BSD-3-Clause-Clear
+ * =========================================================================*/
+
+/**
+ * @file capi_poly_resampler.c
+ *
+ * C source file to implement the Polyphase Resampler module
+ */
+
+#include "capi_poly_resampler_i.h"
+
+static capi_err_t capi_poly_resampler_process(capi_t *_pif, capi_stream_data_t *input[], capi_stream_data_t *output[]);
+
+static capi_err_t capi_poly_resampler_end(capi_t *_pif);
+
+static capi_err_t capi_poly_resampler_set_param(capi_t *                _pif,
+                                                uint32_t                param_id,
+                                                const capi_port_info_t *port_info_ptr,
+                                                capi_buf_t *            params_ptr);
+
+static capi_err_t capi_poly_resampler_get_param(capi_t *                _pif,
+                                                uint32_t                param_id,
+                                                const capi_port_info_t *port_info_ptr,
+                                                capi_buf_t *            params_ptr);
+
+static capi_err_t capi_poly_resampler_set_properties(capi_t *_pif, capi_proplist_t *props_ptr);
+
+static capi_err_t capi_poly_resampler_get_properties(capi_t *_pif, capi_proplist_t *props_ptr);
+
+static capi_vtbl_t vtbl = { capi_poly_resampler_process,        capi_poly_resampler_end,
+                            capi_poly_resampler_set_param,      capi_poly_resampler_get_param,
+                            capi_poly_resampler_set_properties, capi_poly_resampler_get_properties };
+
+/* -------------------------------------------------------------------------
+ * Function name: capi_poly_resampler_get_static_properties
+ * Function to get the static properties of the Polyphase Resampler module
+ * -------------------------------------------------------------------------*/
+capi_err_t capi_poly_resampler_get_static_properties(capi_proplist_t *init_set_properties,
+                                                     capi_proplist_t *static_properties)
+{
+   capi_err_t capi_result = CAPI_EOK;
+
+   if (NULL != static_properties)
+   {
+      capi_result = capi_poly_resampler_process_get_properties((capi_poly_resampler_t *)NULL, static_properties);
+      if (CAPI_FAILED(capi_result))
+      {
+         POLY_RS_MSG(POLY_RS_MIID_UNKNOWN, DBG_ERROR_PRIO, "get static properties failed!");
+         return capi_result;
+      }
+   }
+   else
+   {
+      POLY_RS_MSG(POLY_RS_MIID_UNKNOWN, DBG_ERROR_PRIO, "Get static properties received bad pointer");
+   }
+
+   return capi_result;
+}
+
+/*------------------------------------------------------------------------
+  Function name: capi_poly_resampler_init
+  Initializes the Polyphase Resampler module. The library is created once the
+  input media format is known.
+ * -----------------------------------------------------------------------*/
+capi_err_t capi_poly_resampler_init(capi_t *_pif, capi_proplist_t *init_set_properties)
+{
+   capi_err_t capi_result = CAPI_EOK;
+
+   if ((NULL == _pif) || (NULL == init_set_properties))
+   {
+      POLY_RS_MSG(POLY_RS_MIID_UNKNOWN, DBG_ERROR_PRIO, "Init received bad pointer, 0x%p, 0x%p", _pif, init_set_properties);
+      return CAPI_EBADPARAM;
+   }
+
+   capi_poly_resampler_t *me_ptr = (capi_poly_resampler_t *)_pif;
+
+   memset(me_ptr, 0, sizeof(capi_poly_resampler_t));
+   me_ptr->vtbl.vtbl_ptr = &vtbl;
+
+   capi_cmn_init_media_fmt_v2(&me_ptr->in_media_fmt);
+   capi_cmn_init_media_fmt_v2(&me_ptr->out_media_fmt);
+   capi_cmn_ctrl_port_list_init(&me_ptr->ctrl_port_list);
+   capi_poly_resampler_init_config(me_ptr);
+
+   capi_result = capi_poly_resampler_process_set_properties(me_ptr, init_set_properties);
+   // ignore unsupported error
+   if (CAPI_FAILED(capi_result) && (CAPI_EUNSUPPORTED != capi_result))
+   {
+      POLY_RS_MSG(me_ptr->miid, DBG_ERROR_PRIO, "Initialization Set Property Failed");
+      return capi_result;
+   }
+   capi_result = CAPI_EOK;
+
+   capi_result |= capi_poly_resampler_raise_events(me_ptr);
+   capi_result |= capi_cmn_raise_deinterleaved_unpacked_v2_supported_event(&me_ptr->cb_info);
+
+   POLY_RS_MSG(me_ptr->miid, DBG_HIGH_PRIO, "Initialization completed");
+   return capi_result;
+}
+
+/* -------------------------------------------------------------------------
+ * Function name: capi_poly_resampler_process
+ * Resamples the input buffer into the output buffer, following the drift
+ * reported on the control port.
+ * -------------------------------------------------------------------------*/
+static capi_err_t capi_poly_resampler_process(capi_t *_pif, capi_stream_data_t *input[], capi_stream_data_t *output[])
+{
+   capi_poly_resampler_t *me_ptr = (capi_poly_resampler_t *)_pif;
+   POSAL_ASSERT(me_ptr);
+   POSAL_ASSERT(input[0]);
+   POSAL_ASSERT(output[0]);
+
+   return capi_poly_resampler_process_data(me_ptr, input, output);
+}
+
+/*------------------------------------------------------------------------
+ * Function name: capi_poly_resampler_end
+ * Returns the module to the uninitialized state and frees the library
+ * and control port memory.
+ * -----------------------------------------------------------------------*/
+static capi_err_t capi_poly_resampler_end(capi_t *_pif)
+{
+   if (NULL == _pif)
+   {
+      POLY_RS_MSG(POLY_RS_MIID_UNKNOWN, DBG_ERROR_PRIO, "End received bad pointer, 0x%p", _pif);
+      return CAPI_EBADPARAM;
+   }
+
+   capi_poly_resampler_t *me_ptr = (capi_poly_resampler_t *)_pif;
+
+   capi_poly_resampler_destroy_lib(me_ptr);
+   capi_cmn_ctrl_port_list_deinit(&me_ptr->ctrl_port_list);
+   me_ptr->vtbl.vtbl_ptr = NULL;
+
+   POLY_RS_MSG(me_ptr->miid, DBG_HIGH_PRIO, "End done");
+   return CAPI_EOK;
+}
+
+/* -------------------------------------------------------------------------
+ * Function name: capi_poly_resampler_set_param
+ * Sets a parameter of the module. In the event of a failure, the
+ * appropriate error code is returned.
+ * -------------------------------------------------------------------------*/
+static capi_err_t capi_poly_resampler_set_param(capi_t *                _pif,
+                                                uint32_t                param_id,
+                                                const capi_port_info_t *port_info_ptr,
+                                                capi_buf_t *            params_ptr)
+{
+   capi_err_t capi_result = CAPI_EOK;
+
+   if ((NULL == _pif) || (NULL == params_ptr) || (NULL == params_ptr->data_ptr))
+   {
+      POLY_RS_MSG(POLY_RS_MIID_UNKNOWN, DBG_ERROR_PRIO, "Set param received bad pointer");
+      return CAPI_EBADPARAM;
+   }
+
+   capi_poly_resampler_t *me_ptr = (capi_poly_resampler_t *)_pif;
+
+   switch (param_id)
+   {
+      case PARAM_ID_POLY_RESAMPLER_OUT_CFG:
+      {
+         if (params_ptr->actual_data_len < sizeof(param_id_poly_resampler_out_cfg_t))
+         {
+            POLY_RS_MSG(me_ptr->miid, DBG_ERROR_PRIO, "Set out cfg, bad param size %lu", params_ptr->actual_data_len);
+            return CAPI_ENEEDMORE;
+         }
+
+         param_id_poly_resampler_out_cfg_t *cfg_ptr = (param_id_poly_resampler_out_cfg_t *)params_ptr->data_ptr;
+         if ((PARAM_VAL_NATIVE != cfg_ptr->sampling_rate) && (PARAM_VAL_UNSET != cfg_ptr->sampling_rate) &&
+             ((cfg_ptr->sampling_rate < POLY_RS_MIN_SAMPLE_RATE) || (cfg_ptr->sampling_rate > POLY_RS_MAX_SAMPLE_RATE)))
+         {
+            POLY_RS_MSG(me_ptr->miid, DBG_ERROR_PRIO, "Set out cfg, unsupported sample rate %ld", cfg_ptr->sampling_rate);
+            return CAPI_EBADPARAM;
+         }
+
+         if (PARAM_VAL_UNSET != cfg_ptr->sampling_rate)
+         {
+            me_ptr->out_cfg_sample_rate = cfg_ptr->sampling_rate;
+         }
+         POLY_RS_MSG(me_ptr->miid, DBG_HIGH_PRIO, "Set out cfg, sample rate %ld", cfg_ptr->sampling_rate);
+
+         capi_result = capi_poly_resampler_create_lib(me_ptr);
+         break;
+      }
+      case PARAM_ID_POLY_RESAMPLER_CONFIG:
+      {
+         if (params_ptr->actual_data_len < sizeof(param_id_poly_resampler_config_t))
+         {
+            POLY_RS_MSG(me_ptr->miid, DBG_ERROR_PRIO, "Set config, bad param size %lu", params_ptr->actual_data_len);
+            return CAPI_ENEEDMORE;
+         }
+
+         param_id_poly_resampler_config_t *cfg_ptr = (param_id_poly_resampler_config_t *)params_ptr->data_ptr;
+         if ((cfg_ptr->quality >= POLY_RS_QUALITY_MAX) || (cfg_ptr->drift_settle_ms < 10) ||
+             (cfg_ptr->drift_settle_ms > 60000) || (cfg_ptr->max_adjust_ppm > (POLY_RS_MAX_ADJUST_PPB / 1000)))
+         {
+            POLY_RS_MSG(me_ptr->miid,
+                        DBG_ERROR_PRIO,
+                        "Set config, invalid quality %lu, settle %lu ms or max adjust %lu ppm",
+                        cfg_ptr->quality,
+                        cfg_ptr->drift_settle_ms,
+                        cfg_ptr->max_adjust_ppm);
+            return CAPI_EBADPARAM;
+         }
+
+         bool_t is_quality_changed = (cfg_ptr->quality != me_ptr->config.quality);
+         me_ptr->config            = *cfg_ptr;
+
+         if (is_quality_changed)
+         {
+            capi_result = capi_poly_resampler_create_lib(me_ptr);
+         }
+         break;
+      }
+      case PARAM_ID_POLY_RESAMPLER_RATIO_ADJUST:
+      {
+         if (params_ptr->actual_data_len < sizeof(param_id_poly_resampler_ratio_adjust_t))
+         {
+            POLY_RS_MSG(me_ptr->miid, DBG_ERROR_PRIO, "Set ratio adjust, bad param size %lu", params_ptr->actual_data_len);
+            return CAPI_ENEEDMORE;
+         }
+
+         param_id_poly_resampler_ratio_adjust_t *cfg_ptr = (param_id_poly_resampler_ratio_adjust_t *)params_ptr->data_ptr;
+         if ((cfg_ptr->adjust_ppb > POLY_RS_MAX_ADJUST_PPB) || (cfg_ptr->adjust_ppb < -POLY_RS_MAX_ADJUST_PPB))
+         {
+            POLY_RS_MSG(me_ptr->miid, DBG_ERROR_PRIO, "Set ratio adjust, %ld ppb out of range", cfg_ptr->adjust_ppb);
+            return CAPI_EBADPARAM;
+         }
+
+         me_ptr->manual_adjust_ppb = cfg_ptr->adjust_ppb;
+         capi_result               = capi_poly_resampler_raise_process_event(me_ptr);
+         break;
+      }
+      case INTF_EXTN_PARAM_ID_IMCL_PORT_OPERATION:
+      {
+         capi_result = capi_poly_resampler_handle_ctrl_port_op(me_ptr, params_ptr);
+         break;
+      }
+      case INTF_EXTN_PARAM_ID_IMCL_INCOMING_DATA:
+      {
+         capi_result = capi_poly_resampler_handle_imcl_data(me_ptr, params_ptr);
+         break;
+      }
+      default:
+      {
+         POLY_RS_MSG(me_ptr->miid, DBG_ERROR_PRIO, "Set, unsupported param ID 0x%lx", param_id);
+         capi_result = CAPI_EUNSUPPORTED;
+         break;
+      }
+   }
+
+   return capi_result;
+}
+
+/* -------------------------------------------------------------------------
+ * Function name: capi_poly_resampler_get_param
+ * Gets a parameter of the module. In the event of a failure, the
+ * appropriate error code is returned.
+ * -------------------------------------------------------------------------*/
+static capi_err_t capi_poly_resampler_get_param(capi_t *                _pif,
+                                                uint32_t                param_id,
+                                                const capi_port_info_t *port_info_ptr,
+                                                capi_buf_t *            params_ptr)
+{
+   if ((NULL == _pif) || (NULL == params_ptr) || (NULL == params_ptr->data_ptr))
+   {
+      POLY_RS_MSG(POLY_RS_MIID_UNKNOWN, DBG_ERROR_PRIO, "Get param received bad pointer");
+      return CAPI_EBADPARAM;
+   }
+
+   capi_poly_resampler_t *me_ptr = (capi_poly_resampler_t *)_pif;
+
+   switch (param_id)
+   {
+      case PARAM_ID_POLY_RESAMPLER_OUT_CFG:
+      {
+         if (params_ptr->max_data_len < sizeof(param_id_poly_resampler_out_cfg_t))
+         {
+            return CAPI_ENEEDMORE;
+         }
+         ((param_id_poly_resampler_out_cfg_t *)params_ptr->data_ptr)->sampling_rate = me_ptr->out_cfg_sample_rate;
+         params_ptr->actual_data_len = sizeof(param_id_poly_resampler_out_cfg_t);
+         break;
+      }
+      case PARAM_ID_POLY_RESAMPLER_CONFIG:
+      {
+         if (params_ptr->max_data_len < sizeof(param_id_poly_resampler_config_t))
+         {
+            return CAPI_ENEEDMORE;
+         }
+         *((param_id_poly_resampler_config_t *)params_ptr->data_ptr) = me_ptr->config;
+         params_ptr->actual_data_len                                 = sizeof(param_id_poly_resampler_config_t);
+         break;
+      }
+      case PARAM_ID_POLY_RESAMPLER_RATIO_ADJUST:
+      {
+         if (params_ptr->max_data_len < sizeof(param_id_poly_resampler_ratio_adjust_t))
+         {
+            return CAPI_ENEEDMORE;
+         }
+         ((param_id_poly_resampler_ratio_adjust_t *)params_ptr->data_ptr)->adjust_ppb = me_ptr->applied_adjust_ppb;
+         params_ptr->actual_data_len = sizeof(param_id_poly_resampler_ratio_adjust_t);
+         break;
+      }
+      default:
+      {
+         POLY_RS_MSG(me_ptr->miid, DBG_ERROR_PRIO, "Get, unsupported param ID 0x%lx", param_id);
+         return CAPI_EUNSUPPORTED;
+      }
+   }
+
+   return CAPI_EOK;
+}
+
+static capi_err_t capi_poly_resampler_set_properties(capi_t *_pif, capi_proplist_t *props_ptr)
+{
+   return capi_poly_resampler_process_set_properties((capi_poly_resampler_t *)_pif, props_ptr);
+}
+
+static capi_err_t capi_poly_resampler_get_properties(capi_t *_pif, capi_proplist_t *props_ptr)
+{
+   return capi_poly_resampler_process_get_properties((capi_poly_resampler_t *)_pif, props_ptr);
+}
@@ -0,0 +1,120 @@
+/* ======================================================================== */
+/**
+@file capi_poly_resampler_i.h
+
+   Internal header of the Polyphase Resampler CAPI
+*/
+
+/* =========================================================================
+  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+  SPDX-License-Identifier: BSD-3-Clause-Clear
+  ========================================================================== */
+
+#ifndef CAPI_POLY_RESAMPLER_I_H
+#define CAPI_POLY_RESAMPLER_I_H
+
+/*------------------------------------------------------------------------
+ * Include files
+ * -----------------------------------------------------------------------*/
+#include "poly_resampler_api.h"
+#include "capi_poly_resampler.h"
+#include "poly_rs_lib.h"
+#include "capi_cmn.h"
+#include "capi_cmn_ctrl_port_list.h"
+#include "imcl_timer_drift_info_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/*------------------------------------------------------------------------
+ * Macros
+ * -----------------------------------------------------------------------*/
+#define POLY_RS_MIID_UNKNOWN 0
+#define POLY_RS_MSG_PREFIX "CAPI POLY_RS:[%lX] "
+#define POLY_RS_MSG(ID, xx_ss_mask, xx_fmt, ...) AR_MSG(xx_ss_mask, POLY_RS_MSG_PREFIX xx_fmt, ID, ##__VA_ARGS__)
+
+#define POLY_RS_DEFAULT_DRIFT_SETTLE_MS 1000
+#define POLY_RS_DEFAULT_MAX_ADJUST_PPM 1000
+
+/*------------------------------------------------------------------------
+ * Structure definitions
+ * -----------------------------------------------------------------------*/
+typedef struct capi_poly_rs_events_config_t
+{
+   uint32_t enable;
+   uint32_t kpps;
+   uint32_t delay_in_us;
+} capi_poly_rs_events_config_t;
+
+/*
+  Drift tracking state. The accumulated drift reported on the control port is turned into input time
+  to skip (positive) or repeat (negative); the ratio trim is steered so that the skipped input time
+  follows it over drift_settle_ms.
+*/
+typedef struct capi_poly_rs_drift_t
+{
+   uint32_t        ctrl_port_id;
+   imcl_tdi_hdl_t *tdi_hdl_ptr;        /**< Set by the drift source, NULL until then */
+   bool_t          is_baseline_valid;
+   int64_t         baseline_drift_us;  /**< Accumulated drift at the start of tracking */
+   int64_t         skipped_ns_x_rate;  /**< Input time skipped so far, in ns times the output rate */
+   int32_t         adjust_ppb;         /**< Current drift correction */
+} capi_poly_rs_drift_t;
+
+typedef struct capi_poly_resampler_t
+{
+   capi_t                           vtbl;
+   capi_event_callback_info_t       cb_info;
+   capi_heap_id_t                   heap_info;
+   uint32_t                         miid;
+
+   capi_media_fmt_v2_t              in_media_fmt;
+   capi_media_fmt_v2_t              out_media_fmt;
+   int32_t                          out_cfg_sample_rate; /**< PARAM_VAL_NATIVE follows the input */
+   param_id_poly_resampler_config_t config;
+   int32_t                          manual_adjust_ppb;
+   int32_t                          applied_adjust_ppb;
+
+   poly_rs_lib_t *                  lib_ptr;
+   void *                           lib_mem_ptr;
+
+   ctrl_port_list_handle_t          ctrl_port_list;
+   capi_poly_rs_drift_t             drift;
+
+   capi_poly_rs_events_config_t     events_config;
+
+   int8_t *                         in_pptr[CAPI_MAX_CHANNELS_V2];
+   int8_t *                         out_pptr[CAPI_MAX_CHANNELS_V2];
+} capi_poly_resampler_t;
+
+/*------------------------------------------------------------------------
+ * Function declarations
+ * -----------------------------------------------------------------------*/
+void capi_poly_resampler_init_config(capi_poly_resampler_t *me_ptr);
+
+capi_err_t capi_poly_resampler_process_set_properties(capi_poly_resampler_t *me_ptr, capi_proplist_t *proplist_ptr);
+
+capi_err_t capi_poly_resampler_process_get_properties(capi_poly_resampler_t *me_ptr, capi_proplist_t *proplist_ptr);
+
+capi_err_t capi_poly_resampler_create_lib(capi_poly_resampler_t *me_ptr);
+
+void capi_poly_resampler_destroy_lib(capi_poly_resampler_t *me_ptr);
+
+capi_err_t capi_poly_resampler_raise_events(capi_poly_resampler_t *me_ptr);
+
+capi_err_t capi_poly_resampler_raise_process_event(capi_poly_resampler_t *me_ptr);
+
+capi_err_t capi_poly_resampler_handle_ctrl_port_op(capi_poly_resampler_t *me_ptr, capi_buf_t *params_ptr);
+
+capi_err_t capi_poly_resampler_handle_imcl_data(capi_poly_resampler_t *me_ptr, capi_buf_t *params_ptr);
+
+capi_err_t capi_poly_resampler_process_data(capi_poly_resampler_t *me_ptr,
+                                            capi_stream_data_t *   input[],
+                                            capi_stream_data_t *   output[]);
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif // CAPI_POLY_RESAMPLER_I_H
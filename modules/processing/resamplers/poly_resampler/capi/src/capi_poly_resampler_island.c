@@ -0,0 +1,103 @@
+/* =========================================================================
+  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+  SPDX-License-Identifier: BSD-3-Clause-Clear
+ * =========================================================================*/
+
+/**
+ * @file capi_poly_resampler_island.c
+ *
+ * Process path of the Polyphase Resampler module
+ */
+
+#include "capi_poly_resampler_i.h"
+
+/*
+  The drift source reports how far the local timer ran ahead of its clock. The module assumes its
+  input is paced by the local timer and its output by the drift source, so a positive drift is
+  corrected by skipping that much input time, i.e. by a positive ratio trim.
+*/
+static int32_t capi_poly_resampler_get_drift_adjust(capi_poly_resampler_t *me_ptr, uint32_t out_sample_rate)
+{
+   capi_poly_rs_drift_t *drift_ptr = &me_ptr->drift;
+   imcl_tdi_acc_drift_t  acc_drift;
+   int64_t               err_ns_x_rate, adjust_ppb, max_ppb;
+
+   if ((NULL == drift_ptr->tdi_hdl_ptr) || (NULL == drift_ptr->tdi_hdl_ptr->get_drift_fn_ptr) ||
+       (AR_EOK != drift_ptr->tdi_hdl_ptr->get_drift_fn_ptr(drift_ptr->tdi_hdl_ptr, &acc_drift)))
+   {
+      return 0;
+   }
+
+   if (!drift_ptr->is_baseline_valid)
+   {
+      drift_ptr->baseline_drift_us = acc_drift.acc_drift_us;
+      drift_ptr->skipped_ns_x_rate = 0;
+      drift_ptr->is_baseline_valid = TRUE;
+   }
+
+   err_ns_x_rate =
+      ((acc_drift.acc_drift_us - drift_ptr->baseline_drift_us) * 1000 * (int64_t)out_sample_rate) - drift_ptr->skipped_ns_x_rate;
+
+   /* spread the error over the settle time: ns / ms is ppm, times 1000 for ppb */
+   adjust_ppb = ((err_ns_x_rate / out_sample_rate) * 1000) / me_ptr->config.drift_settle_ms;
+   max_ppb    = (int64_t)me_ptr->config.max_adjust_ppm * 1000;
+   adjust_ppb = (adjust_ppb > max_ppb) ? max_ppb : ((adjust_ppb < -max_ppb) ? -max_ppb : adjust_ppb);
+
+   drift_ptr->adjust_ppb = (int32_t)adjust_ppb;
+   return drift_ptr->adjust_ppb;
+}
+
+static void capi_poly_resampler_update_ratio_adjust(capi_poly_resampler_t *me_ptr)
+{
+   int64_t adjust_ppb =
+      (int64_t)me_ptr->manual_adjust_ppb + capi_poly_resampler_get_drift_adjust(me_ptr, me_ptr->lib_ptr->cfg.out_sample_rate);
+
+   adjust_ppb = (adjust_ppb > POLY_RS_MAX_ADJUST_PPB) ? POLY_RS_MAX_ADJUST_PPB
+                                                      : ((adjust_ppb < -POLY_RS_MAX_ADJUST_PPB) ? -POLY_RS_MAX_ADJUST_PPB
+                                                                                                 : adjust_ppb);
+
+   if ((int32_t)adjust_ppb != me_ptr->applied_adjust_ppb)
+   {
+      if (AR_EOK == poly_rs_lib_set_ratio_adjust(me_ptr->lib_ptr, (int32_t)adjust_ppb))
+      {
+         me_ptr->applied_adjust_ppb = (int32_t)adjust_ppb;
+      }
+   }
+}
+
+capi_err_t capi_poly_resampler_process_data(capi_poly_resampler_t *me_ptr,
+                                            capi_stream_data_t *   input[],
+                                            capi_stream_data_t *   output[])
+{
+   uint32_t bytes_shift = (16 == me_ptr->in_media_fmt.format.bits_per_sample) ? 1 : 2;
+   uint32_t num_in, num_out;
+
+   if (NULL == me_ptr->lib_ptr)
+   {
+      POLY_RS_MSG(me_ptr->miid, DBG_ERROR_PRIO, "Process called without a valid media format");
+      return CAPI_EFAILED;
+   }
+
+   for (uint32_t ch = 0; ch < me_ptr->lib_ptr->cfg.num_channels; ch++)
+   {
+      me_ptr->in_pptr[ch]  = input[0]->buf_ptr[ch].data_ptr;
+      me_ptr->out_pptr[ch] = output[0]->buf_ptr[ch].data_ptr;
+   }
+   num_in  = input[0]->buf_ptr[0].actual_data_len >> bytes_shift;
+   num_out = output[0]->buf_ptr[0].max_data_len >> bytes_shift;
+
+   capi_poly_resampler_update_ratio_adjust(me_ptr);
+
+   poly_rs_lib_process(me_ptr->lib_ptr, me_ptr->in_pptr, &num_in, me_ptr->out_pptr, &num_out);
+
+   if (NULL != me_ptr->drift.tdi_hdl_ptr)
+   {
+      me_ptr->drift.skipped_ns_x_rate += (int64_t)num_out * (me_ptr->applied_adjust_ppb - me_ptr->manual_adjust_ppb);
+   }
+
+   // only the first channel lengths are used for CAPI_DEINTERLEAVED_UNPACKED_V2
+   input[0]->buf_ptr[0].actual_data_len  = num_in << bytes_shift;
+   output[0]->buf_ptr[0].actual_data_len = num_out << bytes_shift;
+
+   return CAPI_EOK;
+}
@@ -0,0 +1,482 @@
+/* =========================================================================
+  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+  SPDX-License-Identifier: BSD-3-Clause-Clear
+ * =========================================================================*/
+
+/**
+ * @file capi_poly_resampler_utils.c
+ *
+ * Media format, event and control port handling of the Polyphase Resampler module
+ */
+
+#include "capi_poly_resampler_i.h"
+
+static bool_t capi_poly_resampler_is_supported_media_type(capi_poly_resampler_t *me_ptr, const capi_media_fmt_v2_t *format_ptr)
+{
+   if (CAPI_FIXED_POINT != format_ptr->header.format_header.data_format)
+   {
+      POLY_RS_MSG(me_ptr->miid,
+                  DBG_ERROR_PRIO,
+                  "Unsupported data format %lu",
+                  (uint32_t)format_ptr->header.format_header.data_format);
+      return FALSE;
+   }
+
+   if (!(((16 == format_ptr->format.bits_per_sample) && (PCM_Q_FACTOR_15 == format_ptr->format.q_factor)) ||
+         ((32 == format_ptr->format.bits_per_sample) && ((PCM_Q_FACTOR_27 == format_ptr->format.q_factor) ||
+                                                         (PCM_Q_FACTOR_31 == format_ptr->format.q_factor)))))
+   {
+      POLY_RS_MSG(me_ptr->miid,
+                  DBG_ERROR_PRIO,
+                  "Unsupported bits per sample %lu, q factor %lu",
+                  format_ptr->format.bits_per_sample,
+                  format_ptr->format.q_factor);
+      return FALSE;
+   }
+
+   if ((CAPI_DEINTERLEAVED_UNPACKED_V2 != format_ptr->format.data_interleaving) &&
+       (1 != format_ptr->format.num_channels))
+   {
+      POLY_RS_MSG(me_ptr->miid, DBG_ERROR_PRIO, "Only de-interleaved unpacked data is supported");
+      return FALSE;
+   }
+
+   if (!format_ptr->format.data_is_signed)
+   {
+      POLY_RS_MSG(me_ptr->miid, DBG_ERROR_PRIO, "Unsigned data is not supported");
+      return FALSE;
+   }
+
+   if ((0 == format_ptr->format.num_channels) || (format_ptr->format.num_channels > CAPI_MAX_CHANNELS_V2) ||
+       (format_ptr->format.sampling_rate < POLY_RS_MIN_SAMPLE_RATE) ||
+       (format_ptr->format.sampling_rate > POLY_RS_MAX_SAMPLE_RATE))
+   {
+      POLY_RS_MSG(me_ptr->miid,
+                  DBG_ERROR_PRIO,
+                  "Unsupported channels %lu or sample rate %lu",
+                  format_ptr->format.num_channels,
+                  format_ptr->format.sampling_rate);
+      return FALSE;
+   }
+
+   return TRUE;
+}
+
+static uint32_t capi_poly_resampler_get_out_sample_rate(capi_poly_resampler_t *me_ptr)
+{
+   return (me_ptr->out_cfg_sample_rate > 0) ? (uint32_t)me_ptr->out_cfg_sample_rate
+                                            : me_ptr->in_media_fmt.format.sampling_rate;
+}
+
+static bool_t capi_poly_resampler_is_drift_port_connected(capi_poly_resampler_t *me_ptr)
+{
+   return (NULL != me_ptr->drift.tdi_hdl_ptr);
+}
+
+void capi_poly_resampler_init_config(capi_poly_resampler_t *me_ptr)
+{
+   me_ptr->out_cfg_sample_rate    = PARAM_VAL_NATIVE;
+   me_ptr->config.quality         = POLY_RS_QUALITY_STANDARD;
+   me_ptr->config.drift_settle_ms = POLY_RS_DEFAULT_DRIFT_SETTLE_MS;
+   me_ptr->config.max_adjust_ppm  = POLY_RS_DEFAULT_MAX_ADJUST_PPM;
+   me_ptr->events_config.enable   = TRUE;
+}
+
+void capi_poly_resampler_destroy_lib(capi_poly_resampler_t *me_ptr)
+{
+   if (NULL != me_ptr->lib_mem_ptr)
+   {
+      posal_memory_free(me_ptr->lib_mem_ptr);
+   }
+   me_ptr->lib_mem_ptr        = NULL;
+   me_ptr->lib_ptr            = NULL;
+   me_ptr->applied_adjust_ppb = 0;
+}
+
+/*
+  (Re)creates the library for the current input media format, output rate and quality. The ratio
+  may be trimmed at any time, so the interpolated table is always built. Raises the output media
+  format and the dependent events.
+*/
+capi_err_t capi_poly_resampler_create_lib(capi_poly_resampler_t *me_ptr)
+{
+   capi_err_t       capi_result = CAPI_EOK;
+   poly_rs_config_t cfg;
+   uint32_t         mem_size = 0;
+
+   if (CAPI_DATA_FORMAT_INVALID_VAL == me_ptr->in_media_fmt.format.sampling_rate)
+   {
+      return CAPI_EOK;
+   }
+
+   capi_poly_resampler_destroy_lib(me_ptr);
+
+   cfg.in_sample_rate     = me_ptr->in_media_fmt.format.sampling_rate;
+   cfg.out_sample_rate    = capi_poly_resampler_get_out_sample_rate(me_ptr);
+   cfg.num_channels       = me_ptr->in_media_fmt.format.num_channels;
+   cfg.bits_per_sample    = me_ptr->in_media_fmt.format.bits_per_sample;
+   cfg.q_factor           = me_ptr->in_media_fmt.format.q_factor;
+   cfg.quality            = me_ptr->config.quality;
+   cfg.allow_ratio_adjust = TRUE;
+
+   if (AR_EOK != poly_rs_lib_get_mem_req(&cfg, &mem_size))
+   {
+      POLY_RS_MSG(me_ptr->miid, DBG_ERROR_PRIO, "Unsupported conversion %lu -> %lu Hz", cfg.in_sample_rate, cfg.out_sample_rate);
+      return CAPI_EUNSUPPORTED;
+   }
+
+   me_ptr->lib_mem_ptr = posal_memory_malloc(mem_size, (POSAL_HEAP_ID)me_ptr->heap_info.heap_id);
+   if (NULL == me_ptr->lib_mem_ptr)
+   {
+      POLY_RS_MSG(me_ptr->miid, DBG_ERROR_PRIO, "Failed to allocate %lu bytes for the library", mem_size);
+      return CAPI_ENOMEMORY;
+   }
+
+   if (AR_EOK != poly_rs_lib_init(&cfg, me_ptr->lib_mem_ptr, mem_size, &me_ptr->lib_ptr))
+   {
+      capi_poly_resampler_destroy_lib(me_ptr);
+      return CAPI_EFAILED;
+   }
+
+   POLY_RS_MSG(me_ptr->miid,
+               DBG_HIGH_PRIO,
+               "Library created, %lu -> %lu Hz, %lu ch, quality %lu, %lu bytes",
+               cfg.in_sample_rate,
+               cfg.out_sample_rate,
+               cfg.num_channels,
+               cfg.quality,
+               mem_size);
+
+   me_ptr->out_media_fmt                      = me_ptr->in_media_fmt;
+   me_ptr->out_media_fmt.format.sampling_rate = cfg.out_sample_rate;
+
+   capi_result |= capi_poly_resampler_raise_events(me_ptr);
+   capi_result |= capi_cmn_output_media_fmt_event_v2(&me_ptr->cb_info, &me_ptr->out_media_fmt, FALSE, 0);
+
+   return capi_result;
+}
+
+/* =========================================================================
+ * FUNCTION : capi_poly_resampler_raise_process_event
+ * DESCRIPTION: Processing is needed when the rates differ or the ratio may be trimmed
+ * =========================================================================*/
+capi_err_t capi_poly_resampler_raise_process_event(capi_poly_resampler_t *me_ptr)
+{
+   capi_err_t capi_result = CAPI_EOK;
+   uint32_t   enable;
+
+   enable = (me_ptr->in_media_fmt.format.sampling_rate != me_ptr->out_media_fmt.format.sampling_rate) ||
+            capi_poly_resampler_is_drift_port_connected(me_ptr) || (0 != me_ptr->manual_adjust_ppb);
+
+   if (me_ptr->events_config.enable != enable)
+   {
+      capi_result = capi_cmn_update_process_check_event(&me_ptr->cb_info, enable);
+      if (CAPI_EOK == capi_result)
+      {
+         me_ptr->events_config.enable = enable;
+      }
+   }
+   return capi_result;
+}
+
+capi_err_t capi_poly_resampler_raise_events(capi_poly_resampler_t *me_ptr)
+{
+   capi_err_t capi_result = CAPI_EOK;
+
+   if (NULL == me_ptr->cb_info.event_cb)
+   {
+      POLY_RS_MSG(me_ptr->miid, DBG_ERROR_PRIO, "Event callback is not set. Unable to raise events!");
+      return CAPI_EUNSUPPORTED;
+   }
+
+   me_ptr->events_config.kpps        = 0;
+   me_ptr->events_config.delay_in_us = 0;
+   if (NULL != me_ptr->lib_ptr)
+   {
+      me_ptr->events_config.kpps        = poly_rs_lib_get_kpps(&me_ptr->lib_ptr->cfg);
+      me_ptr->events_config.delay_in_us = poly_rs_lib_get_delay_us(me_ptr->lib_ptr);
+   }
+
+   capi_result |= capi_poly_resampler_raise_process_event(me_ptr);
+   capi_result |= capi_cmn_update_kpps_event(&me_ptr->cb_info, me_ptr->events_config.kpps);
+   capi_result |= capi_cmn_update_algo_delay_event(&me_ptr->cb_info, me_ptr->events_config.delay_in_us);
+
+   return capi_result;
+}
+
+static void capi_poly_resampler_resync_drift(capi_poly_resampler_t *me_ptr)
+{
+   me_ptr->drift.is_baseline_valid = FALSE;
+   me_ptr->drift.skipped_ns_x_rate = 0;
+   me_ptr->drift.adjust_ppb        = 0;
+}
+
+capi_err_t capi_poly_resampler_handle_ctrl_port_op(capi_poly_resampler_t *me_ptr, capi_buf_t *params_ptr)
+{
+   capi_err_t        capi_result         = CAPI_EOK;
+   uint32_t          supported_intent[1] = { INTENT_ID_TIMER_DRIFT_INFO };
+   ctrl_port_data_t *port_data_ptr       = NULL;
+
+   capi_result = capi_cmn_ctrl_port_operation_handler(&me_ptr->ctrl_port_list,
+                                                      params_ptr,
+                                                      (POSAL_HEAP_ID)me_ptr->heap_info.heap_id,
+                                                      0,
+                                                      1,
+                                                      supported_intent);
+   if (CAPI_FAILED(capi_result))
+   {
+      POLY_RS_MSG(me_ptr->miid, DBG_ERROR_PRIO, "Control port operation failed, 0x%lx", capi_result);
+      return capi_result;
+   }
+
+   capi_cmn_ctrl_port_list_get_next_port_data(&me_ptr->ctrl_port_list, INTENT_ID_TIMER_DRIFT_INFO, 0, &port_data_ptr);
+
+   if ((NULL == port_data_ptr) || (port_data_ptr->port_info.port_id != me_ptr->drift.ctrl_port_id))
+   {
+      /* closed or replaced, the drift handle belongs to the previous peer */
+      me_ptr->drift.ctrl_port_id = port_data_ptr ? port_data_ptr->port_info.port_id : 0;
+      me_ptr->drift.tdi_hdl_ptr  = NULL;
+      capi_poly_resampler_resync_drift(me_ptr);
+   }
+
+   return capi_poly_resampler_raise_process_event(me_ptr);
+}
+
+capi_err_t capi_poly_resampler_handle_imcl_data(capi_poly_resampler_t *me_ptr, capi_buf_t *params_ptr)
+{
+   if (params_ptr->actual_data_len <
+       (sizeof(intf_extn_param_id_imcl_incoming_data_t) + sizeof(imcl_tdi_set_cfg_header_t)))
+   {
+      POLY_RS_MSG(me_ptr->miid, DBG_ERROR_PRIO, "Invalid payload size for incoming imcl data %lu", params_ptr->actual_data_len);
+      return CAPI_ENEEDMORE;
+   }
+
+   intf_extn_param_id_imcl_incoming_data_t *payload_ptr =
+      (intf_extn_param_id_imcl_incoming_data_t *)params_ptr->data_ptr;
+   imcl_tdi_set_cfg_header_t *tdi_cfg_hdr_ptr = (imcl_tdi_set_cfg_header_t *)(payload_ptr + 1);
+
+   if (payload_ptr->port_id != me_ptr->drift.ctrl_port_id)
+   {
+      POLY_RS_MSG(me_ptr->miid, DBG_ERROR_PRIO, "Ctrl port 0x%lx non existent", payload_ptr->port_id);
+      return CAPI_EBADPARAM;
+   }
+
+   switch (tdi_cfg_hdr_ptr->param_id)
+   {
+      case IMCL_PARAM_ID_TIMER_DRIFT_INFO:
+      {
+         if (sizeof(param_id_imcl_timer_drift_info) > tdi_cfg_hdr_ptr->param_size)
+         {
+            POLY_RS_MSG(me_ptr->miid,
+                        DBG_ERROR_PRIO,
+                        "Invalid payload size %lu for timer drift. Required %lu",
+                        tdi_cfg_hdr_ptr->param_size,
+                        sizeof(param_id_imcl_timer_drift_info));
+            return CAPI_EBADPARAM;
+         }
+
+         param_id_imcl_timer_drift_info *drift_info_ptr = (param_id_imcl_timer_drift_info *)(tdi_cfg_hdr_ptr + 1);
+         me_ptr->drift.tdi_hdl_ptr                      = drift_info_ptr->handle_ptr;
+         capi_poly_resampler_resync_drift(me_ptr);
+
+         POLY_RS_MSG(me_ptr->miid, DBG_HIGH_PRIO, "Ctrl port 0x%lx, received drift handle", payload_ptr->port_id);
+         return capi_poly_resampler_raise_process_event(me_ptr);
+      }
+      case IMCL_PARAM_ID_TIMER_DRIFT_RESYNC:
+      {
+         capi_poly_resampler_resync_drift(me_ptr);
+         POLY_RS_MSG(me_ptr->miid, DBG_HIGH_PRIO, "Ctrl port 0x%lx, drift resynced", payload_ptr->port_id);
+         break;
+      }
+      default:
+      {
+         POLY_RS_MSG(me_ptr->miid,
+                     DBG_ERROR_PRIO,
+                     "Ctrl port 0x%lx, unsupported param_id 0x%lx",
+                     payload_ptr->port_id,
+                     tdi_cfg_hdr_ptr->param_id);
+         break;
+      }
+   }
+
+   return CAPI_EOK;
+}
+
+capi_err_t capi_poly_resampler_process_set_properties(capi_poly_resampler_t *me_ptr, capi_proplist_t *proplist_ptr)
+{
+   capi_err_t capi_result = CAPI_EOK;
+
+   if (NULL == me_ptr)
+   {
+      POLY_RS_MSG(POLY_RS_MIID_UNKNOWN, DBG_ERROR_PRIO, "Set common property received null ptr");
+      return CAPI_EBADPARAM;
+   }
+
+   capi_result |= capi_cmn_set_basic_properties(proplist_ptr, &me_ptr->heap_info, &me_ptr->cb_info, TRUE);
+   if (CAPI_EOK != capi_result)
+   {
+      POLY_RS_MSG(me_ptr->miid, DBG_ERROR_PRIO, "Set basic properties failed with result %lu", capi_result);
+   }
+
+   capi_prop_t *prop_array = proplist_ptr->prop_ptr;
+
+   for (uint32_t i = 0; i < proplist_ptr->props_num; i++)
+   {
+      capi_buf_t *payload_ptr = &(prop_array[i].payload);
+
+      switch (prop_array[i].id)
+      {
+         case CAPI_EVENT_CALLBACK_INFO:
+         case CAPI_HEAP_ID:
+         case CAPI_CUSTOM_INIT_DATA:
+         case CAPI_PORT_NUM_INFO:
+         case CAPI_INTERFACE_EXTENSIONS:
+         case CAPI_OUTPUT_MEDIA_FORMAT_V2:
+         {
+            break;
+         }
+         case CAPI_ALGORITHMIC_RESET:
+         {
+            if (NULL != me_ptr->lib_ptr)
+            {
+               poly_rs_lib_reset(me_ptr->lib_ptr);
+            }
+            break;
+         }
+         case CAPI_INPUT_MEDIA_FORMAT_V2:
+         {
+            if (payload_ptr->actual_data_len < sizeof(capi_media_fmt_v2_t))
+            {
+               POLY_RS_MSG(me_ptr->miid,
+                           DBG_ERROR_PRIO,
+                           "Set property id 0x%lx Bad param size %lu",
+                           (uint32_t)prop_array[i].id,
+                           payload_ptr->actual_data_len);
+               CAPI_SET_ERROR(capi_result, CAPI_ENEEDMORE);
+               break;
+            }
+
+            capi_media_fmt_v2_t *data_ptr = (capi_media_fmt_v2_t *)(payload_ptr->data_ptr);
+            if (!capi_poly_resampler_is_supported_media_type(me_ptr, data_ptr))
+            {
+               CAPI_SET_ERROR(capi_result, CAPI_EBADPARAM);
+               break;
+            }
+
+            me_ptr->in_media_fmt.header.format_header.data_format = data_ptr->header.format_header.data_format;
+            me_ptr->in_media_fmt.format                           = data_ptr->format;
+            memscpy(me_ptr->in_media_fmt.channel_type,
+                    sizeof(me_ptr->in_media_fmt.channel_type),
+                    data_ptr->channel_type,
+                    data_ptr->format.num_channels * sizeof(data_ptr->channel_type[0]));
+
+            capi_result |= capi_poly_resampler_create_lib(me_ptr);
+            break;
+         }
+         case CAPI_MODULE_INSTANCE_ID:
+         {
+            if (payload_ptr->actual_data_len >= sizeof(capi_module_instance_id_t))
+            {
+               capi_module_instance_id_t *data_ptr = (capi_module_instance_id_t *)payload_ptr->data_ptr;
+               me_ptr->miid                        = data_ptr->module_instance_id;
+            }
+            else
+            {
+               CAPI_SET_ERROR(capi_result, CAPI_ENEEDMORE);
+            }
+            break;
+         }
+         default:
+         {
+            capi_result |= CAPI_EUNSUPPORTED;
+            break;
+         }
+      }
+   }
+
+   return capi_result;
+}
+
+capi_err_t capi_poly_resampler_process_get_properties(capi_poly_resampler_t *me_ptr, capi_proplist_t *proplist_ptr)
+{
+   capi_err_t        capi_result = CAPI_EOK;
+   capi_basic_prop_t mod_prop;
+   uint32_t          miid = me_ptr ? me_ptr->miid : POLY_RS_MIID_UNKNOWN;
+
+   mod_prop.init_memory_req    = CAPI_ALIGN_8_BYTE(sizeof(capi_poly_resampler_t));
+   mod_prop.stack_size         = POLY_RS_STACK_SIZE;
+   mod_prop.num_fwk_extns      = 0;
+   mod_prop.fwk_extn_ids_arr   = NULL;
+   mod_prop.is_inplace         = FALSE;
+   mod_prop.req_data_buffering = TRUE;
+   mod_prop.max_metadata_size  = 0;
+
+   capi_result |= capi_cmn_get_basic_properties(proplist_ptr, &mod_prop);
+   if (CAPI_EOK != capi_result)
+   {
+      POLY_RS_MSG(miid, DBG_ERROR_PRIO, "Get common basic properties failed with result %lu", capi_result);
+   }
+
+   capi_prop_t *prop_array = proplist_ptr->prop_ptr;
+
+   for (uint32_t i = 0; i < proplist_ptr->props_num; i++)
+   {
+      capi_buf_t *payload_ptr = &prop_array[i].payload;
+
+      switch (prop_array[i].id)
+      {
+         case CAPI_INIT_MEMORY_REQUIREMENT:
+         case CAPI_STACK_SIZE:
+         case CAPI_IS_INPLACE:
+         case CAPI_REQUIRES_DATA_BUFFERING:
+         case CAPI_OUTPUT_MEDIA_FORMAT_SIZE:
+         case CAPI_NUM_NEEDED_FRAMEWORK_EXTENSIONS:
+         {
+            break;
+         }
+         case CAPI_OUTPUT_MEDIA_FORMAT_V2:
+         {
+            if (NULL == me_ptr)
+            {
+               POLY_RS_MSG(POLY_RS_MIID_UNKNOWN, DBG_ERROR_PRIO, "null ptr while querying output mf");
+               return CAPI_EBADPARAM;
+            }
+            capi_result |= capi_cmn_handle_get_output_media_fmt_v2(&prop_array[i], &me_ptr->out_media_fmt);
+            break;
+         }
+         case CAPI_INTERFACE_EXTENSIONS:
+         {
+            if (payload_ptr->max_data_len < sizeof(capi_interface_extns_list_t))
+            {
+               CAPI_SET_ERROR(capi_result, CAPI_ENEEDMORE);
+               break;
+            }
+
+            capi_interface_extns_list_t *intf_ext_list = (capi_interface_extns_list_t *)payload_ptr->data_ptr;
+            if (payload_ptr->max_data_len < (sizeof(capi_interface_extns_list_t) +
+                                             (intf_ext_list->num_extensions * sizeof(capi_interface_extn_desc_t))))
+            {
+               POLY_RS_MSG(miid, DBG_ERROR_PRIO, "CAPI_INTERFACE_EXTENSIONS invalid param size %lu", payload_ptr->max_data_len);
+               CAPI_SET_ERROR(capi_result, CAPI_ENEEDMORE);
+               break;
+            }
+
+            capi_interface_extn_desc_t *curr_intf_extn_desc_ptr =
+               (capi_interface_extn_desc_t *)(payload_ptr->data_ptr + sizeof(capi_interface_extns_list_t));
+            for (uint32_t j = 0; j < intf_ext_list->num_extensions; j++)
+            {
+               curr_intf_extn_desc_ptr->is_supported = (INTF_EXTN_IMCL == curr_intf_extn_desc_ptr->id);
+               curr_intf_extn_desc_ptr++;
+            }
+            break;
+         }
+         default:
+         {
+            capi_result |= CAPI_EUNSUPPORTED;
+            break;
+         }
+      }
+   }
+
+   return capi_result;
+}
@@ -0,0 +1,179 @@
+#ifndef POLY_RS_LIB_H
+#define POLY_RS_LIB_H
+
+/**
+ * \file poly_rs_lib.h
+ * \brief
+ *     Polyphase windowed-sinc sample rate converter.
+ *
+ *     Converts between any two sample rates. A ratio whose reduced output rate is at most
+ *     POLY_RS_MAX_DIRECT_PHASES runs in direct mode, one exact filter phase per output sample.
+ *     Other ratios, and any ratio trimmed with poly_rs_lib_set_ratio_adjust(), run in interpolated
+ *     mode, which blends the two nearest phases of an oversampled filter table.
+ *
+ *     Data is de-interleaved: 16 bit Q15, or 32 bit with the configured Q factor. Filtering is done in
+ *     float, with AVX2/FMA kernels on x86-64 (picked at run time), NEON kernels on AArch64 and a
+ *     portable fallback elsewhere.
+ *
+ *     The caller owns the memory:
+ *
+ *        poly_rs_lib_get_mem_req(&cfg, &size);
+ *        poly_rs_lib_init(&cfg, mem_ptr, size, &lib_ptr);
+ *        poly_rs_lib_process(lib_ptr, in_pptr, &num_in, out_pptr, &num_out);
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+/*------------------------------------------------------------------------
+ * Include files
+ * -----------------------------------------------------------------------*/
+#include "posal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/*------------------------------------------------------------------------
+ * Macros
+ * -----------------------------------------------------------------------*/
+#define POLY_RS_MIN_SAMPLE_RATE 1000
+#define POLY_RS_MAX_SAMPLE_RATE 768000
+
+/** Largest reduced output rate (out_rate / gcd(in_rate, out_rate)) handled in direct mode */
+#define POLY_RS_MAX_DIRECT_PHASES 512
+
+/** Upper bound of the filter length; downsampling stretches the filter by the ratio up to this */
+#define POLY_RS_MAX_TAPS 1024
+
+/** Input samples per channel converted into the filter history in one pass */
+#define POLY_RS_BLOCK_SAMPLES 256
+
+/** Largest ratio trim, in parts per billion (+/- 1 %) */
+#define POLY_RS_MAX_ADJUST_PPB 10000000
+
+/*------------------------------------------------------------------------
+ * Type definitions
+ * -----------------------------------------------------------------------*/
+typedef enum poly_rs_quality_t
+{
+   POLY_RS_QUALITY_LOW_LATENCY = 0, /**< 16 taps, ~50 dB stop band */
+   POLY_RS_QUALITY_STANDARD    = 1, /**< 32 taps, ~75 dB stop band */
+   POLY_RS_QUALITY_HIGH        = 2, /**< 64 taps, ~95 dB stop band */
+   POLY_RS_QUALITY_MAX
+} poly_rs_quality_t;
+
+typedef struct poly_rs_config_t
+{
+   uint32_t in_sample_rate;
+   uint32_t out_sample_rate;
+   uint32_t num_channels;
+   uint32_t bits_per_sample;    /**< 16 or 32 */
+   uint32_t q_factor;           /**< Q format of the samples, 15 for 16 bit */
+   uint32_t quality;            /**< poly_rs_quality_t */
+   bool_t   allow_ratio_adjust; /**< Also build the interpolated table for direct ratios */
+} poly_rs_config_t;
+
+typedef float (*poly_rs_dot_fn_t)(const float *h_ptr, const float *x_ptr, uint32_t n);
+typedef void (*poly_rs_dot2_fn_t)(const float *h0_ptr,
+                                  const float *h1_ptr,
+                                  const float *x_ptr,
+                                  uint32_t     n,
+                                  float *      acc0_ptr,
+                                  float *      acc1_ptr);
+
+// clang-format off
+typedef struct poly_rs_lib_t
+{
+   poly_rs_config_t  cfg;
+
+   uint32_t          taps;              /**< Filter length, a multiple of 8 */
+   uint32_t          delay_samples;     /**< Group delay in input samples */
+
+   /* direct mode, output t is at input position t * step_int + (t * step_frac) / num_phases */
+   uint32_t          num_phases;        /**< Reduced output rate, 0 if the ratio doesn't fit */
+   uint32_t          step_int;
+   uint32_t          step_frac;
+   uint32_t          phase;
+   float            *direct_table_ptr;  /**< num_phases rows of taps coefficients */
+
+   /* interpolated mode, positions in Q32 input samples */
+   uint32_t          interp_shift;      /**< log2 of the number of table phases */
+   float            *interp_table_ptr;  /**< (1 << interp_shift) + 1 rows, NULL if not built */
+   uint64_t          nominal_step_q32;
+   uint64_t          step_q32;
+   uint32_t          frac_q32;
+   int32_t           adjust_ppb;
+   bool_t            use_direct;
+
+   /* per channel filter history */
+   uint32_t          buf_len;           /**< Capacity per channel, in samples */
+   uint32_t          fill;              /**< Valid samples per channel */
+   float           **ch_buf_pptr;
+
+   float             in_scale;
+   float             out_scale;
+   float             out_min;
+   float             out_max;
+
+   poly_rs_dot_fn_t  dot_fn;
+   poly_rs_dot2_fn_t dot2_fn;
+} poly_rs_lib_t;
+// clang-format on
+
+/*------------------------------------------------------------------------
+ * Function declarations
+ * -----------------------------------------------------------------------*/
+/*
+  Returns the memory needed for an instance with the given configuration
+
+  return: AR_EBADPARAM if the configuration is not supported
+*/
+ar_result_t poly_rs_lib_get_mem_req(const poly_rs_config_t *cfg_ptr, uint32_t *size_ptr);
+
+/*
+  Designs the filters and initializes an instance in mem_ptr, which must hold the size returned by
+  poly_rs_lib_get_mem_req(). The instance starts at the first 32 byte aligned address of mem_ptr.
+  There is nothing to free besides mem_ptr.
+*/
+ar_result_t poly_rs_lib_init(const poly_rs_config_t *cfg_ptr, void *mem_ptr, uint32_t mem_size, poly_rs_lib_t **lib_pptr);
+
+/*
+  Clears the filter history and the fractional position; the ratio trim is kept.
+*/
+void poly_rs_lib_reset(poly_rs_lib_t *lib_ptr);
+
+/*
+  Trims the conversion ratio: a positive value consumes input faster, i.e. produces fewer output
+  samples per input sample. Takes effect at the next output sample, without a discontinuity.
+
+  return: AR_EUNSUPPORTED for a non zero trim if the instance was configured without
+          allow_ratio_adjust and runs in direct mode
+*/
+ar_result_t poly_rs_lib_set_ratio_adjust(poly_rs_lib_t *lib_ptr, int32_t adjust_ppb);
+
+/*
+  Converts up to *num_in_ptr input samples per channel into up to *num_out_ptr output samples per channel.
+  Stops when either side runs out. Input held back for the filter history counts as consumed.
+
+  param[in/out] num_in_ptr:  In: available input samples per channel. Out: consumed samples
+  param[in/out] num_out_ptr: In: output space in samples per channel. Out: produced samples
+*/
+ar_result_t poly_rs_lib_process(poly_rs_lib_t *lib_ptr,
+                                int8_t *        in_pptr[],
+                                uint32_t *      num_in_ptr,
+                                int8_t *        out_pptr[],
+                                uint32_t *      num_out_ptr);
+
+/* Group delay of the filter in microseconds */
+uint32_t poly_rs_lib_get_delay_us(const poly_rs_lib_t *lib_ptr);
+
+/* Processing estimate in KPPS for the given configuration */
+uint32_t poly_rs_lib_get_kpps(const poly_rs_config_t *cfg_ptr);
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif // POLY_RS_LIB_H
@@ -0,0 +1,234 @@
+/**
+ * \file poly_rs_iir_rs_lib.c
+ * \brief
+ *     iir_rs_lib.h implemented on the polyphase resampler. Built into PCM_CNV with CONFIG_POLY_RESAMPLER
+ *     in place of the prebuilt IIR resampler library, which is only available for 32 bit ARM.
+ *
+ *     The instance memory of the single port holds a poly_rs_lib_t. It runs the low latency preset,
+ *     which matches the short group delay PCM_CNV expects from this path.
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+/*==============================================================================
+   Includes
+==============================================================================*/
+#include "iir_rs_lib.h"
+#include "poly_rs_lib_i.h"
+#include "ar_msg.h"
+
+/*==============================================================================
+   Local Function Implementation
+==============================================================================*/
+static void poly_rs_iir_fill_config(poly_rs_config_t *cfg_ptr,
+                                    uint32_t          in_sample_rate,
+                                    uint32_t          out_sample_rate,
+                                    uint32_t          num_channels,
+                                    uint32_t          bits_per_sample)
+{
+   cfg_ptr->in_sample_rate     = in_sample_rate;
+   cfg_ptr->out_sample_rate    = out_sample_rate;
+   cfg_ptr->num_channels       = num_channels;
+   cfg_ptr->bits_per_sample    = (16 == bits_per_sample) ? 16 : 32;
+   cfg_ptr->q_factor           = (16 == bits_per_sample) ? 15 : 27;
+   cfg_ptr->quality            = POLY_RS_QUALITY_LOW_LATENCY;
+   cfg_ptr->allow_ratio_adjust = FALSE;
+}
+
+static poly_rs_lib_t *poly_rs_iir_get_lib(iir_rs_lib_t *iir_rs_ptr)
+{
+   if ((NULL == iir_rs_ptr) || (0 == iir_rs_ptr->num_ports) ||
+       (NULL == iir_rs_ptr->lib_instance_per_port_ptr[0].lib_mem_ptr))
+   {
+      return NULL;
+   }
+
+   /* poly_rs_lib_init() places the instance at the first aligned address of the memory */
+   return (poly_rs_lib_t *)POLY_RS_ALIGN((uintptr_t)iir_rs_ptr->lib_instance_per_port_ptr[0].lib_mem_ptr);
+}
+
+/*==============================================================================
+   Public Function Implementation
+==============================================================================*/
+void iir_rs_lib_deinit(iir_rs_lib_t *iir_rs_ptr)
+{
+   if (NULL == iir_rs_ptr)
+   {
+      return;
+   }
+
+   for (uint32_t port = 0; port < MAX_NUM_PORTS; port++)
+   {
+      if (NULL != iir_rs_ptr->lib_instance_per_port_ptr[port].lib_mem_ptr)
+      {
+         posal_memory_free(iir_rs_ptr->lib_instance_per_port_ptr[port].lib_mem_ptr);
+      }
+   }
+   memset(iir_rs_ptr, 0, sizeof(iir_rs_lib_t));
+}
+
+ar_result_t iir_rs_lib_allocate_memory(iir_rs_lib_t *iir_rs_ptr,
+                                       uint32_t      inp_sampling_rate,
+                                       uint32_t      out_sampling_rate,
+                                       uint32_t      num_channels,
+                                       uint32_t      bits_per_sample,
+                                       uint32_t      frame_length_ms,
+                                       uint32_t      heap_id)
+{
+   ar_result_t            result = AR_EOK;
+   poly_rs_config_t       cfg;
+   uint32_t               mem_size = 0;
+   int8_t *               mem_ptr  = NULL;
+   poly_rs_lib_t *        lib_ptr  = NULL;
+   iir_rs_lib_instance_t *inst_ptr;
+
+   if (NULL == iir_rs_ptr)
+   {
+      return AR_EBADPARAM;
+   }
+
+   iir_rs_lib_deinit(iir_rs_ptr);
+
+   poly_rs_iir_fill_config(&cfg, inp_sampling_rate, out_sampling_rate, num_channels, bits_per_sample);
+   if (AR_EOK != (result = poly_rs_lib_get_mem_req(&cfg, &mem_size)))
+   {
+      AR_MSG(DBG_ERROR_PRIO,
+             "poly_rs_iir: unsupported config, %lu -> %lu Hz, %lu ch, %lu bits",
+             inp_sampling_rate,
+             out_sampling_rate,
+             num_channels,
+             bits_per_sample);
+      return result;
+   }
+
+   mem_ptr = (int8_t *)posal_memory_malloc(mem_size, (POSAL_HEAP_ID)heap_id);
+   if (NULL == mem_ptr)
+   {
+      AR_MSG(DBG_ERROR_PRIO, "poly_rs_iir: failed to allocate %lu bytes", mem_size);
+      return AR_ENOMEMORY;
+   }
+
+   if (AR_EOK != (result = poly_rs_lib_init(&cfg, mem_ptr, mem_size, &lib_ptr)))
+   {
+      posal_memory_free(mem_ptr);
+      return result;
+   }
+
+   inst_ptr                                       = &iir_rs_ptr->lib_instance_per_port_ptr[0];
+   inst_ptr->lib_io_config.in_channels            = num_channels;
+   inst_ptr->lib_io_config.out_channels           = num_channels;
+   inst_ptr->lib_io_config.in_sample_rate         = inp_sampling_rate;
+   inst_ptr->lib_io_config.out_sample_rate        = out_sampling_rate;
+   inst_ptr->lib_io_config.frame_length_ms        = frame_length_ms;
+   inst_ptr->lib_io_config.bytes_per_sample       = cfg.bits_per_sample >> 3;
+   inst_ptr->lib_mem_config.lib_instance_mem_size = mem_size;
+   inst_ptr->lib_mem_config.lib_stack_mem_size    = 0;
+   inst_ptr->lib_mem_config.num_in_samples        = (inp_sampling_rate / 1000) * frame_length_ms;
+   inst_ptr->lib_mem_config.num_out_samples       = (out_sampling_rate / 1000) * frame_length_ms;
+   inst_ptr->lib_mem_ptr                          = (iir_resampler_t *)mem_ptr;
+   iir_rs_ptr->num_ports                          = 1;
+
+   return AR_EOK;
+}
+
+ar_result_t iir_rs_lib_clear_algo_memory(iir_rs_lib_t *iir_rs_ptr)
+{
+   poly_rs_lib_t *lib_ptr = poly_rs_iir_get_lib(iir_rs_ptr);
+
+   if (NULL == lib_ptr)
+   {
+      return AR_EBADPARAM;
+   }
+
+   poly_rs_lib_reset(lib_ptr);
+   return AR_EOK;
+}
+
+/*
+  PCM_CNV hands over one frame at a time and advances by exactly num_in_samples and num_out_samples.
+  With the primed history a frame of whole milliseconds always produces its share of output, any
+  shortfall (only possible for a frame that is not) is zero filled to keep the buffers consistent.
+*/
+ar_result_t iir_rs_process(iir_rs_lib_t *iir_rs_ptr,
+                           int8 **       input_data_ptr,
+                           int8 **       output_data_ptr,
+                           uint32        num_in_samples,
+                           uint32        num_out_samples)
+{
+   poly_rs_lib_t *lib_ptr = poly_rs_iir_get_lib(iir_rs_ptr);
+   uint32_t       num_in  = num_in_samples;
+   uint32_t       num_out = num_out_samples;
+
+   if (NULL == lib_ptr)
+   {
+      return AR_EBADPARAM;
+   }
+
+   poly_rs_lib_process(lib_ptr, (int8_t **)input_data_ptr, &num_in, (int8_t **)output_data_ptr, &num_out);
+
+   if (num_out < num_out_samples)
+   {
+      uint32_t bytes_per_sample = lib_ptr->cfg.bits_per_sample >> 3;
+      for (uint32_t ch = 0; ch < lib_ptr->cfg.num_channels; ch++)
+      {
+         memset(output_data_ptr[ch] + (num_out * bytes_per_sample), 0, (num_out_samples - num_out) * bytes_per_sample);
+      }
+   }
+
+   return (num_in == num_in_samples) ? AR_EOK : AR_EFAILED;
+}
+
+ar_result_t iir_rs_get_param(iir_rs_lib_t *iir_rs_ptr, uint32_t param_id, int8_t *param_data_ptr, uint32_t param_size)
+{
+   poly_rs_lib_t *lib_ptr = poly_rs_iir_get_lib(iir_rs_ptr);
+
+   if ((NULL == lib_ptr) || (NULL == param_data_ptr))
+   {
+      return AR_EBADPARAM;
+   }
+
+   switch (param_id)
+   {
+      case PARAM_ID_IIR_RESAMPLER_DELAY:
+      {
+         if (param_size < sizeof(iir_resampler_delay_config_t))
+         {
+            return AR_ENEEDMORE;
+         }
+         ((iir_resampler_delay_config_t *)param_data_ptr)->group_delay_samples_x1000 = lib_ptr->delay_samples * 1000;
+         return AR_EOK;
+      }
+      default:
+      {
+         return AR_EUNSUPPORTED;
+      }
+   }
+}
+
+uint32_t iir_rs_lib_get_kpps(iir_rs_lib_t *iir_rs_ptr, uint32_t input_samp_rate, uint32_t output_samp_rate)
+{
+   poly_rs_lib_t *  lib_ptr = poly_rs_iir_get_lib(iir_rs_ptr);
+   poly_rs_config_t cfg;
+
+   poly_rs_iir_fill_config(&cfg,
+                           input_samp_rate,
+                           output_samp_rate,
+                           lib_ptr ? lib_ptr->cfg.num_channels : 1,
+                           lib_ptr ? lib_ptr->cfg.bits_per_sample : 16);
+
+   return poly_rs_lib_get_kpps(&cfg);
+}
+
+uint32_t iir_rs_lib_get_delay(iir_rs_lib_t *iir_rs_ptr, uint32_t input_samp_rate, uint32_t output_samp_rate)
+{
+   poly_rs_lib_t *lib_ptr = poly_rs_iir_get_lib(iir_rs_ptr);
+
+   return lib_ptr ? poly_rs_lib_get_delay_us(lib_ptr) : 0;
+}
+
+uint32_t iir_rs_lib_get_bw(iir_rs_lib_t *iir_rs_ptr, uint32_t input_samp_rate)
+{
+   return 0;
+}
@@ -0,0 +1,369 @@
+/**
+ * \file poly_rs_lib.c
+ * \brief
+ *     Filter design and instance setup of the polyphase resampler library.
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+/*==============================================================================
+   Includes
+==============================================================================*/
+#include "poly_rs_lib_i.h"
+#include "ar_msg.h"
+#include <math.h>
+
+/*==============================================================================
+   Local Defines
+==============================================================================*/
+#define POLY_RS_PI 3.14159265358979323846
+
+typedef struct poly_rs_preset_t
+{
+   uint32_t base_taps;    /**< Filter length when not downsampling */
+   uint32_t interp_shift; /**< log2 of the phases of the interpolated table */
+   double   kaiser_beta;
+   double   cutoff;       /**< -6 dB point relative to the Nyquist rate of the lower rate */
+} poly_rs_preset_t;
+
+/* The cutoff puts the end of the Kaiser transition band at the Nyquist rate of the lower rate. Pass
+   band edges at 48 kHz: ~14.6 kHz, ~16.8 kHz and ~19.4 kHz. */
+static const poly_rs_preset_t poly_rs_presets[POLY_RS_QUALITY_MAX] = {
+   { 16, 6, 5.0, 0.80 }, /* POLY_RS_QUALITY_LOW_LATENCY */
+   { 32, 7, 7.5, 0.85 }, /* POLY_RS_QUALITY_STANDARD */
+   { 64, 8, 9.5, 0.90 }, /* POLY_RS_QUALITY_HIGH */
+};
+
+/*==============================================================================
+   Local Function Implementation
+==============================================================================*/
+static uint32_t poly_rs_gcd(uint32_t a, uint32_t b)
+{
+   while (0 != b)
+   {
+      uint32_t t = a % b;
+      a          = b;
+      b          = t;
+   }
+   return a;
+}
+
+static ar_result_t poly_rs_validate_config(const poly_rs_config_t *cfg_ptr)
+{
+   if ((NULL == cfg_ptr) || (cfg_ptr->in_sample_rate < POLY_RS_MIN_SAMPLE_RATE) ||
+       (cfg_ptr->in_sample_rate > POLY_RS_MAX_SAMPLE_RATE) || (cfg_ptr->out_sample_rate < POLY_RS_MIN_SAMPLE_RATE) ||
+       (cfg_ptr->out_sample_rate > POLY_RS_MAX_SAMPLE_RATE) || (0 == cfg_ptr->num_channels) ||
+       (cfg_ptr->quality >= POLY_RS_QUALITY_MAX))
+   {
+      return AR_EBADPARAM;
+   }
+
+   if (!(((16 == cfg_ptr->bits_per_sample) && (15 == cfg_ptr->q_factor)) ||
+         ((32 == cfg_ptr->bits_per_sample) && (cfg_ptr->q_factor <= 31))))
+   {
+      return AR_EBADPARAM;
+   }
+
+   return AR_EOK;
+}
+
+static uint32_t poly_rs_get_taps(const poly_rs_config_t *cfg_ptr)
+{
+   uint64_t taps = poly_rs_presets[cfg_ptr->quality].base_taps;
+
+   /* keep the transition band in output samples when downsampling */
+   if (cfg_ptr->in_sample_rate > cfg_ptr->out_sample_rate)
+   {
+      taps = ((taps * cfg_ptr->in_sample_rate) + cfg_ptr->out_sample_rate - 1) / cfg_ptr->out_sample_rate;
+   }
+   taps = (taps + 7) & ~7ULL;
+
+   return (uint32_t)MIN(taps, POLY_RS_MAX_TAPS);
+}
+
+static uint32_t poly_rs_get_num_direct_phases(const poly_rs_config_t *cfg_ptr)
+{
+   uint32_t num_phases = cfg_ptr->out_sample_rate / poly_rs_gcd(cfg_ptr->in_sample_rate, cfg_ptr->out_sample_rate);
+
+   return (num_phases <= POLY_RS_MAX_DIRECT_PHASES) ? num_phases : 0;
+}
+
+static uint32_t poly_rs_get_buf_len(uint32_t taps)
+{
+   return (taps - 1 + POLY_RS_BLOCK_SAMPLES + 7) & ~7u;
+}
+
+/* Modified Bessel function of the first kind, order 0 */
+static double poly_rs_bessel_i0(double x)
+{
+   double sum  = 1.0;
+   double term = 1.0;
+
+   for (uint32_t k = 1; k < 64; k++)
+   {
+      double t = x / (2.0 * k);
+      term *= t * t;
+      sum += term;
+      if (term < (sum * 1e-12))
+      {
+         break;
+      }
+   }
+   return sum;
+}
+
+/*
+  Fills one phase: tap k weighs input sample idx + k for an output at fractional position frac past idx.
+  Each phase is normalized to unity DC gain so the interpolation between phases adds no ripple.
+*/
+static void poly_rs_design_phase(float *row_ptr, uint32_t taps, double frac, double fc, double beta, double i0_beta)
+{
+   double half   = taps * 0.5;
+   double center = half - 1.0;
+   double sum    = 0.0;
+   float  scale;
+
+   for (uint32_t k = 0; k < taps; k++)
+   {
+      double d = (double)k - center - frac;
+      double r = d / half;
+      double w = (fabs(r) < 1.0) ? (poly_rs_bessel_i0(beta * sqrt(1.0 - (r * r))) / i0_beta) : 0.0;
+      double s = (fabs(d) < 1e-9) ? fc : (sin(POLY_RS_PI * fc * d) / (POLY_RS_PI * d));
+
+      sum += s * w;
+      row_ptr[k] = (float)(s * w);
+   }
+
+   scale = (float)(1.0 / sum);
+   for (uint32_t k = 0; k < taps; k++)
+   {
+      row_ptr[k] *= scale;
+   }
+}
+
+static void poly_rs_design_table(float *               table_ptr,
+                                 uint32_t              num_rows,
+                                 uint32_t              num_phases,
+                                 uint32_t              taps,
+                                 const poly_rs_config_t *cfg_ptr)
+{
+   const poly_rs_preset_t *preset_ptr = &poly_rs_presets[cfg_ptr->quality];
+   double                  fc         = preset_ptr->cutoff;
+   double                  i0_beta    = poly_rs_bessel_i0(preset_ptr->kaiser_beta);
+
+   if (cfg_ptr->out_sample_rate < cfg_ptr->in_sample_rate)
+   {
+      fc = (fc * cfg_ptr->out_sample_rate) / cfg_ptr->in_sample_rate;
+   }
+
+   for (uint32_t p = 0; p < num_rows; p++)
+   {
+      poly_rs_design_phase(table_ptr + (p * taps),
+                           taps,
+                           (double)p / (double)num_phases,
+                           fc,
+                           preset_ptr->kaiser_beta,
+                           i0_beta);
+   }
+}
+
+static void poly_rs_update_step(poly_rs_lib_t *lib_ptr)
+{
+   double delta = ((double)lib_ptr->nominal_step_q32 * (double)lib_ptr->adjust_ppb) * 1e-9;
+
+   lib_ptr->step_q32 = (uint64_t)((int64_t)lib_ptr->nominal_step_q32 + (int64_t)delta);
+}
+
+/*==============================================================================
+   Public Function Implementation
+==============================================================================*/
+ar_result_t poly_rs_lib_get_mem_req(const poly_rs_config_t *cfg_ptr, uint32_t *size_ptr)
+{
+   uint32_t taps, num_phases, size;
+
+   if ((NULL == size_ptr) || (AR_EOK != poly_rs_validate_config(cfg_ptr)))
+   {
+      return AR_EBADPARAM;
+   }
+
+   taps       = poly_rs_get_taps(cfg_ptr);
+   num_phases = poly_rs_get_num_direct_phases(cfg_ptr);
+
+   size = POLY_RS_ALIGN_BYTES; /* room to align mem_ptr */
+   size += POLY_RS_ALIGN(sizeof(poly_rs_lib_t));
+   size += POLY_RS_ALIGN(cfg_ptr->num_channels * sizeof(float *));
+   size += num_phases * taps * sizeof(float);
+   if ((0 == num_phases) || cfg_ptr->allow_ratio_adjust)
+   {
+      size += ((1u << poly_rs_presets[cfg_ptr->quality].interp_shift) + 1) * taps * sizeof(float);
+   }
+   size += cfg_ptr->num_channels * poly_rs_get_buf_len(taps) * sizeof(float);
+
+   *size_ptr = size;
+   return AR_EOK;
+}
+
+ar_result_t poly_rs_lib_init(const poly_rs_config_t *cfg_ptr, void *mem_ptr, uint32_t mem_size, poly_rs_lib_t **lib_pptr)
+{
+   ar_result_t    result   = AR_EOK;
+   uint32_t       req_size = 0;
+   uint8_t *      cur_ptr;
+   poly_rs_lib_t *lib_ptr;
+
+   if ((NULL == mem_ptr) || (NULL == lib_pptr) || (AR_EOK != (result = poly_rs_lib_get_mem_req(cfg_ptr, &req_size))))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "poly_rs_lib: init, unsupported config or NULL pointers");
+      return AR_EBADPARAM;
+   }
+
+   if (mem_size < req_size)
+   {
+      AR_MSG(DBG_ERROR_PRIO, "poly_rs_lib: init, memory size %lu is less than required %lu", mem_size, req_size);
+      return AR_ENEEDMORE;
+   }
+
+   memset(mem_ptr, 0, req_size);
+   cur_ptr = (uint8_t *)POLY_RS_ALIGN((uintptr_t)mem_ptr);
+
+   lib_ptr = (poly_rs_lib_t *)cur_ptr;
+   cur_ptr += POLY_RS_ALIGN(sizeof(poly_rs_lib_t));
+
+   lib_ptr->cfg           = *cfg_ptr;
+   lib_ptr->taps          = poly_rs_get_taps(cfg_ptr);
+   lib_ptr->delay_samples = lib_ptr->taps >> 1;
+   lib_ptr->num_phases    = poly_rs_get_num_direct_phases(cfg_ptr);
+   lib_ptr->interp_shift  = poly_rs_presets[cfg_ptr->quality].interp_shift;
+   lib_ptr->buf_len       = poly_rs_get_buf_len(lib_ptr->taps);
+
+   lib_ptr->ch_buf_pptr = (float **)cur_ptr;
+   cur_ptr += POLY_RS_ALIGN(cfg_ptr->num_channels * sizeof(float *));
+
+   if (0 != lib_ptr->num_phases)
+   {
+      uint32_t m         = cfg_ptr->in_sample_rate / (cfg_ptr->out_sample_rate / lib_ptr->num_phases);
+      lib_ptr->step_int  = m / lib_ptr->num_phases;
+      lib_ptr->step_frac = m % lib_ptr->num_phases;
+
+      lib_ptr->direct_table_ptr = (float *)cur_ptr;
+      cur_ptr += lib_ptr->num_phases * lib_ptr->taps * sizeof(float);
+      poly_rs_design_table(lib_ptr->direct_table_ptr, lib_ptr->num_phases, lib_ptr->num_phases, lib_ptr->taps, cfg_ptr);
+   }
+
+   if ((0 == lib_ptr->num_phases) || cfg_ptr->allow_ratio_adjust)
+   {
+      uint32_t num_phases = 1u << lib_ptr->interp_shift;
+
+      lib_ptr->interp_table_ptr = (float *)cur_ptr;
+      cur_ptr += (num_phases + 1) * lib_ptr->taps * sizeof(float);
+      poly_rs_design_table(lib_ptr->interp_table_ptr, num_phases + 1, num_phases, lib_ptr->taps, cfg_ptr);
+   }
+
+   for (uint32_t ch = 0; ch < cfg_ptr->num_channels; ch++)
+   {
+      lib_ptr->ch_buf_pptr[ch] = (float *)cur_ptr;
+      cur_ptr += lib_ptr->buf_len * sizeof(float);
+   }
+
+   lib_ptr->nominal_step_q32 = ((uint64_t)cfg_ptr->in_sample_rate << 32) / cfg_ptr->out_sample_rate;
+   lib_ptr->step_q32         = lib_ptr->nominal_step_q32;
+   lib_ptr->use_direct       = (0 != lib_ptr->num_phases);
+
+   lib_ptr->in_scale  = 1.0f / (float)(1ULL << cfg_ptr->q_factor);
+   lib_ptr->out_scale = (float)(1ULL << cfg_ptr->q_factor);
+   if (16 == cfg_ptr->bits_per_sample)
+   {
+      lib_ptr->out_min = -32768.0f;
+      lib_ptr->out_max = 32767.0f;
+   }
+   else
+   {
+      lib_ptr->out_min = -2147483648.0f;
+      lib_ptr->out_max = 2147483520.0f; /* largest float below 2^31 */
+   }
+
+   poly_rs_lib_select_kernels(lib_ptr, TRUE);
+   poly_rs_lib_reset(lib_ptr);
+
+   AR_MSG(DBG_HIGH_PRIO,
+          "poly_rs_lib: %lu -> %lu Hz, %lu ch, %lu taps, %s mode",
+          cfg_ptr->in_sample_rate,
+          cfg_ptr->out_sample_rate,
+          cfg_ptr->num_channels,
+          lib_ptr->taps,
+          lib_ptr->use_direct ? "direct" : "interpolated");
+
+   *lib_pptr = lib_ptr;
+   return AR_EOK;
+}
+
+void poly_rs_lib_reset(poly_rs_lib_t *lib_ptr)
+{
+   for (uint32_t ch = 0; ch < lib_ptr->cfg.num_channels; ch++)
+   {
+      memset(lib_ptr->ch_buf_pptr[ch], 0, lib_ptr->buf_len * sizeof(float));
+   }
+
+   /* taps - 1 zeros of history: every full input frame then yields exactly its share of output frames */
+   lib_ptr->fill     = lib_ptr->taps - 1;
+   lib_ptr->phase    = 0;
+   lib_ptr->frac_q32 = 0;
+}
+
+ar_result_t poly_rs_lib_set_ratio_adjust(poly_rs_lib_t *lib_ptr, int32_t adjust_ppb)
+{
+   adjust_ppb = MAX(MIN(adjust_ppb, POLY_RS_MAX_ADJUST_PPB), -POLY_RS_MAX_ADJUST_PPB);
+
+   if (adjust_ppb == lib_ptr->adjust_ppb)
+   {
+      return AR_EOK;
+   }
+
+   if ((0 != adjust_ppb) && (NULL == lib_ptr->interp_table_ptr))
+   {
+      return AR_EUNSUPPORTED;
+   }
+
+   if (lib_ptr->use_direct && (0 != adjust_ppb))
+   {
+      lib_ptr->frac_q32   = (uint32_t)(((uint64_t)lib_ptr->phase << 32) / lib_ptr->num_phases);
+      lib_ptr->use_direct = FALSE;
+   }
+   else if (!lib_ptr->use_direct && (0 == adjust_ppb) && (0 != lib_ptr->num_phases))
+   {
+      /* back to the exact phases, the position moves by less than 1 / num_phases of an input sample */
+      lib_ptr->phase      = (uint32_t)(((uint64_t)lib_ptr->frac_q32 * lib_ptr->num_phases) >> 32);
+      lib_ptr->use_direct = TRUE;
+   }
+
+   lib_ptr->adjust_ppb = adjust_ppb;
+   poly_rs_update_step(lib_ptr);
+
+   return AR_EOK;
+}
+
+uint32_t poly_rs_lib_get_delay_us(const poly_rs_lib_t *lib_ptr)
+{
+   return (uint32_t)(((uint64_t)lib_ptr->delay_samples * 1000000) / lib_ptr->cfg.in_sample_rate);
+}
+
+uint32_t poly_rs_lib_get_kpps(const poly_rs_config_t *cfg_ptr)
+{
+   uint64_t taps;
+
+   if (AR_EOK != poly_rs_validate_config(cfg_ptr))
+   {
+      return 0;
+   }
+
+   /* one 4-wide multiply-accumulate packet per 4 taps (two with phase interpolation, assumed
+      whenever the ratio may be trimmed), plus the sample conversion and the loop overhead */
+   taps = poly_rs_get_taps(cfg_ptr);
+   if ((0 == poly_rs_get_num_direct_phases(cfg_ptr)) || cfg_ptr->allow_ratio_adjust)
+   {
+      taps <<= 1;
+   }
+
+   return (uint32_t)((((taps >> 2) + 8) * cfg_ptr->out_sample_rate * cfg_ptr->num_channels) / 1000);
+}
@@ -0,0 +1,39 @@
+#ifndef POLY_RS_LIB_I_H
+#define POLY_RS_LIB_I_H
+
+/**
+ * \file poly_rs_lib_i.h
+ * \brief
+ *     Internal declarations of the polyphase resampler library.
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "poly_rs_lib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define POLY_RS_X86_AVX2
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define POLY_RS_ARM_NEON
+#endif
+
+#define POLY_RS_ALIGN_BYTES 32
+#define POLY_RS_ALIGN(x) (((x) + (POLY_RS_ALIGN_BYTES - 1)) & ~(POLY_RS_ALIGN_BYTES - 1))
+
+/*
+  Picks the dot product kernels. With allow_simd FALSE the portable kernels are used, which the
+  benchmark uses as the baseline.
+*/
+void poly_rs_lib_select_kernels(poly_rs_lib_t *lib_ptr, bool_t allow_simd);
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif // POLY_RS_LIB_I_H
@@ -0,0 +1,319 @@
+/**
+ * \file poly_rs_lib_island.c
+ * \brief
+ *     Processing path of the polyphase resampler library.
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+/*==============================================================================
+   Includes
+==============================================================================*/
+#include "poly_rs_lib_i.h"
+
+#if defined(POLY_RS_X86_AVX2)
+#include <immintrin.h>
+#elif defined(POLY_RS_ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+/*==============================================================================
+   Dot product kernels, n is a multiple of 8
+==============================================================================*/
+static float poly_rs_dot_c(const float *h_ptr, const float *x_ptr, uint32_t n)
+{
+   float a0 = 0.0f, a1 = 0.0f, a2 = 0.0f, a3 = 0.0f;
+
+   for (uint32_t i = 0; i < n; i += 4)
+   {
+      a0 += h_ptr[i] * x_ptr[i];
+      a1 += h_ptr[i + 1] * x_ptr[i + 1];
+      a2 += h_ptr[i + 2] * x_ptr[i + 2];
+      a3 += h_ptr[i + 3] * x_ptr[i + 3];
+   }
+   return (a0 + a1) + (a2 + a3);
+}
+
+static void poly_rs_dot2_c(const float *h0_ptr,
+                           const float *h1_ptr,
+                           const float *x_ptr,
+                           uint32_t     n,
+                           float *      acc0_ptr,
+                           float *      acc1_ptr)
+{
+   *acc0_ptr = poly_rs_dot_c(h0_ptr, x_ptr, n);
+   *acc1_ptr = poly_rs_dot_c(h1_ptr, x_ptr, n);
+}
+
+#if defined(POLY_RS_X86_AVX2)
+__attribute__((target("avx2,fma"))) static inline float poly_rs_hsum_avx2(__m256 v)
+{
+   __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+   s        = _mm_add_ps(s, _mm_movehl_ps(s, s));
+   s        = _mm_add_ss(s, _mm_movehdup_ps(s));
+   return _mm_cvtss_f32(s);
+}
+
+__attribute__((target("avx2,fma"))) static float poly_rs_dot_avx2(const float *h_ptr, const float *x_ptr, uint32_t n)
+{
+   __m256   a0 = _mm256_setzero_ps();
+   __m256   a1 = _mm256_setzero_ps();
+   uint32_t i  = 0;
+
+   for (; (i + 16) <= n; i += 16)
+   {
+      a0 = _mm256_fmadd_ps(_mm256_loadu_ps(h_ptr + i), _mm256_loadu_ps(x_ptr + i), a0);
+      a1 = _mm256_fmadd_ps(_mm256_loadu_ps(h_ptr + i + 8), _mm256_loadu_ps(x_ptr + i + 8), a1);
+   }
+   if (i < n)
+   {
+      a0 = _mm256_fmadd_ps(_mm256_loadu_ps(h_ptr + i), _mm256_loadu_ps(x_ptr + i), a0);
+   }
+   return poly_rs_hsum_avx2(_mm256_add_ps(a0, a1));
+}
+
+/* both phases share the input loads */
+__attribute__((target("avx2,fma"))) static void poly_rs_dot2_avx2(const float *h0_ptr,
+                                                                   const float *h1_ptr,
+                                                                   const float *x_ptr,
+                                                                   uint32_t     n,
+                                                                   float *      acc0_ptr,
+                                                                   float *      acc1_ptr)
+{
+   __m256 a0 = _mm256_setzero_ps();
+   __m256 a1 = _mm256_setzero_ps();
+
+   for (uint32_t i = 0; i < n; i += 8)
+   {
+      __m256 x = _mm256_loadu_ps(x_ptr + i);
+      a0       = _mm256_fmadd_ps(_mm256_loadu_ps(h0_ptr + i), x, a0);
+      a1       = _mm256_fmadd_ps(_mm256_loadu_ps(h1_ptr + i), x, a1);
+   }
+   *acc0_ptr = poly_rs_hsum_avx2(a0);
+   *acc1_ptr = poly_rs_hsum_avx2(a1);
+}
+#endif // POLY_RS_X86_AVX2
+
+#if defined(POLY_RS_ARM_NEON)
+static float poly_rs_dot_neon(const float *h_ptr, const float *x_ptr, uint32_t n)
+{
+   float32x4_t a0 = vdupq_n_f32(0.0f);
+   float32x4_t a1 = vdupq_n_f32(0.0f);
+
+   for (uint32_t i = 0; i < n; i += 8)
+   {
+      a0 = vfmaq_f32(a0, vld1q_f32(h_ptr + i), vld1q_f32(x_ptr + i));
+      a1 = vfmaq_f32(a1, vld1q_f32(h_ptr + i + 4), vld1q_f32(x_ptr + i + 4));
+   }
+   return vaddvq_f32(vaddq_f32(a0, a1));
+}
+
+static void poly_rs_dot2_neon(const float *h0_ptr,
+                              const float *h1_ptr,
+                              const float *x_ptr,
+                              uint32_t     n,
+                              float *      acc0_ptr,
+                              float *      acc1_ptr)
+{
+   float32x4_t a0 = vdupq_n_f32(0.0f);
+   float32x4_t a1 = vdupq_n_f32(0.0f);
+
+   for (uint32_t i = 0; i < n; i += 4)
+   {
+      float32x4_t x = vld1q_f32(x_ptr + i);
+      a0            = vfmaq_f32(a0, vld1q_f32(h0_ptr + i), x);
+      a1            = vfmaq_f32(a1, vld1q_f32(h1_ptr + i), x);
+   }
+   *acc0_ptr = vaddvq_f32(a0);
+   *acc1_ptr = vaddvq_f32(a1);
+}
+#endif // POLY_RS_ARM_NEON
+
+void poly_rs_lib_select_kernels(poly_rs_lib_t *lib_ptr, bool_t allow_simd)
+{
+   lib_ptr->dot_fn  = poly_rs_dot_c;
+   lib_ptr->dot2_fn = poly_rs_dot2_c;
+
+   if (!allow_simd)
+   {
+      return;
+   }
+
+#if defined(POLY_RS_X86_AVX2)
+   __builtin_cpu_init();
+   if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+   {
+      lib_ptr->dot_fn  = poly_rs_dot_avx2;
+      lib_ptr->dot2_fn = poly_rs_dot2_avx2;
+   }
+#elif defined(POLY_RS_ARM_NEON)
+   lib_ptr->dot_fn  = poly_rs_dot_neon;
+   lib_ptr->dot2_fn = poly_rs_dot2_neon;
+#endif
+}
+
+/*==============================================================================
+   Local Function Implementation
+==============================================================================*/
+static inline void poly_rs_store(const poly_rs_lib_t *lib_ptr, int8_t *out_ptr, uint32_t n, float y)
+{
+   float v = y * lib_ptr->out_scale;
+
+   v = (v > lib_ptr->out_max) ? lib_ptr->out_max : ((v < lib_ptr->out_min) ? lib_ptr->out_min : v);
+   v += (v >= 0.0f) ? 0.5f : -0.5f;
+
+   if (16 == lib_ptr->cfg.bits_per_sample)
+   {
+      ((int16_t *)out_ptr)[n] = (int16_t)v;
+   }
+   else
+   {
+      ((int32_t *)out_ptr)[n] = (int32_t)v;
+   }
+}
+
+static void poly_rs_load(poly_rs_lib_t *lib_ptr, int8_t *in_pptr[], uint32_t in_offset, uint32_t n)
+{
+   for (uint32_t ch = 0; ch < lib_ptr->cfg.num_channels; ch++)
+   {
+      float *dst_ptr = lib_ptr->ch_buf_pptr[ch] + lib_ptr->fill;
+
+      if (16 == lib_ptr->cfg.bits_per_sample)
+      {
+         const int16_t *src_ptr = (const int16_t *)in_pptr[ch] + in_offset;
+         for (uint32_t i = 0; i < n; i++)
+         {
+            dst_ptr[i] = (float)src_ptr[i] * lib_ptr->in_scale;
+         }
+      }
+      else
+      {
+         const int32_t *src_ptr = (const int32_t *)in_pptr[ch] + in_offset;
+         for (uint32_t i = 0; i < n; i++)
+         {
+            dst_ptr[i] = (float)src_ptr[i] * lib_ptr->in_scale;
+         }
+      }
+   }
+   lib_ptr->fill += n;
+}
+
+/*
+  Produces as many output samples as the history allows, up to max_out, then drops the history
+  that is no longer needed. All channels walk the same positions, so each channel restarts from
+  the saved state and the last one commits it.
+*/
+static uint32_t poly_rs_filter(poly_rs_lib_t *lib_ptr, int8_t *out_pptr[], uint32_t out_offset, uint32_t max_out)
+{
+   const uint32_t taps       = lib_ptr->taps;
+   const uint32_t fill       = lib_ptr->fill;
+   const uint32_t num_phases = lib_ptr->num_phases;
+   const uint32_t row_shift  = 32 - lib_ptr->interp_shift;
+   uint32_t       num_out    = 0;
+   uint32_t       idx        = 0;
+   uint32_t       phase      = lib_ptr->phase;
+   uint32_t       frac_q32   = lib_ptr->frac_q32;
+
+   for (uint32_t ch = 0; ch < lib_ptr->cfg.num_channels; ch++)
+   {
+      const float *x_ptr   = lib_ptr->ch_buf_pptr[ch];
+      int8_t *     out_ptr = out_pptr[ch] + (out_offset * (lib_ptr->cfg.bits_per_sample >> 3));
+
+      num_out  = 0;
+      idx      = 0;
+      phase    = lib_ptr->phase;
+      frac_q32 = lib_ptr->frac_q32;
+
+      if (lib_ptr->use_direct)
+      {
+         while ((num_out < max_out) && ((idx + taps) <= fill))
+         {
+            float y = lib_ptr->dot_fn(lib_ptr->direct_table_ptr + (phase * taps), x_ptr + idx, taps);
+            poly_rs_store(lib_ptr, out_ptr, num_out++, y);
+
+            idx += lib_ptr->step_int;
+            phase += lib_ptr->step_frac;
+            if (phase >= num_phases)
+            {
+               phase -= num_phases;
+               idx++;
+            }
+         }
+      }
+      else
+      {
+         while ((num_out < max_out) && ((idx + taps) <= fill))
+         {
+            uint32_t     row    = frac_q32 >> row_shift;
+            float        mu     = (float)(uint32_t)(frac_q32 << lib_ptr->interp_shift) * (1.0f / 4294967296.0f);
+            const float *h0_ptr = lib_ptr->interp_table_ptr + (row * taps);
+            float        a0, a1;
+            uint64_t     pos_q32;
+
+            lib_ptr->dot2_fn(h0_ptr, h0_ptr + taps, x_ptr + idx, taps, &a0, &a1);
+            poly_rs_store(lib_ptr, out_ptr, num_out++, a0 + (mu * (a1 - a0)));
+
+            pos_q32  = (uint64_t)frac_q32 + lib_ptr->step_q32;
+            idx += (uint32_t)(pos_q32 >> 32);
+            frac_q32 = (uint32_t)pos_q32;
+         }
+      }
+   }
+
+   lib_ptr->phase    = phase;
+   lib_ptr->frac_q32 = frac_q32;
+
+   /* the step never exceeds the filter length, so idx stays within the history */
+   if (0 != idx)
+   {
+      for (uint32_t ch = 0; ch < lib_ptr->cfg.num_channels; ch++)
+      {
+         memmove(lib_ptr->ch_buf_pptr[ch], lib_ptr->ch_buf_pptr[ch] + idx, (fill - idx) * sizeof(float));
+      }
+      lib_ptr->fill = fill - idx;
+   }
+
+   return num_out;
+}
+
+/*==============================================================================
+   Public Function Implementation
+==============================================================================*/
+ar_result_t poly_rs_lib_process(poly_rs_lib_t *lib_ptr,
+                                int8_t *        in_pptr[],
+                                uint32_t *      num_in_ptr,
+                                int8_t *        out_pptr[],
+                                uint32_t *      num_out_ptr)
+{
+   uint32_t num_in   = 0;
+   uint32_t num_out  = 0;
+   uint32_t max_in   = *num_in_ptr;
+   uint32_t max_out  = *num_out_ptr;
+
+   for (;;)
+   {
+      uint32_t n = MIN(max_in - num_in, lib_ptr->buf_len - lib_ptr->fill);
+      uint32_t produced;
+
+      if (0 != n)
+      {
+         poly_rs_load(lib_ptr, in_pptr, num_in, n);
+         num_in += n;
+      }
+
+      produced = poly_rs_filter(lib_ptr, out_pptr, num_out, max_out - num_out);
+      num_out += produced;
+
+      if ((0 == n) && (0 == produced))
+      {
+         break;
+      }
+   }
+
+   *num_in_ptr  = num_in;
+   *num_out_ptr = num_out;
+
+   return AR_EOK;
+}
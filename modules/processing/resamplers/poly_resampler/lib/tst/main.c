@@ -0,0 +1,308 @@
+/*==============================================================================
+  Copyright (c) Qualcomm Innovation Center, Inc. All Rights Reserved.
+  SPDX-License-Identifier: BSD-3-Clause-Clear
+  ==============================================================================*/
+
+/*============================================================================
+  FILE:          main.c
+
+  OVERVIEW:      Quality test for the polyphase resampler library. Resamples a
+                 sine across direct and interpolated ratios and checks the SNR
+                 and gain of the output tone, then checks that a ratio trim
+                 changes the output rate and frequency by the requested amount.
+
+  DEPENDENCIES:  Links with the spf library for posal and AR_MSG.
+
+  ============================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "poly_rs_lib.h"
+
+/* -----------------------------------------------------------------------
+** Constant / Define Declarations
+** ----------------------------------------------------------------------- */
+#define TST_PI 3.14159265358979323846
+
+#define TST_TONE_HZ 1000.0
+#define TST_AMPLITUDE 0.5
+#define TST_Q_FACTOR 27
+#define TST_INPUT_MS 1000
+#define TST_BLOCK_SAMPLES 480
+
+/* Output samples at the start that still hold the filter history, not analysed */
+#define TST_SETTLE_SAMPLES 2048
+
+/* Largest gain error of the tone */
+#define TST_MAX_GAIN_ERR_DB 0.05
+
+typedef struct tst_ratio_t
+{
+   uint32_t in_rate;
+   uint32_t out_rate;
+   uint32_t quality;
+   bool_t   allow_ratio_adjust; /* forces the interpolated table into use when trimmed */
+   double   min_snr_db;
+} tst_ratio_t;
+
+/* Minimum SNRs are 5 to 10 dB below the measured values (86 to 147 dB with the standard and high
+   presets). The spread comes from the aliasing left by each preset and from the float accumulation. */
+static const tst_ratio_t tst_ratios[] = {
+   { 8000, 48000, POLY_RS_QUALITY_HIGH, FALSE, 120.0 },
+   { 16000, 48000, POLY_RS_QUALITY_HIGH, FALSE, 125.0 },
+   { 44100, 48000, POLY_RS_QUALITY_HIGH, FALSE, 105.0 },
+   { 48000, 44100, POLY_RS_QUALITY_HIGH, FALSE, 105.0 },
+   { 48000, 16000, POLY_RS_QUALITY_HIGH, FALSE, 135.0 },
+   { 96000, 48000, POLY_RS_QUALITY_HIGH, FALSE, 135.0 },
+   { 48000, 96000, POLY_RS_QUALITY_HIGH, FALSE, 98.0 },
+   { 48000, 11025, POLY_RS_QUALITY_HIGH, FALSE, 135.0 },
+   { 11025, 48000, POLY_RS_QUALITY_HIGH, FALSE, 110.0 }, /* interpolated */
+   { 48000, 44117, POLY_RS_QUALITY_HIGH, FALSE, 105.0 }, /* interpolated */
+   { 48000, 48000, POLY_RS_QUALITY_STANDARD, FALSE, 140.0 },
+   { 44100, 48000, POLY_RS_QUALITY_STANDARD, FALSE, 80.0 },
+   { 44100, 48000, POLY_RS_QUALITY_LOW_LATENCY, FALSE, 55.0 },
+};
+
+/* -----------------------------------------------------------------------
+** Function Definitions
+** ----------------------------------------------------------------------- */
+static poly_rs_lib_t *tst_create(const tst_ratio_t *ratio_ptr, void **mem_pptr)
+{
+   poly_rs_config_t cfg;
+   poly_rs_lib_t *  lib_ptr = NULL;
+   uint32_t         size    = 0;
+
+   memset(&cfg, 0, sizeof(cfg));
+   cfg.in_sample_rate     = ratio_ptr->in_rate;
+   cfg.out_sample_rate    = ratio_ptr->out_rate;
+   cfg.num_channels       = 1;
+   cfg.bits_per_sample    = 32;
+   cfg.q_factor           = TST_Q_FACTOR;
+   cfg.quality            = ratio_ptr->quality;
+   cfg.allow_ratio_adjust = ratio_ptr->allow_ratio_adjust;
+
+   if ((AR_EOK != poly_rs_lib_get_mem_req(&cfg, &size)) || (NULL == (*mem_pptr = malloc(size))))
+   {
+      return NULL;
+   }
+
+   if (AR_EOK != poly_rs_lib_init(&cfg, *mem_pptr, size, &lib_ptr))
+   {
+      free(*mem_pptr);
+      *mem_pptr = NULL;
+      return NULL;
+   }
+   return lib_ptr;
+}
+
+/* Resamples num_in samples of the test tone, returns the number of output samples */
+static uint32_t tst_run(poly_rs_lib_t *lib_ptr, uint32_t in_rate, uint32_t num_in, int32_t *out_ptr, uint32_t max_out)
+{
+   int32_t *in_ptr  = (int32_t *)malloc(num_in * sizeof(int32_t));
+   uint32_t in_pos  = 0;
+   uint32_t out_pos = 0;
+
+   if (NULL == in_ptr)
+   {
+      return 0;
+   }
+
+   for (uint32_t i = 0; i < num_in; i++)
+   {
+      double v  = TST_AMPLITUDE * sin((2.0 * TST_PI * TST_TONE_HZ * i) / in_rate);
+      in_ptr[i] = (int32_t)lrint(v * (double)(1 << TST_Q_FACTOR));
+   }
+
+   while (in_pos < num_in)
+   {
+      int8_t * in_pptr[1]  = { (int8_t *)(in_ptr + in_pos) };
+      int8_t * out_pptr[1] = { (int8_t *)(out_ptr + out_pos) };
+      uint32_t n_in        = MIN(TST_BLOCK_SAMPLES, num_in - in_pos);
+      uint32_t n_out       = max_out - out_pos;
+
+      poly_rs_lib_process(lib_ptr, in_pptr, &n_in, out_pptr, &n_out);
+      in_pos += n_in;
+      out_pos += n_out;
+
+      if ((0 == n_in) && (0 == n_out))
+      {
+         break;
+      }
+   }
+
+   free(in_ptr);
+   return out_pos;
+}
+
+/*
+  Fits a sine of the given normalized frequency to the output by least squares, and returns the
+  ratio of the fitted tone to the residual in dB. The residual holds the filter noise, aliasing
+  and any frequency error.
+*/
+static double tst_measure(const int32_t *out_ptr, uint32_t num_out, double freq, double *gain_db_ptr)
+{
+   double ss = 0.0, cc = 0.0, sc = 0.0, ys = 0.0, yc = 0.0;
+   double det, a, b, sig = 0.0, err = 0.0;
+   double scale = 1.0 / (double)(1 << TST_Q_FACTOR);
+
+   for (uint32_t i = TST_SETTLE_SAMPLES; i < num_out - TST_SETTLE_SAMPLES; i++)
+   {
+      double s = sin(2.0 * TST_PI * freq * i);
+      double c = cos(2.0 * TST_PI * freq * i);
+      double y = out_ptr[i] * scale;
+
+      ss += s * s;
+      cc += c * c;
+      sc += s * c;
+      ys += y * s;
+      yc += y * c;
+   }
+
+   det = (ss * cc) - (sc * sc);
+   a   = ((ys * cc) - (yc * sc)) / det;
+   b   = ((yc * ss) - (ys * sc)) / det;
+
+   for (uint32_t i = TST_SETTLE_SAMPLES; i < num_out - TST_SETTLE_SAMPLES; i++)
+   {
+      double fit = (a * sin(2.0 * TST_PI * freq * i)) + (b * cos(2.0 * TST_PI * freq * i));
+      double d   = (out_ptr[i] * scale) - fit;
+
+      sig += fit * fit;
+      err += d * d;
+   }
+
+   *gain_db_ptr = 20.0 * log10(sqrt((a * a) + (b * b)) / TST_AMPLITUDE);
+   return 10.0 * log10(sig / MAX(err, 1e-30));
+}
+
+static int tst_snr(void)
+{
+   int failed = 0;
+
+   for (uint32_t r = 0; r < sizeof(tst_ratios) / sizeof(tst_ratios[0]); r++)
+   {
+      const tst_ratio_t *ratio_ptr = &tst_ratios[r];
+      void *             mem_ptr   = NULL;
+      poly_rs_lib_t *    lib_ptr   = tst_create(ratio_ptr, &mem_ptr);
+      uint32_t           num_in    = (ratio_ptr->in_rate * TST_INPUT_MS) / 1000;
+      uint32_t           max_out   = ((ratio_ptr->out_rate * TST_INPUT_MS) / 1000) + 2;
+      int32_t *          out_ptr   = (int32_t *)malloc(max_out * sizeof(int32_t));
+      uint32_t           num_out;
+      double             expected, snr_db, gain_db;
+
+      if ((NULL == lib_ptr) || (NULL == out_ptr))
+      {
+         printf("FAIL %lu -> %lu: create\n", (unsigned long)ratio_ptr->in_rate, (unsigned long)ratio_ptr->out_rate);
+         free(mem_ptr);
+         free(out_ptr);
+         failed++;
+         continue;
+      }
+
+      num_out = tst_run(lib_ptr, ratio_ptr->in_rate, num_in, out_ptr, max_out);
+      snr_db  = tst_measure(out_ptr, num_out, TST_TONE_HZ / ratio_ptr->out_rate, &gain_db);
+
+      expected = ((double)num_in * ratio_ptr->out_rate) / ratio_ptr->in_rate;
+
+      /* every input frame yields exactly its share of output frames */
+      if ((fabs(num_out - expected) > 1.0) || (snr_db < ratio_ptr->min_snr_db) ||
+          (fabs(gain_db) > TST_MAX_GAIN_ERR_DB))
+      {
+         failed++;
+         printf("FAIL ");
+      }
+      else
+      {
+         printf("ok   ");
+      }
+      printf("%6lu -> %6lu q%lu %s: %lu out, SNR %.1f dB (min %.1f), gain %.4f dB\n",
+             (unsigned long)ratio_ptr->in_rate,
+             (unsigned long)ratio_ptr->out_rate,
+             (unsigned long)ratio_ptr->quality,
+             lib_ptr->use_direct ? "direct" : "interp",
+             (unsigned long)num_out,
+             snr_db,
+             ratio_ptr->min_snr_db,
+             gain_db);
+
+      free(out_ptr);
+      free(mem_ptr);
+   }
+
+   return failed;
+}
+
+/*
+  A trim of adjust_ppb consumes the input (1 + adjust) times faster: the output holds
+  num_in * out / in / (1 + adjust) samples, and the tone moves up by the same factor.
+*/
+static int tst_drift_trim(void)
+{
+   static const int32_t adjust_ppb[] = { 1000000, -1000000, 5000000, -POLY_RS_MAX_ADJUST_PPB, 250 };
+   const tst_ratio_t    ratio        = { 48000, 48000, POLY_RS_QUALITY_HIGH, TRUE, 105.0 };
+   int                  failed       = 0;
+
+   for (uint32_t t = 0; t < sizeof(adjust_ppb) / sizeof(adjust_ppb[0]); t++)
+   {
+      void *         mem_ptr = NULL;
+      poly_rs_lib_t *lib_ptr = tst_create(&ratio, &mem_ptr);
+      uint32_t       num_in  = (ratio.in_rate * TST_INPUT_MS) / 1000;
+      uint32_t       max_out = (num_in * 2);
+      int32_t *      out_ptr = (int32_t *)malloc(max_out * sizeof(int32_t));
+      double         factor  = 1.0 + (adjust_ppb[t] * 1e-9);
+      double         expected, snr_db, gain_db;
+      uint32_t       num_out;
+
+      if ((NULL == lib_ptr) || (NULL == out_ptr) || (AR_EOK != poly_rs_lib_set_ratio_adjust(lib_ptr, adjust_ppb[t])))
+      {
+         printf("FAIL trim %ld ppb: create\n", (long)adjust_ppb[t]);
+         free(mem_ptr);
+         free(out_ptr);
+         failed++;
+         continue;
+      }
+
+      num_out  = tst_run(lib_ptr, ratio.in_rate, num_in, out_ptr, max_out);
+      expected = ((double)num_in * ratio.out_rate) / ratio.in_rate / factor;
+      snr_db   = tst_measure(out_ptr, num_out, (TST_TONE_HZ * factor) / ratio.out_rate, &gain_db);
+
+      if ((fabs(num_out - expected) > 1.0) || (snr_db < ratio.min_snr_db) ||
+          (fabs(gain_db) > TST_MAX_GAIN_ERR_DB))
+      {
+         failed++;
+         printf("FAIL ");
+      }
+      else
+      {
+         printf("ok   ");
+      }
+      printf("trim %9ld ppb: %lu out (expected %.1f), SNR %.1f dB at the trimmed tone, gain %.4f dB\n",
+             (long)adjust_ppb[t],
+             (unsigned long)num_out,
+             expected,
+             snr_db,
+             gain_db);
+
+      free(out_ptr);
+      free(mem_ptr);
+   }
+
+   return failed;
+}
+
+int main(void)
+{
+   int failed = 0;
+
+   posal_init();
+
+   failed += tst_snr();
+   failed += tst_drift_trim();
+
+   printf("poly_rs_lib tests %s\n", (0 == failed) ? "passed" : "FAILED");
+
+   posal_deinit();
+   return (0 == failed) ? 0 : 1;
+}
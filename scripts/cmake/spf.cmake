@@ -71,7 +71,7 @@ function(spf_module_sources)
 	SPF_MODULE
 	"OBFUSCATE"
 	"KCONFIG;NAME;MAJOR_VER;MINOR_VER;AMDB_ITYPE;AMDB_MTYPE;AMDB_MID;AMDB_TAG;AMDB_MOD_NAME;AMDB_FMT_ID1"
-	"SRCS;INCLUDES;H2XML_HEADERS;QACT_MODULE_TYPE;CFLAGS;STATIC_LIB_PATH"
+	"SRCS;INCLUDES;LIBS;H2XML_HEADERS;QACT_MODULE_TYPE;CFLAGS;STATIC_LIB_PATH"
 	# Parser Input
 	${ARGN}
 	)
@@ -139,6 +139,17 @@ function(spf_module_sources)
 	elseif (${SPF_MODULE_KCONFIG} MATCHES "y")
 		spf_sources(${SPF_MODULE_SRCS})
 		spf_include_directories(${SPF_MODULE_INCLUDES})
+		# AR_MSG component of the module sources, see ar_msg.h
+		foreach(src_path ${SPF_MODULE_SRCS})
+			set(abs_path "")
+			get_absolute_path(${src_path} abs_path)
+			set_property(SOURCE ${abs_path} TARGET_DIRECTORY spf APPEND PROPERTY
+				COMPILE_DEFINITIONS AR_MSG_MODULE_ID=AR_MSG_MODULE_ID_CAPI)
+		endforeach()
+		# Static libraries shared between modules are linked once into spf
+		if (NOT "${SPF_MODULE_LIBS}" STREQUAL "")
+			set_property(GLOBAL APPEND PROPERTY GLOBAL_SPF_LIBS_LIST ${SPF_MODULE_LIBS})
+		endif()
 		set(SPF_MODULE_NAME "${SPF_MODULE_NAME}")
 		set(post_build_commands "")
 		set(json_file "${PROJECT_BINARY_DIR}/libs_cfg/${SPF_MODULE_NAME}.json")
@@ -194,6 +205,7 @@ function(spf_module_sources)
 		add_library(${SPF_MODULE_NAME} SHARED "" )
 		set(json_file "${PROJECT_BINARY_DIR}/libs_cfg/${SPF_MODULE_NAME}.json")
 		target_compile_options(${SPF_MODULE_NAME} PRIVATE ${SPF_MODULE_CFLAGS})
+		target_compile_definitions(${SPF_MODULE_NAME} PRIVATE AR_MSG_MODULE_ID=AR_MSG_MODULE_ID_CAPI)
 		file(WRITE ${json_file} 
 		"[\n"
 		"   {\n"
@@ -227,6 +239,10 @@ function(spf_module_sources)
 			target_include_directories(${SPF_MODULE_NAME} PRIVATE ${abs_path})
 		endforeach()
 
+		if (NOT "${SPF_MODULE_LIBS}" STREQUAL "")
+			target_link_libraries(${SPF_MODULE_NAME} PRIVATE ${SPF_MODULE_LIBS})
+		endif()
+
 		foreach(inc_path ${SPF_MODULE_H2XML_HEADERS})
 			set(abs_path "")
 			get_absolute_path(${inc_path} abs_path)
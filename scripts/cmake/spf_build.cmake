@@ -64,6 +64,18 @@ function(spf_build_static_library)
         list(APPEND comp_defs_list ${comp_def})
     endforeach()
 
+    #AR_MSG component of the library, selects its runtime log level (see ar_msg.h)
+    file(RELATIVE_PATH lib_rel_dir ${PROJECT_SOURCE_DIR} ${CMAKE_CURRENT_SOURCE_DIR})
+    if(lib_rel_dir MATCHES "^fwk/platform/")
+        list(APPEND comp_defs_list AR_MSG_MODULE_ID=AR_MSG_MODULE_ID_POSAL)
+    elseif(lib_rel_dir MATCHES "^fwk/spf/apm/")
+        list(APPEND comp_defs_list AR_MSG_MODULE_ID=AR_MSG_MODULE_ID_APM)
+    elseif(lib_rel_dir MATCHES "^fwk/spf/containers/")
+        list(APPEND comp_defs_list AR_MSG_MODULE_ID=AR_MSG_MODULE_ID_CNTR)
+    elseif(lib_rel_dir MATCHES "^(fwk/spf/modules|modules)/")
+        list(APPEND comp_defs_list AR_MSG_MODULE_ID=AR_MSG_MODULE_ID_CAPI)
+    endif()
+
     #message("comp_defs_list: ${comp_defs_list}")
     target_compile_definitions(${static_lib_name} PRIVATE ${comp_defs_list})
 